@@ -0,0 +1,622 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * Host test for the image verification service in CSUImage.c, built against
+ * the model of the CSU DMA in CSUImageHostModel.h.
+ *
+ * The test is single threaded.  It calls the service task's event handler,
+ * prvProcessEvents(), itself with the events the stubs collect, and decides
+ * when each transfer the model runs ends, and whether it ends with an error.
+ * The checks cover the software checksum, rejected jobs, images that are only
+ * verified and images that are copied, the progress reported as a job runs,
+ * checksum mismatches, an error part way through a job, a full queue, and a
+ * long run of random jobs.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test, with a small chunk size so jobs take several
+transfers. */
+#define csuimageUSE_HOST_MODEL			1
+#define csuimageCHUNK_SIZE				4096UL
+#include "CSUImage.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define csutestBUFFER_SIZE				( 64U * 1024U )
+#define csutestRANDOM_ROUNDS			3000
+
+/* The handles xTaskCreate() gives the service task, and the task that
+submits jobs. */
+#define csutestSERVICE_TASK				( ( TaskHandle_t ) &xServiceTaskStandIn )
+#define csutestSUBMITTING_TASK			( ( TaskHandle_t ) &xSubmittingTaskStandIn )
+
+/*-----------------------------------------------------------*/
+
+/* A queue, for the stub queue functions. */
+struct HostTestQueue
+{
+	UBaseType_t uxLength;
+	UBaseType_t uxItemSize;
+	UBaseType_t uxHead;
+	UBaseType_t uxWaiting;
+	uint8_t *pucStorage;
+};
+
+/*-----------------------------------------------------------*/
+
+/* The model CSU DMA. */
+HostCSUDMAModel_t xHostCSUDMAModel;
+
+static uint8_t xServiceTaskStandIn, xSubmittingTaskStandIn;
+
+/* The events sent to the service task and not yet processed, and the
+notifications given to the submitting task. */
+static uint32_t ulPendingEvents = 0;
+static uint32_t ulNotificationsGiven = 0;
+
+/* Cache maintenance calls. */
+static uint32_t ulFlushCalls = 0;
+static size_t xInvalidatedBytes = 0;
+
+/* The progress callbacks made, and the progress of the last. */
+static uint32_t ulProgressCallbacks = 0;
+static size_t xLastBytesDone = 0;
+
+static uint8_t ucSource[ csutestBUFFER_SIZE + csuimageALIGNMENT ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+static uint8_t ucDestination[ csutestBUFFER_SIZE + csuimageALIGNMENT ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheFlushRanges( const Xil_CacheRange *ranges, u32 num )
+{
+	( void ) ranges;
+	hosttestCHECK( ( num == 1 ) || ( num == 2 ) );
+	ulFlushCalls++;
+}
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheInvalidateRange( INTPTR adr, INTPTR len )
+{
+	/* Each transfer's part of the destination is invalidated, and starts on a
+	cache line. */
+	hosttestCHECK( ( adr % csuimageALIGNMENT ) == 0 );
+	hosttestCHECK( ( len > 0 ) && ( len <= ( INTPTR ) csuimageCHUNK_SIZE ) );
+	xInvalidatedBytes += ( size_t ) len;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+QueueHandle_t xQueue = calloc( 1, sizeof( *xQueue ) );
+
+	xQueue->uxLength = uxQueueLength;
+	xQueue->uxItemSize = uxItemSize;
+	xQueue->pucStorage = malloc( uxQueueLength * uxItemSize );
+
+	return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+UBaseType_t uxIndex;
+
+	/* Only one task runs, so a full queue would never empty while it
+	waited. */
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting < xQueue->uxLength )
+	{
+		uxIndex = ( xQueue->uxHead + xQueue->uxWaiting ) % xQueue->uxLength;
+		memcpy( &( xQueue->pucStorage[ uxIndex * xQueue->uxItemSize ] ), pvItemToQueue, xQueue->uxItemSize );
+		xQueue->uxWaiting++;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting > 0 )
+	{
+		memcpy( pvBuffer, &( xQueue->pucStorage[ xQueue->uxHead * xQueue->uxItemSize ] ), xQueue->uxItemSize );
+		xQueue->uxHead = ( xQueue->uxHead + 1 ) % xQueue->uxLength;
+		xQueue->uxWaiting--;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+	return xQueue->uxWaiting;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+	( void ) pxTaskCode;
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+	( void ) uxPriority;
+
+	*pxCreatedTask = csutestSERVICE_TASK;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction )
+{
+	hosttestCHECK( xTaskToNotify == csutestSERVICE_TASK );
+	hosttestCHECK( eAction == eSetBits );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	ulPendingEvents |= ulValue;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	*pxHigherPriorityTaskWoken = pdTRUE;
+
+	return xTaskNotify( xTaskToNotify, ulValue, eAction );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+{
+	/* Only called by the service task, which the test does not run. */
+	( void ) ulBitsToClearOnEntry;
+	( void ) ulBitsToClearOnExit;
+	( void ) pulNotificationValue;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+	hosttestCHECK( xTaskToNotify == csutestSUBMITTING_TASK );
+	hosttestCHECK( uxIndexToNotify == csuimageNOTIFICATION_INDEX );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	ulNotificationsGiven++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+	/* The test only waits with a block time of zero. */
+	( void ) uxIndexToWaitOn;
+	( void ) xClearCountOnExit;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+	return taskSCHEDULER_RUNNING;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return csutestSUBMITTING_TASK;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	pxTimeOut->xOverflowCount = 0;
+	pxTimeOut->xTimeOnEntering = 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+	( void ) pxTimeOut;
+
+	return ( *pxTicksToWait == 0 ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/* Run the service task until it has no events left. */
+static void prvRunService( void )
+{
+uint32_t ulEvents;
+
+	while( ulPendingEvents != 0 )
+	{
+		ulEvents = ulPendingEvents;
+		ulPendingEvents = 0;
+		prvProcessEvents( ulEvents );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Let the CSU DMA and the service task run until every job is done. */
+static void prvDrain( void )
+{
+	do
+	{
+		prvRunService();
+	} while( bHostCSUDMAModelComplete( false ) != false );
+
+	prvRunService();
+	hosttestCHECK( bHostCSUDMAModelRunning() == false );
+}
+/*-----------------------------------------------------------*/
+
+/* The checksum the CSU DMA calculates, one word at a time. */
+static uint32_t prvReferenceChecksum( const uint8_t *pucData, size_t xLength )
+{
+uint32_t ulSum = 0, ulWord;
+size_t x;
+
+	for( x = 0; x < xLength; x += sizeof( ulWord ) )
+	{
+		memcpy( &ulWord, &( pucData[ x ] ), sizeof( ulWord ) );
+		ulSum += ulWord;
+	}
+
+	return ulSum;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProgress( CSUImageJob_t *pxJob, size_t xBytesDone, uint32_t ulChecksum )
+{
+	hosttestCHECK( pxJob->pvContext == &ulProgressCallbacks );
+	hosttestCHECK( ( xBytesDone > xLastBytesDone ) && ( xBytesDone <= pxJob->xLength ) );
+	hosttestCHECK( ( xBytesDone == pxJob->xLength ) || ( ( xBytesDone % csuimageCHUNK_SIZE ) == 0 ) );
+	hosttestCHECK( ulChecksum == prvReferenceChecksum( pxJob->pvImage, xBytesDone ) );
+	hosttestCHECK( xCSUImageGetProgress( pxJob, NULL ) == xBytesDone );
+
+	/* The next transfer has already been started. */
+	hosttestCHECK( bHostCSUDMAModelRunning() == ( xBytesDone < pxJob->xLength ) );
+
+	if( pxJob->pvDestination != NULL )
+	{
+		hosttestCHECK( memcmp( pxJob->pvDestination, pxJob->pvImage, xBytesDone ) == 0 );
+	}
+
+	xLastBytesDone = xBytesDone;
+	ulProgressCallbacks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSoftwareChecksum( void )
+{
+size_t xLength;
+
+	for( xLength = 0; xLength <= 64; xLength += sizeof( uint32_t ) )
+	{
+		hosttestCHECK( ulCSUImageChecksum( &( ucSource[ 4 ] ), xLength ) == prvReferenceChecksum( &( ucSource[ 4 ] ), xLength ) );
+	}
+
+	hosttestCHECK( ulCSUImageChecksum( ucSource, csutestBUFFER_SIZE ) == prvReferenceChecksum( ucSource, csutestBUFFER_SIZE ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRejectedJobs( void )
+{
+CSUImageJob_t xJob = { ucSource, NULL, 0, 0 };
+
+	/* An empty image, a length or image that is not whole words, no image,
+	and a destination that is not whole cache lines are rejected before
+	anything is queued. */
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdFAIL );
+	hosttestCHECK( xJob.xStatus == csuimageSTATUS_FAILED );
+
+	xJob.xLength = 6;
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdFAIL );
+
+	xJob.xLength = 8;
+	xJob.pvImage = &( ucSource[ 2 ] );
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdFAIL );
+
+	xJob.pvImage = NULL;
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdFAIL );
+
+	xJob.pvImage = ucSource;
+	xJob.pvDestination = &( ucDestination[ 4 ] );
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdFAIL );
+
+	hosttestCHECK( ulPendingEvents == 0 );
+	hosttestCHECK( ulFlushCalls == 0 );
+	hosttestCHECK( xHostCSUDMAModel.ulTransfers == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestVerify( void )
+{
+const size_t xLength = ( csuimageCHUNK_SIZE * 3 ) + ( csuimageCHUNK_SIZE / 2 );
+CSUImageJob_t xJob = { &( ucSource[ 4 ] ), NULL, xLength, 0, prvProgress, &ulProgressCallbacks };
+uint32_t ulChecksum;
+
+	/* An image that is not cache line aligned, and is only verified, is
+	read in three and a half transfers, with progress reported after each. */
+	xJob.ulExpectedChecksum = prvReferenceChecksum( xJob.pvImage, xLength );
+	xLastBytesDone = 0;
+	ulProgressCallbacks = 0;
+
+	hosttestCHECK( xCSUImageSubmit( &xJob, 0 ) == pdPASS );
+	hosttestCHECK( xJob.xStatus == csuimageSTATUS_PENDING );
+	prvDrain();
+
+	hosttestCHECK( xCSUImageWait( &xJob, 0 ) == csuimageSTATUS_COMPLETE );
+	hosttestCHECK( ulProgressCallbacks == 4 );
+	hosttestCHECK( ulNotificationsGiven == 1 );
+	hosttestCHECK( xCSUImageGetProgress( &xJob, &ulChecksum ) == xLength );
+	hosttestCHECK( ulChecksum == xJob.ulExpectedChecksum );
+	hosttestCHECK( xHostCSUDMAModel.ulTransfers == 4 );
+
+	/* Nothing was written that the CPU reads, so nothing was invalidated. */
+	hosttestCHECK( xInvalidatedBytes == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestCopyAndMismatch( void )
+{
+const size_t xLength = csuimageCHUNK_SIZE * 5;
+CSUImageJob_t xCopy = { ucSource, ucDestination, xLength, 0, prvProgress, &ulProgressCallbacks };
+CSUImageJob_t xMismatch = { ucSource, NULL, csuimageCHUNK_SIZE, 0 };
+
+	memset( ucDestination, 0x00, sizeof( ucDestination ) );
+	xCopy.ulExpectedChecksum = prvReferenceChecksum( ucSource, xLength );
+	xMismatch.ulExpectedChecksum = prvReferenceChecksum( ucSource, csuimageCHUNK_SIZE ) + 1;
+	xLastBytesDone = 0;
+	ulProgressCallbacks = 0;
+
+	/* The second job's checksum only covers its own image, so the checksum
+	must be cleared between jobs. */
+	hosttestCHECK( xCSUImageSubmit( &xCopy, 0 ) == pdPASS );
+	hosttestCHECK( xCSUImageSubmit( &xMismatch, 0 ) == pdPASS );
+	prvDrain();
+
+	hosttestCHECK( xCopy.xStatus == csuimageSTATUS_COMPLETE );
+	hosttestCHECK( memcmp( ucDestination, ucSource, xLength ) == 0 );
+	hosttestCHECK( ulProgressCallbacks == 5 );
+	hosttestCHECK( xInvalidatedBytes == xLength );
+
+	hosttestCHECK( xMismatch.xStatus == csuimageSTATUS_MISMATCH );
+	hosttestCHECK( xMismatch.ulChecksum == prvReferenceChecksum( ucSource, csuimageCHUNK_SIZE ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestError( void )
+{
+CSUImageJob_t xFailing = { ucSource, ucDestination, csuimageCHUNK_SIZE * 4, 0 };
+CSUImageJob_t xNext = { &( ucSource[ 64 ] ), NULL, csuimageCHUNK_SIZE * 2, 0 };
+CSUImageStats_t xBefore, xAfter;
+
+	xNext.ulExpectedChecksum = prvReferenceChecksum( xNext.pvImage, xNext.xLength );
+	vCSUImageGetStats( &xBefore );
+
+	hosttestCHECK( xCSUImageSubmit( &xFailing, 0 ) == pdPASS );
+	hosttestCHECK( xCSUImageSubmit( &xNext, 0 ) == pdPASS );
+
+	/* The second transfer of the first job ends with an error, which fails
+	the job, resets the CSU DMA, and starts the next job. */
+	prvRunService();
+	hosttestCHECK( bHostCSUDMAModelComplete( false ) != false );
+	prvRunService();
+	hosttestCHECK( bHostCSUDMAModelComplete( true ) != false );
+	prvRunService();
+
+	hosttestCHECK( xFailing.xStatus == csuimageSTATUS_FAILED );
+	hosttestCHECK( xFailing.xBytesDone == csuimageCHUNK_SIZE );
+	hosttestCHECK( xHostCSUDMAModel.ulResets == 1 );
+	hosttestCHECK( xNext.xStatus == csuimageSTATUS_PENDING );
+	hosttestCHECK( bHostCSUDMAModelRunning() != false );
+
+	prvDrain();
+	hosttestCHECK( xNext.xStatus == csuimageSTATUS_COMPLETE );
+
+	vCSUImageGetStats( &xAfter );
+	hosttestCHECK( xAfter.ulFailures - xBefore.ulFailures == 1 );
+	hosttestCHECK( xAfter.ulJobs - xBefore.ulJobs == 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestQueueFull( void )
+{
+static CSUImageJob_t xJobs[ csuimageQUEUE_LENGTH + 2 ];
+UBaseType_t ux;
+
+	for( ux = 0; ux < ( csuimageQUEUE_LENGTH + 2 ); ux++ )
+	{
+		xJobs[ ux ].pvImage = ucSource;
+		xJobs[ ux ].xLength = 64;
+		xJobs[ ux ].ulExpectedChecksum = prvReferenceChecksum( ucSource, 64 );
+	}
+
+	for( ux = 0; ux < csuimageQUEUE_LENGTH; ux++ )
+	{
+		hosttestCHECK( xCSUImageSubmit( &( xJobs[ ux ] ), 0 ) == pdPASS );
+	}
+
+	/* The service task takes the first job from the queue, which leaves
+	space for one more. */
+	prvRunService();
+	hosttestCHECK( xCSUImageSubmit( &( xJobs[ csuimageQUEUE_LENGTH ] ), 0 ) == pdPASS );
+	hosttestCHECK( xCSUImageSubmit( &( xJobs[ csuimageQUEUE_LENGTH + 1 ] ), 0 ) == pdFAIL );
+	hosttestCHECK( xJobs[ csuimageQUEUE_LENGTH + 1 ].xStatus == csuimageSTATUS_FAILED );
+
+	prvDrain();
+
+	for( ux = 0; ux <= csuimageQUEUE_LENGTH; ux++ )
+	{
+		hosttestCHECK( xJobs[ ux ].xStatus == csuimageSTATUS_COMPLETE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomJobs( void )
+{
+static CSUImageJob_t xJobs[ csuimageQUEUE_LENGTH ];
+static uint8_t ucDestinations[ csuimageQUEUE_LENGTH ][ csutestBUFFER_SIZE ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+BaseType_t xExpected[ csuimageQUEUE_LENGTH ];
+CSUImageStats_t xBefore, xAfter;
+uint32_t ulFinished = 0;
+int iRound, iJobs, iJob, iErrorAt, iStep;
+size_t xOffset, xLength;
+
+	vCSUImageGetStats( &xBefore );
+
+	for( iRound = 0; iRound < csutestRANDOM_ROUNDS; iRound++ )
+	{
+		iJobs = 1 + ( rand() % csuimageQUEUE_LENGTH );
+
+		/* Jobs of random images, some copied and some with the wrong checksum,
+		submitted while the CSU DMA and the service task run at random. */
+		for( iJob = 0; iJob < iJobs; iJob++ )
+		{
+			xOffset = ( size_t ) ( rand() % 16 ) * sizeof( uint32_t );
+			xLength = sizeof( uint32_t ) * ( 1 + ( ( size_t ) rand() % ( ( csutestBUFFER_SIZE - 64 ) / sizeof( uint32_t ) ) ) );
+
+			memset( &( xJobs[ iJob ] ), 0x00, sizeof( xJobs[ iJob ] ) );
+			xJobs[ iJob ].pvImage = &( ucSource[ xOffset ] );
+			xJobs[ iJob ].xLength = xLength;
+
+			if( ( rand() & 1 ) != 0 )
+			{
+				xJobs[ iJob ].pvDestination = ucDestinations[ iJob ];
+				memset( ucDestinations[ iJob ], 0x00, xLength );
+			}
+
+			xJobs[ iJob ].ulExpectedChecksum = ulCSUImageChecksum( xJobs[ iJob ].pvImage, xLength );
+			xExpected[ iJob ] = csuimageSTATUS_COMPLETE;
+
+			if( ( rand() % 5 ) == 0 )
+			{
+				xJobs[ iJob ].ulExpectedChecksum++;
+				xExpected[ iJob ] = csuimageSTATUS_MISMATCH;
+			}
+
+			hosttestCHECK( xCSUImageSubmit( &( xJobs[ iJob ] ), 0 ) == pdPASS );
+
+			if( ( rand() & 1 ) != 0 )
+			{
+				prvRunService();
+
+				if( ( rand() & 1 ) != 0 )
+				{
+					( void ) bHostCSUDMAModelComplete( false );
+				}
+			}
+		}
+
+		/* One round in eight may end a transfer with an error. */
+		iErrorAt = ( ( rand() % 8 ) == 0 ) ? ( rand() % 20 ) : -1;
+		iStep = 0;
+
+		do
+		{
+			prvRunService();
+		} while( bHostCSUDMAModelComplete( iStep++ == iErrorAt ) != false );
+
+		prvRunService();
+
+		for( iJob = 0; iJob < iJobs; iJob++ )
+		{
+			if( xJobs[ iJob ].xStatus == csuimageSTATUS_FAILED )
+			{
+				hosttestCHECK( iErrorAt >= 0 );
+			}
+			else
+			{
+				hosttestCHECK( xJobs[ iJob ].xStatus == xExpected[ iJob ] );
+				hosttestCHECK( xJobs[ iJob ].xBytesDone == xJobs[ iJob ].xLength );
+				hosttestCHECK( xJobs[ iJob ].ulChecksum == prvReferenceChecksum( xJobs[ iJob ].pvImage, xJobs[ iJob ].xLength ) );
+
+				if( xJobs[ iJob ].pvDestination != NULL )
+				{
+					hosttestCHECK( memcmp( xJobs[ iJob ].pvDestination, xJobs[ iJob ].pvImage, xJobs[ iJob ].xLength ) == 0 );
+				}
+			}
+
+			ulFinished++;
+		}
+	}
+
+	vCSUImageGetStats( &xAfter );
+	hosttestCHECK( xAfter.ulJobs - xBefore.ulJobs == ulFinished );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+size_t x;
+
+	srand( 7 );
+
+	for( x = 0; x < sizeof( ucSource ); x++ )
+	{
+		ucSource[ x ] = ( uint8_t ) rand();
+	}
+
+	hosttestCHECK( xCSUImageInit( 3 ) == pdPASS );
+
+	prvTestSoftwareChecksum();
+	prvTestRejectedJobs();
+	prvTestVerify();
+	prvTestCopyAndMismatch();
+	prvTestError();
+	prvTestQueueFull();
+	prvTestRandomJobs();
+
+	return iHostTestResult( "CSUImageTest" );
+}
+/*-----------------------------------------------------------*/
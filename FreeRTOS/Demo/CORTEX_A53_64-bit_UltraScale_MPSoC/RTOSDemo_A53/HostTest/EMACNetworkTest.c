@@ -0,0 +1,865 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the zero copy network interface in EMACNetwork.c, built
+ * against the model of the GEM in EMACNetworkHostModel.h and the emacps
+ * driver's descriptor ring functions.
+ *
+ * The test is single threaded.  It decides when frames arrive and leave, when
+ * the MAC interrupt is taken, and when the network task runs - by calling the
+ * task's event handler, prvProcessEvents(), with the events the stubs
+ * collect.  The checks cover:
+ *
+ * + Every receive buffer no task holds being posted to the ring.
+ * + Frames being handed to tasks, and taken from tasks, as pointers to the
+ *   buffers the MAC used, without being copied.
+ * + Released buffers being posted again in batches of emacnetPOST_BATCH, or
+ *   at once when the MAC runs short.
+ * + A burst of frames costing one interrupt, and a burst bigger than the
+ *   network task's budget being finished without another interrupt.
+ *
+ * A long run of random events then checks every buffer is accounted for
+ * after each event, and every frame is delivered in order.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#define emacnetUSE_HOST_MODEL			1
+#include "EMACNetwork.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define emactestMAX_FRAMES				( 400000UL )
+#define emactestRANDOM_STEPS			200000L
+#define emactestMIN_LENGTH				14U
+#define emactestMAX_LENGTH				1514U
+
+/* The handle xTaskCreate() gives the network task. */
+#define emactestNETWORK_TASK			( ( TaskHandle_t ) &xNetworkTaskStandIn )
+
+/*-----------------------------------------------------------*/
+
+/* A queue, for the stub queue functions. */
+struct HostTestQueue
+{
+	UBaseType_t uxLength;
+	UBaseType_t uxItemSize;
+	UBaseType_t uxHead;
+	UBaseType_t uxWaiting;
+	uint8_t *pucStorage;
+};
+
+/*-----------------------------------------------------------*/
+
+/* The model MAC. */
+HostMACModel_t xHostMACModel;
+
+/* Called by the driver's asserts. */
+u32 Xil_AssertStatus;
+
+static uint8_t xNetworkTaskStandIn;
+
+/* The events sent to the network task and not yet processed, and the number
+of times it was notified. */
+static uint32_t ulPendingEvents = 0;
+static uint32_t ulNetworkNotifications = 0;
+
+/* Whether the transmit mutex is held. */
+static BaseType_t xTxMutexHeld = pdFALSE;
+
+/* The receive buffer each frame was written into, by sequence number, and
+the sequence numbers of the frames the MAC accepted, in order. */
+static uint8_t *pucFrameBuffer[ emactestMAX_FRAMES ];
+static uint32_t ulFrameLength[ emactestMAX_FRAMES ];
+static uint32_t ulAccepted[ emactestMAX_FRAMES ];
+static uint32_t ulNextSequence = 0, ulAcceptedCount = 0, ulDeliveredCount = 0;
+
+/* Receive buffers held by the test, as a task would hold them. */
+static uint8_t *pucHeld[ emacnetRX_BUFFERS ];
+static UBaseType_t uxHeld = 0;
+
+/*-----------------------------------------------------------*/
+
+void Xil_Assert( const char8 *File, s32 Line )
+{
+	vHostTestAssertCalled( File, ( int ) Line );
+}
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheFlushRange( INTPTR adr, INTPTR len )
+{
+	/* Only transmit buffers are flushed. */
+	hosttestCHECK( ( ( uint8_t * ) adr >= ucTxBuffers[ 0 ] ) && ( ( uint8_t * ) adr + len <= ucTxBuffers[ emacnetTX_BUFFERS ] ) );
+}
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheInvalidateRanges( const Xil_CacheRange *ranges, u32 num )
+{
+u32 ulRange;
+
+	hosttestCHECK( ( num > 0 ) && ( num <= emacnetRX_BATCH ) );
+
+	for( ulRange = 0; ulRange < num; ulRange++ )
+	{
+		hosttestCHECK( ( ( uint8_t * ) ranges[ ulRange ].Addr >= ucRxBuffers[ 0 ] ) && ( ( uint8_t * ) ranges[ ulRange ].Addr + ranges[ ulRange ].Len <= ucRxBuffers[ emacnetRX_BUFFERS ] ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+QueueHandle_t xQueue = calloc( 1, sizeof( *xQueue ) );
+
+	xQueue->uxLength = uxQueueLength;
+	xQueue->uxItemSize = uxItemSize;
+	xQueue->pucStorage = malloc( uxQueueLength * uxItemSize );
+
+	return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+UBaseType_t uxIndex;
+
+	/* Only one task runs, so a full queue would never empty while it
+	waited. */
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting < xQueue->uxLength )
+	{
+		uxIndex = ( xQueue->uxHead + xQueue->uxWaiting ) % xQueue->uxLength;
+		memcpy( &( xQueue->pucStorage[ uxIndex * xQueue->uxItemSize ] ), pvItemToQueue, xQueue->uxItemSize );
+		xQueue->uxWaiting++;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting > 0 )
+	{
+		memcpy( pvBuffer, &( xQueue->pucStorage[ xQueue->uxHead * xQueue->uxItemSize ] ), xQueue->uxItemSize );
+		xQueue->uxHead = ( xQueue->uxHead + 1 ) % xQueue->uxLength;
+		xQueue->uxWaiting--;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+	return xQueue->uxWaiting;
+}
+/*-----------------------------------------------------------*/
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+	return xQueueCreate( 1, 0 );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )
+{
+	/* Only one task runs, so the mutex is never held when it is taken. */
+	( void ) xBlockTime;
+	hosttestCHECK( xSemaphore == xTxMutex );
+	hosttestCHECK( xTxMutexHeld == pdFALSE );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+	xTxMutexHeld = pdTRUE;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t xSemaphore )
+{
+	hosttestCHECK( xSemaphore == xTxMutex );
+	hosttestCHECK( xTxMutexHeld != pdFALSE );
+	xTxMutexHeld = pdFALSE;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+	( void ) pxTaskCode;
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+	( void ) uxPriority;
+
+	*pxCreatedTask = emactestNETWORK_TASK;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction )
+{
+	hosttestCHECK( xTaskToNotify == emactestNETWORK_TASK );
+	hosttestCHECK( eAction == eSetBits );
+	hosttestCHECK( ( ulValue & ~emacnetALL_EVENTS ) == 0 );
+
+	ulPendingEvents |= ulValue;
+	ulNetworkNotifications++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	*pxHigherPriorityTaskWoken = pdTRUE;
+
+	return xTaskNotify( xTaskToNotify, ulValue, eAction );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+{
+	/* Only called by the network task, which the test does not run. */
+	( void ) ulBitsToClearOnEntry;
+	( void ) ulBitsToClearOnExit;
+	( void ) pulNotificationValue;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/* Run the network task until it has no events left.  Passing pdTRUE also
+runs it as if its block time had expired first. */
+static void prvRunNetworkTask( BaseType_t xTimeout )
+{
+uint32_t ulEvents;
+
+	if( xTimeout != pdFALSE )
+	{
+		prvProcessEvents( emacnetEVENT_TIMEOUT );
+	}
+
+	while( ulPendingEvents != 0 )
+	{
+		ulEvents = ulPendingEvents;
+		ulPendingEvents = 0;
+		prvProcessEvents( ulEvents );
+	}
+
+	hosttestCHECK( xTxMutexHeld == pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+/* Write frame ulSequence into pucFrame, and return its length. */
+static uint32_t prvMakeFrame( uint8_t *pucFrame, uint32_t ulSequence )
+{
+uint32_t ulLength, ul;
+
+	ulLength = emactestMIN_LENGTH + ( ( ulSequence * 2654435761UL ) % ( emactestMAX_LENGTH - emactestMIN_LENGTH + 1U ) );
+	memcpy( pucFrame, &ulSequence, sizeof( ulSequence ) );
+
+	for( ul = sizeof( ulSequence ); ul < ulLength; ul++ )
+	{
+		pucFrame[ ul ] = ( uint8_t ) ( ( ulSequence * 131U ) + ( ul * 7U ) );
+	}
+
+	return ulLength;
+}
+/*-----------------------------------------------------------*/
+
+/* Note the receive buffer the MAC will write frame ulSequence into, if it has
+one, before the MAC receives the frame. */
+static void prvExpectFrame( uint32_t ulSequence, uint32_t ulLength )
+{
+XEmacPs_Bd *pxBd = xHostMACModel.pxRxNext;
+
+	configASSERT( ulSequence < emactestMAX_FRAMES );
+
+	pucFrameBuffer[ ulSequence ] = NULL;
+	ulFrameLength[ ulSequence ] = ulLength;
+
+	if( ( XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_OFFSET ) & XEMACPS_RXBUF_NEW_MASK ) == 0 )
+	{
+		pucFrameBuffer[ ulSequence ] = pucHostMACModelBufferAddress( pxBd, XEMACPS_RXBUF_ADD_MASK );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* A frame arrives from the wire.  Returns pdTRUE if the MAC had a buffer for
+it. */
+static BaseType_t prvArrive( void )
+{
+static uint8_t ucFrame[ emacnetBUFFER_SIZE ];
+uint32_t ulSequence = ulNextSequence++, ulLength;
+BaseType_t xReturn = pdFALSE;
+
+	ulLength = prvMakeFrame( ucFrame, ulSequence );
+	prvExpectFrame( ulSequence, ulLength );
+
+	if( bHostMACModelReceive( ucFrame, ulLength ) != false )
+	{
+		hosttestCHECK( pucFrameBuffer[ ulSequence ] != NULL );
+		ulAccepted[ ulAcceptedCount++ ] = ulSequence;
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		hosttestCHECK( pucFrameBuffer[ ulSequence ] == NULL );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Take the next frame from the interface, as a task would, check it is the
+next frame the MAC accepted, in the buffer the MAC wrote it into, and hold the
+buffer.  Returns pdFALSE if no frame was waiting. */
+static BaseType_t prvReceiveAndHold( void )
+{
+static uint8_t ucExpected[ emacnetBUFFER_SIZE ];
+EMACFrame_t xFrame;
+uint32_t ulSequence;
+BaseType_t xReturn = pdFALSE;
+
+	if( xEMACNetworkReceive( &xFrame, 0 ) == pdPASS )
+	{
+		hosttestCHECK( ulDeliveredCount < ulAcceptedCount );
+		ulSequence = ulAccepted[ ulDeliveredCount++ ];
+
+		hosttestCHECK( xFrame.pucData == pucFrameBuffer[ ulSequence ] );
+		hosttestCHECK( xFrame.ulLength == ulFrameLength[ ulSequence ] );
+		( void ) prvMakeFrame( ucExpected, ulSequence );
+		hosttestCHECK( memcmp( xFrame.pucData, ucExpected, ulFrameLength[ ulSequence ] ) == 0 );
+
+		configASSERT( uxHeld < emacnetRX_BUFFERS );
+		pucHeld[ uxHeld++ ] = xFrame.pucData;
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Release the held buffer at uxIndex. */
+static void prvRelease( UBaseType_t uxIndex )
+{
+	configASSERT( uxIndex < uxHeld );
+	vEMACNetworkReleaseRxBuffer( pucHeld[ uxIndex ] );
+	pucHeld[ uxIndex ] = pucHeld[ --uxHeld ];
+}
+/*-----------------------------------------------------------*/
+
+/* Send one frame, in a buffer from the transmit pool.  Returns pdFALSE if the
+pool was empty. */
+static BaseType_t prvSend( void )
+{
+uint8_t *pucBuffer;
+uint32_t ulSequence, ulLength;
+BaseType_t xReturn = pdFALSE;
+
+	pucBuffer = pucEMACNetworkGetTxBuffer( 0 );
+
+	if( pucBuffer != NULL )
+	{
+		ulSequence = ulNextSequence++;
+		ulLength = prvMakeFrame( pucBuffer, ulSequence );
+
+		/* prvTransmitOne() reads the sequence number back out of the frame
+		when the MAC sends it. */
+		hosttestCHECK( xEMACNetworkSend( pucBuffer, ulLength ) == pdPASS );
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* The MAC sends one frame, which with loopback enabled it also receives.
+Returns pdTRUE if a frame was sent. */
+static BaseType_t prvTransmitOne( void )
+{
+XEmacPs_Bd *pxBd = xHostMACModel.pxTxNext;
+uint8_t *pucBuffer;
+uint32_t ulSequence, ulReceivedBefore = xHostMACModel.ulFramesReceived;
+BaseType_t xReturn = pdFALSE;
+
+	if( ( xHostMACModel.bTxGo != false ) && ( ( XEmacPs_BdRead( pxBd, XEMACPS_BD_STAT_OFFSET ) & XEMACPS_TXBUF_USED_MASK ) == 0 ) )
+	{
+		pucBuffer = pucHostMACModelBufferAddress( pxBd, 0xFFFFFFFFUL );
+		memcpy( &ulSequence, pucBuffer, sizeof( ulSequence ) );
+		prvExpectFrame( ulSequence, XEmacPs_BdRead( pxBd, XEMACPS_BD_STAT_OFFSET ) & XEMACPS_TXBUF_LEN_MASK );
+
+		hosttestCHECK( ulHostMACModelTransmit( 1 ) == 1 );
+
+		/* The MAC read the frame from the buffer the task wrote it into. */
+		hosttestCHECK( xHostMACModel.pucLastSent == pucBuffer );
+		hosttestCHECK( xHostMACModel.ulLastSentLength == ulFrameLength[ ulSequence ] );
+
+		if( xHostMACModel.ulFramesReceived != ulReceivedBefore )
+		{
+			ulAccepted[ ulAcceptedCount++ ] = ulSequence;
+		}
+
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		( void ) ulHostMACModelTransmit( 1 );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* The number of receive descriptors handed to the MAC and not yet filled. */
+static uint32_t prvEmptyDescriptors( void )
+{
+uint32_t ul, ulCount = 0;
+
+	for( ul = 0; ul < emacnetRX_BUFFERS; ul++ )
+	{
+		if( ( XEmacPs_BdRead( &( xDescriptorBlock.xDescriptors.xRx[ ul ] ), XEMACPS_BD_ADDR_OFFSET ) & XEMACPS_RXBUF_NEW_MASK ) == 0 )
+		{
+			ulCount++;
+		}
+	}
+
+	return ulCount;
+}
+/*-----------------------------------------------------------*/
+
+/* Every receive buffer is posted, waiting for a task, held by a task, or
+waiting to be posted again, and every transmit buffer is free or in the
+ring. */
+static void prvCheckBuffersAccountedFor( void )
+{
+XEmacPs_BdRing * const pxTxRing = &( XEmacPs_GetTxRing( &xEMACInstance ) );
+
+	hosttestCHECK( XEmacPs_GetRxRing( &xEMACInstance ).HwCnt == ulRxBuffersPosted );
+	hosttestCHECK( ( ulRxBuffersPosted + uxQueueMessagesWaiting( xRxQueue ) + uxHeld + uxQueueMessagesWaiting( xRecycleQueue ) + uxBuffersToPost ) == emacnetRX_BUFFERS );
+	hosttestCHECK( ( uxQueueMessagesWaiting( xTxFreeQueue ) + pxTxRing->HwCnt + pxTxRing->PreCnt + pxTxRing->PostCnt ) == emacnetTX_BUFFERS );
+}
+/*-----------------------------------------------------------*/
+
+/* Receive every waiting frame and release every buffer, until the network
+task has posted them all again. */
+static void prvDrain( void )
+{
+	do
+	{
+		prvRunNetworkTask( pdTRUE );
+		while( prvReceiveAndHold() != pdFALSE );
+
+		while( uxHeld > 0 )
+		{
+			prvRelease( 0 );
+		}
+
+		prvRunNetworkTask( pdTRUE );
+	} while( ( bHostMACModelRun() != false ) || ( uxQueueMessagesWaiting( xRxQueue ) > 0 ) );
+
+	hosttestCHECK( ulDeliveredCount == ulAcceptedCount );
+	hosttestCHECK( ulRxBuffersPosted == emacnetRX_BUFFERS );
+	hosttestCHECK( prvEmptyDescriptors() == emacnetRX_BUFFERS );
+	prvCheckBuffersAccountedFor();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBuffersPosted( void )
+{
+EMACNetworkStats_t xStats;
+uint8_t *pucBuffer;
+uint32_t ul, ulOther;
+
+	/* Every buffer was posted, in batches, before the receiver was
+	enabled. */
+	vEMACNetworkGetStats( &xStats );
+	hosttestCHECK( xStats.ulRxBuffersPosted == emacnetRX_BUFFERS );
+	hosttestCHECK( xStats.ulRxPostBatches == ( emacnetRX_BUFFERS / emacnetRX_BATCH ) );
+	hosttestCHECK( prvEmptyDescriptors() == emacnetRX_BUFFERS );
+	hosttestCHECK( ( xHostMACModel.ulNetworkControl & XEMACPS_NWCTRL_RXEN_MASK ) != 0 );
+	hosttestCHECK( ( xHostMACModel.ulIMR & ( emacnetRX_INTERRUPTS | emacnetTX_INTERRUPTS ) ) == 0 );
+	hosttestCHECK( ulPendingEvents == 0 );
+	prvCheckBuffersAccountedFor();
+
+	/* Each descriptor holds a different buffer. */
+	for( ul = 0; ul < emacnetRX_BUFFERS; ul++ )
+	{
+		pucBuffer = pucHostMACModelBufferAddress( &( xDescriptorBlock.xDescriptors.xRx[ ul ] ), XEMACPS_RXBUF_ADD_MASK );
+		hosttestCHECK( ( pucBuffer >= ucRxBuffers[ 0 ] ) && ( pucBuffer < ucRxBuffers[ emacnetRX_BUFFERS ] ) );
+
+		for( ulOther = 0; ulOther < ul; ulOther++ )
+		{
+			hosttestCHECK( pucBuffer != pucHostMACModelBufferAddress( &( xDescriptorBlock.xDescriptors.xRx[ ulOther ] ), XEMACPS_RXBUF_ADD_MASK ) );
+		}
+	}
+
+	/* Only the last descriptor wraps. */
+	for( ul = 0; ul < emacnetRX_BUFFERS; ul++ )
+	{
+		hosttestCHECK( ( ( XEmacPs_BdRead( &( xDescriptorBlock.xDescriptors.xRx[ ul ] ), XEMACPS_BD_ADDR_OFFSET ) & XEMACPS_RXBUF_WRAP_MASK ) != 0 ) == ( ul == ( emacnetRX_BUFFERS - 1 ) ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestReceiveByPointer( void )
+{
+EMACNetworkStats_t xBefore, xAfter;
+uint32_t ul;
+
+	vEMACNetworkGetStats( &xBefore );
+
+	/* Each frame is passed to the task in the buffer the MAC wrote it into,
+	which prvReceiveAndHold() checks. */
+	for( ul = 0; ul < 5; ul++ )
+	{
+		hosttestCHECK( prvArrive() == pdTRUE );
+		( void ) bHostMACModelRun();
+	}
+
+	prvRunNetworkTask( pdFALSE );
+
+	for( ul = 0; ul < 5; ul++ )
+	{
+		hosttestCHECK( prvReceiveAndHold() == pdTRUE );
+	}
+
+	hosttestCHECK( prvReceiveAndHold() == pdFALSE );
+	hosttestCHECK( ulRxBuffersPosted == ( emacnetRX_BUFFERS - 5 ) );
+	hosttestCHECK( prvEmptyDescriptors() == ( emacnetRX_BUFFERS - 5 ) );
+	prvCheckBuffersAccountedFor();
+
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxFrames - xBefore.ulRxFrames ) == 5 );
+
+	/* A frame the task sends is read from the buffer the task wrote it into,
+	and with loopback enabled is received into a receive buffer. */
+	hosttestCHECK( prvSend() == pdTRUE );
+	hosttestCHECK( uxQueueMessagesWaiting( xTxFreeQueue ) == ( emacnetTX_BUFFERS - 1 ) );
+	hosttestCHECK( prvTransmitOne() == pdTRUE );
+	hosttestCHECK( bHostMACModelRun() != false );
+	prvRunNetworkTask( pdFALSE );
+
+	/* The sent buffer went back to the pool. */
+	hosttestCHECK( uxQueueMessagesWaiting( xTxFreeQueue ) == emacnetTX_BUFFERS );
+	hosttestCHECK( prvReceiveAndHold() == pdTRUE );
+	prvCheckBuffersAccountedFor();
+
+	prvDrain();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBatchedRecycling( void )
+{
+EMACNetworkStats_t xBefore, xAfter;
+uint32_t ul, ulNotifications;
+
+	/* The task holds 20 buffers, which leaves more than emacnetRX_LOW_WATER
+	posted. */
+	for( ul = 0; ul < 20; ul++ )
+	{
+		hosttestCHECK( prvArrive() == pdTRUE );
+	}
+
+	( void ) bHostMACModelRun();
+	prvRunNetworkTask( pdFALSE );
+
+	while( prvReceiveAndHold() != pdFALSE );
+
+	hosttestCHECK( uxHeld == 20 );
+	vEMACNetworkGetStats( &xBefore );
+
+	/* Released buffers gather without waking the network task until
+	emacnetPOST_BATCH are waiting. */
+	ulNotifications = ulNetworkNotifications;
+
+	for( ul = 0; ul < ( emacnetPOST_BATCH - 1 ); ul++ )
+	{
+		prvRelease( 0 );
+	}
+
+	hosttestCHECK( ulNetworkNotifications == ulNotifications );
+	hosttestCHECK( uxQueueMessagesWaiting( xRecycleQueue ) == ( emacnetPOST_BATCH - 1 ) );
+	prvCheckBuffersAccountedFor();
+
+	prvRelease( 0 );
+	hosttestCHECK( ulNetworkNotifications == ( ulNotifications + 1 ) );
+	hosttestCHECK( ulPendingEvents == emacnetEVENT_POST );
+	prvRunNetworkTask( pdFALSE );
+
+	/* They were posted as one batch. */
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxPostBatches - xBefore.ulRxPostBatches ) == 1 );
+	hosttestCHECK( ( xAfter.ulRxBuffersPosted - xBefore.ulRxBuffersPosted ) == emacnetPOST_BATCH );
+	hosttestCHECK( ulRxBuffersPosted == ( emacnetRX_BUFFERS - 20 + emacnetPOST_BATCH ) );
+	hosttestCHECK( prvEmptyDescriptors() == ulRxBuffersPosted );
+	prvCheckBuffersAccountedFor();
+
+	/* Fewer than emacnetPOST_BATCH buffers wait for the network task's block
+	time to expire. */
+	for( ul = 0; ul < 3; ul++ )
+	{
+		prvRelease( 0 );
+	}
+
+	prvRunNetworkTask( pdFALSE );
+	vEMACNetworkGetStats( &xBefore );
+	hosttestCHECK( xBefore.ulRxBuffersPosted == xAfter.ulRxBuffersPosted );
+
+	prvRunNetworkTask( pdTRUE );
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxPostBatches - xBefore.ulRxPostBatches ) == 1 );
+	hosttestCHECK( ( xAfter.ulRxBuffersPosted - xBefore.ulRxBuffersPosted ) == 3 );
+	prvCheckBuffersAccountedFor();
+
+	prvDrain();
+
+	/* Once fewer than emacnetRX_LOW_WATER buffers are posted each released
+	buffer is posted straight away. */
+	for( ul = 0; ul < ( emacnetRX_BUFFERS - emacnetRX_LOW_WATER + 2 ); ul++ )
+	{
+		hosttestCHECK( prvArrive() == pdTRUE );
+	}
+
+	( void ) bHostMACModelRun();
+	prvRunNetworkTask( pdFALSE );
+
+	while( prvReceiveAndHold() != pdFALSE );
+
+	hosttestCHECK( ulRxBuffersPosted == ( emacnetRX_LOW_WATER - 2 ) );
+
+	for( ul = 0; ul < 2; ul++ )
+	{
+		vEMACNetworkGetStats( &xBefore );
+		prvRelease( 0 );
+		hosttestCHECK( ulPendingEvents == emacnetEVENT_POST );
+		prvRunNetworkTask( pdFALSE );
+		vEMACNetworkGetStats( &xAfter );
+		hosttestCHECK( ( xAfter.ulRxBuffersPosted - xBefore.ulRxBuffersPosted ) == 1 );
+	}
+
+	hosttestCHECK( ulRxBuffersPosted == emacnetRX_LOW_WATER );
+	prvDrain();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestInterruptCoalescing( void )
+{
+EMACNetworkStats_t xBefore, xAfter;
+uint32_t ul, ulInterrupts = 0;
+
+	vEMACNetworkGetStats( &xBefore );
+
+	/* A burst of 40 frames.  The first interrupt masks the receive interrupt,
+	so the rest arrive without one. */
+	for( ul = 0; ul < 40; ul++ )
+	{
+		hosttestCHECK( prvArrive() == pdTRUE );
+
+		if( bHostMACModelRun() != false )
+		{
+			ulInterrupts++;
+		}
+	}
+
+	hosttestCHECK( ulInterrupts == 1 );
+	hosttestCHECK( ( xHostMACModel.ulIMR & emacnetRX_INTERRUPTS ) == emacnetRX_INTERRUPTS );
+
+	/* The network task takes the frames in batches of emacnetRX_BATCH, then
+	unmasks the interrupt with no status left latched. */
+	prvRunNetworkTask( pdFALSE );
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxInterrupts - xBefore.ulRxInterrupts ) == 1 );
+	hosttestCHECK( ( xAfter.ulRxPolls - xBefore.ulRxPolls ) == 3 );
+	hosttestCHECK( ( xAfter.ulRxFrames - xBefore.ulRxFrames ) == 40 );
+	hosttestCHECK( ( xHostMACModel.ulIMR & emacnetRX_INTERRUPTS ) == 0 );
+	hosttestCHECK( ( xHostMACModel.ulISR & emacnetRX_INTERRUPTS ) == 0 );
+	hosttestCHECK( bHostMACModelRun() == false );
+	prvDrain();
+
+	/* A burst that fills every buffer uses the network task's whole budget.
+	It notifies itself to finish, still without another interrupt. */
+	vEMACNetworkGetStats( &xBefore );
+
+	for( ul = 0; ul < emacnetRX_BUFFERS; ul++ )
+	{
+		hosttestCHECK( prvArrive() == pdTRUE );
+		( void ) bHostMACModelRun();
+	}
+
+	ulInterrupts = ulNetworkNotifications;
+	prvRunNetworkTask( pdFALSE );
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxInterrupts - xBefore.ulRxInterrupts ) == 1 );
+	hosttestCHECK( ( xAfter.ulRxPolls - xBefore.ulRxPolls ) == ( emacnetRX_BUFFERS / emacnetRX_BATCH ) );
+	hosttestCHECK( ( ulNetworkNotifications - ulInterrupts ) == 1 );
+	hosttestCHECK( ( xHostMACModel.ulIMR & emacnetRX_INTERRUPTS ) == 0 );
+	hosttestCHECK( ulRxBuffersPosted == 0 );
+
+	/* With every buffer waiting for a task the MAC drops the next frame, and
+	the interrupt reports it. */
+	hosttestCHECK( prvArrive() == pdFALSE );
+	hosttestCHECK( bHostMACModelRun() != false );
+	prvRunNetworkTask( pdFALSE );
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulRxNoBuffer - xBefore.ulRxNoBuffer ) == 1 );
+	hosttestCHECK( xHostMACModel.ulFramesDropped == 1 );
+	prvDrain();
+
+	/* Ten frames sent back to back are reclaimed after one transmit
+	interrupt. */
+	vEMACNetworkGetStats( &xBefore );
+	ulInterrupts = 0;
+
+	for( ul = 0; ul < 10; ul++ )
+	{
+		hosttestCHECK( prvSend() == pdTRUE );
+	}
+
+	for( ul = 0; ul < 10; ul++ )
+	{
+		hosttestCHECK( prvTransmitOne() == pdTRUE );
+
+		if( bHostMACModelRun() != false )
+		{
+			ulInterrupts++;
+		}
+	}
+
+	hosttestCHECK( ulInterrupts == 1 );
+	prvRunNetworkTask( pdFALSE );
+	vEMACNetworkGetStats( &xAfter );
+	hosttestCHECK( ( xAfter.ulTxInterrupts - xBefore.ulTxInterrupts ) == 1 );
+	hosttestCHECK( ( xAfter.ulTxFrames - xBefore.ulTxFrames ) == 10 );
+	hosttestCHECK( uxQueueMessagesWaiting( xTxFreeQueue ) == emacnetTX_BUFFERS );
+	prvDrain();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomEvents( void )
+{
+EMACNetworkStats_t xStats;
+long lStep;
+
+	for( lStep = 0; lStep < emactestRANDOM_STEPS; lStep++ )
+	{
+		switch( rand() % 8 )
+		{
+			case 0 :
+			case 1 :
+				( void ) prvArrive();
+				break;
+
+			case 2 :
+				( void ) bHostMACModelRun();
+				break;
+
+			case 3 :
+				prvRunNetworkTask( ( ( rand() % 4 ) == 0 ) ? pdTRUE : pdFALSE );
+				break;
+
+			case 4 :
+				( void ) prvReceiveAndHold();
+				break;
+
+			case 5 :
+				if( uxHeld > 0 )
+				{
+					prvRelease( ( UBaseType_t ) rand() % uxHeld );
+				}
+				break;
+
+			case 6 :
+				( void ) prvSend();
+				break;
+
+			default :
+				( void ) prvTransmitOne();
+				break;
+		}
+
+		prvCheckBuffersAccountedFor();
+	}
+
+	/* Send what is left in the ring, then receive everything. */
+	while( prvTransmitOne() != pdFALSE );
+
+	prvDrain();
+
+	while( ( bHostMACModelRun() != false ) || ( ulPendingEvents != 0 ) )
+	{
+		prvRunNetworkTask( pdFALSE );
+	}
+
+	hosttestCHECK( uxQueueMessagesWaiting( xTxFreeQueue ) == emacnetTX_BUFFERS );
+
+	vEMACNetworkGetStats( &xStats );
+	hosttestCHECK( xStats.ulRxFrames == ulDeliveredCount );
+	hosttestCHECK( xStats.ulRxQueueFull == 0 );
+	hosttestCHECK( xStats.ulRxBadFrames == 0 );
+	hosttestCHECK( xStats.ulErrorInterrupts == 0 );
+
+	/* Frames dropped while the status was latched share one count. */
+	hosttestCHECK( xStats.ulRxNoBuffer <= xHostMACModel.ulFramesDropped );
+	hosttestCHECK( ( xStats.ulRxNoBuffer == 0 ) == ( xHostMACModel.ulFramesDropped == 0 ) );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+const uint8_t ucMACAddress[ 6 ] = { 0x00, 0x0A, 0x35, 0x00, 0x01, 0x02 };
+
+	hosttestCHECK( xEMACNetworkInit( ucMACAddress, pdTRUE, 3 ) == pdPASS );
+
+	prvTestBuffersPosted();
+	prvTestReceiveByPointer();
+	prvTestBatchedRecycling();
+	prvTestInterruptCoalescing();
+	prvTestRandomEvents();
+
+	return iHostTestResult( "EMACNetworkTest" );
+}
+/*-----------------------------------------------------------*/
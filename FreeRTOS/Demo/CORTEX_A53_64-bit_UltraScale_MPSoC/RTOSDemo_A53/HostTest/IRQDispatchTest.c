@@ -0,0 +1,263 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * Host test for the GIC interrupt dispatcher in IRQDispatch.c, built against
+ * the model of the XScuGic handler table, counter and core ID in
+ * IRQDispatchHostModel.h.  CMakeLists.txt builds it with and without
+ * irqdispatchCOLLECT_STATS.
+ *
+ * Checks that an entry is copied lazily the first time its interrupt is
+ * taken, that vIRQDispatchInit() copies the driver's stub handler so a later
+ * XScuGic_Connect() needs vIRQDispatchUpdate(), that the spurious IDs and IDs
+ * beyond the table are discarded, that the SGI source core bits of ICCIAR are
+ * ignored, and that a handler can take a nested interrupt.  With statistics
+ * collected, the counts and times of the nested and the nesting interrupt,
+ * taken on more than one core, are checked against the time the handlers
+ * added to the model's counter.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* The code under test. */
+#define irqdispatchUSE_HOST_MODEL		1
+#include "IRQDispatch.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+/* The IDs used by the test.  The time a handler takes, in counts, is its
+callback reference. */
+#define irqtestLAZY_ID					30U
+#define irqtestTIMED_ID					7U
+#define irqtestNESTING_ID				5U
+#define irqtestLATE_ID					1U
+#define irqtestSGI_ID					3U
+
+/* The time the nesting handler takes before and after the nested interrupt. */
+#define irqtestNESTING_TIME				10U
+
+/* The ICCIAR source core field, used to check that it is masked off. */
+#define irqtestSOURCE_CORE( x )			( ( uint32_t ) ( x ) << 10 )
+
+/*-----------------------------------------------------------*/
+
+/* The model's handler table and counter. */
+HostIRQModel_t xHostIRQModel;
+
+/* The number of times each handler ran. */
+static uint32_t ulStubCalls = 0;
+static uint32_t ulHandlerCalls[ irqhostNUM_IDS ];
+static uint32_t ulNestingCalls = 0;
+static uint32_t ulLateCalls = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Stands in for the XScuGic driver's stub handler, installed for every ID
+that has no handler of its own. */
+static void prvStubHandler( void *pvCallBackRef )
+{
+	( void ) pvCallBackRef;
+	ulStubCalls++;
+}
+/*-----------------------------------------------------------*/
+
+/* A handler that takes the time given by its callback reference.  The ID it
+is installed for is found from the time, as each ID is given its own time. */
+static void prvTimedHandler( void *pvCallBackRef )
+{
+uint32_t ulTime = ( uint32_t ) ( uintptr_t ) pvCallBackRef;
+
+	ulHandlerCalls[ ulTime ]++;
+	xHostIRQModel.ullCounter += ulTime;
+}
+/*-----------------------------------------------------------*/
+
+/* A handler that is interrupted by irqtestTIMED_ID part way through. */
+static void prvNestingHandler( void *pvCallBackRef )
+{
+	( void ) pvCallBackRef;
+	ulNestingCalls++;
+	xHostIRQModel.ullCounter += irqtestNESTING_TIME;
+	vIRQDispatch( irqtestTIMED_ID );
+	xHostIRQModel.ullCounter += irqtestNESTING_TIME;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLateHandler( void *pvCallBackRef )
+{
+	( void ) pvCallBackRef;
+	ulLateCalls++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvConnect( uint32_t ulInterruptID, void ( *pxHandler )( void * ), void *pvCallBackRef )
+{
+	xHostIRQModel.xHandlerTable[ ulInterruptID ].Handler = pxHandler;
+	xHostIRQModel.xHandlerTable[ ulInterruptID ].CallBackRef = pvCallBackRef;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestLazyCopy( void )
+{
+	/* Before vIRQDispatchInit() is called every entry is empty, so the entry
+	is copied when its interrupt is first taken. */
+	prvConnect( irqtestLAZY_ID, prvTimedHandler, ( void * ) ( uintptr_t ) irqtestLAZY_ID );
+	vIRQDispatch( irqtestLAZY_ID );
+	hosttestCHECK( ulHandlerCalls[ irqtestLAZY_ID ] == 1 );
+	hosttestCHECK( ulStubCalls == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestInitAndUpdate( void )
+{
+	vIRQDispatchInit();
+
+	/* Handlers connected after vIRQDispatchInit() are not seen until the
+	entry is updated, as the stub handler was copied for them. */
+	prvConnect( irqtestTIMED_ID, prvTimedHandler, ( void * ) ( uintptr_t ) irqtestTIMED_ID );
+	prvConnect( irqtestNESTING_ID, prvNestingHandler, NULL );
+	vIRQDispatch( irqtestTIMED_ID );
+	hosttestCHECK( ulHandlerCalls[ irqtestTIMED_ID ] == 0 );
+	hosttestCHECK( ulStubCalls == 1 );
+
+	vIRQDispatchUpdate( irqtestTIMED_ID );
+	vIRQDispatchUpdate( irqtestNESTING_ID );
+	vIRQDispatch( irqtestTIMED_ID );
+	hosttestCHECK( ulHandlerCalls[ irqtestTIMED_ID ] == 1 );
+
+	/* The same again for an entry that was taken before it was connected. */
+	prvConnect( irqtestLATE_ID, prvLateHandler, NULL );
+	vIRQDispatch( irqtestLATE_ID );
+	hosttestCHECK( ulLateCalls == 0 );
+	hosttestCHECK( ulStubCalls == 2 );
+	vIRQDispatchUpdate( irqtestLATE_ID );
+	vIRQDispatch( irqtestLATE_ID );
+	hosttestCHECK( ulLateCalls == 1 );
+	hosttestCHECK( ulStubCalls == 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestDiscardedIDs( void )
+{
+uint32_t ulID;
+
+	/* The spurious IDs and anything else beyond the table call nothing. */
+	for( ulID = ulIRQDispatchNumIDs(); ulID <= irqdispatchINTERRUPT_ID_MASK; ulID++ )
+	{
+		vIRQDispatch( ulID );
+		vIRQDispatch( ulID | irqtestSOURCE_CORE( 3 ) );
+	}
+
+	hosttestCHECK( ulIRQDispatchNumIDs() == irqhostNUM_IDS );
+	hosttestCHECK( ulStubCalls == 2 );
+
+	/* The source core of an SGI selects the same entry as the bare ID. */
+	prvConnect( irqtestSGI_ID, prvTimedHandler, ( void * ) ( uintptr_t ) irqtestSGI_ID );
+	vIRQDispatchUpdate( irqtestSGI_ID );
+	vIRQDispatch( irqtestSGI_ID | irqtestSOURCE_CORE( 1 ) );
+	vIRQDispatch( irqtestSGI_ID | irqtestSOURCE_CORE( 2 ) );
+	hosttestCHECK( ulHandlerCalls[ irqtestSGI_ID ] == 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestNestingAndStats( void )
+{
+uint32_t ulCore;
+IRQStats_t xIRQStats;
+
+	/* Take the timed interrupt on each core, then nest it inside another
+	interrupt on the last core. */
+	for( ulCore = 0; ulCore < irqdispatchNUM_CORES; ulCore++ )
+	{
+		xHostIRQModel.ulCoreID = ulCore;
+		vIRQDispatch( irqtestTIMED_ID );
+	}
+
+	vIRQDispatch( irqtestNESTING_ID );
+	hosttestCHECK( ulNestingCalls == 1 );
+	hosttestCHECK( ulHandlerCalls[ irqtestTIMED_ID ] == 1 + irqdispatchNUM_CORES + 1 );
+	xHostIRQModel.ulCoreID = 0;
+
+	#if( irqdispatchCOLLECT_STATS == 1 )
+	{
+		/* The timed ID was taken once through the stub handler, which took
+		no time, once after the update, once on each core, and once nested. */
+		hosttestCHECK( xIRQDispatchGetStats( irqtestTIMED_ID, &xIRQStats ) == pdPASS );
+		hosttestCHECK( xIRQStats.ulCount == 1 + 1 + irqdispatchNUM_CORES + 1 );
+		hosttestCHECK( xIRQStats.ullTotalTime == ( uint64_t ) irqtestTIMED_ID * ( 1 + irqdispatchNUM_CORES + 1 ) );
+		hosttestCHECK( xIRQStats.ulMaxTime == irqtestTIMED_ID );
+
+		/* The nesting handler's time includes the nested interrupt. */
+		hosttestCHECK( xIRQDispatchGetStats( irqtestNESTING_ID, &xIRQStats ) == pdPASS );
+		hosttestCHECK( xIRQStats.ulCount == 1 );
+		hosttestCHECK( xIRQStats.ullTotalTime == ( 2 * irqtestNESTING_TIME ) + irqtestTIMED_ID );
+		hosttestCHECK( xIRQStats.ulMaxTime == ( 2 * irqtestNESTING_TIME ) + irqtestTIMED_ID );
+
+		/* The SGI was taken twice on core 0. */
+		hosttestCHECK( xIRQDispatchGetStats( irqtestSGI_ID, &xIRQStats ) == pdPASS );
+		hosttestCHECK( xIRQStats.ulCount == 2 );
+		hosttestCHECK( xIRQStats.ullTotalTime == 2 * irqtestSGI_ID );
+
+		/* Only the counters of the core that took an interrupt change. */
+		hosttestCHECK( xStats[ 0 ][ irqtestSGI_ID ].ulCount == 2 );
+		hosttestCHECK( xStats[ 1 ][ irqtestSGI_ID ].ulCount == 0 );
+
+		/* Untaken and out of range IDs. */
+		hosttestCHECK( xIRQDispatchGetStats( irqtestLAZY_ID + 1, &xIRQStats ) == pdPASS );
+		hosttestCHECK( xIRQStats.ulCount == 0 );
+		hosttestCHECK( xIRQDispatchGetStats( irqhostNUM_IDS, &xIRQStats ) == pdFAIL );
+	}
+	#else
+	{
+		hosttestCHECK( xIRQDispatchGetStats( irqtestTIMED_ID, &xIRQStats ) == pdFAIL );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+uint32_t ulID;
+
+	/* The driver installs its stub handler for every ID when it is
+	initialised. */
+	for( ulID = 0; ulID < irqhostNUM_IDS; ulID++ )
+	{
+		prvConnect( ulID, prvStubHandler, NULL );
+	}
+
+	prvTestLazyCopy();
+	prvTestInitAndUpdate();
+	prvTestDiscardedIDs();
+	prvTestNestingAndStats();
+
+	return iHostTestResult( "IRQDispatchTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,441 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * Host test for the interrupt driven console in UARTConsole.c, built against
+ * the fake UART register file in UARTConsoleHostModel.h.
+ *
+ * The test is single threaded.  The line only sends bytes, and the UART
+ * interrupt is only taken, where the test says so, and a blocking writer's
+ * wait for a notification is modelled by ticks during which the line sends
+ * uartctestBYTES_PER_TICK bytes and the interrupt is taken.  Another task's
+ * non-blocking writes can be made from inside that wait, while the blocking
+ * writer holds the writer mutex.  After each test the line is drained, and
+ * the bytes sent must be exactly the bytes each write reported as copied, in
+ * order, with nothing lost to a full FIFO and the FIFO empty interrupt left
+ * disabled.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#define uartconsoleUSE_HOST_MODEL		1
+#include "UARTConsole.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+/* The bytes the line sends per tick while a blocking writer waits. */
+#define uartctestBYTES_PER_TICK			16U
+
+#define uartctestSOURCE_SIZE			30000U
+#define uartctestRANDOM_STEPS			200000L
+#define uartctestOVERFLOW_WRITES		100
+#define uartctestOVERFLOW_LENGTH		77U
+#define uartctestTIMEOUT_LENGTH			10000U
+#define uartctestTIMEOUT_TICKS			5U
+
+/* The handle the stubs give the single task. */
+#define uartctestTASK					( ( TaskHandle_t ) &xHostUARTModel )
+
+/*-----------------------------------------------------------*/
+
+/* The fake UART. */
+HostUARTModel_t xHostUARTModel;
+
+/* The data written, and what the line should have sent. */
+static char cSource[ uartctestSOURCE_SIZE ];
+static char cExpected[ uarthostCAPTURE_SIZE ];
+static uint32_t ulExpected = 0;
+
+/* The stub kernel's state. */
+static TickType_t xTickCount = 0;
+static uint32_t ulNotificationValue = 0;
+static BaseType_t xMutexHeld = pdFALSE;
+static uint32_t ulBytesPerTick = uartctestBYTES_PER_TICK;
+
+/* Called on each tick of a blocking writer's wait, to play the part of other
+tasks. */
+static void ( *pxDuringWait )( void ) = NULL;
+
+/*-----------------------------------------------------------*/
+
+static void prvTick( void )
+{
+	xTickCount++;
+	( void ) ulHostUARTModelShiftOut( ulBytesPerTick );
+
+	while( bHostUARTModelRun() != false )
+	{
+	}
+
+	if( pxDuringWait != NULL )
+	{
+		pxDuringWait();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	pxTimeOut->xOverflowCount = 0;
+	pxTimeOut->xTimeOnEntering = xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+BaseType_t xReturn = pdFALSE;
+TickType_t xElapsed = xTickCount - pxTimeOut->xTimeOnEntering;
+
+	if( *pxTicksToWait != portMAX_DELAY )
+	{
+		if( xElapsed >= *pxTicksToWait )
+		{
+			*pxTicksToWait = 0;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			*pxTicksToWait -= xElapsed;
+			vTaskSetTimeOutState( pxTimeOut );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return uartctestTASK;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+uint32_t ulReturn;
+TickType_t xWaited = 0;
+
+	( void ) uxIndexToWaitOn;
+
+	/* Must not wait inside a critical section. */
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	while( ( ulNotificationValue == 0 ) && ( xWaited < xTicksToWait ) )
+	{
+		prvTick();
+		xWaited++;
+	}
+
+	ulReturn = ulNotificationValue;
+
+	if( xClearCountOnExit != pdFALSE )
+	{
+		ulNotificationValue = 0;
+	}
+	else if( ulNotificationValue != 0 )
+	{
+		ulNotificationValue--;
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	( void ) uxIndexToNotify;
+	hosttestCHECK( xTaskToNotify == uartctestTASK );
+	ulNotificationValue++;
+	*pxHigherPriorityTaskWoken = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+	return ( SemaphoreHandle_t ) &xMutexHeld;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xSemaphore;
+
+	/* Only one task runs, so a held mutex could never be given while the
+	caller waited. */
+	if( xMutexHeld == pdFALSE )
+	{
+		xMutexHeld = pdTRUE;
+		xReturn = pdPASS;
+	}
+	else
+	{
+		hosttestCHECK( xBlockTime == 0 );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t xSemaphore )
+{
+	( void ) xSemaphore;
+	hosttestCHECK( xMutexHeld != pdFALSE );
+	xMutexHeld = pdFALSE;
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWrite( const char *pcData, size_t xLength, TickType_t xTicksToWait )
+{
+size_t xWritten;
+
+	xWritten = xUARTConsoleWrite( pcData, xLength, xTicksToWait );
+
+	/* A write that does not block is copied whole or not at all. */
+	if( xTicksToWait == 0 )
+	{
+		hosttestCHECK( ( xWritten == 0 ) || ( xWritten == xLength ) );
+	}
+
+	hosttestCHECK( xWritten <= xLength );
+	memcpy( &( cExpected[ ulExpected ] ), pcData, xWritten );
+	ulExpected += ( uint32_t ) xWritten;
+
+	return xWritten;
+}
+/*-----------------------------------------------------------*/
+
+/* Let the line send everything, then check what it sent, and start the next
+test with an empty capture. */
+static void prvDrainAndCheck( void )
+{
+UARTConsoleStats_t xConsoleStats;
+uint32_t ulSteps = 0;
+
+	while( ( ulHostUARTModelShiftOut( uarthostFIFO_SIZE ) != 0 ) || ( bHostUARTModelRun() != false ) )
+	{
+		while( bHostUARTModelRun() != false )
+		{
+		}
+
+		ulSteps++;
+
+		if( ulSteps > uartconsoleTX_BUFFER_SIZE )
+		{
+			/* The console stopped making progress. */
+			hosttestCHECK( ulSteps <= uartconsoleTX_BUFFER_SIZE );
+			break;
+		}
+	}
+
+	vUARTConsoleGetStats( &xConsoleStats );
+	hosttestCHECK( xHostUARTModel.ulCaptured == ulExpected );
+	hosttestCHECK( memcmp( xHostUARTModel.cCaptured, cExpected, ulExpected ) == 0 );
+	hosttestCHECK( xHostUARTModel.ulFIFOOverflows == 0 );
+	hosttestCHECK( ( xHostUARTModel.ulIMR & XUARTPS_IXR_TXEMPTY ) == 0 );
+	hosttestCHECK( xConsoleStats.ulBytesSent == xConsoleStats.ulBytesQueued );
+	hosttestCHECK( xConsoleStats.ulHighWaterMark <= uartconsoleTX_BUFFER_SIZE );
+	hosttestCHECK( xMutexHeld == pdFALSE );
+
+	xHostUARTModel.ulCaptured = 0;
+	ulExpected = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestIdleStart( void )
+{
+	/* A write to an idle transmitter fills the FIFO itself, and only needs the
+	interrupt if the FIFO cannot take it all. */
+	( void ) prvWrite( cSource, 10, 0 );
+	hosttestCHECK( xHostUARTModel.ulFIFOCount == 10 );
+	hosttestCHECK( ( xHostUARTModel.ulIMR & XUARTPS_IXR_TXEMPTY ) == 0 );
+
+	( void ) prvWrite( cSource, 100, 0 );
+	hosttestCHECK( xHostUARTModel.ulFIFOCount == uarthostFIFO_SIZE );
+	hosttestCHECK( ( xHostUARTModel.ulIMR & XUARTPS_IXR_TXEMPTY ) != 0 );
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestOverflow( void )
+{
+UARTConsoleStats_t xBefore, xAfter;
+uint32_t ulDropped = 0;
+int iWrite;
+
+	/* With the line stalled, whole messages are dropped once the ring buffer
+	fills. */
+	vUARTConsoleGetStats( &xBefore );
+
+	for( iWrite = 0; iWrite < uartctestOVERFLOW_WRITES; iWrite++ )
+	{
+		if( prvWrite( &( cSource[ iWrite ] ), uartctestOVERFLOW_LENGTH, 0 ) == 0 )
+		{
+			ulDropped++;
+		}
+	}
+
+	vUARTConsoleGetStats( &xAfter );
+	hosttestCHECK( ulDropped > 0 );
+	hosttestCHECK( xAfter.ulMessagesDropped - xBefore.ulMessagesDropped == ulDropped );
+	hosttestCHECK( xAfter.ulBytesDropped - xBefore.ulBytesDropped == ulDropped * uartctestOVERFLOW_LENGTH );
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandom( void )
+{
+long lStep;
+
+	/* Writes, line progress and interrupts in a random order. */
+	for( lStep = 0; lStep < uartctestRANDOM_STEPS; lStep++ )
+	{
+		switch( rand() % 4 )
+		{
+			case 0:
+				( void ) prvWrite( &( cSource[ rand() % 1000 ] ), ( size_t ) ( rand() % 200 ), 0 );
+				break;
+
+			case 1:
+				( void ) ulHostUARTModelShiftOut( ( uint32_t ) ( rand() % 80 ) );
+				break;
+
+			default:
+				while( bHostUARTModelRun() != false )
+				{
+				}
+				break;
+		}
+
+		/* Keep within the capture buffer. */
+		if( ulExpected > ( uarthostCAPTURE_SIZE / 2 ) )
+		{
+			prvDrainAndCheck();
+		}
+	}
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+static void prvNonBlockingWriteDuringWait( void )
+{
+	/* Another task's message must not be copied into the middle of the
+	blocking write, even when there is space for it. */
+	hosttestCHECK( xMutexHeld != pdFALSE );
+	hosttestCHECK( prvWrite( "interleaved", 11, 0 ) == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBlocking( void )
+{
+UARTConsoleStats_t xBefore, xAfter;
+
+	/* A blocking write larger than the ring buffer waits for the line, and
+	other tasks' messages are dropped while it is in progress. */
+	vUARTConsoleGetStats( &xBefore );
+	pxDuringWait = prvNonBlockingWriteDuringWait;
+	hosttestCHECK( prvWrite( cSource, uartctestSOURCE_SIZE, portMAX_DELAY ) == uartctestSOURCE_SIZE );
+	pxDuringWait = NULL;
+	vUARTConsoleGetStats( &xAfter );
+
+	hosttestCHECK( xAfter.ulWriterBlocks > xBefore.ulWriterBlocks );
+	hosttestCHECK( xAfter.ulMessagesDropped > xBefore.ulMessagesDropped );
+	hosttestCHECK( xAfter.ulBytesDropped - xBefore.ulBytesDropped == ( xAfter.ulMessagesDropped - xBefore.ulMessagesDropped ) * 11U );
+
+	/* Once the blocking write is complete other writes get through again. */
+	hosttestCHECK( prvWrite( "after", 5, 0 ) == 5 );
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestTimeout( void )
+{
+UARTConsoleStats_t xBefore, xAfter;
+size_t xWritten;
+
+	/* With the line stalled, a blocking write copies what fits in the FIFO
+	and the ring buffer, then gives up on the rest. */
+	ulBytesPerTick = 0;
+	vUARTConsoleGetStats( &xBefore );
+	xWritten = prvWrite( cSource, uartctestTIMEOUT_LENGTH, uartctestTIMEOUT_TICKS );
+	vUARTConsoleGetStats( &xAfter );
+	ulBytesPerTick = uartctestBYTES_PER_TICK;
+
+	hosttestCHECK( xWritten == uartconsoleTX_BUFFER_SIZE + uarthostFIFO_SIZE );
+	hosttestCHECK( xAfter.ulBytesQueued - xBefore.ulBytesQueued == xWritten );
+	hosttestCHECK( xAfter.ulBytesDropped - xBefore.ulBytesDropped == uartctestTIMEOUT_LENGTH - xWritten );
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestPrintf( void )
+{
+const char *pcMessage = "Pass, status code = 0, tick count = 1234\r\n";
+
+	hosttestCHECK( lUARTConsolePrintf( "%s, status code = %lu, tick count = %lu\r\n", "Pass", 0UL, 1234UL ) == ( int ) strlen( pcMessage ) );
+	memcpy( &( cExpected[ ulExpected ] ), pcMessage, strlen( pcMessage ) );
+	ulExpected += ( uint32_t ) strlen( pcMessage );
+
+	prvDrainAndCheck();
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+uint32_t ulIndex;
+
+	srand( 5 );
+
+	for( ulIndex = 0; ulIndex < uartctestSOURCE_SIZE; ulIndex++ )
+	{
+		cSource[ ulIndex ] = ( char ) ( 'A' + ( rand() % 26 ) );
+	}
+
+	hosttestCHECK( xUARTConsoleInit() == pdPASS );
+
+	prvTestIdleStart();
+	prvTestOverflow();
+	prvTestRandom();
+	prvTestBlocking();
+	prvTestTimeout();
+	prvTestPrintf();
+
+	return iHostTestResult( "UARTConsoleTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,252 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the BSP's memory copy and set functions in xil_mem.c, and host
+ * run of the benchmark in Full_Demo/XilMemBenchmark.c.
+ *
+ * Each of Xil_MemCpy(), Xil_MemCpyNT(), Xil_MemSet() and Xil_MemSetNT() is
+ * compared with the C library's memcpy() or memset() for every pair of source
+ * and destination alignments within 16 bytes, and for every size up to
+ * xmtestMAX_SIZE bytes.  That covers the alignment head, the block loop and
+ * both tails.  Guard bytes either side of the
+ * destination catch writes outside it.  The sizes either side of
+ * XIL_MEM_NT_THRESHOLD, where Xil_MemCpy() and Xil_MemSet() change loops, are
+ * checked for a spread of alignments.
+ *
+ * On an x86 host the block loops are the C ones rather than the LDP/STP and
+ * LDNP/STNP loops, which only an AArch64 host runs.  The benchmark's host
+ * times are in nanoseconds and are printed for comparison only.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+
+/* Demo program include files. */
+#include "XilMemBenchmark.h"
+
+/* Xilinx includes. */
+#include "xil_mem.h"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define xmtestALIGNMENTS			( 16UL )
+#define xmtestMAX_SIZE				( 4096UL + 64UL )
+#define xmtestGUARD_SIZE			( 64UL )
+#define xmtestGUARD_BYTE			( 0xA5U )
+
+/* Must match the default in xil_mem.c. */
+#define xmtestNT_THRESHOLD			( 1024UL * 1024UL )
+
+/* The functions checked. */
+typedef enum
+{
+	eMemCpy = 0,
+	eMemCpyNT,
+	eMemSet,
+	eMemSetNT,
+	eNumFunctions
+} XilMemFunction_t;
+
+static const char * const pcFunctionNames[ eNumFunctions ] = { "Xil_MemCpy", "Xil_MemCpyNT", "Xil_MemSet", "Xil_MemSetNT" };
+
+/*-----------------------------------------------------------*/
+
+/* The source, and the destination and reference with their guard bytes, sized
+for the largest check.  Allocated 16 byte aligned, so the offsets into them set
+the alignments. */
+static uint8_t *pucSource;
+static uint8_t *pucDestination;
+static uint8_t *pucExpected;
+
+/* The number of checks made, which are counted separately from the
+hosttestCHECK()s as only failures are reported. */
+static uint32_t ulChecks = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Check one function for one size and pair of alignments, against memcpy() or
+memset() into the reference. */
+static void prvCheckOne( XilMemFunction_t eFunction, uint32_t ulSize, uint32_t ulSourceOffset, uint32_t ulDestinationOffset )
+{
+const size_t xAreaSize = ( size_t ) ulSize + ulDestinationOffset + ( 2UL * xmtestGUARD_SIZE );
+uint8_t * const pucTarget = &( pucDestination[ xmtestGUARD_SIZE + ulDestinationOffset ] );
+uint8_t * const pucReference = &( pucExpected[ xmtestGUARD_SIZE + ulDestinationOffset ] );
+const uint8_t * const pucFrom = &( pucSource[ ulSourceOffset ] );
+const uint8_t ucValue = ( uint8_t ) ( ulSize + ( ulSourceOffset * 17UL ) + ( uint32_t ) eFunction );
+
+	memset( pucDestination, xmtestGUARD_BYTE, xAreaSize );
+	memset( pucExpected, xmtestGUARD_BYTE, xAreaSize );
+
+	switch( eFunction )
+	{
+		case eMemCpy :
+			memcpy( pucReference, pucFrom, ulSize );
+			Xil_MemCpy( pucTarget, pucFrom, ulSize );
+			break;
+
+		case eMemCpyNT :
+			memcpy( pucReference, pucFrom, ulSize );
+			Xil_MemCpyNT( pucTarget, pucFrom, ulSize );
+			break;
+
+		case eMemSet :
+			memset( pucReference, ucValue, ulSize );
+			Xil_MemSet( pucTarget, ( s32 ) ucValue, ulSize );
+			break;
+
+		default :
+			memset( pucReference, ucValue, ulSize );
+			Xil_MemSetNT( pucTarget, ( s32 ) ucValue, ulSize );
+			break;
+	}
+
+	ulChecks++;
+
+	if( memcmp( pucDestination, pucExpected, xAreaSize ) != 0 )
+	{
+		printf( "%s: size %lu, source offset %lu, destination offset %lu\n", pcFunctionNames[ eFunction ],
+			( unsigned long ) ulSize, ( unsigned long ) ulSourceOffset, ( unsigned long ) ulDestinationOffset );
+		hosttestCHECK( pdFALSE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* Check every function for every pair of alignments, for one size. */
+static void prvCheckSize( uint32_t ulSize )
+{
+uint32_t ulSourceOffset, ulDestinationOffset;
+XilMemFunction_t eFunction;
+
+	for( eFunction = eMemCpy; eFunction < eNumFunctions; eFunction++ )
+	{
+		for( ulSourceOffset = 0; ulSourceOffset < xmtestALIGNMENTS; ulSourceOffset++ )
+		{
+			for( ulDestinationOffset = 0; ulDestinationOffset < xmtestALIGNMENTS; ulDestinationOffset++ )
+			{
+				prvCheckOne( eFunction, ulSize, ulSourceOffset, ulDestinationOffset );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSizes( void )
+{
+uint32_t ulSize;
+
+	for( ulSize = 0; ulSize <= xmtestMAX_SIZE; ulSize++ )
+	{
+		prvCheckSize( ulSize );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestThreshold( void )
+{
+uint32_t ulSize, ulDestinationOffset;
+XilMemFunction_t eFunction;
+
+	/* Every destination alignment, each with a different source alignment,
+	and both aligned. */
+	for( ulSize = xmtestNT_THRESHOLD - 1UL; ulSize <= xmtestNT_THRESHOLD + 1UL; ulSize++ )
+	{
+		for( eFunction = eMemCpy; eFunction < eNumFunctions; eFunction++ )
+		{
+			for( ulDestinationOffset = 0; ulDestinationOffset < xmtestALIGNMENTS; ulDestinationOffset++ )
+			{
+				prvCheckOne( eFunction, ulSize, ( ( ulDestinationOffset * 5UL ) + 3UL ) % xmtestALIGNMENTS, ulDestinationOffset );
+			}
+
+			prvCheckOne( eFunction, ulSize, 0, 0 );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBenchmark( void )
+{
+static const uint32_t ulSizes[] = { 64UL, 1024UL, 16UL * 1024UL, 256UL * 1024UL, 2UL * 1024UL * 1024UL };
+XilMemBenchmarkResult_t xResult;
+size_t x;
+
+	/* The benchmark's own check, then its measurements, as the task makes
+	them. */
+	hosttestCHECK( xXilMemBenchmarkCheck() == pdPASS );
+
+	printf( "%10s %10s %10s %10s %10s %10s %10s %10s (ns)\n", "Size", "memcpy", "legacy", "MemCpy", "MemCpyNT", "memset", "MemSet", "MemSetNT" );
+
+	for( x = 0; x < ( sizeof( ulSizes ) / sizeof( ulSizes[ 0 ] ) ); x++ )
+	{
+		vXilMemBenchmarkMeasure( ulSizes[ x ], &xResult );
+		hosttestCHECK( xResult.ulSize == ulSizes[ x ] );
+
+		printf( "%10lu %10lu %10lu %10lu %10lu %10lu %10lu %10lu\n", ( unsigned long ) xResult.ulSize,
+			( unsigned long ) xResult.ulMemcpyTime, ( unsigned long ) xResult.ulLegacyCopyTime,
+			( unsigned long ) xResult.ulXilMemCpyTime, ( unsigned long ) xResult.ulXilMemCpyNTTime,
+			( unsigned long ) xResult.ulMemsetTime, ( unsigned long ) xResult.ulXilMemSetTime,
+			( unsigned long ) xResult.ulXilMemSetNTTime );
+	}
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+const size_t xBufferSize = xmtestNT_THRESHOLD + xmtestALIGNMENTS + ( 2UL * xmtestGUARD_SIZE ) + xmtestALIGNMENTS;
+size_t x;
+
+	pucSource = aligned_alloc( xmtestALIGNMENTS, xBufferSize );
+	pucDestination = aligned_alloc( xmtestALIGNMENTS, xBufferSize );
+	pucExpected = aligned_alloc( xmtestALIGNMENTS, xBufferSize );
+	configASSERT( ( pucSource != NULL ) && ( pucDestination != NULL ) && ( pucExpected != NULL ) );
+
+	/* No run of the source repeats within a block, so a byte copied from the
+	wrong place is seen. */
+	for( x = 0; x < xBufferSize; x++ )
+	{
+		pucSource[ x ] = ( uint8_t ) ( ( x * 7UL ) + ( x >> 8UL ) );
+	}
+
+	prvTestSizes();
+	prvTestThreshold();
+	printf( "%lu copies and sets checked\n", ( unsigned long ) ulChecks );
+
+	prvTestBenchmark();
+
+	free( pucSource );
+	free( pucDestination );
+	free( pucExpected );
+
+	return iHostTestResult( "XilMemTest" );
+}
+/*-----------------------------------------------------------*/
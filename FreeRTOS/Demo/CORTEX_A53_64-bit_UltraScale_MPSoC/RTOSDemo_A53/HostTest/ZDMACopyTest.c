@@ -0,0 +1,742 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * Host test for the scatter gather copy service in ZDMACopy.c, built against
+ * the model of the GDMA channels in ZDMACopyHostModel.h.
+ *
+ * The test is single threaded.  It calls the service task's event handler,
+ * prvProcessEvents(), itself with the events the stubs collect, and decides
+ * when each model channel reaches the end of its list.  The checks cover
+ * rejected segments, the spreading of requests over the channels, the
+ * chaining of small requests into one list, a request spread over several
+ * lists, a list that ends with an error, a full queue, and a long run of
+ * random requests, each checked against the data the channels copied.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#define zdmacopyUSE_HOST_MODEL			1
+#include "ZDMACopy.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define zdmatestBUFFER_SIZE				( 1024U * 1024U )
+#define zdmatestRANDOM_ROUNDS			2000
+#define zdmatestNUM_TASKS				2
+
+/* The handle xTaskCreate() gives the service task. */
+#define zdmatestSERVICE_TASK			( ( TaskHandle_t ) &xServiceTaskStandIn )
+
+/*-----------------------------------------------------------*/
+
+/* A queue, for the stub queue functions. */
+struct HostTestQueue
+{
+	UBaseType_t uxLength;
+	UBaseType_t uxItemSize;
+	UBaseType_t uxHead;
+	UBaseType_t uxWaiting;
+	uint8_t *pucStorage;
+};
+
+/*-----------------------------------------------------------*/
+
+/* The model channels. */
+HostZDMAModel_t xHostZDMAModel;
+
+static uint8_t xServiceTaskStandIn;
+
+/* The tasks that submit requests, and the notifications each was given. */
+static uint8_t ucTasks[ zdmatestNUM_TASKS ];
+static TaskHandle_t xCurrentTask = ( TaskHandle_t ) &( ucTasks[ 0 ] );
+static uint32_t ulNotificationsGiven[ zdmatestNUM_TASKS ];
+
+/* The events sent to the service task and not yet processed, and the number
+of times it was notified. */
+static uint32_t ulPendingEvents = 0;
+static uint32_t ulServiceNotifications = 0;
+
+/* Cache maintenance calls. */
+static uint32_t ulFlushCalls = 0;
+static uint32_t ulInvalidatedRanges = 0;
+
+static uint8_t ucSource[ zdmatestBUFFER_SIZE ] __attribute__( ( aligned( 64 ) ) );
+static uint8_t ucDestination[ zdmatestBUFFER_SIZE ] __attribute__( ( aligned( 64 ) ) );
+
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheFlushRanges( const Xil_CacheRange *ranges, u32 num )
+{
+	( void ) ranges;
+	hosttestCHECK( ( num > 0 ) && ( num <= zdmacopyFLUSH_RANGES ) );
+	ulFlushCalls++;
+}
+/*-----------------------------------------------------------*/
+
+void Xil_DCacheInvalidateRanges( const Xil_CacheRange *ranges, u32 num )
+{
+u32 ulRange;
+
+	/* Invalidating a range that is not whole cache lines would discard data
+	next to it. */
+	hosttestCHECK( ( num > 0 ) && ( num <= zdmacopyLIST_LENGTH ) );
+
+	for( ulRange = 0; ulRange < num; ulRange++ )
+	{
+		hosttestCHECK( ( ranges[ ulRange ].Addr % zdmacopyALIGNMENT ) == 0 );
+		hosttestCHECK( ( ranges[ ulRange ].Len % zdmacopyALIGNMENT ) == 0 );
+	}
+
+	ulInvalidatedRanges += num;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+QueueHandle_t xQueue = calloc( 1, sizeof( *xQueue ) );
+
+	xQueue->uxLength = uxQueueLength;
+	xQueue->uxItemSize = uxItemSize;
+	xQueue->pucStorage = malloc( uxQueueLength * uxItemSize );
+
+	return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+UBaseType_t uxIndex;
+
+	/* Only one task runs, so a full queue would never empty while it
+	waited. */
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting < xQueue->uxLength )
+	{
+		uxIndex = ( xQueue->uxHead + xQueue->uxWaiting ) % xQueue->uxLength;
+		memcpy( &( xQueue->pucStorage[ uxIndex * xQueue->uxItemSize ] ), pvItemToQueue, xQueue->uxItemSize );
+		xQueue->uxWaiting++;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xTicksToWait;
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xQueue->uxWaiting > 0 )
+	{
+		memcpy( pvBuffer, &( xQueue->pucStorage[ xQueue->uxHead * xQueue->uxItemSize ] ), xQueue->uxItemSize );
+		xQueue->uxHead = ( xQueue->uxHead + 1 ) % xQueue->uxLength;
+		xQueue->uxWaiting--;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+	return xQueue->uxWaiting;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+	( void ) pxTaskCode;
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+	( void ) uxPriority;
+
+	*pxCreatedTask = zdmatestSERVICE_TASK;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction )
+{
+	hosttestCHECK( xTaskToNotify == zdmatestSERVICE_TASK );
+	hosttestCHECK( eAction == eSetBits );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	ulPendingEvents |= ulValue;
+	ulServiceNotifications++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	*pxHigherPriorityTaskWoken = pdTRUE;
+
+	return xTaskNotify( xTaskToNotify, ulValue, eAction );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+{
+	/* Only called by the service task, which the test does not run. */
+	( void ) ulBitsToClearOnEntry;
+	( void ) ulBitsToClearOnExit;
+	( void ) pulNotificationValue;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+	hosttestCHECK( uxIndexToNotify == zdmacopyNOTIFICATION_INDEX );
+	hosttestCHECK( ( ( uint8_t * ) xTaskToNotify >= ucTasks ) && ( ( uint8_t * ) xTaskToNotify < &( ucTasks[ zdmatestNUM_TASKS ] ) ) );
+
+	ulNotificationsGiven[ ( uint8_t * ) xTaskToNotify - ucTasks ]++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+	/* The test only waits with a block time of zero. */
+	( void ) uxIndexToWaitOn;
+	( void ) xClearCountOnExit;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+	return taskSCHEDULER_RUNNING;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return xCurrentTask;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	pxTimeOut->xOverflowCount = 0;
+	pxTimeOut->xTimeOnEntering = 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+	( void ) pxTimeOut;
+
+	return ( *pxTicksToWait == 0 ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/* Run the service task until it has no events left. */
+static void prvRunService( void )
+{
+uint32_t ulEvents;
+
+	while( ulPendingEvents != 0 )
+	{
+		ulEvents = ulPendingEvents;
+		ulPendingEvents = 0;
+		prvProcessEvents( ulEvents );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCompleteAllChannels( void )
+{
+UBaseType_t uxChannel;
+BaseType_t xCompleted = pdFALSE;
+
+	for( uxChannel = 0; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		if( bHostZDMAModelComplete( uxChannel, false ) != false )
+		{
+			xCompleted = pdTRUE;
+		}
+	}
+
+	return xCompleted;
+}
+/*-----------------------------------------------------------*/
+
+/* Let the channels and the service task run until every request is done. */
+static void prvDrain( void )
+{
+	do
+	{
+		prvRunService();
+	} while( prvCompleteAllChannels() != pdFALSE );
+
+	prvRunService();
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillSource( uint32_t ulSeed )
+{
+uint32_t ulIndex;
+
+	for( ulIndex = 0; ulIndex < zdmatestBUFFER_SIZE; ulIndex++ )
+	{
+		ucSource[ ulIndex ] = ( uint8_t ) ( ( ulIndex * 7U ) + ulSeed + ( ulIndex >> 9 ) );
+	}
+
+	memset( ucDestination, 0x00, sizeof( ucDestination ) );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCopied( const ZDMACopySegment_t *pxSegments, UBaseType_t uxSegments )
+{
+UBaseType_t ux;
+BaseType_t xReturn = pdTRUE;
+
+	for( ux = 0; ux < uxSegments; ux++ )
+	{
+		if( memcmp( pxSegments[ ux ].pvDestination, pxSegments[ ux ].pvSource, pxSegments[ ux ].xLength ) != 0 )
+		{
+			xReturn = pdFALSE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Make every channel other than channel 0 look busy, or idle again, so
+requests are queued on channel 0. */
+static void prvSetOtherChannelsBusy( BaseType_t xBusy )
+{
+UBaseType_t uxChannel;
+
+	for( uxChannel = 1; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		xChannels[ uxChannel ].xBusy = xBusy;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRejectedSegments( void )
+{
+ZDMACopySegment_t xSegments[ 2 ] =
+{
+	{ ucDestination, ucSource, zdmacopyALIGNMENT },
+	{ ucDestination + 8, ucSource, zdmacopyALIGNMENT }
+};
+ZDMACopyRequest_t xRequest = { xSegments, 2 };
+
+	/* A destination or length that is not whole cache lines, an empty
+	segment, and a NULL source are rejected before anything is queued. */
+	hosttestCHECK( xZDMACopySubmit( &xRequest, 0 ) == pdFAIL );
+	hosttestCHECK( xRequest.xStatus == zdmacopySTATUS_FAILED );
+
+	xSegments[ 1 ].pvDestination = ucDestination + zdmacopyALIGNMENT;
+	xSegments[ 1 ].xLength = 100;
+	hosttestCHECK( xZDMACopySubmit( &xRequest, 0 ) == pdFAIL );
+
+	xSegments[ 1 ].xLength = 0;
+	hosttestCHECK( xZDMACopySubmit( &xRequest, 0 ) == pdFAIL );
+
+	xSegments[ 1 ].xLength = 2 * zdmacopyALIGNMENT;
+	xSegments[ 1 ].pvSource = NULL;
+	hosttestCHECK( xZDMACopySubmit( &xRequest, 0 ) == pdFAIL );
+
+	/* A request with no segments is complete at once. */
+	xRequest.uxNumberOfSegments = 0;
+	hosttestCHECK( xZDMACopySubmit( &xRequest, 0 ) == pdPASS );
+	hosttestCHECK( xRequest.xStatus == zdmacopySTATUS_COMPLETE );
+
+	hosttestCHECK( ulPendingEvents == 0 );
+	hosttestCHECK( ulFlushCalls == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSpreadOverChannels( void )
+{
+static ZDMACopySegment_t xSegments[ zdmacopyCHANNELS ][ 3 ];
+static ZDMACopyRequest_t xRequests[ zdmacopyCHANNELS ];
+ZDMACopySegment_t xExtraSegment = { ucDestination + ( 100 * 4096 ), ucSource + ( 100 * 4096 ), 4096 };
+ZDMACopyRequest_t xExtraRequest = { &xExtraSegment, 1 };
+ZDMACopyStats_t xStats;
+uint32_t ulNotificationsBefore;
+UBaseType_t uxChannel, ux;
+
+	prvFillSource( 1 );
+
+	/* One request per channel goes to a different channel each time.  The
+	sources need not be aligned. */
+	for( uxChannel = 0; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		for( ux = 0; ux < 3; ux++ )
+		{
+			xSegments[ uxChannel ][ ux ].pvDestination = ucDestination + ( ( ( uxChannel * 3 ) + ux ) * 4096 );
+			xSegments[ uxChannel ][ ux ].pvSource = ucSource + 3 + ( ( ( ( 5 - uxChannel ) * 3 ) + ux ) * 4096 );
+			xSegments[ uxChannel ][ ux ].xLength = 4096;
+		}
+
+		xRequests[ uxChannel ].pxSegments = xSegments[ uxChannel ];
+		xRequests[ uxChannel ].uxNumberOfSegments = 3;
+		hosttestCHECK( xZDMACopySubmit( &( xRequests[ uxChannel ] ), 0 ) == pdPASS );
+		hosttestCHECK( uxQueueMessagesWaiting( xChannels[ uxChannel ].xQueue ) == 1 );
+	}
+
+	hosttestCHECK( ulPendingEvents == zdmacopyALL_EVENTS );
+	prvRunService();
+
+	for( uxChannel = 0; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		hosttestCHECK( bHostZDMAModelRunning( uxChannel ) != false );
+		hosttestCHECK( xRequests[ uxChannel ].xStatus == zdmacopySTATUS_PENDING );
+	}
+
+	/* With every channel busy a request is queued without waking the service
+	task, on the lowest numbered of the equally loaded channels. */
+	ulNotificationsBefore = ulServiceNotifications;
+	hosttestCHECK( xZDMACopySubmit( &xExtraRequest, 0 ) == pdPASS );
+	hosttestCHECK( ulServiceNotifications == ulNotificationsBefore );
+	hosttestCHECK( xZDMACopyWait( &xExtraRequest, 0 ) == zdmacopySTATUS_PENDING );
+	hosttestCHECK( uxQueueMessagesWaiting( xChannels[ 0 ].xQueue ) == 1 );
+
+	/* Channels complete independently. */
+	hosttestCHECK( bHostZDMAModelComplete( 3, false ) != false );
+	prvRunService();
+	hosttestCHECK( xRequests[ 3 ].xStatus == zdmacopySTATUS_COMPLETE );
+	hosttestCHECK( xRequests[ 0 ].xStatus == zdmacopySTATUS_PENDING );
+
+	prvDrain();
+
+	for( uxChannel = 0; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		hosttestCHECK( xRequests[ uxChannel ].xStatus == zdmacopySTATUS_COMPLETE );
+		hosttestCHECK( prvCopied( xSegments[ uxChannel ], 3 ) != pdFALSE );
+	}
+
+	hosttestCHECK( xZDMACopyWait( &xExtraRequest, 0 ) == zdmacopySTATUS_COMPLETE );
+	hosttestCHECK( prvCopied( &xExtraSegment, 1 ) != pdFALSE );
+	hosttestCHECK( ulNotificationsGiven[ 0 ] == zdmacopyCHANNELS + 1 );
+
+	vZDMACopyGetStats( &xStats );
+	hosttestCHECK( xStats.ulRequests == zdmacopyCHANNELS + 1 );
+	hosttestCHECK( xStats.ulLists == zdmacopyCHANNELS + 1 );
+	hosttestCHECK( xStats.ulSegments == ( zdmacopyCHANNELS * 3 ) + 1 );
+	hosttestCHECK( xStats.ullBytes == ( uint64_t ) ( ( zdmacopyCHANNELS * 3 ) + 1 ) * 4096U );
+	hosttestCHECK( xStats.ulChainedRequests == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestChaining( void )
+{
+static ZDMACopySegment_t xSegments[ 40 ][ 2 ];
+static ZDMACopyRequest_t xRequests[ 40 ];
+ZDMACopyStats_t xBefore, xAfter;
+uint32_t ulInvalidatedBefore = ulInvalidatedRanges;
+UBaseType_t uxChannel, uxRequest, ux;
+
+	prvFillSource( 2 );
+	vZDMACopyGetStats( &xBefore );
+
+	/* Requests submitted before the service task runs are chained into one
+	list per channel, and their contiguous destinations into one range. */
+	for( uxRequest = 0; uxRequest < 40; uxRequest++ )
+	{
+		for( ux = 0; ux < 2; ux++ )
+		{
+			xSegments[ uxRequest ][ ux ].pvDestination = ucDestination + ( ( ( uxRequest * 2 ) + ux ) * 1024 );
+			xSegments[ uxRequest ][ ux ].pvSource = ucSource + ( ( ( uxRequest * 2 ) + ux ) * 1024 ) + 1;
+			xSegments[ uxRequest ][ ux ].xLength = 1024;
+		}
+
+		xRequests[ uxRequest ].pxSegments = xSegments[ uxRequest ];
+		xRequests[ uxRequest ].uxNumberOfSegments = 2;
+		hosttestCHECK( xZDMACopySubmit( &( xRequests[ uxRequest ] ), 0 ) == pdPASS );
+	}
+
+	for( uxChannel = 0; uxChannel < zdmacopyCHANNELS; uxChannel++ )
+	{
+		hosttestCHECK( bHostZDMAModelRunning( uxChannel ) == false );
+	}
+
+	prvDrain();
+
+	for( uxRequest = 0; uxRequest < 40; uxRequest++ )
+	{
+		hosttestCHECK( xRequests[ uxRequest ].xStatus == zdmacopySTATUS_COMPLETE );
+		hosttestCHECK( prvCopied( xSegments[ uxRequest ], 2 ) != pdFALSE );
+	}
+
+	vZDMACopyGetStats( &xAfter );
+	hosttestCHECK( xAfter.ulLists - xBefore.ulLists == zdmacopyCHANNELS );
+	hosttestCHECK( xAfter.ulChainedRequests - xBefore.ulChainedRequests == 40 - zdmacopyCHANNELS );
+
+	/* Requests were spread round robin over the channels, so no two requests
+	in a list have contiguous destinations, but each request's two segments
+	do. */
+	hosttestCHECK( ulInvalidatedRanges - ulInvalidatedBefore == 40 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRequestOverSeveralLists( void )
+{
+static ZDMACopySegment_t xSegments[ 100 ];
+ZDMACopySegment_t xSmallSegment = { ucDestination + ( 200 * 2048 ), ucSource + ( 200 * 2048 ), 2048 };
+ZDMACopyRequest_t xBigRequest = { xSegments, 100 };
+ZDMACopyRequest_t xSmallRequest = { &xSmallSegment, 1 };
+ZDMACopyStats_t xBefore, xAfter;
+UBaseType_t ux, uxLists = 0;
+
+	prvFillSource( 3 );
+	vZDMACopyGetStats( &xBefore );
+
+	for( ux = 0; ux < 100; ux++ )
+	{
+		xSegments[ ux ].pvDestination = ucDestination + ( ( 99 - ux ) * 2048 );
+		xSegments[ ux ].pvSource = ucSource + ( ux * 2048 );
+		xSegments[ ux ].xLength = 2048;
+	}
+
+	/* A request with more segments than fit in a list, then a request from
+	another task queued behind it on the same channel. */
+	prvSetOtherChannelsBusy( pdTRUE );
+	hosttestCHECK( xZDMACopySubmit( &xBigRequest, 0 ) == pdPASS );
+	prvRunService();
+	xCurrentTask = ( TaskHandle_t ) &( ucTasks[ 1 ] );
+	hosttestCHECK( xZDMACopySubmit( &xSmallRequest, 0 ) == pdPASS );
+	xCurrentTask = ( TaskHandle_t ) &( ucTasks[ 0 ] );
+	hosttestCHECK( uxQueueMessagesWaiting( xChannels[ 0 ].xQueue ) == 1 );
+	prvSetOtherChannelsBusy( pdFALSE );
+
+	/* The big request only completes with its last list, and the small
+	request shares that list. */
+	while( bHostZDMAModelComplete( 0, false ) != false )
+	{
+		uxLists++;
+		prvRunService();
+
+		if( xBigRequest.xStatus == zdmacopySTATUS_PENDING )
+		{
+			hosttestCHECK( xSmallRequest.xStatus == zdmacopySTATUS_PENDING );
+		}
+	}
+
+	hosttestCHECK( uxLists == ( 100 + zdmacopyLIST_LENGTH ) / zdmacopyLIST_LENGTH );
+	hosttestCHECK( xBigRequest.xStatus == zdmacopySTATUS_COMPLETE );
+	hosttestCHECK( xSmallRequest.xStatus == zdmacopySTATUS_COMPLETE );
+	hosttestCHECK( prvCopied( xSegments, 100 ) != pdFALSE );
+	hosttestCHECK( prvCopied( &xSmallSegment, 1 ) != pdFALSE );
+	hosttestCHECK( ulNotificationsGiven[ 1 ] == 1 );
+
+	vZDMACopyGetStats( &xAfter );
+	hosttestCHECK( xAfter.ulLists - xBefore.ulLists == uxLists );
+	hosttestCHECK( xAfter.ulRequests - xBefore.ulRequests == 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestListError( void )
+{
+static ZDMACopySegment_t xSegments[ 40 ];
+ZDMACopySegment_t xLaterSegment = { ucDestination + ( 500 * 1024 ), ucSource + ( 500 * 1024 ), 1024 };
+ZDMACopyRequest_t xFirst = { xSegments, 10 };
+ZDMACopyRequest_t xSecond = { &( xSegments[ 10 ] ), 30 };
+ZDMACopyRequest_t xLater = { &xLaterSegment, 1 };
+ZDMACopyStats_t xBefore, xAfter;
+UBaseType_t ux;
+
+	prvFillSource( 4 );
+
+	for( ux = 0; ux < 40; ux++ )
+	{
+		xSegments[ ux ].pvDestination = ucDestination + ( ux * 1024 );
+		xSegments[ ux ].pvSource = ucSource + ( ux * 1024 );
+		xSegments[ ux ].xLength = 1024;
+	}
+
+	/* Two requests in one list, the second only partly, then a request
+	queued behind them. */
+	prvSetOtherChannelsBusy( pdTRUE );
+	hosttestCHECK( xZDMACopySubmit( &xFirst, 0 ) == pdPASS );
+	hosttestCHECK( xZDMACopySubmit( &xSecond, 0 ) == pdPASS );
+	prvRunService();
+	hosttestCHECK( xHostZDMAModel.uxListLength[ 0 ] == zdmacopyLIST_LENGTH );
+	hosttestCHECK( xZDMACopySubmit( &xLater, 0 ) == pdPASS );
+	prvSetOtherChannelsBusy( pdFALSE );
+
+	/* An error fails both requests, and the rest of the second is not
+	copied.  The channel then carries on with the next request. */
+	vZDMACopyGetStats( &xBefore );
+	hosttestCHECK( bHostZDMAModelComplete( 0, true ) != false );
+	prvRunService();
+	hosttestCHECK( xFirst.xStatus == zdmacopySTATUS_FAILED );
+	hosttestCHECK( xSecond.xStatus == zdmacopySTATUS_FAILED );
+	hosttestCHECK( xLater.xStatus == zdmacopySTATUS_PENDING );
+	hosttestCHECK( bHostZDMAModelRunning( 0 ) != false );
+	hosttestCHECK( xHostZDMAModel.uxListLength[ 0 ] == 1 );
+
+	hosttestCHECK( bHostZDMAModelComplete( 0, false ) != false );
+	prvRunService();
+	hosttestCHECK( xLater.xStatus == zdmacopySTATUS_COMPLETE );
+	hosttestCHECK( prvCopied( &xLaterSegment, 1 ) != pdFALSE );
+
+	vZDMACopyGetStats( &xAfter );
+	hosttestCHECK( xAfter.ulFailedRequests - xBefore.ulFailedRequests == 2 );
+	hosttestCHECK( xAfter.ulSegments - xBefore.ulSegments == 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestQueueFull( void )
+{
+static ZDMACopySegment_t xSegment = { ucDestination, ucSource, zdmacopyALIGNMENT };
+static ZDMACopyRequest_t xRequests[ ( zdmacopyCHANNELS * zdmacopyQUEUE_LENGTH ) + 1 ];
+UBaseType_t ux, uxQueued = 0;
+
+	/* Until the service task runs, every queue fills, then requests fail. */
+	for( ux = 0; ux < ( sizeof( xRequests ) / sizeof( xRequests[ 0 ] ) ); ux++ )
+	{
+		xRequests[ ux ].pxSegments = &xSegment;
+		xRequests[ ux ].uxNumberOfSegments = 1;
+
+		if( xZDMACopySubmit( &( xRequests[ ux ] ), 0 ) == pdPASS )
+		{
+			uxQueued++;
+		}
+		else
+		{
+			hosttestCHECK( xRequests[ ux ].xStatus == zdmacopySTATUS_FAILED );
+		}
+	}
+
+	hosttestCHECK( uxQueued == zdmacopyCHANNELS * zdmacopyQUEUE_LENGTH );
+	prvDrain();
+
+	for( ux = 0; ux < uxQueued; ux++ )
+	{
+		hosttestCHECK( xRequests[ ux ].xStatus == zdmacopySTATUS_COMPLETE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomRequests( void )
+{
+static ZDMACopySegment_t xSegments[ 64 ][ 8 ];
+static ZDMACopyRequest_t xRequests[ 64 ];
+UBaseType_t uxRequests, uxRequest, uxSegments, ux, uxNext;
+int iRound;
+
+	srand( 5 );
+
+	for( iRound = 0; iRound < zdmatestRANDOM_ROUNDS; iRound++ )
+	{
+		prvFillSource( ( uint32_t ) iRound );
+		uxRequests = 1 + ( UBaseType_t ) ( rand() % 64 );
+		uxNext = 0;
+
+		/* Requests of random segments to separate destinations, submitted
+		while the channels and the service task run at random. */
+		for( uxRequest = 0; uxRequest < uxRequests; uxRequest++ )
+		{
+			uxSegments = 1 + ( UBaseType_t ) ( rand() % 8 );
+
+			for( ux = 0; ux < uxSegments; ux++ )
+			{
+				xSegments[ uxRequest ][ ux ].pvDestination = ucDestination + ( uxNext * 1024 );
+				xSegments[ uxRequest ][ ux ].pvSource = ucSource + ( ( rand() % 900 ) * 1024 ) + ( rand() % 64 );
+				xSegments[ uxRequest ][ ux ].xLength = zdmacopyALIGNMENT * ( 1 + ( rand() % 16 ) );
+				uxNext++;
+			}
+
+			xRequests[ uxRequest ].pxSegments = xSegments[ uxRequest ];
+			xRequests[ uxRequest ].uxNumberOfSegments = uxSegments;
+
+			while( xZDMACopySubmit( &( xRequests[ uxRequest ] ), 0 ) != pdPASS )
+			{
+				prvRunService();
+				( void ) prvCompleteAllChannels();
+			}
+
+			if( ( rand() % 3 ) == 0 )
+			{
+				prvRunService();
+			}
+
+			if( ( rand() % 4 ) == 0 )
+			{
+				( void ) bHostZDMAModelComplete( ( UBaseType_t ) ( rand() % zdmacopyCHANNELS ), false );
+			}
+		}
+
+		prvDrain();
+
+		for( uxRequest = 0; uxRequest < uxRequests; uxRequest++ )
+		{
+			hosttestCHECK( xRequests[ uxRequest ].xStatus == zdmacopySTATUS_COMPLETE );
+			hosttestCHECK( prvCopied( xSegments[ uxRequest ], xRequests[ uxRequest ].uxNumberOfSegments ) != pdFALSE );
+		}
+	}
+
+	/* Some lists must have been given more than one request. */
+	hosttestCHECK( xHostZDMAModel.ulLongestList == zdmacopyLIST_LENGTH );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	hosttestCHECK( xZDMACopyInit( 3 ) == pdPASS );
+
+	prvTestRejectedSegments();
+	prvTestSpreadOverChannels();
+	prvTestChaining();
+	prvTestRequestOverSeveralLists();
+	prvTestListError();
+	prvTestQueueFull();
+	prvTestRandomRequests();
+
+	return iHostTestResult( "ZDMACopyTest" );
+}
+/*-----------------------------------------------------------*/
@@ -60,6 +60,11 @@
  * queue send task writes to the queue every 200 milliseconds, the queue receive
  * task leaves the Blocked state every 200 milliseconds, and therefore outputs
  * a message every 200 milliseconds.
+ *
+ * Once a second the queue receive task also reports how often the core woke
+ * up - from tick interrupts, and, when configUSE_TICKLESS_IDLE is 2, from
+ * sleeps with the tick stopped.  When irqdispatchCOLLECT_STATS is 1 it also
+ * reports the time spent in the tick handler.  See FreeRTOS_tick_config.c.
  */
 
 /* Kernel includes. */
@@ -67,8 +72,13 @@
 #include "task.h"
 #include "semphr.h"
 
+/* Demo includes. */
+#include "FreeRTOS_tick_config.h"
+#include "IRQDispatch.h"
+
 /* Xilinx includes. */
 #include "xil_printf.h"
+#include "xparameters.h"
 
 /* Priorities at which the tasks are created. */
 #define mainQUEUE_RECEIVE_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
@@ -83,6 +93,9 @@ will remove items as they are added, meaning the send task should always find
 the queue empty. */
 #define mainQUEUE_LENGTH					( 1 )
 
+/* How often the tick statistics are reported. */
+#define mainTICK_REPORT_PERIOD				pdMS_TO_TICKS( 1000 )
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -91,6 +104,12 @@ the queue empty. */
 static void prvQueueReceiveTask( void *pvParameters );
 static void prvQueueSendTask( void *pvParameters );
 
+/*
+ * Report the core's wakeups per second, and the tick handler's execution
+ * time, since the last report.
+ */
+static void prvReportTickStats( void );
+
 /*-----------------------------------------------------------*/
 
 /* The queue used by both tasks. */
@@ -179,6 +198,56 @@ const uint32_t ulExpectedValue = 100UL;
 			xil_printf( "100 received\r\n" );
 			ulReceivedValue = 0U;
 		}
+
+		prvReportTickStats();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportTickStats( void )
+{
+static TickType_t xLastReportTime = 0;
+static TickStats_t xLastStats = { 0 };
+TickStats_t xStats;
+TickType_t xNow, xElapsed;
+uint32_t ulWakeups;
+
+	xNow = xTaskGetTickCount();
+	xElapsed = xNow - xLastReportTime;
+
+	if( xElapsed >= mainTICK_REPORT_PERIOD )
+	{
+		vGetTickStats( &xStats );
+
+		/* The core wakes for each tick interrupt, and for each sleep that
+		is ended by some other interrupt. */
+		ulWakeups = ( xStats.ulTickInterrupts - xLastStats.ulTickInterrupts ) + ( xStats.ulEarlyWakes - xLastStats.ulEarlyWakes );
+		xil_printf( "Tick: %u wakeups/s, %u interrupts, %u sleeps, %u ticks suppressed\r\n",
+					( uint32_t ) ( ( ( uint64_t ) ulWakeups * configTICK_RATE_HZ ) / xElapsed ),
+					xStats.ulTickInterrupts - xLastStats.ulTickInterrupts,
+					xStats.ulSleeps - xLastStats.ulSleeps,
+					xStats.ulTicksSuppressed - xLastStats.ulTicksSuppressed );
+
+		#if( irqdispatchCOLLECT_STATS == 1 )
+		{
+		IRQStats_t xIRQStats;
+		uint64_t ullFrequency;
+
+			/* The dispatcher times handlers in generic timer counts.  Convert
+			to CPU cycles, to within the counter's resolution. */
+			__asm volatile( "MRS %0, CNTFRQ_EL0" : "=r" ( ullFrequency ) );
+
+			if( ( xIRQDispatchGetStats( ulGetTickInterruptID(), &xIRQStats ) == pdPASS ) && ( xIRQStats.ulCount > 0 ) )
+			{
+				xil_printf( "Tick handler: mean %u max %u CPU cycles, since start\r\n",
+							( uint32_t ) ( ( ( xIRQStats.ullTotalTime / xIRQStats.ulCount ) * XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ ) / ullFrequency ),
+							( uint32_t ) ( ( ( uint64_t ) xIRQStats.ulMaxTime * XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ ) / ullFrequency ) );
+			}
+		}
+		#endif
+
+		xLastStats = xStats;
+		xLastReportTime = xNow;
 	}
 }
 /*-----------------------------------------------------------*/
@@ -0,0 +1,730 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Verifies, and optionally copies, firmware images using the CSU DMA.  The
+ * CSU DMA has a source channel that reads memory into the secure stream
+ * switch (SSS), and a destination channel that writes the stream back to
+ * memory.  The service routes the source channel's stream straight back to
+ * the destination channel, and adds up the words the source channel reads
+ * in its checksum register - which, despite the register's name, holds a
+ * 32-bit sum, not a CRC.  An image that is only verified is written to a
+ * scratch buffer, as the source channel cannot run without the destination
+ * channel taking its data.
+ *
+ * xCSUImageSubmit() cleans the image, and the destination, from the data cache
+ * in the calling task, and queues the job.  The service task runs one job at a
+ * time, as a series of transfers of up to csuimageCHUNK_SIZE bytes, so the
+ * job's progress can be reported as it goes.  The end of each transfer
+ * interrupts the CPU and wakes the service task, which reads the checksum so
+ * far and starts the next transfer straight away, then invalidates the part
+ * of the destination just written and calls the job's progress callback while
+ * the CSU DMA gets on with the next part.  When the last transfer ends the
+ * checksum is compared with the one expected, and the task that submitted the
+ * job is notified.  The CPU only runs the service task briefly at the end of
+ * each transfer, so other tasks carry on while an image is read.
+ *
+ * As the destination is invalidated from the cache, the CPU must not write to
+ * the rest of the cache line that holds the end of the destination while the
+ * job is pending.  The image can have any 4 byte alignment.
+ *
+ * If the CSU DMA reports an error the job fails, and the CSU DMA is reset
+ * before the next job.
+ *
+ * The service owns the CSU DMA and the DMA route through the SSS, so must not
+ * be used at the same time as other users of either, such as the xilsecure
+ * library.
+ *
+ * Building with csuimageUSE_HOST_MODEL set to 1 replaces the CSU DMA with the
+ * model in CSUImageHostModel.h, which copies and adds up the data in
+ * software, so the service can be tested on a host.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "CSUImage.h"
+
+/* Xilinx includes. */
+#include "xil_cache.h"
+
+#ifndef csuimageUSE_HOST_MODEL
+	#define csuimageUSE_HOST_MODEL			0
+#endif
+
+#if( csuimageUSE_HOST_MODEL == 1 )
+
+	#include "CSUImageHostModel.h"
+
+#else
+
+	/* Demo includes. */
+	#include "IRQDispatch.h"
+
+	/* Xilinx includes. */
+	#include "xcsudma.h"
+	#include "xscugic.h"
+	#include "xil_io.h"
+
+	/* The SSS configuration register, and the value of its DMA field that
+	routes the source channel's stream to the destination channel.  The
+	driver declares XCsuDma_LoopBackTransfer(), but this version does not
+	implement it. */
+	#define csuimageSSS_CFG_ADDRESS			( XCSU_BASEADDRESS + 0x008U )
+	#define csuimageSSS_DMA_MASK			( 0x000000F0U )
+	#define csuimageSSS_DMA_LOOPBACK		( 0x00000050U )
+
+	/* The errors that stop a transfer, so no done interrupt follows. */
+	#define csuimageERRORS					( XCSUDMA_IXR_AXI_WRERR_MASK )
+
+	/* The destination channel ends each transfer, once it has written the
+	last of the data the source channel read. */
+	#define csuimageDST_INTERRUPTS			( XCSUDMA_IXR_DONE_MASK | csuimageERRORS )
+	#define csuimageSRC_INTERRUPTS			( csuimageERRORS )
+
+#endif /* csuimageUSE_HOST_MODEL */
+
+/* The most bytes read by one transfer, which is how often progress is
+reported.  Also the size of the scratch buffer images that are only verified
+are written to. */
+#ifndef csuimageCHUNK_SIZE
+	#define csuimageCHUNK_SIZE				( 0x10000UL )
+#endif
+
+/* The number of jobs that can wait for the CSU DMA. */
+#ifndef csuimageQUEUE_LENGTH
+	#define csuimageQUEUE_LENGTH			4
+#endif
+
+/* The task notification index used to tell a task that a job it submitted
+has finished.  As in ZDMACopy.c the default uses the last index, so a task
+that submits jobs must not use that index for anything else. */
+#ifndef csuimageNOTIFICATION_INDEX
+	#define csuimageNOTIFICATION_INDEX		( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#ifndef csuimageTASK_STACK_SIZE
+	#define csuimageTASK_STACK_SIZE			( configMINIMAL_STACK_SIZE * 2 )
+#endif
+
+/* The events sent to the service task, as bits in its notification value. */
+#define csuimageEVENT_JOB_QUEUED			( 1UL << 0UL )
+#define csuimageEVENT_TRANSFER_ENDED		( 1UL << 1UL )
+#define csuimageALL_EVENTS					( csuimageEVENT_JOB_QUEUED | csuimageEVENT_TRANSFER_ENDED )
+
+#if( ( csuimageCHUNK_SIZE == 0 ) || ( ( csuimageCHUNK_SIZE % csuimageALIGNMENT ) != 0 ) )
+	#error csuimageCHUNK_SIZE must be a non zero multiple of csuimageALIGNMENT.
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Take the next job from the queue, if there is one, and start its first
+ * transfer.  Called from the service task.
+ */
+static void prvStartJob( void );
+
+/*
+ * Start the transfer of the part of the current job that starts xOffset bytes
+ * into the image.  Called from the service task.
+ */
+static void prvStartChunk( size_t xOffset );
+
+/*
+ * Account for the transfer that has just ended, start the next, and finish the
+ * current job if it has no more to transfer.  Called from the service task.
+ */
+static void prvFinishChunk( void );
+
+/*
+ * Set the current job's state, notify the task that submitted it, and make the
+ * service ready for the next job.
+ */
+static void prvFinishJob( BaseType_t xStatus );
+
+/*
+ * Act on the events in ulEvents.
+ */
+static void prvProcessEvents( uint32_t ulEvents );
+
+/*
+ * The task that runs the CSU DMA.
+ */
+static void prvCSUImageTask( void *pvParameters );
+
+/*
+ * Called from the interrupt when a transfer ends, or stops because of an
+ * error.
+ */
+static void prvTransferEndedFromISR( BaseType_t xSucceeded );
+
+/*
+ * Initialise the CSU DMA and install its interrupt handler.
+ */
+static BaseType_t prvInitDMA( void );
+
+/*
+ * Start the CSU DMA copying xLength bytes from pvSource to pvDestination,
+ * adding each word to the checksum.
+ */
+static void prvStartTransfer( const void *pvSource, void *pvDestination, size_t xLength );
+
+/*
+ * Read and clear the CSU DMA's checksum.
+ */
+static uint32_t prvReadChecksum( void );
+static void prvClearChecksum( void );
+
+/*
+ * Return the CSU DMA to a state in which it can be started again after an
+ * error.
+ */
+static void prvResetDMA( void );
+
+#if( csuimageUSE_HOST_MODEL == 0 )
+
+	/*
+	 * The CSU DMA interrupt handler.
+	 */
+	static void prvCSUDMAHandler( void *pvUnused );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+static QueueHandle_t xJobQueue = NULL;
+
+static TaskHandle_t xServiceTask = NULL;
+
+/* The job being run, and the part of it being transferred.  Only the service
+task accesses them. */
+static CSUImageJob_t *pxCurrentJob = NULL;
+static size_t xChunkOffset = 0, xChunkLength = 0;
+
+/* How the current transfer ended, or csuimageSTATUS_PENDING.  Written by the
+interrupt. */
+static volatile BaseType_t xTransferStatus = csuimageSTATUS_COMPLETE;
+
+static CSUImageStats_t xStats;
+
+/* The destination of images that are only verified. */
+static uint8_t ucScratch[ csuimageCHUNK_SIZE ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+
+#if( csuimageUSE_HOST_MODEL == 0 )
+
+	static XCsuDma xCSUDMAInstance;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xCSUImageInit( UBaseType_t uxPriority )
+{
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xServiceTask == NULL );
+
+	xJobQueue = xQueueCreate( csuimageQUEUE_LENGTH, sizeof( CSUImageJob_t * ) );
+
+	if( ( xJobQueue != NULL ) && ( prvInitDMA() == pdPASS ) )
+	{
+		xReturn = xTaskCreate( prvCSUImageTask, "CSUImg", csuimageTASK_STACK_SIZE, NULL, uxPriority, &xServiceTask );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCSUImageSubmit( CSUImageJob_t *pxJob, TickType_t xTicksToWait )
+{
+Xil_CacheRange xRanges[ 2 ];
+u32 ulRanges = 1U;
+BaseType_t xReturn = pdPASS;
+
+	configASSERT( xServiceTask );
+	configASSERT( pxJob );
+
+	/* The completion is sent to the submitting task. */
+	configASSERT( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING );
+
+	pxJob->xRequestingTask = xTaskGetCurrentTaskHandle();
+	pxJob->xBytesDone = 0;
+	pxJob->ulChecksum = 0;
+
+	if( ( pxJob->pvImage == NULL ) || ( pxJob->xLength == 0 ) ||
+		( ( pxJob->xLength % sizeof( uint32_t ) ) != 0 ) ||
+		( ( ( UINTPTR ) pxJob->pvImage % sizeof( uint32_t ) ) != 0 ) ||
+		( ( ( UINTPTR ) pxJob->pvDestination % csuimageALIGNMENT ) != 0 ) )
+	{
+		pxJob->xStatus = csuimageSTATUS_FAILED;
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		pxJob->xStatus = csuimageSTATUS_PENDING;
+
+		/* Write any of the image held in the cache out to memory, where the
+		CSU DMA will read it, and write back any dirty lines in the
+		destination, so they cannot be evicted over the data the CSU DMA
+		writes.  Done once for the whole job, in one call, rather than for
+		each transfer. */
+		xRanges[ 0 ].Addr = ( INTPTR ) pxJob->pvImage;
+		xRanges[ 0 ].Len = ( INTPTR ) pxJob->xLength;
+
+		if( pxJob->pvDestination != NULL )
+		{
+			xRanges[ 1 ].Addr = ( INTPTR ) pxJob->pvDestination;
+			xRanges[ 1 ].Len = ( INTPTR ) pxJob->xLength;
+			ulRanges++;
+		}
+
+		Xil_DCacheFlushRanges( xRanges, ulRanges );
+
+		if( xQueueSendToBack( xJobQueue, &pxJob, xTicksToWait ) != pdPASS )
+		{
+			pxJob->xStatus = csuimageSTATUS_FAILED;
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			( void ) xTaskNotify( xServiceTask, csuimageEVENT_JOB_QUEUED, eSetBits );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xCSUImageWait( CSUImageJob_t *pxJob, TickType_t xTicksToWait )
+{
+TimeOut_t xTimeOut;
+
+	configASSERT( pxJob );
+	configASSERT( pxJob->xRequestingTask == xTaskGetCurrentTaskHandle() );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	/* The notification that wakes the task may be left over from another job
+	that finished before it was waited for, so the state is checked each time
+	the task wakes. */
+	while( ( pxJob->xStatus == csuimageSTATUS_PENDING ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) )
+	{
+		( void ) ulTaskNotifyTakeIndexed( csuimageNOTIFICATION_INDEX, pdFALSE, xTicksToWait );
+	}
+
+	return pxJob->xStatus;
+}
+/*-----------------------------------------------------------*/
+
+size_t xCSUImageGetProgress( const CSUImageJob_t *pxJob, uint32_t *pulChecksum )
+{
+size_t xBytesDone;
+uint32_t ulChecksum;
+
+	configASSERT( pxJob );
+
+	/* The count and the checksum are updated together by the service task. */
+	taskENTER_CRITICAL();
+	{
+		xBytesDone = pxJob->xBytesDone;
+		ulChecksum = pxJob->ulChecksum;
+	}
+	taskEXIT_CRITICAL();
+
+	if( pulChecksum != NULL )
+	{
+		*pulChecksum = ulChecksum;
+	}
+
+	return xBytesDone;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulCSUImageChecksum( const void *pvImage, size_t xLength )
+{
+const uint32_t *pulWord = ( const uint32_t * ) pvImage;
+const uint32_t * const pulEnd = pulWord + ( xLength / sizeof( uint32_t ) );
+uint32_t ulSum0 = 0, ulSum1 = 0, ulSum2 = 0, ulSum3 = 0;
+
+	configASSERT( ( ( UINTPTR ) pvImage % sizeof( uint32_t ) ) == 0 );
+
+	/* Four independent sums, so the additions do not wait on each other. */
+	while( ( pulEnd - pulWord ) >= 4 )
+	{
+		ulSum0 += pulWord[ 0 ];
+		ulSum1 += pulWord[ 1 ];
+		ulSum2 += pulWord[ 2 ];
+		ulSum3 += pulWord[ 3 ];
+		pulWord += 4;
+	}
+
+	while( pulWord < pulEnd )
+	{
+		ulSum0 += *pulWord;
+		pulWord++;
+	}
+
+	return ulSum0 + ulSum1 + ulSum2 + ulSum3;
+}
+/*-----------------------------------------------------------*/
+
+void vCSUImageGetStats( CSUImageStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartJob( void )
+{
+	if( xQueueReceive( xJobQueue, &pxCurrentJob, 0 ) == pdPASS )
+	{
+		prvClearChecksum();
+		prvStartChunk( 0 );
+	}
+	else
+	{
+		pxCurrentJob = NULL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartChunk( size_t xOffset )
+{
+CSUImageJob_t * const pxJob = pxCurrentJob;
+void *pvDestination;
+
+	xChunkOffset = xOffset;
+	xChunkLength = pxJob->xLength - xOffset;
+
+	if( xChunkLength > ( size_t ) csuimageCHUNK_SIZE )
+	{
+		xChunkLength = ( size_t ) csuimageCHUNK_SIZE;
+	}
+
+	if( pxJob->pvDestination != NULL )
+	{
+		pvDestination = &( ( ( uint8_t * ) pxJob->pvDestination )[ xOffset ] );
+	}
+	else
+	{
+		pvDestination = ucScratch;
+	}
+
+	xTransferStatus = csuimageSTATUS_PENDING;
+	prvStartTransfer( &( ( ( const uint8_t * ) pxJob->pvImage )[ xOffset ] ), pvDestination, xChunkLength );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinishChunk( void )
+{
+CSUImageJob_t * const pxJob = pxCurrentJob;
+const size_t xOffset = xChunkOffset, xLength = xChunkLength;
+const size_t xBytesDone = xOffset + xLength;
+uint32_t ulChecksum;
+
+	if( xTransferStatus != csuimageSTATUS_COMPLETE )
+	{
+		prvResetDMA();
+
+		taskENTER_CRITICAL();
+		{
+			xStats.ulFailures++;
+		}
+		taskEXIT_CRITICAL();
+
+		prvFinishJob( csuimageSTATUS_FAILED );
+	}
+	else
+	{
+		/* The checksum register holds the sum of every word read since the job
+		started, so must be read before the next transfer adds to it. */
+		ulChecksum = prvReadChecksum();
+
+		/* Keep the CSU DMA busy while the part just transferred is dealt
+		with. */
+		if( xBytesDone < pxJob->xLength )
+		{
+			prvStartChunk( xBytesDone );
+		}
+
+		/* Discard any lines the CPU speculatively loaded from the destination
+		while the CSU DMA was writing it. */
+		if( pxJob->pvDestination != NULL )
+		{
+			Xil_DCacheInvalidateRange( ( INTPTR ) &( ( ( uint8_t * ) pxJob->pvDestination )[ xOffset ] ), ( INTPTR ) xLength );
+		}
+
+		taskENTER_CRITICAL();
+		{
+			pxJob->xBytesDone = xBytesDone;
+			pxJob->ulChecksum = ulChecksum;
+			xStats.ulChunks++;
+			xStats.ullBytes += ( uint64_t ) xLength;
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxJob->pxProgressCallback != NULL )
+		{
+			pxJob->pxProgressCallback( pxJob, xBytesDone, ulChecksum );
+		}
+
+		if( xBytesDone == pxJob->xLength )
+		{
+			if( ulChecksum == pxJob->ulExpectedChecksum )
+			{
+				prvFinishJob( csuimageSTATUS_COMPLETE );
+			}
+			else
+			{
+				taskENTER_CRITICAL();
+				{
+					xStats.ulMismatches++;
+				}
+				taskEXIT_CRITICAL();
+
+				prvFinishJob( csuimageSTATUS_MISMATCH );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinishJob( BaseType_t xStatus )
+{
+CSUImageJob_t * const pxJob = pxCurrentJob;
+TaskHandle_t xTask;
+
+	pxCurrentJob = NULL;
+
+	taskENTER_CRITICAL();
+	{
+		xStats.ulJobs++;
+	}
+	taskEXIT_CRITICAL();
+
+	/* The job belongs to the task again as soon as its state changes, so the
+	task handle is read first. */
+	xTask = pxJob->xRequestingTask;
+	pxJob->xStatus = xStatus;
+	( void ) xTaskNotifyGiveIndexed( xTask, csuimageNOTIFICATION_INDEX );
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessEvents( uint32_t ulEvents )
+{
+	( void ) ulEvents;
+
+	/* Each event only says that something may have changed, so both are
+	handled by looking at the state. */
+	if( ( pxCurrentJob != NULL ) && ( xTransferStatus != csuimageSTATUS_PENDING ) )
+	{
+		prvFinishChunk();
+	}
+
+	if( pxCurrentJob == NULL )
+	{
+		prvStartJob();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCSUImageTask( void *pvParameters )
+{
+uint32_t ulEvents;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) xTaskNotifyWait( 0, csuimageALL_EVENTS, &ulEvents, portMAX_DELAY );
+		prvProcessEvents( ulEvents );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTransferEndedFromISR( BaseType_t xSucceeded )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* A transfer that ends with both an error and a done interrupt is only
+	reported once. */
+	if( xTransferStatus == csuimageSTATUS_PENDING )
+	{
+		xTransferStatus = ( xSucceeded != pdFALSE ) ? csuimageSTATUS_COMPLETE : csuimageSTATUS_FAILED;
+		( void ) xTaskNotifyFromISR( xServiceTask, csuimageEVENT_TRANSFER_ENDED, eSetBits, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+#if( csuimageUSE_HOST_MODEL == 1 )
+
+	static BaseType_t prvInitDMA( void )
+	{
+		vHostCSUDMAModelInit( prvTransferEndedFromISR );
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStartTransfer( const void *pvSource, void *pvDestination, size_t xLength )
+	{
+	bool bStarted;
+
+		bStarted = bHostCSUDMAModelStart( pvSource, pvDestination, xLength );
+		configASSERT( bStarted != false );
+		( void ) bStarted;
+	}
+	/*-----------------------------------------------------------*/
+
+	static uint32_t prvReadChecksum( void )
+	{
+		return ulHostCSUDMAModelGetChecksum();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvClearChecksum( void )
+	{
+		vHostCSUDMAModelClearChecksum();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetDMA( void )
+	{
+		vHostCSUDMAModelReset();
+	}
+	/*-----------------------------------------------------------*/
+
+#else
+
+	static BaseType_t prvInitDMA( void )
+	{
+	extern XScuGic xInterruptController;
+	XCsuDma_Config *pxConfig;
+	BaseType_t xReturn = pdFAIL;
+	const uint8_t ucLevelSensitive = 1;
+
+		pxConfig = XCsuDma_LookupConfig( XPAR_XCSUDMA_0_DEVICE_ID );
+
+		if( ( pxConfig != NULL ) && ( XCsuDma_CfgInitialize( &xCSUDMAInstance, pxConfig, pxConfig->BaseAddress ) == XST_SUCCESS ) )
+		{
+			/* Route the source channel's stream to the destination channel. */
+			Xil_Out32( csuimageSSS_CFG_ADDRESS, ( Xil_In32( csuimageSSS_CFG_ADDRESS ) & ~csuimageSSS_DMA_MASK ) | csuimageSSS_DMA_LOOPBACK );
+
+			XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, XCSUDMA_IXR_SRC_MASK );
+			XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, XCSUDMA_IXR_DST_MASK );
+			XCsuDma_EnableIntr( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, csuimageSRC_INTERRUPTS );
+			XCsuDma_EnableIntr( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, csuimageDST_INTERRUPTS );
+
+			/* The interrupt calls FreeRTOS API functions, so must be at or
+			below the maximum API call interrupt priority.  The handler clears
+			the CSU DMA's interrupt status, so it is level sensitive. */
+			XScuGic_SetPriorityTriggerType( &xInterruptController, XPAR_XCSUDMA_INTR, configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
+
+			if( XScuGic_Connect( &xInterruptController, XPAR_XCSUDMA_INTR, ( Xil_InterruptHandler ) prvCSUDMAHandler, NULL ) == XST_SUCCESS )
+			{
+				vIRQDispatchUpdate( XPAR_XCSUDMA_INTR );
+				XScuGic_Enable( &xInterruptController, XPAR_XCSUDMA_INTR );
+				xReturn = pdPASS;
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStartTransfer( const void *pvSource, void *pvDestination, size_t xLength )
+	{
+	const uint64_t ullSource = ( uint64_t ) ( UINTPTR ) pvSource;
+	const uint64_t ullDestination = ( uint64_t ) ( UINTPTR ) pvDestination;
+	const u32 ulWords = ( u32 ) ( xLength / sizeof( uint32_t ) );
+
+		/* The cache was cleaned for the whole job when it was submitted, so the
+		transfers are started with XCsuDma_64BitTransfer(), which, unlike
+		XCsuDma_Transfer(), does no cache maintenance of its own.  The
+		destination channel is started first, so it is ready for the first
+		of the data. */
+		XCsuDma_64BitTransfer( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, ( u32 ) ullDestination, ( u32 ) ( ullDestination >> 32ULL ), ulWords, 0 );
+		XCsuDma_64BitTransfer( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, ( u32 ) ullSource, ( u32 ) ( ullSource >> 32ULL ), ulWords, 0 );
+	}
+	/*-----------------------------------------------------------*/
+
+	static uint32_t prvReadChecksum( void )
+	{
+		return XCsuDma_GetCheckSum( &xCSUDMAInstance );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvClearChecksum( void )
+	{
+		XCsuDma_ClearCheckSum( &xCSUDMAInstance );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetDMA( void )
+	{
+		/* The interrupt enables are set again in case the reset cleared them.
+		The SSS route is not part of the CSU DMA, so is not affected. */
+		XCsuDma_Reset();
+		XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, XCSUDMA_IXR_SRC_MASK );
+		XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, XCSUDMA_IXR_DST_MASK );
+		XCsuDma_EnableIntr( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, csuimageSRC_INTERRUPTS );
+		XCsuDma_EnableIntr( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, csuimageDST_INTERRUPTS );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCSUDMAHandler( void *pvUnused )
+	{
+	u32 ulSourceStatus, ulDestinationStatus;
+
+		( void ) pvUnused;
+
+		ulSourceStatus = XCsuDma_IntrGetStatus( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL );
+		ulDestinationStatus = XCsuDma_IntrGetStatus( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL );
+		XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_SRC_CHANNEL, ulSourceStatus );
+		XCsuDma_IntrClear( &xCSUDMAInstance, XCSUDMA_DST_CHANNEL, ulDestinationStatus );
+
+		if( ( ( ulSourceStatus | ulDestinationStatus ) & csuimageERRORS ) != 0U )
+		{
+			prvTransferEndedFromISR( pdFALSE );
+		}
+		else if( ( ulDestinationStatus & XCSUDMA_IXR_DONE_MASK ) != 0U )
+		{
+			prvTransferEndedFromISR( pdTRUE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* csuimageUSE_HOST_MODEL */
@@ -0,0 +1,138 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef CSU_IMAGE_H
+#define CSU_IMAGE_H
+
+/*
+ * A service that verifies, and optionally copies, firmware images with the
+ * configuration security unit's DMA controller (CSU DMA), using the checksum
+ * the CSU DMA calculates over the data it reads.  A task submits an image,
+ * then carries on while the image streams through the CSU DMA, and can follow
+ * its progress or wait for it to complete.  See CSUImage.c.
+ */
+
+/* The destination of an image that is copied must be a multiple of this, as
+the CSU DMA is not coherent with the data cache - see CSUImage.c. */
+#define csuimageALIGNMENT					64U
+
+/* The states of a job. */
+#define csuimageSTATUS_PENDING				( ( BaseType_t ) 0 )
+#define csuimageSTATUS_COMPLETE				( ( BaseType_t ) 1 )	/* The checksum matched. */
+#define csuimageSTATUS_MISMATCH				( ( BaseType_t ) 2 )	/* The image was read, but the checksum did not match. */
+#define csuimageSTATUS_FAILED				( ( BaseType_t ) 3 )	/* The job was rejected, or the CSU DMA reported an error. */
+
+struct CSU_IMAGE_JOB;
+
+/* The prototype of the function called as a job progresses - see
+CSUImageJob_t. */
+typedef void ( *CSUImageProgressCallback_t )( struct CSU_IMAGE_JOB *pxJob, size_t xBytesDone, uint32_t ulChecksum );
+
+/* A request to read the xLength bytes at pvImage through the CSU DMA, and
+compare their checksum with ulExpectedChecksum.  The image must be 4 byte
+aligned, and xLength a multiple of 4.  If pvDestination is not NULL the image
+is also copied to pvDestination, which must be csuimageALIGNMENT aligned.
+
+If pxProgressCallback is not NULL it is called, from the service task, each
+time another part of the image has been read, with the number of bytes read so
+far and their checksum.  At that point those bytes have also been copied.  The
+callback must not block.
+
+The job and the buffers belong to the service from when the job is submitted
+until it is no longer csuimageSTATUS_PENDING. */
+typedef struct CSU_IMAGE_JOB
+{
+	const void *pvImage;
+	void *pvDestination;
+	size_t xLength;
+	uint32_t ulExpectedChecksum;
+	CSUImageProgressCallback_t pxProgressCallback;
+	void *pvContext;						/* For use by the callback. */
+
+	/* Private to the service. */
+	TaskHandle_t xRequestingTask;
+	size_t xBytesDone;
+	uint32_t ulChecksum;
+	volatile BaseType_t xStatus;
+} CSUImageJob_t;
+
+/* Counters maintained by the service. */
+typedef struct CSU_IMAGE_STATS
+{
+	uint32_t ulJobs;						/* Jobs finished, whatever their state. */
+	uint32_t ulMismatches;					/* Jobs whose checksum did not match. */
+	uint32_t ulFailures;					/* Jobs the CSU DMA reported an error for. */
+	uint32_t ulChunks;						/* Transfers run. */
+	uint64_t ullBytes;						/* Bytes read. */
+} CSUImageStats_t;
+
+/*
+ * Initialise the CSU DMA and start the task that runs it at priority
+ * uxPriority.  Must be called once, from main() or a task, before the other
+ * functions.  Returns pdPASS if the service was started.
+ */
+BaseType_t xCSUImageInit( UBaseType_t uxPriority );
+
+/*
+ * Queue pxJob, waiting up to xTicksToWait ticks for space in the queue, and
+ * return without waiting for the image to be read.  Jobs are run one at a
+ * time, in the order they were submitted.  Must only be called from a task,
+ * once the scheduler has started.
+ *
+ * Returns pdPASS if the job was queued, or pdFAIL if it was not queued because
+ * it breaks the rules above or the queue stayed full.
+ */
+BaseType_t xCSUImageSubmit( CSUImageJob_t *pxJob, TickType_t xTicksToWait );
+
+/*
+ * Wait up to xTicksToWait ticks for a job submitted by the calling task to
+ * finish, and return its state.  Each finished job gives the task that
+ * submitted it a notification at index csuimageNOTIFICATION_INDEX - see
+ * CSUImage.c.
+ */
+BaseType_t xCSUImageWait( CSUImageJob_t *pxJob, TickType_t xTicksToWait );
+
+/*
+ * Return the number of bytes of a job's image read so far.  If pulChecksum is
+ * not NULL it is set to the checksum of those bytes.  Can be called from any
+ * task.
+ */
+size_t xCSUImageGetProgress( const CSUImageJob_t *pxJob, uint32_t *pulChecksum );
+
+/*
+ * Return the checksum the CSU DMA calculates, calculated by the CPU instead -
+ * the 32-bit sum of the xLength / 4 words at pvImage.  Used to find the
+ * expected checksum of an image, and by the host model.
+ */
+uint32_t ulCSUImageChecksum( const void *pvImage, size_t xLength );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vCSUImageGetStats( CSUImageStats_t *pxStats );
+
+#endif /* CSU_IMAGE_H */
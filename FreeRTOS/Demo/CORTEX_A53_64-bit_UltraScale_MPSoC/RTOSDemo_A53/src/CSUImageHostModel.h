@@ -0,0 +1,138 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef CSU_IMAGE_HOST_MODEL_H
+#define CSU_IMAGE_HOST_MODEL_H
+
+/*
+ * A software model of the CSU DMA in loopback, used in place of the hardware
+ * when CSUImage.c is built on a host with csuimageUSE_HOST_MODEL set to 1.
+ * Like the hardware, the model refuses a new transfer while one is running,
+ * adds each word it reads to a checksum that is only reset when it is
+ * cleared, and raises its interrupt when the transfer ends.
+ *
+ * Nothing is read until a host harness calls bHostCSUDMAModelComplete(), so
+ * the harness decides when each transfer finishes, relative to the tasks, and
+ * whether it finishes with an error.
+ *
+ * HostTest/CSUImageTest.c is such a harness.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct HostCSUDMAModel
+{
+	const uint8_t *pucSource;
+	uint8_t *pucDestination;
+	size_t xLength;
+	bool bRunning;
+	uint32_t ulChecksum;
+	uint32_t ulTransfers;
+	uint32_t ulResets;
+	void ( *pxHandler )( BaseType_t xSucceeded );
+} HostCSUDMAModel_t;
+
+extern HostCSUDMAModel_t xHostCSUDMAModel;
+
+static inline void vHostCSUDMAModelInit( void ( *pxHandler )( BaseType_t xSucceeded ) )
+{
+	memset( &xHostCSUDMAModel, 0x00, sizeof( xHostCSUDMAModel ) );
+	xHostCSUDMAModel.pxHandler = pxHandler;
+}
+
+/* Start copying xLength bytes from pvSource to pvDestination.  Returns false
+if a transfer is already running. */
+static inline bool bHostCSUDMAModelStart( const void *pvSource, void *pvDestination, size_t xLength )
+{
+bool bStarted = false;
+
+	if( xHostCSUDMAModel.bRunning == false )
+	{
+		xHostCSUDMAModel.pucSource = ( const uint8_t * ) pvSource;
+		xHostCSUDMAModel.pucDestination = ( uint8_t * ) pvDestination;
+		xHostCSUDMAModel.xLength = xLength;
+		xHostCSUDMAModel.bRunning = true;
+		xHostCSUDMAModel.ulTransfers++;
+		bStarted = true;
+	}
+
+	return bStarted;
+}
+
+static inline bool bHostCSUDMAModelRunning( void )
+{
+	return xHostCSUDMAModel.bRunning;
+}
+
+static inline uint32_t ulHostCSUDMAModelGetChecksum( void )
+{
+	return xHostCSUDMAModel.ulChecksum;
+}
+
+static inline void vHostCSUDMAModelClearChecksum( void )
+{
+	xHostCSUDMAModel.ulChecksum = 0;
+}
+
+/* Stop any transfer without taking the interrupt. */
+static inline void vHostCSUDMAModelReset( void )
+{
+	xHostCSUDMAModel.bRunning = false;
+	xHostCSUDMAModel.ulResets++;
+}
+
+/* Finish the running transfer and take its interrupt.  With bError set the
+transfer stops half way, as after an AXI error.  Returns false if no transfer
+was running. */
+static inline bool bHostCSUDMAModelComplete( bool bError )
+{
+size_t xRead, x;
+uint32_t ulWord;
+bool bCompleted = false;
+
+	if( xHostCSUDMAModel.bRunning != false )
+	{
+		xRead = ( bError != false ) ? ( ( xHostCSUDMAModel.xLength / 2 ) & ~( size_t ) 3 ) : xHostCSUDMAModel.xLength;
+
+		for( x = 0; x < xRead; x += sizeof( ulWord ) )
+		{
+			memcpy( &ulWord, &( xHostCSUDMAModel.pucSource[ x ] ), sizeof( ulWord ) );
+			xHostCSUDMAModel.ulChecksum += ulWord;
+			memcpy( &( xHostCSUDMAModel.pucDestination[ x ] ), &ulWord, sizeof( ulWord ) );
+		}
+
+		xHostCSUDMAModel.bRunning = false;
+		xHostCSUDMAModel.pxHandler( ( bError != false ) ? pdFALSE : pdTRUE );
+		bCompleted = true;
+	}
+
+	return bCompleted;
+}
+
+#endif /* CSU_IMAGE_HOST_MODEL_H */
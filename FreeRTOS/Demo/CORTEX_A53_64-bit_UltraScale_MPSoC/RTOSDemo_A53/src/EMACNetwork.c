@@ -0,0 +1,978 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A zero copy frame interface to the GEM Ethernet MAC, built on the buffer
+ * descriptor ring functions in the emacps driver (xemacps_bdring.c).
+ *
+ * Every receive buffer that no task holds is posted to the receive descriptor
+ * ring, so the MAC always has somewhere to write an arriving frame.  When the
+ * MAC has filled a buffer the frame is passed to the receiving task as a
+ * pointer to the buffer, through a queue - the frame is never copied.  The
+ * task hands the buffer back with vEMACNetworkReleaseRxBuffer(), which puts it
+ * on a recycle queue.  Released buffers are posted to the ring again in
+ * batches: the network task is only woken once emacnetPOST_BATCH buffers are
+ * waiting (or the number posted runs low), and then allocates, cleans and
+ * hands over the descriptors for the whole batch together.  Transmission works
+ * the same way in reverse - a task fills a buffer from the transmit pool, and
+ * the MAC reads the frame from that buffer.
+ *
+ * Receive interrupts are coalesced.  The interrupt handler masks the receive
+ * interrupt before waking the network task, and the task takes frames from the
+ * ring, emacnetRX_BATCH descriptors at a time, until the ring is empty before
+ * unmasking it again - so a burst of frames costs one interrupt.  Each batch is
+ * taken with XEmacPs_BdRingFromHwRxBatch(), which reads each descriptor once
+ * and invalidates the cache over all the batch's frames in one pass.  Transmit
+ * complete interrupts are handled the same way, with
+ * XEmacPs_BdRingFromHwTxBatch().
+ *
+ * The descriptors are shared with the MAC, so are placed in a block of memory
+ * that is mapped non-cacheable.  The buffers are cached, and are cleaned and
+ * invalidated around each transfer.
+ *
+ * Building with emacnetUSE_HOST_MODEL set to 1 replaces the MAC and the
+ * interrupt controller with the model in EMACNetworkHostModel.h, which owns
+ * the descriptor rings as the MAC does, so the ring management can be tested
+ * on a host, with or without the model looping transmitted frames back.
+ *
+ * On the target the file is empty unless emacnetENABLE is set to 1.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* Demo includes. */
+#include "EMACNetwork.h"
+
+#ifndef emacnetUSE_HOST_MODEL
+	#define emacnetUSE_HOST_MODEL		0
+#endif
+
+#if( ( emacnetENABLE == 1 ) || ( emacnetUSE_HOST_MODEL == 1 ) )
+
+/* Xilinx includes. */
+#include "xemacps.h"
+#include "xil_cache.h"
+
+#if( emacnetUSE_HOST_MODEL == 1 )
+
+	#include "EMACNetworkHostModel.h"
+
+	#define emacnetREAD_REG( ulOffset )				ulHostMACModelRead( ulOffset )
+	#define emacnetWRITE_REG( ulOffset, ulValue )	vHostMACModelWrite( ( ulOffset ), ( ulValue ) )
+	#define emacnetREAD_COUNTER()					ullHostMACModelReadCounter()
+	#define emacnetBARRIER()						__asm volatile( "" ::: "memory" )
+
+	/* The model needs no particular placement for the descriptors. */
+	#define emacnetDESCRIPTOR_BLOCK_SIZE			XEMACPS_BD_ALIGNMENT
+
+#else
+
+	/* Demo includes. */
+	#include "IRQDispatch.h"
+
+	/* Xilinx includes. */
+	#include "xscugic.h"
+	#include "xil_mmu.h"
+
+	/* The MAC wired to the PHY on the ZCU102 - device 0 is GEM3. */
+	#define emacnetDEVICE_ID						XPAR_XEMACPS_0_DEVICE_ID
+	#define emacnetINTERRUPT_ID						XPAR_XEMACPS_3_INTR
+
+	#define emacnetREAD_REG( ulOffset )				XEmacPs_ReadReg( xEMACInstance.Config.BaseAddress, ( ulOffset ) )
+	#define emacnetWRITE_REG( ulOffset, ulValue )	XEmacPs_WriteReg( xEMACInstance.Config.BaseAddress, ( ulOffset ), ( ulValue ) )
+	#define emacnetREAD_COUNTER()					prvReadCounter()
+	#define emacnetBARRIER()						__asm volatile( "DSB SY" ::: "memory" )
+
+	/* The smallest block whose attributes Xil_SetTlbAttributes() can change. */
+	#define emacnetDESCRIPTOR_BLOCK_SIZE			0x200000UL
+
+	/* The link speed, in Mbps.  The PHY is not configured here, so must
+	already be set up for this speed - for example by its strapping or by the
+	boot loader. */
+	#ifndef emacnetLINK_SPEED
+		#define emacnetLINK_SPEED					1000
+	#endif
+
+	static inline uint64_t prvReadCounter( void )
+	{
+	uint64_t ullCount;
+
+		__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+
+		return ullCount;
+	}
+
+#endif /* emacnetUSE_HOST_MODEL */
+
+/* The most descriptors taken from, or buffers posted to, the receive ring in
+one batch.  Sets the size of three arrays on the network task's stack. */
+#ifndef emacnetRX_BATCH
+	#define emacnetRX_BATCH					16
+#endif
+
+/* The most descriptors taken from the transmit ring in one batch. */
+#ifndef emacnetTX_BATCH
+	#define emacnetTX_BATCH					16
+#endif
+
+/* The number of batches taken from the receive ring before the network task
+looks at its other events. */
+#ifndef emacnetRX_BUDGET
+	#define emacnetRX_BUDGET				4
+#endif
+
+/* Released receive buffers are posted once this many are waiting, or straight
+away if fewer than emacnetRX_LOW_WATER buffers are posted. */
+#ifndef emacnetPOST_BATCH
+	#define emacnetPOST_BATCH				8
+#endif
+
+#ifndef emacnetRX_LOW_WATER
+	#define emacnetRX_LOW_WATER				( emacnetRX_BUFFERS / 4 )
+#endif
+
+/* The network task also wakes this often, so buffers released in smaller
+numbers than emacnetPOST_BATCH are still posted. */
+#ifndef emacnetIDLE_POLL_TICKS
+	#define emacnetIDLE_POLL_TICKS			pdMS_TO_TICKS( 10 )
+#endif
+
+/* The number of received frames that can wait for a task.  The default can
+hold every receive buffer. */
+#ifndef emacnetRX_QUEUE_LENGTH
+	#define emacnetRX_QUEUE_LENGTH			emacnetRX_BUFFERS
+#endif
+
+#ifndef emacnetTASK_STACK_SIZE
+	#define emacnetTASK_STACK_SIZE			( configMINIMAL_STACK_SIZE * 2 )
+#endif
+
+/* The events sent to the network task, as bits in its notification value. */
+#define emacnetEVENT_RX						( 1UL << 0UL )
+#define emacnetEVENT_TX						( 1UL << 1UL )
+#define emacnetEVENT_POST					( 1UL << 2UL )
+#define emacnetALL_EVENTS					( emacnetEVENT_RX | emacnetEVENT_TX | emacnetEVENT_POST )
+
+/* Not sent - used when the network task wakes because its block time
+expired. */
+#define emacnetEVENT_TIMEOUT				( 1UL << 3UL )
+
+/* The interrupts used.  The receive and transmit interrupts are masked while
+the network task services the rings. */
+#define emacnetRX_INTERRUPTS				( XEMACPS_IXR_FRAMERX_MASK | XEMACPS_IXR_RXUSED_MASK )
+#define emacnetTX_INTERRUPTS				( XEMACPS_IXR_TXCOMPL_MASK )
+#define emacnetERROR_INTERRUPTS				( ( XEMACPS_IXR_RX_ERR_MASK & ~XEMACPS_IXR_RXUSED_MASK ) | XEMACPS_IXR_TX_ERR_MASK )
+
+#if( ( emacnetBUFFER_SIZE != XEMACPS_RX_BUF_SIZE ) || ( ( emacnetBUFFER_SIZE % 64 ) != 0 ) )
+	#error emacnetBUFFER_SIZE must equal XEMACPS_RX_BUF_SIZE, and be a multiple of the cache line size.
+#endif
+
+#if( ( emacnetRX_BATCH > emacnetRX_BUFFERS ) || ( emacnetPOST_BATCH > emacnetRX_BUFFERS ) )
+	#error emacnetRX_BATCH and emacnetPOST_BATCH cannot exceed emacnetRX_BUFFERS.
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The descriptor rings.  There is one receive descriptor per receive buffer,
+so a released buffer always has a descriptor to be posted with, and one
+transmit descriptor per transmit buffer.  The MAC's second transmit queue is
+never used, but has to point at a descriptor that stops it. */
+typedef struct EMAC_DESCRIPTORS
+{
+	XEmacPs_Bd xRx[ emacnetRX_BUFFERS ] __attribute__( ( aligned( XEMACPS_BD_ALIGNMENT ) ) );
+	XEmacPs_Bd xTx[ emacnetTX_BUFFERS ] __attribute__( ( aligned( XEMACPS_BD_ALIGNMENT ) ) );
+	XEmacPs_Bd xTxTerminate __attribute__( ( aligned( XEMACPS_BD_ALIGNMENT ) ) );
+} EMACDescriptors_t;
+
+/* Pads the descriptors out to a whole block, so nothing else shares their
+memory attributes. */
+typedef union EMAC_DESCRIPTOR_BLOCK
+{
+	EMACDescriptors_t xDescriptors;
+	uint8_t ucBlock[ emacnetDESCRIPTOR_BLOCK_SIZE ];
+} EMACDescriptorBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Configure the MAC and create the descriptor rings, leaving the MAC stopped.
+ */
+static BaseType_t prvInitMAC( const uint8_t *pucMACAddress, BaseType_t xLoopback );
+
+/*
+ * Install the interrupt handler and start the MAC.
+ */
+static BaseType_t prvStartMAC( BaseType_t xLoopback );
+
+/*
+ * Create and initialise both descriptor rings.  Every transmit descriptor
+ * starts with its used bit set, and every receive descriptor with its new bit
+ * set, so the MAC does not touch any of them until they are handed over.
+ */
+static BaseType_t prvCreateRings( void );
+
+/*
+ * Take up to emacnetRX_BATCH descriptors the MAC has filled from the receive
+ * ring, and pass their frames to the receive queue.  Returns the number of
+ * descriptors taken.  Called from the network task.
+ */
+static uint32_t prvReceiveFrames( void );
+
+/*
+ * Post the released receive buffers to the receive ring, in batches of up to
+ * emacnetRX_BATCH.  Unless xPostAll is pdTRUE nothing is posted until
+ * emacnetPOST_BATCH buffers are waiting, or the number posted is below
+ * emacnetRX_LOW_WATER.  Called from the network task.
+ */
+static void prvPostRxBuffers( BaseType_t xPostAll );
+
+/*
+ * Return the buffers of the frames the MAC has sent to the transmit pool.
+ * Called from the network task.
+ */
+static void prvReclaimTxBuffers( void );
+
+/*
+ * Unmask ulInterrupts, first clearing any of their status bits that latched
+ * while they were masked.  Called from the network task.
+ */
+static void prvEnableInterrupts( uint32_t ulInterrupts );
+
+/*
+ * Returns pdTRUE if the MAC has filled the next receive descriptor.
+ */
+static BaseType_t prvRxFramePending( void );
+
+/*
+ * Act on the events in ulEvents.
+ */
+static void prvProcessEvents( uint32_t ulEvents );
+
+/*
+ * The task that services the descriptor rings.
+ */
+static void prvEMACNetworkTask( void *pvParameters );
+
+/*
+ * The MAC interrupt handler.
+ */
+static void prvInterruptHandler( void *pvCallBackRef );
+
+/*-----------------------------------------------------------*/
+
+static XEmacPs xEMACInstance;
+
+static EMACDescriptorBlock_t xDescriptorBlock __attribute__( ( aligned( emacnetDESCRIPTOR_BLOCK_SIZE ) ) );
+
+static uint8_t ucRxBuffers[ emacnetRX_BUFFERS ][ emacnetBUFFER_SIZE ] __attribute__( ( aligned( 64 ) ) );
+static uint8_t ucTxBuffers[ emacnetTX_BUFFERS ][ emacnetBUFFER_SIZE ] __attribute__( ( aligned( 64 ) ) );
+
+/* Receive buffers waiting to be posted.  Only accessed by the network task. */
+static uint8_t *pucBuffersToPost[ emacnetRX_BUFFERS ];
+static UBaseType_t uxBuffersToPost = 0;
+
+/* The number of receive buffers posted to the ring.  Written by the network
+task, and read without a lock by tasks releasing buffers. */
+static volatile uint32_t ulRxBuffersPosted = 0;
+
+/* Received frames waiting for a task, released receive buffers, free transmit
+buffers, and the mutex that serialises access to the transmit ring. */
+static QueueHandle_t xRxQueue = NULL, xRecycleQueue = NULL, xTxFreeQueue = NULL;
+static SemaphoreHandle_t xTxMutex = NULL;
+
+static TaskHandle_t xNetworkTask = NULL;
+
+static EMACNetworkStats_t xStats;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xEMACNetworkInit( const uint8_t *pucMACAddress, BaseType_t xLoopback, UBaseType_t uxPriority )
+{
+BaseType_t xReturn = pdFAIL;
+uint8_t *pucBuffer;
+UBaseType_t ux;
+
+	configASSERT( xNetworkTask == NULL );
+
+	xRxQueue = xQueueCreate( emacnetRX_QUEUE_LENGTH, sizeof( EMACFrame_t ) );
+	xRecycleQueue = xQueueCreate( emacnetRX_BUFFERS, sizeof( uint8_t * ) );
+	xTxFreeQueue = xQueueCreate( emacnetTX_BUFFERS, sizeof( uint8_t * ) );
+	xTxMutex = xSemaphoreCreateMutex();
+
+	if( ( xRxQueue != NULL ) && ( xRecycleQueue != NULL ) && ( xTxFreeQueue != NULL ) && ( xTxMutex != NULL ) )
+	{
+		for( ux = 0; ux < ( UBaseType_t ) emacnetTX_BUFFERS; ux++ )
+		{
+			pucBuffer = ucTxBuffers[ ux ];
+			( void ) xQueueSendToBack( xTxFreeQueue, &pucBuffer, 0 );
+		}
+
+		for( ux = 0; ux < ( UBaseType_t ) emacnetRX_BUFFERS; ux++ )
+		{
+			pucBuffersToPost[ ux ] = ucRxBuffers[ ux ];
+		}
+
+		uxBuffersToPost = emacnetRX_BUFFERS;
+
+		xReturn = prvInitMAC( pucMACAddress, xLoopback );
+	}
+
+	if( xReturn == pdPASS )
+	{
+		/* Every buffer is posted before the receiver is enabled. */
+		prvPostRxBuffers( pdTRUE );
+
+		xReturn = xTaskCreate( prvEMACNetworkTask, "EMAC", emacnetTASK_STACK_SIZE, NULL, uxPriority, &xNetworkTask );
+	}
+
+	if( xReturn == pdPASS )
+	{
+		xReturn = prvStartMAC( xLoopback );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xEMACNetworkReceive( EMACFrame_t *pxFrame, TickType_t xTicksToWait )
+{
+	configASSERT( xRxQueue );
+
+	return xQueueReceive( xRxQueue, pxFrame, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+void vEMACNetworkReleaseRxBuffer( uint8_t *pucBuffer )
+{
+	configASSERT( ( pucBuffer >= ucRxBuffers[ 0 ] ) && ( pucBuffer < ucRxBuffers[ emacnetRX_BUFFERS ] ) );
+	configASSERT( ( ( pucBuffer - ucRxBuffers[ 0 ] ) % emacnetBUFFER_SIZE ) == 0 );
+
+	/* The queue can hold every buffer, so is never full. */
+	( void ) xQueueSendToBack( xRecycleQueue, &pucBuffer, 0 );
+
+	/* Posting buffers one at a time would wake the network task for each, so
+	let them gather unless the MAC is running short. */
+	if( ( uxQueueMessagesWaiting( xRecycleQueue ) >= ( UBaseType_t ) emacnetPOST_BATCH ) || ( ulRxBuffersPosted < ( uint32_t ) emacnetRX_LOW_WATER ) )
+	{
+		( void ) xTaskNotify( xNetworkTask, emacnetEVENT_POST, eSetBits );
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint8_t *pucEMACNetworkGetTxBuffer( TickType_t xTicksToWait )
+{
+uint8_t *pucBuffer;
+
+	configASSERT( xTxFreeQueue );
+
+	if( xQueueReceive( xTxFreeQueue, &pucBuffer, xTicksToWait ) != pdPASS )
+	{
+		pucBuffer = NULL;
+	}
+
+	return pucBuffer;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xEMACNetworkSend( uint8_t *pucBuffer, size_t xLength )
+{
+XEmacPs_BdRing * const pxRing = &( XEmacPs_GetTxRing( &xEMACInstance ) );
+XEmacPs_Bd *pxBd;
+uint32_t ulStatus;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( ( pucBuffer >= ucTxBuffers[ 0 ] ) && ( pucBuffer < ucTxBuffers[ emacnetTX_BUFFERS ] ) );
+	configASSERT( ( ( pucBuffer - ucTxBuffers[ 0 ] ) % emacnetBUFFER_SIZE ) == 0 );
+	configASSERT( ( xLength > 0 ) && ( xLength <= ( size_t ) emacnetBUFFER_SIZE ) );
+
+	/* The MAC reads the frame from memory. */
+	Xil_DCacheFlushRange( ( INTPTR ) pucBuffer, ( INTPTR ) xLength );
+
+	( void ) xSemaphoreTake( xTxMutex, portMAX_DELAY );
+	{
+		/* There is one descriptor per buffer, and a descriptor is freed when
+		its buffer is returned to the pool, so this only fails if the buffer
+		was not obtained from pucEMACNetworkGetTxBuffer(). */
+		if( XEmacPs_BdRingAlloc( pxRing, 1, &pxBd ) == XST_SUCCESS )
+		{
+			XEmacPs_BdSetAddressTx( pxBd, ( UINTPTR ) pucBuffer );
+
+			/* Hand the descriptor to the MAC by clearing its used bit, in the
+			same write as the length, once the address is visible.  Only the
+			wrap bit is kept from the previous frame. */
+			ulStatus = XEmacPs_BdRead( pxBd, XEMACPS_BD_STAT_OFFSET ) & XEMACPS_TXBUF_WRAP_MASK;
+			emacnetBARRIER();
+			XEmacPs_BdWrite( pxBd, XEMACPS_BD_STAT_OFFSET, ulStatus | XEMACPS_TXBUF_LAST_MASK | ( uint32_t ) xLength );
+
+			( void ) XEmacPs_BdRingToHw( pxRing, 1, pxBd );
+			emacnetBARRIER();
+
+			/* The network control register is also written by the interrupt
+			handler. */
+			taskENTER_CRITICAL();
+			{
+				emacnetWRITE_REG( XEMACPS_NWCTRL_OFFSET, emacnetREAD_REG( XEMACPS_NWCTRL_OFFSET ) | XEMACPS_NWCTRL_STARTTX_MASK );
+				xStats.ulTxFrames++;
+			}
+			taskEXIT_CRITICAL();
+
+			xReturn = pdPASS;
+		}
+	}
+	( void ) xSemaphoreGive( xTxMutex );
+
+	if( xReturn != pdPASS )
+	{
+		vEMACNetworkReleaseTxBuffer( pucBuffer );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vEMACNetworkReleaseTxBuffer( uint8_t *pucBuffer )
+{
+	configASSERT( ( pucBuffer >= ucTxBuffers[ 0 ] ) && ( pucBuffer < ucTxBuffers[ emacnetTX_BUFFERS ] ) );
+
+	/* The queue can hold every buffer, so is never full. */
+	( void ) xQueueSendToBack( xTxFreeQueue, &pucBuffer, 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vEMACNetworkGetStats( EMACNetworkStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInitMAC( const uint8_t *pucMACAddress, BaseType_t xLoopback )
+{
+BaseType_t xReturn = pdFAIL;
+
+	#if( emacnetUSE_HOST_MODEL == 1 )
+	{
+		( void ) pucMACAddress;
+		( void ) xLoopback;
+
+		xReturn = prvCreateRings();
+
+		if( xReturn == pdPASS )
+		{
+			vHostMACModelInit( xDescriptorBlock.xDescriptors.xRx, xDescriptorBlock.xDescriptors.xTx, prvInterruptHandler );
+		}
+	}
+	#else
+	{
+	XEmacPs_Config *pxConfig;
+
+		pxConfig = XEmacPs_LookupConfig( emacnetDEVICE_ID );
+		configASSERT( pxConfig );
+
+		/* Resets the MAC, and leaves it stopped with the driver's default
+		options. */
+		if( XEmacPs_CfgInitialize( &xEMACInstance, pxConfig, pxConfig->BaseAddress ) == XST_SUCCESS )
+		{
+			( void ) XEmacPs_SetMacAddress( &xEMACInstance, ( void * ) pucMACAddress, 1 );
+			XEmacPs_SetOperatingSpeed( &xEMACInstance, emacnetLINK_SPEED );
+
+			if( xLoopback != pdFALSE )
+			{
+				emacnetWRITE_REG( XEMACPS_NWCTRL_OFFSET, emacnetREAD_REG( XEMACPS_NWCTRL_OFFSET ) | XEMACPS_NWCTRL_LOOPEN_MASK );
+			}
+
+			Xil_SetTlbAttributes( ( UINTPTR ) &xDescriptorBlock, NORM_NONCACHE );
+			xReturn = prvCreateRings();
+		}
+
+		if( xReturn == pdPASS )
+		{
+			XEmacPs_SetQueuePtr( &xEMACInstance, ( UINTPTR ) xDescriptorBlock.xDescriptors.xRx, 0, XEMACPS_RECV );
+			XEmacPs_SetQueuePtr( &xEMACInstance, ( UINTPTR ) xDescriptorBlock.xDescriptors.xTx, 0, XEMACPS_SEND );
+
+			if( xEMACInstance.Version > 2 )
+			{
+				XEmacPs_SetQueuePtr( &xEMACInstance, ( UINTPTR ) &( xDescriptorBlock.xDescriptors.xTxTerminate ), 1, XEMACPS_SEND );
+			}
+		}
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartMAC( BaseType_t xLoopback )
+{
+BaseType_t xReturn = pdFAIL;
+
+	#if( emacnetUSE_HOST_MODEL == 1 )
+	{
+	uint32_t ulControl = XEMACPS_NWCTRL_TXEN_MASK | XEMACPS_NWCTRL_RXEN_MASK;
+
+		/* As XEmacPs_Start(). */
+		if( xLoopback != pdFALSE )
+		{
+			ulControl |= XEMACPS_NWCTRL_LOOPEN_MASK;
+		}
+
+		emacnetWRITE_REG( XEMACPS_ISR_OFFSET, XEMACPS_IXR_ALL_MASK );
+		emacnetWRITE_REG( XEMACPS_NWCTRL_OFFSET, ulControl );
+		emacnetWRITE_REG( XEMACPS_IER_OFFSET, emacnetRX_INTERRUPTS | emacnetTX_INTERRUPTS | emacnetERROR_INTERRUPTS );
+		xReturn = pdPASS;
+	}
+	#else
+	{
+	extern XScuGic xInterruptController;
+	const uint8_t ucLevelSensitive = 1;
+
+		( void ) xLoopback;
+
+		/* The interrupt calls FreeRTOS API functions, so must be at or below
+		the maximum API call interrupt priority. */
+		XScuGic_SetPriorityTriggerType( &xInterruptController, emacnetINTERRUPT_ID, configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
+
+		if( XScuGic_Connect( &xInterruptController, emacnetINTERRUPT_ID, ( Xil_InterruptHandler ) prvInterruptHandler, NULL ) == XST_SUCCESS )
+		{
+			vIRQDispatchUpdate( emacnetINTERRUPT_ID );
+			XScuGic_Enable( &xInterruptController, emacnetINTERRUPT_ID );
+
+			/* Enables the receiver, the transmitter, and the receive, transmit
+			and error interrupts. */
+			XEmacPs_Start( &xEMACInstance );
+
+			/* The second transmit queue is not used. */
+			if( xEMACInstance.Version > 2 )
+			{
+				XEmacPs_IntQ1Disable( &xEMACInstance, XEMACPS_INTQ1_IXR_ALL_MASK );
+			}
+
+			xReturn = pdPASS;
+		}
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCreateRings( void )
+{
+EMACDescriptors_t * const pxDescriptors = &( xDescriptorBlock.xDescriptors );
+XEmacPs_BdRing * const pxRxRing = &( XEmacPs_GetRxRing( &xEMACInstance ) );
+XEmacPs_BdRing * const pxTxRing = &( XEmacPs_GetTxRing( &xEMACInstance ) );
+XEmacPs_Bd xTemplate;
+BaseType_t xReturn = pdFAIL;
+
+	XEmacPs_BdClear( &xTemplate );
+	XEmacPs_BdWrite( &xTemplate, XEMACPS_BD_ADDR_OFFSET, XEMACPS_RXBUF_NEW_MASK );
+
+	if( ( XEmacPs_BdRingCreate( pxRxRing, ( UINTPTR ) pxDescriptors->xRx, ( UINTPTR ) pxDescriptors->xRx, XEMACPS_BD_ALIGNMENT, emacnetRX_BUFFERS ) == XST_SUCCESS ) &&
+		( XEmacPs_BdRingClone( pxRxRing, &xTemplate, XEMACPS_RECV ) == XST_SUCCESS ) )
+	{
+		XEmacPs_BdClear( &xTemplate );
+		XEmacPs_BdWrite( &xTemplate, XEMACPS_BD_STAT_OFFSET, XEMACPS_TXBUF_USED_MASK );
+
+		if( ( XEmacPs_BdRingCreate( pxTxRing, ( UINTPTR ) pxDescriptors->xTx, ( UINTPTR ) pxDescriptors->xTx, XEMACPS_BD_ALIGNMENT, emacnetTX_BUFFERS ) == XST_SUCCESS ) &&
+			( XEmacPs_BdRingClone( pxTxRing, &xTemplate, XEMACPS_SEND ) == XST_SUCCESS ) )
+		{
+			XEmacPs_BdClear( &( pxDescriptors->xTxTerminate ) );
+			XEmacPs_BdWrite( &( pxDescriptors->xTxTerminate ), XEMACPS_BD_STAT_OFFSET, XEMACPS_TXBUF_USED_MASK | XEMACPS_TXBUF_WRAP_MASK );
+			xReturn = pdPASS;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvReceiveFrames( void )
+{
+XEmacPs_BdRing * const pxRing = &( XEmacPs_GetRxRing( &xEMACInstance ) );
+XEmacPs_BdVecEntry xBds[ emacnetRX_BATCH ];
+EMACFrame_t xFrames[ emacnetRX_BATCH ];
+uint32_t ulCount, ulFrames = 0, ulBadFrames = 0, ulQueueFull = 0, ul, ulStatus;
+uint8_t *pucBuffer;
+
+	/* The core may have loaded lines of the buffers speculatively while the MAC
+	was writing them, so this also invalidates them again - for the whole batch
+	in one pass. */
+	ulCount = XEmacPs_BdRingFromHwRxBatch( pxRing, emacnetRX_BATCH, XEMACPS_RX_BUF_SIZE, xBds );
+
+	if( ulCount > 0 )
+	{
+		for( ul = 0; ul < ulCount; ul++ )
+		{
+			pucBuffer = ( uint8_t * ) xBds[ ul ].BufAddr;
+			ulStatus = xBds[ ul ].Status;
+
+			if( ( ulStatus & ( XEMACPS_RXBUF_SOF_MASK | XEMACPS_RXBUF_EOF_MASK ) ) == ( XEMACPS_RXBUF_SOF_MASK | XEMACPS_RXBUF_EOF_MASK ) )
+			{
+				xFrames[ ulFrames ].pucData = pucBuffer;
+				xFrames[ ulFrames ].ulLength = ulStatus & XEMACPS_RXBUF_LEN_MASK;
+				ulFrames++;
+			}
+			else
+			{
+				/* Part of a frame that did not fit one buffer. */
+				pucBuffersToPost[ uxBuffersToPost++ ] = pucBuffer;
+				ulBadFrames++;
+			}
+		}
+
+		( void ) XEmacPs_BdRingFree( pxRing, ulCount, xBds[ 0 ].BdPtr );
+		ulRxBuffersPosted -= ulCount;
+
+		for( ul = 0; ul < ulFrames; ul++ )
+		{
+			if( xQueueSendToBack( xRxQueue, &( xFrames[ ul ] ), 0 ) != pdPASS )
+			{
+				pucBuffersToPost[ uxBuffersToPost++ ] = xFrames[ ul ].pucData;
+				ulQueueFull++;
+			}
+		}
+
+		taskENTER_CRITICAL();
+		{
+			xStats.ulRxFrames += ulFrames - ulQueueFull;
+			xStats.ulRxQueueFull += ulQueueFull;
+			xStats.ulRxBadFrames += ulBadFrames;
+			xStats.ulRxPolls++;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return ulCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPostRxBuffers( BaseType_t xPostAll )
+{
+XEmacPs_BdRing * const pxRing = &( XEmacPs_GetRxRing( &xEMACInstance ) );
+XEmacPs_Bd *pxBdSet, *pxBd;
+Xil_CacheRange xRanges[ emacnetRX_BATCH ];
+uint8_t *pucBuffer;
+uint32_t ulCount, ul;
+
+	while( ( uxBuffersToPost < ( UBaseType_t ) emacnetRX_BUFFERS ) && ( xQueueReceive( xRecycleQueue, &pucBuffer, 0 ) == pdPASS ) )
+	{
+		pucBuffersToPost[ uxBuffersToPost++ ] = pucBuffer;
+	}
+
+	/* Otherwise wait for enough buffers to share the cost of posting them, or
+	for the MAC to run short. */
+	if( ( uxBuffersToPost >= ( UBaseType_t ) emacnetPOST_BATCH ) || ( ulRxBuffersPosted < ( uint32_t ) emacnetRX_LOW_WATER ) )
+	{
+		xPostAll = pdTRUE;
+	}
+
+	while( ( xPostAll != pdFALSE ) && ( uxBuffersToPost > 0 ) )
+	{
+		ulCount = ( uint32_t ) uxBuffersToPost;
+
+		if( ulCount > ( uint32_t ) emacnetRX_BATCH )
+		{
+			ulCount = emacnetRX_BATCH;
+		}
+
+		/* There is one descriptor per buffer, so this cannot fail. */
+		if( XEmacPs_BdRingAlloc( pxRing, ulCount, &pxBdSet ) != XST_SUCCESS )
+		{
+			configASSERT( pdFALSE );
+			break;
+		}
+
+		pxBd = pxBdSet;
+
+		for( ul = 0; ul < ulCount; ul++ )
+		{
+			pucBuffer = pucBuffersToPost[ --uxBuffersToPost ];
+			xRanges[ ul ].Addr = ( INTPTR ) pucBuffer;
+			xRanges[ ul ].Len = emacnetBUFFER_SIZE;
+
+			/* Keeps the wrap and new bits. */
+			XEmacPs_BdSetAddressRx( pxBd, ( UINTPTR ) pucBuffer );
+			pxBd = XEmacPs_BdRingNext( pxRing, pxBd );
+		}
+
+		/* No dirty line may be written back over a frame once the MAC owns the
+		buffers, so clean and invalidate them all before any is handed over. */
+		Xil_DCacheInvalidateRanges( xRanges, ulCount );
+		emacnetBARRIER();
+
+		pxBd = pxBdSet;
+
+		for( ul = 0; ul < ulCount; ul++ )
+		{
+			XEmacPs_BdClearRxNew( pxBd );
+			pxBd = XEmacPs_BdRingNext( pxRing, pxBd );
+		}
+
+		( void ) XEmacPs_BdRingToHw( pxRing, ulCount, pxBdSet );
+		ulRxBuffersPosted += ulCount;
+
+		taskENTER_CRITICAL();
+		{
+			xStats.ulRxPostBatches++;
+			xStats.ulRxBuffersPosted += ulCount;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReclaimTxBuffers( void )
+{
+XEmacPs_BdRing * const pxRing = &( XEmacPs_GetTxRing( &xEMACInstance ) );
+XEmacPs_BdVecEntry xBds[ emacnetTX_BATCH ];
+uint32_t ulSent, ul;
+
+	( void ) xSemaphoreTake( xTxMutex, portMAX_DELAY );
+	{
+		do
+		{
+			ulSent = XEmacPs_BdRingFromHwTxBatch( pxRing, emacnetTX_BATCH, xBds );
+
+			for( ul = 0; ul < ulSent; ul++ )
+			{
+				vEMACNetworkReleaseTxBuffer( ( uint8_t * ) xBds[ ul ].BufAddr );
+			}
+
+			if( ulSent > 0 )
+			{
+				( void ) XEmacPs_BdRingFree( pxRing, ulSent, xBds[ 0 ].BdPtr );
+			}
+		} while( ulSent == ( uint32_t ) emacnetTX_BATCH );
+	}
+	( void ) xSemaphoreGive( xTxMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvEnableInterrupts( uint32_t ulInterrupts )
+{
+uint32_t ulLatched;
+
+	/* Status latched while the interrupts were masked describes work that has
+	already been done, so clear it rather than take an interrupt for it - but
+	still count the times the MAC found no receive buffer. */
+	ulLatched = emacnetREAD_REG( XEMACPS_ISR_OFFSET ) & ulInterrupts;
+	emacnetWRITE_REG( XEMACPS_ISR_OFFSET, ulLatched );
+
+	if( ( ulLatched & XEMACPS_IXR_RXUSED_MASK ) != 0 )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* As in XEmacPs_IntrHandler(), flush the frame the MAC could not
+			store out of its packet buffer. */
+			emacnetWRITE_REG( XEMACPS_NWCTRL_OFFSET, emacnetREAD_REG( XEMACPS_NWCTRL_OFFSET ) | XEMACPS_NWCTRL_FLUSH_DPRAM_MASK );
+			xStats.ulRxNoBuffer++;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	emacnetWRITE_REG( XEMACPS_IER_OFFSET, ulInterrupts );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRxFramePending( void )
+{
+XEmacPs_BdRing * const pxRing = &( XEmacPs_GetRxRing( &xEMACInstance ) );
+BaseType_t xReturn = pdFALSE;
+
+	if( ( pxRing->HwCnt > 0 ) && ( XEmacPs_BdIsRxNew( pxRing->HwHead ) != FALSE ) )
+	{
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessEvents( uint32_t ulEvents )
+{
+uint64_t ullStart;
+uint32_t ulBatches = 0;
+BaseType_t xMore;
+
+	if( ( ulEvents & emacnetEVENT_TX ) != 0 )
+	{
+		prvReclaimTxBuffers();
+		prvEnableInterrupts( emacnetTX_INTERRUPTS );
+
+		/* A frame sent between the reclaim and the unmask latched no
+		interrupt, so look again. */
+		prvReclaimTxBuffers();
+	}
+
+	ullStart = emacnetREAD_COUNTER();
+
+	/* Buffers released in smaller numbers than emacnetPOST_BATCH are posted
+	when the task next has nothing to do. */
+	prvPostRxBuffers( ( ( ulEvents & emacnetEVENT_TIMEOUT ) != 0 ) ? pdTRUE : pdFALSE );
+
+	if( ( ulEvents & emacnetEVENT_RX ) != 0 )
+	{
+		/* The receive interrupt stays masked until the ring is empty. */
+		do
+		{
+			xMore = pdFALSE;
+
+			if( prvReceiveFrames() == ( uint32_t ) emacnetRX_BATCH )
+			{
+				xMore = pdTRUE;
+			}
+
+			prvPostRxBuffers( pdFALSE );
+			ulBatches++;
+
+			if( xMore == pdFALSE )
+			{
+				prvEnableInterrupts( emacnetRX_INTERRUPTS );
+
+				/* Nor did a frame that arrived between the last batch and the
+				unmask. */
+				if( prvRxFramePending() != pdFALSE )
+				{
+					emacnetWRITE_REG( XEMACPS_IDR_OFFSET, emacnetRX_INTERRUPTS );
+					xMore = pdTRUE;
+				}
+			}
+			else if( ulBatches == ( uint32_t ) emacnetRX_BUDGET )
+			{
+				/* Come back to the ring, with the interrupt still masked, once
+				any other events have been handled. */
+				( void ) xTaskNotify( xNetworkTask, emacnetEVENT_RX, eSetBits );
+				xMore = pdFALSE;
+			}
+		} while( xMore != pdFALSE );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		xStats.ullRxTime += emacnetREAD_COUNTER() - ullStart;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvEMACNetworkTask( void *pvParameters )
+{
+uint32_t ulEvents;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xTaskNotifyWait( 0, emacnetALL_EVENTS, &ulEvents, emacnetIDLE_POLL_TICKS ) == pdFALSE )
+		{
+			ulEvents = emacnetEVENT_TIMEOUT;
+		}
+
+		prvProcessEvents( ulEvents );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptHandler( void *pvCallBackRef )
+{
+uint32_t ulStatus, ulEvents = 0;
+UBaseType_t uxSavedInterruptStatus;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	( void ) pvCallBackRef;
+
+	/* Status bits latch while masked, so only take the enabled ones.  A set
+	bit in the mask register disables the interrupt. */
+	ulStatus = emacnetREAD_REG( XEMACPS_ISR_OFFSET ) & ~emacnetREAD_REG( XEMACPS_IMR_OFFSET );
+	emacnetWRITE_REG( XEMACPS_ISR_OFFSET, ulStatus );
+
+	/* Mask the receive and transmit interrupts until the network task has
+	serviced the rings. */
+	if( ( ulStatus & emacnetRX_INTERRUPTS ) != 0 )
+	{
+		emacnetWRITE_REG( XEMACPS_IDR_OFFSET, emacnetRX_INTERRUPTS );
+		emacnetWRITE_REG( XEMACPS_RXSR_OFFSET, XEMACPS_RXSR_FRAMERX_MASK | XEMACPS_RXSR_BUFFNA_MASK );
+		ulEvents |= emacnetEVENT_RX;
+	}
+
+	if( ( ulStatus & emacnetTX_INTERRUPTS ) != 0 )
+	{
+		emacnetWRITE_REG( XEMACPS_IDR_OFFSET, emacnetTX_INTERRUPTS );
+		emacnetWRITE_REG( XEMACPS_TXSR_OFFSET, XEMACPS_TXSR_TXCOMPL_MASK | XEMACPS_TXSR_USEDREAD_MASK );
+		ulEvents |= emacnetEVENT_TX;
+	}
+
+	if( ( ulStatus & emacnetERROR_INTERRUPTS ) != 0 )
+	{
+		emacnetWRITE_REG( XEMACPS_RXSR_OFFSET, XEMACPS_RXSR_HRESPNOK_MASK | XEMACPS_RXSR_RXOVR_MASK );
+		emacnetWRITE_REG( XEMACPS_TXSR_OFFSET, XEMACPS_TXSR_ERROR_MASK );
+	}
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		if( ( ulStatus & XEMACPS_IXR_RXUSED_MASK ) != 0 )
+		{
+			/* As in XEmacPs_IntrHandler(), flush the frame the MAC could not
+			store out of its packet buffer. */
+			emacnetWRITE_REG( XEMACPS_NWCTRL_OFFSET, emacnetREAD_REG( XEMACPS_NWCTRL_OFFSET ) | XEMACPS_NWCTRL_FLUSH_DPRAM_MASK );
+			xStats.ulRxNoBuffer++;
+		}
+
+		if( ( ulEvents & emacnetEVENT_RX ) != 0 )
+		{
+			xStats.ulRxInterrupts++;
+		}
+
+		if( ( ulEvents & emacnetEVENT_TX ) != 0 )
+		{
+			xStats.ulTxInterrupts++;
+		}
+
+		if( ( ulStatus & emacnetERROR_INTERRUPTS ) != 0 )
+		{
+			xStats.ulErrorInterrupts++;
+		}
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( ulEvents != 0 )
+	{
+		( void ) xTaskNotifyFromISR( xNetworkTask, ulEvents, eSetBits, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* emacnetENABLE */
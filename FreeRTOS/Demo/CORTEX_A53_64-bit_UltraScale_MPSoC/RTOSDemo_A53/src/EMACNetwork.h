@@ -0,0 +1,137 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef EMAC_NETWORK_H
+#define EMAC_NETWORK_H
+
+/*
+ * A zero copy frame interface to the Ethernet MAC (GEM), built on the emacps
+ * driver's buffer descriptor rings.  Received frames are handed to tasks as
+ * pointers to the buffers the MAC wrote them into, and frames are transmitted
+ * from the buffers tasks wrote them into.  See EMACNetwork.c.
+ */
+
+/* Set to 1 in FreeRTOSConfig.h to build the interface.  Its descriptors take a
+2MB block of memory, so it is not built by default. */
+#ifndef emacnetENABLE
+	#define emacnetENABLE				0
+#endif
+
+/* The size of each receive and transmit buffer, in bytes.  Must match the
+receive buffer size the emacps driver programs into the MAC (1536 bytes), and
+be a multiple of the cache line size.  A frame must fit in one buffer. */
+#define emacnetBUFFER_SIZE				1536
+
+/* The number of receive buffers, all of which are posted to the receive
+descriptor ring while no task holds them. */
+#ifndef emacnetRX_BUFFERS
+	#define emacnetRX_BUFFERS			64
+#endif
+
+/* The number of transmit buffers, which is also the number of transmit
+descriptors. */
+#ifndef emacnetTX_BUFFERS
+	#define emacnetTX_BUFFERS			32
+#endif
+
+/* A received frame.  pucData points into a receive buffer that belongs to the
+task that received the frame until it passes it back with
+vEMACNetworkReleaseRxBuffer(). */
+typedef struct EMAC_FRAME
+{
+	uint8_t *pucData;
+	uint32_t ulLength;				/* Bytes, excluding the FCS. */
+} EMACFrame_t;
+
+/* Counters maintained by the interface.  Times are in generic timer (CNTPCT_EL0)
+counts, or nanoseconds in host builds. */
+typedef struct EMAC_NETWORK_STATS
+{
+	uint32_t ulRxFrames;			/* Frames passed to the receive queue. */
+	uint32_t ulRxQueueFull;			/* Frames dropped because the receive queue was full. */
+	uint32_t ulRxBadFrames;			/* Frames dropped because they did not fit in one buffer. */
+	uint32_t ulRxNoBuffer;			/* Times the MAC found no receive buffer posted, and so dropped a frame. */
+	uint32_t ulRxInterrupts;		/* Interrupts that started a pass over the receive ring. */
+	uint32_t ulRxPolls;				/* Batches of descriptors taken from the receive ring. */
+	uint32_t ulRxPostBatches;		/* Batches of buffers posted to the receive ring. */
+	uint32_t ulRxBuffersPosted;		/* Buffers posted to the receive ring. */
+	uint32_t ulTxFrames;			/* Frames passed to the MAC. */
+	uint32_t ulTxInterrupts;		/* Interrupts that started a pass over the transmit ring. */
+	uint32_t ulErrorInterrupts;		/* Interrupts that reported a DMA or overrun error. */
+	uint64_t ullRxTime;				/* Time spent taking frames from the receive ring and reposting buffers. */
+} EMACNetworkStats_t;
+
+/*
+ * Initialise the MAC with the MAC address pucMACAddress, post every receive
+ * buffer, and start the task that services the descriptor rings at priority
+ * uxPriority.  If xLoopback is pdTRUE the MAC's local loopback is enabled, so
+ * every transmitted frame is received again without a PHY or cable.  Must be
+ * called once, from main() or a task.  Returns pdPASS if the interface was
+ * started.
+ */
+BaseType_t xEMACNetworkInit( const uint8_t *pucMACAddress, BaseType_t xLoopback, UBaseType_t uxPriority );
+
+/*
+ * Wait up to xTicksToWait ticks for a received frame.  The frame's buffer
+ * must be passed back to vEMACNetworkReleaseRxBuffer() once the calling task
+ * has finished with it - until then it is not available to the MAC.  Returns
+ * pdPASS if *pxFrame was filled in.
+ */
+BaseType_t xEMACNetworkReceive( EMACFrame_t *pxFrame, TickType_t xTicksToWait );
+
+/*
+ * Return a receive buffer, so it can be posted to the MAC again.  Buffers are
+ * posted in batches - see emacnetPOST_BATCH in EMACNetwork.c.
+ */
+void vEMACNetworkReleaseRxBuffer( uint8_t *pucBuffer );
+
+/*
+ * Wait up to xTicksToWait ticks for a free transmit buffer of
+ * emacnetBUFFER_SIZE bytes.  Returns NULL if none became free.
+ */
+uint8_t *pucEMACNetworkGetTxBuffer( TickType_t xTicksToWait );
+
+/*
+ * Transmit the xLength byte frame, excluding the FCS, held in the transmit
+ * buffer pucBuffer.  The buffer belongs to the interface from the time of the
+ * call, and is freed once the MAC has sent it.  Returns pdPASS if the frame
+ * was queued for transmission.
+ */
+BaseType_t xEMACNetworkSend( uint8_t *pucBuffer, size_t xLength );
+
+/*
+ * Return a transmit buffer obtained from pucEMACNetworkGetTxBuffer() without
+ * sending it.
+ */
+void vEMACNetworkReleaseTxBuffer( uint8_t *pucBuffer );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vEMACNetworkGetStats( EMACNetworkStats_t *pxStats );
+
+#endif /* EMAC_NETWORK_H */
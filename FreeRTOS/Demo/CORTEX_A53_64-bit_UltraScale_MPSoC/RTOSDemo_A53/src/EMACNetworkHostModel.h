@@ -0,0 +1,293 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef EMAC_NETWORK_HOST_MODEL_H
+#define EMAC_NETWORK_HOST_MODEL_H
+
+/*
+ * A software model of the parts of the GEM used by EMACNetwork.c, used in
+ * place of the hardware when EMACNetwork.c is built on a host with
+ * emacnetUSE_HOST_MODEL set to 1.  The model owns the descriptor rings the
+ * same way the MAC does: it writes received frames into the buffers of the
+ * receive descriptors whose used ("new") bit is clear, then sets the bit, and
+ * sends the frames held by the transmit descriptors whose used bit is clear,
+ * then sets the bit, following the wrap bits back to the start of each ring.
+ * Like the hardware, the interrupt status bits latch whether or not they are
+ * masked, a bit set in the interrupt mask register disables that interrupt,
+ * and the interrupt is level sensitive.  The register offsets, status bits
+ * and descriptor layout are those in xemacps_hw.h and xemacps_bd.h, which
+ * must be built with XEMACPS_BD_ADDR64 defined so descriptors hold 64-bit
+ * addresses, as HostTest/EMACNetworkTest.c is.
+ *
+ * Nothing arrives or leaves until a host harness calls
+ * bHostMACModelReceive() or ulHostMACModelTransmit(), so the harness decides
+ * when frames arrive relative to the tasks.  With the local loopback bit set
+ * in the network control register each transmitted frame is received again,
+ * as on the hardware.  The harness calls bHostMACModelRun() wherever it wants
+ * the interrupt to be taken.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "xemacps_hw.h"
+#include "xemacps_bd.h"
+
+typedef struct HostMACModel
+{
+	uint32_t ulNetworkControl;
+	uint32_t ulIMR;					/* Set through IDR, cleared through IER. */
+	uint32_t ulISR;					/* Latched status, cleared by writing 1s. */
+	uint32_t ulRxStatus;
+	uint32_t ulTxStatus;
+	bool bTxGo;						/* Set by writing the start transmit bit. */
+	XEmacPs_Bd *pxRxBase, *pxRxNext;
+	XEmacPs_Bd *pxTxBase, *pxTxNext;
+	uint32_t ulFramesReceived;		/* Frames written to receive buffers. */
+	uint32_t ulFramesDropped;		/* Frames dropped as no receive buffer was posted. */
+	uint32_t ulFramesSent;
+	const uint8_t *pucLastSent;		/* The buffer holding the last frame sent. */
+	uint32_t ulLastSentLength;
+	void ( *pxHandler )( void *pvCallBackRef );
+} HostMACModel_t;
+
+extern HostMACModel_t xHostMACModel;
+
+static inline uint32_t ulHostMACModelRead( uint32_t ulOffset )
+{
+uint32_t ulValue = 0;
+
+	if( ulOffset == XEMACPS_NWCTRL_OFFSET )
+	{
+		ulValue = xHostMACModel.ulNetworkControl;
+	}
+	else if( ulOffset == XEMACPS_IMR_OFFSET )
+	{
+		ulValue = xHostMACModel.ulIMR;
+	}
+	else if( ulOffset == XEMACPS_ISR_OFFSET )
+	{
+		ulValue = xHostMACModel.ulISR;
+	}
+	else if( ulOffset == XEMACPS_RXSR_OFFSET )
+	{
+		ulValue = xHostMACModel.ulRxStatus;
+	}
+	else if( ulOffset == XEMACPS_TXSR_OFFSET )
+	{
+		ulValue = xHostMACModel.ulTxStatus;
+	}
+
+	return ulValue;
+}
+
+static inline void vHostMACModelWrite( uint32_t ulOffset, uint32_t ulValue )
+{
+	if( ulOffset == XEMACPS_NWCTRL_OFFSET )
+	{
+		/* The start transmit and flush bits are actions, not state. */
+		if( ( ulValue & XEMACPS_NWCTRL_STARTTX_MASK ) != 0 )
+		{
+			xHostMACModel.bTxGo = true;
+		}
+
+		xHostMACModel.ulNetworkControl = ulValue & ~( XEMACPS_NWCTRL_STARTTX_MASK | XEMACPS_NWCTRL_FLUSH_DPRAM_MASK );
+	}
+	else if( ulOffset == XEMACPS_IER_OFFSET )
+	{
+		xHostMACModel.ulIMR &= ~ulValue;
+	}
+	else if( ulOffset == XEMACPS_IDR_OFFSET )
+	{
+		xHostMACModel.ulIMR |= ( ulValue & XEMACPS_IXR_ALL_MASK );
+	}
+	else if( ulOffset == XEMACPS_ISR_OFFSET )
+	{
+		xHostMACModel.ulISR &= ~ulValue;
+	}
+	else if( ulOffset == XEMACPS_RXSR_OFFSET )
+	{
+		xHostMACModel.ulRxStatus &= ~ulValue;
+	}
+	else if( ulOffset == XEMACPS_TXSR_OFFSET )
+	{
+		xHostMACModel.ulTxStatus &= ~ulValue;
+	}
+}
+
+/* The buffer address held in a descriptor, without the receive wrap and new
+bits. */
+static inline uint8_t *pucHostMACModelBufferAddress( XEmacPs_Bd *pxBd, uint32_t ulLowMask )
+{
+UINTPTR uxAddress;
+
+	uxAddress = ( UINTPTR ) XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_HI_OFFSET );
+	uxAddress = ( uxAddress << 32U ) | ( UINTPTR ) ( XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_OFFSET ) & ulLowMask );
+
+	return ( uint8_t * ) uxAddress;
+}
+
+/* Called with the ring base addresses the MAC would be given through the queue
+base registers.  Leaves every interrupt masked, as after a reset. */
+static inline void vHostMACModelInit( XEmacPs_Bd *pxRxBase, XEmacPs_Bd *pxTxBase, void ( *pxHandler )( void *pvCallBackRef ) )
+{
+	memset( &xHostMACModel, 0x00, sizeof( xHostMACModel ) );
+	xHostMACModel.pxRxBase = pxRxBase;
+	xHostMACModel.pxRxNext = pxRxBase;
+	xHostMACModel.pxTxBase = pxTxBase;
+	xHostMACModel.pxTxNext = pxTxBase;
+	xHostMACModel.ulIMR = XEMACPS_IXR_ALL_MASK;
+	xHostMACModel.pxHandler = pxHandler;
+}
+
+/* Receive one frame from the wire.  Returns false if the receiver is disabled,
+or if the next receive descriptor's buffer was not posted, in which case the
+frame is dropped and the buffer not available status is latched. */
+static inline bool bHostMACModelReceive( const uint8_t *pucFrame, uint32_t ulLength )
+{
+XEmacPs_Bd *pxBd = xHostMACModel.pxRxNext;
+uint32_t ulAddress;
+bool bReceived = false;
+
+	if( ( xHostMACModel.ulNetworkControl & XEMACPS_NWCTRL_RXEN_MASK ) != 0 )
+	{
+		ulAddress = XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_OFFSET );
+
+		if( ( ulAddress & XEMACPS_RXBUF_NEW_MASK ) != 0 )
+		{
+			xHostMACModel.ulISR |= XEMACPS_IXR_RXUSED_MASK;
+			xHostMACModel.ulRxStatus |= XEMACPS_RXSR_BUFFNA_MASK;
+			xHostMACModel.ulFramesDropped++;
+		}
+		else
+		{
+			/* The model only receives frames that fit one buffer. */
+			configASSERT( ulLength <= XEMACPS_RX_BUF_SIZE );
+
+			memcpy( pucHostMACModelBufferAddress( pxBd, XEMACPS_RXBUF_ADD_MASK ), pucFrame, ulLength );
+			XEmacPs_BdWrite( pxBd, XEMACPS_BD_STAT_OFFSET, XEMACPS_RXBUF_SOF_MASK | XEMACPS_RXBUF_EOF_MASK | ulLength );
+			XEmacPs_BdWrite( pxBd, XEMACPS_BD_ADDR_OFFSET, ulAddress | XEMACPS_RXBUF_NEW_MASK );
+
+			if( ( ulAddress & XEMACPS_RXBUF_WRAP_MASK ) != 0 )
+			{
+				xHostMACModel.pxRxNext = xHostMACModel.pxRxBase;
+			}
+			else
+			{
+				xHostMACModel.pxRxNext = pxBd + 1;
+			}
+
+			xHostMACModel.ulISR |= XEMACPS_IXR_FRAMERX_MASK;
+			xHostMACModel.ulRxStatus |= XEMACPS_RXSR_FRAMERX_MASK;
+			xHostMACModel.ulFramesReceived++;
+			bReceived = true;
+		}
+	}
+
+	return bReceived;
+}
+
+/* Send up to ulMaxFrames frames, if transmission has been started.  Each frame
+must be held in one descriptor.  Returns the number of frames sent. */
+static inline uint32_t ulHostMACModelTransmit( uint32_t ulMaxFrames )
+{
+XEmacPs_Bd *pxBd;
+uint32_t ulStatus, ulSent = 0;
+
+	while( ( xHostMACModel.bTxGo != false ) && ( ulSent < ulMaxFrames ) )
+	{
+		pxBd = xHostMACModel.pxTxNext;
+		ulStatus = XEmacPs_BdRead( pxBd, XEMACPS_BD_STAT_OFFSET );
+
+		if( ( ulStatus & XEMACPS_TXBUF_USED_MASK ) != 0 )
+		{
+			/* Transmission stops at the first descriptor the CPU has not
+			handed over. */
+			xHostMACModel.bTxGo = false;
+			xHostMACModel.ulISR |= XEMACPS_IXR_TXUSED_MASK;
+			xHostMACModel.ulTxStatus |= XEMACPS_TXSR_USEDREAD_MASK;
+		}
+		else
+		{
+			configASSERT( ( ulStatus & XEMACPS_TXBUF_LAST_MASK ) != 0 );
+
+			xHostMACModel.pucLastSent = pucHostMACModelBufferAddress( pxBd, 0xFFFFFFFFUL );
+			xHostMACModel.ulLastSentLength = ulStatus & XEMACPS_TXBUF_LEN_MASK;
+			xHostMACModel.ulFramesSent++;
+			ulSent++;
+
+			if( ( xHostMACModel.ulNetworkControl & XEMACPS_NWCTRL_LOOPEN_MASK ) != 0 )
+			{
+				( void ) bHostMACModelReceive( xHostMACModel.pucLastSent, xHostMACModel.ulLastSentLength );
+			}
+
+			XEmacPs_BdWrite( pxBd, XEMACPS_BD_STAT_OFFSET, ulStatus | XEMACPS_TXBUF_USED_MASK );
+
+			if( ( ulStatus & XEMACPS_TXBUF_WRAP_MASK ) != 0 )
+			{
+				xHostMACModel.pxTxNext = xHostMACModel.pxTxBase;
+			}
+			else
+			{
+				xHostMACModel.pxTxNext = pxBd + 1;
+			}
+
+			xHostMACModel.ulISR |= XEMACPS_IXR_TXCOMPL_MASK;
+			xHostMACModel.ulTxStatus |= XEMACPS_TXSR_TXCOMPL_MASK;
+		}
+	}
+
+	return ulSent;
+}
+
+/* Stands in for CNTPCT_EL0, in nanoseconds. */
+static inline uint64_t ullHostMACModelReadCounter( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+
+/* Take the MAC interrupt if it is pending.  Returns true if the handler ran. */
+static inline bool bHostMACModelRun( void )
+{
+bool bHandled = false;
+
+	if( ( xHostMACModel.pxHandler != NULL ) && ( ( xHostMACModel.ulISR & ~xHostMACModel.ulIMR ) != 0 ) )
+	{
+		xHostMACModel.pxHandler( NULL );
+		bHandled = true;
+	}
+
+	return bHandled;
+}
+
+#endif /* EMAC_NETWORK_HOST_MODEL_H */
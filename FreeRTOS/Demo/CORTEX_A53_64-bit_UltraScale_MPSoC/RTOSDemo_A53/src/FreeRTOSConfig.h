@@ -69,7 +69,12 @@
 
 #define configCPU_CLOCK_HZ						100000000UL
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
-#define configUSE_TICKLESS_IDLE					0
+/* Set to 2 to use the tickless idle implementation in FreeRTOS_tick_config.c,
+which needs tickconfigUSE_GENERIC_TIMER to be 1.  The blinky demo reports how
+often the core wakes. */
+#ifndef configUSE_TICKLESS_IDLE
+	#define configUSE_TICKLESS_IDLE				0
+#endif
 #define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
 #define configPERIPHERAL_CLOCK_HZ  				( 33333000UL )
 #define configUSE_PREEMPTION					1
@@ -90,6 +95,13 @@
 #define configUSE_COUNTING_SEMAPHORES			1
 #define configUSE_QUEUE_SETS					1
 
+/* The A53 port is single core, so the scheduler only runs on core 0.  The
+other cores are left parked by boot.S.  Running the demo on all four cores
+needs an SMP version of the port that calls configSTART_SECONDARY_CORES() and
+configYIELD_CORE(), so the platform can release cores 1-3 and send them yield
+SGIs.  Until such a port is available no four core build is provided. */
+#define configNUM_CORES							1
+
 /* This demo creates RTOS objects using both static and dynamic allocation. */
 #define configSUPPORT_STATIC_ALLOCATION			1
 #define configSUPPORT_DYNAMIC_ALLOCATION		1 /* Defaults to 1 anyway. */
@@ -156,6 +168,25 @@ positive errors being reported considering the priority of other tasks in the
 system. */
 #define recmuCONTROLLING_TASK_PRIORITY ( configMAX_PRIORITIES - 2 )
 
+/* The GDMA used by the DMA copy service (DMACopy.c) is not cache coherent, so
+the part of each transfer made by the DMA engine must start and end on a cache
+line boundary. */
+#define dmacopyPORT_ALIGNMENT			64U
+
+/* Set to 1 to have the interrupt dispatcher (IRQDispatch.c) count each
+interrupt, and time its handler, per interrupt ID.  The full demo's check task
+then prints the statistics. */
+#define irqdispatchCOLLECT_STATS		0
+
+/* The zero copy Ethernet interface (EMACNetwork.c) and the emacps descriptor
+ring benchmark (Full_Demo/EMACBdRingBenchmark.c) each place their descriptors
+in a 2MB block of memory mapped non-cacheable, so each is only built when set
+to 1 here.  Setting emacnetENABLE to 1 also builds the EMAC loopback benchmark
+(Full_Demo/EMACNetworkBenchmark.c).  The full demo starts each benchmark that
+is built. */
+#define emacnetENABLE					0
+#define bdbenchENABLE					0
+
 /****** Hardware specific settings. *******************************************/
 
 /*
@@ -171,6 +202,16 @@ void vConfigureTickInterrupt( void );
 void vClearTickInterrupt( void );
 #define configCLEAR_TICK_INTERRUPT() vClearTickInterrupt()
 
+/* Set to 1 to generate the tick from the core's generic timer (the EL1
+physical timer), or to 0 to generate it from TTC 3 as the original demo did. */
+#define tickconfigUSE_GENERIC_TIMER				1
+
+#if( configUSE_TICKLESS_IDLE == 2 )
+	/* TickType_t is 64 bits on this port. */
+	void vApplicationSleep( uint64_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vApplicationSleep( xExpectedIdleTime )
+#endif
+
 /* The following constant describe the hardware, and are correct for the
 Zynq MPU. */
 #define configINTERRUPT_CONTROLLER_BASE_ADDRESS 		( XPAR_PSU_ACPU_GIC_DIST_BASEADDR )
@@ -25,102 +25,343 @@
  * 1 tab == 4 spaces!
  */
 
+/*
+ * Provides the tick interrupt, and optionally tickless idle, for the port.
+ * configSETUP_TICK_INTERRUPT() and configCLEAR_TICK_INTERRUPT() in
+ * FreeRTOSConfig.h map onto vConfigureTickInterrupt() and vClearTickInterrupt().
+ *
+ * When tickconfigUSE_GENERIC_TIMER is 1 the tick is generated by the core's
+ * EL1 physical timer (CNTP_*_EL0).  Each core has its own generic timer, and
+ * its interrupt is a private peripheral interrupt, so no shared peripheral is
+ * needed and the tick is not routed through the distributor's SPI targets.
+ * The timer counts CNTPCT_EL0, which runs at CNTFRQ_EL0 (set by boot.S).  The compare value is
+ * advanced by exactly one tick period on each tick, so ticks never drift, and
+ * clearing the interrupt is a single system register write rather than the
+ * TTC's MMIO read and write.
+ *
+ * When tickconfigUSE_GENERIC_TIMER is 0 the tick is generated by TTC 3, as in
+ * the original demo, which allows the two to be compared.
+ *
+ * When configUSE_TICKLESS_IDLE is 2, vApplicationSleep() stops the tick while
+ * the core is idle.  It sets the compare value to the tick at which the next
+ * task unblocks, waits for an interrupt, then steps the tick count by the
+ * whole tick periods that passed and puts the compare value back on the next
+ * tick boundary.
+ *
+ * vGetTickStats() returns the number of tick interrupts and sleeps, from which
+ * the blinky demo calculates the core's wakeups per second.  The time spent in
+ * the tick handler is measured by the interrupt dispatcher (IRQDispatch.c)
+ * when irqdispatchCOLLECT_STATS is 1 - see ulGetTickInterruptID().
+ */
+
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* Demo includes. */
+#include "IRQDispatch.h"
+#include "FreeRTOS_tick_config.h"
+
 /* Xilinx includes. */
 #include "platform.h"
 #include "xttcps.h"
 #include "xscugic.h"
 
-/* Timer used to generate the tick interrupt. */
-static XTtcPs xRTOSTickTimerInstance;
+#ifndef tickconfigUSE_GENERIC_TIMER
+	#define tickconfigUSE_GENERIC_TIMER		1
+#endif
+
+#if( ( configUSE_TICKLESS_IDLE == 2 ) && ( tickconfigUSE_GENERIC_TIMER == 0 ) )
+	#error Tickless idle is only implemented for the generic timer tick.
+#endif
+
+/* The EL1 physical timer's interrupt, PPI 14. */
+#define tickconfigGENERIC_TIMER_INTERRUPT_ID	( 30UL )
+
+/* CNTP_CTL_EL0 bits.  Clearing IMASK unmasks the timer's interrupt. */
+#define tickconfigTIMER_ENABLE					( 1ULL )
+
+/* Limits the counter arithmetic in vApplicationSleep() to 64 bits. */
+#define tickconfigMAX_SUPPRESSED_TICKS			( ( TickType_t ) 0xFFFFFFFFUL )
+
+/*-----------------------------------------------------------*/
+
+#if( tickconfigUSE_GENERIC_TIMER == 1 )
+
+	/*
+	 * Access the generic timer of the calling core.
+	 */
+	static inline uint64_t prvReadCounter( void );
+	static inline uint64_t prvReadCompareValue( void );
+	static inline void prvWriteCompareValue( uint64_t ullCompareValue );
+
+	/* The number of CNTPCT_EL0 counts in a tick period. */
+	static uint64_t ullCountsPerTick = 0;
+
+#else
+
+	/* Timer used to generate the tick interrupt. */
+	static XTtcPs xRTOSTickTimerInstance;
+
+#endif /* tickconfigUSE_GENERIC_TIMER */
+
+/* Only updated by the tick interrupt and vApplicationSleep(). */
+static TickStats_t xTickStats = { 0 };
 
 /*-----------------------------------------------------------*/
 
 void vConfigureTickInterrupt( void )
 {
-BaseType_t xStatus;
-XTtcPs_Config *pxTimerConfiguration;
-XInterval usInterval;
-uint8_t ucPrescale;
-const uint8_t ucLevelSensitive = 1;
 extern XScuGic xInterruptController;
+const uint8_t ucLevelSensitive = 1;
+BaseType_t xStatus;
 
-	pxTimerConfiguration = XTtcPs_LookupConfig( XPAR_XTTCPS_3_DEVICE_ID );
+	#if( tickconfigUSE_GENERIC_TIMER == 1 )
+	{
+	uint64_t ullFrequency;
 
-	/* Initialise the device. */
-	xStatus = XTtcPs_CfgInitialize( &xRTOSTickTimerInstance, pxTimerConfiguration, pxTimerConfiguration->BaseAddress );
+		__asm volatile( "MRS %0, CNTFRQ_EL0" : "=r" ( ullFrequency ) );
+		ullCountsPerTick = ullFrequency / configTICK_RATE_HZ;
+		configASSERT( ullCountsPerTick > 0ULL );
 
-	if( xStatus != XST_SUCCESS )
-	{
-		/* Not sure how to do this before XTtcPs_CfgInitialize is called as
-		*xRTOSTickTimerInstance is set within XTtcPs_CfgInitialize(). */
-		XTtcPs_Stop( &xRTOSTickTimerInstance );
-		xStatus = XTtcPs_CfgInitialize( &xRTOSTickTimerInstance, pxTimerConfiguration, pxTimerConfiguration->BaseAddress );
+		/* The priority must be the lowest possible. */
+		XScuGic_SetPriorityTriggerType( &xInterruptController, tickconfigGENERIC_TIMER_INTERRUPT_ID, portLOWEST_USABLE_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
+
+		/* Connect to the interrupt controller. */
+		xStatus = XScuGic_Connect( &xInterruptController, tickconfigGENERIC_TIMER_INTERRUPT_ID, ( Xil_ExceptionHandler ) FreeRTOS_Tick_Handler, NULL );
 		configASSERT( xStatus == XST_SUCCESS );
+		( void ) xStatus;
+
+		/* Enable the interrupt in the GIC. */
+		XScuGic_Enable( &xInterruptController, tickconfigGENERIC_TIMER_INTERRUPT_ID );
+
+		/* Start the timer, with the first tick one period from now. */
+		prvWriteCompareValue( prvReadCounter() + ullCountsPerTick );
+		__asm volatile( "MSR CNTP_CTL_EL0, %0\n ISB SY" :: "r" ( tickconfigTIMER_ENABLE ) : "memory" );
 	}
+	#else
+	{
+	XTtcPs_Config *pxTimerConfiguration;
+	XInterval usInterval;
+	uint8_t ucPrescale;
+
+		pxTimerConfiguration = XTtcPs_LookupConfig( XPAR_XTTCPS_3_DEVICE_ID );
 
-	/* Set the options. */
-	XTtcPs_SetOptions( &xRTOSTickTimerInstance, ( XTTCPS_OPTION_INTERVAL_MODE | XTTCPS_OPTION_WAVE_DISABLE ) );
+		/* Initialise the device. */
+		xStatus = XTtcPs_CfgInitialize( &xRTOSTickTimerInstance, pxTimerConfiguration, pxTimerConfiguration->BaseAddress );
+
+		if( xStatus != XST_SUCCESS )
+		{
+			/* Not sure how to do this before XTtcPs_CfgInitialize is called as
+			*xRTOSTickTimerInstance is set within XTtcPs_CfgInitialize(). */
+			XTtcPs_Stop( &xRTOSTickTimerInstance );
+			xStatus = XTtcPs_CfgInitialize( &xRTOSTickTimerInstance, pxTimerConfiguration, pxTimerConfiguration->BaseAddress );
+			configASSERT( xStatus == XST_SUCCESS );
+		}
+
+		/* Set the options. */
+		XTtcPs_SetOptions( &xRTOSTickTimerInstance, ( XTTCPS_OPTION_INTERVAL_MODE | XTTCPS_OPTION_WAVE_DISABLE ) );
 
-	/* Derive values from the tick rate. */
-	XTtcPs_CalcIntervalFromFreq( &xRTOSTickTimerInstance, configTICK_RATE_HZ, &( usInterval ), &( ucPrescale ) );
+		/* Derive values from the tick rate. */
+		XTtcPs_CalcIntervalFromFreq( &xRTOSTickTimerInstance, configTICK_RATE_HZ, &( usInterval ), &( ucPrescale ) );
 
-	/* Set the interval and prescale. */
-	XTtcPs_SetInterval( &xRTOSTickTimerInstance, usInterval );
-	XTtcPs_SetPrescaler( &xRTOSTickTimerInstance, ucPrescale );
+		/* Set the interval and prescale. */
+		XTtcPs_SetInterval( &xRTOSTickTimerInstance, usInterval );
+		XTtcPs_SetPrescaler( &xRTOSTickTimerInstance, ucPrescale );
 
-	/* The priority must be the lowest possible. */
-	XScuGic_SetPriorityTriggerType( &xInterruptController, XPAR_XTTCPS_3_INTR, portLOWEST_USABLE_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
+		/* The priority must be the lowest possible. */
+		XScuGic_SetPriorityTriggerType( &xInterruptController, XPAR_XTTCPS_3_INTR, portLOWEST_USABLE_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
 
-	/* Connect to the interrupt controller. */
-	xStatus = XScuGic_Connect( &xInterruptController, XPAR_XTTCPS_3_INTR, (Xil_ExceptionHandler) FreeRTOS_Tick_Handler, ( void * ) &xRTOSTickTimerInstance );
-	configASSERT( xStatus == XST_SUCCESS);
+		/* Connect to the interrupt controller. */
+		xStatus = XScuGic_Connect( &xInterruptController, XPAR_XTTCPS_3_INTR, (Xil_ExceptionHandler) FreeRTOS_Tick_Handler, ( void * ) &xRTOSTickTimerInstance );
+		configASSERT( xStatus == XST_SUCCESS);
 
-	/* Enable the interrupt in the GIC. */
-	XScuGic_Enable( &xInterruptController, XPAR_XTTCPS_3_INTR );
+		/* Enable the interrupt in the GIC. */
+		XScuGic_Enable( &xInterruptController, XPAR_XTTCPS_3_INTR );
 
-	/* Enable the interrupts in the timer. */
-	XTtcPs_EnableInterrupts( &xRTOSTickTimerInstance, XTTCPS_IXR_INTERVAL_MASK );
+		/* Enable the interrupts in the timer. */
+		XTtcPs_EnableInterrupts( &xRTOSTickTimerInstance, XTTCPS_IXR_INTERVAL_MASK );
+
+		/* Start the timer. */
+		XTtcPs_Start( &xRTOSTickTimerInstance );
+
+	}
+	#endif /* tickconfigUSE_GENERIC_TIMER */
 
-	/* Start the timer. */
-	XTtcPs_Start( &xRTOSTickTimerInstance );
+	/* The handlers installed by the demo before the scheduler was started are
+	now in place, and interrupts are still masked, so build the dispatch table
+	used by vApplicationIRQHandler(). */
+	vIRQDispatchInit();
 }
 /*-----------------------------------------------------------*/
 
 void vClearTickInterrupt( void )
 {
-volatile uint32_t ulInterruptStatus;
+	#if( tickconfigUSE_GENERIC_TIMER == 1 )
+	{
+		/* Moving the compare value on to the next tick clears the interrupt.
+		It is advanced from the tick that was due, not from now, so latency in
+		handling the interrupt does not make the tick drift.  The ISB ensures
+		the interrupt is cleared before the GIC is told it has been handled. */
+		prvWriteCompareValue( prvReadCompareValue() + ullCountsPerTick );
+		__asm volatile( "ISB SY" ::: "memory" );
+	}
+	#else
+	{
+	volatile uint32_t ulInterruptStatus;
+
+		/* Read the interrupt status, then write it back to clear the
+		interrupt. */
+		ulInterruptStatus = XTtcPs_GetInterruptStatus( &xRTOSTickTimerInstance );
+		XTtcPs_ClearInterruptStatus( &xRTOSTickTimerInstance, ulInterruptStatus );
+		__asm volatile( "DSB SY" );
+		__asm volatile( "ISB SY" );
+	}
+	#endif /* tickconfigUSE_GENERIC_TIMER */
 
-	/* Read the interrupt status, then write it back to clear the interrupt. */
-	ulInterruptStatus = XTtcPs_GetInterruptStatus( &xRTOSTickTimerInstance );
-	XTtcPs_ClearInterruptStatus( &xRTOSTickTimerInstance, ulInterruptStatus );
-	__asm volatile( "DSB SY" );
-	__asm volatile( "ISB SY" );
+	xTickStats.ulTickInterrupts++;
 }
 /*-----------------------------------------------------------*/
 
-void vApplicationIRQHandler( uint32_t ulICCIAR )
+uint32_t ulGetTickInterruptID( void )
 {
-extern const XScuGic_Config XScuGic_ConfigTable[];
-static const XScuGic_VectorTableEntry *pxVectorTable = XScuGic_ConfigTable[ XPAR_SCUGIC_SINGLE_DEVICE_ID ].HandlerTable;
-uint32_t ulInterruptID;
-const XScuGic_VectorTableEntry *pxVectorEntry;
+	#if( tickconfigUSE_GENERIC_TIMER == 1 )
+	{
+		return tickconfigGENERIC_TIMER_INTERRUPT_ID;
+	}
+	#else
+	{
+		return XPAR_XTTCPS_3_INTR;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
 
-	/* Interrupts cannot be re-enabled until the source of the interrupt is
-	cleared. The ID of the interrupt is obtained by bitwise ANDing the ICCIAR
-	value with 0x3FF. */
-	ulInterruptID = ulICCIAR & 0x3FFUL;
-	if( ulInterruptID < XSCUGIC_MAX_NUM_INTR_INPUTS )
+void vGetTickStats( TickStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
 	{
-		/* Call the function installed in the array of installed handler
-		functions. */
-		pxVectorEntry = &( pxVectorTable[ ulInterruptID ] );
-		configASSERT( pxVectorEntry );
-		pxVectorEntry->Handler( pxVectorEntry->CallBackRef );
+		*pxStats = xTickStats;
 	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 2 )
+
+	void vApplicationSleep( TickType_t xExpectedIdleTime )
+	{
+	uint64_t ullDAIF, ullNextTick, ullWakeTick, ullNow, ullPeriods;
+	TickType_t xCompleteTickPeriods;
+
+		if( xExpectedIdleTime > tickconfigMAX_SUPPRESSED_TICKS )
+		{
+			xExpectedIdleTime = tickconfigMAX_SUPPRESSED_TICKS;
+		}
+
+		/* Mask IRQs in the core rather than in the GIC, as a pending
+		interrupt must still end the WFI below. */
+		__asm volatile( "MRS %0, DAIF\n MSR DAIFSET, #2\n ISB SY" : "=r" ( ullDAIF ) :: "memory" );
+
+		ullNextTick = prvReadCompareValue();
+
+		if( ( prvReadCounter() >= ullNextTick ) ||
+			( eTaskConfirmSleepModeStatus() == eAbortSleep ) )
+		{
+			/* A tick is due, or a task became ready since the idle task
+			decided to sleep. */
+			xTickStats.ulAbortedSleeps++;
+		}
+		else
+		{
+			/* The next tick is due at ullNextTick, and the tick at which a
+			task unblocks xExpectedIdleTime - 1 periods after that. */
+			ullWakeTick = ullNextTick + ( ( uint64_t ) ( xExpectedIdleTime - 1 ) * ullCountsPerTick );
+			prvWriteCompareValue( ullWakeTick );
+			__asm volatile( "ISB SY\n DSB SY\n WFI\n ISB SY" ::: "memory" );
+
+			ullNow = prvReadCounter();
+
+			if( ullNow < ullNextTick )
+			{
+				/* Woken by another interrupt before the tick that was due. */
+				xCompleteTickPeriods = 0;
+				prvWriteCompareValue( ullNextTick );
+				xTickStats.ulEarlyWakes++;
+			}
+			else
+			{
+				ullPeriods = ( ( ullNow - ullNextTick ) / ullCountsPerTick ) + 1ULL;
+
+				if( ullPeriods >= ( uint64_t ) xExpectedIdleTime )
+				{
+					/* The tick at which a task unblocks is due, so leave
+					the compare value on that tick and let the tick
+					interrupt, which is pending, process it.  The tick count
+					must not be stepped up to that tick.  If the wake was
+					late, the following tick interrupts catch up one period
+					at a time. */
+					xCompleteTickPeriods = xExpectedIdleTime - 1;
+				}
+				else
+				{
+					/* Woken by another interrupt.  Put the compare value
+					back on the next tick boundary. */
+					xCompleteTickPeriods = ( TickType_t ) ullPeriods;
+					prvWriteCompareValue( ullNextTick + ( ullPeriods * ullCountsPerTick ) );
+					xTickStats.ulEarlyWakes++;
+				}
+			}
+
+			__asm volatile( "ISB SY" ::: "memory" );
+			vTaskStepTick( xCompleteTickPeriods );
+
+			xTickStats.ulSleeps++;
+			xTickStats.ulTicksSuppressed += ( uint32_t ) xCompleteTickPeriods;
+		}
+
+		/* Take any pending interrupt. */
+		__asm volatile( "MSR DAIF, %0\n ISB SY" :: "r" ( ullDAIF ) : "memory" );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if( tickconfigUSE_GENERIC_TIMER == 1 )
+
+	static inline uint64_t prvReadCounter( void )
+	{
+	uint64_t ullCount;
+
+		/* The ISB stops the counter being read early. */
+		__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+		return ullCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	static inline uint64_t prvReadCompareValue( void )
+	{
+	uint64_t ullCompareValue;
+
+		__asm volatile( "MRS %0, CNTP_CVAL_EL0" : "=r" ( ullCompareValue ) );
+		return ullCompareValue;
+	}
+	/*-----------------------------------------------------------*/
+
+	static inline void prvWriteCompareValue( uint64_t ullCompareValue )
+	{
+		__asm volatile( "MSR CNTP_CVAL_EL0, %0" :: "r" ( ullCompareValue ) : "memory" );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* tickconfigUSE_GENERIC_TIMER */
+
+void vApplicationIRQHandler( uint32_t ulICCIAR )
+{
+	/* Interrupts cannot be re-enabled until the source of the interrupt is
+	cleared.  vIRQDispatch() obtains the ID of the interrupt from the ICCIAR
+	value and calls the handler installed for it. */
+	vIRQDispatch( ulICCIAR );
 }
 
 
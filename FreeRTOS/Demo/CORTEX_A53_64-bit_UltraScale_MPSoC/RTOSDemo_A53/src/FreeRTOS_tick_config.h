@@ -0,0 +1,56 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FREERTOS_TICK_CONFIG_H
+#define FREERTOS_TICK_CONFIG_H
+
+/*
+ * Statistics kept by the tick implementation in FreeRTOS_tick_config.c.
+ */
+
+/* Counters that are only ever incremented.  The sleep counters stay at 0 unless
+configUSE_TICKLESS_IDLE is 2. */
+typedef struct TICK_STATS
+{
+	uint32_t ulTickInterrupts;		/* Tick interrupts taken. */
+	uint32_t ulSleeps;				/* Times the core slept with the tick stopped. */
+	uint32_t ulEarlyWakes;			/* Sleeps ended by an interrupt other than the tick. */
+	uint32_t ulAbortedSleeps;		/* Times the core decided not to sleep after all. */
+	uint32_t ulTicksSuppressed;		/* Ticks accounted for by vTaskStepTick() rather than by an interrupt. */
+} TickStats_t;
+
+/*
+ * Take a snapshot of the tick statistics.
+ */
+void vGetTickStats( TickStats_t *pxStats );
+
+/*
+ * The GIC interrupt ID of the tick, for use with xIRQDispatchGetStats().
+ */
+uint32_t ulGetTickInterruptID( void );
+
+#endif /* FREERTOS_TICK_CONFIG_H */
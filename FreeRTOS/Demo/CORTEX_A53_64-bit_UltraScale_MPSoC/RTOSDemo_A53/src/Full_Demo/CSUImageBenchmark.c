@@ -0,0 +1,327 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures the cost of verifying a firmware image at boot, on the CPU and with
+ * the CSU DMA image service in CSUImage.c.
+ *
+ * For each image length the image is verified four ways: by the CPU adding up
+ * the image in place, by the CPU copying the image then adding up the copy,
+ * and by the service, both verifying the image in place and copying it.  All
+ * four calculate the same checksum.  The times for the service include the
+ * cache maintenance it does, and the time the task is blocked waiting for the
+ * job - time the CPU is free to run other tasks.  The time the task spends in
+ * xCSUImageSubmit(), which is the CPU time a job costs the requesting task
+ * beyond the few instructions the service task runs per transfer, is also
+ * recorded.
+ *
+ * Each job's progress callback checks the progress is reported in order, and
+ * each copy is compared with the image.  Before the timings are taken, a job
+ * with the wrong expected checksum checks that a mismatch is reported.
+ *
+ * The benchmark runs once, timing each case over csuimagebenchREPETITIONS
+ * runs.  Times are taken from the generic timer, which unlike the cycle
+ * counter keeps counting while the core waits for an interrupt.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Demo includes. */
+#include "CSUImage.h"
+#include "CSUImageBenchmark.h"
+
+#define csuimagebenchMAX_LENGTH			( 0x400000UL )
+#define csuimagebenchREPETITIONS		( 4UL )
+
+/* The image lengths measured. */
+static const uint32_t ulLengths[] = { 0x10000UL, 0x100000UL, csuimagebenchMAX_LENGTH };
+#define csuimagebenchNUM_LENGTHS		( sizeof( ulLengths ) / sizeof( ulLengths[ 0 ] ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmark.
+ */
+static void prvCSUImageBenchmarkTask( void *pvParameters );
+
+/*
+ * Time verifying the first ulLength bytes of the image on the CPU, copying
+ * them first if xCopy is pdTRUE.  Returns the mean time in microseconds.
+ */
+static uint32_t prvTimeCPU( uint32_t ulLength, BaseType_t xCopy );
+
+/*
+ * Time verifying the first ulLength bytes of the image with a job, copying
+ * them if xCopy is pdTRUE.  Returns the mean time in microseconds, and sets
+ * *pulSubmitTime to the mean time each call to xCSUImageSubmit() took.
+ */
+static uint32_t prvTimeJob( uint32_t ulLength, BaseType_t xCopy, uint32_t *pulSubmitTime );
+
+/*
+ * Run one job and set xErrorDetected if it does not end in state
+ * xExpectedStatus, or does not report its progress correctly.
+ */
+static void prvRunJob( CSUImageJob_t *pxJob, BaseType_t xExpectedStatus, uint64_t *pullSubmitTime );
+
+/*
+ * The progress callback used by every job.
+ */
+static void prvProgressCallback( CSUImageJob_t *pxJob, size_t xBytesDone, uint32_t ulChecksum );
+
+static uint32_t prvToMicroseconds( uint64_t ullTicks );
+
+static inline uint64_t prvReadCounter( void );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucImage[ csuimagebenchMAX_LENGTH ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+static uint8_t ucDestination[ csuimagebenchMAX_LENGTH ] __attribute__( ( aligned( csuimageALIGNMENT ) ) );
+
+/* The checksum of the image being measured. */
+static uint32_t ulImageChecksum = 0;
+
+/* The progress last reported for the running job.  Only the service task
+writes it while a job is pending. */
+static size_t xLastBytesDone = 0;
+
+/* The generic timer frequency, in Hz. */
+static uint64_t ullCounterFrequency = 0;
+
+static CSUImageBenchmarkResult_t xResults[ csuimagebenchNUM_LENGTHS ];
+
+/* Set once xResults[] is complete. */
+static volatile BaseType_t xComplete = pdFALSE;
+
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartCSUImageBenchmarkTask( UBaseType_t uxPriority )
+{
+	if( xCSUImageInit( uxPriority + ( UBaseType_t ) 1 ) == pdPASS )
+	{
+		xTaskCreate( prvCSUImageBenchmarkTask, "CSUBM", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+	}
+	else
+	{
+		xErrorDetected = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIsCSUImageBenchmarkStillPassing( void )
+{
+	return ( xErrorDetected == pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetCSUImageBenchmarkResults( const CSUImageBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xComplete != pdFALSE )
+	{
+		*ppxResults = xResults;
+		*puxNumResults = ( UBaseType_t ) csuimagebenchNUM_LENGTHS;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCSUImageBenchmarkTask( void *pvParameters )
+{
+CSUImageJob_t xJob;
+UBaseType_t uxLength;
+uint32_t ulLength, ulUnused, ul;
+uint64_t ullUnused = 0;
+
+	( void ) pvParameters;
+
+	__asm volatile( "MRS %0, CNTFRQ_EL0" : "=r" ( ullCounterFrequency ) );
+
+	for( ul = 0; ul < csuimagebenchMAX_LENGTH; ul++ )
+	{
+		ucImage[ ul ] = ( uint8_t ) ( ul ^ ( ul >> 8UL ) ^ ( ul >> 16UL ) );
+	}
+
+	/* A job whose checksum does not match is read to the end, then reported
+	as a mismatch. */
+	memset( &xJob, 0x00, sizeof( xJob ) );
+	xJob.pvImage = ucImage;
+	xJob.xLength = ( size_t ) ulLengths[ 0 ];
+	xJob.ulExpectedChecksum = ulCSUImageChecksum( ucImage, ( size_t ) ulLengths[ 0 ] ) + 1UL;
+	xJob.pxProgressCallback = prvProgressCallback;
+	prvRunJob( &xJob, csuimageSTATUS_MISMATCH, &ullUnused );
+
+	for( uxLength = 0; uxLength < csuimagebenchNUM_LENGTHS; uxLength++ )
+	{
+		ulLength = ulLengths[ uxLength ];
+		ulImageChecksum = ulCSUImageChecksum( ucImage, ( size_t ) ulLength );
+
+		xResults[ uxLength ].ulLength = ulLength;
+		xResults[ uxLength ].ulCPUVerifyTime = prvTimeCPU( ulLength, pdFALSE );
+		xResults[ uxLength ].ulCPUCopyTime = prvTimeCPU( ulLength, pdTRUE );
+		xResults[ uxLength ].ulDMAVerifyTime = prvTimeJob( ulLength, pdFALSE, &ulUnused );
+		xResults[ uxLength ].ulDMACopyTime = prvTimeJob( ulLength, pdTRUE, &( xResults[ uxLength ].ulSubmitTime ) );
+
+		/* Let lower priority tasks run between lengths. */
+		vTaskDelay( 1 );
+	}
+
+	xComplete = pdTRUE;
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeCPU( uint32_t ulLength, BaseType_t xCopy )
+{
+uint64_t ullStart, ullElapsed;
+uint32_t ulRepetition, ulChecksum;
+
+	memset( ucDestination, 0x00, ( size_t ) ulLength );
+
+	ullStart = prvReadCounter();
+
+	for( ulRepetition = 0; ulRepetition < csuimagebenchREPETITIONS; ulRepetition++ )
+	{
+		if( xCopy != pdFALSE )
+		{
+			memcpy( ucDestination, ucImage, ( size_t ) ulLength );
+			ulChecksum = ulCSUImageChecksum( ucDestination, ( size_t ) ulLength );
+		}
+		else
+		{
+			ulChecksum = ulCSUImageChecksum( ucImage, ( size_t ) ulLength );
+		}
+
+		if( ulChecksum != ulImageChecksum )
+		{
+			xErrorDetected = pdTRUE;
+		}
+	}
+
+	ullElapsed = prvReadCounter() - ullStart;
+
+	return prvToMicroseconds( ullElapsed / csuimagebenchREPETITIONS );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeJob( uint32_t ulLength, BaseType_t xCopy, uint32_t *pulSubmitTime )
+{
+CSUImageJob_t xJob;
+uint64_t ullStart, ullElapsed, ullSubmitTime = 0;
+uint32_t ulRepetition;
+
+	memset( &xJob, 0x00, sizeof( xJob ) );
+	xJob.pvImage = ucImage;
+	xJob.pvDestination = ( xCopy != pdFALSE ) ? ( void * ) ucDestination : NULL;
+	xJob.xLength = ( size_t ) ulLength;
+	xJob.ulExpectedChecksum = ulImageChecksum;
+	xJob.pxProgressCallback = prvProgressCallback;
+
+	memset( ucDestination, 0x00, ( size_t ) ulLength );
+
+	ullStart = prvReadCounter();
+
+	for( ulRepetition = 0; ulRepetition < csuimagebenchREPETITIONS; ulRepetition++ )
+	{
+		prvRunJob( &xJob, csuimageSTATUS_COMPLETE, &ullSubmitTime );
+	}
+
+	ullElapsed = prvReadCounter() - ullStart;
+
+	if( ( xCopy != pdFALSE ) && ( memcmp( ucDestination, ucImage, ( size_t ) ulLength ) != 0 ) )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	*pulSubmitTime = prvToMicroseconds( ullSubmitTime / csuimagebenchREPETITIONS );
+
+	return prvToMicroseconds( ullElapsed / csuimagebenchREPETITIONS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunJob( CSUImageJob_t *pxJob, BaseType_t xExpectedStatus, uint64_t *pullSubmitTime )
+{
+uint64_t ullSubmitStart;
+
+	xLastBytesDone = 0;
+
+	ullSubmitStart = prvReadCounter();
+
+	if( xCSUImageSubmit( pxJob, portMAX_DELAY ) != pdPASS )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	*pullSubmitTime += prvReadCounter() - ullSubmitStart;
+
+	if( ( xCSUImageWait( pxJob, portMAX_DELAY ) != xExpectedStatus ) ||
+		( xLastBytesDone != pxJob->xLength ) ||
+		( xCSUImageGetProgress( pxJob, NULL ) != pxJob->xLength ) )
+	{
+		xErrorDetected = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProgressCallback( CSUImageJob_t *pxJob, size_t xBytesDone, uint32_t ulChecksum )
+{
+	( void ) ulChecksum;
+
+	if( ( xBytesDone <= xLastBytesDone ) || ( xBytesDone > pxJob->xLength ) )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	xLastBytesDone = xBytesDone;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvToMicroseconds( uint64_t ullTicks )
+{
+	return ( uint32_t ) ( ( ullTicks * 1000000ULL ) / ullCounterFrequency );
+}
+/*-----------------------------------------------------------*/
+
+static inline uint64_t prvReadCounter( void )
+{
+uint64_t ullCount;
+
+	__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+
+	return ullCount;
+}
+/*-----------------------------------------------------------*/
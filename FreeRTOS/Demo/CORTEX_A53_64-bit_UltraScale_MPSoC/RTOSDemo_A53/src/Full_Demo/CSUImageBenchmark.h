@@ -0,0 +1,61 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef CSU_IMAGE_BENCHMARK_H
+#define CSU_IMAGE_BENCHMARK_H
+
+/* The time taken to verify, or copy and verify, an image of one length, in
+microseconds - see CSUImageBenchmark.c. */
+typedef struct CSU_IMAGE_BENCHMARK_RESULT
+{
+	uint32_t ulLength;				/* The length of the image, in bytes. */
+	uint32_t ulCPUVerifyTime;		/* ulCSUImageChecksum() of the image. */
+	uint32_t ulCPUCopyTime;			/* memcpy() of the image, then ulCSUImageChecksum() of the copy. */
+	uint32_t ulDMAVerifyTime;		/* A job that only verifies the image. */
+	uint32_t ulDMACopyTime;			/* A job that copies and verifies the image. */
+	uint32_t ulSubmitTime;			/* The time xCSUImageSubmit() took for the copy job. */
+} CSUImageBenchmarkResult_t;
+
+/*
+ * Start the image service in CSUImage.c, at priority uxPriority + 1, and the
+ * task that measures it, at priority uxPriority.
+ */
+void vStartCSUImageBenchmarkTask( UBaseType_t uxPriority );
+
+/*
+ * Returns pdFAIL if the service could not be started, a job did not end as
+ * expected, or a copy was wrong, otherwise pdPASS.
+ */
+BaseType_t xIsCSUImageBenchmarkStillPassing( void );
+
+/*
+ * Returns pdPASS, and points *ppxResults at an array of *puxNumResults results,
+ * once the benchmark has completed.  Otherwise returns pdFAIL.
+ */
+BaseType_t xGetCSUImageBenchmarkResults( const CSUImageBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults );
+
+#endif /* CSU_IMAGE_BENCHMARK_H */
@@ -0,0 +1,338 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Times the BSP's data cache range maintenance functions in xil_cache.c for a
+ * range of sizes, using the PMU cycle counter.  Each measurement is made on a
+ * buffer that has just been written, so the lines being maintained are dirty,
+ * and the best of cachebenchREPETITIONS runs is kept to filter out interrupts.
+ *
+ * For comparison, the per line loops the BSP used before the range functions
+ * were batched are reproduced here - they select each cache level in
+ * CSSELR_EL1 in turn, and wait for each operation with a dsb, with interrupts
+ * masked throughout.  CSSELR_EL1 only selects the cache reported by
+ * CCSIDR_EL1, so the second operation on each line repeats the first.
+ *
+ * The scatter-gather results compare flushing cachebenchRANGES separate parts
+ * of the buffer with one call to Xil_DCacheFlushRange() each, against a single
+ * call to Xil_DCacheFlushRanges().
+ *
+ * The benchmark runs once.  Note that QEMU does not model caches, so results
+ * measured under QEMU only show the cost of the instructions, not of the memory
+ * traffic.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Demo includes. */
+#include "CacheMaintBenchmark.h"
+
+/* Xilinx includes. */
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+
+#define cachebenchMAX_SIZE				( 1024UL * 1024UL )
+#define cachebenchREPETITIONS			( 8 )
+#define cachebenchRANGES				( 4UL )
+#define cachebenchCACHE_LINE_SIZE		( 64UL )
+#define cachebenchIRQ_FIQ_MASK			( 0xC0U )
+
+/* The sizes measured. */
+static const uint32_t ulSizes[] = { 64UL, 1024UL, 16UL * 1024UL, 256UL * 1024UL, cachebenchMAX_SIZE };
+#define cachebenchNUM_SIZES				( sizeof( ulSizes ) / sizeof( ulSizes[ 0 ] ) )
+
+/* PMU registers and bits. */
+#define cachebenchPMCR_ENABLE			( 1ULL )
+#define cachebenchPMCNTEN_CYCLES		( 1ULL << 31ULL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmark.
+ */
+static void prvCacheMaintBenchmarkTask( void *pvParameters );
+
+/*
+ * The flush and invalidate loops used by the BSP before the range functions
+ * were batched.  adr and len must be cache line aligned.
+ */
+static void prvLegacyFlushRange( INTPTR adr, INTPTR len );
+static void prvLegacyInvalidateRange( INTPTR adr, INTPTR len );
+
+/*
+ * Dirty the first ulSize bytes of the buffer, then time one call to
+ * pxFunction.  Returns the best time of cachebenchREPETITIONS calls, in CPU
+ * cycles.
+ */
+static uint32_t prvTime( uint32_t ( *pxFunction )( uint32_t ulSize ), uint32_t ulSize );
+
+/*
+ * The functions timed by prvTime().  Each returns the cycle count from just
+ * before the cache maintenance started.
+ */
+static uint32_t prvTimeLegacyFlush( uint32_t ulSize );
+static uint32_t prvTimeLegacyInvalidate( uint32_t ulSize );
+static uint32_t prvTimeFlush( uint32_t ulSize );
+static uint32_t prvTimeInvalidate( uint32_t ulSize );
+static uint32_t prvTimeSeparateFlush( uint32_t ulSize );
+static uint32_t prvTimeScatterFlush( uint32_t ulSize );
+
+static inline uint32_t prvReadCycleCounter( void );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucBuffer[ cachebenchMAX_SIZE ] __attribute__( ( aligned( cachebenchCACHE_LINE_SIZE ) ) );
+
+static CacheMaintBenchmarkResult_t xResults[ cachebenchNUM_SIZES ];
+
+/* Set once xResults[] is complete. */
+static volatile BaseType_t xComplete = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartCacheMaintBenchmarkTask( UBaseType_t uxPriority )
+{
+	xTaskCreate( prvCacheMaintBenchmarkTask, "CacheBM", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetCacheMaintBenchmarkResults( const CacheMaintBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xComplete != pdFALSE )
+	{
+		*ppxResults = xResults;
+		*puxNumResults = ( UBaseType_t ) cachebenchNUM_SIZES;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCacheMaintBenchmarkTask( void *pvParameters )
+{
+uint64_t ullPMCR;
+UBaseType_t uxSize;
+
+	( void ) pvParameters;
+
+	/* Start the cycle counter on this core. */
+	__asm volatile( "MRS %0, PMCR_EL0" : "=r" ( ullPMCR ) );
+	__asm volatile( "MSR PMCR_EL0, %0\n MSR PMCNTENSET_EL0, %1\n ISB SY" :: "r" ( ullPMCR | cachebenchPMCR_ENABLE ), "r" ( cachebenchPMCNTEN_CYCLES ) : "memory" );
+
+	for( uxSize = 0; uxSize < cachebenchNUM_SIZES; uxSize++ )
+	{
+		xResults[ uxSize ].ulSize = ulSizes[ uxSize ];
+		xResults[ uxSize ].ulLegacyFlushCycles = prvTime( prvTimeLegacyFlush, ulSizes[ uxSize ] );
+		xResults[ uxSize ].ulLegacyInvalidateCycles = prvTime( prvTimeLegacyInvalidate, ulSizes[ uxSize ] );
+		xResults[ uxSize ].ulFlushCycles = prvTime( prvTimeFlush, ulSizes[ uxSize ] );
+		xResults[ uxSize ].ulInvalidateCycles = prvTime( prvTimeInvalidate, ulSizes[ uxSize ] );
+		xResults[ uxSize ].ulSeparateFlushCycles = prvTime( prvTimeSeparateFlush, ulSizes[ uxSize ] );
+		xResults[ uxSize ].ulScatterFlushCycles = prvTime( prvTimeScatterFlush, ulSizes[ uxSize ] );
+
+		/* Let lower priority tasks run between sizes. */
+		vTaskDelay( 1 );
+	}
+
+	xComplete = pdTRUE;
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTime( uint32_t ( *pxFunction )( uint32_t ulSize ), uint32_t ulSize )
+{
+uint32_t ulBest = UINT32_MAX, ulTime, ulStart;
+BaseType_t x;
+
+	for( x = 0; x < cachebenchREPETITIONS; x++ )
+	{
+		memset( ucBuffer, ( int ) x, ulSize );
+		ulStart = pxFunction( ulSize );
+		ulTime = prvReadCycleCounter() - ulStart;
+
+		if( ulTime < ulBest )
+		{
+			ulBest = ulTime;
+		}
+	}
+
+	return ulBest;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeLegacyFlush( uint32_t ulSize )
+{
+uint32_t ulStart = prvReadCycleCounter();
+
+	prvLegacyFlushRange( ( INTPTR ) ucBuffer, ( INTPTR ) ulSize );
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeLegacyInvalidate( uint32_t ulSize )
+{
+uint32_t ulStart = prvReadCycleCounter();
+
+	prvLegacyInvalidateRange( ( INTPTR ) ucBuffer, ( INTPTR ) ulSize );
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeFlush( uint32_t ulSize )
+{
+uint32_t ulStart = prvReadCycleCounter();
+
+	Xil_DCacheFlushRange( ( INTPTR ) ucBuffer, ( INTPTR ) ulSize );
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeInvalidate( uint32_t ulSize )
+{
+uint32_t ulStart = prvReadCycleCounter();
+
+	Xil_DCacheInvalidateRange( ( INTPTR ) ucBuffer, ( INTPTR ) ulSize );
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeSeparateFlush( uint32_t ulSize )
+{
+const uint32_t ulRangeSize = ulSize / cachebenchRANGES;
+uint32_t ulStart, ulRange;
+
+	/* Sizes below cachebenchRANGES lines are maintained as one range. */
+	if( ulRangeSize < cachebenchCACHE_LINE_SIZE )
+	{
+		ulStart = prvReadCycleCounter();
+		Xil_DCacheFlushRange( ( INTPTR ) ucBuffer, ( INTPTR ) ulSize );
+	}
+	else
+	{
+		ulStart = prvReadCycleCounter();
+
+		for( ulRange = 0; ulRange < cachebenchRANGES; ulRange++ )
+		{
+			Xil_DCacheFlushRange( ( INTPTR ) &( ucBuffer[ ulRange * ulRangeSize ] ), ( INTPTR ) ulRangeSize );
+		}
+	}
+
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeScatterFlush( uint32_t ulSize )
+{
+const uint32_t ulRangeSize = ulSize / cachebenchRANGES;
+Xil_CacheRange xRanges[ cachebenchRANGES ];
+uint32_t ulStart, ulRange, ulNumRanges = cachebenchRANGES;
+
+	if( ulRangeSize < cachebenchCACHE_LINE_SIZE )
+	{
+		xRanges[ 0 ].Addr = ( INTPTR ) ucBuffer;
+		xRanges[ 0 ].Len = ( INTPTR ) ulSize;
+		ulNumRanges = 1UL;
+	}
+	else
+	{
+		for( ulRange = 0; ulRange < cachebenchRANGES; ulRange++ )
+		{
+			xRanges[ ulRange ].Addr = ( INTPTR ) &( ucBuffer[ ulRange * ulRangeSize ] );
+			xRanges[ ulRange ].Len = ( INTPTR ) ulRangeSize;
+		}
+	}
+
+	ulStart = prvReadCycleCounter();
+	Xil_DCacheFlushRanges( xRanges, ulNumRanges );
+
+	return ulStart;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLegacyFlushRange( INTPTR adr, INTPTR len )
+{
+INTPTR tempadr = adr;
+const INTPTR end = adr + len;
+u32 currmask;
+
+	currmask = mfcpsr();
+	mtcpsr( currmask | cachebenchIRQ_FIQ_MASK );
+
+	while( tempadr < end )
+	{
+		mtcp( CSSELR_EL1, 0x0 );
+		mtcpdc( CIVAC, tempadr );
+		dsb();
+		mtcp( CSSELR_EL1, 0x2 );
+		mtcpdc( CIVAC, tempadr );
+		dsb();
+		tempadr += cachebenchCACHE_LINE_SIZE;
+	}
+
+	mtcpsr( currmask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLegacyInvalidateRange( INTPTR adr, INTPTR len )
+{
+INTPTR tempadr = adr;
+const INTPTR end = adr + len;
+u32 currmask;
+
+	currmask = mfcpsr();
+	mtcpsr( currmask | cachebenchIRQ_FIQ_MASK );
+
+	while( tempadr < end )
+	{
+		mtcp( CSSELR_EL1, 0x0 );
+		mtcpdc( IVAC, tempadr );
+		dsb();
+		mtcp( CSSELR_EL1, 0x2 );
+		mtcpdc( IVAC, tempadr );
+		dsb();
+		tempadr += cachebenchCACHE_LINE_SIZE;
+	}
+
+	mtcpsr( currmask );
+}
+/*-----------------------------------------------------------*/
+
+static inline uint32_t prvReadCycleCounter( void )
+{
+uint64_t ullCycles;
+
+	__asm volatile( "ISB SY\n MRS %0, PMCCNTR_EL0" : "=r" ( ullCycles ) :: "memory" );
+	return ( uint32_t ) ullCycles;
+}
+/*-----------------------------------------------------------*/
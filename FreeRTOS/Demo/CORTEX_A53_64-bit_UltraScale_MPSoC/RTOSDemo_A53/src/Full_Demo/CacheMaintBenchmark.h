@@ -0,0 +1,52 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef CACHE_MAINT_BENCHMARK_H
+#define CACHE_MAINT_BENCHMARK_H
+
+/* The time taken to maintain one range size, in CPU cycles - see
+CacheMaintBenchmark.c. */
+typedef struct CACHE_MAINT_BENCHMARK_RESULT
+{
+	uint32_t ulSize;					/* The number of bytes maintained. */
+	uint32_t ulLegacyFlushCycles;		/* The per line, per cache level loop the BSP used to flush a range. */
+	uint32_t ulLegacyInvalidateCycles;	/* The per line, per cache level loop the BSP used to invalidate a range. */
+	uint32_t ulFlushCycles;				/* Xil_DCacheFlushRange(). */
+	uint32_t ulInvalidateCycles;		/* Xil_DCacheInvalidateRange(). */
+	uint32_t ulSeparateFlushCycles;		/* Xil_DCacheFlushRange() called once for each of cachebenchRANGES ranges. */
+	uint32_t ulScatterFlushCycles;		/* Xil_DCacheFlushRanges() called once for the same cachebenchRANGES ranges. */
+} CacheMaintBenchmarkResult_t;
+
+void vStartCacheMaintBenchmarkTask( UBaseType_t uxPriority );
+
+/*
+ * Returns pdPASS, and points *ppxResults at an array of *puxNumResults results
+ * ordered by size, once the benchmark has completed.  Otherwise returns pdFAIL.
+ */
+BaseType_t xGetCacheMaintBenchmarkResults( const CacheMaintBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults );
+
+#endif /* CACHE_MAINT_BENCHMARK_H */
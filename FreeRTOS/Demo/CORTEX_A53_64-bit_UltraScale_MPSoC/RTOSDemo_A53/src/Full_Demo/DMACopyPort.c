@@ -0,0 +1,248 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * The Zynq UltraScale+ MPSoC port layer for the DMA copy service in
+ * Common/Minimal/DMACopy.c.  The service uses the first dmacopyMAX_CHANNELS
+ * channels of the general purpose DMA controller (GDMA) in simple mode, driven
+ * through the zdma driver.
+ *
+ * The GDMA is not coherent with the A53 data cache, so the source and
+ * destination are cleaned from the cache before a transfer starts, and the
+ * destination is invalidated when the transfer ends.  dmacopyPORT_ALIGNMENT is
+ * set to the cache line size in FreeRTOSConfig.h, so the DMA engine never
+ * writes to a cache line that the CPU is also writing to.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "DMACopy.h"
+#include "IRQDispatch.h"
+
+/* Xilinx includes. */
+#include "xzdma.h"
+#include "xscugic.h"
+#include "xil_cache.h"
+
+/* The GDMA channels used, which must have their own interrupts. */
+#define dmaportCHANNELS_AVAILABLE	2
+static const uint16_t usDeviceIDs[ dmaportCHANNELS_AVAILABLE ] = { XPAR_PSU_GDMA_0_DEVICE_ID, XPAR_PSU_GDMA_1_DEVICE_ID };
+static const uint32_t ulInterruptIDs[ dmaportCHANNELS_AVAILABLE ] = { XPAR_PSU_GDMA_0_INTR, XPAR_PSU_GDMA_1_INTR };
+
+#if( dmacopyMAX_CHANNELS < dmaportCHANNELS_AVAILABLE )
+	#define dmaportCHANNELS			dmacopyMAX_CHANNELS
+#else
+	#define dmaportCHANNELS			dmaportCHANNELS_AVAILABLE
+#endif
+
+/* The errors after which the channel stops, so no done interrupt follows. */
+#define dmaportFATAL_ERRORS			( XZDMA_IXR_AXI_WR_DATA_MASK | XZDMA_IXR_AXI_RD_DATA_MASK | XZDMA_IXR_AXI_RD_DST_DSCR_MASK | XZDMA_IXR_AXI_RD_SRC_DSCR_MASK )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by XZDma_IntrHandler() when a transfer ends or the channel reports an
+ * error.
+ */
+static void prvDoneHandler( void *pvCallBackRef );
+static void prvErrorHandler( void *pvCallBackRef, u32 ulErrorMask );
+
+/*
+ * Set the mode and start a transfer on a channel.
+ */
+static BaseType_t prvStartTransfer( UBaseType_t uxChannel, XZDma_Mode xMode, void *pvDestination, const void *pvSource, size_t xLength );
+
+/*-----------------------------------------------------------*/
+
+static XZDma xDMAInstances[ dmaportCHANNELS ];
+
+/* Set while a transfer is in progress, so a transfer that ends with both an
+error and a done interrupt is only reported once. */
+static volatile BaseType_t xTransferActive[ dmaportCHANNELS ];
+
+/* The pattern written by a memset, which the GDMA writes 128 bits at a time. */
+static uint32_t ulSetPattern[ dmaportCHANNELS ][ 4 ];
+
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxDMACopyPortInit( void )
+{
+extern XScuGic xInterruptController;
+static UBaseType_t uxChannelsInitialised = 0;
+XZDma_Config *pxConfig;
+BaseType_t xStatus;
+const uint8_t ucRisingEdge = 3;
+
+	/* Only initialise the channels once, even if the service is reset. */
+	while( uxChannelsInitialised < dmaportCHANNELS )
+	{
+		pxConfig = XZDma_LookupConfig( usDeviceIDs[ uxChannelsInitialised ] );
+		configASSERT( pxConfig );
+
+		xStatus = XZDma_CfgInitialize( &( xDMAInstances[ uxChannelsInitialised ] ), pxConfig, pxConfig->BaseAddress );
+		configASSERT( xStatus == XST_SUCCESS );
+
+		XZDma_SetCallBack( &( xDMAInstances[ uxChannelsInitialised ] ), XZDMA_HANDLER_DONE, ( void * ) prvDoneHandler, ( void * ) uxChannelsInitialised );
+		XZDma_SetCallBack( &( xDMAInstances[ uxChannelsInitialised ] ), XZDMA_HANDLER_ERROR, ( void * ) prvErrorHandler, ( void * ) uxChannelsInitialised );
+
+		/* The interrupt calls FreeRTOS API functions, so must be at or below
+		the maximum API call interrupt priority. */
+		XScuGic_SetPriorityTriggerType( &xInterruptController, ulInterruptIDs[ uxChannelsInitialised ], configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucRisingEdge );
+
+		xStatus = XScuGic_Connect( &xInterruptController, ulInterruptIDs[ uxChannelsInitialised ], ( Xil_InterruptHandler ) XZDma_IntrHandler, ( void * ) &( xDMAInstances[ uxChannelsInitialised ] ) );
+		configASSERT( xStatus == XST_SUCCESS );
+		vIRQDispatchUpdate( ulInterruptIDs[ uxChannelsInitialised ] );
+
+		XScuGic_Enable( &xInterruptController, ulInterruptIDs[ uxChannelsInitialised ] );
+		uxChannelsInitialised++;
+	}
+
+	return uxChannelsInitialised;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDMACopyPortStartCopy( UBaseType_t uxChannel, void *pvDestination, const void *pvSource, size_t xLength )
+{
+Xil_CacheRange xRanges[ 2 ];
+
+	/* Write any of the source held in the cache out to memory, where the DMA
+	engine will read it, and write back any dirty lines in the destination, so
+	they cannot be evicted over the data the DMA engine writes.  Both ranges
+	are maintained in one call, so they share barriers. */
+	xRanges[ 0 ].Addr = ( INTPTR ) pvSource;
+	xRanges[ 0 ].Len = ( INTPTR ) xLength;
+	xRanges[ 1 ].Addr = ( INTPTR ) pvDestination;
+	xRanges[ 1 ].Len = ( INTPTR ) xLength;
+	Xil_DCacheFlushRanges( xRanges, 2U );
+
+	return prvStartTransfer( uxChannel, XZDMA_NORMAL_MODE, pvDestination, pvSource, xLength );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDMACopyPortStartSet( UBaseType_t uxChannel, void *pvDestination, uint8_t ucValue, size_t xLength )
+{
+uint32_t ulWord = ( uint32_t ) ucValue * 0x01010101UL;
+
+	ulSetPattern[ uxChannel ][ 0 ] = ulWord;
+	ulSetPattern[ uxChannel ][ 1 ] = ulWord;
+	ulSetPattern[ uxChannel ][ 2 ] = ulWord;
+	ulSetPattern[ uxChannel ][ 3 ] = ulWord;
+
+	/* Write back any dirty lines in the destination now, so they cannot be
+	evicted over the data the DMA engine writes. */
+	Xil_DCacheFlushRange( ( INTPTR ) pvDestination, ( INTPTR ) xLength );
+
+	return prvStartTransfer( uxChannel, XZDMA_WRONLY_MODE, pvDestination, NULL, xLength );
+}
+/*-----------------------------------------------------------*/
+
+void vDMACopyPortEndTransfer( UBaseType_t uxChannel, void *pvDestination, size_t xLength )
+{
+	( void ) uxChannel;
+
+	/* Discard any lines the CPU speculatively loaded while the DMA engine was
+	writing.  The range is cache line aligned, so nothing else is lost. */
+	Xil_DCacheInvalidateRange( ( INTPTR ) pvDestination, ( INTPTR ) xLength );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartTransfer( UBaseType_t uxChannel, XZDma_Mode xMode, void *pvDestination, const void *pvSource, size_t xLength )
+{
+XZDma *pxInstance = &( xDMAInstances[ uxChannel ] );
+XZDma_Transfer xTransfer;
+BaseType_t xReturn = pdFALSE;
+
+	if( XZDma_SetMode( pxInstance, FALSE, xMode ) == XST_SUCCESS )
+	{
+		if( xMode == XZDMA_WRONLY_MODE )
+		{
+			XZDma_WOData( pxInstance, ulSetPattern[ uxChannel ] );
+		}
+
+		xTransfer.SrcAddr = ( UINTPTR ) pvSource;
+		xTransfer.DstAddr = ( UINTPTR ) pvDestination;
+		xTransfer.Size = ( u32 ) xLength;
+		xTransfer.SrcCoherent = 0;
+		xTransfer.DstCoherent = 0;
+		xTransfer.Pause = 0;
+
+		/* XZDma_IntrHandler() disables the channel's interrupts each time a
+		transfer completes. */
+		xTransferActive[ uxChannel ] = pdTRUE;
+		XZDma_EnableIntr( pxInstance, XZDMA_IXR_ALL_INTR_MASK );
+
+		if( XZDma_Start( pxInstance, &xTransfer, 1 ) == XST_SUCCESS )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			XZDma_DisableIntr( pxInstance, XZDMA_IXR_ALL_INTR_MASK );
+			xTransferActive[ uxChannel ] = pdFALSE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoneHandler( void *pvCallBackRef )
+{
+UBaseType_t uxChannel = ( UBaseType_t ) pvCallBackRef;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if( xTransferActive[ uxChannel ] != pdFALSE )
+	{
+		xTransferActive[ uxChannel ] = pdFALSE;
+		vDMACopyTransferCompleteFromISR( uxChannel, pdTRUE, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+static void prvErrorHandler( void *pvCallBackRef, u32 ulErrorMask )
+{
+UBaseType_t uxChannel = ( UBaseType_t ) pvCallBackRef;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* Other errors are counter overflows and the like, after which the
+	transfer continues to the done interrupt. */
+	if( ( ( ulErrorMask & dmaportFATAL_ERRORS ) != 0U ) && ( xTransferActive[ uxChannel ] != pdFALSE ) )
+	{
+		xTransferActive[ uxChannel ] = pdFALSE;
+		XZDma_DisableIntr( &( xDMAInstances[ uxChannel ] ), XZDMA_IXR_ALL_INTR_MASK );
+		vDMACopyTransferCompleteFromISR( uxChannel, pdFALSE, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
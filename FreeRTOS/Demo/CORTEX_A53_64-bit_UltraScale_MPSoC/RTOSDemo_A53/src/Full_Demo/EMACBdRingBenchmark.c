@@ -0,0 +1,410 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures how fast filled receive descriptors can be taken back from an
+ * emacps descriptor ring, comparing XEmacPs_BdRingFromHwRxBatch() with
+ * XEmacPs_BdRingFromHwRx() followed by the per descriptor work a caller of the
+ * latter has to do - read each descriptor's buffer address and length, and
+ * invalidate the cache over each buffer with Xil_DCacheInvalidateRange().
+ *
+ * No MAC is used.  The benchmark plays the part of the MAC by writing the
+ * status and setting the new bit of each descriptor in a burst, then times
+ * taking the burst back from the ring, then posts the buffers again - like a
+ * driver, it invalidates the buffers as they are posted, so they are not in
+ * the cache when the burst is taken back.  As on a real ring the descriptors
+ * are in memory mapped non-cacheable, so every read of a descriptor goes to
+ * DDR.  The frames are single buffer frames of two lengths, and frames that
+ * use bdbenchMULTI_BUFFERS contiguous buffers each, which the batch function
+ * invalidates as one range.
+ *
+ * The benchmark runs once, timing each case with the PMU cycle counter over
+ * bdbenchREPETITIONS bursts.  The file is empty unless bdbenchENABLE is set to
+ * 1 in FreeRTOSConfig.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "EMACBdRingBenchmark.h"
+
+#if( bdbenchENABLE == 1 )
+
+/* Xilinx includes. */
+#include "xparameters.h"
+#include "xemacps.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+
+#define bdbenchRING_SIZE				( 64UL )
+#define bdbenchREPETITIONS				( 1000UL )
+#define bdbenchMULTI_BUFFERS			( 4UL )
+
+/* The smallest block whose attributes Xil_SetTlbAttributes() can change. */
+#define bdbenchDESCRIPTOR_BLOCK_SIZE	( 0x200000UL )
+
+/* PMU registers and bits. */
+#define bdbenchPMCR_ENABLE				( 1ULL )
+#define bdbenchPMCNTEN_CYCLES			( 1ULL << 31ULL )
+
+/* The cases measured - the number of descriptors in each burst, the frame
+length, and the number of buffers per frame. */
+static const uint32_t ulCases[][ 3 ] =
+{
+	{ 1UL, 64UL, 1UL },
+	{ 4UL, 64UL, 1UL },
+	{ 16UL, 64UL, 1UL },
+	{ 32UL, 64UL, 1UL },
+	{ 1UL, 1514UL, 1UL },
+	{ 4UL, 1514UL, 1UL },
+	{ 16UL, 1514UL, 1UL },
+	{ 32UL, 1514UL, 1UL },
+	{ 32UL, ( bdbenchMULTI_BUFFERS - 1UL ) * XEMACPS_RX_BUF_SIZE + 1514UL, bdbenchMULTI_BUFFERS }
+};
+#define bdbenchNUM_CASES				( sizeof( ulCases ) / sizeof( ulCases[ 0 ] ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmark.
+ */
+static void prvEMACBdRingBenchmarkTask( void *pvParameters );
+
+/*
+ * Create the receive ring, with every descriptor posted.
+ */
+static BaseType_t prvCreateRing( void );
+
+/*
+ * Time one case.  Returns the rate in descriptors per second.
+ */
+static uint32_t prvTimeCase( const uint32_t *pulCase, BaseType_t xBatch );
+
+/*
+ * Play the part of the MAC, filling the next ulDescriptors posted descriptors
+ * with frames of ulFrameLength bytes, ulBuffersPerFrame descriptors each.
+ */
+static void prvFillDescriptors( uint32_t ulDescriptors, uint32_t ulFrameLength, uint32_t ulBuffersPerFrame );
+
+/*
+ * Take up to ulLimit filled descriptors back from the ring, and free them, the
+ * way a caller of XEmacPs_BdRingFromHwRx() does.  Returns the number taken.
+ */
+static uint32_t prvLegacyReclaim( uint32_t ulLimit );
+
+/*
+ * The same, with XEmacPs_BdRingFromHwRxBatch().
+ */
+static uint32_t prvBatchReclaim( uint32_t ulLimit );
+
+/*
+ * Post ulCount descriptors back to the ring.
+ */
+static void prvRepost( uint32_t ulCount );
+
+static inline uint32_t prvReadCycleCounter( void );
+
+/*-----------------------------------------------------------*/
+
+static XEmacPs_BdRing xRing;
+
+/* The descriptors, in a block that is mapped non-cacheable. */
+static union
+{
+	XEmacPs_Bd xBds[ bdbenchRING_SIZE ];
+	uint8_t ucBlock[ bdbenchDESCRIPTOR_BLOCK_SIZE ];
+} xDescriptorBlock __attribute__( ( aligned( bdbenchDESCRIPTOR_BLOCK_SIZE ) ) );
+
+static uint8_t ucBuffers[ bdbenchRING_SIZE ][ XEMACPS_RX_BUF_SIZE ] __attribute__( ( aligned( 64 ) ) );
+
+/* Filled by XEmacPs_BdRingFromHwRxBatch().  Too large for the task's stack. */
+static XEmacPs_BdVecEntry xBdVector[ bdbenchRING_SIZE ];
+
+static EMACBdRingBenchmarkResult_t xResults[ bdbenchNUM_CASES ];
+
+/* Set once xResults[] is complete. */
+static volatile BaseType_t xComplete = pdFALSE;
+
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartEMACBdRingBenchmarkTask( UBaseType_t uxPriority )
+{
+	xTaskCreate( prvEMACBdRingBenchmarkTask, "BdRingBM", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIsEMACBdRingBenchmarkStillPassing( void )
+{
+	return ( xErrorDetected == pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetEMACBdRingBenchmarkResults( const EMACBdRingBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xComplete != pdFALSE )
+	{
+		*ppxResults = xResults;
+		*puxNumResults = ( UBaseType_t ) bdbenchNUM_CASES;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEMACBdRingBenchmarkTask( void *pvParameters )
+{
+uint64_t ullPMCR;
+UBaseType_t uxCase;
+
+	( void ) pvParameters;
+
+	/* Start the cycle counter on this core. */
+	__asm volatile( "MRS %0, PMCR_EL0" : "=r" ( ullPMCR ) );
+	__asm volatile( "MSR PMCR_EL0, %0\n MSR PMCNTENSET_EL0, %1\n ISB SY" :: "r" ( ullPMCR | bdbenchPMCR_ENABLE ), "r" ( bdbenchPMCNTEN_CYCLES ) : "memory" );
+
+	Xil_SetTlbAttributes( ( UINTPTR ) &xDescriptorBlock, NORM_NONCACHE );
+
+	if( prvCreateRing() != pdPASS )
+	{
+		xErrorDetected = pdTRUE;
+	}
+	else
+	{
+		for( uxCase = 0; uxCase < bdbenchNUM_CASES; uxCase++ )
+		{
+			xResults[ uxCase ].ulDescriptors = ulCases[ uxCase ][ 0 ];
+			xResults[ uxCase ].ulFrameLength = ulCases[ uxCase ][ 1 ];
+			xResults[ uxCase ].ulBuffersPerFrame = ulCases[ uxCase ][ 2 ];
+			xResults[ uxCase ].ulLegacyRate = prvTimeCase( ulCases[ uxCase ], pdFALSE );
+			xResults[ uxCase ].ulBatchRate = prvTimeCase( ulCases[ uxCase ], pdTRUE );
+
+			/* Let lower priority tasks run between cases. */
+			vTaskDelay( 1 );
+		}
+
+		xComplete = pdTRUE;
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCreateRing( void )
+{
+XEmacPs_Bd xTemplate, *pxBdSet, *pxBd;
+uint32_t ul;
+BaseType_t xReturn = pdFAIL;
+
+	XEmacPs_BdClear( &xTemplate );
+
+	if( ( XEmacPs_BdRingCreate( &xRing, ( UINTPTR ) xDescriptorBlock.xBds, ( UINTPTR ) xDescriptorBlock.xBds, XEMACPS_BD_ALIGNMENT, bdbenchRING_SIZE ) == XST_SUCCESS ) &&
+		( XEmacPs_BdRingClone( &xRing, &xTemplate, XEMACPS_RECV ) == XST_SUCCESS ) &&
+		( XEmacPs_BdRingAlloc( &xRing, bdbenchRING_SIZE, &pxBdSet ) == XST_SUCCESS ) )
+	{
+		/* Buffer n is always posted to descriptor n, so the buffers of
+		consecutive descriptors are contiguous. */
+		pxBd = pxBdSet;
+
+		for( ul = 0; ul < bdbenchRING_SIZE; ul++ )
+		{
+			XEmacPs_BdSetAddressRx( pxBd, ( UINTPTR ) ucBuffers[ ul ] );
+			XEmacPs_BdClearRxNew( pxBd );
+			pxBd = XEmacPs_BdRingNext( &xRing, pxBd );
+		}
+
+		if( XEmacPs_BdRingToHw( &xRing, bdbenchRING_SIZE, pxBdSet ) == XST_SUCCESS )
+		{
+			xReturn = pdPASS;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeCase( const uint32_t *pulCase, BaseType_t xBatch )
+{
+uint64_t ullCycles = 0, ullDescriptors = 0;
+uint32_t ulRepetition, ulCount, ulStart, ulRate = 0;
+
+	for( ulRepetition = 0; ulRepetition < bdbenchREPETITIONS; ulRepetition++ )
+	{
+		prvFillDescriptors( pulCase[ 0 ], pulCase[ 1 ], pulCase[ 2 ] );
+
+		ulStart = prvReadCycleCounter();
+
+		if( xBatch != pdFALSE )
+		{
+			ulCount = prvBatchReclaim( pulCase[ 0 ] );
+		}
+		else
+		{
+			ulCount = prvLegacyReclaim( pulCase[ 0 ] );
+		}
+
+		ullCycles += ( uint64_t ) ( prvReadCycleCounter() - ulStart );
+		ullDescriptors += ulCount;
+
+		if( ulCount != pulCase[ 0 ] )
+		{
+			xErrorDetected = pdTRUE;
+		}
+
+		prvRepost( ulCount );
+	}
+
+	if( ullCycles > 0 )
+	{
+		ulRate = ( uint32_t ) ( ( ullDescriptors * XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ ) / ullCycles );
+	}
+
+	return ulRate;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillDescriptors( uint32_t ulDescriptors, uint32_t ulFrameLength, uint32_t ulBuffersPerFrame )
+{
+XEmacPs_Bd *pxBd = xRing.HwHead;
+uint32_t ul, ulBuffer = 0, ulStatus;
+
+	for( ul = 0; ul < ulDescriptors; ul++ )
+	{
+		ulStatus = 0;
+
+		if( ulBuffer == 0 )
+		{
+			ulStatus |= XEMACPS_RXBUF_SOF_MASK;
+		}
+
+		if( ++ulBuffer == ulBuffersPerFrame )
+		{
+			ulStatus |= XEMACPS_RXBUF_EOF_MASK | ulFrameLength;
+			ulBuffer = 0;
+		}
+
+		/* The status is written before the new bit, as by the MAC. */
+		XEmacPs_BdWrite( pxBd, XEMACPS_BD_STAT_OFFSET, ulStatus );
+		XEmacPs_BdWrite( pxBd, XEMACPS_BD_ADDR_OFFSET, XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_OFFSET ) | XEMACPS_RXBUF_NEW_MASK );
+		pxBd = XEmacPs_BdRingNext( &xRing, pxBd );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLegacyReclaim( uint32_t ulLimit )
+{
+XEmacPs_Bd *pxBdSet, *pxBd;
+uint32_t ulCount, ul, ulStatus, ulFrameBytes = 0, ulLength;
+UINTPTR uxBuffer;
+
+	ulCount = XEmacPs_BdRingFromHwRx( &xRing, ulLimit, &pxBdSet );
+	pxBd = pxBdSet;
+
+	for( ul = 0; ul < ulCount; ul++ )
+	{
+		/* XEmacPs_BdGetBufAddr() does not build the 64-bit address correctly,
+		so the two words are read here. */
+		uxBuffer = ( UINTPTR ) ( XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_OFFSET ) & XEMACPS_RXBUF_ADD_MASK );
+		uxBuffer |= ( UINTPTR ) XEmacPs_BdRead( pxBd, XEMACPS_BD_ADDR_HI_OFFSET ) << 32U;
+		ulStatus = XEmacPs_BdGetStatus( pxBd );
+
+		if( ( ulStatus & XEMACPS_RXBUF_EOF_MASK ) != 0 )
+		{
+			ulLength = ( ulStatus & XEMACPS_RXBUF_LEN_MASK ) - ulFrameBytes;
+			ulFrameBytes = 0;
+		}
+		else
+		{
+			ulLength = XEMACPS_RX_BUF_SIZE;
+			ulFrameBytes += XEMACPS_RX_BUF_SIZE;
+		}
+
+		Xil_DCacheInvalidateRange( ( INTPTR ) uxBuffer, ( INTPTR ) ulLength );
+		pxBd = XEmacPs_BdRingNext( &xRing, pxBd );
+	}
+
+	( void ) XEmacPs_BdRingFree( &xRing, ulCount, pxBdSet );
+
+	return ulCount;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBatchReclaim( uint32_t ulLimit )
+{
+uint32_t ulCount;
+
+	ulCount = XEmacPs_BdRingFromHwRxBatch( &xRing, ulLimit, XEMACPS_RX_BUF_SIZE, xBdVector );
+
+	if( ulCount > 0 )
+	{
+		( void ) XEmacPs_BdRingFree( &xRing, ulCount, xBdVector[ 0 ].BdPtr );
+	}
+
+	return ulCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRepost( uint32_t ulCount )
+{
+XEmacPs_Bd *pxBdSet, *pxBd;
+uint32_t ul;
+
+	if( ( ulCount > 0 ) && ( XEmacPs_BdRingAlloc( &xRing, ulCount, &pxBdSet ) == XST_SUCCESS ) )
+	{
+		pxBd = pxBdSet;
+
+		for( ul = 0; ul < ulCount; ul++ )
+		{
+			XEmacPs_BdClearRxNew( pxBd );
+			pxBd = XEmacPs_BdRingNext( &xRing, pxBd );
+		}
+
+		( void ) XEmacPs_BdRingToHw( &xRing, ulCount, pxBdSet );
+	}
+
+	/* As a driver does when it posts buffers, so the next reclaim starts with
+	none of them in the cache. */
+	Xil_DCacheInvalidateRange( ( INTPTR ) ucBuffers, ( INTPTR ) sizeof( ucBuffers ) );
+}
+/*-----------------------------------------------------------*/
+
+static inline uint32_t prvReadCycleCounter( void )
+{
+uint64_t ullCycles;
+
+	__asm volatile( "ISB SY\n MRS %0, PMCCNTR_EL0" : "=r" ( ullCycles ) :: "memory" );
+	return ( uint32_t ) ullCycles;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* bdbenchENABLE */
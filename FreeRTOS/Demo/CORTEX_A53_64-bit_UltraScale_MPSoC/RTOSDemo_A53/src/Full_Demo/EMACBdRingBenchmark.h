@@ -0,0 +1,62 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef EMAC_BD_RING_BENCHMARK_H
+#define EMAC_BD_RING_BENCHMARK_H
+
+/* Set to 1 in FreeRTOSConfig.h to build the benchmark.  Its descriptors take a
+2MB block of memory, so it is not built by default. */
+#ifndef bdbenchENABLE
+	#define bdbenchENABLE				0
+#endif
+
+/* The rate at which filled receive descriptors are taken back from the ring,
+in descriptors per second - see EMACBdRingBenchmark.c. */
+typedef struct EMAC_BD_RING_BENCHMARK_RESULT
+{
+	uint32_t ulDescriptors;			/* The number of descriptors filled before each reclaim. */
+	uint32_t ulFrameLength;			/* The length of each frame. */
+	uint32_t ulBuffersPerFrame;		/* The number of descriptors each frame uses. */
+	uint32_t ulLegacyRate;			/* XEmacPs_BdRingFromHwRx(), with a cache invalidate per buffer. */
+	uint32_t ulBatchRate;			/* XEmacPs_BdRingFromHwRxBatch(). */
+} EMACBdRingBenchmarkResult_t;
+
+void vStartEMACBdRingBenchmarkTask( UBaseType_t uxPriority );
+
+/*
+ * Returns pdFAIL if either reclaim function returned the wrong descriptors,
+ * otherwise pdPASS.
+ */
+BaseType_t xIsEMACBdRingBenchmarkStillPassing( void );
+
+/*
+ * Returns pdPASS, and points *ppxResults at an array of *puxNumResults results,
+ * once the benchmark has completed.  Otherwise returns pdFAIL.
+ */
+BaseType_t xGetEMACBdRingBenchmarkResults( const EMACBdRingBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults );
+
+#endif /* EMAC_BD_RING_BENCHMARK_H */
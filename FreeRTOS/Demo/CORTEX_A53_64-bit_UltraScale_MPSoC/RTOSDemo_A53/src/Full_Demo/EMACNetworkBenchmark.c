@@ -0,0 +1,340 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures the zero copy frame interface in EMACNetwork.c with the MAC in
+ * local loopback, so no cable or link partner is needed.
+ *
+ * A sender task fills transmit buffers with frames of varying length, each
+ * carrying a sequence number and a pattern derived from it, and sends them as
+ * fast as transmit buffers become free.  A receiver task takes the frames from
+ * the interface, checks the sequence number of each and the whole pattern of
+ * every emacbenchCHECK_INTERVAL'th, and releases the buffers.  A gap in the
+ * sequence is a frame the MAC dropped, which happens when the receiver falls
+ * far enough behind that no receive buffer is posted - the gaps are counted,
+ * not treated as errors.  Corrupt, duplicated or reordered frames are errors.
+ *
+ * After emacbenchWARM_UP_TIME_MS the receiver takes a snapshot of the
+ * interface's counters, and emacbenchMEASURE_TIME_MS later it takes another,
+ * and computes the frame rate, the network task's CPU cycles per frame (from
+ * the generic timer counts it records), and the number of frames per receive
+ * interrupt.  The tasks keep running, and checking, afterwards.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Demo includes. */
+#include "EMACNetwork.h"
+#include "EMACNetworkBenchmark.h"
+
+/* Only built with the interface it measures - see FreeRTOSConfig.h. */
+#if( emacnetENABLE == 1 )
+
+/* Xilinx includes. */
+#include "xparameters.h"
+
+#define emacbenchWARM_UP_TIME_MS		( 1000UL )
+#define emacbenchMEASURE_TIME_MS		( 5000UL )
+
+/* The whole payload of one frame in this many is checked. */
+#define emacbenchCHECK_INTERVAL			( 16UL )
+
+/* The frames use the local experimental EtherType, and carry the sequence
+number straight after the header. */
+#define emacbenchETHERTYPE_HIGH			( 0x88U )
+#define emacbenchETHERTYPE_LOW			( 0xB5U )
+#define emacbenchHEADER_LENGTH			( 14UL )
+#define emacbenchPAYLOAD_OFFSET			( emacbenchHEADER_LENGTH + sizeof( uint32_t ) )
+#define emacbenchMIN_FRAME_LENGTH		( 60UL )
+#define emacbenchMAX_FRAME_LENGTH		( 1514UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks that send and receive the benchmark frames.
+ */
+static void prvSenderTask( void *pvParameters );
+static void prvReceiverTask( void *pvParameters );
+
+/*
+ * Write the frame with sequence number ulSequence into pucFrame, and return
+ * its length.
+ */
+static uint32_t prvFillFrame( uint8_t *pucFrame, uint32_t ulSequence );
+
+/*
+ * Returns pdPASS if the payload of pxFrame is the pattern for ulSequence.
+ */
+static BaseType_t prvCheckPayload( const EMACFrame_t *pxFrame, uint32_t ulSequence );
+
+/*
+ * Compute xResult from the counters taken at the start and end of the
+ * measurement.
+ */
+static void prvComputeResult( const EMACNetworkStats_t *pxStart, const EMACNetworkStats_t *pxEnd, uint64_t ullElapsed );
+
+static inline uint64_t prvReadCounter( void );
+
+/*-----------------------------------------------------------*/
+
+/* A locally administered address. */
+static const uint8_t ucMACAddress[ 6 ] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+static EMACNetworkBenchmarkResult_t xResult;
+
+/* Frames that did not arrive. */
+static uint32_t ulFramesLost = 0;
+
+/* Set once xResult is complete. */
+static volatile BaseType_t xComplete = pdFALSE;
+
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartEMACNetworkBenchmark( UBaseType_t uxPriority )
+{
+	if( xEMACNetworkInit( ucMACAddress, pdTRUE, uxPriority + ( UBaseType_t ) 1 ) == pdPASS )
+	{
+		xTaskCreate( prvSenderTask, "EMACTx", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+		xTaskCreate( prvReceiverTask, "EMACRx", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+	}
+	else
+	{
+		xErrorDetected = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIsEMACNetworkBenchmarkStillPassing( void )
+{
+	return ( xErrorDetected == pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetEMACNetworkBenchmarkResult( EMACNetworkBenchmarkResult_t *pxResult )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xComplete != pdFALSE )
+	{
+		*pxResult = xResult;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSenderTask( void *pvParameters )
+{
+uint32_t ulSequence = 0;
+uint8_t *pucBuffer;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Sending is paced by the MAC returning transmit buffers. */
+		pucBuffer = pucEMACNetworkGetTxBuffer( portMAX_DELAY );
+
+		if( pucBuffer != NULL )
+		{
+			if( xEMACNetworkSend( pucBuffer, prvFillFrame( pucBuffer, ulSequence ) ) == pdPASS )
+			{
+				ulSequence++;
+			}
+			else
+			{
+				xErrorDetected = pdTRUE;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void *pvParameters )
+{
+EMACFrame_t xFrame;
+EMACNetworkStats_t xStart, xEnd;
+uint32_t ulSequence, ulExpected = 0;
+uint64_t ullStartCount = 0;
+TickType_t xStartTime;
+BaseType_t xMeasuring = pdFALSE;
+
+	( void ) pvParameters;
+
+	xStartTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		if( xEMACNetworkReceive( &xFrame, pdMS_TO_TICKS( emacbenchWARM_UP_TIME_MS ) ) == pdPASS )
+		{
+			/* In loopback the only frames are the benchmark's own. */
+			if( ( xFrame.ulLength < emacbenchMIN_FRAME_LENGTH ) ||
+				( memcmp( xFrame.pucData, ucMACAddress, sizeof( ucMACAddress ) ) != 0 ) ||
+				( xFrame.pucData[ 12 ] != emacbenchETHERTYPE_HIGH ) ||
+				( xFrame.pucData[ 13 ] != emacbenchETHERTYPE_LOW ) )
+			{
+				xErrorDetected = pdTRUE;
+			}
+			else
+			{
+				memcpy( &ulSequence, &( xFrame.pucData[ emacbenchHEADER_LENGTH ] ), sizeof( ulSequence ) );
+
+				/* The difference is signed so the sequence number can wrap. */
+				if( ( int32_t ) ( ulSequence - ulExpected ) < 0 )
+				{
+					/* Duplicated or reordered. */
+					xErrorDetected = pdTRUE;
+				}
+				else
+				{
+					ulFramesLost += ulSequence - ulExpected;
+					ulExpected = ulSequence + 1UL;
+
+					if( ( ( ulSequence % emacbenchCHECK_INTERVAL ) == 0 ) && ( prvCheckPayload( &xFrame, ulSequence ) != pdPASS ) )
+					{
+						xErrorDetected = pdTRUE;
+					}
+				}
+			}
+
+			vEMACNetworkReleaseRxBuffer( xFrame.pucData );
+		}
+
+		if( xComplete == pdFALSE )
+		{
+			if( xMeasuring == pdFALSE )
+			{
+				if( ( xTaskGetTickCount() - xStartTime ) >= pdMS_TO_TICKS( emacbenchWARM_UP_TIME_MS ) )
+				{
+					vEMACNetworkGetStats( &xStart );
+					ullStartCount = prvReadCounter();
+					xStartTime = xTaskGetTickCount();
+					ulFramesLost = 0;
+					xMeasuring = pdTRUE;
+				}
+			}
+			else if( ( xTaskGetTickCount() - xStartTime ) >= pdMS_TO_TICKS( emacbenchMEASURE_TIME_MS ) )
+			{
+				vEMACNetworkGetStats( &xEnd );
+				prvComputeResult( &xStart, &xEnd, prvReadCounter() - ullStartCount );
+				xComplete = pdTRUE;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvFillFrame( uint8_t *pucFrame, uint32_t ulSequence )
+{
+uint32_t ulLength, ul;
+
+	/* Cycle through the frame lengths. */
+	ulLength = emacbenchMIN_FRAME_LENGTH + ( ( ulSequence * 97UL ) % ( emacbenchMAX_FRAME_LENGTH - emacbenchMIN_FRAME_LENGTH + 1UL ) );
+
+	/* Sent to, and from, this MAC. */
+	memcpy( pucFrame, ucMACAddress, sizeof( ucMACAddress ) );
+	memcpy( &( pucFrame[ sizeof( ucMACAddress ) ] ), ucMACAddress, sizeof( ucMACAddress ) );
+	pucFrame[ 12 ] = emacbenchETHERTYPE_HIGH;
+	pucFrame[ 13 ] = emacbenchETHERTYPE_LOW;
+	memcpy( &( pucFrame[ emacbenchHEADER_LENGTH ] ), &ulSequence, sizeof( ulSequence ) );
+
+	for( ul = emacbenchPAYLOAD_OFFSET; ul < ulLength; ul++ )
+	{
+		pucFrame[ ul ] = ( uint8_t ) ( ulSequence + ul );
+	}
+
+	return ulLength;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckPayload( const EMACFrame_t *pxFrame, uint32_t ulSequence )
+{
+BaseType_t xReturn = pdPASS;
+uint32_t ul;
+
+	if( pxFrame->ulLength != emacbenchMIN_FRAME_LENGTH + ( ( ulSequence * 97UL ) % ( emacbenchMAX_FRAME_LENGTH - emacbenchMIN_FRAME_LENGTH + 1UL ) ) )
+	{
+		xReturn = pdFAIL;
+	}
+
+	for( ul = emacbenchPAYLOAD_OFFSET; ( ul < pxFrame->ulLength ) && ( xReturn == pdPASS ); ul++ )
+	{
+		if( pxFrame->pucData[ ul ] != ( uint8_t ) ( ulSequence + ul ) )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvComputeResult( const EMACNetworkStats_t *pxStart, const EMACNetworkStats_t *pxEnd, uint64_t ullElapsed )
+{
+uint64_t ullFrequency, ullFrames, ullInterrupts;
+
+	__asm volatile( "MRS %0, CNTFRQ_EL0" : "=r" ( ullFrequency ) );
+
+	ullFrames = ( uint64_t ) ( pxEnd->ulRxFrames - pxStart->ulRxFrames );
+	ullInterrupts = ( uint64_t ) ( pxEnd->ulRxInterrupts - pxStart->ulRxInterrupts );
+
+	if( ( ullFrames > 0 ) && ( ullElapsed > 0 ) )
+	{
+		xResult.ulFramesPerSecond = ( uint32_t ) ( ( ullFrames * ullFrequency ) / ullElapsed );
+
+		/* The network task's time is in generic timer counts. */
+		xResult.ulCyclesPerFrame = ( uint32_t ) ( ( ( ( pxEnd->ullRxTime - pxStart->ullRxTime ) / ullFrames ) * XPAR_CPU_CORTEXA53_0_CPU_CLK_FREQ_HZ ) / ullFrequency );
+	}
+
+	if( ullInterrupts > 0 )
+	{
+		xResult.ulFramesPerInterrupt = ( uint32_t ) ( ullFrames / ullInterrupts );
+	}
+
+	xResult.ulFramesLost = ulFramesLost;
+}
+/*-----------------------------------------------------------*/
+
+static inline uint64_t prvReadCounter( void )
+{
+uint64_t ullCount;
+
+	__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+
+	return ullCount;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* emacnetENABLE */
@@ -0,0 +1,59 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef EMAC_NETWORK_BENCHMARK_H
+#define EMAC_NETWORK_BENCHMARK_H
+
+/* The throughput of the frame interface in EMACNetwork.c, measured over
+emacbenchMEASURE_TIME_MS - see EMACNetworkBenchmark.c. */
+typedef struct EMAC_NETWORK_BENCHMARK_RESULT
+{
+	uint32_t ulFramesPerSecond;		/* Frames received per second. */
+	uint32_t ulCyclesPerFrame;		/* CPU cycles the network task spent on each frame received. */
+	uint32_t ulFramesPerInterrupt;	/* Frames received per receive interrupt. */
+	uint32_t ulFramesLost;			/* Frames sent but not received. */
+} EMACNetworkBenchmarkResult_t;
+
+/*
+ * Start the interface in loopback mode, with its network task at uxPriority + 1,
+ * and the tasks that send and receive the benchmark frames at uxPriority.
+ */
+void vStartEMACNetworkBenchmark( UBaseType_t uxPriority );
+
+/*
+ * Returns pdFAIL if a frame was corrupted, duplicated or reordered, or could
+ * not be sent, otherwise pdPASS.
+ */
+BaseType_t xIsEMACNetworkBenchmarkStillPassing( void );
+
+/*
+ * Returns pdPASS, and fills in *pxResult, once the measurement has completed.
+ * Otherwise returns pdFAIL.
+ */
+BaseType_t xGetEMACNetworkBenchmarkResult( EMACNetworkBenchmarkResult_t *pxResult );
+
+#endif /* EMAC_NETWORK_BENCHMARK_H */
@@ -51,6 +51,7 @@
 /* Demo includes. */
 #include "IntQueueTimer.h"
 #include "IntQueue.h"
+#include "IRQDispatch.h"
 
 /* Xilinx includes. */
 #include "xttcps.h"
@@ -166,6 +167,7 @@ const uint8_t ucRisingEdge = 3;
 		/* Connect to the interrupt controller. */
 		xStatus = XScuGic_Connect( &xInterruptController, xInterruptIDs[ xTimer ], ( Xil_InterruptHandler ) prvTimerHandler, ( void * ) pxTimerInstance );
 		configASSERT( xStatus == XST_SUCCESS);
+		vIRQDispatchUpdate( xInterruptIDs[ xTimer ] );
 
 		/* Enable the interrupt in the GIC. */
 		XScuGic_Enable( &xInterruptController, xInterruptIDs[ xTimer ] );
@@ -0,0 +1,466 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Checks, then times, the BSP's memory copy and set functions in xil_mem.c.
+ *
+ * The check compares each function with a byte by byte reference for every
+ * combination of source and destination alignment within 16 bytes, for every
+ * size up to xilmembenchCHECK_SIZES bytes and for a few larger sizes.  Guard
+ * bytes either side of the destination catch writes outside it.  On AArch64
+ * this covers the LDP/STP and LDNP/STNP loops, the alignment head and the
+ * tail of each function.
+ *
+ * The timings compare Xil_MemCpy() and Xil_MemCpyNT() with the C library's
+ * memcpy() and with the word then byte loop Xil_MemCpy() used to use, and the
+ * set functions with memset().  Buffers are cache line aligned, and the best
+ * of xilmembenchREPETITIONS runs is kept to filter out interrupts.  The
+ * largest size is twice the size of the A53's L2 cache, where the
+ * non-temporal versions should show their benefit.  Note that QEMU does not
+ * model caches, so results measured under QEMU are not representative.
+ *
+ * The benchmark runs once.
+ *
+ * Building with xilmembenchUSE_HOST_BUILD set to 1 leaves out the task and
+ * times with clock_gettime() instead of the PMU cycle counter, so the check
+ * and the measurements can be run by a harness on a host (AArch64 hosts use
+ * the same loops as the target), linked with xil_mem.c.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Demo includes. */
+#include "XilMemBenchmark.h"
+
+/* Xilinx includes. */
+#include "xil_mem.h"
+
+#ifndef xilmembenchUSE_HOST_BUILD
+	#define xilmembenchUSE_HOST_BUILD	0
+#endif
+
+#if( xilmembenchUSE_HOST_BUILD == 1 )
+
+	#include <time.h>
+
+	#define xilmembenchREAD_TIME()		prvReadNanoseconds()
+
+	static inline uint32_t prvReadNanoseconds( void )
+	{
+	struct timespec xNow;
+
+		( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+		return ( uint32_t ) ( ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec );
+	}
+
+#else
+
+	#define xilmembenchREAD_TIME()		prvReadCycleCounter()
+
+	static inline uint32_t prvReadCycleCounter( void )
+	{
+	uint64_t ullCycles;
+
+		__asm volatile( "ISB SY\n MRS %0, PMCCNTR_EL0" : "=r" ( ullCycles ) :: "memory" );
+		return ( uint32_t ) ullCycles;
+	}
+
+#endif /* xilmembenchUSE_HOST_BUILD */
+
+#define xilmembenchMAX_SIZE				( 2UL * 1024UL * 1024UL )
+#define xilmembenchREPETITIONS			( 4 )
+#define xilmembenchCACHE_LINE_SIZE		( 64UL )
+
+/* Every size up to this is checked, then the sizes in ulCheckSizes[]. */
+#define xilmembenchCHECK_SIZES			( 160UL )
+#define xilmembenchALIGNMENTS			( 16UL )
+#define xilmembenchGUARD_SIZE			( 32UL )
+#define xilmembenchGUARD_BYTE			( 0xA5U )
+
+/* The sizes checked above xilmembenchCHECK_SIZES, chosen to be either side of
+multiples of the 32 byte block size. */
+static const uint32_t ulCheckSizes[] = { 255UL, 256UL, 257UL, 1023UL, 1024UL, 4096UL + 13UL };
+#define xilmembenchNUM_CHECK_SIZES		( sizeof( ulCheckSizes ) / sizeof( ulCheckSizes[ 0 ] ) )
+#define xilmembenchMAX_CHECK_SIZE		( 4096UL + 13UL )
+
+
+/* PMU registers and bits. */
+#define xilmembenchPMCR_ENABLE			( 1ULL )
+#define xilmembenchPMCNTEN_CYCLES		( 1ULL << 31ULL )
+
+/* The functions checked, in the order they are checked. */
+typedef enum
+{
+	eCheckMemCpy = 0,
+	eCheckMemCpyNT,
+	eCheckMemSet,
+	eCheckMemSetNT,
+	eNumChecks
+} XilMemCheck_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Check one function, for one size and pair of alignments.  Returns pdPASS if
+ * the destination matches the reference and the guard bytes are untouched.
+ */
+static BaseType_t prvCheckOne( XilMemCheck_t eCheck, uint32_t ulSize, uint32_t ulSourceOffset, uint32_t ulDestinationOffset );
+
+/*
+ * Check every function for every pair of alignments, for one size.
+ */
+static BaseType_t prvCheckSize( uint32_t ulSize );
+
+/*
+ * The copy loop Xil_MemCpy() used before it was optimised.
+ */
+static void prvLegacyMemCpy( void *pvDestination, const void *pvSource, uint32_t ulCount );
+
+/*
+ * Time one call to pxFunction.  Returns the best time of
+ * xilmembenchREPETITIONS calls.
+ */
+static uint32_t prvTime( void ( *pxFunction )( uint32_t ulSize ), uint32_t ulSize );
+
+/*
+ * The functions timed by prvTime().
+ */
+static void prvTimeMemcpy( uint32_t ulSize );
+static void prvTimeLegacyCopy( uint32_t ulSize );
+static void prvTimeXilMemCpy( uint32_t ulSize );
+static void prvTimeXilMemCpyNT( uint32_t ulSize );
+static void prvTimeMemset( uint32_t ulSize );
+static void prvTimeXilMemSet( uint32_t ulSize );
+static void prvTimeXilMemSetNT( uint32_t ulSize );
+
+#if( xilmembenchUSE_HOST_BUILD == 0 )
+
+	/*
+	 * The task that runs the benchmark.
+	 */
+	static void prvXilMemBenchmarkTask( void *pvParameters );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucSource[ xilmembenchMAX_SIZE ] __attribute__( ( aligned( xilmembenchCACHE_LINE_SIZE ) ) );
+static uint8_t ucDestination[ xilmembenchMAX_SIZE ] __attribute__( ( aligned( xilmembenchCACHE_LINE_SIZE ) ) );
+
+/* The reference result, built byte by byte, for the check. */
+static uint8_t ucExpected[ xilmembenchMAX_CHECK_SIZE + xilmembenchALIGNMENTS + ( 2UL * xilmembenchGUARD_SIZE ) ];
+
+#if( xilmembenchUSE_HOST_BUILD == 0 )
+
+	/* The sizes timed by the task. */
+	static const uint32_t ulSizes[] = { 64UL, 1024UL, 16UL * 1024UL, 256UL * 1024UL, xilmembenchMAX_SIZE };
+	#define xilmembenchNUM_SIZES		( sizeof( ulSizes ) / sizeof( ulSizes[ 0 ] ) )
+
+	static XilMemBenchmarkResult_t xResults[ xilmembenchNUM_SIZES ];
+
+	/* Set once xResults[] is complete. */
+	static volatile BaseType_t xComplete = pdFALSE;
+
+	/* Set if the check fails. */
+	static volatile BaseType_t xCheckFailed = pdFALSE;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xXilMemBenchmarkCheck( void )
+{
+BaseType_t xReturn = pdPASS;
+uint32_t ulSize, ulIndex;
+
+	for( ulIndex = 0; ulIndex < sizeof( ucSource ); ulIndex++ )
+	{
+		ucSource[ ulIndex ] = ( uint8_t ) ( ( ulIndex * 7UL ) + ( ulIndex >> 8UL ) );
+	}
+
+	for( ulSize = 0; ( ulSize <= xilmembenchCHECK_SIZES ) && ( xReturn == pdPASS ); ulSize++ )
+	{
+		xReturn = prvCheckSize( ulSize );
+	}
+
+	for( ulIndex = 0; ( ulIndex < xilmembenchNUM_CHECK_SIZES ) && ( xReturn == pdPASS ); ulIndex++ )
+	{
+		xReturn = prvCheckSize( ulCheckSizes[ ulIndex ] );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vXilMemBenchmarkMeasure( uint32_t ulSize, XilMemBenchmarkResult_t *pxResult )
+{
+	configASSERT( ulSize <= xilmembenchMAX_SIZE );
+
+	pxResult->ulSize = ulSize;
+	pxResult->ulMemcpyTime = prvTime( prvTimeMemcpy, ulSize );
+	pxResult->ulLegacyCopyTime = prvTime( prvTimeLegacyCopy, ulSize );
+	pxResult->ulXilMemCpyTime = prvTime( prvTimeXilMemCpy, ulSize );
+	pxResult->ulXilMemCpyNTTime = prvTime( prvTimeXilMemCpyNT, ulSize );
+	pxResult->ulMemsetTime = prvTime( prvTimeMemset, ulSize );
+	pxResult->ulXilMemSetTime = prvTime( prvTimeXilMemSet, ulSize );
+	pxResult->ulXilMemSetNTTime = prvTime( prvTimeXilMemSetNT, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+#if( xilmembenchUSE_HOST_BUILD == 0 )
+
+	void vStartXilMemBenchmarkTask( UBaseType_t uxPriority )
+	{
+		xTaskCreate( prvXilMemBenchmarkTask, "XilMemBM", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xIsXilMemBenchmarkStillPassing( void )
+	{
+		return ( xCheckFailed == pdFALSE ) ? pdPASS : pdFAIL;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xGetXilMemBenchmarkResults( const XilMemBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults )
+	{
+	BaseType_t xReturn = pdFAIL;
+
+		if( xComplete != pdFALSE )
+		{
+			*ppxResults = xResults;
+			*puxNumResults = ( UBaseType_t ) xilmembenchNUM_SIZES;
+			xReturn = pdPASS;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvXilMemBenchmarkTask( void *pvParameters )
+	{
+	uint64_t ullPMCR;
+	UBaseType_t uxSize;
+
+		( void ) pvParameters;
+
+		if( xXilMemBenchmarkCheck() != pdPASS )
+		{
+			xCheckFailed = pdTRUE;
+		}
+		else
+		{
+			/* Start the cycle counter on this core. */
+			__asm volatile( "MRS %0, PMCR_EL0" : "=r" ( ullPMCR ) );
+			__asm volatile( "MSR PMCR_EL0, %0\n MSR PMCNTENSET_EL0, %1\n ISB SY" :: "r" ( ullPMCR | xilmembenchPMCR_ENABLE ), "r" ( xilmembenchPMCNTEN_CYCLES ) : "memory" );
+
+			for( uxSize = 0; uxSize < xilmembenchNUM_SIZES; uxSize++ )
+			{
+				vXilMemBenchmarkMeasure( ulSizes[ uxSize ], &( xResults[ uxSize ] ) );
+
+				/* Let lower priority tasks run between sizes. */
+				vTaskDelay( 1 );
+			}
+
+			xComplete = pdTRUE;
+		}
+
+		vTaskDelete( NULL );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* xilmembenchUSE_HOST_BUILD */
+
+static BaseType_t prvCheckSize( uint32_t ulSize )
+{
+BaseType_t xReturn = pdPASS;
+uint32_t ulSourceOffset, ulDestinationOffset;
+XilMemCheck_t eCheck;
+
+	for( eCheck = eCheckMemCpy; ( eCheck < eNumChecks ) && ( xReturn == pdPASS ); eCheck++ )
+	{
+		for( ulSourceOffset = 0; ulSourceOffset < xilmembenchALIGNMENTS; ulSourceOffset++ )
+		{
+			for( ulDestinationOffset = 0; ulDestinationOffset < xilmembenchALIGNMENTS; ulDestinationOffset++ )
+			{
+				if( prvCheckOne( eCheck, ulSize, ulSourceOffset, ulDestinationOffset ) != pdPASS )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckOne( XilMemCheck_t eCheck, uint32_t ulSize, uint32_t ulSourceOffset, uint32_t ulDestinationOffset )
+{
+/* The area compared covers the destination and the guard bytes either side of
+it.  The destination starts ulDestinationOffset bytes after a 16 byte aligned
+address. */
+const uint32_t ulAreaSize = ulSize + ulDestinationOffset + ( 2UL * xilmembenchGUARD_SIZE );
+uint8_t * const pucDestination = &( ucDestination[ xilmembenchGUARD_SIZE + ulDestinationOffset ] );
+const uint8_t * const pucSource = &( ucSource[ ulSourceOffset ] );
+const uint8_t ucValue = ( uint8_t ) ( ulSize + ulSourceOffset + ( uint32_t ) eCheck );
+uint32_t ulIndex;
+
+	memset( ucDestination, xilmembenchGUARD_BYTE, ulAreaSize );
+	memset( ucExpected, xilmembenchGUARD_BYTE, ulAreaSize );
+
+	for( ulIndex = 0; ulIndex < ulSize; ulIndex++ )
+	{
+		if( ( eCheck == eCheckMemCpy ) || ( eCheck == eCheckMemCpyNT ) )
+		{
+			ucExpected[ xilmembenchGUARD_SIZE + ulDestinationOffset + ulIndex ] = pucSource[ ulIndex ];
+		}
+		else
+		{
+			ucExpected[ xilmembenchGUARD_SIZE + ulDestinationOffset + ulIndex ] = ucValue;
+		}
+	}
+
+	switch( eCheck )
+	{
+		case eCheckMemCpy :
+			Xil_MemCpy( pucDestination, pucSource, ulSize );
+			break;
+
+		case eCheckMemCpyNT :
+			Xil_MemCpyNT( pucDestination, pucSource, ulSize );
+			break;
+
+		case eCheckMemSet :
+			Xil_MemSet( pucDestination, ( s32 ) ucValue, ulSize );
+			break;
+
+		default :
+			Xil_MemSetNT( pucDestination, ( s32 ) ucValue, ulSize );
+			break;
+	}
+
+	return ( memcmp( ucDestination, ucExpected, ulAreaSize ) == 0 ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTime( void ( *pxFunction )( uint32_t ulSize ), uint32_t ulSize )
+{
+uint32_t ulBest = UINT32_MAX, ulTime, ulStart;
+BaseType_t x;
+
+	for( x = 0; x < xilmembenchREPETITIONS; x++ )
+	{
+		ulStart = xilmembenchREAD_TIME();
+		pxFunction( ulSize );
+		ulTime = xilmembenchREAD_TIME() - ulStart;
+
+		if( ulTime < ulBest )
+		{
+			ulBest = ulTime;
+		}
+	}
+
+	return ulBest;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeMemcpy( uint32_t ulSize )
+{
+	memcpy( ucDestination, ucSource, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeLegacyCopy( uint32_t ulSize )
+{
+	prvLegacyMemCpy( ucDestination, ucSource, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeXilMemCpy( uint32_t ulSize )
+{
+	Xil_MemCpy( ucDestination, ucSource, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeXilMemCpyNT( uint32_t ulSize )
+{
+	Xil_MemCpyNT( ucDestination, ucSource, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeMemset( uint32_t ulSize )
+{
+	memset( ucDestination, ( int ) ulSize, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeXilMemSet( uint32_t ulSize )
+{
+	Xil_MemSet( ucDestination, ( s32 ) ulSize, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeXilMemSetNT( uint32_t ulSize )
+{
+	Xil_MemSetNT( ucDestination, ( s32 ) ulSize, ulSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLegacyMemCpy( void *pvDestination, const void *pvSource, uint32_t ulCount )
+{
+volatile char *pcDestination = ( volatile char * ) pvDestination;
+const volatile char *pcSource = ( const volatile char * ) pvSource;
+volatile int *plDestination;
+const volatile int *plSource;
+
+	/* As the original Xil_MemCpy(), which copied int sized words while at
+	least one word remained, then bytes.  The volatile accesses stop the
+	compiler replacing the loops with a call to memcpy(). */
+	while( ulCount >= sizeof( int ) )
+	{
+		plDestination = ( volatile int * ) pcDestination;
+		plSource = ( const volatile int * ) pcSource;
+		*plDestination = *plSource;
+		pcDestination += sizeof( int );
+		pcSource += sizeof( int );
+		ulCount -= sizeof( int );
+	}
+
+	while( ulCount > 0UL )
+	{
+		*pcDestination = *pcSource;
+		pcDestination++;
+		pcSource++;
+		ulCount--;
+	}
+}
+/*-----------------------------------------------------------*/
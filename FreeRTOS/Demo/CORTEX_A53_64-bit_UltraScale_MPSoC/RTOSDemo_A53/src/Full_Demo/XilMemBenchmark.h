@@ -0,0 +1,70 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef XIL_MEM_BENCHMARK_H
+#define XIL_MEM_BENCHMARK_H
+
+/* The time taken to copy or set one buffer size - see XilMemBenchmark.c.
+Times are in CPU cycles, or in nanoseconds in host builds. */
+typedef struct XIL_MEM_BENCHMARK_RESULT
+{
+	uint32_t ulSize;				/* The number of bytes copied or set. */
+	uint32_t ulMemcpyTime;			/* The C library's memcpy(). */
+	uint32_t ulLegacyCopyTime;		/* The word then byte loop Xil_MemCpy() used to use. */
+	uint32_t ulXilMemCpyTime;		/* Xil_MemCpy(). */
+	uint32_t ulXilMemCpyNTTime;		/* Xil_MemCpyNT(). */
+	uint32_t ulMemsetTime;			/* The C library's memset(). */
+	uint32_t ulXilMemSetTime;		/* Xil_MemSet(). */
+	uint32_t ulXilMemSetNTTime;		/* Xil_MemSetNT(). */
+} XilMemBenchmarkResult_t;
+
+/*
+ * Check Xil_MemCpy(), Xil_MemCpyNT(), Xil_MemSet() and Xil_MemSetNT() against
+ * a byte by byte reference for every source and destination alignment and a
+ * range of sizes.  Returns pdPASS if every result matched.
+ */
+BaseType_t xXilMemBenchmarkCheck( void );
+
+/*
+ * Time each function for one size, up to xilmembenchMAX_SIZE bytes.
+ */
+void vXilMemBenchmarkMeasure( uint32_t ulSize, XilMemBenchmarkResult_t *pxResult );
+
+void vStartXilMemBenchmarkTask( UBaseType_t uxPriority );
+
+/*
+ * Returns pdFAIL if the correctness check failed, otherwise pdPASS.
+ */
+BaseType_t xIsXilMemBenchmarkStillPassing( void );
+
+/*
+ * Returns pdPASS, and points *ppxResults at an array of *puxNumResults results
+ * ordered by size, once the benchmark has completed.  Otherwise returns pdFAIL.
+ */
+BaseType_t xGetXilMemBenchmarkResults( const XilMemBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults );
+
+#endif /* XIL_MEM_BENCHMARK_H */
@@ -0,0 +1,317 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures the scatter gather copy service in ZDMACopy.c against memcpy().
+ *
+ * Each case copies a 1MB buffer as a list of equal sized segments, writing
+ * the segments to the destination in the reverse order, so each segment is a
+ * separate block of memory.  The list is copied three ways: by memcpy() of
+ * each segment in turn, by one request holding the whole list, and by one
+ * request per channel, submitted together and then waited for.  The times for
+ * the requests include the cache maintenance the service does, and the time
+ * the task is blocked waiting for them.  The time the task spends in
+ * xZDMACopySubmit() is also recorded, as that is the CPU time a copy costs
+ * the requesting task.  After each way the destination is compared with the
+ * source.
+ *
+ * The benchmark runs once, timing each case over zdmabenchREPETITIONS copies
+ * of the buffer.  Times are taken from the generic timer, which unlike the
+ * cycle counter keeps counting while the core waits for an interrupt.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <string.h>
+
+/* Demo includes. */
+#include "ZDMACopy.h"
+#include "ZDMACopyBenchmark.h"
+
+#define zdmabenchBUFFER_SIZE			( 0x100000UL )
+#define zdmabenchREPETITIONS			( 16UL )
+#define zdmabenchMAX_SEGMENTS			( 1024UL )
+
+/* The cases measured - the number of segments, and the size of each. */
+static const uint32_t ulCases[][ 2 ] =
+{
+	{ 1UL, zdmabenchBUFFER_SIZE },
+	{ 16UL, zdmabenchBUFFER_SIZE / 16UL },
+	{ 256UL, zdmabenchBUFFER_SIZE / 256UL },
+	{ zdmabenchMAX_SEGMENTS, zdmabenchBUFFER_SIZE / zdmabenchMAX_SEGMENTS }
+};
+#define zdmabenchNUM_CASES				( sizeof( ulCases ) / sizeof( ulCases[ 0 ] ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmark.
+ */
+static void prvZDMACopyBenchmarkTask( void *pvParameters );
+
+/*
+ * Fill xSegments[] with ulSegments segments of ulSegmentSize bytes.
+ */
+static void prvBuildSegments( uint32_t ulSegments, uint32_t ulSegmentSize );
+
+/*
+ * Time copying the segments with memcpy().  Returns the rate.
+ */
+static uint32_t prvTimeMemcpy( uint32_t ulSegments );
+
+/*
+ * Time copying the segments with uxRequests requests, submitted together.
+ * Returns the rate, and sets *pulSubmitTime to the mean time each call to
+ * xZDMACopySubmit() took, in nanoseconds.
+ */
+static uint32_t prvTimeRequests( uint32_t ulSegments, UBaseType_t uxRequests, uint32_t *pulSubmitTime );
+
+/*
+ * Clear the destination, so the next copy can be checked.
+ */
+static void prvClearDestination( void );
+
+/*
+ * Set xErrorDetected if any segment's destination differs from its source.
+ */
+static void prvCheckDestination( uint32_t ulSegments );
+
+static inline uint64_t prvReadCounter( void );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucSource[ zdmabenchBUFFER_SIZE ] __attribute__( ( aligned( zdmacopyALIGNMENT ) ) );
+static uint8_t ucDestination[ zdmabenchBUFFER_SIZE ] __attribute__( ( aligned( zdmacopyALIGNMENT ) ) );
+
+static ZDMACopySegment_t xSegments[ zdmabenchMAX_SEGMENTS ];
+static ZDMACopyRequest_t xRequests[ zdmacopyCHANNELS ];
+
+/* The generic timer frequency, in Hz. */
+static uint64_t ullCounterFrequency = 0;
+
+static ZDMACopyBenchmarkResult_t xResults[ zdmabenchNUM_CASES ];
+
+/* Set once xResults[] is complete. */
+static volatile BaseType_t xComplete = pdFALSE;
+
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartZDMACopyBenchmarkTask( UBaseType_t uxPriority )
+{
+	if( xZDMACopyInit( uxPriority + ( UBaseType_t ) 1 ) == pdPASS )
+	{
+		xTaskCreate( prvZDMACopyBenchmarkTask, "ZDMABM", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+	}
+	else
+	{
+		xErrorDetected = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIsZDMACopyBenchmarkStillPassing( void )
+{
+	return ( xErrorDetected == pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetZDMACopyBenchmarkResults( const ZDMACopyBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xComplete != pdFALSE )
+	{
+		*ppxResults = xResults;
+		*puxNumResults = ( UBaseType_t ) zdmabenchNUM_CASES;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvZDMACopyBenchmarkTask( void *pvParameters )
+{
+UBaseType_t uxCase, uxRequests;
+uint32_t ulSegments, ulUnused, ul;
+
+	( void ) pvParameters;
+
+	__asm volatile( "MRS %0, CNTFRQ_EL0" : "=r" ( ullCounterFrequency ) );
+
+	for( ul = 0; ul < zdmabenchBUFFER_SIZE; ul++ )
+	{
+		ucSource[ ul ] = ( uint8_t ) ( ul ^ ( ul >> 8UL ) ^ ( ul >> 16UL ) );
+	}
+
+	for( uxCase = 0; uxCase < zdmabenchNUM_CASES; uxCase++ )
+	{
+		ulSegments = ulCases[ uxCase ][ 0 ];
+		prvBuildSegments( ulSegments, ulCases[ uxCase ][ 1 ] );
+
+		xResults[ uxCase ].ulSegments = ulSegments;
+		xResults[ uxCase ].ulSegmentSize = ulCases[ uxCase ][ 1 ];
+
+		prvClearDestination();
+		xResults[ uxCase ].ulMemcpyRate = prvTimeMemcpy( ulSegments );
+		prvCheckDestination( ulSegments );
+
+		prvClearDestination();
+		xResults[ uxCase ].ulRequestRate = prvTimeRequests( ulSegments, 1, &( xResults[ uxCase ].ulSubmitTime ) );
+		prvCheckDestination( ulSegments );
+
+		/* A list with fewer segments than there are channels cannot use them
+		all. */
+		uxRequests = ( ulSegments < ( uint32_t ) zdmacopyCHANNELS ) ? ( UBaseType_t ) ulSegments : ( UBaseType_t ) zdmacopyCHANNELS;
+
+		prvClearDestination();
+		xResults[ uxCase ].ulParallelRate = prvTimeRequests( ulSegments, uxRequests, &ulUnused );
+		prvCheckDestination( ulSegments );
+
+		/* Let lower priority tasks run between cases. */
+		vTaskDelay( 1 );
+	}
+
+	xComplete = pdTRUE;
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBuildSegments( uint32_t ulSegments, uint32_t ulSegmentSize )
+{
+uint32_t ul;
+
+	for( ul = 0; ul < ulSegments; ul++ )
+	{
+		xSegments[ ul ].pvSource = &( ucSource[ ul * ulSegmentSize ] );
+		xSegments[ ul ].pvDestination = &( ucDestination[ ( ulSegments - 1UL - ul ) * ulSegmentSize ] );
+		xSegments[ ul ].xLength = ( size_t ) ulSegmentSize;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeMemcpy( uint32_t ulSegments )
+{
+uint64_t ullStart, ullElapsed;
+uint32_t ulRepetition, ul;
+
+	ullStart = prvReadCounter();
+
+	for( ulRepetition = 0; ulRepetition < zdmabenchREPETITIONS; ulRepetition++ )
+	{
+		for( ul = 0; ul < ulSegments; ul++ )
+		{
+			memcpy( xSegments[ ul ].pvDestination, xSegments[ ul ].pvSource, xSegments[ ul ].xLength );
+		}
+	}
+
+	ullElapsed = prvReadCounter() - ullStart;
+
+	return ( uint32_t ) ( ( ( uint64_t ) zdmabenchBUFFER_SIZE * zdmabenchREPETITIONS * ullCounterFrequency ) / ( ullElapsed * 1000000ULL ) );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimeRequests( uint32_t ulSegments, UBaseType_t uxRequests, uint32_t *pulSubmitTime )
+{
+uint64_t ullStart, ullElapsed, ullSubmitStart, ullSubmitTime = 0;
+uint32_t ulRepetition, ulPerRequest, ulFirst;
+UBaseType_t ux;
+
+	ulPerRequest = ( ulSegments + ( uint32_t ) uxRequests - 1UL ) / ( uint32_t ) uxRequests;
+
+	ullStart = prvReadCounter();
+
+	for( ulRepetition = 0; ulRepetition < zdmabenchREPETITIONS; ulRepetition++ )
+	{
+		for( ux = 0; ux < uxRequests; ux++ )
+		{
+			ulFirst = ( uint32_t ) ux * ulPerRequest;
+			xRequests[ ux ].pxSegments = &( xSegments[ ulFirst ] );
+			xRequests[ ux ].uxNumberOfSegments = ( UBaseType_t ) ( ( ulSegments - ulFirst < ulPerRequest ) ? ( ulSegments - ulFirst ) : ulPerRequest );
+
+			ullSubmitStart = prvReadCounter();
+
+			if( xZDMACopySubmit( &( xRequests[ ux ] ), portMAX_DELAY ) != pdPASS )
+			{
+				xErrorDetected = pdTRUE;
+			}
+
+			ullSubmitTime += prvReadCounter() - ullSubmitStart;
+		}
+
+		for( ux = 0; ux < uxRequests; ux++ )
+		{
+			if( xZDMACopyWait( &( xRequests[ ux ] ), portMAX_DELAY ) != zdmacopySTATUS_COMPLETE )
+			{
+				xErrorDetected = pdTRUE;
+			}
+		}
+	}
+
+	ullElapsed = prvReadCounter() - ullStart;
+
+	*pulSubmitTime = ( uint32_t ) ( ( ullSubmitTime * 1000000000ULL ) / ( ullCounterFrequency * zdmabenchREPETITIONS * ( uint64_t ) uxRequests ) );
+
+	return ( uint32_t ) ( ( ( uint64_t ) zdmabenchBUFFER_SIZE * zdmabenchREPETITIONS * ullCounterFrequency ) / ( ullElapsed * 1000000ULL ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvClearDestination( void )
+{
+	memset( ucDestination, 0x00, sizeof( ucDestination ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckDestination( uint32_t ulSegments )
+{
+uint32_t ul;
+
+	for( ul = 0; ul < ulSegments; ul++ )
+	{
+		if( memcmp( xSegments[ ul ].pvDestination, xSegments[ ul ].pvSource, xSegments[ ul ].xLength ) != 0 )
+		{
+			xErrorDetected = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static inline uint64_t prvReadCounter( void )
+{
+uint64_t ullCount;
+
+	__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+
+	return ullCount;
+}
+/*-----------------------------------------------------------*/
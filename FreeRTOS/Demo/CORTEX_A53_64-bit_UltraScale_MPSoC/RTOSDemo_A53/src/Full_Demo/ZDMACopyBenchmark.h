@@ -0,0 +1,61 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef ZDMA_COPY_BENCHMARK_H
+#define ZDMA_COPY_BENCHMARK_H
+
+/* The rate at which a list of segments is copied, in megabytes (10^6 bytes)
+per second - see ZDMACopyBenchmark.c. */
+typedef struct ZDMA_COPY_BENCHMARK_RESULT
+{
+	uint32_t ulSegments;			/* The number of segments in the list. */
+	uint32_t ulSegmentSize;			/* The size of each segment, in bytes. */
+	uint32_t ulMemcpyRate;			/* memcpy() of each segment in turn. */
+	uint32_t ulRequestRate;			/* One request holding every segment. */
+	uint32_t ulParallelRate;		/* The segments split into one request per channel. */
+	uint32_t ulSubmitTime;			/* The time xZDMACopySubmit() took for the single request, in nanoseconds. */
+} ZDMACopyBenchmarkResult_t;
+
+/*
+ * Start the copy service in ZDMACopy.c, at priority uxPriority + 1, and the
+ * task that measures it, at priority uxPriority.
+ */
+void vStartZDMACopyBenchmarkTask( UBaseType_t uxPriority );
+
+/*
+ * Returns pdFAIL if the service could not be started, a request failed, or a
+ * copy was wrong, otherwise pdPASS.
+ */
+BaseType_t xIsZDMACopyBenchmarkStillPassing( void );
+
+/*
+ * Returns pdPASS, and points *ppxResults at an array of *puxNumResults results,
+ * once the benchmark has completed.  Otherwise returns pdFAIL.
+ */
+BaseType_t xGetZDMACopyBenchmarkResults( const ZDMACopyBenchmarkResult_t **ppxResults, UBaseType_t *puxNumResults );
+
+#endif /* ZDMA_COPY_BENCHMARK_H */
@@ -62,7 +62,9 @@
  * "Check" task - The check task period is set to five seconds.  Each time it
  * executes it checks all the standard demo tasks, and the register check tasks,
  * are not only still executing, but are executing without reporting any errors,
- * then outputs the system status to the UART.
+ * then outputs the system status to the UART.  When mainUSE_UART_CONSOLE is 1
+ * the output is queued by the interrupt driven console in UARTConsole.c, so the
+ * check task does not wait for it to be sent.
  */
 
 /* Standard includes. */
@@ -90,6 +92,16 @@
 #include "AbortDelay.h"
 #include "QueueOverwrite.h"
 #include "TimerDemo.h"
+#include "BlockPoolDemo.h"
+#include "DMACopyBenchmark.h"
+#include "IRQDispatch.h"
+#include "CacheMaintBenchmark.h"
+#include "XilMemBenchmark.h"
+#include "UARTConsole.h"
+#include "EMACNetworkBenchmark.h"
+#include "EMACBdRingBenchmark.h"
+#include "ZDMACopyBenchmark.h"
+#include "CSUImageBenchmark.h"
 
 /* Xilinx includes. */
 #include "xil_printf.h"
@@ -103,6 +115,66 @@
 #define mainCOM_TEST_TASK_PRIORITY			( tskIDLE_PRIORITY + ( UBaseType_t ) 2 )
 #define mainCHECK_TASK_PRIORITY				( configMAX_PRIORITIES - ( UBaseType_t ) 1 )
 #define mainQUEUE_OVERWRITE_PRIORITY		( tskIDLE_PRIORITY )
+#define mainDMA_COPY_BENCHMARK_PRIORITY		( tskIDLE_PRIORITY + ( UBaseType_t ) 2 )
+#define mainCACHE_MAINT_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+#define mainXIL_MEM_BENCHMARK_PRIORITY		( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+#define mainEMAC_NETWORK_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+#define mainEMAC_BD_RING_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+#define mainZDMA_COPY_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+#define mainCSU_IMAGE_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + ( UBaseType_t ) 1 )
+
+/* Set to 1 to compare memcpy() with the DMA copy service in DMACopy.c.  The
+benchmark loads the system heavily enough to starve the low priority test tasks,
+so is disabled by default. */
+#define mainENABLE_DMA_COPY_BENCHMARK		0
+
+/* Set to 1 to time the data cache range maintenance functions in xil_cache.c
+for a range of sizes - see CacheMaintBenchmark.c.  The results are printed
+once, by the check task. */
+#define mainENABLE_CACHE_MAINT_BENCHMARK	0
+
+/* Set to 1 to check the memory copy and set functions in xil_mem.c, then time
+them against memcpy() and memset() - see XilMemBenchmark.c.  The results are
+printed once, by the check task. */
+#define mainENABLE_XIL_MEM_BENCHMARK		0
+
+/* Set emacnetENABLE to 1 in FreeRTOSConfig.h to pass frames through the zero
+copy Ethernet interface in EMACNetwork.c with the MAC in local loopback, and
+measure the frame rate - see EMACNetworkBenchmark.c.  Like the DMA copy
+benchmark it keeps the CPU busy, so is disabled by default.  The results are
+printed once, by the check task.  The option is in FreeRTOSConfig.h as it also
+decides whether EMACNetwork.c is built. */
+#define mainENABLE_EMAC_NETWORK_BENCHMARK	emacnetENABLE
+
+/* Set bdbenchENABLE to 1 in FreeRTOSConfig.h to time taking filled receive
+descriptors back from an emacps descriptor ring, one at a time and in batches -
+see EMACBdRingBenchmark.c.  No MAC is used.  The results are printed once, by
+the check task. */
+#define mainENABLE_EMAC_BD_RING_BENCHMARK	bdbenchENABLE
+
+/* Set to 1 to compare memcpy() with the scatter gather copy service in
+ZDMACopy.c, which uses GDMA channels 2 to 7 - see ZDMACopyBenchmark.c.  The
+results are printed once, by the check task. */
+#define mainENABLE_ZDMA_COPY_BENCHMARK		0
+
+/* Set to 1 to compare verifying a firmware image on the CPU with verifying it
+through the CSU DMA image service in CSUImage.c - see CSUImageBenchmark.c.
+The results are printed once, by the check task. */
+#define mainENABLE_CSU_IMAGE_BENCHMARK		0
+
+/* Set to 1 to send the check task's output through the interrupt driven
+console in UARTConsole.c, or 0 to write it with xil_printf(), which waits for
+each character to be sent. */
+#define mainUSE_UART_CONSOLE				1
+
+#if( mainUSE_UART_CONSOLE == 1 )
+	#define mainPRINTF							lUARTConsolePrintf
+#else
+	#define mainPRINTF							xil_printf
+#endif
+
+/* lUARTConsolePrintf() formats messages on the calling task's stack. */
+#define mainCHECK_TASK_STACK_SIZE			( configMINIMAL_STACK_SIZE * ( UBaseType_t ) 3 )
 
 /* A block time of zero simply means "don't block". */
 #define mainDONT_BLOCK						( ( TickType_t ) 0 )
@@ -175,6 +247,16 @@ volatile uint64_t ullRegTest1LoopCounter = 0ULL, ullRegTest2LoopCounter = 0ULL;
 
 void main_full( void )
 {
+	#if( mainUSE_UART_CONSOLE == 1 )
+	{
+		BaseType_t xStatus;
+
+		xStatus = xUARTConsoleInit();
+		configASSERT( xStatus == pdPASS );
+		( void ) xStatus; /* Remove compiler warning if configASSERT() is not defined. */
+	}
+	#endif
+
 	/* Start all the other standard demo/test tasks.  They have no particular
 	functionality, but do demonstrate how to use the FreeRTOS API and test the
 	kernel port. */
@@ -193,6 +275,49 @@ void main_full( void )
 	vCreateAbortDelayTasks();
 	vStartQueueOverwriteTask( mainQUEUE_OVERWRITE_PRIORITY );
 	vStartTimerDemoTask( mainTIMER_TEST_PERIOD );
+	vStartBlockPoolDemoTasks();
+
+	#if( mainENABLE_DMA_COPY_BENCHMARK == 1 )
+	{
+		vStartDMACopyBenchmarkTasks( mainDMA_COPY_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_CACHE_MAINT_BENCHMARK == 1 )
+	{
+		vStartCacheMaintBenchmarkTask( mainCACHE_MAINT_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_XIL_MEM_BENCHMARK == 1 )
+	{
+		vStartXilMemBenchmarkTask( mainXIL_MEM_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_EMAC_NETWORK_BENCHMARK == 1 )
+	{
+		vStartEMACNetworkBenchmark( mainEMAC_NETWORK_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_EMAC_BD_RING_BENCHMARK == 1 )
+	{
+		vStartEMACBdRingBenchmarkTask( mainEMAC_BD_RING_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_ZDMA_COPY_BENCHMARK == 1 )
+	{
+		vStartZDMACopyBenchmarkTask( mainZDMA_COPY_BENCHMARK_PRIORITY );
+	}
+	#endif
+
+	#if( mainENABLE_CSU_IMAGE_BENCHMARK == 1 )
+	{
+		vStartCSUImageBenchmarkTask( mainCSU_IMAGE_BENCHMARK_PRIORITY );
+	}
+	#endif
 
 	/* Create the register check tasks, as described at the top of this	file */
 	xTaskCreate( prvRegTestTaskEntry1, "Reg1", configMINIMAL_STACK_SIZE, mainREG_TEST_TASK_1_PARAMETER, tskIDLE_PRIORITY, NULL );
@@ -203,7 +328,7 @@ void main_full( void )
 
 	/* Create the task that performs the 'check' functionality,	as described at
 	the top of this file. */
-	xTaskCreate( prvCheckTask, "Check", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
+	xTaskCreate( prvCheckTask, "Check", mainCHECK_TASK_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
 
 	/* Start the scheduler. */
 	vTaskStartScheduler();
@@ -335,6 +460,204 @@ const char *pcStatusString = "Pass";
 			pcStatusString = "Error: Timer Demo";
 		}
 
+		if( xAreBlockPoolDemoTasksStillRunning() != pdPASS )
+		{
+			ullErrorFound |= 1ULL << 19ULL;
+			pcStatusString = "Error: Block Pool";
+		}
+
+		#if( mainENABLE_DMA_COPY_BENCHMARK == 1 )
+		{
+			DMACopyBenchmarkResult_t xCPUCopy, xDMACopy;
+			uint32_t ulRun;
+
+			if( xAreDMACopyBenchmarkTasksStillRunning() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 20ULL;
+				pcStatusString = "Error: DMA Copy";
+			}
+			else if( xGetDMACopyBenchmarkResults( &xCPUCopy, &xDMACopy, &ulRun ) == pdPASS )
+			{
+				mainPRINTF( "memcpy: %u bytes/s, %u us per copy, %u%% CPU available\r\n", xCPUCopy.ulBytesPerSecond, xCPUCopy.ulMeanCopyTime, xCPUCopy.ulCPUAvailable );
+				mainPRINTF( "pvDMAMemCpy: %u bytes/s, %u us per copy, %u%% CPU available\r\n", xDMACopy.ulBytesPerSecond, xDMACopy.ulMeanCopyTime, xDMACopy.ulCPUAvailable );
+			}
+		}
+		#endif
+
+		#if( mainENABLE_CACHE_MAINT_BENCHMARK == 1 )
+		{
+			static BaseType_t xCacheResultsPrinted = pdFALSE;
+			const CacheMaintBenchmarkResult_t *pxResults;
+			UBaseType_t uxResults, uxResult;
+
+			if( ( xCacheResultsPrinted == pdFALSE ) && ( xGetCacheMaintBenchmarkResults( &pxResults, &uxResults ) == pdPASS ) )
+			{
+				mainPRINTF( "Cache maintenance cycles: bytes, legacy flush, legacy invalidate, flush, invalidate, 4 x flush, flush 4 ranges\r\n" );
+
+				for( uxResult = 0; uxResult < uxResults; uxResult++ )
+				{
+					mainPRINTF( "%u, %u, %u, %u, %u, %u, %u\r\n", pxResults[ uxResult ].ulSize,
+								pxResults[ uxResult ].ulLegacyFlushCycles, pxResults[ uxResult ].ulLegacyInvalidateCycles,
+								pxResults[ uxResult ].ulFlushCycles, pxResults[ uxResult ].ulInvalidateCycles,
+								pxResults[ uxResult ].ulSeparateFlushCycles, pxResults[ uxResult ].ulScatterFlushCycles );
+				}
+
+				xCacheResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( mainENABLE_XIL_MEM_BENCHMARK == 1 )
+		{
+			static BaseType_t xXilMemResultsPrinted = pdFALSE;
+			const XilMemBenchmarkResult_t *pxResults;
+			UBaseType_t uxResults, uxResult;
+
+			if( xIsXilMemBenchmarkStillPassing() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 22ULL;
+				pcStatusString = "Error: Xil_Mem";
+			}
+			else if( ( xXilMemResultsPrinted == pdFALSE ) && ( xGetXilMemBenchmarkResults( &pxResults, &uxResults ) == pdPASS ) )
+			{
+				mainPRINTF( "Copy and set cycles: bytes, memcpy, legacy Xil_MemCpy, Xil_MemCpy, Xil_MemCpyNT, memset, Xil_MemSet, Xil_MemSetNT\r\n" );
+
+				for( uxResult = 0; uxResult < uxResults; uxResult++ )
+				{
+					mainPRINTF( "%u, %u, %u, %u, %u, %u, %u, %u\r\n", pxResults[ uxResult ].ulSize,
+								pxResults[ uxResult ].ulMemcpyTime, pxResults[ uxResult ].ulLegacyCopyTime,
+								pxResults[ uxResult ].ulXilMemCpyTime, pxResults[ uxResult ].ulXilMemCpyNTTime,
+								pxResults[ uxResult ].ulMemsetTime, pxResults[ uxResult ].ulXilMemSetTime,
+								pxResults[ uxResult ].ulXilMemSetNTTime );
+				}
+
+				xXilMemResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( mainENABLE_EMAC_NETWORK_BENCHMARK == 1 )
+		{
+			static BaseType_t xEMACResultsPrinted = pdFALSE;
+			EMACNetworkBenchmarkResult_t xEMACResult;
+
+			if( xIsEMACNetworkBenchmarkStillPassing() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 23ULL;
+				pcStatusString = "Error: EMAC";
+			}
+			else if( ( xEMACResultsPrinted == pdFALSE ) && ( xGetEMACNetworkBenchmarkResult( &xEMACResult ) == pdPASS ) )
+			{
+				mainPRINTF( "EMAC loopback: %u frames/s, %u cycles per frame, %u frames per interrupt, %u frames lost\r\n",
+							xEMACResult.ulFramesPerSecond, xEMACResult.ulCyclesPerFrame,
+							xEMACResult.ulFramesPerInterrupt, xEMACResult.ulFramesLost );
+
+				xEMACResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( mainENABLE_EMAC_BD_RING_BENCHMARK == 1 )
+		{
+			static BaseType_t xBdRingResultsPrinted = pdFALSE;
+			const EMACBdRingBenchmarkResult_t *pxResults;
+			UBaseType_t uxResults, uxResult;
+
+			if( xIsEMACBdRingBenchmarkStillPassing() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 24ULL;
+				pcStatusString = "Error: BD ring";
+			}
+			else if( ( xBdRingResultsPrinted == pdFALSE ) && ( xGetEMACBdRingBenchmarkResults( &pxResults, &uxResults ) == pdPASS ) )
+			{
+				mainPRINTF( "Descriptors/s: descriptors, frame length, buffers per frame, XEmacPs_BdRingFromHwRx, XEmacPs_BdRingFromHwRxBatch\r\n" );
+
+				for( uxResult = 0; uxResult < uxResults; uxResult++ )
+				{
+					mainPRINTF( "%u, %u, %u, %u, %u\r\n", pxResults[ uxResult ].ulDescriptors,
+								pxResults[ uxResult ].ulFrameLength, pxResults[ uxResult ].ulBuffersPerFrame,
+								pxResults[ uxResult ].ulLegacyRate, pxResults[ uxResult ].ulBatchRate );
+				}
+
+				xBdRingResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( mainENABLE_ZDMA_COPY_BENCHMARK == 1 )
+		{
+			static BaseType_t xZDMAResultsPrinted = pdFALSE;
+			const ZDMACopyBenchmarkResult_t *pxResults;
+			UBaseType_t uxResults, uxResult;
+
+			if( xIsZDMACopyBenchmarkStillPassing() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 25ULL;
+				pcStatusString = "Error: ZDMA copy";
+			}
+			else if( ( xZDMAResultsPrinted == pdFALSE ) && ( xGetZDMACopyBenchmarkResults( &pxResults, &uxResults ) == pdPASS ) )
+			{
+				mainPRINTF( "Copy MB/s: segments, segment size, memcpy, one request, one request per channel, submit ns\r\n" );
+
+				for( uxResult = 0; uxResult < uxResults; uxResult++ )
+				{
+					mainPRINTF( "%u, %u, %u, %u, %u, %u\r\n", pxResults[ uxResult ].ulSegments,
+								pxResults[ uxResult ].ulSegmentSize, pxResults[ uxResult ].ulMemcpyRate,
+								pxResults[ uxResult ].ulRequestRate, pxResults[ uxResult ].ulParallelRate,
+								pxResults[ uxResult ].ulSubmitTime );
+				}
+
+				xZDMAResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( mainENABLE_CSU_IMAGE_BENCHMARK == 1 )
+		{
+			static BaseType_t xCSUImageResultsPrinted = pdFALSE;
+			const CSUImageBenchmarkResult_t *pxResults;
+			UBaseType_t uxResults, uxResult;
+
+			if( xIsCSUImageBenchmarkStillPassing() != pdPASS )
+			{
+				ullErrorFound |= 1ULL << 26ULL;
+				pcStatusString = "Error: CSU image";
+			}
+			else if( ( xCSUImageResultsPrinted == pdFALSE ) && ( xGetCSUImageBenchmarkResults( &pxResults, &uxResults ) == pdPASS ) )
+			{
+				mainPRINTF( "Image verify us: length, CPU, CPU copy, CSU DMA, CSU DMA copy, submit\r\n" );
+
+				for( uxResult = 0; uxResult < uxResults; uxResult++ )
+				{
+					mainPRINTF( "%u, %u, %u, %u, %u, %u\r\n", pxResults[ uxResult ].ulLength,
+								pxResults[ uxResult ].ulCPUVerifyTime, pxResults[ uxResult ].ulCPUCopyTime,
+								pxResults[ uxResult ].ulDMAVerifyTime, pxResults[ uxResult ].ulDMACopyTime,
+								pxResults[ uxResult ].ulSubmitTime );
+				}
+
+				xCSUImageResultsPrinted = pdTRUE;
+			}
+		}
+		#endif
+
+		#if( irqdispatchCOLLECT_STATS == 1 )
+		{
+			IRQStats_t xIRQStats;
+			uint32_t ulInterruptID;
+
+			/* Report each interrupt that has been taken.  The handler times are
+			in generic timer counts, and are cumulative since the scheduler
+			started. */
+			for( ulInterruptID = 0; ulInterruptID < ulIRQDispatchNumIDs(); ulInterruptID++ )
+			{
+				if( ( xIRQDispatchGetStats( ulInterruptID, &xIRQStats ) == pdPASS ) && ( xIRQStats.ulCount > 0 ) )
+				{
+					mainPRINTF( "IRQ %u: %u interrupts, handler time mean %u max %u counts\r\n", ulInterruptID, xIRQStats.ulCount, ( uint32_t ) ( xIRQStats.ullTotalTime / xIRQStats.ulCount ), xIRQStats.ulMaxTime );
+				}
+			}
+		}
+		#endif
+
 		/* Check that the register test 1 task is still running. */
 		if( ullLastRegTest1Value == ullRegTest1LoopCounter )
 		{
@@ -352,7 +675,7 @@ const char *pcStatusString = "Pass";
 		ullLastRegTest2Value = ullRegTest2LoopCounter;
 
 		/* Output the system status string. */
-		xil_printf( "%s, status code = %lu, tick count = %lu\r\n", pcStatusString, ullErrorFound, xTaskGetTickCount() );
+		mainPRINTF( "%s, status code = %lu, tick count = %lu\r\n", pcStatusString, ullErrorFound, xTaskGetTickCount() );
 
 		configASSERT( ullErrorFound == pdFALSE );
 	}
@@ -454,6 +777,9 @@ void vFullDemoTickHook( void )
 
 	/* Call the code that 'gives' a task notification from an ISR. */
 	xNotifyTaskFromISR();
+
+	/* Call the code that exchanges block pool blocks with a task. */
+	vBlockPoolPeriodicISRTest();
 }
 
 
@@ -0,0 +1,269 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * The GIC interrupt dispatcher called by vApplicationIRQHandler().
+ *
+ * The XScuGic driver keeps the installed handlers in the HandlerTable member
+ * of its configuration structure, which the original vApplicationIRQHandler()
+ * reached through XScuGic_ConfigTable[] on every interrupt.  This file keeps
+ * its own copy of the handlers in a cache line aligned table, so dispatching
+ * an interrupt is one bounds check, one load of the handler and its callback
+ * reference from the same cache line, and the call.  The bounds check also
+ * discards the spurious interrupt IDs (1020 to 1023).
+ *
+ * The table is filled from the driver's table by vIRQDispatchInit(), and any
+ * entry that is still empty is filled the first time its interrupt is taken.
+ * Handlers installed with XScuGic_Connect() after vIRQDispatchInit() has been
+ * called must be copied by calling vIRQDispatchUpdate().
+ *
+ * When irqdispatchCOLLECT_STATS is 1 each interrupt is counted, and its
+ * handler is timed using the generic timer's physical count (CNTPCT_EL0), per
+ * interrupt ID.  The counters are kept per core, as SGIs and PPIs are banked
+ * per core so the same ID can be handled on more than one core at once.  The
+ * same ID cannot nest on one core, so no locking is needed.
+ *
+ * Building with irqdispatchUSE_HOST_MODEL set to 1 replaces the XScuGic handler
+ * table, the counter and the core ID with the model in IRQDispatchHostModel.h,
+ * so the dispatch and accounting can be tested on a host by feeding
+ * vIRQDispatch() ICCIAR values from a fake source.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "IRQDispatch.h"
+
+#ifndef irqdispatchUSE_HOST_MODEL
+	#define irqdispatchUSE_HOST_MODEL		0
+#endif
+
+#if( irqdispatchUSE_HOST_MODEL == 1 )
+
+	#include "IRQDispatchHostModel.h"
+
+	#define irqdispatchNUM_IDS				irqhostNUM_IDS
+	#define irqdispatchHANDLER_TABLE		( xHostIRQModel.xHandlerTable )
+	#define irqdispatchREAD_COUNTER()		ullHostIRQModelReadCounter()
+	#define irqdispatchGET_CORE_ID()		ulHostIRQModelGetCoreID()
+	#define irqdispatchWRITE_BARRIER()		__asm volatile( "" ::: "memory" )
+
+#else
+
+	/* Xilinx includes. */
+	#include "xscugic.h"
+
+	extern XScuGic_Config XScuGic_ConfigTable[];
+
+	#define irqdispatchNUM_IDS				XSCUGIC_MAX_NUM_INTR_INPUTS
+	#define irqdispatchHANDLER_TABLE		( XScuGic_ConfigTable[ XPAR_SCUGIC_SINGLE_DEVICE_ID ].HandlerTable )
+	#define irqdispatchREAD_COUNTER()		prvReadCounter()
+	#define irqdispatchGET_CORE_ID()		prvGetCoreID()
+	#define irqdispatchWRITE_BARRIER()		__asm volatile( "DMB SY" ::: "memory" )
+
+	static inline uint64_t prvReadCounter( void )
+	{
+	uint64_t ullCount;
+
+		/* The ISB stops the counter being read early. */
+		__asm volatile( "ISB SY\n MRS %0, CNTPCT_EL0" : "=r" ( ullCount ) :: "memory" );
+		return ullCount;
+	}
+
+	static inline uint32_t prvGetCoreID( void )
+	{
+	uint64_t ullMPIDR;
+
+		__asm volatile( "MRS %0, MPIDR_EL1" : "=r" ( ullMPIDR ) );
+		return ( uint32_t ) ( ullMPIDR & 0xFFULL );
+	}
+
+#endif /* irqdispatchUSE_HOST_MODEL */
+
+#ifdef configNUM_CORES
+	#define irqdispatchNUM_CORES			configNUM_CORES
+#else
+	#define irqdispatchNUM_CORES			1
+#endif
+
+/* The interrupt ID is held in the bottom 10 bits of ICCIAR.  For SGIs, the
+bits above hold the ID of the requesting core. */
+#define irqdispatchINTERRUPT_ID_MASK		( 0x3FFUL )
+
+#define irqdispatchCACHE_LINE_SIZE			( 64 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct IRQ_DISPATCH_ENTRY
+{
+	void ( *pxHandler )( void *pvCallBackRef );
+	void *pvCallBackRef;
+} IRQDispatchEntry_t;
+
+/*
+ * Copy the handler for ulInterruptID from the XScuGic handler table.
+ */
+static void prvCopyEntry( uint32_t ulInterruptID );
+
+/*-----------------------------------------------------------*/
+
+/* The dispatch table.  A NULL handler means the entry has not been copied from
+the XScuGic handler table yet. */
+static IRQDispatchEntry_t xDispatchTable[ irqdispatchNUM_IDS ] __attribute__( ( aligned( irqdispatchCACHE_LINE_SIZE ) ) );
+
+#if( irqdispatchCOLLECT_STATS == 1 )
+
+	/* Each core only writes its own counters. */
+	static IRQStats_t xStats[ irqdispatchNUM_CORES ][ irqdispatchNUM_IDS ] __attribute__( ( aligned( irqdispatchCACHE_LINE_SIZE ) ) );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vIRQDispatchInit( void )
+{
+uint32_t ulInterruptID;
+
+	for( ulInterruptID = 0; ulInterruptID < irqdispatchNUM_IDS; ulInterruptID++ )
+	{
+		prvCopyEntry( ulInterruptID );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vIRQDispatchUpdate( uint32_t ulInterruptID )
+{
+	configASSERT( ulInterruptID < irqdispatchNUM_IDS );
+	prvCopyEntry( ulInterruptID );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyEntry( uint32_t ulInterruptID )
+{
+IRQDispatchEntry_t *pxEntry = &( xDispatchTable[ ulInterruptID ] );
+
+	/* The entry may be read by an interrupt on another core while it is
+	updated, so the callback reference is written before the handler, and the
+	handler is written in a single store.  An interrupt that sees the old
+	handler with the new reference is only possible if a handler is replaced
+	while its interrupt is enabled, which the XScuGic driver does not support
+	either. */
+	pxEntry->pvCallBackRef = irqdispatchHANDLER_TABLE[ ulInterruptID ].CallBackRef;
+	irqdispatchWRITE_BARRIER();
+	pxEntry->pxHandler = irqdispatchHANDLER_TABLE[ ulInterruptID ].Handler;
+}
+/*-----------------------------------------------------------*/
+
+void vIRQDispatch( uint32_t ulICCIAR )
+{
+uint32_t ulInterruptID = ulICCIAR & irqdispatchINTERRUPT_ID_MASK;
+IRQDispatchEntry_t *pxEntry;
+
+	if( ulInterruptID < irqdispatchNUM_IDS )
+	{
+		pxEntry = &( xDispatchTable[ ulInterruptID ] );
+
+		if( pxEntry->pxHandler == NULL )
+		{
+			prvCopyEntry( ulInterruptID );
+		}
+
+		#if( irqdispatchCOLLECT_STATS == 1 )
+		{
+		IRQStats_t *pxStats = &( xStats[ irqdispatchGET_CORE_ID() ][ ulInterruptID ] );
+		uint64_t ullStart, ullTime;
+
+			ullStart = irqdispatchREAD_COUNTER();
+			pxEntry->pxHandler( pxEntry->pvCallBackRef );
+			ullTime = irqdispatchREAD_COUNTER() - ullStart;
+
+			pxStats->ulCount++;
+			pxStats->ullTotalTime += ullTime;
+
+			if( ullTime > ( uint64_t ) pxStats->ulMaxTime )
+			{
+				pxStats->ulMaxTime = ( ullTime > 0xFFFFFFFFULL ) ? 0xFFFFFFFFUL : ( uint32_t ) ullTime;
+			}
+		}
+		#else
+		{
+			pxEntry->pxHandler( pxEntry->pvCallBackRef );
+		}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIRQDispatchGetStats( uint32_t ulInterruptID, IRQStats_t *pxStats )
+{
+BaseType_t xReturn = pdFAIL;
+
+	#if( irqdispatchCOLLECT_STATS == 1 )
+	{
+	uint32_t ulCore;
+
+		if( ulInterruptID < irqdispatchNUM_IDS )
+		{
+			pxStats->ulCount = 0;
+			pxStats->ulMaxTime = 0;
+			pxStats->ullTotalTime = 0;
+
+			/* The counters are updated without locking, so the snapshot is only
+			consistent to within the interrupts that occur while it is taken. */
+			for( ulCore = 0; ulCore < irqdispatchNUM_CORES; ulCore++ )
+			{
+				pxStats->ulCount += xStats[ ulCore ][ ulInterruptID ].ulCount;
+				pxStats->ullTotalTime += xStats[ ulCore ][ ulInterruptID ].ullTotalTime;
+
+				if( xStats[ ulCore ][ ulInterruptID ].ulMaxTime > pxStats->ulMaxTime )
+				{
+					pxStats->ulMaxTime = xStats[ ulCore ][ ulInterruptID ].ulMaxTime;
+				}
+			}
+
+			xReturn = pdPASS;
+		}
+	}
+	#else
+	{
+		( void ) ulInterruptID;
+		( void ) pxStats;
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulIRQDispatchNumIDs( void )
+{
+	return irqdispatchNUM_IDS;
+}
+/*-----------------------------------------------------------*/
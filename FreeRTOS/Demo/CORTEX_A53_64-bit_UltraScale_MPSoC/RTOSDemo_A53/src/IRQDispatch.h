@@ -0,0 +1,86 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef IRQ_DISPATCH_H
+#define IRQ_DISPATCH_H
+
+/*
+ * Dispatches GIC interrupts to the handlers installed with XScuGic_Connect(),
+ * for vApplicationIRQHandler().  See IRQDispatch.c.
+ */
+
+/* Set to 1 in FreeRTOSConfig.h to count each interrupt, and time its handler,
+per interrupt ID. */
+#ifndef irqdispatchCOLLECT_STATS
+	#define irqdispatchCOLLECT_STATS	0
+#endif
+
+/* The statistics for one interrupt ID, summed over all cores.  Times are in
+generic timer (CNTPCT_EL0) counts, and include the time spent in any
+interrupts that nest inside the handler. */
+typedef struct IRQ_STATS
+{
+	uint32_t ulCount;
+	uint32_t ulMaxTime;
+	uint64_t ullTotalTime;
+} IRQStats_t;
+
+/*
+ * Copy every handler currently installed in the XScuGic handler table into
+ * the dispatch table.  Called once the demo's handlers are installed, before
+ * interrupts are enabled.  An entry that has not been copied is copied the
+ * first time its interrupt is taken, so calling this function is optional.
+ */
+void vIRQDispatchInit( void );
+
+/*
+ * Copy the handler for one interrupt ID into the dispatch table.  Must be
+ * called after any call to XScuGic_Connect() made after vIRQDispatchInit(), as
+ * vIRQDispatchInit() copies the driver's stub handler for IDs that have no
+ * handler installed.
+ */
+void vIRQDispatchUpdate( uint32_t ulInterruptID );
+
+/*
+ * Call the handler for the interrupt identified by ulICCIAR, the value read
+ * from the GIC's interrupt acknowledge register.
+ */
+void vIRQDispatch( uint32_t ulICCIAR );
+
+/*
+ * Take a snapshot of the statistics for one interrupt ID.  Returns pdFAIL if
+ * ulInterruptID is out of range or statistics are not collected.
+ */
+BaseType_t xIRQDispatchGetStats( uint32_t ulInterruptID, IRQStats_t *pxStats );
+
+/*
+ * The number of interrupt IDs the dispatch table covers.
+ */
+uint32_t ulIRQDispatchNumIDs( void );
+
+#endif /* IRQ_DISPATCH_H */
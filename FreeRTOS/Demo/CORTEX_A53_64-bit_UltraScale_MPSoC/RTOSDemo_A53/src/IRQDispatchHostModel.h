@@ -0,0 +1,77 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef IRQ_DISPATCH_HOST_MODEL_H
+#define IRQ_DISPATCH_HOST_MODEL_H
+
+/*
+ * A software model of the parts of the A53 and the XScuGic driver used by
+ * IRQDispatch.c, used in place of them when IRQDispatch.c is built on a host
+ * with irqdispatchUSE_HOST_MODEL set to 1.  The model provides the driver's
+ * handler table, a counter that stands in for CNTPCT_EL0, and the ID of the
+ * core taking the interrupt.
+ *
+ * A host harness installs handlers in xHostIRQModel.xHandlerTable as
+ * XScuGic_Connect() would, then calls vIRQDispatch() with ICCIAR values from
+ * its own fake source.  Handlers can advance xHostIRQModel.ullCounter to model
+ * the time they take, and call vIRQDispatch() themselves to model nesting.
+ * HostTest/IRQDispatchTest.c is such a harness.
+ */
+
+#include <stdint.h>
+
+#ifndef irqhostNUM_IDS
+	#define irqhostNUM_IDS		195
+#endif
+
+/* The same layout as the XScuGic driver's XScuGic_VectorTableEntry. */
+typedef struct HostVectorTableEntry
+{
+	void ( *Handler )( void *CallBackRef );
+	void *CallBackRef;
+} HostVectorTableEntry_t;
+
+typedef struct HostIRQModel
+{
+	HostVectorTableEntry_t xHandlerTable[ irqhostNUM_IDS ];
+	uint64_t ullCounter;
+	uint32_t ulCoreID;
+} HostIRQModel_t;
+
+extern HostIRQModel_t xHostIRQModel;
+
+static inline uint64_t ullHostIRQModelReadCounter( void )
+{
+	return xHostIRQModel.ullCounter;
+}
+
+static inline uint32_t ulHostIRQModelGetCoreID( void )
+{
+	return xHostIRQModel.ulCoreID;
+}
+
+#endif /* IRQ_DISPATCH_HOST_MODEL_H */
@@ -0,0 +1,486 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An interrupt driven console for the UART used by xil_printf().
+ *
+ * xil_printf() writes each character with outbyte(), which spins until there
+ * is space in the UART's transmit FIFO, so a task printing a status line waits
+ * for most of the line to be sent - around 87us per character at 115200 baud.
+ * Here writers copy their data into a ring buffer and return, and the UART
+ * interrupt moves it from the ring buffer to the 64 byte transmit FIFO.
+ *
+ * The interrupt is only enabled while the ring buffer holds data.  A write
+ * that finds the transmitter idle fills the FIFO itself, then enables the
+ * FIFO empty interrupt, and each interrupt refills the FIFO until it is full,
+ * so one interrupt is taken per FIFO full - 64 characters - rather than one
+ * per character.  The Cadence UART's TX trigger (TTRIG) interrupt is not used
+ * as it is raised when the FIFO fills up to the trigger level, not when it
+ * drains down to it.  The PS UART has no DMA interface, so the FIFO is always
+ * written by the CPU.
+ *
+ * Writes made with a block time of zero, including lUARTConsolePrintf(), copy
+ * the whole message or, if it does not fit, drop and count it.  Writes made
+ * with a block time copy what fits, then wait on a direct to task notification
+ * that the interrupt gives once uartconsoleWAKE_SPACE bytes are free.  Only
+ * one blocking writer waits at a time - the others wait on a mutex.  Writes
+ * with a block time of zero also take the mutex, without waiting, so they are
+ * never copied into the middle of a blocking write - they are dropped and
+ * counted if a blocking write is in progress.  The ring
+ * buffer is shared by all cores, so it is only accessed inside critical
+ * sections.
+ *
+ * Building with uartconsoleUSE_HOST_MODEL set to 1 replaces the UART and the
+ * interrupt controller with the register model in UARTConsoleHostModel.h, so
+ * the ring buffer and flow control logic can be tested on a host.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Demo includes. */
+#include "UARTConsole.h"
+
+#ifndef uartconsoleUSE_HOST_MODEL
+	#define uartconsoleUSE_HOST_MODEL		0
+#endif
+
+#if( uartconsoleUSE_HOST_MODEL == 1 )
+
+	#include "UARTConsoleHostModel.h"
+
+	#define uartconsoleREAD_REG( ulOffset )				ulHostUARTModelRead( ulOffset )
+	#define uartconsoleWRITE_REG( ulOffset, ulValue )	vHostUARTModelWrite( ( ulOffset ), ( ulValue ) )
+
+#else
+
+	/* Demo includes. */
+	#include "IRQDispatch.h"
+
+	/* Xilinx includes. */
+	#include "xuartps.h"
+	#include "xscugic.h"
+
+	/* The UART used by xil_printf(). */
+	#define uartconsoleDEVICE_ID			XPAR_XUARTPS_0_DEVICE_ID
+	#define uartconsoleINTERRUPT_ID			XPAR_XUARTPS_0_INTR
+
+	#define uartconsoleREAD_REG( ulOffset )				XUartPs_ReadReg( xUARTInstance.Config.BaseAddress, ( ulOffset ) )
+	#define uartconsoleWRITE_REG( ulOffset, ulValue )	XUartPs_WriteReg( xUARTInstance.Config.BaseAddress, ( ulOffset ), ( ulValue ) )
+
+	static XUartPs xUARTInstance;
+
+#endif /* uartconsoleUSE_HOST_MODEL */
+
+/* A blocked writer is woken when at least this many bytes are free. */
+#ifndef uartconsoleWAKE_SPACE
+	#define uartconsoleWAKE_SPACE			( uartconsoleTX_BUFFER_SIZE / 4 )
+#endif
+
+#define uartconsoleINDEX_MASK				( ( uint32_t ) uartconsoleTX_BUFFER_SIZE - 1UL )
+
+#if( ( uartconsoleTX_BUFFER_SIZE & ( uartconsoleTX_BUFFER_SIZE - 1 ) ) != 0 )
+	#error uartconsoleTX_BUFFER_SIZE must be a power of two.
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The number of bytes free in the ring buffer.  Called from a critical
+ * section.
+ */
+static uint32_t prvSpaceAvailable( void );
+
+/*
+ * Copy up to xLength bytes into the ring buffer, and return the number
+ * copied.  Called from a critical section.
+ */
+static size_t prvCopyIn( const char *pcData, size_t xLength );
+
+/*
+ * Start the transmitter if it is idle and the ring buffer holds data.  Called
+ * from a critical section.
+ */
+static void prvStartTransmit( void );
+
+/*
+ * Move bytes from the ring buffer to the transmit FIFO until the FIFO is full
+ * or the ring buffer is empty, then enable the FIFO empty interrupt if there
+ * is more to send, or disable it if not.  Called from a critical section.
+ */
+static void prvFillTxFIFO( void );
+
+/*
+ * The UART interrupt handler.
+ */
+static void prvInterruptHandler( void *pvCallBackRef );
+
+/*-----------------------------------------------------------*/
+
+/* The ring buffer.  The indexes run freely, and are masked when used. */
+static char cTxBuffer[ uartconsoleTX_BUFFER_SIZE ];
+static uint32_t ulHead = 0, ulTail = 0;
+
+/* pdTRUE while the FIFO empty interrupt is enabled. */
+static BaseType_t xTransmitting = pdFALSE;
+
+/* The blocking writer waiting for space, if any. */
+static TaskHandle_t xWaitingWriter = NULL;
+
+/* Serialises blocking writers. */
+static SemaphoreHandle_t xWriterMutex = NULL;
+
+static UARTConsoleStats_t xStats;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xUARTConsoleInit( void )
+{
+BaseType_t xReturn = pdFAIL;
+
+	if( xWriterMutex == NULL )
+	{
+		#if( uartconsoleUSE_HOST_MODEL == 1 )
+		{
+			vHostUARTModelInstallHandler( prvInterruptHandler );
+			xReturn = pdPASS;
+		}
+		#else
+		{
+		extern XScuGic xInterruptController;
+		XUartPs_Config *pxConfig;
+		const uint8_t ucLevelSensitive = 1;
+
+			pxConfig = XUartPs_LookupConfig( uartconsoleDEVICE_ID );
+
+			/* xil_printf() must keep writing to the same UART. */
+			configASSERT( pxConfig );
+			configASSERT( pxConfig->BaseAddress == STDOUT_BASEADDRESS );
+
+			/* Leaves all the UART's interrupts disabled. */
+			if( XUartPs_CfgInitialize( &xUARTInstance, pxConfig, pxConfig->BaseAddress ) == XST_SUCCESS )
+			{
+				uartconsoleWRITE_REG( XUARTPS_ISR_OFFSET, XUARTPS_IXR_MASK );
+
+				/* The interrupt calls FreeRTOS API functions, so must be at or
+				below the maximum API call interrupt priority. */
+				XScuGic_SetPriorityTriggerType( &xInterruptController, uartconsoleINTERRUPT_ID, configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucLevelSensitive );
+
+				if( XScuGic_Connect( &xInterruptController, uartconsoleINTERRUPT_ID, ( Xil_InterruptHandler ) prvInterruptHandler, NULL ) == XST_SUCCESS )
+				{
+					vIRQDispatchUpdate( uartconsoleINTERRUPT_ID );
+					XScuGic_Enable( &xInterruptController, uartconsoleINTERRUPT_ID );
+					xReturn = pdPASS;
+				}
+			}
+		}
+		#endif
+
+		if( xReturn == pdPASS )
+		{
+			xWriterMutex = xSemaphoreCreateMutex();
+
+			if( xWriterMutex == NULL )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+	}
+	else
+	{
+		/* Already initialised. */
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xUARTConsoleWrite( const char *pcData, size_t xLength, TickType_t xTicksToWait )
+{
+size_t xWritten = 0;
+TimeOut_t xTimeOut;
+BaseType_t xTimedOut = pdFALSE;
+
+	configASSERT( xWriterMutex );
+
+	if( xTicksToWait == ( TickType_t ) 0 )
+	{
+		/* A blocking writer holds the mutex until its whole message has been
+		copied, so a message copied while it is held would be spliced into
+		the middle of the blocking writer's message. */
+		if( xSemaphoreTake( xWriterMutex, ( TickType_t ) 0 ) == pdPASS )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( ( size_t ) prvSpaceAvailable() >= xLength )
+				{
+					xWritten = prvCopyIn( pcData, xLength );
+					prvStartTransmit();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			( void ) xSemaphoreGive( xWriterMutex );
+		}
+
+		if( xWritten != xLength )
+		{
+			taskENTER_CRITICAL();
+			{
+				xStats.ulBytesDropped += ( uint32_t ) xLength;
+				xStats.ulMessagesDropped++;
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+	else
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		if( xSemaphoreTake( xWriterMutex, xTicksToWait ) == pdPASS )
+		{
+			/* Clear any notification left over from an earlier write. */
+			( void ) ulTaskNotifyTake( pdTRUE, ( TickType_t ) 0 );
+
+			while( ( xWritten < xLength ) && ( xTimedOut == pdFALSE ) )
+			{
+				taskENTER_CRITICAL();
+				{
+					xWritten += prvCopyIn( &( pcData[ xWritten ] ), xLength - xWritten );
+					prvStartTransmit();
+
+					if( xWritten < xLength )
+					{
+						/* Ask the interrupt to give a notification once there is
+						space. */
+						xWaitingWriter = xTaskGetCurrentTaskHandle();
+						xStats.ulWriterBlocks++;
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( xWritten < xLength )
+				{
+					if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+					{
+						( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+					}
+					else
+					{
+						xTimedOut = pdTRUE;
+					}
+				}
+			}
+
+			taskENTER_CRITICAL();
+			{
+				xWaitingWriter = NULL;
+				xStats.ulBytesDropped += ( uint32_t ) ( xLength - xWritten );
+			}
+			taskEXIT_CRITICAL();
+
+			( void ) xSemaphoreGive( xWriterMutex );
+		}
+		else
+		{
+			taskENTER_CRITICAL();
+			{
+				xStats.ulBytesDropped += ( uint32_t ) xLength;
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+
+	return xWritten;
+}
+/*-----------------------------------------------------------*/
+
+int lUARTConsolePrintf( const char *pcFormat, ... )
+{
+char cMessage[ uartconsoleMAX_MESSAGE_LENGTH ];
+va_list xArgs;
+int lLength;
+
+	va_start( xArgs, pcFormat );
+	lLength = vsnprintf( cMessage, sizeof( cMessage ), pcFormat, xArgs );
+	va_end( xArgs );
+
+	if( lLength < 0 )
+	{
+		lLength = 0;
+	}
+	else if( lLength >= ( int ) sizeof( cMessage ) )
+	{
+		/* Truncated. */
+		lLength = ( int ) sizeof( cMessage ) - 1;
+	}
+
+	return ( int ) xUARTConsoleWrite( cMessage, ( size_t ) lLength, ( TickType_t ) 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vUARTConsoleGetStats( UARTConsoleStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSpaceAvailable( void )
+{
+	return ( uint32_t ) uartconsoleTX_BUFFER_SIZE - ( ulHead - ulTail );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCopyIn( const char *pcData, size_t xLength )
+{
+const uint32_t ulIndex = ulHead & uartconsoleINDEX_MASK;
+uint32_t ulFirst, ulUsed;
+
+	if( xLength > ( size_t ) prvSpaceAvailable() )
+	{
+		xLength = ( size_t ) prvSpaceAvailable();
+	}
+
+	/* The data may wrap around the end of the buffer. */
+	ulFirst = ( uint32_t ) uartconsoleTX_BUFFER_SIZE - ulIndex;
+
+	if( ulFirst > ( uint32_t ) xLength )
+	{
+		ulFirst = ( uint32_t ) xLength;
+	}
+
+	memcpy( &( cTxBuffer[ ulIndex ] ), pcData, ulFirst );
+	memcpy( cTxBuffer, &( pcData[ ulFirst ] ), xLength - ulFirst );
+	ulHead += ( uint32_t ) xLength;
+
+	xStats.ulBytesQueued += ( uint32_t ) xLength;
+	ulUsed = ulHead - ulTail;
+
+	if( ulUsed > xStats.ulHighWaterMark )
+	{
+		xStats.ulHighWaterMark = ulUsed;
+	}
+
+	return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartTransmit( void )
+{
+	/* While the FIFO empty interrupt is enabled the interrupt handler sends
+	anything added to the ring buffer. */
+	if( ( xTransmitting == pdFALSE ) && ( ulHead != ulTail ) )
+	{
+		/* The FIFO empty status latches whether or not the interrupt is
+		enabled, so clear it before the FIFO is filled. */
+		uartconsoleWRITE_REG( XUARTPS_ISR_OFFSET, XUARTPS_IXR_TXEMPTY );
+		prvFillTxFIFO();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillTxFIFO( void )
+{
+	while( ( ulHead != ulTail ) && ( ( uartconsoleREAD_REG( XUARTPS_SR_OFFSET ) & XUARTPS_SR_TXFULL ) == 0U ) )
+	{
+		uartconsoleWRITE_REG( XUARTPS_FIFO_OFFSET, ( uint32_t ) ( uint8_t ) cTxBuffer[ ulTail & uartconsoleINDEX_MASK ] );
+		ulTail++;
+		xStats.ulBytesSent++;
+	}
+
+	if( ulHead != ulTail )
+	{
+		if( xTransmitting == pdFALSE )
+		{
+			uartconsoleWRITE_REG( XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY );
+			xTransmitting = pdTRUE;
+		}
+	}
+	else
+	{
+		/* Everything is in the FIFO, so the FIFO empty interrupt is not needed
+		until more is written. */
+		if( xTransmitting != pdFALSE )
+		{
+			uartconsoleWRITE_REG( XUARTPS_IDR_OFFSET, XUARTPS_IXR_TXEMPTY );
+			xTransmitting = pdFALSE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptHandler( void *pvCallBackRef )
+{
+uint32_t ulStatus;
+UBaseType_t uxSavedInterruptStatus;
+TaskHandle_t xTaskToWake = NULL;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	( void ) pvCallBackRef;
+
+	/* Clear the status before refilling the FIFO, so the FIFO emptying again
+	latches a new interrupt. */
+	ulStatus = uartconsoleREAD_REG( XUARTPS_ISR_OFFSET ) & uartconsoleREAD_REG( XUARTPS_IMR_OFFSET );
+	uartconsoleWRITE_REG( XUARTPS_ISR_OFFSET, ulStatus );
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		xStats.ulInterrupts++;
+
+		if( ( ulStatus & XUARTPS_IXR_TXEMPTY ) != 0U )
+		{
+			prvFillTxFIFO();
+		}
+
+		if( ( xWaitingWriter != NULL ) && ( prvSpaceAvailable() >= ( uint32_t ) uartconsoleWAKE_SPACE ) )
+		{
+			xTaskToWake = xWaitingWriter;
+			xWaitingWriter = NULL;
+		}
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xTaskToWake != NULL )
+	{
+		vTaskNotifyGiveFromISR( xTaskToWake, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
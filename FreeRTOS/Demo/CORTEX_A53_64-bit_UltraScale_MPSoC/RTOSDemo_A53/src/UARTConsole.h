@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef UART_CONSOLE_H
+#define UART_CONSOLE_H
+
+/*
+ * An interrupt driven transmit path for the UART used by xil_printf(), so
+ * tasks can write to the console without waiting for each character to be
+ * sent.  See UARTConsole.c.
+ */
+
+/* The size of the transmit ring buffer, in bytes.  Must be a power of two. */
+#ifndef uartconsoleTX_BUFFER_SIZE
+	#define uartconsoleTX_BUFFER_SIZE		4096
+#endif
+
+/* The longest message lUARTConsolePrintf() formats - longer messages are
+truncated.  The buffer is on the calling task's stack. */
+#ifndef uartconsoleMAX_MESSAGE_LENGTH
+	#define uartconsoleMAX_MESSAGE_LENGTH	160
+#endif
+
+/* Counters maintained by the console. */
+typedef struct UART_CONSOLE_STATS
+{
+	uint32_t ulBytesQueued;			/* Bytes copied into the ring buffer. */
+	uint32_t ulBytesDropped;		/* Bytes that were not copied into the ring buffer. */
+	uint32_t ulMessagesDropped;		/* Non-blocking writes that were dropped. */
+	uint32_t ulBytesSent;			/* Bytes written to the UART's transmit FIFO. */
+	uint32_t ulInterrupts;			/* UART interrupts taken. */
+	uint32_t ulWriterBlocks;		/* Times a blocking write waited for space. */
+	uint32_t ulHighWaterMark;		/* The most bytes held in the ring buffer. */
+} UARTConsoleStats_t;
+
+/*
+ * Take over transmission on the console UART and install its interrupt
+ * handler.  Must be called before the other functions, from main() or a task.
+ * Returns pdPASS if the console could be initialised.
+ */
+BaseType_t xUARTConsoleInit( void );
+
+/*
+ * Copy xLength bytes into the transmit ring buffer.  If xTicksToWait is 0 the
+ * bytes are either copied together or, if the buffer does not have space for
+ * all of them or another task's blocking write is in progress, dropped and
+ * counted, so the call never blocks.  Otherwise the calling task copies as
+ * much as fits, then waits for the UART to make more space, for up to
+ * xTicksToWait ticks in total.  Writes are serialised, so the bytes of one
+ * write are never mixed with those of another.  Must be called from a task.
+ *
+ * Returns the number of bytes copied.
+ */
+size_t xUARTConsoleWrite( const char *pcData, size_t xLength, TickType_t xTicksToWait );
+
+/*
+ * A printf() equivalent that never blocks - see xUARTConsoleWrite().  Returns
+ * the number of bytes queued, or 0 if the message was dropped.
+ */
+int lUARTConsolePrintf( const char *pcFormat, ... );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vUARTConsoleGetStats( UARTConsoleStats_t *pxStats );
+
+#endif /* UART_CONSOLE_H */
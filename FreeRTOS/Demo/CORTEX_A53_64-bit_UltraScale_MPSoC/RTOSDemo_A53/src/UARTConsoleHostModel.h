@@ -0,0 +1,181 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef UART_CONSOLE_HOST_MODEL_H
+#define UART_CONSOLE_HOST_MODEL_H
+
+/*
+ * A software model of the Cadence UART registers used by UARTConsole.c, used
+ * in place of the hardware when UARTConsole.c is built on a host with
+ * uartconsoleUSE_HOST_MODEL set to 1.  The register offsets and bits have the
+ * same values as in xuartps_hw.h.  Like the hardware, the interrupt status
+ * bits latch whether or not they are enabled in the mask, a write to a full
+ * transmit FIFO is lost, and the interrupt is level sensitive - it stays
+ * pending while an enabled status bit is set.
+ *
+ * The UART does not send anything until a host harness calls
+ * ulHostUARTModelShiftOut(), so the harness decides how fast the line runs
+ * relative to the writers.  It then calls bHostUARTModelRun() wherever it
+ * wants the interrupt to be taken.  Every byte written to the FIFO is kept
+ * in cCaptured[] so the output can be checked.  HostTest/UARTConsoleTest.c
+ * is such a harness.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define XUARTPS_IER_OFFSET		0x0008U
+#define XUARTPS_IDR_OFFSET		0x000CU
+#define XUARTPS_IMR_OFFSET		0x0010U
+#define XUARTPS_ISR_OFFSET		0x0014U
+#define XUARTPS_SR_OFFSET		0x002CU
+#define XUARTPS_FIFO_OFFSET		0x0030U
+
+#define XUARTPS_IXR_TXEMPTY		0x00000008U
+#define XUARTPS_IXR_MASK		0x00003FFFU
+#define XUARTPS_SR_TXFULL		0x00000010U
+#define XUARTPS_SR_TXEMPTY		0x00000008U
+
+#define uarthostFIFO_SIZE		64UL
+
+#ifndef uarthostCAPTURE_SIZE
+	#define uarthostCAPTURE_SIZE	( 1024UL * 1024UL )
+#endif
+
+typedef struct HostUARTModel
+{
+	uint32_t ulIMR;					/* Set through IER, cleared through IDR. */
+	uint32_t ulISR;					/* Latched status, cleared by writing 1s. */
+	uint32_t ulFIFOCount;
+	uint32_t ulFIFOOverflows;		/* Writes to a full FIFO. */
+	uint32_t ulCaptured;			/* Bytes written to the FIFO. */
+	char cCaptured[ uarthostCAPTURE_SIZE ];
+	void ( *pxHandler )( void *pvCallBackRef );
+} HostUARTModel_t;
+
+extern HostUARTModel_t xHostUARTModel;
+
+static inline uint32_t ulHostUARTModelRead( uint32_t ulOffset )
+{
+uint32_t ulValue = 0;
+
+	if( ulOffset == XUARTPS_IMR_OFFSET )
+	{
+		ulValue = xHostUARTModel.ulIMR;
+	}
+	else if( ulOffset == XUARTPS_ISR_OFFSET )
+	{
+		ulValue = xHostUARTModel.ulISR;
+	}
+	else if( ulOffset == XUARTPS_SR_OFFSET )
+	{
+		if( xHostUARTModel.ulFIFOCount == uarthostFIFO_SIZE )
+		{
+			ulValue |= XUARTPS_SR_TXFULL;
+		}
+
+		if( xHostUARTModel.ulFIFOCount == 0 )
+		{
+			ulValue |= XUARTPS_SR_TXEMPTY;
+		}
+	}
+
+	return ulValue;
+}
+
+static inline void vHostUARTModelWrite( uint32_t ulOffset, uint32_t ulValue )
+{
+	if( ulOffset == XUARTPS_IER_OFFSET )
+	{
+		xHostUARTModel.ulIMR |= ( ulValue & XUARTPS_IXR_MASK );
+	}
+	else if( ulOffset == XUARTPS_IDR_OFFSET )
+	{
+		xHostUARTModel.ulIMR &= ~ulValue;
+	}
+	else if( ulOffset == XUARTPS_ISR_OFFSET )
+	{
+		xHostUARTModel.ulISR &= ~ulValue;
+	}
+	else if( ulOffset == XUARTPS_FIFO_OFFSET )
+	{
+		if( xHostUARTModel.ulFIFOCount < uarthostFIFO_SIZE )
+		{
+			xHostUARTModel.cCaptured[ xHostUARTModel.ulCaptured % uarthostCAPTURE_SIZE ] = ( char ) ulValue;
+			xHostUARTModel.ulCaptured++;
+			xHostUARTModel.ulFIFOCount++;
+		}
+		else
+		{
+			xHostUARTModel.ulFIFOOverflows++;
+		}
+	}
+}
+
+/* Send up to ulBytes bytes from the transmit FIFO.  Latches the TX empty status
+if the FIFO becomes empty.  Returns the number of bytes sent. */
+static inline uint32_t ulHostUARTModelShiftOut( uint32_t ulBytes )
+{
+	if( ulBytes > xHostUARTModel.ulFIFOCount )
+	{
+		ulBytes = xHostUARTModel.ulFIFOCount;
+	}
+
+	if( ulBytes > 0 )
+	{
+		xHostUARTModel.ulFIFOCount -= ulBytes;
+
+		if( xHostUARTModel.ulFIFOCount == 0 )
+		{
+			xHostUARTModel.ulISR |= XUARTPS_IXR_TXEMPTY;
+		}
+	}
+
+	return ulBytes;
+}
+
+static inline void vHostUARTModelInstallHandler( void ( *pxHandler )( void *pvCallBackRef ) )
+{
+	xHostUARTModel.pxHandler = pxHandler;
+}
+
+/* Take the UART interrupt if it is pending.  Returns true if the handler
+ran. */
+static inline bool bHostUARTModelRun( void )
+{
+bool bHandled = false;
+
+	if( ( xHostUARTModel.pxHandler != NULL ) && ( ( xHostUARTModel.ulISR & xHostUARTModel.ulIMR ) != 0 ) )
+	{
+		xHostUARTModel.pxHandler( NULL );
+		bHandled = true;
+	}
+
+	return bHandled;
+}
+
+#endif /* UART_CONSOLE_HOST_MODEL_H */
@@ -0,0 +1,816 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An asynchronous scatter gather copy service built on the general purpose DMA
+ * controller (GDMA).  The service owns zdmacopyCHANNELS GDMA channels, each
+ * with its own queue of requests, and one task that runs them all.
+ *
+ * xZDMACopySubmit() cleans the request's sources and destinations from the
+ * data cache in the calling task, puts the request on the queue of the channel
+ * with the least work, and returns.  Whenever a channel is idle the service
+ * task takes requests from the channel's queue and chains their segments into
+ * one linked list of descriptors, up to zdmacopyLIST_LENGTH segments long - so
+ * a burst of small requests costs one start and one interrupt, and a request
+ * with more segments than fit in one list is spread over consecutive lists.
+ * The channel then works through the whole list without the CPU.  The
+ * interrupt at the end of the list wakes the service task, which invalidates
+ * the cache over the destinations, marks each request that finished in the
+ * list complete, notifies the tasks that submitted them, and starts the
+ * channel's next list.
+ *
+ * The GDMA is not coherent with the data cache, so the destination and length
+ * of each segment must be multiples of the cache line size (zdmacopyALIGNMENT)
+ * - then invalidating the destinations cannot discard data the CPU wrote next
+ * to them.  Sources can have any alignment.
+ *
+ * If a channel reports an error, every request with segments in its list
+ * fails, including a request only part of which was in the list, and the
+ * channel is reset before its next list.
+ *
+ * Building with zdmacopyUSE_HOST_MODEL set to 1 replaces the channels with the
+ * model in ZDMACopyHostModel.h, so the queueing and chaining can be tested on
+ * a host.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "ZDMACopy.h"
+
+/* Xilinx includes. */
+#include "xil_cache.h"
+
+#ifndef zdmacopyUSE_HOST_MODEL
+	#define zdmacopyUSE_HOST_MODEL		0
+#endif
+
+#if( zdmacopyUSE_HOST_MODEL == 1 )
+
+	#include "ZDMACopyHostModel.h"
+
+#else
+
+	/* Demo includes. */
+	#include "IRQDispatch.h"
+
+	/* Xilinx includes. */
+	#include "xzdma.h"
+	#include "xscugic.h"
+
+	/* The GDMA channels, which each have their own interrupt. */
+	#define zdmacopyGDMA_CHANNELS			8
+
+	/* The errors after which a channel stops, so no done interrupt follows. */
+	#define zdmacopyFATAL_ERRORS			( XZDMA_IXR_AXI_WR_DATA_MASK | XZDMA_IXR_AXI_RD_DATA_MASK | XZDMA_IXR_AXI_RD_DST_DSCR_MASK | XZDMA_IXR_AXI_RD_SRC_DSCR_MASK )
+
+	/* Only the end of each list, and the fatal errors, interrupt the CPU. */
+	#define zdmacopyINTERRUPTS				( XZDMA_IXR_DMA_DONE_MASK | zdmacopyFATAL_ERRORS )
+
+	#if( ( zdmacopyFIRST_CHANNEL + zdmacopyCHANNELS ) > zdmacopyGDMA_CHANNELS )
+		#error zdmacopyFIRST_CHANNEL and zdmacopyCHANNELS select channels the GDMA does not have.
+	#endif
+
+#endif /* zdmacopyUSE_HOST_MODEL */
+
+/* The most segments in one descriptor list.  Each segment uses a source and a
+destination descriptor, 64 bytes in all. */
+#ifndef zdmacopyLIST_LENGTH
+	#define zdmacopyLIST_LENGTH				32
+#endif
+
+/* The number of requests that can wait for each channel. */
+#ifndef zdmacopyQUEUE_LENGTH
+	#define zdmacopyQUEUE_LENGTH			8
+#endif
+
+/* The most ranges cleaned from the cache in one call when a request is
+submitted.  Sets the size of an array on the submitting task's stack. */
+#ifndef zdmacopyFLUSH_RANGES
+	#define zdmacopyFLUSH_RANGES			8
+#endif
+
+/* The task notification index used to tell a task that a request it submitted
+has completed.  As in TimerWheel.c the default uses the last index, so a task
+that submits requests must not use that index for anything else. */
+#ifndef zdmacopyNOTIFICATION_INDEX
+	#define zdmacopyNOTIFICATION_INDEX		( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#ifndef zdmacopyTASK_STACK_SIZE
+	#define zdmacopyTASK_STACK_SIZE			( configMINIMAL_STACK_SIZE * 2 )
+#endif
+
+/* The events sent to the service task, as bits in its notification value.
+Each channel has one bit, sent both when a request is queued while the channel
+is idle and when the channel reaches the end of its list. */
+#define zdmacopyEVENT_CHANNEL( uxChannel )	( 1UL << ( uint32_t ) ( uxChannel ) )
+#define zdmacopyALL_EVENTS					( ( 1UL << ( uint32_t ) zdmacopyCHANNELS ) - 1UL )
+
+#if( ( zdmacopyCHANNELS < 1 ) || ( zdmacopyCHANNELS > 31 ) )
+	#error zdmacopyCHANNELS must be between 1 and 31.
+#endif
+
+#if( zdmacopyFLUSH_RANGES < 2 )
+	#error zdmacopyFLUSH_RANGES must be at least 2.
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The state of one channel.  Only the service task accesses it, other than
+xBusy, which submitting tasks read, and xListStatus, which the interrupt
+writes. */
+typedef struct ZDMA_CHANNEL
+{
+	QueueHandle_t xQueue;										/* Requests waiting for the channel. */
+	ZDMACopyRequest_t *pxCarry;									/* A request taken from the queue that has segments not yet in a list. */
+	ZDMACopyRequest_t *pxListRequests[ zdmacopyLIST_LENGTH ];	/* The requests with segments in the current list, in order. */
+	UBaseType_t uxListRequests;
+	ZDMACopySegment_t xList[ zdmacopyLIST_LENGTH ];				/* The segments in the current list. */
+	UBaseType_t uxListLength;
+	Xil_CacheRange xDestinations[ zdmacopyLIST_LENGTH ];		/* Their destinations, with adjacent destinations merged. */
+	UBaseType_t uxDestinations;
+	volatile BaseType_t xBusy;									/* Set from when a list is started until it has been finished. */
+	volatile BaseType_t xListStatus;							/* How the current list ended, or zdmacopySTATUS_PENDING. */
+} ZDMAChannel_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the index of the channel with the fewest requests queued or
+ * running.
+ */
+static UBaseType_t prvSelectChannel( void );
+
+/*
+ * Clean the sources and destinations of a request's segments from the data
+ * cache.  Called from the submitting task.
+ */
+static void prvCleanSegments( const ZDMACopyRequest_t *pxRequest );
+
+/*
+ * Chain segments from the channel's queued requests into a descriptor list,
+ * and start the channel on it.  Called from the service task.
+ */
+static void prvStartList( UBaseType_t uxChannel );
+
+/*
+ * Invalidate the destinations of the list the channel has finished, and
+ * complete each request that has no segments left to copy.  Called from the
+ * service task.
+ */
+static void prvFinishList( UBaseType_t uxChannel );
+
+/*
+ * Set a channel's busy flag.
+ */
+static void prvSetBusy( ZDMAChannel_t *pxChannel, BaseType_t xBusy );
+
+/*
+ * Act on the events in ulEvents.
+ */
+static void prvProcessEvents( uint32_t ulEvents );
+
+/*
+ * The task that runs the channels.
+ */
+static void prvZDMACopyTask( void *pvParameters );
+
+/*
+ * Called from the interrupt when a channel reaches the end of its list, or
+ * stops because of an error.
+ */
+static void prvListEndedFromISR( UBaseType_t uxChannel, BaseType_t xSucceeded );
+
+/*
+ * Initialise the channels and install their interrupt handlers.
+ */
+static BaseType_t prvInitChannels( void );
+
+/*
+ * Start a channel on the segments in its xList[] array.  Returns pdFALSE if
+ * the channel could not be started.
+ */
+static BaseType_t prvStartChannel( UBaseType_t uxChannel );
+
+/*
+ * Return a channel that stopped with an error to a state in which it can be
+ * started again.
+ */
+static void prvResetChannel( UBaseType_t uxChannel );
+
+#if( zdmacopyUSE_HOST_MODEL == 0 )
+
+	/*
+	 * Called by XZDma_IntrHandler() when a channel reaches the end of its list
+	 * or reports an error.
+	 */
+	static void prvDoneHandler( void *pvCallBackRef );
+	static void prvErrorHandler( void *pvCallBackRef, u32 ulErrorMask );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+static ZDMAChannel_t xChannels[ zdmacopyCHANNELS ];
+
+static TaskHandle_t xServiceTask = NULL;
+
+static ZDMACopyStats_t xStats;
+
+#if( zdmacopyUSE_HOST_MODEL == 0 )
+
+	static const uint16_t usDeviceIDs[ zdmacopyGDMA_CHANNELS ] =
+	{
+		XPAR_PSU_GDMA_0_DEVICE_ID, XPAR_PSU_GDMA_1_DEVICE_ID, XPAR_PSU_GDMA_2_DEVICE_ID, XPAR_PSU_GDMA_3_DEVICE_ID,
+		XPAR_PSU_GDMA_4_DEVICE_ID, XPAR_PSU_GDMA_5_DEVICE_ID, XPAR_PSU_GDMA_6_DEVICE_ID, XPAR_PSU_GDMA_7_DEVICE_ID
+	};
+
+	static const uint32_t ulInterruptIDs[ zdmacopyGDMA_CHANNELS ] =
+	{
+		XPAR_PSU_GDMA_0_INTR, XPAR_PSU_GDMA_1_INTR, XPAR_PSU_GDMA_2_INTR, XPAR_PSU_GDMA_3_INTR,
+		XPAR_PSU_GDMA_4_INTR, XPAR_PSU_GDMA_5_INTR, XPAR_PSU_GDMA_6_INTR, XPAR_PSU_GDMA_7_INTR
+	};
+
+	static XZDma xDMAInstances[ zdmacopyCHANNELS ];
+
+	/* The list of transfers passed to XZDma_Start(), which writes it into the
+	descriptors. */
+	static XZDma_Transfer xTransfers[ zdmacopyCHANNELS ][ zdmacopyLIST_LENGTH ];
+
+	/* The source descriptors of each channel, followed by its destination
+	descriptors. */
+	static XZDma_LlDscr xDescriptors[ zdmacopyCHANNELS ][ zdmacopyLIST_LENGTH * 2 ] __attribute__( ( aligned( 64 ) ) );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xZDMACopyInit( UBaseType_t uxPriority )
+{
+BaseType_t xReturn = pdPASS;
+UBaseType_t uxChannel;
+
+	configASSERT( xServiceTask == NULL );
+
+	for( uxChannel = 0; uxChannel < ( UBaseType_t ) zdmacopyCHANNELS; uxChannel++ )
+	{
+		xChannels[ uxChannel ].xQueue = xQueueCreate( zdmacopyQUEUE_LENGTH, sizeof( ZDMACopyRequest_t * ) );
+		xChannels[ uxChannel ].xListStatus = zdmacopySTATUS_COMPLETE;
+
+		if( xChannels[ uxChannel ].xQueue == NULL )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	if( xReturn == pdPASS )
+	{
+		xReturn = prvInitChannels();
+	}
+
+	if( xReturn == pdPASS )
+	{
+		xReturn = xTaskCreate( prvZDMACopyTask, "ZDMA", zdmacopyTASK_STACK_SIZE, NULL, uxPriority, &xServiceTask );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xZDMACopySubmit( ZDMACopyRequest_t *pxRequest, TickType_t xTicksToWait )
+{
+const ZDMACopySegment_t *pxSegment;
+ZDMAChannel_t *pxChannel;
+UBaseType_t uxChannel, ux;
+BaseType_t xReturn = pdPASS, xIdle;
+
+	configASSERT( xServiceTask );
+	configASSERT( pxRequest );
+
+	/* The completion is sent to the submitting task. */
+	configASSERT( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING );
+
+	for( ux = 0; ux < pxRequest->uxNumberOfSegments; ux++ )
+	{
+		pxSegment = &( pxRequest->pxSegments[ ux ] );
+
+		if( ( pxSegment->pvDestination == NULL ) || ( pxSegment->pvSource == NULL ) ||
+			( pxSegment->xLength == 0 ) || ( pxSegment->xLength > ( size_t ) zdmacopyMAX_SEGMENT_LENGTH ) ||
+			( ( pxSegment->xLength % zdmacopyALIGNMENT ) != 0 ) ||
+			( ( ( UINTPTR ) pxSegment->pvDestination % zdmacopyALIGNMENT ) != 0 ) )
+		{
+			xReturn = pdFAIL;
+			break;
+		}
+	}
+
+	pxRequest->xRequestingTask = xTaskGetCurrentTaskHandle();
+	pxRequest->uxSegmentsIssued = 0;
+
+	if( xReturn != pdPASS )
+	{
+		pxRequest->xStatus = zdmacopySTATUS_FAILED;
+	}
+	else if( pxRequest->uxNumberOfSegments == 0 )
+	{
+		pxRequest->xStatus = zdmacopySTATUS_COMPLETE;
+	}
+	else
+	{
+		pxRequest->xStatus = zdmacopySTATUS_PENDING;
+		prvCleanSegments( pxRequest );
+
+		uxChannel = prvSelectChannel();
+		pxChannel = &( xChannels[ uxChannel ] );
+
+		if( xQueueSendToBack( pxChannel->xQueue, &pxRequest, xTicksToWait ) != pdPASS )
+		{
+			pxRequest->xStatus = zdmacopySTATUS_FAILED;
+			xReturn = pdFAIL;
+		}
+		else
+		{
+			/* A busy channel takes the request from its queue when it finishes
+			its current list, so the service task is only woken for an idle
+			channel.  The flag is read in a critical section, as the service
+			task clears it in one before it looks at the queue. */
+			taskENTER_CRITICAL();
+			{
+				xIdle = ( pxChannel->xBusy == pdFALSE ) ? pdTRUE : pdFALSE;
+			}
+			taskEXIT_CRITICAL();
+
+			if( xIdle != pdFALSE )
+			{
+				( void ) xTaskNotify( xServiceTask, zdmacopyEVENT_CHANNEL( uxChannel ), eSetBits );
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xZDMACopyWait( ZDMACopyRequest_t *pxRequest, TickType_t xTicksToWait )
+{
+TimeOut_t xTimeOut;
+
+	configASSERT( pxRequest );
+	configASSERT( pxRequest->xRequestingTask == xTaskGetCurrentTaskHandle() );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	/* The notification that wakes the task may be left over from another
+	request that completed before it was waited for, so the state is checked
+	each time the task wakes. */
+	while( ( pxRequest->xStatus == zdmacopySTATUS_PENDING ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) )
+	{
+		( void ) ulTaskNotifyTakeIndexed( zdmacopyNOTIFICATION_INDEX, pdFALSE, xTicksToWait );
+	}
+
+	return pxRequest->xStatus;
+}
+/*-----------------------------------------------------------*/
+
+void vZDMACopyGetStats( ZDMACopyStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvSelectChannel( void )
+{
+UBaseType_t uxChannel, uxLoad, uxBestLoad = ~( ( UBaseType_t ) 0 ), uxBest = 0;
+
+	/* The busy flags are read without a lock, as the choice only has to be a
+	good one, not an exact one. */
+	for( uxChannel = 0; uxChannel < ( UBaseType_t ) zdmacopyCHANNELS; uxChannel++ )
+	{
+		uxLoad = uxQueueMessagesWaiting( xChannels[ uxChannel ].xQueue );
+
+		if( xChannels[ uxChannel ].xBusy != pdFALSE )
+		{
+			uxLoad++;
+		}
+
+		if( uxLoad < uxBestLoad )
+		{
+			uxBestLoad = uxLoad;
+			uxBest = uxChannel;
+		}
+	}
+
+	return uxBest;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCleanSegments( const ZDMACopyRequest_t *pxRequest )
+{
+Xil_CacheRange xRanges[ zdmacopyFLUSH_RANGES ];
+const ZDMACopySegment_t *pxSegment;
+UBaseType_t ux;
+u32 ulRanges = 0;
+
+	/* Write any of the sources held in the cache out to memory, where the
+	channel will read them, and write back any dirty lines in the
+	destinations, so they cannot be evicted over the data the channel writes.
+	The ranges are cleaned zdmacopyFLUSH_RANGES at a time, so they share
+	barriers. */
+	for( ux = 0; ux < pxRequest->uxNumberOfSegments; ux++ )
+	{
+		pxSegment = &( pxRequest->pxSegments[ ux ] );
+
+		xRanges[ ulRanges ].Addr = ( INTPTR ) pxSegment->pvSource;
+		xRanges[ ulRanges ].Len = ( INTPTR ) pxSegment->xLength;
+		xRanges[ ulRanges + 1U ].Addr = ( INTPTR ) pxSegment->pvDestination;
+		xRanges[ ulRanges + 1U ].Len = ( INTPTR ) pxSegment->xLength;
+		ulRanges += 2U;
+
+		if( ( ulRanges + 2U ) > ( u32 ) zdmacopyFLUSH_RANGES )
+		{
+			Xil_DCacheFlushRanges( xRanges, ulRanges );
+			ulRanges = 0;
+		}
+	}
+
+	if( ulRanges > 0 )
+	{
+		Xil_DCacheFlushRanges( xRanges, ulRanges );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartList( UBaseType_t uxChannel )
+{
+ZDMAChannel_t * const pxChannel = &( xChannels[ uxChannel ] );
+ZDMACopyRequest_t *pxRequest;
+const ZDMACopySegment_t *pxSegment;
+Xil_CacheRange *pxRange = NULL;
+
+	pxChannel->uxListRequests = 0;
+	pxChannel->uxListLength = 0;
+	pxChannel->uxDestinations = 0;
+
+	while( pxChannel->uxListLength < ( UBaseType_t ) zdmacopyLIST_LENGTH )
+	{
+		/* The rest of a request that did not fit in the last list goes
+		first. */
+		if( ( pxChannel->pxCarry == NULL ) && ( xQueueReceive( pxChannel->xQueue, &( pxChannel->pxCarry ), 0 ) != pdPASS ) )
+		{
+			break;
+		}
+
+		pxRequest = pxChannel->pxCarry;
+		pxChannel->pxListRequests[ pxChannel->uxListRequests++ ] = pxRequest;
+
+		while( ( pxRequest->uxSegmentsIssued < pxRequest->uxNumberOfSegments ) && ( pxChannel->uxListLength < ( UBaseType_t ) zdmacopyLIST_LENGTH ) )
+		{
+			pxSegment = &( pxRequest->pxSegments[ pxRequest->uxSegmentsIssued ] );
+			pxRequest->uxSegmentsIssued++;
+			pxChannel->xList[ pxChannel->uxListLength++ ] = *pxSegment;
+
+			/* Segments that fill a buffer piece by piece are invalidated as
+			one range. */
+			if( ( pxRange != NULL ) && ( ( pxRange->Addr + pxRange->Len ) == ( INTPTR ) pxSegment->pvDestination ) )
+			{
+				pxRange->Len += ( INTPTR ) pxSegment->xLength;
+			}
+			else
+			{
+				pxRange = &( pxChannel->xDestinations[ pxChannel->uxDestinations++ ] );
+				pxRange->Addr = ( INTPTR ) pxSegment->pvDestination;
+				pxRange->Len = ( INTPTR ) pxSegment->xLength;
+			}
+		}
+
+		if( pxRequest->uxSegmentsIssued == pxRequest->uxNumberOfSegments )
+		{
+			pxChannel->pxCarry = NULL;
+		}
+	}
+
+	if( pxChannel->uxListLength > 0 )
+	{
+		pxChannel->xListStatus = zdmacopySTATUS_PENDING;
+		prvSetBusy( pxChannel, pdTRUE );
+
+		if( prvStartChannel( uxChannel ) == pdFALSE )
+		{
+			/* Finish the list, as failed, the next time the task runs. */
+			pxChannel->xListStatus = zdmacopySTATUS_FAILED;
+			( void ) xTaskNotify( xServiceTask, zdmacopyEVENT_CHANNEL( uxChannel ), eSetBits );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinishList( UBaseType_t uxChannel )
+{
+ZDMAChannel_t * const pxChannel = &( xChannels[ uxChannel ] );
+const BaseType_t xListStatus = pxChannel->xListStatus;
+ZDMACopyRequest_t *pxRequest;
+TaskHandle_t xTask;
+UBaseType_t ux, uxCompleted = 0;
+uint64_t ullBytes = 0;
+
+	/* Discard any lines the CPU speculatively loaded from the destinations
+	while the channel was writing them.  The destinations are cache line
+	aligned, so nothing else is lost.  Done even if the list failed, as the
+	channel may have written some of them. */
+	Xil_DCacheInvalidateRanges( pxChannel->xDestinations, ( u32 ) pxChannel->uxDestinations );
+
+	if( xListStatus != zdmacopySTATUS_COMPLETE )
+	{
+		prvResetChannel( uxChannel );
+
+		/* The rest of a request that was only partly in the list is not
+		copied - the request fails with the rest of the list. */
+		pxChannel->pxCarry = NULL;
+	}
+
+	for( ux = 0; ux < pxChannel->uxListLength; ux++ )
+	{
+		ullBytes += ( uint64_t ) pxChannel->xList[ ux ].xLength;
+	}
+
+	for( ux = 0; ux < pxChannel->uxListRequests; ux++ )
+	{
+		pxRequest = pxChannel->pxListRequests[ ux ];
+
+		/* A request with segments still to go in the next list is not
+		finished yet. */
+		if( pxRequest != pxChannel->pxCarry )
+		{
+			/* The request belongs to the task again as soon as its state
+			changes, so the task handle is read first. */
+			xTask = pxRequest->xRequestingTask;
+			pxRequest->xStatus = xListStatus;
+			( void ) xTaskNotifyGiveIndexed( xTask, zdmacopyNOTIFICATION_INDEX );
+			uxCompleted++;
+		}
+	}
+
+	taskENTER_CRITICAL();
+	{
+		xStats.ulRequests += ( uint32_t ) uxCompleted;
+		xStats.ulChainedRequests += ( uint32_t ) ( pxChannel->uxListRequests - 1 );
+		xStats.ulLists++;
+
+		if( xListStatus == zdmacopySTATUS_COMPLETE )
+		{
+			xStats.ulSegments += ( uint32_t ) pxChannel->uxListLength;
+			xStats.ullBytes += ullBytes;
+		}
+		else
+		{
+			xStats.ulFailedRequests += ( uint32_t ) uxCompleted;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetBusy( ZDMAChannel_t *pxChannel, BaseType_t xBusy )
+{
+	taskENTER_CRITICAL();
+	{
+		pxChannel->xBusy = xBusy;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessEvents( uint32_t ulEvents )
+{
+ZDMAChannel_t *pxChannel;
+UBaseType_t uxChannel;
+
+	for( uxChannel = 0; uxChannel < ( UBaseType_t ) zdmacopyCHANNELS; uxChannel++ )
+	{
+		if( ( ulEvents & zdmacopyEVENT_CHANNEL( uxChannel ) ) != 0 )
+		{
+			pxChannel = &( xChannels[ uxChannel ] );
+
+			if( ( pxChannel->xBusy != pdFALSE ) && ( pxChannel->xListStatus != zdmacopySTATUS_PENDING ) )
+			{
+				prvFinishList( uxChannel );
+
+				/* Cleared before the queue is looked at - see
+				xZDMACopySubmit(). */
+				prvSetBusy( pxChannel, pdFALSE );
+			}
+
+			if( pxChannel->xBusy == pdFALSE )
+			{
+				prvStartList( uxChannel );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvZDMACopyTask( void *pvParameters )
+{
+uint32_t ulEvents;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) xTaskNotifyWait( 0, zdmacopyALL_EVENTS, &ulEvents, portMAX_DELAY );
+		prvProcessEvents( ulEvents );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvListEndedFromISR( UBaseType_t uxChannel, BaseType_t xSucceeded )
+{
+ZDMAChannel_t * const pxChannel = &( xChannels[ uxChannel ] );
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* A list that ends with both an error and a done interrupt is only
+	reported once. */
+	if( pxChannel->xListStatus == zdmacopySTATUS_PENDING )
+	{
+		pxChannel->xListStatus = ( xSucceeded != pdFALSE ) ? zdmacopySTATUS_COMPLETE : zdmacopySTATUS_FAILED;
+		( void ) xTaskNotifyFromISR( xServiceTask, zdmacopyEVENT_CHANNEL( uxChannel ), eSetBits, &xHigherPriorityTaskWoken );
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+#if( zdmacopyUSE_HOST_MODEL == 1 )
+
+	static BaseType_t prvInitChannels( void )
+	{
+		vHostZDMAModelInit( prvListEndedFromISR );
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvStartChannel( UBaseType_t uxChannel )
+	{
+	ZDMAChannel_t * const pxChannel = &( xChannels[ uxChannel ] );
+
+		return ( bHostZDMAModelStart( uxChannel, pxChannel->xList, pxChannel->uxListLength ) != false ) ? pdTRUE : pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetChannel( UBaseType_t uxChannel )
+	{
+		/* A model channel is ready to start again as soon as it stops. */
+		( void ) uxChannel;
+	}
+	/*-----------------------------------------------------------*/
+
+#else
+
+	static BaseType_t prvInitChannels( void )
+	{
+	extern XScuGic xInterruptController;
+	XZDma_Config *pxConfig;
+	XZDma *pxInstance;
+	UBaseType_t uxChannel;
+	uint32_t ulInterruptID;
+	BaseType_t xReturn = pdPASS;
+	const uint8_t ucRisingEdge = 3;
+
+		for( uxChannel = 0; ( uxChannel < ( UBaseType_t ) zdmacopyCHANNELS ) && ( xReturn == pdPASS ); uxChannel++ )
+		{
+			pxInstance = &( xDMAInstances[ uxChannel ] );
+			pxConfig = XZDma_LookupConfig( usDeviceIDs[ zdmacopyFIRST_CHANNEL + uxChannel ] );
+			ulInterruptID = ulInterruptIDs[ zdmacopyFIRST_CHANNEL + uxChannel ];
+			xReturn = pdFAIL;
+
+			/* Each channel runs linked lists of descriptors, in the memory set
+			aside for it. */
+			if( ( pxConfig != NULL ) &&
+				( XZDma_CfgInitialize( pxInstance, pxConfig, pxConfig->BaseAddress ) == XST_SUCCESS ) &&
+				( XZDma_SetMode( pxInstance, TRUE, XZDMA_NORMAL_MODE ) == XST_SUCCESS ) &&
+				( XZDma_CreateBDList( pxInstance, XZDMA_LINKEDLIST, ( UINTPTR ) xDescriptors[ uxChannel ], sizeof( xDescriptors[ uxChannel ] ) ) == zdmacopyLIST_LENGTH ) )
+			{
+				XZDma_SetCallBack( pxInstance, XZDMA_HANDLER_DONE, ( void * ) prvDoneHandler, ( void * ) uxChannel );
+				XZDma_SetCallBack( pxInstance, XZDMA_HANDLER_ERROR, ( void * ) prvErrorHandler, ( void * ) uxChannel );
+
+				/* The interrupt calls FreeRTOS API functions, so must be at or
+				below the maximum API call interrupt priority. */
+				XScuGic_SetPriorityTriggerType( &xInterruptController, ulInterruptID, configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT, ucRisingEdge );
+
+				if( XScuGic_Connect( &xInterruptController, ulInterruptID, ( Xil_InterruptHandler ) XZDma_IntrHandler, ( void * ) pxInstance ) == XST_SUCCESS )
+				{
+					vIRQDispatchUpdate( ulInterruptID );
+					XScuGic_Enable( &xInterruptController, ulInterruptID );
+					xReturn = pdPASS;
+				}
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvStartChannel( UBaseType_t uxChannel )
+	{
+	ZDMAChannel_t * const pxChannel = &( xChannels[ uxChannel ] );
+	XZDma * const pxInstance = &( xDMAInstances[ uxChannel ] );
+	XZDma_Transfer * const pxTransfers = xTransfers[ uxChannel ];
+	UBaseType_t ux;
+	BaseType_t xReturn = pdFALSE;
+
+		for( ux = 0; ux < pxChannel->uxListLength; ux++ )
+		{
+			pxTransfers[ ux ].SrcAddr = ( UINTPTR ) pxChannel->xList[ ux ].pvSource;
+			pxTransfers[ ux ].DstAddr = ( UINTPTR ) pxChannel->xList[ ux ].pvDestination;
+			pxTransfers[ ux ].Size = ( u32 ) pxChannel->xList[ ux ].xLength;
+			pxTransfers[ ux ].SrcCoherent = 0;
+			pxTransfers[ ux ].DstCoherent = 0;
+			pxTransfers[ ux ].Pause = 0;
+		}
+
+		/* XZDma_IntrHandler() disables the channel's interrupts each time a
+		list ends.  XZDma_Start() writes the list into the descriptors, and
+		cleans each from the cache, before starting the channel. */
+		XZDma_EnableIntr( pxInstance, zdmacopyINTERRUPTS );
+
+		if( XZDma_Start( pxInstance, pxTransfers, ( u32 ) pxChannel->uxListLength ) == XST_SUCCESS )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			XZDma_DisableIntr( pxInstance, XZDMA_IXR_ALL_INTR_MASK );
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetChannel( UBaseType_t uxChannel )
+	{
+	XZDma * const pxInstance = &( xDMAInstances[ uxChannel ] );
+
+		/* XZDma_Reset() also returns the channel to simple mode.  The driver
+		marks a channel idle when it stops with an error. */
+		if( pxInstance->ChannelState == XZDMA_IDLE )
+		{
+			XZDma_Reset( pxInstance );
+			( void ) XZDma_SetMode( pxInstance, TRUE, XZDMA_NORMAL_MODE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvDoneHandler( void *pvCallBackRef )
+	{
+		prvListEndedFromISR( ( UBaseType_t ) pvCallBackRef, pdTRUE );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvErrorHandler( void *pvCallBackRef, u32 ulErrorMask )
+	{
+	UBaseType_t uxChannel = ( UBaseType_t ) pvCallBackRef;
+
+		/* Other errors are counter overflows and the like, after which the
+		list continues to the done interrupt. */
+		if( ( ulErrorMask & zdmacopyFATAL_ERRORS ) != 0U )
+		{
+			XZDma_DisableIntr( &( xDMAInstances[ uxChannel ] ), XZDMA_IXR_ALL_INTR_MASK );
+			prvListEndedFromISR( uxChannel, pdFALSE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* zdmacopyUSE_HOST_MODEL */
@@ -0,0 +1,130 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef ZDMA_COPY_H
+#define ZDMA_COPY_H
+
+/*
+ * An asynchronous scatter gather copy service built on the general purpose DMA
+ * controller (GDMA) channels, driven through the zdma driver in linked list
+ * mode.  Any task can submit a request to copy a list of segments, then carry
+ * on and wait for the request to complete later.  See ZDMACopy.c.
+ */
+
+/* The GDMA channels the service owns - zdmacopyCHANNELS channels starting at
+zdmacopyFIRST_CHANNEL.  The DMA copy service (DMACopy.c) uses the first
+dmacopyMAX_CHANNELS channels, so by default the two services can be used
+together. */
+#ifndef zdmacopyFIRST_CHANNEL
+	#define zdmacopyFIRST_CHANNEL			2
+#endif
+
+#ifndef zdmacopyCHANNELS
+	#define zdmacopyCHANNELS				6
+#endif
+
+/* The destination of each segment, and the length of each segment, must be a
+multiple of this, as the GDMA is not coherent with the data cache - see
+ZDMACopy.c. */
+#define zdmacopyALIGNMENT					64U
+
+/* The longest segment a descriptor can describe. */
+#define zdmacopyMAX_SEGMENT_LENGTH			( 0x3FFFFFFFUL )
+
+/* The states of a request. */
+#define zdmacopySTATUS_PENDING				( ( BaseType_t ) 0 )
+#define zdmacopySTATUS_COMPLETE				( ( BaseType_t ) 1 )
+#define zdmacopySTATUS_FAILED				( ( BaseType_t ) 2 )
+
+/* One contiguous block to copy.  The source and destination must not
+overlap. */
+typedef struct ZDMA_COPY_SEGMENT
+{
+	void *pvDestination;
+	const void *pvSource;
+	size_t xLength;
+} ZDMACopySegment_t;
+
+/* A request to copy uxNumberOfSegments segments, in order.  The request, the
+segment array and the buffers belong to the service from when the request is
+submitted until it is no longer zdmacopySTATUS_PENDING. */
+typedef struct ZDMA_COPY_REQUEST
+{
+	const ZDMACopySegment_t *pxSegments;
+	UBaseType_t uxNumberOfSegments;
+
+	/* Private to the service. */
+	TaskHandle_t xRequestingTask;
+	UBaseType_t uxSegmentsIssued;
+	volatile BaseType_t xStatus;
+} ZDMACopyRequest_t;
+
+/* Counters maintained by the service. */
+typedef struct ZDMA_COPY_STATS
+{
+	uint32_t ulRequests;			/* Requests completed, including those that failed. */
+	uint32_t ulFailedRequests;		/* Requests the DMA engine reported an error for. */
+	uint32_t ulChainedRequests;		/* Requests that shared a descriptor list with an earlier request. */
+	uint32_t ulSegments;			/* Segments copied. */
+	uint32_t ulLists;				/* Descriptor lists run. */
+	uint64_t ullBytes;				/* Bytes copied. */
+} ZDMACopyStats_t;
+
+/*
+ * Initialise the channels and start the task that runs them at priority
+ * uxPriority.  Must be called once, from main() or a task, before the other
+ * functions.  Returns pdPASS if the service was started.
+ */
+BaseType_t xZDMACopyInit( UBaseType_t uxPriority );
+
+/*
+ * Queue pxRequest on the least busy channel, waiting up to xTicksToWait ticks
+ * for space in the channel's queue, and return without waiting for the copy.
+ * Requests queued on the same channel are copied in the order they were
+ * submitted, but requests can complete in any order.  Must only be called from
+ * a task, once the scheduler has started.
+ *
+ * Returns pdPASS if the request was queued (or had no segments, in which case
+ * it is already complete), or pdFAIL if it was not queued because a segment
+ * breaks the rules above or the queue stayed full.
+ */
+BaseType_t xZDMACopySubmit( ZDMACopyRequest_t *pxRequest, TickType_t xTicksToWait );
+
+/*
+ * Wait up to xTicksToWait ticks for a request submitted by the calling task to
+ * complete, and return its state.  Each completed request gives the task that
+ * submitted it a notification at index zdmacopyNOTIFICATION_INDEX - see
+ * ZDMACopy.c.
+ */
+BaseType_t xZDMACopyWait( ZDMACopyRequest_t *pxRequest, TickType_t xTicksToWait );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vZDMACopyGetStats( ZDMACopyStats_t *pxStats );
+
+#endif /* ZDMA_COPY_H */
@@ -0,0 +1,123 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef ZDMA_COPY_HOST_MODEL_H
+#define ZDMA_COPY_HOST_MODEL_H
+
+/*
+ * A software model of the GDMA channels used by ZDMACopy.c, used in place of
+ * the hardware when ZDMACopy.c is built on a host with zdmacopyUSE_HOST_MODEL
+ * set to 1.  Like a channel in linked list mode, each model channel is given a
+ * whole list of segments at once, refuses a new list while it is running one,
+ * and raises its interrupt when it reaches the end of the list.
+ *
+ * Nothing is copied until a host harness calls bHostZDMAModelComplete(), so
+ * the harness decides when each channel finishes, relative to the tasks and
+ * to the other channels, and whether it finishes with an error.
+ *
+ * HostTest/ZDMACopyTest.c is such a harness.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct HostZDMAModel
+{
+	const ZDMACopySegment_t *pxList[ zdmacopyCHANNELS ];
+	UBaseType_t uxListLength[ zdmacopyCHANNELS ];
+	bool bRunning[ zdmacopyCHANNELS ];
+	uint32_t ulListsStarted;
+	uint32_t ulLongestList;
+	void ( *pxHandler )( UBaseType_t uxChannel, BaseType_t xSucceeded );
+} HostZDMAModel_t;
+
+extern HostZDMAModel_t xHostZDMAModel;
+
+static inline void vHostZDMAModelInit( void ( *pxHandler )( UBaseType_t uxChannel, BaseType_t xSucceeded ) )
+{
+	memset( &xHostZDMAModel, 0x00, sizeof( xHostZDMAModel ) );
+	xHostZDMAModel.pxHandler = pxHandler;
+}
+
+/* Start a channel on a list of uxLength segments.  Returns false if the
+channel is already running a list. */
+static inline bool bHostZDMAModelStart( UBaseType_t uxChannel, const ZDMACopySegment_t *pxList, UBaseType_t uxLength )
+{
+bool bStarted = false;
+
+	if( xHostZDMAModel.bRunning[ uxChannel ] == false )
+	{
+		xHostZDMAModel.pxList[ uxChannel ] = pxList;
+		xHostZDMAModel.uxListLength[ uxChannel ] = uxLength;
+		xHostZDMAModel.bRunning[ uxChannel ] = true;
+		xHostZDMAModel.ulListsStarted++;
+
+		if( uxLength > xHostZDMAModel.ulLongestList )
+		{
+			xHostZDMAModel.ulLongestList = ( uint32_t ) uxLength;
+		}
+
+		bStarted = true;
+	}
+
+	return bStarted;
+}
+
+static inline bool bHostZDMAModelRunning( UBaseType_t uxChannel )
+{
+	return xHostZDMAModel.bRunning[ uxChannel ];
+}
+
+/* Finish the list a channel is running and take its interrupt.  With bError
+set the channel stops after the first segment, as after an AXI error.  Returns
+false if the channel was not running a list. */
+static inline bool bHostZDMAModelComplete( UBaseType_t uxChannel, bool bError )
+{
+const ZDMACopySegment_t *pxSegment;
+UBaseType_t ux, uxCopied;
+bool bCompleted = false;
+
+	if( xHostZDMAModel.bRunning[ uxChannel ] != false )
+	{
+		uxCopied = ( bError != false ) ? 1 : xHostZDMAModel.uxListLength[ uxChannel ];
+
+		for( ux = 0; ux < uxCopied; ux++ )
+		{
+			pxSegment = &( xHostZDMAModel.pxList[ uxChannel ][ ux ] );
+			memcpy( pxSegment->pvDestination, pxSegment->pvSource, pxSegment->xLength );
+		}
+
+		xHostZDMAModel.bRunning[ uxChannel ] = false;
+		xHostZDMAModel.pxHandler( uxChannel, ( bError != false ) ? pdFALSE : pdTRUE );
+		bCompleted = true;
+	}
+
+	return bCompleted;
+}
+
+#endif /* ZDMA_COPY_HOST_MODEL_H */
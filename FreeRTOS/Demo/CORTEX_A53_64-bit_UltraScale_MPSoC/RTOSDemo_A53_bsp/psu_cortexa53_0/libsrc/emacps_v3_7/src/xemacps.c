@@ -361,7 +361,7 @@ void XEmacPs_Reset(XEmacPs *InstancePtr)
 	if (InstancePtr->Version > 2) {
 		XEmacPs_WriteReg(InstancePtr->Config.BaseAddress, XEMACPS_DMACR_OFFSET,
 			(XEmacPs_ReadReg(InstancePtr->Config.BaseAddress, XEMACPS_DMACR_OFFSET) |
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 			(u32)XEMACPS_DMACR_ADDR_WIDTH_64 |
 #endif
 			(u32)XEMACPS_DMACR_INCR16_AHB_BURST));
@@ -475,7 +475,7 @@ void XEmacPs_SetQueuePtr(XEmacPs *InstancePtr, UINTPTR QPtr, u8 QueueNum,
 			XEMACPS_TXQ1BASE_OFFSET,
 			(QPtr & ULONG64_LO_MASK));
 	}
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 	if (Direction == XEMACPS_SEND) {
 		/* Set the MSB of TX Queue start address */
 		XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
@@ -87,11 +87,12 @@ extern "C" {
 #include <string.h>
 #include "xil_types.h"
 #include "xil_assert.h"
+#include "xemacps_hw.h"
 
 /************************** Constant Definitions *****************************/
 
 /**************************** Type Definitions *******************************/
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 /* Minimum BD alignment */
 #define XEMACPS_DMABD_MINIMUM_ALIGNMENT  64U
 #define XEMACPS_BD_NUM_WORDS 4U
@@ -175,7 +176,7 @@ typedef u32 XEmacPs_Bd[XEMACPS_BD_NUM_WORDS];
  *    void XEmacPs_BdSetAddressTx(XEmacPs_Bd* BdPtr, UINTPTR Addr)
  *
  *****************************************************************************/
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 #define XEmacPs_BdSetAddressTx(BdPtr, Addr)                        \
     XEmacPs_BdWrite((BdPtr), XEMACPS_BD_ADDR_OFFSET,		\
 			(u32)((Addr) & ULONG64_LO_MASK));		\
@@ -200,7 +201,7 @@ typedef u32 XEmacPs_Bd[XEMACPS_BD_NUM_WORDS];
  *    void XEmacPs_BdSetAddressRx(XEmacPs_Bd* BdPtr, UINTPTR Addr)
  *
  *****************************************************************************/
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 #define XEmacPs_BdSetAddressRx(BdPtr, Addr)                        \
     XEmacPs_BdWrite((BdPtr), XEMACPS_BD_ADDR_OFFSET,              \
     ((XEmacPs_BdRead((BdPtr), XEMACPS_BD_ADDR_OFFSET) &           \
@@ -261,7 +262,7 @@ typedef u32 XEmacPs_Bd[XEMACPS_BD_NUM_WORDS];
  *    UINTPTR XEmacPs_BdGetBufAddr(XEmacPs_Bd* BdPtr)
  *
  *****************************************************************************/
-#ifdef __aarch64__
+#ifdef XEMACPS_BD_ADDR64
 #define XEmacPs_BdGetBufAddr(BdPtr)                               \
     (XEmacPs_BdRead((BdPtr), XEMACPS_BD_ADDR_OFFSET) |		  \
 	(XEmacPs_BdRead((BdPtr), XEMACPS_BD_ADDR_HI_OFFSET)) << 32U)
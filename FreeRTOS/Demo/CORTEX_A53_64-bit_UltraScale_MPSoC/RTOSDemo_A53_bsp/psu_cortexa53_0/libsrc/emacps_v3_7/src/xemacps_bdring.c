@@ -67,12 +67,23 @@
 
 #include "xstatus.h"
 #include "xil_cache.h"
+#include "xpseudo_asm.h"
 #include "xemacps_hw.h"
 #include "xemacps_bd.h"
 #include "xemacps_bdring.h"
 
 /************************** Constant Definitions *****************************/
 
+/*
+ * The number of cache ranges XEmacPs_BdRingFromHwRxBatch() collects before
+ * invalidating them. Buffers that are contiguous in memory share one range, so
+ * this is the number of separate runs of buffers invalidated per call to
+ * Xil_DCacheInvalidateRanges().
+ */
+#ifndef XEMACPS_BD_BATCH_RANGES
+#define XEMACPS_BD_BATCH_RANGES 16U
+#endif
+
 /**************************** Type Definitions *******************************/
 
 
@@ -865,6 +876,291 @@ u32 XEmacPs_BdRingFromHwRx(XEmacPs_BdRing * RingPtr, u32 BdLimit,
 }
 
 
+/*****************************************************************************/
+/**
+ * Read the buffer address of a BD. On 64-bit targets the address is split
+ * across two words of the BD.
+ *
+ * @param BdPtr is the BD to read.
+ * @param AddrMask masks the status bits out of the low word of the address.
+ *
+ * @return The address of the BD's buffer.
+ *
+ *****************************************************************************/
+static INLINE UINTPTR XEmacPs_BdReadBufAddr(XEmacPs_Bd * BdPtr, u32 AddrMask)
+{
+	UINTPTR BufAddr;
+
+	BufAddr = (UINTPTR)(XEmacPs_BdRead(BdPtr, XEMACPS_BD_ADDR_OFFSET) &
+			AddrMask);
+#ifdef XEMACPS_BD_ADDR64
+	BufAddr |= (UINTPTR)XEmacPs_BdRead(BdPtr, XEMACPS_BD_ADDR_HI_OFFSET)
+			<< 32U;
+#endif
+
+	return BufAddr;
+}
+
+
+/*****************************************************************************/
+/**
+ * Returns up to BdLimit BDs that have been processed by hardware, as
+ * XEmacPs_BdRingFromHwTx() does, but reads each BD once and returns what the
+ * caller needs from it in an array, so the caller does not have to read the
+ * BDs again. The BDs must be freed with XEmacPs_BdRingFree(), passing
+ * BdVec[0].BdPtr as the head of the set:
+ *
+ * <pre>
+ *        NumBd = XEmacPs_BdRingFromHwTxBatch(MyRingPtr, MaxBd, MyBdVec),
+ *
+ *        for (i=0; i<NumBd; i++)
+ *        {
+ *           * Release the buffer at MyBdVec[i].BufAddr *.....
+ *        }
+ *
+ *        XEmacPs_BdRingFree(MyRingPtr, NumBd, MyBdVec[0].BdPtr),
+ * </pre>
+ *
+ * The search stops at the first BD of a frame that hardware has not yet
+ * marked used, and never goes beyond the BDs given to hardware. If hardware
+ * has only partially completed a frame spanning multiple BDs, then none of
+ * the BDs for that frame are returned.
+ *
+ * No cache maintenance is needed here, as transmit buffers are flushed before
+ * their BDs are given to hardware.
+ *
+ * @param RingPtr is a pointer to the instance to be worked on.
+ * @param BdLimit is the maximum number of BDs to return.
+ * @param BdVec is an output parameter, an array of at least BdLimit entries
+ *        that is filled with the BDs returned, in ring order.
+ *
+ * @return
+ *   The number of BDs processed by hardware. A value of 0 indicates that no
+ *   BDs are available. No more than BdLimit BDs will be returned.
+ *
+ * @note This function should not be preempted by another XEmacPs_Bd function
+ *       call that modifies the BD space. It is the caller's responsibility to
+ *       provide a mutual exclusion mechanism.
+ *
+ *****************************************************************************/
+u32 XEmacPs_BdRingFromHwTxBatch(XEmacPs_BdRing * RingPtr, u32 BdLimit,
+				XEmacPs_BdVecEntry * BdVec)
+{
+	XEmacPs_Bd *CurBdPtr;
+	u32 BdStr;
+	u32 BdCount = 0U;
+	u32 BdFrameCount = 0U;
+	u32 Sop = 0U;
+	u32 BdLimitLoc = BdLimit;
+
+	if (BdLimitLoc > RingPtr->HwCnt) {
+		BdLimitLoc = RingPtr->HwCnt;
+	}
+
+	CurBdPtr = RingPtr->HwHead;
+
+	/* Hardware only sets the used bit of the first BD of each frame, so
+	 * the BDs after it are taken up to the BD with the "last" bit set.
+	 * BdFrameCount is the number of BDs in complete frames.
+	 */
+	while (BdCount < BdLimitLoc) {
+		BdStr = XEmacPs_BdRead(CurBdPtr, XEMACPS_BD_STAT_OFFSET);
+
+		if ((Sop == 0U) && ((BdStr & XEMACPS_TXBUF_USED_MASK) == 0U)) {
+			break;
+		}
+		Sop = 1U;
+
+		BdVec[BdCount].BdPtr = CurBdPtr;
+		BdVec[BdCount].BufAddr = XEmacPs_BdReadBufAddr(CurBdPtr,
+							0xFFFFFFFFU);
+		BdVec[BdCount].Status = BdStr;
+		BdCount++;
+
+		if ((BdStr & XEMACPS_TXBUF_LAST_MASK) != 0U) {
+			Sop = 0U;
+			BdFrameCount = BdCount;
+		}
+
+		CurBdPtr = XEmacPs_BdRingNext(RingPtr, CurBdPtr);
+	}
+
+	if (BdFrameCount > 0U) {
+		RingPtr->HwCnt -= BdFrameCount;
+		RingPtr->PostCnt += BdFrameCount;
+		XEMACPS_RING_SEEKAHEAD(RingPtr, RingPtr->HwHead, BdFrameCount);
+	}
+
+	return BdFrameCount;
+}
+
+
+/*****************************************************************************/
+/**
+ * Returns up to BdLimit BDs that have been processed by hardware, as
+ * XEmacPs_BdRingFromHwRx() does, but reads each BD once and returns what the
+ * caller needs from it in an array, and invalidates the data cache over the
+ * received data in all the BDs' buffers together. Buffers that are contiguous
+ * in memory are invalidated as one range, and up to XEMACPS_BD_BATCH_RANGES
+ * ranges are invalidated per call to Xil_DCacheInvalidateRanges(), so the
+ * barrier that completes the maintenance is shared by the whole batch. The
+ * BDs must be freed with XEmacPs_BdRingFree(), passing BdVec[0].BdPtr as the
+ * head of the set:
+ *
+ * <pre>
+ *        NumBd = XEmacPs_BdRingFromHwRxBatch(MyRingPtr, MaxBd,
+ *                                            XEMACPS_RX_BUF_SIZE, MyBdVec),
+ *
+ *        for (i=0; i<NumBd; i++)
+ *        {
+ *           * Examine MyBdVec[i].Status and MyBdVec[i].BufAddr *.....
+ *        }
+ *
+ *        XEmacPs_BdRingFree(MyRingPtr, NumBd, MyBdVec[0].BdPtr),
+ * </pre>
+ *
+ * The search stops at the first BD that hardware has not yet marked new, and
+ * never goes beyond the BDs given to hardware. If hardware has only partially
+ * completed a frame spanning multiple BDs, then none of the BDs for that
+ * frame are returned.
+ *
+ * @param RingPtr is a pointer to the instance to be worked on.
+ * @param BdLimit is the maximum number of BDs to return.
+ * @param BufSize is the receive buffer size hardware is configured with,
+ *        XEMACPS_RX_BUF_SIZE, or XEMACPS_RX_BUF_SIZE_JUMBO if jumbo frames
+ *        are enabled. Hardware fills each buffer of a frame but the last.
+ * @param BdVec is an output parameter, an array of at least BdLimit entries
+ *        that is filled with the BDs returned, in ring order.
+ *
+ * @return
+ *   The number of BDs processed by hardware. A value of 0 indicates that no
+ *   data is available. No more than BdLimit BDs will be returned.
+ *
+ * @note The buffers must not share cache lines with other data the CPU
+ *       writes while they are given to hardware.
+ *
+ * @note This function should not be preempted by another XEmacPs_Bd function
+ *       call that modifies the BD space. It is the caller's responsibility to
+ *       provide a mutual exclusion mechanism.
+ *
+ *****************************************************************************/
+u32 XEmacPs_BdRingFromHwRxBatch(XEmacPs_BdRing * RingPtr, u32 BdLimit,
+				u32 BufSize, XEmacPs_BdVecEntry * BdVec)
+{
+	Xil_CacheRange Ranges[XEMACPS_BD_BATCH_RANGES];
+	XEmacPs_Bd *CurBdPtr;
+	UINTPTR BufAddr;
+	u32 BdStr;
+	u32 LenMask;
+	u32 FrameLen;
+	u32 FrameBytes = 0U;
+	u32 BufLen;
+	u32 BdCount = 0U;
+	u32 BdFrameCount = 0U;
+	u32 NumRanges = 0U;
+	u32 Index;
+	u32 BdLimitLoc = BdLimit;
+
+	if (BdLimitLoc > RingPtr->HwCnt) {
+		BdLimitLoc = RingPtr->HwCnt;
+	}
+
+	CurBdPtr = RingPtr->HwHead;
+
+	/* Find the BDs hardware has finished with. The new bit is in the
+	 * address word, which hardware writes after the status word.
+	 */
+	while (BdCount < BdLimitLoc) {
+		if (XEmacPs_BdIsRxNew(CurBdPtr) == FALSE) {
+			break;
+		}
+
+		BdVec[BdCount].BdPtr = CurBdPtr;
+		BdCount++;
+		CurBdPtr = XEmacPs_BdRingNext(RingPtr, CurBdPtr);
+	}
+
+	/* One barrier orders all the reads of the new bits before the reads
+	 * of the status words, and before the cache maintenance on the
+	 * buffers, so neither can see data from before hardware wrote it.
+	 */
+	if (BdCount > 0U) {
+		dmb();
+	}
+
+	for (Index = 0U; Index < BdCount; Index++) {
+		BdStr = XEmacPs_BdRead(BdVec[Index].BdPtr,
+					XEMACPS_BD_STAT_OFFSET);
+		BdVec[Index].Status = BdStr;
+		BdVec[Index].BufAddr = XEmacPs_BdReadBufAddr(BdVec[Index].BdPtr,
+							XEMACPS_RXBUF_ADD_MASK);
+
+		if ((BdStr & XEMACPS_RXBUF_EOF_MASK) != 0U) {
+			BdFrameCount = Index + 1U;
+		}
+	}
+
+	/* The length in the status word of a frame's last BD is the length of
+	 * the whole frame. The BDs before it are full.
+	 */
+	if (BufSize > XEMACPS_RX_BUF_SIZE) {
+		LenMask = XEMACPS_RXBUF_LEN_JUMBO_MASK;
+	} else {
+		LenMask = XEMACPS_RXBUF_LEN_MASK;
+	}
+
+	for (Index = 0U; Index < BdFrameCount; Index++) {
+		BdStr = BdVec[Index].Status;
+		BufAddr = BdVec[Index].BufAddr;
+
+		if ((BdStr & XEMACPS_RXBUF_EOF_MASK) != 0U) {
+			FrameLen = BdStr & LenMask;
+			if (FrameLen > (FrameBytes + BufSize)) {
+				BufLen = BufSize;
+			} else if (FrameLen > FrameBytes) {
+				BufLen = FrameLen - FrameBytes;
+			} else {
+				BufLen = 0U;
+			}
+			FrameBytes = 0U;
+		} else {
+			BufLen = BufSize;
+			FrameBytes += BufSize;
+		}
+
+		if (BufLen == 0U) {
+			continue;
+		}
+
+		if ((NumRanges > 0U) &&
+			(BufAddr == (UINTPTR)(Ranges[NumRanges - 1U].Addr +
+					Ranges[NumRanges - 1U].Len))) {
+			Ranges[NumRanges - 1U].Len += (INTPTR)BufLen;
+		} else {
+			if (NumRanges == XEMACPS_BD_BATCH_RANGES) {
+				Xil_DCacheInvalidateRanges(Ranges, NumRanges);
+				NumRanges = 0U;
+			}
+			Ranges[NumRanges].Addr = (INTPTR)BufAddr;
+			Ranges[NumRanges].Len = (INTPTR)BufLen;
+			NumRanges++;
+		}
+	}
+
+	if (NumRanges > 0U) {
+		Xil_DCacheInvalidateRanges(Ranges, NumRanges);
+	}
+
+	if (BdFrameCount > 0U) {
+		RingPtr->HwCnt -= BdFrameCount;
+		RingPtr->PostCnt += BdFrameCount;
+		XEMACPS_RING_SEEKAHEAD(RingPtr, RingPtr->HwHead, BdFrameCount);
+	}
+
+	return BdFrameCount;
+}
+
+
 /*****************************************************************************/
 /**
  * Frees a set of BDs that had been previously retrieved with
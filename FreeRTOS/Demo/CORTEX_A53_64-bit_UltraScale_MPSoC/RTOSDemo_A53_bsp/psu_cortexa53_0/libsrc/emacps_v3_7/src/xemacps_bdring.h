@@ -90,6 +90,17 @@ typedef struct {
 	u32 AllCnt;     /**< Total Number of BDs for channel */
 } XEmacPs_BdRing;
 
+/**
+ * One BD returned by XEmacPs_BdRingFromHwRxBatch() or
+ * XEmacPs_BdRingFromHwTxBatch(), with the fields the caller needs read out of
+ * the BD, which is normally in uncached memory.
+ */
+typedef struct {
+	XEmacPs_Bd *BdPtr;	/**< The BD */
+	UINTPTR BufAddr;	/**< Address of the BD's buffer */
+	u32 Status;		/**< The BD's status word */
+} XEmacPs_BdVecEntry;
+
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -228,6 +239,10 @@ u32 XEmacPs_BdRingFromHwTx(XEmacPs_BdRing * RingPtr, u32 BdLimit,
 				 XEmacPs_Bd ** BdSetPtr);
 u32 XEmacPs_BdRingFromHwRx(XEmacPs_BdRing * RingPtr, u32 BdLimit,
 				 XEmacPs_Bd ** BdSetPtr);
+u32 XEmacPs_BdRingFromHwTxBatch(XEmacPs_BdRing * RingPtr, u32 BdLimit,
+				XEmacPs_BdVecEntry * BdVec);
+u32 XEmacPs_BdRingFromHwRxBatch(XEmacPs_BdRing * RingPtr, u32 BdLimit,
+				u32 BufSize, XEmacPs_BdVecEntry * BdVec);
 LONG XEmacPs_BdRingCheck(XEmacPs_BdRing * RingPtr, u8 Direction);
 
 void XEmacPs_BdRingPtrReset(XEmacPs_BdRing * RingPtr, void *virtaddrloc);
@@ -84,7 +84,13 @@ extern "C" {
                                            supported */
 #define XEMACPS_MAX_TYPE_ID      4U   /**< Maxmum number of type id supported */
 
-#ifdef __aarch64__
+/* The descriptors hold 64 bit buffer addresses on the A53. A host build of the
+ * driver defines XEMACPS_BD_ADDR64 to select the same layout. */
+#if defined (__aarch64__) && !defined (XEMACPS_BD_ADDR64)
+#define XEMACPS_BD_ADDR64
+#endif
+
+#ifdef XEMACPS_BD_ADDR64
 #define XEMACPS_BD_ALIGNMENT     64U   /**< Minimum buffer descriptor alignment
                                            on the local bus */
 #else
@@ -0,0 +1,725 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*****************************************************************************/
+/**
+*
+* @file xemacps_bdring_test.c
+*
+* Host unit test for XEmacPs_BdRingFromHwRxBatch() and
+* XEmacPs_BdRingFromHwTxBatch(). The test plays the part of the MAC by writing
+* the status words and new/used bits of the BDs in a ring held in ordinary
+* memory, and records the ranges the batch receive function passes to
+* Xil_DCacheInvalidateRanges().
+*
+* The directed tests cover batches cut short by the BD limit, frames whose
+* last BD has not been written yet, frames that span the end of the ring,
+* batches that need more than XEMACPS_BD_BATCH_RANGES ranges, and stale
+* new/used bits on BDs that have not been given to hardware. A randomised test
+* then runs receive frames of one to four BDs through the ring, wrapping it
+* many times, and checks each batch against the frames the MAC wrote.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xemacps_hw.h"
+#include "xemacps_bd.h"
+#include "xemacps_bdring.h"
+
+/************************** Constant Definitions *****************************/
+
+#define TEST_NUM_BDS		64U
+#define TEST_BUF_SIZE		XEMACPS_RX_BUF_SIZE
+#define TEST_MAX_RANGES		(4U * TEST_NUM_BDS)
+#define TEST_RANDOM_STEPS	2000000L
+
+/* The frame lengths the MAC writes in the random test are kept for this many
+ * frames, which is more than the ring can hold at once.
+ */
+#define TEST_FRAME_HISTORY	(4U * TEST_NUM_BDS)
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define CHECK(Expr)	CheckResult((Expr) != 0, #Expr, __LINE__)
+
+/************************** Variable Definitions *****************************/
+
+u32 Xil_AssertStatus;
+
+static XEmacPs_Bd BdSpace[TEST_NUM_BDS] __attribute__ ((aligned(64)));
+static u8 Buffers[TEST_NUM_BDS][TEST_BUF_SIZE] __attribute__ ((aligned(64)));
+static XEmacPs_BdRing Ring;
+
+/* The ranges passed to Xil_DCacheInvalidateRanges(). */
+static Xil_CacheRange RangeLog[TEST_MAX_RANGES];
+static u32 RangeCount;
+static u32 InvalidateCalls;
+
+static u32 Checks;
+static u32 Failures;
+
+/*****************************************************************************/
+
+static void CheckResult(int Passed, const char *Expr, int Line)
+{
+	Checks++;
+
+	if (Passed == 0) {
+		Failures++;
+		printf("xemacps_bdring_test.c:%d: check failed: %s\n", Line, Expr);
+	}
+}
+
+/*****************************************************************************/
+/*
+ * The BSP's assert handler, which the driver's Xil_AssertNonvoid() checks call.
+ */
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("%s:%d: driver assert\n", File, (int)Line);
+	abort();
+}
+
+/*****************************************************************************/
+/*
+ * Record the ranges instead of maintaining the cache.
+ */
+void Xil_DCacheInvalidateRanges(const Xil_CacheRange *ranges, u32 num)
+{
+	u32 Index;
+
+	CHECK((num > 0U) && (num <= XEMACPS_BD_BATCH_RANGES));
+	InvalidateCalls++;
+
+	for (Index = 0U; Index < num; Index++) {
+		if (RangeCount < TEST_MAX_RANGES) {
+			RangeLog[RangeCount] = ranges[Index];
+		}
+		RangeCount++;
+	}
+}
+
+/*****************************************************************************/
+
+static void ClearRangeLog(void)
+{
+	RangeCount = 0U;
+	InvalidateCalls = 0U;
+}
+
+/*****************************************************************************/
+
+static u8 *BufferFor(u32 BdIndex, int Reversed)
+{
+	u32 Index = BdIndex % TEST_NUM_BDS;
+
+	if (Reversed != 0) {
+		Index = TEST_NUM_BDS - 1U - Index;
+	}
+
+	return Buffers[Index];
+}
+
+/*****************************************************************************/
+
+static int CountsAddUp(const XEmacPs_BdRing *RingPtr)
+{
+	return (RingPtr->HwCnt + RingPtr->PreCnt + RingPtr->FreeCnt +
+		RingPtr->PostCnt) == RingPtr->AllCnt;
+}
+
+/*****************************************************************************/
+/*
+ * Build a receive ring with every BD given to hardware, BD n pointing at
+ * buffer n, or at buffer (TEST_NUM_BDS - 1 - n) if Reversed is set so that no
+ * two buffers in ring order are contiguous.
+ */
+static void CreateRxRing(int Reversed)
+{
+	XEmacPs_Bd Template;
+	XEmacPs_Bd *BdPtr;
+	u32 Index;
+
+	memset(BdSpace, 0, sizeof(BdSpace));
+	memset(&Ring, 0, sizeof(Ring));
+	XEmacPs_BdClear(&Template);
+
+	CHECK(XEmacPs_BdRingCreate(&Ring, (UINTPTR)BdSpace, (UINTPTR)BdSpace,
+				XEMACPS_BD_ALIGNMENT, TEST_NUM_BDS) == XST_SUCCESS);
+	CHECK(XEmacPs_BdRingClone(&Ring, &Template, XEMACPS_RECV) ==
+		XST_SUCCESS);
+	CHECK(XEmacPs_BdRingAlloc(&Ring, TEST_NUM_BDS, &BdPtr) == XST_SUCCESS);
+
+	for (Index = 0U; Index < TEST_NUM_BDS; Index++) {
+		XEmacPs_BdSetAddressRx(&BdSpace[Index],
+				(UINTPTR)BufferFor(Index, Reversed));
+		XEmacPs_BdClearRxNew(&BdSpace[Index]);
+	}
+
+	CHECK(XEmacPs_BdRingToHw(&Ring, TEST_NUM_BDS, BdPtr) == XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/*
+ * Play the part of the MAC: write the status word of a receive BD, then set
+ * its new bit.
+ */
+static void MacReceive(u32 BdIndex, u32 Status)
+{
+	XEmacPs_Bd *BdPtr = &BdSpace[BdIndex % TEST_NUM_BDS];
+
+	XEmacPs_BdWrite(BdPtr, XEMACPS_BD_STAT_OFFSET, Status);
+	XEmacPs_BdWrite(BdPtr, XEMACPS_BD_ADDR_OFFSET,
+		XEmacPs_BdRead(BdPtr, XEMACPS_BD_ADDR_OFFSET) |
+		XEMACPS_RXBUF_NEW_MASK);
+}
+
+/*****************************************************************************/
+/*
+ * Write a frame of NumBds BDs, starting at BdIndex.
+ */
+static void MacReceiveFrame(u32 BdIndex, u32 NumBds, u32 FrameLen)
+{
+	u32 Index;
+	u32 Status;
+
+	for (Index = 0U; Index < NumBds; Index++) {
+		Status = 0U;
+		if (Index == 0U) {
+			Status |= XEMACPS_RXBUF_SOF_MASK;
+		}
+		if (Index == (NumBds - 1U)) {
+			Status |= XEMACPS_RXBUF_EOF_MASK | FrameLen;
+		}
+		MacReceive(BdIndex + Index, Status);
+	}
+}
+
+/*****************************************************************************/
+/*
+ * Give Count BDs back to hardware, as a driver does once it has finished with
+ * their buffers.
+ */
+static void Repost(u32 Count)
+{
+	XEmacPs_Bd *BdSet;
+	XEmacPs_Bd *BdPtr;
+	u32 Index;
+
+	CHECK(XEmacPs_BdRingAlloc(&Ring, Count, &BdSet) == XST_SUCCESS);
+
+	for (Index = 0U, BdPtr = BdSet; Index < Count; Index++) {
+		XEmacPs_BdClearRxNew(BdPtr);
+		BdPtr = XEmacPs_BdRingNext(&Ring, BdPtr);
+	}
+
+	CHECK(XEmacPs_BdRingToHw(&Ring, Count, BdSet) == XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/*
+ * Take back a batch of up to Limit BDs, check it is exactly Expected BDs
+ * starting at BD FirstBd, then free and repost them.
+ */
+static u32 TakeRx(u32 Limit, u32 FirstBd, u32 Expected, int Reversed)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	u32 NumBd;
+	u32 Index;
+
+	NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, Limit, TEST_BUF_SIZE, BdVec);
+	CHECK(NumBd == Expected);
+
+	for (Index = 0U; (Index < NumBd) && (Index < Expected); Index++) {
+		CHECK(BdVec[Index].BdPtr ==
+			&BdSpace[(FirstBd + Index) % TEST_NUM_BDS]);
+		CHECK(BdVec[Index].BufAddr ==
+			(UINTPTR)BufferFor(FirstBd + Index, Reversed));
+	}
+
+	if (NumBd > 0U) {
+		CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) ==
+			XST_SUCCESS);
+		Repost(NumBd);
+	}
+
+	CHECK(CountsAddUp(&Ring));
+
+	return NumBd;
+}
+
+/*****************************************************************************/
+
+static void TestRxPartialBatches(void)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	u32 NumBd;
+	u32 Index;
+
+	CreateRxRing(0);
+
+	/* Nothing received. */
+	ClearRangeLog();
+	CHECK(XEmacPs_BdRingFromHwRxBatch(&Ring, 16U, TEST_BUF_SIZE, BdVec) ==
+		0U);
+	CHECK(InvalidateCalls == 0U);
+	CHECK(Ring.HwCnt == TEST_NUM_BDS);
+
+	/* Five single BD frames taken with a limit of three, then the rest. */
+	for (Index = 0U; Index < 5U; Index++) {
+		MacReceiveFrame(Index, 1U, 60U + Index);
+	}
+
+	ClearRangeLog();
+	NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, 3U, TEST_BUF_SIZE, BdVec);
+	CHECK(NumBd == 3U);
+	CHECK((InvalidateCalls == 1U) && (RangeCount == 3U));
+
+	for (Index = 0U; Index < 3U; Index++) {
+		CHECK(BdVec[Index].BdPtr == &BdSpace[Index]);
+		CHECK(BdVec[Index].BufAddr == (UINTPTR)Buffers[Index]);
+		CHECK((BdVec[Index].Status & XEMACPS_RXBUF_LEN_MASK) ==
+			(60U + Index));
+		CHECK(RangeLog[Index].Addr == (INTPTR)Buffers[Index]);
+		CHECK(RangeLog[Index].Len == (INTPTR)(60U + Index));
+	}
+
+	CHECK(Ring.HwHead == &BdSpace[3]);
+	CHECK(Ring.HwCnt == (TEST_NUM_BDS - 3U));
+	CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) == XST_SUCCESS);
+	Repost(NumBd);
+	(void)TakeRx(16U, 3U, 2U, 0);
+
+	/* A frame over four contiguous buffers is one range, and a frame whose
+	 * last BD has not been written is left for the next call.
+	 */
+	MacReceiveFrame(5U, 4U, 3U * TEST_BUF_SIZE + 500U);
+	MacReceive(9U, XEMACPS_RXBUF_SOF_MASK);
+	MacReceive(10U, 0U);
+
+	ClearRangeLog();
+	NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, 16U, TEST_BUF_SIZE, BdVec);
+	CHECK(NumBd == 4U);
+	CHECK((InvalidateCalls == 1U) && (RangeCount == 1U));
+	CHECK(RangeLog[0].Addr == (INTPTR)Buffers[5]);
+	CHECK(RangeLog[0].Len == (INTPTR)(3U * TEST_BUF_SIZE + 500U));
+	CHECK(Ring.HwHead == &BdSpace[9]);
+	CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) == XST_SUCCESS);
+	Repost(NumBd);
+
+	ClearRangeLog();
+	CHECK(XEmacPs_BdRingFromHwRxBatch(&Ring, 16U, TEST_BUF_SIZE, BdVec) ==
+		0U);
+	CHECK(InvalidateCalls == 0U);
+
+	MacReceive(11U, XEMACPS_RXBUF_EOF_MASK | (2U * TEST_BUF_SIZE + 128U));
+	ClearRangeLog();
+	(void)TakeRx(16U, 9U, 3U, 0);
+	CHECK((RangeCount == 1U) &&
+		(RangeLog[0].Len == (INTPTR)(2U * TEST_BUF_SIZE + 128U)));
+
+	/* A limit that ends inside a frame returns only the frames before it. */
+	MacReceiveFrame(12U, 1U, 64U);
+	MacReceiveFrame(13U, 2U, TEST_BUF_SIZE + 64U);
+	(void)TakeRx(2U, 12U, 1U, 0);
+	(void)TakeRx(1U, 13U, 0U, 0);
+	(void)TakeRx(2U, 13U, 2U, 0);
+}
+
+/*****************************************************************************/
+
+static void TestRxWraparound(void)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	u32 NumBd;
+	u32 Index;
+	u32 FrameLen = 3U * TEST_BUF_SIZE + 100U;
+
+	CreateRxRing(0);
+
+	/* Move the head to two BDs from the end of the ring. */
+	for (Index = 0U; Index < (TEST_NUM_BDS - 2U); Index++) {
+		MacReceiveFrame(Index, 1U, 64U);
+	}
+	(void)TakeRx(TEST_NUM_BDS, 0U, TEST_NUM_BDS - 2U, 0);
+
+	/* A frame spanning the end of the ring, then a single BD frame. The
+	 * buffers either side of the wrap are not contiguous, so the frame is
+	 * two ranges, and the frame's last buffer is not full, so the next
+	 * frame starts a third.
+	 */
+	MacReceiveFrame(TEST_NUM_BDS - 2U, 4U, FrameLen);
+	MacReceiveFrame(2U, 1U, 64U);
+
+	ClearRangeLog();
+	NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, 16U, TEST_BUF_SIZE, BdVec);
+	CHECK(NumBd == 5U);
+
+	for (Index = 0U; Index < NumBd; Index++) {
+		CHECK(BdVec[Index].BdPtr ==
+			&BdSpace[(TEST_NUM_BDS - 2U + Index) % TEST_NUM_BDS]);
+	}
+
+	CHECK((InvalidateCalls == 1U) && (RangeCount == 3U));
+	CHECK(RangeLog[0].Addr == (INTPTR)Buffers[TEST_NUM_BDS - 2U]);
+	CHECK(RangeLog[0].Len == (INTPTR)(2U * TEST_BUF_SIZE));
+	CHECK(RangeLog[1].Addr == (INTPTR)Buffers[0]);
+	CHECK(RangeLog[1].Len == (INTPTR)(FrameLen - 2U * TEST_BUF_SIZE));
+	CHECK(RangeLog[2].Addr == (INTPTR)Buffers[2]);
+	CHECK(RangeLog[2].Len == (INTPTR)64U);
+	CHECK(Ring.HwHead == &BdSpace[3]);
+	CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) == XST_SUCCESS);
+	Repost(NumBd);
+	CHECK(CountsAddUp(&Ring));
+
+	/* The same frame with only its first two BDs written. */
+	for (Index = 3U; Index < (TEST_NUM_BDS - 2U); Index++) {
+		MacReceiveFrame(Index, 1U, 64U);
+	}
+	(void)TakeRx(TEST_NUM_BDS, 3U, TEST_NUM_BDS - 5U, 0);
+	MacReceive(TEST_NUM_BDS - 2U, XEMACPS_RXBUF_SOF_MASK);
+	MacReceive(TEST_NUM_BDS - 1U, 0U);
+	(void)TakeRx(16U, TEST_NUM_BDS - 2U, 0U, 0);
+	MacReceive(0U, 0U);
+	MacReceive(1U, XEMACPS_RXBUF_EOF_MASK | FrameLen);
+	(void)TakeRx(16U, TEST_NUM_BDS - 2U, 4U, 0);
+}
+
+/*****************************************************************************/
+
+static void TestRxRanges(void)
+{
+	u32 Index;
+
+	/* No two buffers contiguous: one range per BD, passed in as many calls
+	 * as XEMACPS_BD_BATCH_RANGES allows.
+	 */
+	CreateRxRing(1);
+	for (Index = 0U; Index < 40U; Index++) {
+		MacReceiveFrame(Index, 1U, TEST_BUF_SIZE);
+	}
+	ClearRangeLog();
+	(void)TakeRx(40U, 0U, 40U, 1);
+	CHECK(RangeCount == 40U);
+	CHECK(InvalidateCalls ==
+		((40U + XEMACPS_BD_BATCH_RANGES - 1U) / XEMACPS_BD_BATCH_RANGES));
+
+	/* Every buffer contiguous and full: one range. */
+	CreateRxRing(0);
+	for (Index = 0U; Index < 40U; Index++) {
+		MacReceiveFrame(Index, 1U, TEST_BUF_SIZE);
+	}
+	ClearRangeLog();
+	(void)TakeRx(TEST_NUM_BDS, 0U, 40U, 0);
+	CHECK((InvalidateCalls == 1U) && (RangeCount == 1U));
+	CHECK(RangeLog[0].Len == (INTPTR)(40U * TEST_BUF_SIZE));
+}
+
+/*****************************************************************************/
+
+static void TestRxStaleNewBits(void)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	XEmacPs_Bd *BdPtr;
+	u32 NumBd;
+	u32 Index;
+
+	/* Take every BD, then give only four back to hardware without clearing
+	 * their new bits. The BDs after them still have their new bits set too,
+	 * but are not hardware's, so must not be returned.
+	 */
+	CreateRxRing(0);
+	for (Index = 0U; Index < TEST_NUM_BDS; Index++) {
+		MacReceiveFrame(Index, 1U, 64U);
+	}
+
+	NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, TEST_NUM_BDS, TEST_BUF_SIZE,
+					BdVec);
+	CHECK(NumBd == TEST_NUM_BDS);
+	CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) == XST_SUCCESS);
+	CHECK(XEmacPs_BdRingAlloc(&Ring, 4U, &BdPtr) == XST_SUCCESS);
+	CHECK(XEmacPs_BdRingToHw(&Ring, 4U, BdPtr) == XST_SUCCESS);
+	CHECK(XEmacPs_BdRingFromHwRxBatch(&Ring, TEST_NUM_BDS, TEST_BUF_SIZE,
+					BdVec) == 4U);
+}
+
+/*****************************************************************************/
+/*
+ * The MAC writes frames of one to four BDs into the BDs it owns, while the
+ * test takes batches with random limits and reposts random numbers of BDs.
+ * Each batch must be whole frames, in ring order, with the lengths the MAC
+ * wrote, and its ranges must cover exactly the frames' data.
+ */
+static void TestRxRandom(void)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	u32 FrameLens[TEST_FRAME_HISTORY];
+	u32 MacNext = 0U;
+	u32 HostNext = 0U;
+	u32 Given = TEST_NUM_BDS;
+	u32 FramesIn = 0U;
+	u32 FramesOut = 0U;
+	u32 NumBd;
+	u32 Limit;
+	u32 Index;
+	u32 Bds;
+	u32 FrameLen;
+	u32 Free;
+	INTPTR Covered;
+	INTPTR Logged;
+	long Step;
+
+	CreateRxRing(0);
+	srand(7);
+
+	for (Step = 0; Step < TEST_RANDOM_STEPS; Step++) {
+		switch (rand() % 3) {
+		case 0:
+			/* Only write a frame if the MAC owns all its BDs. */
+			Bds = 1U + ((u32)rand() % 4U);
+			if (((MacNext + Bds) - HostNext) <= Given) {
+				FrameLen = ((Bds - 1U) * TEST_BUF_SIZE) + 1U +
+					((u32)rand() % TEST_BUF_SIZE);
+				FrameLens[FramesIn % TEST_FRAME_HISTORY] =
+					FrameLen;
+				FramesIn++;
+				MacReceiveFrame(MacNext, Bds, FrameLen);
+				MacNext += Bds;
+			}
+			break;
+
+		case 1:
+			Limit = 1U + ((u32)rand() % 24U);
+			ClearRangeLog();
+			NumBd = XEmacPs_BdRingFromHwRxBatch(&Ring, Limit,
+						TEST_BUF_SIZE, BdVec);
+			CHECK(NumBd <= Limit);
+			CHECK(NumBd <= (MacNext - HostNext));
+
+			Covered = 0;
+			for (Index = 0U; Index < NumBd; Index++) {
+				CHECK(BdVec[Index].BdPtr ==
+					&BdSpace[(HostNext + Index) %
+						TEST_NUM_BDS]);
+				if ((BdVec[Index].Status &
+					XEMACPS_RXBUF_EOF_MASK) != 0U) {
+					FrameLen = BdVec[Index].Status &
+						XEMACPS_RXBUF_LEN_MASK;
+					CHECK(FrameLen == FrameLens[FramesOut %
+						TEST_FRAME_HISTORY]);
+					Covered += (INTPTR)FrameLen;
+					FramesOut++;
+				}
+			}
+
+			/* The batch ends at the end of a frame. */
+			if (NumBd > 0U) {
+				CHECK((BdVec[NumBd - 1U].Status &
+					XEMACPS_RXBUF_EOF_MASK) != 0U);
+			}
+
+			Logged = 0;
+			for (Index = 0U; Index < RangeCount; Index++) {
+				Logged += RangeLog[Index].Len;
+			}
+			CHECK(Logged == Covered);
+
+			if (NumBd > 0U) {
+				CHECK(XEmacPs_BdRingFree(&Ring, NumBd,
+					BdVec[0].BdPtr) == XST_SUCCESS);
+				HostNext += NumBd;
+				Given -= NumBd;
+			}
+			break;
+
+		default:
+			Free = XEmacPs_BdRingGetFreeCnt(&Ring);
+			if (Free > 0U) {
+				Bds = 1U + ((u32)rand() % Free);
+				Repost(Bds);
+				Given += Bds;
+			}
+			break;
+		}
+	}
+
+	CHECK(CountsAddUp(&Ring));
+
+	/* The ring has wrapped many times. */
+	CHECK(HostNext > (100U * TEST_NUM_BDS));
+	CHECK(FramesOut > 0U);
+}
+
+/*****************************************************************************/
+/*
+ * Give a transmit frame of NumBds BDs, starting at BD BdIndex, to hardware.
+ */
+static void QueueTxFrame(u32 BdIndex, u32 NumBds)
+{
+	XEmacPs_Bd *BdSet;
+	XEmacPs_Bd *BdPtr;
+	u32 Index;
+	u32 Status;
+
+	CHECK(XEmacPs_BdRingAlloc(&Ring, NumBds, &BdSet) == XST_SUCCESS);
+	CHECK(BdSet == &BdSpace[BdIndex % TEST_NUM_BDS]);
+
+	for (Index = 0U, BdPtr = BdSet; Index < NumBds; Index++) {
+		XEmacPs_BdSetAddressTx(BdPtr,
+			(UINTPTR)Buffers[(BdIndex + Index) % TEST_NUM_BDS]);
+		Status = XEmacPs_BdRead(BdPtr, XEMACPS_BD_STAT_OFFSET) &
+			XEMACPS_TXBUF_WRAP_MASK;
+		Status |= 100U;
+		if (Index == (NumBds - 1U)) {
+			Status |= XEMACPS_TXBUF_LAST_MASK;
+		}
+		XEmacPs_BdWrite(BdPtr, XEMACPS_BD_STAT_OFFSET, Status);
+		BdPtr = XEmacPs_BdRingNext(&Ring, BdPtr);
+	}
+
+	CHECK(XEmacPs_BdRingToHw(&Ring, NumBds, BdSet) == XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/*
+ * Play the part of the MAC: set the used bit of the first BD of a frame once
+ * it has been sent.
+ */
+static void MacSent(u32 BdIndex)
+{
+	XEmacPs_Bd *BdPtr = &BdSpace[BdIndex % TEST_NUM_BDS];
+
+	XEmacPs_BdWrite(BdPtr, XEMACPS_BD_STAT_OFFSET,
+		XEmacPs_BdRead(BdPtr, XEMACPS_BD_STAT_OFFSET) |
+		XEMACPS_TXBUF_USED_MASK);
+}
+
+/*****************************************************************************/
+/*
+ * Take back a batch of up to Limit transmit BDs, check it is exactly Expected
+ * BDs starting at BD FirstBd, then free them.
+ */
+static void TakeTx(u32 Limit, u32 FirstBd, u32 Expected)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	u32 NumBd;
+	u32 Index;
+
+	NumBd = XEmacPs_BdRingFromHwTxBatch(&Ring, Limit, BdVec);
+	CHECK(NumBd == Expected);
+
+	for (Index = 0U; (Index < NumBd) && (Index < Expected); Index++) {
+		CHECK(BdVec[Index].BdPtr ==
+			&BdSpace[(FirstBd + Index) % TEST_NUM_BDS]);
+		CHECK(BdVec[Index].BufAddr ==
+			(UINTPTR)Buffers[(FirstBd + Index) % TEST_NUM_BDS]);
+	}
+
+	if (NumBd > 0U) {
+		CHECK((BdVec[NumBd - 1U].Status & XEMACPS_TXBUF_LAST_MASK) != 0U);
+		CHECK(XEmacPs_BdRingFree(&Ring, NumBd, BdVec[0].BdPtr) ==
+			XST_SUCCESS);
+	}
+
+	CHECK(CountsAddUp(&Ring));
+}
+
+/*****************************************************************************/
+
+static void TestTx(void)
+{
+	XEmacPs_BdVecEntry BdVec[TEST_NUM_BDS];
+	XEmacPs_Bd Template;
+	u32 Index;
+
+	memset(BdSpace, 0, sizeof(BdSpace));
+	memset(&Ring, 0, sizeof(Ring));
+	XEmacPs_BdClear(&Template);
+	XEmacPs_BdSetTxUsed(&Template);
+	CHECK(XEmacPs_BdRingCreate(&Ring, (UINTPTR)BdSpace, (UINTPTR)BdSpace,
+				XEMACPS_BD_ALIGNMENT, TEST_NUM_BDS) == XST_SUCCESS);
+	CHECK(XEmacPs_BdRingClone(&Ring, &Template, XEMACPS_SEND) ==
+		XST_SUCCESS);
+	CHECK(XEmacPs_BdRingFromHwTxBatch(&Ring, 8U, BdVec) == 0U);
+
+	/* Frames of one, three and two BDs. Nothing is returned until the MAC
+	 * has sent a frame, and a limit that ends inside a frame returns only
+	 * the frames before it.
+	 */
+	QueueTxFrame(0U, 1U);
+	QueueTxFrame(1U, 3U);
+	QueueTxFrame(4U, 2U);
+	TakeTx(8U, 0U, 0U);
+	MacSent(0U);
+	MacSent(1U);
+	TakeTx(3U, 0U, 1U);
+	TakeTx(8U, 1U, 3U);
+
+	/* The BD after the last frame given to hardware has its used bit set
+	 * from the template, but is not hardware's, so is not returned.
+	 */
+	TakeTx(8U, 4U, 0U);
+	MacSent(4U);
+	TakeTx(8U, 4U, 2U);
+	CHECK(Ring.HwCnt == 0U);
+
+	/* Move to the end of the ring, then send a frame that spans it. */
+	for (Index = 6U; Index < (TEST_NUM_BDS - 1U); Index++) {
+		QueueTxFrame(Index, 1U);
+		MacSent(Index);
+	}
+	TakeTx(TEST_NUM_BDS, 6U, TEST_NUM_BDS - 7U);
+	QueueTxFrame(TEST_NUM_BDS - 1U, 3U);
+	TakeTx(8U, TEST_NUM_BDS - 1U, 0U);
+	MacSent(TEST_NUM_BDS - 1U);
+	TakeTx(8U, TEST_NUM_BDS - 1U, 3U);
+	CHECK(Ring.HwHead == &BdSpace[2]);
+	CHECK(Ring.HwCnt == 0U);
+}
+
+/*****************************************************************************/
+
+int main(void)
+{
+	TestRxPartialBatches();
+	TestRxWraparound();
+	TestRxRanges();
+	TestRxStaleNewBits();
+	TestRxRandom();
+	TestTx();
+
+	printf("xemacps_bdring_test: %u checks, %u failed\n", Checks, Failures);
+
+	return (Failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+/*
+ * Stands in for the standalone BSP's xpseudo_asm.h when xemacps_bdring.c is
+ * built for the host unit test. The barriers only need to stop the compiler
+ * reordering accesses, as the test's model of the MAC runs on the same thread.
+ */
+#ifndef XPSEUDO_ASM_H
+#define XPSEUDO_ASM_H
+
+#define dmb()	__asm__ __volatile__ ("" ::: "memory")
+#define dsb()	__asm__ __volatile__ ("" ::: "memory")
+#define isb()	__asm__ __volatile__ ("" ::: "memory")
+
+#endif /* XPSEUDO_ASM_H */
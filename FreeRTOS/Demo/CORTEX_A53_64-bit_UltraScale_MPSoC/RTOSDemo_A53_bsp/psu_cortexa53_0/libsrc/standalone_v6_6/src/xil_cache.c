@@ -88,10 +88,22 @@
 #include "bspconfig.h"
 
 /************************** Function Prototypes ******************************/
+static void Xil_DCacheMaintainRanges(const Xil_CacheRange *ranges, u32 num,
+					u32 invalidate);
 
 /************************** Variable Definitions *****************************/
 #define IRQ_FIQ_MASK 0xC0U	/* Mask IRQ and FIQ interrupts in cpsr */
 
+/*
+ * The number of cache lines maintained by the range functions between
+ * barriers. IRQ and FIQ are masked while each batch is issued, and are
+ * restored between batches, so this bounds the interrupt latency the range
+ * functions add.
+ */
+#ifndef XIL_CACHE_MAINT_BATCH_LINES
+#define XIL_CACHE_MAINT_BATCH_LINES 64U
+#endif
+
 /****************************************************************************/
 /**
 * @brief	Enable the Data cache.
@@ -423,44 +435,11 @@ void Xil_DCacheInvalidateLine(INTPTR adr)
 ****************************************************************************/
 void Xil_DCacheInvalidateRange(INTPTR  adr, INTPTR len)
 {
-	const INTPTR cacheline = 64U;
-	INTPTR end;
-	INTPTR tempadr = adr;
-	INTPTR tempend;
-	u32 currmask;
-	currmask = mfcpsr();
-	mtcpsr(currmask | IRQ_FIQ_MASK);
-	if (len != 0U) {
-		end = tempadr + len;
-		tempend = end;
+	Xil_CacheRange range;
 
-		if ((tempadr & (cacheline-1U)) != 0U) {
-			tempadr &= (~(cacheline - 1U));
-			Xil_DCacheFlushLine(tempadr);
-			tempadr += cacheline;
-		}
-		if ((tempend & (cacheline-1U)) != 0U) {
-			tempend &= (~(cacheline - 1U));
-			Xil_DCacheFlushLine(tempend);
-		}
-
-		while (tempadr < tempend) {
-			/* Select cache level 0 and D cache in CSSR */
-			mtcp(CSSELR_EL1,0x0);
-			/* Invalidate Data cache line */
-			mtcpdc(IVAC,(tempadr & (~0x3F)));
-			/* Wait for invalidate to complete */
-			dsb();
-			/* Select cache level 0 and D cache in CSSR */
-			mtcp(CSSELR_EL1,0x2);
-			/* Invalidate Data cache line */
-			mtcpdc(IVAC,(tempadr & (~0x3F)));
-			/* Wait for invalidate to complete */
-			dsb();
-			tempadr += cacheline;
-		}
-	}
-	mtcpsr(currmask);
+	range.Addr = adr;
+	range.Len = len;
+	Xil_DCacheMaintainRanges(&range, 1U, 1U);
 }
 
 /****************************************************************************/
@@ -613,43 +592,124 @@ void Xil_DCacheFlushLine(INTPTR  adr)
 ****************************************************************************/
 void Xil_DCacheFlushRange(INTPTR  adr, INTPTR len)
 {
-	const u32 cacheline = 64U;
+	Xil_CacheRange range;
+
+	range.Addr = adr;
+	range.Len = len;
+	Xil_DCacheMaintainRanges(&range, 1U, 0U);
+}
+
+/****************************************************************************/
+/**
+* @brief	Invalidate the Data cache for a list of address ranges.
+* 			The cachelines present in each range are invalidated as by
+*			Xil_DCacheInvalidateRange, but with one barrier per batch of
+*			cachelines across the whole list rather than one per range.
+*
+* @param	ranges: Array of the ranges to be invalidated.
+* @param	num: Number of entries in ranges.
+*
+* @return	None.
+*
+* @note		Cachelines that are only partly covered by a range are flushed
+*			rather than invalidated, so data outside the range is not lost.
+*
+****************************************************************************/
+void Xil_DCacheInvalidateRanges(const Xil_CacheRange *ranges, u32 num)
+{
+	Xil_DCacheMaintainRanges(ranges, num, 1U);
+}
+
+/****************************************************************************/
+/**
+* @brief	Flush the Data cache for a list of address ranges.
+* 			The cachelines present in each range are flushed as by
+*			Xil_DCacheFlushRange, but with one barrier per batch of
+*			cachelines across the whole list rather than one per range.
+*
+* @param	ranges: Array of the ranges to be flushed.
+* @param	num: Number of entries in ranges.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void Xil_DCacheFlushRanges(const Xil_CacheRange *ranges, u32 num)
+{
+	Xil_DCacheMaintainRanges(ranges, num, 0U);
+}
+
+/****************************************************************************/
+/**
+* @brief	Invalidate or flush the Data cache for a list of address ranges.
+*
+* @param	ranges: Array of the ranges to be maintained.
+* @param	num: Number of entries in ranges.
+* @param	invalidate: 1 to invalidate the ranges, 0 to flush them.
+*
+* @return	None.
+*
+* @note		Data cache maintenance by virtual address operates to the point
+*			of coherency, so one operation per cacheline covers both the L1
+*			and L2 caches - the cache level selected in CSSELR_EL1 does not
+*			apply to it. The operations are issued in batches of
+*			XIL_CACHE_MAINT_BATCH_LINES cachelines with IRQ and FIQ masked.
+*			Each batch ends with a dsb, then interrupts are restored
+*			briefly, so a pending interrupt waits for at most one batch
+*			rather than for the whole list of ranges.
+*
+****************************************************************************/
+static void Xil_DCacheMaintainRanges(const Xil_CacheRange *ranges, u32 num,
+					u32 invalidate)
+{
+	const INTPTR cacheline = 64U;
+	INTPTR tempadr;
 	INTPTR end;
-	INTPTR tempadr = adr;
-	INTPTR tempend;
+	u32 index;
+	u32 lines = 0U;
 	u32 currmask;
+
 	currmask = mfcpsr();
 	mtcpsr(currmask | IRQ_FIQ_MASK);
-	if (len != 0x00000000U) {
-		end = tempadr + len;
-		tempend = end;
-		if ((tempadr & (0x3F)) != 0) {
-			tempadr &= ~(0x3F);
-			Xil_DCacheFlushLine(tempadr);
-			tempadr += cacheline;
-		}
-		if ((tempend & (0x3F)) != 0) {
-			tempend &= ~(0x3F);
-			Xil_DCacheFlushLine(tempend);
+
+	for (index = 0U; index < num; index++) {
+		if (ranges[index].Len == 0U) {
+			continue;
 		}
 
-		while (tempadr < tempend) {
-			/* Select cache level 0 and D cache in CSSR */
-			mtcp(CSSELR_EL1,0x0);
-			/* Flush Data cache line */
-			mtcpdc(CIVAC,(tempadr & (~0x3F)));
-			/* Wait for flush to complete */
-			dsb();
-			/* Select cache level 1 and D cache in CSSR */
-			mtcp(CSSELR_EL1,0x2);
-			/* Flush Data cache line */
-			mtcpdc(CIVAC,(tempadr & (~0x3F)));
-			/* Wait for flush to complete */
-			dsb();
+		tempadr = ranges[index].Addr & (~(cacheline - 1U));
+		end = ranges[index].Addr + ranges[index].Len;
+
+		while (tempadr < end) {
+			/*
+			 * A cacheline that is only partly in the range may hold
+			 * other data, so it is flushed rather than invalidated.
+			 */
+			if ((invalidate != 0U) &&
+				(tempadr >= ranges[index].Addr) &&
+				((tempadr + cacheline) <= end)) {
+				mtcpdc(IVAC, tempadr);
+			} else {
+				mtcpdc(CIVAC, tempadr);
+			}
 			tempadr += cacheline;
+
+			lines++;
+			if (lines == XIL_CACHE_MAINT_BATCH_LINES) {
+				/* Wait for the batch to complete, then let any
+				 * pending interrupt in. */
+				dsb();
+				mtcpsr(currmask);
+				isb();
+				lines = 0U;
+				mtcpsr(currmask | IRQ_FIQ_MASK);
+			}
 		}
 	}
 
+	/* Wait for the last batch to complete */
+	dsb();
 	mtcpsr(currmask);
 }
 
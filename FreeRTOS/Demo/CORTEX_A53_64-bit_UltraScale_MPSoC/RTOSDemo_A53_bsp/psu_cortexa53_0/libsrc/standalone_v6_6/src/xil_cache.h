@@ -65,6 +65,16 @@ extern "C" {
 #define L1_DATA_PREFETCH_CONTROL_MASK  0xE000
 #define L1_DATA_PREFETCH_CONTROL_SHIFT  13
 
+/**************************** Type Definitions *******************************/
+/**
+* One range of memory in the list passed to Xil_DCacheInvalidateRanges() and
+* Xil_DCacheFlushRanges().
+*/
+typedef struct {
+	INTPTR Addr;	/**< Start address of the range */
+	INTPTR Len;		/**< Length of the range in bytes */
+} Xil_CacheRange;
+
 /************************** Function Prototypes ******************************/
 void Xil_DCacheEnable(void);
 void Xil_DCacheDisable(void);
@@ -74,6 +84,8 @@ void Xil_DCacheInvalidateLine(INTPTR adr);
 void Xil_DCacheFlush(void);
 void Xil_DCacheFlushRange(INTPTR adr, INTPTR len);
 void Xil_DCacheFlushLine(INTPTR adr);
+void Xil_DCacheInvalidateRanges(const Xil_CacheRange *ranges, u32 num);
+void Xil_DCacheFlushRanges(const Xil_CacheRange *ranges, u32 num);
 
 void Xil_ICacheEnable(void);
 void Xil_ICacheDisable(void);
@@ -33,8 +33,9 @@
 /**
 * @file xil_mem.c
 *
-* This file contains xil mem copy function to use in case of word aligned
-* data copies.
+* This file contains xil mem copy and set functions, which handle any
+* alignment and copy or set 32 bytes per iteration once the destination is
+* aligned.
 *
 * <pre>
 * MODIFICATION HISTORY:
@@ -50,8 +51,50 @@
 /***************************** Include Files ********************************/
 
 #include "xil_types.h"
+#include "xil_mem.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Copies and sets of at least this many bytes use non-temporal stores, so a
+ * buffer that does not fit in the cache does not evict everything else on its
+ * way through. The default is the size of the Cortex-A53 L2 cache.
+ */
+#ifndef XIL_MEM_NT_THRESHOLD
+#define XIL_MEM_NT_THRESHOLD	(1024U * 1024U)
+#endif
+
+/* Bytes moved by each iteration of the main loops */
+#define XIL_MEM_BLOCK_SIZE	32U
+
+/* The destination is aligned to this before the main loops start */
+#define XIL_MEM_ALIGN		16U
+
+/************************** Function Prototypes *****************************/
+
+static void Xil_MemCpyInternal(u8 *d, const u8 *s, u32 cnt, u32 nt);
+static void Xil_MemSetInternal(u8 *d, u8 val, u32 cnt, u32 nt);
 
 /***************** Inline Functions Definitions ********************/
+
+/*
+ * Load and store 64 bits at any alignment. The compiler turns these into
+ * single loads and stores on processors that allow unaligned accesses to
+ * normal memory, as the A53 does.
+ */
+static inline u64 Xil_MemLoad64(const u8 *s)
+{
+	u64 val;
+
+	__builtin_memcpy(&val, s, sizeof(val));
+	return val;
+}
+
+static inline void Xil_MemStore64(u8 *d, u64 val)
+{
+	__builtin_memcpy(d, &val, sizeof(val));
+}
+
 /*****************************************************************************/
 /**
 * @brief       This  function copies memory from once location to other.
@@ -62,22 +105,225 @@
 *
 * @param       cnt: 32 bit length of bytes to be copied
 *
+* @note        Bytes are copied until the destination is 16 byte aligned,
+*              then 32 bytes are copied per iteration (LDP/STP on AArch64),
+*              then the tail is copied 8 bytes and then 1 byte at a time.
+*              Copies of XIL_MEM_NT_THRESHOLD bytes or more are made as by
+*              Xil_MemCpyNT. The source and destination must not overlap.
+*              NEON registers are not used, so the function can be called
+*              from FreeRTOS tasks that have no floating point context.
+*
 *****************************************************************************/
 void Xil_MemCpy(void* dst, const void* src, u32 cnt)
 {
-	char *d = (char*)(void *)dst;
-	const char *s = src;
-
-	while (cnt >= sizeof (int)) {
-		*(int*)d = *(int*)s;
-		d += sizeof (int);
-		s += sizeof (int);
-		cnt -= sizeof (int);
+	Xil_MemCpyInternal((u8 *)dst, (const u8 *)src, cnt,
+			(cnt >= XIL_MEM_NT_THRESHOLD) ? 1U : 0U);
+}
+
+/*****************************************************************************/
+/**
+* @brief       This  function copies memory from once location to other, using
+*              non-temporal loads and stores (LDNP/STNP on AArch64), which hint
+*              that the data need not be kept in the cache.
+*
+* @param       dst: pointer pointing to destination memory
+*
+* @param       src: pointer pointing to source memory
+*
+* @param       cnt: 32 bit length of bytes to be copied
+*
+* @note        On other processors this is the same as Xil_MemCpy.
+*
+*****************************************************************************/
+void Xil_MemCpyNT(void* dst, const void* src, u32 cnt)
+{
+	Xil_MemCpyInternal((u8 *)dst, (const u8 *)src, cnt, 1U);
+}
+
+/*****************************************************************************/
+/**
+* @brief       This  function sets each byte of a memory area to a value.
+*
+* @param       dst: pointer pointing to destination memory
+*
+* @param       val: the value written, converted to u8
+*
+* @param       cnt: 32 bit length of bytes to be set
+*
+* @note        Sets of XIL_MEM_NT_THRESHOLD bytes or more are made as by
+*              Xil_MemSetNT.
+*
+*****************************************************************************/
+void Xil_MemSet(void* dst, s32 val, u32 cnt)
+{
+	Xil_MemSetInternal((u8 *)dst, (u8)val, cnt,
+			(cnt >= XIL_MEM_NT_THRESHOLD) ? 1U : 0U);
+}
+
+/*****************************************************************************/
+/**
+* @brief       This  function sets each byte of a memory area to a value, using
+*              non-temporal stores (STNP on AArch64).
+*
+* @param       dst: pointer pointing to destination memory
+*
+* @param       val: the value written, converted to u8
+*
+* @param       cnt: 32 bit length of bytes to be set
+*
+* @note        On other processors this is the same as Xil_MemSet.
+*
+*****************************************************************************/
+void Xil_MemSetNT(void* dst, s32 val, u32 cnt)
+{
+	Xil_MemSetInternal((u8 *)dst, (u8)val, cnt, 1U);
+}
+
+/*****************************************************************************/
+/*
+* Copy cnt bytes from s to d, using non-temporal accesses for the main loop if
+* nt is not 0.
+*
+*****************************************************************************/
+static void Xil_MemCpyInternal(u8 *d, const u8 *s, u32 cnt, u32 nt)
+{
+	u32 head;
+	u64 blocks;
+
+	if (cnt >= (XIL_MEM_BLOCK_SIZE + XIL_MEM_ALIGN)) {
+		/* Align the destination, so no store crosses a cache line */
+		head = (u32)((0U - (UINTPTR)d) & (XIL_MEM_ALIGN - 1U));
+		cnt -= head;
+		while (head > 0U) {
+			*d = *s;
+			d += 1U;
+			s += 1U;
+			head -= 1U;
+		}
+
+		blocks = cnt / XIL_MEM_BLOCK_SIZE;
+		cnt -= (u32)(blocks * XIL_MEM_BLOCK_SIZE);
+
+#if defined (__aarch64__)
+		if (nt != 0U) {
+			__asm__ __volatile__(
+				"1:	ldnp	x4, x5, [%1]\n"
+				"	ldnp	x6, x7, [%1, #16]\n"
+				"	add	%1, %1, #32\n"
+				"	stnp	x4, x5, [%0]\n"
+				"	stnp	x6, x7, [%0, #16]\n"
+				"	add	%0, %0, #32\n"
+				"	subs	%2, %2, #1\n"
+				"	b.ne	1b\n"
+				: "+r" (d), "+r" (s), "+r" (blocks)
+				:
+				: "x4", "x5", "x6", "x7", "cc", "memory");
+		} else {
+			__asm__ __volatile__(
+				"1:	ldp	x4, x5, [%1], #32\n"
+				"	ldp	x6, x7, [%1, #-16]\n"
+				"	stp	x4, x5, [%0], #32\n"
+				"	stp	x6, x7, [%0, #-16]\n"
+				"	subs	%2, %2, #1\n"
+				"	b.ne	1b\n"
+				: "+r" (d), "+r" (s), "+r" (blocks)
+				:
+				: "x4", "x5", "x6", "x7", "cc", "memory");
+		}
+#else
+		(void)nt;
+		while (blocks > 0U) {
+			Xil_MemStore64(d, Xil_MemLoad64(s));
+			Xil_MemStore64(d + 8U, Xil_MemLoad64(s + 8U));
+			Xil_MemStore64(d + 16U, Xil_MemLoad64(s + 16U));
+			Xil_MemStore64(d + 24U, Xil_MemLoad64(s + 24U));
+			d += XIL_MEM_BLOCK_SIZE;
+			s += XIL_MEM_BLOCK_SIZE;
+			blocks -= 1U;
+		}
+#endif
 	}
-	while ((cnt) > 0U){
+
+	while (cnt >= sizeof(u64)) {
+		Xil_MemStore64(d, Xil_MemLoad64(s));
+		d += sizeof(u64);
+		s += sizeof(u64);
+		cnt -= sizeof(u64);
+	}
+	while (cnt > 0U) {
 		*d = *s;
 		d += 1U;
 		s += 1U;
 		cnt -= 1U;
 	}
 }
+
+/*****************************************************************************/
+/*
+* Set cnt bytes from d to val, using non-temporal stores for the main loop if
+* nt is not 0.
+*
+*****************************************************************************/
+static void Xil_MemSetInternal(u8 *d, u8 val, u32 cnt, u32 nt)
+{
+	const u64 pattern = (u64)val * 0x0101010101010101ULL;
+	u32 head;
+	u64 blocks;
+
+	if (cnt >= (XIL_MEM_BLOCK_SIZE + XIL_MEM_ALIGN)) {
+		head = (u32)((0U - (UINTPTR)d) & (XIL_MEM_ALIGN - 1U));
+		cnt -= head;
+		while (head > 0U) {
+			*d = val;
+			d += 1U;
+			head -= 1U;
+		}
+
+		blocks = cnt / XIL_MEM_BLOCK_SIZE;
+		cnt -= (u32)(blocks * XIL_MEM_BLOCK_SIZE);
+
+#if defined (__aarch64__)
+		if (nt != 0U) {
+			__asm__ __volatile__(
+				"1:	stnp	%2, %2, [%0]\n"
+				"	stnp	%2, %2, [%0, #16]\n"
+				"	add	%0, %0, #32\n"
+				"	subs	%1, %1, #1\n"
+				"	b.ne	1b\n"
+				: "+r" (d), "+r" (blocks)
+				: "r" (pattern)
+				: "cc", "memory");
+		} else {
+			__asm__ __volatile__(
+				"1:	stp	%2, %2, [%0], #32\n"
+				"	stp	%2, %2, [%0, #-16]\n"
+				"	subs	%1, %1, #1\n"
+				"	b.ne	1b\n"
+				: "+r" (d), "+r" (blocks)
+				: "r" (pattern)
+				: "cc", "memory");
+		}
+#else
+		(void)nt;
+		while (blocks > 0U) {
+			Xil_MemStore64(d, pattern);
+			Xil_MemStore64(d + 8U, pattern);
+			Xil_MemStore64(d + 16U, pattern);
+			Xil_MemStore64(d + 24U, pattern);
+			d += XIL_MEM_BLOCK_SIZE;
+			blocks -= 1U;
+		}
+#endif
+	}
+
+	while (cnt >= sizeof(u64)) {
+		Xil_MemStore64(d, pattern);
+		d += sizeof(u64);
+		cnt -= sizeof(u64);
+	}
+	while (cnt > 0U) {
+		*d = val;
+		d += 1U;
+		cnt -= 1U;
+	}
+}
@@ -51,9 +51,16 @@
 *
 *****************************************************************************/
 
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
 /************************** Function Prototypes *****************************/
 
 void Xil_MemCpy(void* dst, const void* src, u32 cnt);
+void Xil_MemCpyNT(void* dst, const void* src, u32 cnt);
+void Xil_MemSet(void* dst, s32 val, u32 cnt);
+void Xil_MemSetNT(void* dst, s32 val, u32 cnt);
 /**
 * @} End of "addtogroup common_mem_operation_api".
 */
\ No newline at end of file
@@ -0,0 +1,273 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the inter-core channel in OnEitherCore/IntercoreChannel.c,
+ * built against the software model of the SIO FIFO in
+ * IntercoreChannelHostModel.h.
+ *
+ * The test plays both cores.  It sends from the SDK core, takes the FIFO
+ * interrupt on the RTOS core by calling bHostFIFOModelRun(), and receives as
+ * the RTOS task - in a random order, so the sender, the interrupt and the
+ * receiver interleave in every way the ring allows.  Each time the receiver
+ * would block on an empty ring the test checks that the next send wakes it,
+ * which is the lost wake up the doorbell protocol exists to prevent.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#define channelUSE_HOST_FIFO_MODEL  1
+#include "IntercoreChannel.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+/* Notifications given to the receiving task and not yet taken. */
+static uint32_t ulPendingNotifications = 0;
+
+/* The number of times xTaskCheckForTimeOut() has been called since
+vTaskSetTimeOutState(). */
+static uint32_t ulTimeOutChecks = 0;
+
+/* Words other than channelDOORBELL passed to the doorbell handler. */
+static uint32_t ulForeignWords = 0, ulLastForeignWord = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions IntercoreChannel.c uses. */
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+    /* Only the receiving task calls into the kernel. */
+    return ( TaskHandle_t ) &ulPendingNotifications;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+    ( void ) pxTimeOut;
+    ulTimeOutChecks = 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+    ( void ) pxTimeOut;
+
+    /* A zero block time has always timed out.  Otherwise the receiver is
+    allowed to block once. */
+    ulTimeOutChecks++;
+    return ( ( *pxTicksToWait == 0 ) || ( ulTimeOutChecks > 1 ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    hosttestCHECK( xTaskToNotify == xTaskGetCurrentTaskHandle() );
+    hosttestCHECK( uxIndexToNotify == channelNOTIFICATION_INDEX );
+
+    ulPendingNotifications++;
+    *pxHigherPriorityTaskWoken = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+    uint32_t ulReturn;
+
+    ( void ) uxIndexToWaitOn;
+    ( void ) xClearCountOnExit;
+    ( void ) xTicksToWait;
+
+    /* While the receiver is blocked the RTOS core takes any pending FIFO
+    interrupt. */
+    ( void ) bHostFIFOModelRun();
+
+    ulReturn = ulPendingNotifications;
+    ulPendingNotifications = 0;
+
+    return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoorbellHandler( uint32_t ulWord, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    ( void ) pxHigherPriorityTaskWoken;
+
+    ulForeignWords++;
+    ulLastForeignWord = ulWord;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResetChannel( void )
+{
+    memset( &xHostFIFOModel, 0x00, sizeof( xHostFIFOModel ) );
+    ulPendingNotifications = 0;
+    ulForeignWords = 0;
+    vIntercoreChannelInit();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomInterleaving( void )
+{
+    IntercoreMessage_t xMessage = { 0 };
+    IntercoreChannelStats_t xStats;
+    uint32_t ulNextToSend = 0, ulNextExpected = 0, ulSends, ulLostWakes = 0, ulIteration;
+
+    prvResetChannel();
+    srand( 3 );
+
+    /* The first receive installs the interrupt handler. */
+    hosttestCHECK( xIntercoreChannelReceive( &xMessage, 0 ) == pdFAIL );
+    hosttestCHECK( xHostFIFOModel.bInterruptEnabled != false );
+
+    for( ulIteration = 0; ulIteration < 200000UL; ulIteration++ )
+    {
+        switch( rand() % 4 )
+        {
+            case 0:
+                /* The SDK core sends a burst, which may fill the ring. */
+                for( ulSends = ( uint32_t ) ( rand() % 80 ); ulSends > 0; ulSends-- )
+                {
+                    xMessage.ulValue = ulNextToSend;
+
+                    if( bIntercoreChannelSend( &xMessage ) != false )
+                    {
+                        ulNextToSend++;
+                    }
+                }
+                break;
+
+            case 1:
+                /* The RTOS core takes the FIFO interrupt, if it is pending. */
+                ( void ) bHostFIFOModelRun();
+                break;
+
+            default:
+                /* The receiver drains the ring, checking nothing is lost or
+                reordered. */
+                while( xIntercoreChannelReceive( &xMessage, 0 ) == pdPASS )
+                {
+                    hosttestCHECK( xMessage.ulValue == ulNextExpected );
+                    ulNextExpected = xMessage.ulValue + 1;
+                }
+
+                hosttestCHECK( ulNextExpected == ulNextToSend );
+
+                /* The receiver now blocks, so takes any notification left
+                from the messages it has already received... */
+                ( void ) bHostFIFOModelRun();
+                ulPendingNotifications = 0;
+
+                /* ...and the next send must ring the doorbell and so wake
+                it. */
+                xMessage.ulValue = ulNextToSend;
+                hosttestCHECK( bIntercoreChannelSend( &xMessage ) != false );
+                ulNextToSend++;
+
+                if( ( bHostFIFOModelRun() == false ) || ( ulPendingNotifications == 0 ) )
+                {
+                    ulLostWakes++;
+                }
+                break;
+        }
+    }
+
+    hosttestCHECK( ulLostWakes == 0 );
+    hosttestCHECK( xHostFIFOModel.bWriteOverflow == false );
+
+    vIntercoreChannelGetStats( &xStats );
+    hosttestCHECK( xStats.ulMessagesSent == ulNextToSend );
+    hosttestCHECK( xStats.ulMessagesReceived == ulNextExpected );
+    hosttestCHECK( xStats.ulSendsRingFull > 0 );
+
+    /* Most messages do not need a doorbell of their own. */
+    hosttestCHECK( xStats.ulDoorbellsRung < xStats.ulMessagesSent );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestFullFIFO( void )
+{
+    IntercoreMessage_t xMessage = { 0 };
+    IntercoreChannelStats_t xStats;
+    uint32_t ulWord;
+
+    /* Another service fills the FIFO, so the channel cannot ring its
+    doorbell.  The receiver must still be woken when the FIFO is drained. */
+    prvResetChannel();
+    vIntercoreChannelSetDoorbellHandler( prvDoorbellHandler );
+    hosttestCHECK( xIntercoreChannelReceive( &xMessage, 0 ) == pdFAIL );
+
+    for( ulWord = 0; ulWord < channelHOST_FIFO_DEPTH; ulWord++ )
+    {
+        vHostFIFOModelPush( 0x1000UL + ulWord );
+    }
+
+    xMessage.ulValue = 42;
+    hosttestCHECK( bIntercoreChannelSend( &xMessage ) != false );
+
+    vIntercoreChannelGetStats( &xStats );
+    hosttestCHECK( xStats.ulDoorbellsRung == 0 );
+    hosttestCHECK( xHostFIFOModel.bWriteOverflow == false );
+
+    /* The interrupt passes the other service's words to its handler, then
+    finds the message in the ring and wakes the receiver. */
+    hosttestCHECK( bHostFIFOModelRun() != false );
+    hosttestCHECK( ulPendingNotifications == 1 );
+    hosttestCHECK( ulForeignWords == channelHOST_FIFO_DEPTH );
+    hosttestCHECK( ulLastForeignWord == ( 0x1000UL + channelHOST_FIFO_DEPTH - 1 ) );
+
+    xMessage.ulValue = 0;
+    hosttestCHECK( xIntercoreChannelReceive( &xMessage, portMAX_DELAY ) == pdPASS );
+    hosttestCHECK( xMessage.ulValue == 42 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestTimeOut( void )
+{
+    IntercoreMessage_t xMessage = { 0 };
+
+    /* A receive with a block time returns pdFAIL if nothing arrives. */
+    prvResetChannel();
+    hosttestCHECK( xIntercoreChannelReceive( &xMessage, 10 ) == pdFAIL );
+    hosttestCHECK( ulTimeOutChecks == 2 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    prvTestRandomInterleaving();
+    prvTestFullFIFO();
+    prvTestTimeOut();
+
+    return iHostTestResult( "IntercoreChannelTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,226 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the batched GPIO writes and PIO patterns in Standard/ParTest.c,
+ * built against the software model of the GPIO bank and state machines in
+ * ParTestHostModel.h.
+ *
+ * Random sets, clears and toggles, with patterns started and stopped among
+ * them, are checked against a reference copy of the outputs after each flush,
+ * and each flush must make at most one write to the bank.  The pattern slots
+ * are then checked directly: a pattern with the same step length is queued
+ * rather than restarted, a new step length restarts the state machine, and a
+ * pattern fails cleanly when no state machine is free.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The code under test. */
+#define partstUSE_HOST_MODEL        1
+#define partstBATCH_UPDATES         1
+#include "ParTest.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define partesttFIRST_GPIO          2U
+#define partesttGPIOS               20U
+#define partesttFLUSHES             200000L
+#define partesttSTATE_MACHINES      2U
+
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvRandomGPIO( void )
+{
+    return partesttFIRST_GPIO + ( UBaseType_t ) ( rand() % partesttGPIOS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStopAllPatterns( void )
+{
+    UBaseType_t uxGPIO;
+
+    for( uxGPIO = 0; uxGPIO < partstNUM_GPIOS; uxGPIO++ )
+    {
+        if( ( ulPatternGPIOs & ( 1UL << uxGPIO ) ) != 0 )
+        {
+            vParTestStopLEDPattern( uxGPIO );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBatchedWrites( void )
+{
+    ParTestStats_t xStats;
+    uint32_t ulReference = 0, ulMask, ulWrites, ulRequests = 0, ulChangedFlushes = 0;
+    UBaseType_t uxGPIO;
+    long lFlush;
+    int iChange, iChanges;
+
+    for( lFlush = 0; lFlush < partesttFLUSHES; lFlush++ )
+    {
+        /* Changes made by any number of tasks between two ticks. */
+        iChanges = rand() % 20;
+
+        for( iChange = 0; iChange < iChanges; iChange++ )
+        {
+            uxGPIO = prvRandomGPIO();
+            ulMask = 1UL << uxGPIO;
+            ulRequests++;
+
+            switch( rand() % 3 )
+            {
+                case 0:
+                    vParTestSetLED( uxGPIO, pdTRUE );
+                    ulReference |= ulMask;
+                    break;
+
+                case 1:
+                    vParTestSetLED( uxGPIO, pdFALSE );
+                    ulReference &= ~ulMask;
+                    break;
+
+                default:
+                    vParTestToggleLED( uxGPIO );
+                    ulReference ^= ulMask;
+                    break;
+            }
+        }
+
+        /* Nothing is written until the tick. */
+        hosttestCHECK( xHostGPIOModel.ulWrites == ulChangedFlushes );
+        ulWrites = xHostGPIOModel.ulWrites;
+
+        vParTestFlushFromISR();
+
+        /* The tick makes at most one write, and leaves the outputs not driven
+        by a state machine as the reference says. */
+        hosttestCHECK( ( xHostGPIOModel.ulWrites - ulWrites ) <= 1U );
+        ulChangedFlushes += xHostGPIOModel.ulWrites - ulWrites;
+        hosttestCHECK( ( xHostGPIOModel.ulOutput & ~ulPatternGPIOs ) == ( ulReference & ~ulPatternGPIOs ) );
+
+        /* Hand a GPIO to a state machine now and then, and take one back. */
+        if( ( rand() % 1000 ) == 0 )
+        {
+            uxGPIO = prvRandomGPIO();
+
+            if( xParTestSetLEDPattern( uxGPIO, 0xf0f0f0f0UL, 100000UL ) == pdPASS )
+            {
+                /* Returned to the SIO low when the pattern stops. */
+                ulReference &= ~( 1UL << uxGPIO );
+            }
+        }
+
+        if( ( ( rand() % 700 ) == 0 ) && ( ulPatternGPIOs != 0 ) )
+        {
+            uxGPIO = ( UBaseType_t ) __builtin_ctz( ulPatternGPIOs );
+            vParTestStopLEDPattern( uxGPIO );
+            ulReference &= ~( 1UL << uxGPIO );
+        }
+    }
+
+    prvStopAllPatterns();
+    vParTestGetStats( &xStats );
+
+    printf( "%u requests, %u writes in %ld ticks\n", ( unsigned ) xStats.ulRequests, ( unsigned ) xStats.ulWrites, partesttFLUSHES );
+
+    hosttestCHECK( xStats.ulRequests == ulRequests );
+    hosttestCHECK( xStats.ulWrites == xHostGPIOModel.ulWrites );
+    hosttestCHECK( xStats.ulWrites == ulChangedFlushes );
+    hosttestCHECK( xStats.ulWrites < xStats.ulRequests );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestPatterns( void )
+{
+    const HostGPIOStateMachine_t * const pxSlot0 = &( xHostGPIOModel.xStateMachines[ 0 ] );
+    uint32_t ulWrites, ulUpdates;
+
+    prvStopAllPatterns();
+    hosttestCHECK( ulPatternGPIOs == 0 );
+    hosttestCHECK( xHostGPIOModel.ulFreeStateMachines == partesttSTATE_MACHINES );
+
+    /* A pattern starts on the first free slot, and a second pattern with the
+    same step length is handed to the running state machine. */
+    hosttestCHECK( xParTestSetLEDPattern( 7, 0x1UL, 1000 ) == pdPASS );
+    hosttestCHECK( pxSlot0->bRunning && ( pxSlot0->ulGPIO == 7 ) );
+    hosttestCHECK( pxSlot0->ulDelayLoops == ( 100U - partstPATTERN_STEP_OVERHEAD ) );
+    ulUpdates = pxSlot0->ulPatternUpdates;
+    hosttestCHECK( xParTestSetLEDPattern( 7, 0x3UL, 1000 ) == pdPASS );
+    hosttestCHECK( pxSlot0->ulPatternUpdates == ( ulUpdates + 1U ) );
+    hosttestCHECK( pxSlot0->ulPattern == 0x3UL );
+
+    /* A new step length restarts the state machine in the same slot. */
+    hosttestCHECK( xParTestSetLEDPattern( 7, 0x3UL, 2000 ) == pdPASS );
+    hosttestCHECK( pxSlot0->ulDelayLoops == ( 200U - partstPATTERN_STEP_OVERHEAD ) );
+    hosttestCHECK( xHostGPIOModel.ulFreeStateMachines == ( partesttSTATE_MACHINES - 1U ) );
+
+    /* Writes to a GPIO driven by a state machine are dropped. */
+    ulWrites = xHostGPIOModel.ulWrites;
+    vParTestSetLED( 7, pdTRUE );
+    vParTestToggleLED( 7 );
+    vParTestFlushFromISR();
+    hosttestCHECK( xHostGPIOModel.ulWrites == ulWrites );
+
+    /* With every state machine in use, another pattern fails and leaves the
+    GPIO with the SIO. */
+    hosttestCHECK( xParTestSetLEDPattern( 8, 0x3UL, 2000 ) == pdPASS );
+    hosttestCHECK( xParTestSetLEDPattern( 9, 0x3UL, 2000 ) == pdFAIL );
+    hosttestCHECK( ( ulPatternGPIOs & ( 1UL << 9 ) ) == 0 );
+    vParTestSetLED( 9, pdTRUE );
+    vParTestFlushFromISR();
+    hosttestCHECK( ( xHostGPIOModel.ulOutput & ( 1UL << 9 ) ) != 0 );
+
+    /* Stopping a pattern returns the GPIO to the SIO. */
+    vParTestStopLEDPattern( 7 );
+    hosttestCHECK( ( xHostGPIOModel.ulOutputEnabled & ( 1UL << 7 ) ) != 0 );
+    vParTestSetLED( 7, pdTRUE );
+    vParTestFlushFromISR();
+    hosttestCHECK( ( xHostGPIOModel.ulOutput & ( 1UL << 7 ) ) != 0 );
+
+    prvStopAllPatterns();
+    hosttestCHECK( xHostGPIOModel.ulFreeStateMachines == partesttSTATE_MACHINES );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    srand( 3 );
+
+    xHostGPIOModel.ulFreeStateMachines = partesttSTATE_MACHINES;
+    vParTestInitialise();
+
+    prvTestBatchedWrites();
+    prvTestPatterns();
+
+    return iHostTestResult( "ParTestTest" );
+}
+/*-----------------------------------------------------------*/
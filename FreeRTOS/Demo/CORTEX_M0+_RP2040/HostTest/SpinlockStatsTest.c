@@ -0,0 +1,176 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the spin lock statistics in Standard/SpinlockStats.c, built
+ * against the software model of the spin locks and timer in
+ * SpinlockStatsHostModel.h.
+ *
+ * Two host threads play the two cores, taking the same lock through
+ * ulSpinlockStatsLock() while a third thread plays the sampling alarm.  The
+ * test checks the lock provided mutual exclusion, that every acquisition was
+ * counted, that contention and held samples were seen, and that a lock nobody
+ * took has no statistics.
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <stdio.h>
+
+/* The code under test. */
+#define spinstatsUSE_HOST_MODEL     1
+#include "SpinlockStats.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define spintestCORES               2
+#define spintestITERATIONS          200000UL
+#define spintestHOLD_LOOPS          5
+#define spintestLOCK                5
+#define spintestUNUSED_LOCK         6
+
+static volatile int iStopSampling = 0;
+static uint32_t ulShared = 0;
+static uint32_t ulPerCore[ spintestCORES ];
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions SpinlockStats.c uses.  The test does not
+start the contention tasks. */
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+    ( void ) pxTaskCode;
+    ( void ) pcName;
+    ( void ) usStackDepth;
+    ( void ) pvParameters;
+    ( void ) uxPriority;
+    ( void ) pxCreatedTask;
+
+    hosttestCHECK( pdFALSE );
+
+    return pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+    ( void ) xTicksToDelay;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvCore( void * pvParameters )
+{
+    const uintptr_t uxCore = ( uintptr_t ) pvParameters;
+    uint32_t ulIteration, ulSaved, ulValue;
+    volatile int iHold;
+
+    for( ulIteration = 0; ulIteration < spintestITERATIONS; ulIteration++ )
+    {
+        ulSaved = ulSpinlockStatsLock( spintestLOCK );
+        {
+            /* Read, wait, then write back, so a failure of mutual exclusion
+            loses an increment. */
+            ulValue = ulShared;
+
+            for( iHold = 0; iHold < spintestHOLD_LOOPS; iHold++ )
+            {
+            }
+
+            ulShared = ulValue + 1;
+            ulPerCore[ uxCore ]++;
+        }
+        vSpinlockStatsUnlock( spintestLOCK, ulSaved );
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvSamplingAlarm( void * pvParameters )
+{
+    while( iStopSampling == 0 )
+    {
+        vSpinlockStatsSampleFromISR();
+    }
+
+    return pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    pthread_t xSampler, xCores[ spintestCORES ];
+    SpinlockStats_t xStats;
+    uint32_t ulSamples;
+    uintptr_t uxCore;
+
+    pthread_create( &xSampler, NULL, prvSamplingAlarm, NULL );
+
+    for( uxCore = 0; uxCore < spintestCORES; uxCore++ )
+    {
+        pthread_create( &( xCores[ uxCore ] ), NULL, prvCore, ( void * ) uxCore );
+    }
+
+    for( uxCore = 0; uxCore < spintestCORES; uxCore++ )
+    {
+        pthread_join( xCores[ uxCore ], NULL );
+    }
+
+    iStopSampling = 1;
+    pthread_join( xSampler, NULL );
+
+    ulSamples = ulSpinlockStatsGet( spintestLOCK, &xStats );
+
+    printf( "acquisitions %u, contended %u, spins %u (max %u), max hold %uus, held in %u of %u samples\n",
+            ( unsigned ) xStats.ulAcquisitions, ( unsigned ) xStats.ulContendedAcquisitions,
+            ( unsigned ) xStats.ulSpinIterations, ( unsigned ) xStats.ulMaxSpinIterations,
+            ( unsigned ) xStats.ulMaxHoldTime, ( unsigned ) xStats.ulHeldSamples, ( unsigned ) ulSamples );
+
+    /* The lock provided mutual exclusion and every acquisition was counted. */
+    hosttestCHECK( ulShared == ( spintestCORES * spintestITERATIONS ) );
+    hosttestCHECK( ulPerCore[ 0 ] == spintestITERATIONS );
+    hosttestCHECK( ulPerCore[ 1 ] == spintestITERATIONS );
+    hosttestCHECK( xStats.ulAcquisitions == ( spintestCORES * spintestITERATIONS ) );
+
+    /* The cores contended, and the sampler saw the lock held. */
+    hosttestCHECK( xStats.ulContendedAcquisitions > 0 );
+    hosttestCHECK( xStats.ulSpinIterations >= xStats.ulContendedAcquisitions );
+    hosttestCHECK( xStats.ulMaxSpinIterations > 0 );
+    hosttestCHECK( xStats.ulHeldSamples > 0 );
+    hosttestCHECK( xStats.ulHeldSamples <= ulSamples );
+
+    /* Every lock was released, and an unused lock has no statistics. */
+    hosttestCHECK( ulHostSpinlockGetState() == 0 );
+    ulSpinlockStatsGet( spintestUNUSED_LOCK, &xStats );
+    hosttestCHECK( xStats.ulAcquisitions == 0 );
+    hosttestCHECK( xStats.ulHeldSamples == 0 );
+
+    return iHostTestResult( "SpinlockStatsTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,318 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the SMP tickless idle in Standard/TicklessIdle.c, built against
+ * the software model of SysTick, the timer and waiting for an event in
+ * TicklessIdleHostModel.h.
+ *
+ * The test plays the kernel, both cores and the interrupts.  It checks that:
+ *
+ * + Over many sleeps of random length, some ended early by an interrupt and
+ *   some abandoned, the tick count is never stepped up to the tick at which a
+ *   task unblocks and SysTick stays in phase with where it would have been had
+ *   it never stopped.
+ *
+ * + The tick core does not sleep while the other core is running a task.
+ *
+ * + The other core switching in a task while the tick core sleeps wakes the
+ *   tick core straight away, rather than when the next task unblocks.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The code under test. */
+#define ticklessUSE_HOST_MODEL      1
+#include "TicklessIdle.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define tltestCYCLES_PER_TICK       ( ( uint64_t ) hostticklessCYCLES_PER_US * ticklessUS_PER_TICK )
+#define tltestOTHER_CORE            ( ( configTICK_CORE + 1 ) % configNUM_CORES )
+#define tltestRANDOM_SLEEPS         100000L
+
+/* The kernel's tick count, and the tick at which the next task unblocks. */
+static TickType_t xTickCount = 0, xNextUnblockTick = 0;
+
+/* Makes the next call to eTaskConfirmSleepModeStatus() abort the sleep. */
+static BaseType_t xAbortNextSleep = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions TicklessIdle.c uses. */
+
+eSleepModeStatus eTaskConfirmSleepModeStatus( void )
+{
+    eSleepModeStatus eReturn = eStandardSleep;
+
+    if( xAbortNextSleep != pdFALSE )
+    {
+        xAbortNextSleep = pdFALSE;
+        eReturn = eAbortSleep;
+    }
+
+    return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskStepTick( const TickType_t xTicksToJump )
+{
+    /* The tick at which a task unblocks must be left to the tick interrupt. */
+    hosttestCHECK( ( xTickCount + xTicksToJump ) < xNextUnblockTick );
+    xTickCount += xTicksToJump;
+}
+/*-----------------------------------------------------------*/
+
+/* Process ulTicks tick interrupts. */
+static void prvTick( uint32_t ulTicks )
+{
+    while( ulTicks-- > 0 )
+    {
+        xTickCount++;
+
+        if( xTickCount >= xNextUnblockTick )
+        {
+            xNextUnblockTick = xTickCount + 2 + ( TickType_t ) ( rand() % 800 );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Take the ticks that became pending while the tick core slept. */
+static void prvTakeMissedTicks( void )
+{
+    prvTick( xHostTicklessModel.ulMissedTicks );
+    xHostTicklessModel.ulMissedTicks = 0;
+}
+/*-----------------------------------------------------------*/
+
+/* Call xFunction as if on the other core. */
+static void prvOnOtherCore( void ( *xFunction )( void ) )
+{
+    uxHostTestCoreID = tltestOTHER_CORE;
+    xFunction();
+    uxHostTestCoreID = configTICK_CORE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvOtherCoreGoesIdle( void )
+{
+    vApplicationSleep( portMAX_DELAY );
+}
+/*-----------------------------------------------------------*/
+
+/* Start from time zero, with a tick due every tltestCYCLES_PER_TICK cycles
+and the other core idle. */
+static void prvReset( void )
+{
+    xHostTicklessModel = ( HostTicklessModel_t ) { 0 };
+    xHostTicklessModel.ulLoad = ( uint32_t ) tltestCYCLES_PER_TICK - 1U;
+    xHostTicklessModel.bSysTickEnabled = true;
+    xHostTicklessModel.ullNextTickCycles = tltestCYCLES_PER_TICK;
+    xHostTicklessModel.ullInterruptCycles = UINT64_MAX;
+    xHostTicklessModel.ullOtherCoreCycles = UINT64_MAX;
+
+    xTickCount = 0;
+    xNextUnblockTick = 5;
+    prvOnOtherCore( prvOtherCoreGoesIdle );
+}
+/*-----------------------------------------------------------*/
+
+/* The tick count matches the ticks that have passed, and the next tick is due
+where it would have been had SysTick never stopped - to within ulSlackCycles. */
+static void prvCheckInPhase( uint64_t ulSlackCycles )
+{
+    const uint64_t ullDue = ( ( uint64_t ) xTickCount + 1U ) * tltestCYCLES_PER_TICK;
+    const uint64_t ullNext = xHostTicklessModel.ullNextTickCycles;
+
+    hosttestCHECK( xHostTicklessModel.bSysTickEnabled );
+    hosttestCHECK( ( ullNext + ulSlackCycles >= ullDue ) && ( ullNext <= ullDue + ulSlackCycles ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomSleeps( void )
+{
+    TicklessIdleStats_t xBefore, xAfter;
+    TickType_t xExpectedIdleTime, xUnblockTick;
+    bool bInterrupted;
+    long lSleep;
+
+    prvReset();
+    vTicklessIdleGetStats( &xBefore );
+
+    for( lSleep = 0; lSleep < tltestRANDOM_SLEEPS; lSleep++ )
+    {
+        prvTick( ulHostTicklessRun( ( uint64_t ) rand() % ( 3U * tltestCYCLES_PER_TICK ) ) );
+
+        xExpectedIdleTime = xNextUnblockTick - xTickCount;
+
+        if( xExpectedIdleTime < 2 )
+        {
+            continue;
+        }
+
+        /* One sleep in four is ended early by another interrupt, and one in
+        fifty is abandoned because a task became ready. */
+        bInterrupted = ( rand() % 4 ) == 0;
+
+        if( bInterrupted )
+        {
+            xHostTicklessModel.ullInterruptCycles = xHostTicklessModel.ullCycles +
+                                                    ( ( uint64_t ) rand() % ( xExpectedIdleTime * tltestCYCLES_PER_TICK ) );
+        }
+
+        xAbortNextSleep = ( rand() % 50 ) == 0;
+        xUnblockTick = xNextUnblockTick;
+
+        vApplicationSleep( xExpectedIdleTime );
+        prvTakeMissedTicks();
+        xHostTicklessModel.ullInterruptCycles = UINT64_MAX;
+
+        hosttestCHECK( xTickCount < xUnblockTick );
+
+        if( bInterrupted == false )
+        {
+            /* Run on to the tick at which the task unblocks, which must be
+            taken on time. */
+            while( xTickCount < xUnblockTick )
+            {
+                prvTick( ulHostTicklessRun( 1000 ) );
+            }
+
+            hosttestCHECK( xHostTicklessModel.ullCycles < ( ( uint64_t ) xUnblockTick * tltestCYCLES_PER_TICK ) + 1000U );
+        }
+    }
+
+    vTicklessIdleGetStats( &xAfter );
+
+    printf( "%u sleeps, %u aborted, %u woken early, %u ticks suppressed, next tick %lld cycles out\n",
+            ( unsigned ) ( xAfter.ulSleeps - xBefore.ulSleeps ),
+            ( unsigned ) ( xAfter.ulAborted - xBefore.ulAborted ),
+            ( unsigned ) ( xAfter.ulEarlyWakes - xBefore.ulEarlyWakes ),
+            ( unsigned ) ( xAfter.ulTicksSuppressed - xBefore.ulTicksSuppressed ),
+            ( long long ) xHostTicklessModel.ullNextTickCycles - ( ( long long ) xTickCount + 1 ) * ( long long ) tltestCYCLES_PER_TICK );
+
+    hosttestCHECK( ( xAfter.ulSleeps - xBefore.ulSleeps ) > ( tltestRANDOM_SLEEPS / 2 ) );
+    hosttestCHECK( xAfter.ulAborted > xBefore.ulAborted );
+    hosttestCHECK( xAfter.ulEarlyWakes > xBefore.ulEarlyWakes );
+
+    /* Each sleep may lose at most a few cycles of phase. */
+    prvCheckInPhase( ( uint64_t ) ( xAfter.ulSleeps - xBefore.ulSleeps ) * hostticklessCYCLES_PER_US );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestOtherCoreBusy( void )
+{
+    TicklessIdleStats_t xBefore, xAfter;
+
+    prvReset();
+    xNextUnblockTick = 100;
+    vTicklessIdleGetStats( &xBefore );
+
+    /* A task running on the other core keeps the tick core awake. */
+    prvOnOtherCore( vTicklessIdleTaskSwitchedIn );
+    vApplicationSleep( xNextUnblockTick - xTickCount );
+
+    vTicklessIdleGetStats( &xAfter );
+    hosttestCHECK( xAfter.ulOtherCoreBusy == xBefore.ulOtherCoreBusy + 1 );
+    hosttestCHECK( xAfter.ulSleeps == xBefore.ulSleeps );
+    hosttestCHECK( xHostTicklessModel.ullCycles == 0 );
+    hosttestCHECK( xTickCoreSleeping == pdFALSE );
+    prvCheckInPhase( 0 );
+
+    /* Once the other core is idle again the tick core sleeps. */
+    prvOnOtherCore( prvOtherCoreGoesIdle );
+    vApplicationSleep( xNextUnblockTick - xTickCount );
+    prvTakeMissedTicks();
+
+    vTicklessIdleGetStats( &xAfter );
+    hosttestCHECK( xAfter.ulSleeps == xBefore.ulSleeps + 1 );
+    hosttestCHECK( xTickCount == xNextUnblockTick - 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvOtherCoreSwitchesInTask( void )
+{
+    prvOnOtherCore( vTicklessIdleTaskSwitchedIn );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestWakeFromOtherCore( void )
+{
+    TicklessIdleStats_t xBefore, xAfter;
+    const uint64_t ullSwitchCycles = ( 10U * tltestCYCLES_PER_TICK ) + ( tltestCYCLES_PER_TICK / 2U );
+
+    prvReset();
+    xNextUnblockTick = 100;
+    vTicklessIdleGetStats( &xBefore );
+
+    /* Half way through the eleventh tick period an interrupt on the other core
+    unblocks a task, which the other core switches in. */
+    xHostTicklessModel.ullOtherCoreCycles = ullSwitchCycles;
+    xHostTicklessModel.pxOtherCoreEvent = prvOtherCoreSwitchesInTask;
+
+    vApplicationSleep( xNextUnblockTick - xTickCount );
+    prvTakeMissedTicks();
+
+    vTicklessIdleGetStats( &xAfter );
+
+    /* The tick core woke within a microsecond of the task being switched in,
+    with the ten ticks that passed accounted for and the tick back in phase. */
+    hosttestCHECK( xAfter.ulSleeps == xBefore.ulSleeps + 1 );
+    hosttestCHECK( xAfter.ulEarlyWakes == xBefore.ulEarlyWakes + 1 );
+    hosttestCHECK( xHostTicklessModel.ullCycles >= ullSwitchCycles );
+    hosttestCHECK( xHostTicklessModel.ullCycles <= ullSwitchCycles + ( 2U * hostticklessCYCLES_PER_US ) );
+    hosttestCHECK( xTickCount == 10 );
+    hosttestCHECK( xTickCoreSleeping == pdFALSE );
+    prvCheckInPhase( 2U * hostticklessCYCLES_PER_US );
+
+    /* The other core is now busy, so the tick core does not sleep again. */
+    vApplicationSleep( xNextUnblockTick - xTickCount );
+    vTicklessIdleGetStats( &xAfter );
+    hosttestCHECK( xAfter.ulOtherCoreBusy == xBefore.ulOtherCoreBusy + 1 );
+
+    /* A task switched in on the other core while the tick core is awake does
+    not leave a wake request behind. */
+    prvOnOtherCore( vTicklessIdleTaskSwitchedIn );
+    hosttestCHECK( xWakeRequested == pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    srand( 1 );
+
+    prvTestRandomSleeps();
+    prvTestOtherCoreBusy();
+    prvTestWakeFromOtherCore();
+
+    return iHostTestResult( "TicklessIdleTest" );
+}
+/*-----------------------------------------------------------*/
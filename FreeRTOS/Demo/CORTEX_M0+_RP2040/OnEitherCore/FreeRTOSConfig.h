@@ -107,7 +107,12 @@
 #define configRUN_MULTIPLE_PRIORITIES           1
 
 /* RP2040 specific */
+/* SDK synchronization primitive interop uses the SIO FIFO interrupt, so builds
+that use the FIFO for the intercore channel (IntercoreChannel.c) set this to 0
+from CMakeLists.txt. */
+#ifndef configSUPPORT_PICO_SYNC_INTEROP
 #define configSUPPORT_PICO_SYNC_INTEROP         1
+#endif
 #define configSUPPORT_PICO_TIME_INTEROP         1
 
 #include <assert.h>
@@ -0,0 +1,354 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * See the comments at the top of IntercoreChannel.h.
+ *
+ * The ring is written only by the SDK core and read only by the RTOS core, so
+ * it needs no lock - the SDK core owns ulHead and the RTOS core owns ulTail.
+ *
+ * Deciding when to ring the doorbell is the only subtle part.  Ringing on
+ * every message would cost an interrupt per message, so the sender only rings
+ * when the message it has just published is the only message in the ring -
+ * that is, when the receiver has consumed everything before it and so might be
+ * about to block.  A wake up cannot be lost because each side publishes its
+ * own index before reading the other side's:
+ *
+ *   Sender:   ulHead = head + 1; barrier; if( ulTail == head ) ring.
+ *   Receiver: ulTail = tail;     barrier; if( ulHead == tail ) block.
+ *
+ * If the receiver reads the old ulHead and blocks then its write to ulTail
+ * happened first, so the sender must see ulTail == head and ring.  Otherwise
+ * the receiver sees the new message and does not block.  A doorbell that turns
+ * out to be unnecessary just leaves a notification pending, which costs the
+ * receiver one extra pass through its loop.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+
+/* Demo includes. */
+#include "IntercoreChannel.h"
+
+/* Set channelUSE_HOST_FIFO_MODEL to 1 to build the channel against the
+software model of the SIO FIFO in IntercoreChannelHostModel.h rather than the
+RP2040 hardware, so the ring and doorbell logic can be exercised on a host. */
+#ifndef channelUSE_HOST_FIFO_MODEL
+    #define channelUSE_HOST_FIFO_MODEL  0
+#endif
+
+#if ( channelUSE_HOST_FIFO_MODEL == 1 )
+    #include "IntercoreChannelHostModel.h"
+
+    HostFIFOModel_t xHostFIFOModel;
+
+    #define channelMEMORY_BARRIER()         __sync_synchronize()
+    #define channelFIFO_WRITE_READY()       bHostFIFOModelWriteReady()
+    #define channelFIFO_PUSH( ulWord )      vHostFIFOModelPush( ulWord )
+    #define channelFIFO_READ_VALID()        bHostFIFOModelReadValid()
+    #define channelFIFO_POP()               ulHostFIFOModelPop()
+    #define channelFIFO_CLEAR_IRQ()         vHostFIFOModelClearIRQ()
+    #define channelFIFO_INSTALL_HANDLER( pxHandler )    vHostFIFOModelInstallHandler( pxHandler )
+#else
+    #include "pico/multicore.h"
+    #include "hardware/irq.h"
+    #include "hardware/sync.h"
+
+    #if ( configSUPPORT_PICO_SYNC_INTEROP == 1 )
+        #error The port uses the SIO FIFO interrupt when configSUPPORT_PICO_SYNC_INTEROP is 1.
+    #endif
+
+    /* The sender is the only writer to its FIFO, so once there is space the
+    push cannot block.  Likewise the handler only pops when there is data. */
+    #define channelMEMORY_BARRIER()         __dmb()
+    #define channelFIFO_WRITE_READY()       multicore_fifo_wready()
+    #define channelFIFO_PUSH( ulWord )      multicore_fifo_push_blocking( ulWord )
+    #define channelFIFO_READ_VALID()        multicore_fifo_rvalid()
+    #define channelFIFO_POP()               multicore_fifo_pop_blocking()
+    #define channelFIFO_CLEAR_IRQ()         multicore_fifo_clear_irq()
+    #define channelFIFO_INSTALL_HANDLER( pxHandler )                            \
+    do {                                                                        \
+        irq_set_exclusive_handler( SIO_IRQ_PROC0 + get_core_num(), pxHandler );  \
+        irq_set_enabled( SIO_IRQ_PROC0 + get_core_num(), true );                \
+    } while( 0 )
+#endif
+
+/* The number of messages the ring can hold.  Must be a power of two. */
+#ifndef channelRING_LENGTH
+    #define channelRING_LENGTH          64
+#endif
+
+/* The task notification index used to wake the receiving task. */
+#ifndef channelNOTIFICATION_INDEX
+    #define channelNOTIFICATION_INDEX   0
+#endif
+
+#if ( ( channelRING_LENGTH & ( channelRING_LENGTH - 1 ) ) != 0 )
+    #error channelRING_LENGTH must be a power of two.
+#endif
+
+#define channelRING_INDEX_MASK          ( ( uint32_t ) channelRING_LENGTH - 1UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The SIO FIFO interrupt handler, which runs on the RTOS core.
+ */
+static void prvDoorbellInterruptHandler( void );
+
+/*
+ * Install the SIO FIFO interrupt handler on the calling core, if it is not
+ * already installed.
+ */
+static void prvInstallDoorbellInterrupt( void );
+
+/*
+ * Copy the oldest message out of the ring, returning false if the ring is
+ * empty.
+ */
+static bool prvRingGet( IntercoreMessage_t *pxMessage );
+
+/*-----------------------------------------------------------*/
+
+/* The indexes increment freely and are masked on use, so the ring is empty
+when they are equal and full when they differ by channelRING_LENGTH. */
+static volatile uint32_t ulHead = 0;    /* Written only by the SDK core. */
+static volatile uint32_t ulTail = 0;    /* Written only by the RTOS core. */
+static IntercoreMessage_t xRing[ channelRING_LENGTH ];
+
+/* The task woken by the doorbell.  NULL until the first receive. */
+static TaskHandle_t volatile xReceivingTask = NULL;
+
+/* Called for FIFO words written by other services. */
+static IntercoreDoorbellHandler_t volatile pxDoorbellHandler = NULL;
+static bool bInterruptInstalled = false;
+
+/* Each counter is only written by one core. */
+static volatile uint32_t ulMessagesSent = 0, ulSendsRingFull = 0, ulDoorbellsRung = 0;
+static volatile uint32_t ulDoorbellInterrupts = 0, ulMessagesReceived = 0;
+
+/*-----------------------------------------------------------*/
+
+void vIntercoreChannelInit( void )
+{
+    ulHead = 0;
+    ulTail = 0;
+    xReceivingTask = NULL;
+    pxDoorbellHandler = NULL;
+    bInterruptInstalled = false;
+    ulMessagesSent = 0;
+    ulSendsRingFull = 0;
+    ulDoorbellsRung = 0;
+    ulDoorbellInterrupts = 0;
+    ulMessagesReceived = 0;
+}
+/*-----------------------------------------------------------*/
+
+bool bIntercoreChannelSend( const IntercoreMessage_t *pxMessage )
+{
+    uint32_t ulLocalHead = ulHead;
+    bool bReturn = false;
+
+    if( ( ulLocalHead - ulTail ) >= ( uint32_t ) channelRING_LENGTH )
+    {
+        ulSendsRingFull++;
+    }
+    else
+    {
+        xRing[ ulLocalHead & channelRING_INDEX_MASK ] = *pxMessage;
+
+        /* The message must be visible before the updated head. */
+        channelMEMORY_BARRIER();
+        ulHead = ulLocalHead + 1UL;
+
+        /* And the updated head must be visible before the tail is read - see
+        the comments at the top of this file. */
+        channelMEMORY_BARRIER();
+
+        if( ulTail == ulLocalHead )
+        {
+            /* If the FIFO is full then the interrupt is already pending, and
+            the handler checks the ring after emptying the FIFO. */
+            if( channelFIFO_WRITE_READY() )
+            {
+                channelFIFO_PUSH( channelDOORBELL );
+                ulDoorbellsRung++;
+            }
+        }
+
+        ulMessagesSent++;
+        bReturn = true;
+    }
+
+    return bReturn;
+}
+/*-----------------------------------------------------------*/
+
+static bool prvRingGet( IntercoreMessage_t *pxMessage )
+{
+    uint32_t ulLocalTail = ulTail;
+    bool bReturn = false;
+
+    /* Order the previous write to ulTail before the read of ulHead - see the
+    comments at the top of this file. */
+    channelMEMORY_BARRIER();
+
+    if( ulHead != ulLocalTail )
+    {
+        /* The read of ulHead must complete before the message is read. */
+        channelMEMORY_BARRIER();
+        *pxMessage = xRing[ ulLocalTail & channelRING_INDEX_MASK ];
+
+        /* And the message must be read before the slot is released. */
+        channelMEMORY_BARRIER();
+        ulTail = ulLocalTail + 1UL;
+
+        ulMessagesReceived++;
+        bReturn = true;
+    }
+
+    return bReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIntercoreChannelReceive( IntercoreMessage_t *pxMessage, TickType_t xTicksToWait )
+{
+    BaseType_t xReturn = pdFAIL;
+    TimeOut_t xTimeOut;
+
+    if( xReceivingTask == NULL )
+    {
+        /* First call. */
+        xReceivingTask = xTaskGetCurrentTaskHandle();
+        prvInstallDoorbellInterrupt();
+    }
+
+    /* There can only be one receiver. */
+    configASSERT( xReceivingTask == xTaskGetCurrentTaskHandle() );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ;; )
+    {
+        if( prvRingGet( pxMessage ) != false )
+        {
+            xReturn = pdPASS;
+            break;
+        }
+
+        /* The ring was empty after ulTail was published, so if a message
+        arrives from now on the doorbell will be rung and the notification
+        will be pending. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            break;
+        }
+
+        ( void ) ulTaskNotifyTakeIndexed( channelNOTIFICATION_INDEX, pdTRUE, xTicksToWait );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vIntercoreChannelSetDoorbellHandler( IntercoreDoorbellHandler_t pxHandler )
+{
+    pxDoorbellHandler = pxHandler;
+    prvInstallDoorbellInterrupt();
+}
+/*-----------------------------------------------------------*/
+
+static void prvInstallDoorbellInterrupt( void )
+{
+    taskENTER_CRITICAL();
+    {
+        if( bInterruptInstalled == false )
+        {
+            /* Each core has its own receive FIFO and interrupt, so the handler
+            has to be installed from the core that will take it, which is the
+            core the calling task is running on.  Any words already written
+            stay in the FIFO, so the interrupt is taken as soon as it is
+            enabled.  Overflow and underflow flags left over from before a
+            reset are discarded. */
+            channelFIFO_CLEAR_IRQ();
+            channelFIFO_INSTALL_HANDLER( prvDoorbellInterruptHandler );
+            bInterruptInstalled = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvDoorbellInterruptHandler( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t ulWord;
+
+    /* The interrupt remains asserted while the FIFO holds data, so it must be
+    emptied.  Any number of channel doorbells are handled by one
+    notification. */
+    while( channelFIFO_READ_VALID() )
+    {
+        ulWord = channelFIFO_POP();
+
+        if( ( ulWord != channelDOORBELL ) && ( pxDoorbellHandler != NULL ) )
+        {
+            pxDoorbellHandler( ulWord, &xHigherPriorityTaskWoken );
+        }
+    }
+
+    channelFIFO_CLEAR_IRQ();
+    ulDoorbellInterrupts++;
+
+    /* The sender does not ring the doorbell if the FIFO is full, so rather
+    than relying on having seen a channelDOORBELL word, check the ring itself.
+    The FIFO was emptied after the sender saw it full, so the sender's new head
+    is visible. */
+    channelMEMORY_BARRIER();
+
+    if( ( xReceivingTask != NULL ) && ( ulHead != ulTail ) )
+    {
+        vTaskNotifyGiveIndexedFromISR( xReceivingTask, channelNOTIFICATION_INDEX, &xHigherPriorityTaskWoken );
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vIntercoreChannelGetStats( IntercoreChannelStats_t *pxStats )
+{
+    pxStats->ulMessagesSent = ulMessagesSent;
+    pxStats->ulSendsRingFull = ulSendsRingFull;
+    pxStats->ulDoorbellsRung = ulDoorbellsRung;
+    pxStats->ulDoorbellInterrupts = ulDoorbellInterrupts;
+    pxStats->ulMessagesReceived = ulMessagesReceived;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,111 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef INTERCORE_CHANNEL_H
+#define INTERCORE_CHANNEL_H
+
+/*
+ * A message channel from the core running the plain SDK (the "SDK core") to
+ * the core running FreeRTOS (the "RTOS core").
+ *
+ * Messages are copied into a single producer single consumer ring buffer held
+ * in shared RAM.  The SIO inter-core FIFO carries no data - it is only used as
+ * a doorbell that raises the SIO FIFO interrupt on the RTOS core, and the
+ * interrupt handler wakes the receiving task with a direct to task
+ * notification.  The doorbell is only rung when the receiver has emptied the
+ * ring, so a burst of messages costs one interrupt, not one per message.
+ *
+ * The RP2040 FreeRTOS port uses the same interrupt to implement
+ * configSUPPORT_PICO_SYNC_INTEROP, so the channel can only be used in builds
+ * that set configSUPPORT_PICO_SYNC_INTEROP to 0.
+ */
+
+/* The word the channel writes to the SIO FIFO.  Other users of the FIFO must
+not write this value - see vIntercoreChannelSetDoorbellHandler(). */
+#define channelDOORBELL                 ( 0x0D00BE11UL )
+
+/* The prototype of the function called for FIFO words other than
+channelDOORBELL. */
+typedef void ( *IntercoreDoorbellHandler_t )( uint32_t ulWord, BaseType_t *pxHigherPriorityTaskWoken );
+
+/* The messages passed through the channel.  The meaning of each member is
+defined by the application. */
+typedef struct IntercoreMessage
+{
+    uint32_t ulType;
+    uint32_t ulValue;
+    uint32_t ulTimeStamp;
+} IntercoreMessage_t;
+
+/* Counters maintained by the channel. */
+typedef struct IntercoreChannelStats
+{
+    uint32_t ulMessagesSent;        /* Messages successfully written to the ring. */
+    uint32_t ulSendsRingFull;       /* Sends that failed because the ring was full. */
+    uint32_t ulDoorbellsRung;       /* Words written to the SIO FIFO. */
+    uint32_t ulDoorbellInterrupts;  /* SIO FIFO interrupts taken on the RTOS core. */
+    uint32_t ulMessagesReceived;
+} IntercoreChannelStats_t;
+
+/*
+ * Reset the channel.  Must be called before the SDK core is launched and before
+ * the scheduler is started.
+ */
+void vIntercoreChannelInit( void );
+
+/*
+ * Called on the SDK core.  Copies *pxMessage into the ring and, if necessary,
+ * rings the doorbell.  Never blocks - returns false if the ring is full.
+ */
+bool bIntercoreChannelSend( const IntercoreMessage_t *pxMessage );
+
+/*
+ * Called from a single task on the RTOS core.  Copies the oldest message in
+ * the ring into *pxMessage, blocking for up to xTicksToWait ticks for one to
+ * arrive.  The first call installs the SIO FIFO interrupt handler on the
+ * calling core and makes the calling task the channel's receiver.  Uses the
+ * receiving task's notification value at index channelNOTIFICATION_INDEX.
+ *
+ * Returns pdPASS if a message was received, otherwise pdFAIL.
+ */
+BaseType_t xIntercoreChannelReceive( IntercoreMessage_t *pxMessage, TickType_t xTicksToWait );
+
+/*
+ * Other services can share the SIO FIFO interrupt by writing their own words
+ * (any value other than channelDOORBELL) to the FIFO from the SDK core.  The
+ * interrupt handler passes each such word to pxHandler, from the interrupt.
+ * Must be called from a task on the RTOS core, as it also installs the
+ * interrupt handler on the calling core if that has not already been done.
+ */
+void vIntercoreChannelSetDoorbellHandler( IntercoreDoorbellHandler_t pxHandler );
+
+/*
+ * Take a snapshot of the channel's counters.
+ */
+void vIntercoreChannelGetStats( IntercoreChannelStats_t *pxStats );
+
+#endif /* INTERCORE_CHANNEL_H */
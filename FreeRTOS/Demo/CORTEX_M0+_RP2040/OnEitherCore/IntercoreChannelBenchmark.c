@@ -0,0 +1,258 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A throughput and latency benchmark for the channel implemented in
+ * IntercoreChannel.c.
+ *
+ * The SDK core alternates between two phases, each chanbenchPHASE_US long.  In
+ * the burst phase it sends messages as fast as the ring accepts them, which
+ * measures throughput - the receiver rarely finds the ring empty so the
+ * doorbell is rarely rung.  In the paced phase it sends one message every
+ * chanbenchPACED_INTERVAL_US, which measures the latency of the full doorbell,
+ * interrupt and task wake up path, as the receiver blocks between messages.
+ *
+ * Each message carries a sequence number and the time at which it was sent,
+ * read from the 1MHz system timer that both cores can see.  The receiving task
+ * checks the sequence for lost or reordered messages, and prints the results
+ * for each phase when the next phase starts.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* SDK includes. */
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+
+/* Demo includes. */
+#include "IntercoreChannel.h"
+#include "IntercoreChannelBenchmark.h"
+
+/* The time the sender spends in each phase. */
+#ifndef chanbenchPHASE_US
+    #define chanbenchPHASE_US           ( 1000000UL )
+#endif
+
+/* The interval between messages in the paced phase. */
+#ifndef chanbenchPACED_INTERVAL_US
+    #define chanbenchPACED_INTERVAL_US  ( 100UL )
+#endif
+
+/* Values for the ulType member of the benchmark messages. */
+#define chanbenchBURST                  ( 0UL )
+#define chanbenchPACED                  ( 1UL )
+#define chanbenchNUMBER_OF_PHASES       ( 2UL )
+
+/* Long enough for the receiver to notice if the sender stops. */
+#define chanbenchRECEIVE_TIMEOUT        pdMS_TO_TICKS( 2000 )
+
+/*-----------------------------------------------------------*/
+
+/* The results gathered for one phase. */
+typedef struct ChannelPhaseResults
+{
+    uint32_t ulMessages;
+    uint32_t ulFirstReceiveTime;
+    uint32_t ulLastReceiveTime;
+    uint64_t ullTotalLatency;
+    uint32_t ulMaxLatency;
+} ChannelPhaseResults_t;
+
+/*
+ * The task that receives the messages.
+ */
+static void prvChannelBenchmarkReceiveTask( void *pvParameters );
+
+/*
+ * Print and then clear the results of a phase.
+ */
+static void prvReportPhase( uint32_t ulPhase, ChannelPhaseResults_t *pxResults );
+
+/*
+ * Send a message, retrying until there is space in the ring.  The time stamp
+ * is taken when the message is actually sent.
+ */
+static void prvSendMessage( uint32_t ulPhase, uint32_t ulSequence );
+
+/*-----------------------------------------------------------*/
+
+/* Incremented by the receiver each time a message arrives out of sequence. */
+static uint32_t ulSequenceErrors = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartIntercoreChannelBenchmark( UBaseType_t uxPriority )
+{
+    vIntercoreChannelInit();
+    xTaskCreate( prvChannelBenchmarkReceiveTask, "ChanRx", configMINIMAL_STACK_SIZE * 2, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendMessage( uint32_t ulPhase, uint32_t ulSequence )
+{
+    IntercoreMessage_t xMessage;
+
+    xMessage.ulType = ulPhase;
+    xMessage.ulValue = ulSequence;
+
+    do
+    {
+        xMessage.ulTimeStamp = time_us_32();
+    } while( bIntercoreChannelSend( &xMessage ) == false );
+}
+/*-----------------------------------------------------------*/
+
+void vIntercoreChannelBenchmarkSender( void )
+{
+    uint32_t ulSequence = 0, ulPhaseEnd, ulNextSend;
+
+    printf("Core %d: Sending intercore channel benchmark messages\n", get_core_num());
+
+    for( ;; )
+    {
+        ulPhaseEnd = time_us_32() + chanbenchPHASE_US;
+
+        while( ( int32_t ) ( time_us_32() - ulPhaseEnd ) < 0 )
+        {
+            prvSendMessage( chanbenchBURST, ulSequence++ );
+        }
+
+        ulPhaseEnd = time_us_32() + chanbenchPHASE_US;
+        ulNextSend = time_us_32();
+
+        while( ( int32_t ) ( ulNextSend - ulPhaseEnd ) < 0 )
+        {
+            while( ( int32_t ) ( time_us_32() - ulNextSend ) < 0 )
+            {
+                tight_loop_contents();
+            }
+
+            prvSendMessage( chanbenchPACED, ulSequence++ );
+            ulNextSend += chanbenchPACED_INTERVAL_US;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportPhase( uint32_t ulPhase, ChannelPhaseResults_t *pxResults )
+{
+    static const char * const pcPhaseNames[ chanbenchNUMBER_OF_PHASES ] = { "burst", "paced" };
+    uint32_t ulElapsed, ulRate = 0, ulMeanLatency = 0;
+    IntercoreChannelStats_t xStats;
+
+    if( pxResults->ulMessages > 1UL )
+    {
+        ulElapsed = pxResults->ulLastReceiveTime - pxResults->ulFirstReceiveTime;
+
+        if( ulElapsed > 0UL )
+        {
+            ulRate = ( uint32_t ) ( ( ( uint64_t ) ( pxResults->ulMessages - 1UL ) * 1000000ULL ) / ulElapsed );
+        }
+
+        ulMeanLatency = ( uint32_t ) ( pxResults->ullTotalLatency / pxResults->ulMessages );
+    }
+
+    vIntercoreChannelGetStats( &xStats );
+
+    printf("Core %d - Thread '%s': %s: %lu msgs/s, latency mean %lu us max %lu us\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()),
+           pcPhaseNames[ ulPhase ], ( unsigned long ) ulRate, ( unsigned long ) ulMeanLatency, ( unsigned long ) pxResults->ulMaxLatency);
+    printf("Core %d - Thread '%s': sent %lu, ring full %lu, doorbells %lu, interrupts %lu, sequence errors %lu\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()),
+           ( unsigned long ) xStats.ulMessagesSent, ( unsigned long ) xStats.ulSendsRingFull, ( unsigned long ) xStats.ulDoorbellsRung,
+           ( unsigned long ) xStats.ulDoorbellInterrupts, ( unsigned long ) ulSequenceErrors);
+
+    memset( pxResults, 0x00, sizeof( ChannelPhaseResults_t ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvChannelBenchmarkReceiveTask( void *pvParameters )
+{
+    ChannelPhaseResults_t xResults[ chanbenchNUMBER_OF_PHASES ];
+    IntercoreMessage_t xMessage;
+    uint32_t ulExpectedSequence = 0, ulCurrentPhase = chanbenchBURST, ulNow, ulLatency;
+    uint32_t ulReportEndTime = time_us_32();
+    ChannelPhaseResults_t *pxResults;
+
+    ( void ) pvParameters;
+
+    memset( xResults, 0x00, sizeof( xResults ) );
+
+    for( ;; )
+    {
+        if( xIntercoreChannelReceive( &xMessage, chanbenchRECEIVE_TIMEOUT ) == pdPASS )
+        {
+            ulNow = time_us_32();
+            configASSERT( xMessage.ulType < chanbenchNUMBER_OF_PHASES );
+
+            if( xMessage.ulValue != ulExpectedSequence )
+            {
+                ulSequenceErrors++;
+            }
+
+            ulExpectedSequence = xMessage.ulValue + 1UL;
+
+            if( xMessage.ulType != ulCurrentPhase )
+            {
+                prvReportPhase( ulCurrentPhase, &( xResults[ ulCurrentPhase ] ) );
+                ulCurrentPhase = xMessage.ulType;
+                ulReportEndTime = time_us_32();
+            }
+
+            /* Messages sent while the results were being printed have been
+            waiting in the ring for the printf() calls to complete, so are not
+            timed. */
+            if( ( int32_t ) ( xMessage.ulTimeStamp - ulReportEndTime ) < 0 )
+            {
+                continue;
+            }
+
+            pxResults = &( xResults[ ulCurrentPhase ] );
+            ulLatency = ulNow - xMessage.ulTimeStamp;
+
+            if( pxResults->ulMessages == 0UL )
+            {
+                pxResults->ulFirstReceiveTime = ulNow;
+            }
+
+            pxResults->ulMessages++;
+            pxResults->ulLastReceiveTime = ulNow;
+            pxResults->ullTotalLatency += ulLatency;
+
+            if( ulLatency > pxResults->ulMaxLatency )
+            {
+                pxResults->ulMaxLatency = ulLatency;
+            }
+        }
+        else
+        {
+            printf("Core %d - Thread '%s': No messages from the SDK core\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()));
+        }
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,122 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef INTERCORE_CHANNEL_HOST_MODEL_H
+#define INTERCORE_CHANNEL_HOST_MODEL_H
+
+/*
+ * A software model of one direction of the RP2040 SIO inter-core FIFO, used
+ * in place of the hardware when IntercoreChannel.c is built on a host with
+ * channelUSE_HOST_FIFO_MODEL set to 1.  Like the hardware, the FIFO is
+ * channelHOST_FIFO_DEPTH words deep, a write to a full FIFO is dropped and
+ * latches the write overflow flag, and the "interrupt" is level sensitive -
+ * it stays pending while the FIFO holds data.
+ *
+ * A host harness calls bHostFIFOModelRun() wherever it wants the RTOS core to
+ * take a pending interrupt, which lets it interleave sender, receiver and
+ * interrupt in any order - as HostTest/IntercoreChannelTest.c does.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef channelHOST_FIFO_DEPTH
+    #define channelHOST_FIFO_DEPTH  8
+#endif
+
+typedef struct HostFIFOModel
+{
+    uint32_t ulWords[ channelHOST_FIFO_DEPTH ];
+    uint32_t ulReadIndex;
+    uint32_t ulCount;
+    bool bWriteOverflow;
+    bool bInterruptEnabled;
+    void ( *pxHandler )( void );
+} HostFIFOModel_t;
+
+extern HostFIFOModel_t xHostFIFOModel;
+
+static inline bool bHostFIFOModelWriteReady( void )
+{
+    return xHostFIFOModel.ulCount < channelHOST_FIFO_DEPTH;
+}
+
+static inline void vHostFIFOModelPush( uint32_t ulWord )
+{
+    if( bHostFIFOModelWriteReady() )
+    {
+        xHostFIFOModel.ulWords[ ( xHostFIFOModel.ulReadIndex + xHostFIFOModel.ulCount ) % channelHOST_FIFO_DEPTH ] = ulWord;
+        xHostFIFOModel.ulCount++;
+    }
+    else
+    {
+        xHostFIFOModel.bWriteOverflow = true;
+    }
+}
+
+static inline bool bHostFIFOModelReadValid( void )
+{
+    return xHostFIFOModel.ulCount > 0;
+}
+
+static inline uint32_t ulHostFIFOModelPop( void )
+{
+    uint32_t ulWord = xHostFIFOModel.ulWords[ xHostFIFOModel.ulReadIndex ];
+
+    xHostFIFOModel.ulReadIndex = ( xHostFIFOModel.ulReadIndex + 1 ) % channelHOST_FIFO_DEPTH;
+    xHostFIFOModel.ulCount--;
+
+    return ulWord;
+}
+
+static inline void vHostFIFOModelClearIRQ( void )
+{
+    xHostFIFOModel.bWriteOverflow = false;
+}
+
+static inline void vHostFIFOModelInstallHandler( void ( *pxHandler )( void ) )
+{
+    xHostFIFOModel.pxHandler = pxHandler;
+    xHostFIFOModel.bInterruptEnabled = true;
+}
+
+/* Take the FIFO interrupt if it is enabled and pending.  Returns true if the
+handler ran. */
+static inline bool bHostFIFOModelRun( void )
+{
+    bool bHandled = false;
+
+    if( ( xHostFIFOModel.bInterruptEnabled != false ) && ( xHostFIFOModel.ulCount > 0 ) )
+    {
+        xHostFIFOModel.pxHandler();
+        bHandled = true;
+    }
+
+    return bHandled;
+}
+
+#endif /* INTERCORE_CHANNEL_HOST_MODEL_H */
@@ -0,0 +1,263 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares running the same job (a bitwise CRC32 of a buffer) directly in a
+ * task with offloading it to the SDK core using OffloadService.c.
+ *
+ * A higher priority "load" task wakes on every tick and busy waits for
+ * offbenchLOAD_US, standing in for the rest of an application, so a job run
+ * in a task is preempted part way through.  Each round the benchmark task runs
+ * the job offbenchJOBS_PER_ROUND times each way and prints:
+ *
+ *  - in task: the time from calling the job function to it returning.
+ *  - offloaded exec: the time the job took on the SDK core.
+ *  - offloaded round trip: the time from submitting the job to the submitting
+ *    task running again after it completed.
+ *  - completion latency: the part of the round trip from the job function
+ *    returning to the submitting task running again.
+ *
+ * The CRC calculated by each offloaded job is checked against the CRC
+ * calculated in the task.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* SDK includes. */
+#include <stdio.h>
+#include "pico/stdlib.h"
+
+/* Demo includes. */
+#include "OffloadService.h"
+#include "OffloadBenchmark.h"
+
+/* The number of bytes the job calculates the CRC of. */
+#ifndef offbenchBUFFER_SIZE
+    #define offbenchBUFFER_SIZE         ( 1024U )
+#endif
+
+#ifndef offbenchJOBS_PER_ROUND
+    #define offbenchJOBS_PER_ROUND      ( 200UL )
+#endif
+
+/* How long the load task busy waits each tick. */
+#ifndef offbenchLOAD_US
+    #define offbenchLOAD_US             ( 150UL )
+#endif
+
+/* Far longer than a job takes. */
+#define offbenchJOB_TIMEOUT             pdMS_TO_TICKS( 100 )
+
+#define offbenchDELAY_BETWEEN_ROUNDS    pdMS_TO_TICKS( 2000 )
+
+/*-----------------------------------------------------------*/
+
+/* The parameters passed to the job function. */
+typedef struct CRCJobParameters
+{
+    const uint8_t *pucData;
+    size_t xLength;
+    uint32_t ulCRC;
+} CRCJobParameters_t;
+
+/* Minimum, maximum and total of a set of times, in microseconds. */
+typedef struct TimeStats
+{
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint32_t ulTotal;
+} TimeStats_t;
+
+/*
+ * The job.  Deliberately bitwise rather than table driven, so it takes long
+ * enough to be preempted by the tick.
+ */
+static void prvCRCJob( void *pvParameters );
+
+/*
+ * The task that runs and times the jobs, and the task that loads the RTOS
+ * core.
+ */
+static void prvOffloadBenchmarkTask( void *pvParameters );
+static void prvLoadTask( void *pvParameters );
+
+/*
+ * Helpers to accumulate and print TimeStats_t structures.
+ */
+static void prvResetStats( TimeStats_t *pxStats );
+static void prvAddTime( TimeStats_t *pxStats, uint32_t ulTime );
+static void prvPrintStats( const char *pcName, const TimeStats_t *pxStats );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t ucBuffer[ offbenchBUFFER_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+void vStartOffloadBenchmark( UBaseType_t uxPriority )
+{
+    xTaskCreate( prvOffloadBenchmarkTask, "Offload", configMINIMAL_STACK_SIZE * 2, NULL, uxPriority, NULL );
+    xTaskCreate( prvLoadTask, "Load", configMINIMAL_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCRCJob( void *pvParameters )
+{
+    CRCJobParameters_t *pxParameters = ( CRCJobParameters_t * ) pvParameters;
+    uint32_t ulCRC = 0xFFFFFFFFUL;
+    size_t x;
+    int iBit;
+
+    for( x = 0; x < pxParameters->xLength; x++ )
+    {
+        ulCRC ^= pxParameters->pucData[ x ];
+
+        for( iBit = 0; iBit < 8; iBit++ )
+        {
+            ulCRC = ( ulCRC >> 1 ) ^ ( 0xEDB88320UL & ( 0UL - ( ulCRC & 1UL ) ) );
+        }
+    }
+
+    pxParameters->ulCRC = ~ulCRC;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResetStats( TimeStats_t *pxStats )
+{
+    pxStats->ulMin = UINT32_MAX;
+    pxStats->ulMax = 0;
+    pxStats->ulTotal = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddTime( TimeStats_t *pxStats, uint32_t ulTime )
+{
+    if( ulTime < pxStats->ulMin )
+    {
+        pxStats->ulMin = ulTime;
+    }
+
+    if( ulTime > pxStats->ulMax )
+    {
+        pxStats->ulMax = ulTime;
+    }
+
+    pxStats->ulTotal += ulTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintStats( const char *pcName, const TimeStats_t *pxStats )
+{
+    printf("Core %d - Thread '%s': %s: min %lu us, mean %lu us, max %lu us\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()), pcName,
+           ( unsigned long ) pxStats->ulMin, ( unsigned long ) ( pxStats->ulTotal / offbenchJOBS_PER_ROUND ), ( unsigned long ) pxStats->ulMax);
+}
+/*-----------------------------------------------------------*/
+
+static void prvOffloadBenchmarkTask( void *pvParameters )
+{
+    TimeStats_t xInTask, xOffloadedExec, xRoundTrip, xCompletionLatency;
+    CRCJobParameters_t xParameters;
+    OffloadJob_t xJob;
+    uint32_t ulJob, ulStart, ulEnd, ulExpectedCRC, ulErrors = 0;
+    size_t x;
+
+    ( void ) pvParameters;
+
+    for( x = 0; x < offbenchBUFFER_SIZE; x++ )
+    {
+        ucBuffer[ x ] = ( uint8_t ) ( x * 7U );
+    }
+
+    xParameters.pucData = ucBuffer;
+    xParameters.xLength = offbenchBUFFER_SIZE;
+    xJob.pxFunction = prvCRCJob;
+    xJob.pvParameters = &xParameters;
+
+    for( ;; )
+    {
+        prvResetStats( &xInTask );
+        prvResetStats( &xOffloadedExec );
+        prvResetStats( &xRoundTrip );
+        prvResetStats( &xCompletionLatency );
+
+        for( ulJob = 0; ulJob < offbenchJOBS_PER_ROUND; ulJob++ )
+        {
+            /* Run the job in this task. */
+            ulStart = time_us_32();
+            prvCRCJob( &xParameters );
+            ulEnd = time_us_32();
+            prvAddTime( &xInTask, ulEnd - ulStart );
+            ulExpectedCRC = xParameters.ulCRC;
+
+            /* Run the same job on the SDK core. */
+            xParameters.ulCRC = 0;
+
+            if( xOffloadRun( &xJob, offbenchJOB_TIMEOUT ) == pdPASS )
+            {
+                ulEnd = time_us_32();
+                prvAddTime( &xOffloadedExec, xJob.ulEndTime - xJob.ulStartTime );
+                prvAddTime( &xRoundTrip, ulEnd - xJob.ulSubmitTime );
+                prvAddTime( &xCompletionLatency, ulEnd - xJob.ulEndTime );
+
+                if( xParameters.ulCRC != ulExpectedCRC )
+                {
+                    ulErrors++;
+                }
+            }
+            else
+            {
+                /* The job may still run, so xJob cannot be reused. */
+                printf("Core %d - Thread '%s': Offloaded job did not complete\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()));
+                vTaskSuspend( NULL );
+            }
+        }
+
+        prvPrintStats( "in task", &xInTask );
+        prvPrintStats( "offloaded exec", &xOffloadedExec );
+        prvPrintStats( "offloaded round trip", &xRoundTrip );
+        prvPrintStats( "completion latency", &xCompletionLatency );
+        printf("Core %d - Thread '%s': %lu jobs offloaded, %lu CRC errors\n", get_core_num(), pcTaskGetName(xTaskGetCurrentTaskHandle()),
+               ( unsigned long ) offbenchJOBS_PER_ROUND, ( unsigned long ) ulErrors);
+
+        vTaskDelay( offbenchDELAY_BETWEEN_ROUNDS );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadTask( void *pvParameters )
+{
+    ( void ) pvParameters;
+
+    for( ;; )
+    {
+        vTaskDelay( 1 );
+        busy_wait_us_32( offbenchLOAD_US );
+    }
+}
+/*-----------------------------------------------------------*/
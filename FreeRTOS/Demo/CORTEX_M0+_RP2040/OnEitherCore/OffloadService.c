@@ -0,0 +1,210 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * See the comments at the top of OffloadService.h.
+ *
+ * Jobs are passed to the SDK core through a ring of job pointers.  Any task on
+ * the RTOS core can submit, so writes to the ring are serialised by a critical
+ * section - sufficient because FreeRTOS only runs on one core.  Only the SDK
+ * core reads the ring.  The SDK core waits for work with __wfe(), and the
+ * submitting task wakes it with __sev() after publishing the job.  The event
+ * register latches a __sev() that arrives before the __wfe(), so a wake up
+ * cannot be lost between the SDK core finding the ring empty and it sleeping.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* SDK includes. */
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+/* Demo includes. */
+#include "IntercoreChannel.h"
+#include "OffloadService.h"
+
+/* The number of jobs that can be waiting to run.  Must be a power of two. */
+#ifndef offloadQUEUE_LENGTH
+    #define offloadQUEUE_LENGTH         16
+#endif
+
+/* The task notification index used to signal job completion. */
+#ifndef offloadNOTIFICATION_INDEX
+    #define offloadNOTIFICATION_INDEX   0
+#endif
+
+#if ( ( offloadQUEUE_LENGTH & ( offloadQUEUE_LENGTH - 1 ) ) != 0 )
+    #error offloadQUEUE_LENGTH must be a power of two.
+#endif
+
+#define offloadINDEX_MASK               ( ( uint32_t ) offloadQUEUE_LENGTH - 1UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called from the SIO FIFO interrupt with the address of each completed job.
+ */
+static void prvJobCompleteHandler( uint32_t ulWord, BaseType_t *pxHigherPriorityTaskWoken );
+
+/*-----------------------------------------------------------*/
+
+/* As in IntercoreChannel.c, the indexes increment freely and are masked on
+use. */
+static volatile uint32_t ulSubmitIndex = 0;     /* Written only by the RTOS core. */
+static volatile uint32_t ulRunIndex = 0;        /* Written only by the SDK core. */
+static OffloadJob_t * volatile pxJobQueue[ offloadQUEUE_LENGTH ];
+
+static bool bCompletionHandlerSet = false;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xOffloadSubmit( OffloadJob_t *pxJob )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT( pxJob );
+    configASSERT( pxJob->pxFunction );
+
+    if( bCompletionHandlerSet == false )
+    {
+        /* Jobs can only complete after they have been submitted, so this is
+        early enough to install the handler. */
+        vIntercoreChannelSetDoorbellHandler( prvJobCompleteHandler );
+        bCompletionHandlerSet = true;
+    }
+
+    pxJob->xSubmittingTask = xTaskGetCurrentTaskHandle();
+    pxJob->xComplete = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if( ( ulSubmitIndex - ulRunIndex ) < ( uint32_t ) offloadQUEUE_LENGTH )
+        {
+            pxJob->ulSubmitTime = time_us_32();
+            pxJobQueue[ ulSubmitIndex & offloadINDEX_MASK ] = pxJob;
+
+            /* The job must be visible before the updated index. */
+            __dmb();
+            ulSubmitIndex++;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xReturn == pdPASS )
+    {
+        /* Wake the SDK core if it is waiting for work. */
+        __sev();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xOffloadWait( OffloadJob_t *pxJob, TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+
+    configASSERT( pxJob->xSubmittingTask == xTaskGetCurrentTaskHandle() );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    /* The notification may be for a different job submitted by the same task,
+    so the job's own flag is the test for completion. */
+    while( pxJob->xComplete == pdFALSE )
+    {
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            break;
+        }
+
+        ( void ) ulTaskNotifyTakeIndexed( offloadNOTIFICATION_INDEX, pdTRUE, xTicksToWait );
+    }
+
+    return ( pxJob->xComplete != pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xOffloadRun( OffloadJob_t *pxJob, TickType_t xTicksToWait )
+{
+    BaseType_t xReturn;
+
+    xReturn = xOffloadSubmit( pxJob );
+
+    if( xReturn == pdPASS )
+    {
+        xReturn = xOffloadWait( pxJob, xTicksToWait );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvJobCompleteHandler( uint32_t ulWord, BaseType_t *pxHigherPriorityTaskWoken )
+{
+    OffloadJob_t *pxJob = ( OffloadJob_t * ) ulWord;
+
+    pxJob->ulNotifyTime = time_us_32();
+    pxJob->xComplete = pdTRUE;
+    vTaskNotifyGiveIndexedFromISR( pxJob->xSubmittingTask, offloadNOTIFICATION_INDEX, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vOffloadServiceSDKCore( void )
+{
+    OffloadJob_t *pxJob;
+    uint32_t ulLocalRunIndex;
+
+    for( ;; )
+    {
+        ulLocalRunIndex = ulRunIndex;
+
+        while( ulSubmitIndex == ulLocalRunIndex )
+        {
+            __wfe();
+        }
+
+        /* The read of the index must complete before the job is read. */
+        __dmb();
+        pxJob = pxJobQueue[ ulLocalRunIndex & offloadINDEX_MASK ];
+        ulRunIndex = ulLocalRunIndex + 1UL;
+
+        pxJob->ulStartTime = time_us_32();
+        pxJob->pxFunction( pxJob->pvParameters );
+        pxJob->ulEndTime = time_us_32();
+
+        /* Everything the job wrote must be visible before the completion.
+        The RTOS core takes the interrupt promptly, so the push only blocks if
+        more than the depth of the FIFO completions are outstanding. */
+        __dmb();
+        multicore_fifo_push_blocking( ( uint32_t ) pxJob );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,90 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef OFFLOAD_SERVICE_H
+#define OFFLOAD_SERVICE_H
+
+/*
+ * Runs work on the core that is not running FreeRTOS (the "SDK core").
+ *
+ * A task on the RTOS core fills in an OffloadJob_t and submits it.  The SDK
+ * core runs submitted jobs one at a time, in submission order, each to
+ * completion - nothing preempts a job, so its execution time does not include
+ * the tick interrupt or higher priority tasks as it would if the job ran in a
+ * task.  When a job completes the SDK core writes the address of the job to
+ * the SIO FIFO, and the FIFO interrupt on the RTOS core notifies the task that
+ * submitted it.
+ *
+ * Job functions run outside of FreeRTOS, so must not call the FreeRTOS API.
+ * The service shares the SIO FIFO interrupt with IntercoreChannel.c, so has the
+ * same requirement that configSUPPORT_PICO_SYNC_INTEROP is 0.
+ */
+
+/* The function a job runs. */
+typedef void ( *OffloadFunction_t )( void *pvParameters );
+
+typedef struct OffloadJob
+{
+    /* Set by the submitting task. */
+    OffloadFunction_t pxFunction;
+    void *pvParameters;
+
+    /* Set by the service.  The times are read from the 1MHz system timer. */
+    TaskHandle_t xSubmittingTask;
+    volatile BaseType_t xComplete;
+    uint32_t ulSubmitTime;      /* When the job was submitted. */
+    uint32_t ulStartTime;       /* When the SDK core started the job. */
+    uint32_t ulEndTime;         /* When the job function returned. */
+    uint32_t ulNotifyTime;      /* When the FIFO interrupt notified the submitting task. */
+} OffloadJob_t;
+
+/*
+ * Called from a task on the RTOS core.  Queues pxJob to run on the SDK core
+ * and returns without waiting for it.  pxJob must remain valid until it has
+ * completed.  Returns pdFAIL if offloadQUEUE_LENGTH jobs are already queued.
+ * The first call installs the SIO FIFO interrupt on the calling core.
+ */
+BaseType_t xOffloadSubmit( OffloadJob_t *pxJob );
+
+/*
+ * Called by the task that submitted pxJob.  Blocks for up to xTicksToWait
+ * ticks for the job to complete, using the task notification at index
+ * offloadNOTIFICATION_INDEX.  Returns pdPASS if the job has completed.
+ */
+BaseType_t xOffloadWait( OffloadJob_t *pxJob, TickType_t xTicksToWait );
+
+/*
+ * Submit pxJob then wait for it to complete.
+ */
+BaseType_t xOffloadRun( OffloadJob_t *pxJob, TickType_t xTicksToWait );
+
+/*
+ * The SDK core side of the service.  Runs submitted jobs forever.
+ */
+void vOffloadServiceSDKCore( void );
+
+#endif /* OFFLOAD_SERVICE_H */
@@ -12,6 +12,22 @@
 #define mainRUN_FREE_RTOS_ON_CORE 0
 #endif
 
+/* Set mainCREATE_INTERCORE_CHANNEL_BENCHMARK to 1 to replace the demo tasks and
+the SDK core's busy work with the intercore channel benchmark implemented in
+IntercoreChannelBenchmark.c.  The on_core_zero_channel_benchmark and
+on_core_one_channel_benchmark targets do this. */
+#ifndef mainCREATE_INTERCORE_CHANNEL_BENCHMARK
+#define mainCREATE_INTERCORE_CHANNEL_BENCHMARK 0
+#endif
+
+/* Set mainCREATE_OFFLOAD_BENCHMARK to 1 to instead use the SDK core to run
+jobs offloaded from FreeRTOS tasks by OffloadService.c, and run the benchmark
+implemented in OffloadBenchmark.c.  The on_core_zero_offload_benchmark and
+on_core_one_offload_benchmark targets do this. */
+#ifndef mainCREATE_OFFLOAD_BENCHMARK
+#define mainCREATE_OFFLOAD_BENCHMARK 0
+#endif
+
 /* Priorities at which the tasks are created.  The event semaphore task is
 given the maximum priority of ( configMAX_PRIORITIES - 1 ) to ensure it runs as
 soon as the semaphore is given. */
@@ -20,6 +36,8 @@ soon as the semaphore is given. */
 #define mainQUEUE_RECEIVE_TASK_PRIORITY     ( tskIDLE_PRIORITY + 2 )
 #define mainQUEUE_SEND_TASK_PRIORITY        ( tskIDLE_PRIORITY + 1 )
 #define mainEVENT_SEMAPHORE_TASK_PRIORITY   ( configMAX_PRIORITIES - 1 )
+#define mainCHANNEL_BENCHMARK_TASK_PRIORITY ( tskIDLE_PRIORITY + 2 )
+#define mainOFFLOAD_BENCHMARK_TASK_PRIORITY ( tskIDLE_PRIORITY + 2 )
 
 /* The rate at which data is sent to the queue, specified in milliseconds, and
 converted to ticks using the pdMS_TO_TICKS() macro. */
@@ -94,6 +112,9 @@ static volatile uint32_t ulCountOfSDKSemaphoreAcquires = 0;
 
 #include "pico/mutex.h"
 #include "pico/sem.h"
+#include "IntercoreChannelBenchmark.h"
+#include "OffloadService.h"
+#include "OffloadBenchmark.h"
 
 #if configNUM_CORES > 1
 #error Require only one core configured for FreeRTOS
@@ -103,6 +124,11 @@ auto_init_mutex(xSDKMutex);
 static semaphore_t xSDKSemaphore;
 
 static void prvNonRTOSWorker() {
+#if ( mainCREATE_INTERCORE_CHANNEL_BENCHMARK == 1 )
+    vIntercoreChannelBenchmarkSender();
+#elif ( mainCREATE_OFFLOAD_BENCHMARK == 1 )
+    vOffloadServiceSDKCore();
+#endif
     printf("Core %d: Doing regular SDK stuff\n", get_core_num());
     uint32_t counter;
     while (true) {
@@ -146,6 +172,13 @@ int main(void) {
     can be done here if it was not done before main() was called. */
     prvSetupHardware();
 
+#if ( mainCREATE_INTERCORE_CHANNEL_BENCHMARK == 1 )
+    /* Only the benchmark runs, so the results are not disturbed by the other
+    tasks. */
+    vStartIntercoreChannelBenchmark(mainCHANNEL_BENCHMARK_TASK_PRIORITY);
+#elif ( mainCREATE_OFFLOAD_BENCHMARK == 1 )
+    vStartOffloadBenchmark(mainOFFLOAD_BENCHMARK_TASK_PRIORITY);
+#else
     /* Create the queue used by the queue send and queue receive tasks. */
     xQueue = xQueueCreate(     /* The number of items the queue can hold. */
             mainQUEUE_LENGTH,
@@ -241,6 +274,7 @@ int main(void) {
     command queue cannot possibly be full here (this is the first timer to
     be created, and it is not yet running). */
     xTimerStart(xExampleSoftwareTimer, 0);
+#endif
 
     multicore_launch_core1(prvCore1Entry);
 #if ( mainRUN_FREE_RTOS_ON_CORE == 0 )
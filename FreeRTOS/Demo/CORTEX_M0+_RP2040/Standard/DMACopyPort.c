@@ -0,0 +1,191 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * The RP2040 port layer for the DMA copy service in
+ * ../../Common/Minimal/DMACopy.c.  Up to dmacopyMAX_CHANNELS DMA channels are
+ * claimed from the SDK, so the channels used by other parts of the
+ * application are left alone.  The channels interrupt on DMA_IRQ_1, on the
+ * core that calls vDMACopyInit(), through a shared handler so the other
+ * channels can still use the IRQ.
+ *
+ * The RP2040 has no data cache, so no cache maintenance is needed.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "DMACopy.h"
+
+/* SDK APIs.*/
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+/* The error flags in a channel's CTRL register, which are cleared by writing
+a 1 to them. */
+#define dmaportERROR_BITS ( DMA_CH0_CTRL_TRIG_READ_ERROR_BITS | DMA_CH0_CTRL_TRIG_WRITE_ERROR_BITS )
+
+static void prvDMAIRQHandler( void );
+static enum dma_channel_transfer_size prvTransferSize( uintptr_t uxAddresses, size_t xLength );
+
+/* The SDK's number for each channel used by the service. */
+static uint uxDMAChannel[ dmacopyMAX_CHANNELS ];
+static UBaseType_t uxChannelsClaimed = 0;
+
+/* The DMA engine reads the value to write from here during a memset. */
+static uint32_t ulSetValue[ dmacopyMAX_CHANNELS ];
+
+UBaseType_t uxDMACopyPortInit( void )
+{
+    int iChannel;
+
+    /* Only claim the channels once, even if the service is reset. */
+    if( uxChannelsClaimed == 0 )
+    {
+        while( uxChannelsClaimed < dmacopyMAX_CHANNELS )
+        {
+            iChannel = dma_claim_unused_channel( false );
+
+            if( iChannel < 0 )
+            {
+                break;
+            }
+
+            uxDMAChannel[ uxChannelsClaimed ] = ( uint ) iChannel;
+            dma_channel_set_irq1_enabled( ( uint ) iChannel, true );
+            uxChannelsClaimed++;
+        }
+
+        if( uxChannelsClaimed > 0 )
+        {
+            irq_add_shared_handler( DMA_IRQ_1, prvDMAIRQHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY );
+            irq_set_enabled( DMA_IRQ_1, true );
+        }
+    }
+
+    return uxChannelsClaimed;
+}
+
+BaseType_t xDMACopyPortStartCopy( UBaseType_t uxChannel, void *pvDestination, const void *pvSource, size_t xLength )
+{
+    enum dma_channel_transfer_size xSize = prvTransferSize( ( uintptr_t ) pvDestination | ( uintptr_t ) pvSource, xLength );
+    dma_channel_config xConfig = dma_channel_get_default_config( uxDMAChannel[ uxChannel ] );
+
+    channel_config_set_transfer_data_size( &xConfig, xSize );
+    channel_config_set_read_increment( &xConfig, true );
+    channel_config_set_write_increment( &xConfig, true );
+    dma_channel_configure( uxDMAChannel[ uxChannel ], &xConfig, pvDestination, pvSource, xLength >> xSize, true );
+
+    return pdTRUE;
+}
+
+BaseType_t xDMACopyPortStartSet( UBaseType_t uxChannel, void *pvDestination, uint8_t ucValue, size_t xLength )
+{
+    enum dma_channel_transfer_size xSize = prvTransferSize( ( uintptr_t ) pvDestination, xLength );
+    dma_channel_config xConfig = dma_channel_get_default_config( uxDMAChannel[ uxChannel ] );
+
+    /* Every byte of the word holds the value, so the word can be read at
+    whatever transfer size is used. */
+    ulSetValue[ uxChannel ] = ( uint32_t ) ucValue * 0x01010101UL;
+
+    channel_config_set_transfer_data_size( &xConfig, xSize );
+    channel_config_set_read_increment( &xConfig, false );
+    channel_config_set_write_increment( &xConfig, true );
+    dma_channel_configure( uxDMAChannel[ uxChannel ], &xConfig, pvDestination, &( ulSetValue[ uxChannel ] ), xLength >> xSize, true );
+
+    return pdTRUE;
+}
+
+void vDMACopyPortEndTransfer( UBaseType_t uxChannel, void *pvDestination, size_t xLength )
+{
+    /* Nothing to do - there is no data cache. */
+    ( void ) uxChannel;
+    ( void ) pvDestination;
+    ( void ) xLength;
+}
+
+/* Use the widest transfer the alignment of the buffers and the length
+allow.  The enum value is the log2 of the transfer size in bytes. */
+static enum dma_channel_transfer_size prvTransferSize( uintptr_t uxAddresses, size_t xLength )
+{
+    enum dma_channel_transfer_size xSize;
+
+    uxAddresses |= ( uintptr_t ) xLength;
+
+    if( ( uxAddresses & 0x03U ) == 0 )
+    {
+        xSize = DMA_SIZE_32;
+    }
+    else if( ( uxAddresses & 0x01U ) == 0 )
+    {
+        xSize = DMA_SIZE_16;
+    }
+    else
+    {
+        xSize = DMA_SIZE_8;
+    }
+
+    return xSize;
+}
+
+static void prvDMAIRQHandler( void )
+{
+    UBaseType_t uxChannel;
+    uint uxDMA;
+    BaseType_t xSucceeded, xHigherPriorityTaskWoken = pdFALSE;
+
+    for( uxChannel = 0; uxChannel < uxChannelsClaimed; uxChannel++ )
+    {
+        uxDMA = uxDMAChannel[ uxChannel ];
+
+        /* The IRQ is shared, so only acknowledge the channels the service
+        owns. */
+        if( ( dma_hw->ints1 & ( 1UL << uxDMA ) ) != 0 )
+        {
+            dma_hw->ints1 = 1UL << uxDMA;
+
+            if( ( dma_hw->ch[ uxDMA ].al1_ctrl & DMA_CH0_CTRL_TRIG_AHB_ERROR_BITS ) != 0 )
+            {
+                /* Write through the non-triggering alias so the channel is
+                not restarted. */
+                hw_set_bits( &( dma_hw->ch[ uxDMA ].al1_ctrl ), dmaportERROR_BITS );
+                xSucceeded = pdFALSE;
+            }
+            else
+            {
+                xSucceeded = pdTRUE;
+            }
+
+            vDMACopyTransferCompleteFromISR( uxChannel, xSucceeded, &xHigherPriorityTaskWoken );
+        }
+    }
+
+    portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
+}
@@ -42,7 +42,10 @@
 
 /* Scheduler Related */
 #define configUSE_PREEMPTION                    1
-#define configUSE_TICKLESS_IDLE                 0
+/* The main_tickless target in CMakeLists.txt sets this to 2 - see below. */
+#ifndef configUSE_TICKLESS_IDLE
+    #define configUSE_TICKLESS_IDLE             0
+#endif
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     1
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
@@ -57,7 +60,7 @@
 #define configUSE_RECURSIVE_MUTEXES             1
 #define configUSE_APPLICATION_TASK_TAG          0
 #define configUSE_COUNTING_SEMAPHORES           1
-#define configQUEUE_REGISTRY_SIZE               8
+#define configQUEUE_REGISTRY_SIZE               32
 #define configUSE_QUEUE_SETS                    1
 #define configUSE_TIME_SLICING                  1
 #define configUSE_NEWLIB_REENTRANT              0
@@ -79,11 +82,20 @@
 #define configUSE_MALLOC_FAILED_HOOK            1
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
-/* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+/* Run time and task stats gathering related definitions.  The run time counter
+is only used to time the benchmarks, so is off unless the build turns it on - as
+the main_full_timer_bench targets in CMakeLists.txt do. */
+#ifndef configGENERATE_RUN_TIME_STATS
+    #define configGENERATE_RUN_TIME_STATS       0
+#endif
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* The run time counter is the low word of the RP2040's free running 1MHz
+timer (TIMERAWL), which the pico SDK starts before main() is called. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        ( *( ( volatile uint32_t * ) 0x40054028UL ) )
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         1
@@ -103,7 +115,12 @@
 
 /* SMP port only */
 #define configNUM_CORES                         2
-#define configTICK_CORE                         0
+/* The core that takes the tick interrupt.  The build can override this, see
+the main_full_tick1 target in CMakeLists.txt. */
+#ifndef configTICK_CORE
+    #define configTICK_CORE                     0
+#endif
+#define configUSE_CORE_AFFINITY                 1
 #define configRUN_MULTIPLE_PRIORITIES           0
 
 /* RP2040 specific */
@@ -133,6 +150,28 @@ to exclude the API function. */
 #define INCLUDE_xTaskResumeFromISR              1
 #define INCLUDE_xQueueGetMutexHolder            1
 
+/* Demo specific.  Setting these to 1 takes the mutexes used by the recursive
+mutex and generic queue tests through MutexProfiler.c, which records contention
+statistics for the mutexes in the queue registry.  The check task prints the
+statistics.  The queue registry is large enough to hold every queue the demo
+registers, so the mutexes are not left out of it. */
+#define recmuUSE_MUTEX_PROFILER                 0
+#define genqUSE_MUTEX_PROFILER                  0
+
+/* Demo specific.  Word align the destination of each transfer the DMA copy
+service (DMACopy.c) makes with the DMA engine, so DMACopyPort.c can use 32-bit
+transfers.  The CPU copies any bytes before the first aligned address. */
+#define dmacopyPORT_ALIGNMENT                   4U
+
+/* Tickless idle, implemented in TicklessIdle.c, which also needs to know which
+cores are running their idle task. */
+#if ( configUSE_TICKLESS_IDLE == 2 )
+    extern void vApplicationSleep( uint32_t xExpectedIdleTime );
+    extern void vTicklessIdleTaskSwitchedIn( void );
+    #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )   vApplicationSleep( xExpectedIdleTime )
+    #define traceTASK_SWITCHED_IN()                             vTicklessIdleTaskSwitchedIn()
+#endif
+
 /* A header file that defines trace macro can be included here. */
 
 #endif /* FREERTOS_CONFIG_H */
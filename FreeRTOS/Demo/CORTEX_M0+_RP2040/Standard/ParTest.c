@@ -0,0 +1,486 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * Implements the standard ParTest interface, and the extensions described at
+ * the top of ParTestBatch.h, for the RP2040's GPIOs.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+
+/* Demo includes. */
+#include "partest.h"
+#include "ParTestBatch.h"
+
+/* Set partstUSE_HOST_MODEL to 1 to build against the software model of the
+GPIO bank and state machines in ParTestHostModel.h rather than the RP2040
+hardware, so the batching can be exercised on a host. */
+#ifndef partstUSE_HOST_MODEL
+    #define partstUSE_HOST_MODEL        0
+#endif
+
+/* The tick hook does not run while the tick is suppressed, so by default
+changes are only batched when tickless idle is not in use. */
+#ifndef partstBATCH_UPDATES
+    #if ( configUSE_TICKLESS_IDLE == 0 )
+        #define partstBATCH_UPDATES     1
+    #else
+        #define partstBATCH_UPDATES     0
+    #endif
+#endif
+
+#define partstNUM_GPIOS                 30U
+
+/* Two PIO blocks, each with four state machines. */
+#define partstMAX_PATTERNS              8U
+
+/* The clock the pattern state machines run at.  Each step of a pattern takes
+partstPATTERN_STEP_OVERHEAD cycles, plus one for each iteration of the delay
+loop. */
+#define partstPIO_CLOCK_HZ              100000UL
+#define partstPATTERN_STEP_OVERHEAD     3UL
+
+#if ( partstUSE_HOST_MODEL == 1 )
+    #include "ParTestHostModel.h"
+
+    HostGPIOModel_t xHostGPIOModel;
+
+    #define partstGPIO_INIT( ulMask )                           vHostGPIOInit( ulMask )
+    #define partstGPIO_GET_OUTPUT()                             ( xHostGPIOModel.ulOutput )
+    #define partstGPIO_PUT_MASKED( ulMask, ulValue )            vHostGPIOPutMasked( ulMask, ulValue )
+    #define partstPATTERN_START( uxSlot, uxGPIO, ulPattern, ulDelayLoops )  bHostGPIOPatternStart( uxSlot, uxGPIO, ulPattern, ulDelayLoops )
+    #define partstPATTERN_UPDATE( uxSlot, ulPattern )           vHostGPIOPatternUpdate( uxSlot, ulPattern )
+    #define partstPATTERN_STOP( uxSlot, uxGPIO )                vHostGPIOPatternStop( uxSlot, uxGPIO )
+#else
+    #include "hardware/gpio.h"
+    #include "hardware/pio.h"
+    #include "hardware/pio_instructions.h"
+    #include "hardware/clocks.h"
+    #include "hardware/structs/sio.h"
+
+    #define partstGPIO_INIT( ulMask )                           do { gpio_init_mask( ulMask ); gpio_set_dir_out_masked( ulMask ); } while( 0 )
+    #define partstGPIO_GET_OUTPUT()                             ( sio_hw->gpio_out )
+    #define partstGPIO_PUT_MASKED( ulMask, ulValue )            gpio_put_masked( ulMask, ulValue )
+    #define partstPATTERN_START( uxSlot, uxGPIO, ulPattern, ulDelayLoops )  prvPIOPatternStart( uxSlot, uxGPIO, ulPattern, ulDelayLoops )
+    #define partstPATTERN_UPDATE( uxSlot, ulPattern )           pio_sm_put( xPatternPIO[ uxSlot ], uxPatternSM[ uxSlot ], ulPattern )
+    #define partstPATTERN_STOP( uxSlot, uxGPIO )                prvPIOPatternStop( uxSlot, uxGPIO )
+
+    #define partstPROGRAM_LENGTH        6U
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Record a change to the GPIOs in ulMask - set if xValue is pdTRUE, cleared
+ * if pdFALSE, toggled if xToggle is pdTRUE.  Called in a critical section.
+ */
+static void prvRecordChange( uint32_t ulMask, BaseType_t xValue, BaseType_t xToggle );
+
+/*
+ * Make one write to the GPIO bank.  Called in a critical section.
+ */
+static void prvWrite( uint32_t ulSet, uint32_t ulClear, uint32_t ulToggle );
+
+static void prvInitialiseGPIO( UBaseType_t uxLED );
+
+#if ( partstUSE_HOST_MODEL == 0 )
+    static bool prvPIOPatternStart( UBaseType_t uxSlot, UBaseType_t uxGPIO, uint32_t ulPattern, uint32_t ulDelayLoops );
+    static void prvPIOPatternStop( UBaseType_t uxSlot, UBaseType_t uxGPIO );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Changes not yet written to the GPIO bank.  A GPIO is in at most one mask. */
+static uint32_t ulPendingSet = 0, ulPendingClear = 0, ulPendingToggle = 0;
+
+/* GPIOs that have been configured as SIO outputs, and GPIOs being driven by a
+state machine. */
+static uint32_t ulInitialisedGPIOs = 0, ulPatternGPIOs = 0;
+
+static ParTestStats_t xStats;
+
+/* The GPIO and step length of each pattern, or partstNUM_GPIOS if the slot is
+free. */
+static UBaseType_t uxPatternGPIO[ partstMAX_PATTERNS ];
+static uint32_t ulPatternDelayLoops[ partstMAX_PATTERNS ];
+
+#if ( partstUSE_HOST_MODEL == 0 )
+    /* The state machine running each pattern. */
+    static PIO xPatternPIO[ partstMAX_PATTERNS ];
+    static uint uxPatternSM[ partstMAX_PATTERNS ];
+
+    /* The offset of the pattern program in each PIO block, or -1 if it has
+    not been loaded. */
+    static int lProgramOffset[ 2 ] = { -1, -1 };
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vParTestInitialise( void )
+{
+    UBaseType_t uxSlot;
+
+    for( uxSlot = 0; uxSlot < partstMAX_PATTERNS; uxSlot++ )
+    {
+        uxPatternGPIO[ uxSlot ] = partstNUM_GPIOS;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vParTestSetLED( UBaseType_t uxLED, BaseType_t xValue )
+{
+    configASSERT( uxLED < partstNUM_GPIOS );
+
+    prvInitialiseGPIO( uxLED );
+
+    taskENTER_CRITICAL();
+    {
+        prvRecordChange( 1UL << uxLED, xValue, pdFALSE );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vParTestToggleLED( UBaseType_t uxLED )
+{
+    configASSERT( uxLED < partstNUM_GPIOS );
+
+    prvInitialiseGPIO( uxLED );
+
+    taskENTER_CRITICAL();
+    {
+        prvRecordChange( 1UL << uxLED, pdFALSE, pdTRUE );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseGPIO( UBaseType_t uxLED )
+{
+    const uint32_t ulMask = 1UL << uxLED;
+
+    /* Only ever set, so a GPIO initialised twice by two tasks at once is
+    harmless. */
+    if( ( ulInitialisedGPIOs & ulMask ) == 0 )
+    {
+        partstGPIO_INIT( ulMask );
+
+        taskENTER_CRITICAL();
+        {
+            ulInitialisedGPIOs |= ulMask;
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordChange( uint32_t ulMask, BaseType_t xValue, BaseType_t xToggle )
+{
+    xStats.ulRequests++;
+
+    if( ( ulMask & ulPatternGPIOs ) != 0 )
+    {
+        /* The GPIO belongs to a state machine. */
+    }
+    else if( xToggle != pdFALSE )
+    {
+        /* Toggling a pending set or clear reverses it. */
+        if( ( ulPendingSet & ulMask ) != 0 )
+        {
+            ulPendingSet &= ~ulMask;
+            ulPendingClear |= ulMask;
+        }
+        else if( ( ulPendingClear & ulMask ) != 0 )
+        {
+            ulPendingClear &= ~ulMask;
+            ulPendingSet |= ulMask;
+        }
+        else
+        {
+            ulPendingToggle ^= ulMask;
+        }
+    }
+    else
+    {
+        /* Setting or clearing overrides any earlier change. */
+        ulPendingToggle &= ~ulMask;
+
+        if( xValue != pdFALSE )
+        {
+            ulPendingSet |= ulMask;
+            ulPendingClear &= ~ulMask;
+        }
+        else
+        {
+            ulPendingClear |= ulMask;
+            ulPendingSet &= ~ulMask;
+        }
+    }
+
+    #if ( partstBATCH_UPDATES == 0 )
+    {
+        prvWrite( ulPendingSet, ulPendingClear, ulPendingToggle );
+        ulPendingSet = ulPendingClear = ulPendingToggle = 0;
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvWrite( uint32_t ulSet, uint32_t ulClear, uint32_t ulToggle )
+{
+    const uint32_t ulMask = ulSet | ulClear | ulToggle;
+    uint32_t ulValue;
+
+    if( ulMask != 0 )
+    {
+        ulValue = ( ( partstGPIO_GET_OUTPUT() | ulSet ) & ~ulClear ) ^ ulToggle;
+        partstGPIO_PUT_MASKED( ulMask, ulValue );
+        xStats.ulWrites++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vParTestFlushFromISR( void )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        prvWrite( ulPendingSet, ulPendingClear, ulPendingToggle );
+        ulPendingSet = ulPendingClear = ulPendingToggle = 0;
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xParTestSetLEDPattern( UBaseType_t uxLED, uint32_t ulPattern, uint32_t ulStepMicroseconds )
+{
+    UBaseType_t uxSlot, uxFree = partstMAX_PATTERNS;
+    uint32_t ulDelayLoops;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT( uxLED < partstNUM_GPIOS );
+
+    ulDelayLoops = ( uint32_t ) ( ( ( uint64_t ) ulStepMicroseconds * partstPIO_CLOCK_HZ ) / 1000000ULL );
+
+    if( ulDelayLoops > partstPATTERN_STEP_OVERHEAD )
+    {
+        ulDelayLoops -= partstPATTERN_STEP_OVERHEAD;
+    }
+    else
+    {
+        ulDelayLoops = 1;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        for( uxSlot = 0; uxSlot < partstMAX_PATTERNS; uxSlot++ )
+        {
+            if( uxPatternGPIO[ uxSlot ] == uxLED )
+            {
+                break;
+            }
+            else if( ( uxPatternGPIO[ uxSlot ] == partstNUM_GPIOS ) && ( uxFree == partstMAX_PATTERNS ) )
+            {
+                uxFree = uxSlot;
+            }
+        }
+
+        if( ( uxSlot < partstMAX_PATTERNS ) && ( ulPatternDelayLoops[ uxSlot ] == ulDelayLoops ) )
+        {
+            /* The state machine picks up the new pattern when it next reloads
+            its output shift register. */
+            partstPATTERN_UPDATE( uxSlot, ulPattern );
+        }
+        else
+        {
+            if( uxSlot < partstMAX_PATTERNS )
+            {
+                /* Restart on the same slot with the new step length. */
+                partstPATTERN_STOP( uxSlot, uxLED );
+                uxFree = uxSlot;
+            }
+
+            if( ( uxFree < partstMAX_PATTERNS ) && ( partstPATTERN_START( uxFree, uxLED, ulPattern, ulDelayLoops ) != false ) )
+            {
+                uxPatternGPIO[ uxFree ] = uxLED;
+                ulPatternDelayLoops[ uxFree ] = ulDelayLoops;
+                ulPatternGPIOs |= 1UL << uxLED;
+
+                /* Discard changes the state machine would overwrite. */
+                ulPendingSet &= ~( 1UL << uxLED );
+                ulPendingClear &= ~( 1UL << uxLED );
+                ulPendingToggle &= ~( 1UL << uxLED );
+            }
+            else
+            {
+                if( uxFree < partstMAX_PATTERNS )
+                {
+                    uxPatternGPIO[ uxFree ] = partstNUM_GPIOS;
+                }
+
+                ulPatternGPIOs &= ~( 1UL << uxLED );
+                xReturn = pdFAIL;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vParTestStopLEDPattern( UBaseType_t uxLED )
+{
+    UBaseType_t uxSlot;
+
+    configASSERT( uxLED < partstNUM_GPIOS );
+
+    taskENTER_CRITICAL();
+    {
+        for( uxSlot = 0; uxSlot < partstMAX_PATTERNS; uxSlot++ )
+        {
+            if( uxPatternGPIO[ uxSlot ] == uxLED )
+            {
+                partstPATTERN_STOP( uxSlot, uxLED );
+                uxPatternGPIO[ uxSlot ] = partstNUM_GPIOS;
+                ulPatternGPIOs &= ~( 1UL << uxLED );
+
+                /* The GPIO is an SIO output again. */
+                ulInitialisedGPIOs |= 1UL << uxLED;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vParTestGetStats( ParTestStats_t *pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if ( partstUSE_HOST_MODEL == 0 )
+
+    static bool prvPIOPatternStart( UBaseType_t uxSlot, UBaseType_t uxGPIO, uint32_t ulPattern, uint32_t ulDelayLoops )
+    {
+        static uint16_t usProgram[ partstPROGRAM_LENGTH ];
+        static const pio_program_t xProgram =
+        {
+            .instructions = usProgram,
+            .length = partstPROGRAM_LENGTH,
+            .origin = -1
+        };
+        const PIO xPIOs[ 2 ] = { pio0, pio1 };
+        pio_sm_config xConfig;
+        int lSM = -1;
+        UBaseType_t uxPIO;
+
+        if( usProgram[ 0 ] == 0 )
+        {
+            /* Repeat the pattern in X, one bit per step, for ever.  The delay
+            loop count is held in the ISR, which the program does not otherwise
+            use.  pull noblock copies X to the OSR if nothing has been written
+            to the TX FIFO, so writing to the FIFO changes the pattern at the
+            start of the next repetition.  Jump targets are relative to the
+            start of the program, and are relocated when it is loaded. */
+            usProgram[ 0 ] = pio_encode_pull( false, false );       /* pull noblock */
+            usProgram[ 1 ] = pio_encode_mov( pio_x, pio_osr );      /* mov x, osr */
+            usProgram[ 2 ] = pio_encode_out( pio_pins, 1 );         /* out pins, 1 */
+            usProgram[ 3 ] = pio_encode_mov( pio_y, pio_isr );      /* mov y, isr */
+            usProgram[ 4 ] = pio_encode_jmp_y_dec( 4 );             /* jmp y--, 4 */
+            usProgram[ 5 ] = pio_encode_jmp_not_osre( 2 );          /* jmp !osre, 2 */
+        }
+
+        for( uxPIO = 0; ( uxPIO < 2 ) && ( lSM < 0 ); uxPIO++ )
+        {
+            if( lProgramOffset[ uxPIO ] < 0 )
+            {
+                if( pio_can_add_program( xPIOs[ uxPIO ], &xProgram ) )
+                {
+                    lProgramOffset[ uxPIO ] = ( int ) pio_add_program( xPIOs[ uxPIO ], &xProgram );
+                }
+            }
+
+            if( lProgramOffset[ uxPIO ] >= 0 )
+            {
+                lSM = pio_claim_unused_sm( xPIOs[ uxPIO ], false );
+            }
+        }
+
+        if( lSM >= 0 )
+        {
+            uxPIO--;
+            xPatternPIO[ uxSlot ] = xPIOs[ uxPIO ];
+            uxPatternSM[ uxSlot ] = ( uint ) lSM;
+
+            xConfig = pio_get_default_sm_config();
+            sm_config_set_wrap( &xConfig, lProgramOffset[ uxPIO ], lProgramOffset[ uxPIO ] + partstPROGRAM_LENGTH - 1 );
+            sm_config_set_out_pins( &xConfig, uxGPIO, 1 );
+            sm_config_set_out_shift( &xConfig, true, false, 32 );
+            sm_config_set_clkdiv( &xConfig, ( float ) clock_get_hz( clk_sys ) / ( float ) partstPIO_CLOCK_HZ );
+
+            pio_gpio_init( xPIOs[ uxPIO ], uxGPIO );
+            pio_sm_set_consistent_pindirs( xPIOs[ uxPIO ], lSM, uxGPIO, 1, true );
+            pio_sm_init( xPIOs[ uxPIO ], lSM, lProgramOffset[ uxPIO ], &xConfig );
+
+            /* Load the delay loop count into the ISR and the pattern into X.
+            jmp y-- loops once more than the count it starts with. */
+            pio_sm_put( xPIOs[ uxPIO ], lSM, ulDelayLoops - 1UL );
+            pio_sm_exec( xPIOs[ uxPIO ], lSM, pio_encode_pull( false, true ) );
+            pio_sm_exec( xPIOs[ uxPIO ], lSM, pio_encode_mov( pio_isr, pio_osr ) );
+            pio_sm_put( xPIOs[ uxPIO ], lSM, ulPattern );
+            pio_sm_exec( xPIOs[ uxPIO ], lSM, pio_encode_pull( false, true ) );
+            pio_sm_exec( xPIOs[ uxPIO ], lSM, pio_encode_mov( pio_x, pio_osr ) );
+
+            pio_sm_set_enabled( xPIOs[ uxPIO ], lSM, true );
+        }
+
+        return ( lSM >= 0 );
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvPIOPatternStop( UBaseType_t uxSlot, UBaseType_t uxGPIO )
+    {
+        pio_sm_set_enabled( xPatternPIO[ uxSlot ], uxPatternSM[ uxSlot ], false );
+        pio_sm_unclaim( xPatternPIO[ uxSlot ], uxPatternSM[ uxSlot ] );
+        partstGPIO_INIT( 1UL << uxGPIO );
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* partstUSE_HOST_MODEL */
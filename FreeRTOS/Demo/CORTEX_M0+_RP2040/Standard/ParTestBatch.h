@@ -0,0 +1,83 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef PARTEST_BATCH_H
+#define PARTEST_BATCH_H
+
+/*
+ * Extensions to the standard ParTest interface in partest.h, implemented by
+ * ParTest.c.  The LED numbers passed to vParTestSetLED() and
+ * vParTestToggleLED() are GPIO numbers.
+ *
+ * When partstBATCH_UPDATES is 1 the two functions only record the change, and
+ * the changes made by all tasks, on both cores, are written to the GPIO bank
+ * in a single write by vParTestFlushFromISR(), which the tick hook calls.  A
+ * change therefore takes effect up to one tick after it is made.
+ *
+ * A GPIO can instead be handed to a PIO state machine that repeats a 32-bit
+ * pattern on it, one bit per step, without using the CPU.  While a pattern is
+ * running, vParTestSetLED() and vParTestToggleLED() have no effect on that
+ * GPIO.
+ */
+
+/* Counters maintained by ParTest.c. */
+typedef struct ParTestStats
+{
+    uint32_t ulRequests;        /* Calls to vParTestSetLED() and vParTestToggleLED(). */
+    uint32_t ulWrites;          /* Writes made to the GPIO bank. */
+} ParTestStats_t;
+
+/*
+ * Write the changes made since the last call to the GPIO bank.  Called from
+ * the tick hook.
+ */
+void vParTestFlushFromISR( void );
+
+/*
+ * Repeat ulPattern on GPIO uxLED, least significant bit first, holding each
+ * bit for ulStepMicroseconds.  If a pattern with the same step length is
+ * already running on the GPIO the new pattern starts when the current
+ * repetition ends, otherwise the pattern starts immediately.  Must be called
+ * from a task.
+ *
+ * Returns pdFAIL if there is no free state machine.
+ */
+BaseType_t xParTestSetLEDPattern( UBaseType_t uxLED, uint32_t ulPattern, uint32_t ulStepMicroseconds );
+
+/*
+ * Stop the pattern running on GPIO uxLED, and return control of it to
+ * vParTestSetLED() and vParTestToggleLED().  Must be called from a task.
+ */
+void vParTestStopLEDPattern( UBaseType_t uxLED );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vParTestGetStats( ParTestStats_t *pxStats );
+
+#endif /* PARTEST_BATCH_H */
@@ -0,0 +1,112 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef PARTEST_HOST_MODEL_H
+#define PARTEST_HOST_MODEL_H
+
+/*
+ * A software model of the RP2040 GPIO bank and the pattern state machines,
+ * used in place of the hardware when ParTest.c is built on a host with
+ * partstUSE_HOST_MODEL set to 1.  It records the output levels, the number of
+ * writes made to the bank, and the pattern each state machine is running.
+ * xHostGPIOModel.ulFreeStateMachines sets how many state machines can be
+ * claimed.
+ *
+ * HostTest/ParTestTest.c builds ParTest.c against this model.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define hostgpioNUM_STATE_MACHINES  8
+
+typedef struct HostGPIOStateMachine
+{
+    bool bRunning;
+    uint32_t ulGPIO;
+    uint32_t ulPattern;
+    uint32_t ulDelayLoops;
+    uint32_t ulPatternUpdates;
+} HostGPIOStateMachine_t;
+
+typedef struct HostGPIOModel
+{
+    uint32_t ulOutput;
+    uint32_t ulOutputEnabled;
+    uint32_t ulWrites;
+    uint32_t ulFreeStateMachines;
+    HostGPIOStateMachine_t xStateMachines[ hostgpioNUM_STATE_MACHINES ];
+} HostGPIOModel_t;
+
+extern HostGPIOModel_t xHostGPIOModel;
+
+static inline void vHostGPIOInit( uint32_t ulMask )
+{
+    xHostGPIOModel.ulOutput &= ~ulMask;
+    xHostGPIOModel.ulOutputEnabled |= ulMask;
+}
+
+/* Like gpio_put_masked(), one write to the bank. */
+static inline void vHostGPIOPutMasked( uint32_t ulMask, uint32_t ulValue )
+{
+    xHostGPIOModel.ulOutput = ( xHostGPIOModel.ulOutput & ~ulMask ) | ( ulValue & ulMask );
+    xHostGPIOModel.ulWrites++;
+}
+
+static inline bool bHostGPIOPatternStart( uint32_t ulSlot, uint32_t ulGPIO, uint32_t ulPattern, uint32_t ulDelayLoops )
+{
+    bool bStarted = false;
+
+    if( ( xHostGPIOModel.ulFreeStateMachines > 0 ) && ( xHostGPIOModel.xStateMachines[ ulSlot ].bRunning == false ) )
+    {
+        xHostGPIOModel.ulFreeStateMachines--;
+        xHostGPIOModel.xStateMachines[ ulSlot ].bRunning = true;
+        xHostGPIOModel.xStateMachines[ ulSlot ].ulGPIO = ulGPIO;
+        xHostGPIOModel.xStateMachines[ ulSlot ].ulPattern = ulPattern;
+        xHostGPIOModel.xStateMachines[ ulSlot ].ulDelayLoops = ulDelayLoops;
+        xHostGPIOModel.ulOutputEnabled &= ~( 1UL << ulGPIO );
+        bStarted = true;
+    }
+
+    return bStarted;
+}
+
+static inline void vHostGPIOPatternUpdate( uint32_t ulSlot, uint32_t ulPattern )
+{
+    xHostGPIOModel.xStateMachines[ ulSlot ].ulPattern = ulPattern;
+    xHostGPIOModel.xStateMachines[ ulSlot ].ulPatternUpdates++;
+}
+
+static inline void vHostGPIOPatternStop( uint32_t ulSlot, uint32_t ulGPIO )
+{
+    xHostGPIOModel.xStateMachines[ ulSlot ].bRunning = false;
+    xHostGPIOModel.ulFreeStateMachines++;
+    vHostGPIOInit( 1UL << ulGPIO );
+}
+
+#endif /* PARTEST_HOST_MODEL_H */
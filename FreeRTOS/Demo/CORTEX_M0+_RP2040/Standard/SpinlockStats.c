@@ -0,0 +1,326 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * See the comments at the top of SpinlockStats.h.
+ *
+ * The statistics for a lock taken through ulSpinlockStatsLock() are only
+ * updated while that lock is held, so the lock itself protects them and the
+ * instrumentation adds no locking of its own.  The sample counts are only
+ * updated by the sampling alarm, on one core.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+
+/* Demo includes. */
+#include "SpinlockStats.h"
+
+/* Set spinstatsUSE_HOST_MODEL to 1 to build against the software model of the
+spin locks and timer in SpinlockStatsHostModel.h rather than the RP2040
+hardware, so the instrumentation can be exercised on a host. */
+#ifndef spinstatsUSE_HOST_MODEL
+    #define spinstatsUSE_HOST_MODEL     0
+#endif
+
+#if ( spinstatsUSE_HOST_MODEL == 1 )
+    #include "SpinlockStatsHostModel.h"
+
+    volatile uint32_t ulHostSpinlockState;
+
+    #define spinstatsTRY_LOCK( ulLockNum )              bHostSpinlockTryAcquire( ulLockNum )
+    #define spinstatsACQUIRE_FENCE()
+    #define spinstatsRELEASE_LOCK( ulLockNum )          vHostSpinlockRelease( ulLockNum )
+    #define spinstatsGET_LOCK_STATE()                   ulHostSpinlockGetState()
+    #define spinstatsCLAIM_UNUSED_LOCK()                ulHostSpinlockClaimUnused()
+    #define spinstatsGET_TIME()                         ulHostTimerReadMicroseconds()
+    #define spinstatsDISABLE_INTERRUPTS()               ( 0UL )
+    #define spinstatsRESTORE_INTERRUPTS( ulSaved )      ( ( void ) ( ulSaved ) )
+#else
+    #include "hardware/sync.h"
+    #include "hardware/timer.h"
+    #include "hardware/irq.h"
+    #include "hardware/structs/sio.h"
+    #include "pico/time.h"
+
+    /* Reading a lock register claims the lock if it is free, and returns
+    non-zero if the claim succeeded. */
+    #define spinstatsTRY_LOCK( ulLockNum )              ( *spin_lock_instance( ulLockNum ) != 0 )
+    #define spinstatsACQUIRE_FENCE()                    __mem_fence_acquire()
+    #define spinstatsRELEASE_LOCK( ulLockNum )          spin_unlock_unsafe( spin_lock_instance( ulLockNum ) )
+    #define spinstatsGET_LOCK_STATE()                   ( sio_hw->spinlock_st )
+    #define spinstatsCLAIM_UNUSED_LOCK()                ( ( uint32_t ) spin_lock_claim_unused( true ) )
+    #define spinstatsGET_TIME()                         ( timer_hw->timerawl )
+    #define spinstatsDISABLE_INTERRUPTS()               save_and_disable_interrupts()
+    #define spinstatsRESTORE_INTERRUPTS( ulSaved )      restore_interrupts( ulSaved )
+#endif
+
+#ifndef spinstatsSAMPLE_PERIOD_US
+    #define spinstatsSAMPLE_PERIOD_US   100
+#endif
+
+/* How many times the test tasks take the lock before blocking, and how long
+they hold it for, in iterations of an empty loop. */
+#define spinstatsITERATIONS_PER_DELAY   100
+#define spinstatsHOLD_LOOPS             20
+
+#define spinstatsNUM_TEST_TASKS         2
+
+/*-----------------------------------------------------------*/
+
+static void prvSpinlockContentionTask( void *pvParameters );
+
+#if ( spinstatsUSE_HOST_MODEL == 0 )
+    static void prvSampleAlarmCallback( uint uxAlarm );
+#endif
+
+/*-----------------------------------------------------------*/
+
+static SpinlockStats_t xLockStats[ spinstatsNUM_LOCKS ];
+static uint32_t ulAcquiredAt[ spinstatsNUM_LOCKS ];
+
+/* Written only by the sampling alarm. */
+static volatile uint32_t ulHeldSamples[ spinstatsNUM_LOCKS ];
+static volatile uint32_t ulSamples = 0;
+
+/* Used by the contention test tasks.  The counts are only accessed with
+ulTestLock held. */
+static uint32_t ulTestLock = spinstatsNUM_LOCKS;
+static volatile uint32_t ulSharedCount = 0;
+static volatile uint32_t ulTaskCounts[ spinstatsNUM_TEST_TASKS ];
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+uint32_t ulSpinlockStatsLock( uint32_t ulLockNum )
+{
+    SpinlockStats_t * pxStats = &( xLockStats[ ulLockNum ] );
+    uint32_t ulSaved, ulSpins = 0;
+
+    configASSERT( ulLockNum < spinstatsNUM_LOCKS );
+
+    ulSaved = spinstatsDISABLE_INTERRUPTS();
+
+    while( spinstatsTRY_LOCK( ulLockNum ) == false )
+    {
+        ulSpins++;
+    }
+
+    spinstatsACQUIRE_FENCE();
+
+    /* The lock is now held, so its statistics can be updated. */
+    pxStats->ulAcquisitions++;
+
+    if( ulSpins > 0 )
+    {
+        pxStats->ulContendedAcquisitions++;
+        pxStats->ulSpinIterations += ulSpins;
+
+        if( ulSpins > pxStats->ulMaxSpinIterations )
+        {
+            pxStats->ulMaxSpinIterations = ulSpins;
+        }
+    }
+
+    ulAcquiredAt[ ulLockNum ] = spinstatsGET_TIME();
+
+    return ulSaved;
+}
+/*-----------------------------------------------------------*/
+
+void vSpinlockStatsUnlock( uint32_t ulLockNum, uint32_t ulSavedInterruptStatus )
+{
+    SpinlockStats_t * pxStats = &( xLockStats[ ulLockNum ] );
+    uint32_t ulHoldTime;
+
+    configASSERT( ulLockNum < spinstatsNUM_LOCKS );
+
+    /* Record the hold time before releasing the lock, while the statistics
+    are still protected by it. */
+    ulHoldTime = spinstatsGET_TIME() - ulAcquiredAt[ ulLockNum ];
+
+    if( ulHoldTime > pxStats->ulMaxHoldTime )
+    {
+        pxStats->ulMaxHoldTime = ulHoldTime;
+    }
+
+    spinstatsRELEASE_LOCK( ulLockNum );
+    spinstatsRESTORE_INTERRUPTS( ulSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vSpinlockStatsSampleFromISR( void )
+{
+    uint32_t ulState = spinstatsGET_LOCK_STATE();
+    uint32_t ulLockNum;
+
+    for( ulLockNum = 0; ulState != 0; ulLockNum++, ulState >>= 1 )
+    {
+        if( ( ulState & 0x01UL ) != 0 )
+        {
+            ulHeldSamples[ ulLockNum ]++;
+        }
+    }
+
+    ulSamples++;
+}
+/*-----------------------------------------------------------*/
+
+#if ( spinstatsUSE_HOST_MODEL == 0 )
+
+    void vSpinlockStatsStartSampling( void )
+    {
+        /* Claim whichever alarm is free, rather than a fixed one, so the
+        sampling cannot collide with the alarms other demos and the SDK use. */
+        uint uxAlarm = ( uint ) hardware_alarm_claim_unused( true );
+
+        hardware_alarm_set_callback( uxAlarm, prvSampleAlarmCallback );
+        hardware_alarm_set_target( uxAlarm, make_timeout_time_us( spinstatsSAMPLE_PERIOD_US ) );
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvSampleAlarmCallback( uint uxAlarm )
+    {
+        vSpinlockStatsSampleFromISR();
+        hardware_alarm_set_target( uxAlarm, make_timeout_time_us( spinstatsSAMPLE_PERIOD_US ) );
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* spinstatsUSE_HOST_MODEL */
+
+uint32_t ulSpinlockStatsGet( uint32_t ulLockNum, SpinlockStats_t *pxStats )
+{
+    configASSERT( ulLockNum < spinstatsNUM_LOCKS );
+
+    *pxStats = xLockStats[ ulLockNum ];
+    pxStats->ulHeldSamples = ulHeldSamples[ ulLockNum ];
+
+    return ulSamples;
+}
+/*-----------------------------------------------------------*/
+
+void vStartSpinlockStatsTasks( UBaseType_t uxPriority )
+{
+    TaskHandle_t xTask;
+    BaseType_t xTaskNumber;
+
+    ulTestLock = spinstatsCLAIM_UNUSED_LOCK();
+
+    for( xTaskNumber = 0; xTaskNumber < spinstatsNUM_TEST_TASKS; xTaskNumber++ )
+    {
+        xTaskCreate( prvSpinlockContentionTask, "SpinLk", configMINIMAL_STACK_SIZE, ( void * ) xTaskNumber, uxPriority, &xTask );
+
+        #if ( configUSE_CORE_AFFINITY == 1 ) && ( configNUM_CORES > 1 )
+        {
+            /* One task on each core, so the lock is contended. */
+            vTaskCoreAffinitySet( xTask, ( UBaseType_t ) 1 << ( xTaskNumber % configNUM_CORES ) );
+        }
+        #else
+        {
+            ( void ) xTask;
+        }
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSpinlockStatsTestLock( void )
+{
+    return ulTestLock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpinlockContentionTask( void *pvParameters )
+{
+    const BaseType_t xTaskNumber = ( BaseType_t ) pvParameters;
+    uint32_t ulSaved, ulValue, ulIteration, ulTotal;
+    volatile uint32_t ulHoldLoop;
+    BaseType_t xTask;
+
+    for( ;; )
+    {
+        for( ulIteration = 0; ulIteration < spinstatsITERATIONS_PER_DELAY; ulIteration++ )
+        {
+            ulSaved = ulSpinlockStatsLock( ulTestLock );
+            {
+                /* Read, wait, then write back, so a failure of mutual
+                exclusion loses an increment. */
+                ulValue = ulSharedCount;
+
+                for( ulHoldLoop = 0; ulHoldLoop < spinstatsHOLD_LOOPS; ulHoldLoop++ )
+                {
+                }
+
+                ulSharedCount = ulValue + 1;
+                ulTaskCounts[ xTaskNumber ]++;
+
+                for( xTask = 0, ulTotal = 0; xTask < spinstatsNUM_TEST_TASKS; xTask++ )
+                {
+                    ulTotal += ulTaskCounts[ xTask ];
+                }
+
+                if( ulTotal != ulSharedCount )
+                {
+                    xErrorDetected = pdTRUE;
+                }
+            }
+            vSpinlockStatsUnlock( ulTestLock, ulSaved );
+        }
+
+        vTaskDelay( 1 );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreSpinlockStatsTasksStillRunning( void )
+{
+    static uint32_t ulLastTaskCounts[ spinstatsNUM_TEST_TASKS ] = { 0 };
+    BaseType_t xTask, xReturn = pdPASS;
+
+    for( xTask = 0; xTask < spinstatsNUM_TEST_TASKS; xTask++ )
+    {
+        if( ulLastTaskCounts[ xTask ] == ulTaskCounts[ xTask ] )
+        {
+            xReturn = pdFAIL;
+        }
+
+        ulLastTaskCounts[ xTask ] = ulTaskCounts[ xTask ];
+    }
+
+    if( xErrorDetected != pdFALSE )
+    {
+        xReturn = pdFAIL;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,102 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef SPINLOCK_STATS_H
+#define SPINLOCK_STATS_H
+
+/*
+ * Statistics for the RP2040's 32 hardware spin locks.
+ *
+ * Locks taken through ulSpinlockStatsLock() and vSpinlockStatsUnlock() have
+ * their acquisitions, spin iterations and hold times recorded exactly.  Locks
+ * taken elsewhere - the locks the FreeRTOS port uses for its critical sections
+ * and the locks the pico SDK uses when configSUPPORT_PICO_SYNC_INTEROP is 1 -
+ * cannot be instrumented without changing the port and the SDK, so once
+ * vSpinlockStatsStartSampling() has been called a hardware alarm samples the
+ * SIO spin lock state register every spinstatsSAMPLE_PERIOD_US microseconds,
+ * and the fraction of samples in which a lock was held estimates how much of
+ * the time it is held.  The alarm cannot interrupt the core it runs on while
+ * that core has interrupts disabled, so the estimate is low for locks held by
+ * the sampling core.
+ *
+ * Hold times are measured with the 1MHz timer, so are in microseconds.
+ */
+
+#define spinstatsNUM_LOCKS          32
+
+typedef struct SpinlockStats
+{
+    uint32_t ulAcquisitions;            /* Acquisitions through ulSpinlockStatsLock(). */
+    uint32_t ulContendedAcquisitions;   /* Acquisitions that found the lock held. */
+    uint32_t ulSpinIterations;          /* Total times round the spin loop. */
+    uint32_t ulMaxSpinIterations;
+    uint32_t ulMaxHoldTime;             /* Longest time the lock was held, in microseconds. */
+    uint32_t ulHeldSamples;             /* Samples in which the lock was held, by any code. */
+} SpinlockStats_t;
+
+/*
+ * Equivalent to the SDK's spin_lock_blocking() and spin_unlock(), but recording
+ * statistics for the lock.  ulSpinlockStatsLock() disables interrupts and
+ * returns the previous interrupt state, which must be passed to
+ * vSpinlockStatsUnlock().
+ */
+uint32_t ulSpinlockStatsLock( uint32_t ulLockNum );
+void vSpinlockStatsUnlock( uint32_t ulLockNum, uint32_t ulSavedInterruptStatus );
+
+/*
+ * Start sampling the state of every lock, on the calling core.
+ */
+void vSpinlockStatsStartSampling( void );
+
+/*
+ * Take one sample.  Called by the sampling alarm, or directly by a host
+ * harness.
+ */
+void vSpinlockStatsSampleFromISR( void );
+
+/*
+ * Copy the statistics for ulLockNum into *pxStats, and return the total
+ * number of samples taken.  The copy is not atomic, so one field may be one
+ * acquisition ahead of another.
+ */
+uint32_t ulSpinlockStatsGet( uint32_t ulLockNum, SpinlockStats_t *pxStats );
+
+/*
+ * Two tasks, one pinned to each core, that contend for a lock taken through
+ * ulSpinlockStatsLock(), and check it provides mutual exclusion.
+ */
+void vStartSpinlockStatsTasks( UBaseType_t uxPriority );
+BaseType_t xAreSpinlockStatsTasksStillRunning( void );
+
+/*
+ * The lock the tasks contend for, or spinstatsNUM_LOCKS before the tasks have
+ * been started.
+ */
+uint32_t ulSpinlockStatsTestLock( void );
+
+#endif /* SPINLOCK_STATS_H */
@@ -0,0 +1,80 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef SPINLOCK_STATS_HOST_MODEL_H
+#define SPINLOCK_STATS_HOST_MODEL_H
+
+/*
+ * A software model of the RP2040 hardware spin locks and 1MHz timer, used in
+ * place of the hardware when SpinlockStats.c is built on a host with
+ * spinstatsUSE_HOST_MODEL set to 1.  Like the SIO, reading a lock claims it
+ * if it is free, and the state of all 32 locks can be read as one word.
+ * Host threads stand in for the two cores.  Interrupts are not modelled.
+ *
+ * HostTest/SpinlockStatsTest.c builds SpinlockStats.c against this model.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+extern volatile uint32_t ulHostSpinlockState;
+
+static inline bool bHostSpinlockTryAcquire( uint32_t ulLockNum )
+{
+    uint32_t ulBit = 1UL << ulLockNum;
+
+    return ( __atomic_fetch_or( &ulHostSpinlockState, ulBit, __ATOMIC_ACQUIRE ) & ulBit ) == 0;
+}
+
+static inline void vHostSpinlockRelease( uint32_t ulLockNum )
+{
+    __atomic_fetch_and( &ulHostSpinlockState, ~( 1UL << ulLockNum ), __ATOMIC_RELEASE );
+}
+
+static inline uint32_t ulHostSpinlockGetState( void )
+{
+    return __atomic_load_n( &ulHostSpinlockState, __ATOMIC_RELAXED );
+}
+
+/* Claim the highest numbered lock, which the SDK leaves for applications. */
+static inline uint32_t ulHostSpinlockClaimUnused( void )
+{
+    return 31;
+}
+
+static inline uint32_t ulHostTimerReadMicroseconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( uint32_t ) ( ( xNow.tv_sec * 1000000ULL ) + ( xNow.tv_nsec / 1000 ) );
+}
+
+#endif /* SPINLOCK_STATS_HOST_MODEL_H */
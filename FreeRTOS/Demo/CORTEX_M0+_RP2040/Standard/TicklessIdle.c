@@ -0,0 +1,607 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+/*
+ * See the comments at the top of TicklessIdle.h.
+ *
+ * The statistics and the SysTick state are only accessed by the tick core.
+ * Each core's idle flag is only written by that core.
+ */
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+
+/* Demo includes. */
+#include "TicklessIdle.h"
+
+/* Set ticklessUSE_HOST_MODEL to 1 to build against the software model of
+SysTick, the timer and the core's sleep in TicklessIdleHostModel.h rather than
+the RP2040 hardware, so the tick compensation can be checked on a host.  The
+demo tasks are not built in that case. */
+#ifndef ticklessUSE_HOST_MODEL
+    #define ticklessUSE_HOST_MODEL      0
+#endif
+
+#if ( ticklessUSE_HOST_MODEL == 1 )
+    #include "TicklessIdleHostModel.h"
+
+    HostTicklessModel_t xHostTicklessModel;
+
+    #define ticklessGET_CORE_ID()                   ( ( BaseType_t ) portGET_CORE_ID() )
+    #define ticklessGET_TIME_US()                   ullHostTicklessGetTime()
+    #define ticklessWAIT_FOR_TIMER_EDGE()           ullHostTicklessWaitForTimerEdge()
+    #define ticklessCYCLES_PER_US()                 ( hostticklessCYCLES_PER_US )
+    #define ticklessSYSTICK_GET_RELOAD()            ( xHostTicklessModel.ulLoad )
+    #define ticklessSYSTICK_SET_RELOAD( x )         ( xHostTicklessModel.ulLoad = ( x ) )
+    #define ticklessSYSTICK_GET_COUNT()             ulHostTicklessSysTickGetCount()
+    #define ticklessSYSTICK_STOP()                  vHostTicklessSysTickStop()
+    #define ticklessSYSTICK_RESTART()               vHostTicklessSysTickStart( false )
+    #define ticklessSYSTICK_START_FROM_ZERO()       vHostTicklessSysTickStart( true )
+    #define ticklessSYSTICK_PENDING()               ( xHostTicklessModel.ulMissedTicks != 0U )
+    #define ticklessINTERRUPT_PENDING()             bHostTicklessInterruptPending()
+    #define ticklessWAIT_FOR_EVENT()                vHostTicklessWaitForEvent()
+    #define ticklessSEND_EVENT()
+    #define ticklessMEMORY_BARRIER()                __atomic_thread_fence( __ATOMIC_SEQ_CST )
+    #define ticklessINIT_WAKE_ALARM()
+    #define ticklessSET_WAKE_ALARM( ullTime )       bHostTicklessSetAlarm( ullTime )
+    #define ticklessCANCEL_WAKE_ALARM()             ( xHostTicklessModel.bAlarmArmed = false )
+    #define ticklessDISABLE_INTERRUPTS()            ( 0UL )
+    #define ticklessRESTORE_INTERRUPTS( ulSaved )   ( ( void ) ( ulSaved ) )
+#else
+    #include "hardware/sync.h"
+    #include "hardware/timer.h"
+    #include "hardware/clocks.h"
+    #include "pico/time.h"
+
+    /* The Cortex-M0+ registers used, named as in the kernel's ARM ports. */
+    #define ticklessNVIC_SYSTICK_CTRL_REG           ( *( ( volatile uint32_t * ) 0xe000e010 ) )
+    #define ticklessNVIC_SYSTICK_LOAD_REG           ( *( ( volatile uint32_t * ) 0xe000e014 ) )
+    #define ticklessNVIC_SYSTICK_CURRENT_VALUE_REG  ( *( ( volatile uint32_t * ) 0xe000e018 ) )
+    #define ticklessNVIC_ISPR_REG                   ( *( ( volatile uint32_t * ) 0xe000e200 ) )
+    #define ticklessSCB_ICSR_REG                    ( *( ( volatile uint32_t * ) 0xe000ed04 ) )
+    #define ticklessSCB_SCR_REG                     ( *( ( volatile uint32_t * ) 0xe000ed10 ) )
+    #define ticklessNVIC_SYSTICK_ENABLE_BIT         ( 1UL << 0UL )
+    #define ticklessSCB_PENDSTSET_BIT               ( 1UL << 26UL )
+    #define ticklessSCB_SEVONPEND_BIT               ( 1UL << 4UL )
+
+    #define ticklessGET_CORE_ID()                   ( ( BaseType_t ) get_core_num() )
+    #define ticklessGET_TIME_US()                   time_us_64()
+    #define ticklessWAIT_FOR_TIMER_EDGE()           prvWaitForTimerEdge()
+    #define ticklessCYCLES_PER_US()                 ( clock_get_hz( clk_sys ) / 1000000UL )
+    #define ticklessSYSTICK_GET_RELOAD()            ( ticklessNVIC_SYSTICK_LOAD_REG )
+    #define ticklessSYSTICK_SET_RELOAD( x )         ( ticklessNVIC_SYSTICK_LOAD_REG = ( x ) )
+    #define ticklessSYSTICK_GET_COUNT()             ( ticklessNVIC_SYSTICK_CURRENT_VALUE_REG )
+    #define ticklessSYSTICK_STOP()                  ( ticklessNVIC_SYSTICK_CTRL_REG &= ~ticklessNVIC_SYSTICK_ENABLE_BIT )
+    #define ticklessSYSTICK_RESTART()               ( ticklessNVIC_SYSTICK_CTRL_REG |= ticklessNVIC_SYSTICK_ENABLE_BIT )
+    #define ticklessSYSTICK_START_FROM_ZERO()       do { ticklessNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL; ticklessSYSTICK_RESTART(); } while( 0 )
+    #define ticklessSYSTICK_PENDING()               ( ( ticklessSCB_ICSR_REG & ticklessSCB_PENDSTSET_BIT ) != 0UL )
+    #define ticklessINTERRUPT_PENDING()             ( ticklessNVIC_ISPR_REG != 0UL )
+    #define ticklessWAIT_FOR_EVENT()                __wfe()
+    #define ticklessSEND_EVENT()                    __sev()
+    #define ticklessMEMORY_BARRIER()                __dmb()
+    #define ticklessINIT_WAKE_ALARM()               prvInitWakeAlarm()
+    #define ticklessSET_WAKE_ALARM( ullTime )       ( hardware_alarm_set_target( uxWakeAlarm, from_us_since_boot( ullTime ) ) == false )
+    #define ticklessCANCEL_WAKE_ALARM()             hardware_alarm_cancel( uxWakeAlarm )
+    #define ticklessDISABLE_INTERRUPTS()            save_and_disable_interrupts()
+    #define ticklessRESTORE_INTERRUPTS( ulSaved )   restore_interrupts( ulSaved )
+#endif
+
+/* How long before the tick at which a task unblocks the tick core wakes, so it
+has time to restart SysTick before that tick is due. */
+#ifndef ticklessWAKE_MARGIN_US
+    #define ticklessWAKE_MARGIN_US      10
+#endif
+
+/* Demo task parameters. */
+#define ticklessDEMO_ALARM_PERIOD_US    47000UL
+#define ticklessDEMO_DELAY_TICKS        ( ( TickType_t ) 250 )
+#define ticklessUS_PER_TICK             ( 1000000UL / configTICK_RATE_HZ )
+
+/* A delay is in error if it differs from the requested length by more than a
+tick period. */
+#define ticklessDEMO_MAX_DELAY_ERROR_US ticklessUS_PER_TICK
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Work out how many whole tick periods passed while SysTick was stopped, and
+ * how long it is until the next tick is due.
+ */
+static TickType_t prvCompleteTickPeriods( uint32_t ulRemainingCycles,
+                                          uint64_t ullElapsedCycles,
+                                          TickType_t xExpectedIdleTime,
+                                          uint32_t *pulNextTickCycles );
+
+static BaseType_t prvOtherCoresIdle( void );
+
+#if ( ticklessUSE_HOST_MODEL == 0 )
+    static uint64_t prvWaitForTimerEdge( void );
+    static void prvInitWakeAlarm( void );
+    static void prvWakeAlarmCallback( uint uxAlarm );
+    static void prvWakeLatencyTask( void *pvParameters );
+    static void prvDelayTask( void *pvParameters );
+    static void prvDemoAlarmCallback( uint uxAlarm );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Written only by the core each entry belongs to. */
+static volatile uint8_t ucCoreIdle[ configNUM_CORES ];
+
+/* Set by vTicklessIdleWakeFromISR(). */
+static volatile BaseType_t xWakeRequested = pdFALSE;
+
+/* Set while the tick core is checking whether it can sleep, and while it
+sleeps. */
+static volatile BaseType_t xTickCoreSleeping = pdFALSE;
+
+static bool bInitialised = false;
+static uint32_t ulCyclesPerTick, ulCyclesPerUs;
+static TicklessIdleStats_t xStats;
+
+#if ( ticklessUSE_HOST_MODEL == 0 )
+    static uint uxWakeAlarm;
+
+    /* Used by the demo tasks. */
+    static TaskHandle_t xWakeLatencyTask = NULL;
+    static uint uxDemoAlarm;
+    static absolute_time_t xNextDemoAlarmTime;
+    static volatile uint32_t ulLastDemoAlarmTime;
+    static volatile uint32_t ulWakeups = 0, ulTotalWakeLatency = 0, ulMaxWakeLatency = 0;
+    static volatile uint32_t ulDelays = 0, ulMaxDelayError = 0;
+    static volatile BaseType_t xErrorDetected = pdFALSE;
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vApplicationSleep( TickType_t xExpectedIdleTime )
+{
+    const BaseType_t xCore = ticklessGET_CORE_ID();
+    uint32_t ulSaved, ulRemainingCycles, ulNextTickCycles;
+    uint64_t ullStartTime, ullWakeTime, ullElapsedTime;
+    TickType_t xCompleteTickPeriods;
+
+    if( xCore != configTICK_CORE )
+    {
+        /* Only the tick core sleeps.  Record that this core is idle, and
+        return rather than hold the scheduler suspended. */
+        ucCoreIdle[ xCore ] = ( uint8_t ) pdTRUE;
+    }
+    else
+    {
+        if( bInitialised == false )
+        {
+            /* SysTick was configured by the port when the scheduler started. */
+            ulCyclesPerTick = ticklessSYSTICK_GET_RELOAD() + 1UL;
+            ulCyclesPerUs = ticklessCYCLES_PER_US();
+            ticklessINIT_WAKE_ALARM();
+            bInitialised = true;
+        }
+
+        /* Cleared before eTaskConfirmSleepModeStatus() checks for tasks made
+        ready by interrupts, so no request made after that check is missed. */
+        xWakeRequested = pdFALSE;
+
+        ulSaved = ticklessDISABLE_INTERRUPTS();
+
+        /* Tell the other cores the tick core is about to sleep before checking
+        they are idle.  vTicklessIdleTaskSwitchedIn() does the opposite, so
+        either this core sees the other core is busy, or the other core sees
+        this core is asleep and wakes it. */
+        xTickCoreSleeping = pdTRUE;
+        ticklessMEMORY_BARRIER();
+
+        if( prvOtherCoresIdle() == pdFALSE )
+        {
+            xStats.ulOtherCoreBusy++;
+        }
+        else
+        {
+            /* Stop SysTick just as the 1MHz timer increments, and end the
+            sleep on an increment too, so the time asleep is measured to
+            within a few cycles rather than to within a microsecond.  Reading
+            the timer at random points would, on average, lose half a
+            microsecond per sleep. */
+            ullStartTime = ticklessWAIT_FOR_TIMER_EDGE();
+            ticklessSYSTICK_STOP();
+            ulRemainingCycles = ticklessSYSTICK_GET_COUNT();
+
+            if( ( ticklessSYSTICK_PENDING() != false ) ||
+                ( ulRemainingCycles == 0UL ) ||
+                ( eTaskConfirmSleepModeStatus() == eAbortSleep ) )
+            {
+                /* A tick is due, or a task became ready since the idle task
+                decided to sleep.  Carry on counting from where SysTick
+                stopped. */
+                ticklessSYSTICK_RESTART();
+                xStats.ulAborted++;
+            }
+            else
+            {
+                /* The next tick is due in ulRemainingCycles, and the tick at
+                which a task unblocks xExpectedIdleTime - 1 periods after
+                that. */
+                ullWakeTime = ullStartTime + ( ( ( uint64_t ) ulRemainingCycles +
+                                                 ( ( uint64_t ) ( xExpectedIdleTime - 1 ) * ulCyclesPerTick ) ) / ulCyclesPerUs );
+
+                if( ullWakeTime > ( ullStartTime + ticklessWAKE_MARGIN_US ) )
+                {
+                    ullWakeTime -= ticklessWAKE_MARGIN_US;
+                }
+
+                if( ticklessSET_WAKE_ALARM( ullWakeTime ) != false )
+                {
+                    /* Interrupts are disabled, but with SEVONPEND set a newly
+                    pending interrupt still generates an event, as does
+                    another core switching in a task.  Events can also be
+                    spurious, hence the loop. */
+                    while( ( ticklessINTERRUPT_PENDING() == false ) && ( xWakeRequested == pdFALSE ) )
+                    {
+                        ticklessWAIT_FOR_EVENT();
+                    }
+
+                    ticklessCANCEL_WAKE_ALARM();
+                }
+
+                ullElapsedTime = ticklessWAIT_FOR_TIMER_EDGE() - ullStartTime;
+
+                if( ullElapsedTime < ( ullWakeTime - ullStartTime ) )
+                {
+                    xStats.ulEarlyWakes++;
+                }
+
+                xCompleteTickPeriods = prvCompleteTickPeriods( ulRemainingCycles,
+                                                               ullElapsedTime * ulCyclesPerUs,
+                                                               xExpectedIdleTime,
+                                                               &ulNextTickCycles );
+
+                /* Restart SysTick from a reload value that puts the next tick
+                back in phase, then set the normal reload value, which is used
+                from the tick after next.  As in the kernel's ports, stepping
+                the tick count in between gives SysTick time to load the first
+                value. */
+                ticklessSYSTICK_SET_RELOAD( ulNextTickCycles - 1UL );
+                ticklessSYSTICK_START_FROM_ZERO();
+                vTaskStepTick( xCompleteTickPeriods );
+                ticklessSYSTICK_SET_RELOAD( ulCyclesPerTick - 1UL );
+
+                xStats.ulSleeps++;
+                xStats.ulTicksSuppressed += ( uint32_t ) xCompleteTickPeriods;
+                xStats.ulTimeAsleep += ( uint32_t ) ullElapsedTime;
+            }
+        }
+
+        xTickCoreSleeping = pdFALSE;
+
+        ticklessRESTORE_INTERRUPTS( ulSaved );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvCompleteTickPeriods( uint32_t ulRemainingCycles,
+                                          uint64_t ullElapsedCycles,
+                                          TickType_t xExpectedIdleTime,
+                                          uint32_t *pulNextTickCycles )
+{
+    TickType_t xCompleteTickPeriods;
+    uint64_t ullAfterFirstTick, ullPeriods;
+
+    if( ullElapsedCycles < ulRemainingCycles )
+    {
+        /* Woke before the tick that was due when SysTick stopped. */
+        xCompleteTickPeriods = 0;
+        *pulNextTickCycles = ulRemainingCycles - ( uint32_t ) ullElapsedCycles;
+    }
+    else
+    {
+        ullAfterFirstTick = ullElapsedCycles - ulRemainingCycles;
+        ullPeriods = ( ullAfterFirstTick / ulCyclesPerTick ) + 1ULL;
+        *pulNextTickCycles = ulCyclesPerTick - ( uint32_t ) ( ullAfterFirstTick % ulCyclesPerTick );
+
+        if( ullPeriods >= ( uint64_t ) xExpectedIdleTime )
+        {
+            /* The tick at which a task unblocks is due, or overdue, so leave it
+            to the tick interrupt, which fires almost immediately.  The tick
+            count must not be stepped up to that tick.  Any later ticks are
+            lost. */
+            xCompleteTickPeriods = xExpectedIdleTime - 1;
+            *pulNextTickCycles = 0;
+        }
+        else
+        {
+            xCompleteTickPeriods = ( TickType_t ) ullPeriods;
+        }
+    }
+
+    /* SysTick does not count with a reload value of 0. */
+    if( *pulNextTickCycles < ulCyclesPerUs )
+    {
+        *pulNextTickCycles = ulCyclesPerUs;
+    }
+
+    return xCompleteTickPeriods;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvOtherCoresIdle( void )
+{
+    BaseType_t xCore, xReturn = pdTRUE;
+
+    for( xCore = 0; xCore < configNUM_CORES; xCore++ )
+    {
+        if( ( xCore != configTICK_CORE ) && ( ucCoreIdle[ xCore ] == ( uint8_t ) pdFALSE ) )
+        {
+            xReturn = pdFALSE;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTicklessIdleTaskSwitchedIn( void )
+{
+    const BaseType_t xCore = ticklessGET_CORE_ID();
+
+    /* Set again by vApplicationSleep() if the task switched in is the idle
+    task. */
+    ucCoreIdle[ xCore ] = ( uint8_t ) pdFALSE;
+    ticklessMEMORY_BARRIER();
+
+    if( ( xCore != configTICK_CORE ) && ( xTickCoreSleeping != pdFALSE ) )
+    {
+        /* The tick core holds the scheduler suspended while it sleeps, and may
+        not wake until the next task unblocks, so this task would lose the
+        tick it may rely on for time slicing. */
+        vTicklessIdleWakeFromISR();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vTicklessIdleTickHook( void )
+{
+    xStats.ulTickInterrupts++;
+}
+/*-----------------------------------------------------------*/
+
+void vTicklessIdleWakeFromISR( void )
+{
+    xWakeRequested = pdTRUE;
+    ticklessSEND_EVENT();
+}
+/*-----------------------------------------------------------*/
+
+void vTicklessIdleGetStats( TicklessIdleStats_t *pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if ( ticklessUSE_HOST_MODEL == 0 )
+
+    static uint64_t prvWaitForTimerEdge( void )
+    {
+        const uint64_t ullNow = time_us_64();
+        uint64_t ullEdge;
+
+        do
+        {
+            ullEdge = time_us_64();
+        } while( ullEdge == ullNow );
+
+        return ullEdge;
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvInitWakeAlarm( void )
+    {
+        /* Called on the tick core, so the alarm interrupt is enabled on, and
+        ends sleeps on, the tick core. */
+        uxWakeAlarm = ( uint ) hardware_alarm_claim_unused( true );
+        hardware_alarm_set_callback( uxWakeAlarm, prvWakeAlarmCallback );
+
+        /* Let pending interrupts end a wait for event while interrupts are
+        disabled. */
+        ticklessSCB_SCR_REG |= ticklessSCB_SEVONPEND_BIT;
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvWakeAlarmCallback( uint uxAlarm )
+    {
+        /* Nothing to do - the interrupt has already ended the sleep. */
+        ( void ) uxAlarm;
+    }
+    /*-----------------------------------------------------------*/
+
+    void vStartTicklessIdleDemoTasks( UBaseType_t uxPriority )
+    {
+        xTaskCreate( prvWakeLatencyTask, "TLWake", configMINIMAL_STACK_SIZE, NULL, uxPriority, &xWakeLatencyTask );
+        xTaskCreate( prvDelayTask, "TLDelay", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvWakeLatencyTask( void *pvParameters )
+    {
+        uint32_t ulLatency;
+
+        ( void ) pvParameters;
+
+        /* The alarm interrupt is taken by the core this task is running on
+        now, which need not be the tick core. */
+        uxDemoAlarm = ( uint ) hardware_alarm_claim_unused( true );
+        hardware_alarm_set_callback( uxDemoAlarm, prvDemoAlarmCallback );
+        xNextDemoAlarmTime = make_timeout_time_us( ticklessDEMO_ALARM_PERIOD_US );
+        hardware_alarm_set_target( uxDemoAlarm, xNextDemoAlarmTime );
+
+        for( ;; )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+            ulLatency = time_us_32() - ulLastDemoAlarmTime;
+
+            taskENTER_CRITICAL();
+            {
+                ulWakeups++;
+                ulTotalWakeLatency += ulLatency;
+
+                if( ulLatency > ulMaxWakeLatency )
+                {
+                    ulMaxWakeLatency = ulLatency;
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvDemoAlarmCallback( uint uxAlarm )
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        /* Latency is measured from when the alarm was due, not from when this
+        interrupt ran, so it includes the time taken to leave a sleep. */
+        ulLastDemoAlarmTime = ( uint32_t ) to_us_since_boot( xNextDemoAlarmTime );
+        vTaskNotifyGiveFromISR( xWakeLatencyTask, &xHigherPriorityTaskWoken );
+
+        xNextDemoAlarmTime = delayed_by_us( xNextDemoAlarmTime, ticklessDEMO_ALARM_PERIOD_US );
+
+        if( hardware_alarm_set_target( uxAlarm, xNextDemoAlarmTime ) )
+        {
+            /* The target had already passed, so start again from now. */
+            xNextDemoAlarmTime = make_timeout_time_us( ticklessDEMO_ALARM_PERIOD_US );
+            hardware_alarm_set_target( uxAlarm, xNextDemoAlarmTime );
+        }
+
+        /* This interrupt may not be on the tick core. */
+        vTicklessIdleWakeFromISR();
+
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvDelayTask( void *pvParameters )
+    {
+        TickType_t xLastWakeTime;
+        uint32_t ulLastTime, ulTime, ulError;
+        const uint32_t ulExpectedTime = ( uint32_t ) ticklessDEMO_DELAY_TICKS * ticklessUS_PER_TICK;
+
+        ( void ) pvParameters;
+
+        xLastWakeTime = xTaskGetTickCount();
+        vTaskDelayUntil( &xLastWakeTime, ticklessDEMO_DELAY_TICKS );
+        ulLastTime = time_us_32();
+
+        for( ;; )
+        {
+            /* Each wake is exactly ticklessDEMO_DELAY_TICKS ticks after the
+            last, so the time between them only varies by the latency of the
+            wake. */
+            vTaskDelayUntil( &xLastWakeTime, ticklessDEMO_DELAY_TICKS );
+            ulTime = time_us_32();
+
+            if( ( ulTime - ulLastTime ) > ulExpectedTime )
+            {
+                ulError = ( ulTime - ulLastTime ) - ulExpectedTime;
+            }
+            else
+            {
+                ulError = ulExpectedTime - ( ulTime - ulLastTime );
+            }
+
+            ulLastTime = ulTime;
+
+            taskENTER_CRITICAL();
+            {
+                ulDelays++;
+
+                if( ulError > ulMaxDelayError )
+                {
+                    ulMaxDelayError = ulError;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( ulError > ticklessDEMO_MAX_DELAY_ERROR_US )
+            {
+                xErrorDetected = pdTRUE;
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    void vTicklessIdleDemoGetResults( TicklessIdleDemoResult_t *pxResult )
+    {
+        taskENTER_CRITICAL();
+        {
+            pxResult->ulWakeups = ulWakeups;
+            pxResult->ulMeanWakeLatency = ( ulWakeups != 0 ) ? ( ulTotalWakeLatency / ulWakeups ) : 0;
+            pxResult->ulMaxWakeLatency = ulMaxWakeLatency;
+            pxResult->ulMaxDelayError = ulMaxDelayError;
+
+            ulWakeups = 0;
+            ulTotalWakeLatency = 0;
+            ulMaxWakeLatency = 0;
+            ulMaxDelayError = 0;
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+    BaseType_t xAreTicklessIdleDemoTasksStillRunning( void )
+    {
+        static uint32_t ulLastDelays = 0;
+        BaseType_t xReturn = pdPASS;
+
+        /* ulWakeups is reset by vTicklessIdleDemoGetResults(), so only the
+        delay task is checked for progress.  The check must not be made more
+        often than once every ticklessDEMO_DELAY_TICKS ticks. */
+        if( ulLastDelays == ulDelays )
+        {
+            xReturn = pdFAIL;
+        }
+
+        ulLastDelays = ulDelays;
+
+        if( xErrorDetected != pdFALSE )
+        {
+            xReturn = pdFAIL;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ticklessUSE_HOST_MODEL */
@@ -0,0 +1,120 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef TICKLESS_IDLE_H
+#define TICKLESS_IDLE_H
+
+/*
+ * Tickless idle for the SMP build, selected by setting configUSE_TICKLESS_IDLE
+ * to 2 - see the main_tickless target in CMakeLists.txt.
+ *
+ * Only the tick core (configTICK_CORE) takes the tick interrupt, so only the
+ * tick core suppresses it, and only while every other core is also running
+ * its idle task - a task running on another core may rely on the tick for time
+ * slicing.  When it sleeps, the tick core stops SysTick, arms a 64-bit timer
+ * alarm for just before the tick at which the next task unblocks, and waits for
+ * an event.  On waking it measures the time asleep with the 1MHz timer, steps
+ * the tick count over the whole tick periods that passed, and restarts SysTick
+ * so the next tick falls where it would have done had the tick not stopped.
+ *
+ * The time asleep is measured between increments of the timer, which adds up
+ * to a microsecond to each sleep but keeps SysTick in phase to within a few
+ * cycles per sleep.
+ *
+ * An interrupt taken on the tick core ends the sleep.  An interrupt taken on
+ * another core cannot, as the tick core holds the scheduler suspended while it
+ * sleeps, so interrupts on other cores that unblock tasks must call
+ * vTicklessIdleWakeFromISR().  Another core that switches in a task while the
+ * tick core is deciding whether to sleep, or is asleep, wakes the tick core
+ * itself, from vTicklessIdleTaskSwitchedIn().
+ */
+
+/* Counters maintained for the tick core. */
+typedef struct TicklessIdleStats
+{
+    uint32_t ulTickInterrupts;      /* Tick interrupts taken. */
+    uint32_t ulSleeps;              /* Times the tick was suppressed. */
+    uint32_t ulTicksSuppressed;     /* Tick periods stepped over by vTaskStepTick(). */
+    uint32_t ulEarlyWakes;          /* Sleeps ended before the wake alarm. */
+    uint32_t ulOtherCoreBusy;       /* Sleeps not taken because another core was running a task. */
+    uint32_t ulAborted;             /* Sleeps abandoned because a task became ready, or a tick was pending. */
+    uint32_t ulTimeAsleep;          /* Total time asleep, in microseconds. */
+} TicklessIdleStats_t;
+
+/* Measurements taken by the demo tasks. */
+typedef struct TicklessIdleDemoResult
+{
+    uint32_t ulWakeups;             /* Alarm interrupts handled by the wake latency task. */
+    uint32_t ulMeanWakeLatency;     /* Mean time from the alarm to the task running, in microseconds. */
+    uint32_t ulMaxWakeLatency;
+    uint32_t ulMaxDelayError;       /* Largest difference between a periodic delay and its length in microseconds. */
+} TicklessIdleDemoResult_t;
+
+/*
+ * Implements portSUPPRESS_TICKS_AND_SLEEP().  Called by the idle task with the
+ * scheduler suspended.
+ */
+void vApplicationSleep( TickType_t xExpectedIdleTime );
+
+/*
+ * Implements traceTASK_SWITCHED_IN(), to track which cores are idle.
+ */
+void vTicklessIdleTaskSwitchedIn( void );
+
+/*
+ * Must be called from the tick hook.
+ */
+void vTicklessIdleTickHook( void );
+
+/*
+ * End a sleep on the tick core.  For interrupts on other cores - see above.
+ */
+void vTicklessIdleWakeFromISR( void );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vTicklessIdleGetStats( TicklessIdleStats_t *pxStats );
+
+/*
+ * Two tasks that spend most of their time blocked.  One is woken by a hardware
+ * alarm every ticklessDEMO_ALARM_PERIOD_US microseconds and measures how long
+ * after the alarm it runs.  The other delays for ticklessDEMO_DELAY_TICKS ticks
+ * at a time and checks, against the 1MHz timer, that the delays are the right
+ * length - which they are not if the tick count is not compensated correctly
+ * after a sleep.
+ */
+void vStartTicklessIdleDemoTasks( UBaseType_t uxPriority );
+BaseType_t xAreTicklessIdleDemoTasksStillRunning( void );
+
+/*
+ * Copy the measurements taken since the last call into *pxResult.
+ */
+void vTicklessIdleDemoGetResults( TicklessIdleDemoResult_t *pxResult );
+
+#endif /* TICKLESS_IDLE_H */
@@ -0,0 +1,202 @@
+/*
+ * FreeRTOS V202107.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef TICKLESS_IDLE_HOST_MODEL_H
+#define TICKLESS_IDLE_HOST_MODEL_H
+
+/*
+ * A software model of SysTick, the 1MHz timer, one timer alarm and waiting for
+ * an event, used in place of the hardware when TicklessIdle.c is built on a
+ * host with ticklessUSE_HOST_MODEL set to 1.  Time is simulated, in CPU
+ * cycles, and only moves when the harness calls ulHostTicklessRun() or when
+ * the code under test waits for an event - which moves time on to the wake
+ * alarm, or to xHostTicklessModel.ullInterruptCycles or
+ * xHostTicklessModel.ullOtherCoreCycles if either is sooner.  At
+ * ullOtherCoreCycles the wait calls pxOtherCoreEvent, so the harness can play
+ * another core - switching in a task, say - while the tick core sleeps.
+ *
+ * HostTest/TicklessIdleTest.c builds TicklessIdle.c against this model.
+ *
+ * Like the hardware, a SysTick started from zero first counts down from the
+ * reload value it has when it is started, and later from whatever reload
+ * value it has at the time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define hostticklessCYCLES_PER_US   125U
+
+typedef struct HostTicklessModel
+{
+    uint64_t ullCycles;             /* The simulated time. */
+    uint32_t ulLoad;                /* The SysTick reload value. */
+    bool bSysTickEnabled;
+    uint64_t ullNextTickCycles;     /* When SysTick next reaches zero, if enabled. */
+    uint32_t ulStoppedCount;        /* The count SysTick stopped at, if not enabled. */
+    bool bAlarmArmed;
+    uint64_t ullAlarmTime;          /* In microseconds, like the hardware. */
+    uint64_t ullInterruptCycles;    /* When another interrupt becomes pending, or UINT64_MAX. */
+    uint32_t ulMissedTicks;         /* Ticks pending because SysTick reached zero while interrupts were disabled. */
+    uint64_t ullOtherCoreCycles;    /* When pxOtherCoreEvent is called, or UINT64_MAX. */
+    void ( *pxOtherCoreEvent )( void );
+} HostTicklessModel_t;
+
+extern HostTicklessModel_t xHostTicklessModel;
+
+static inline uint64_t ullHostTicklessGetTime( void )
+{
+    return xHostTicklessModel.ullCycles / hostticklessCYCLES_PER_US;
+}
+
+/* Move time on to the next increment of the 1MHz timer, and return the new
+time. */
+static inline uint64_t ullHostTicklessWaitForTimerEdge( void )
+{
+    uint64_t ullTime = ullHostTicklessGetTime() + 1U;
+    uint64_t ullCycles = ullTime * hostticklessCYCLES_PER_US;
+
+    if( xHostTicklessModel.bSysTickEnabled )
+    {
+        /* SysTick keeps running while the core waits. */
+        while( xHostTicklessModel.ullNextTickCycles <= ullCycles )
+        {
+            xHostTicklessModel.ullNextTickCycles += xHostTicklessModel.ulLoad + 1U;
+            xHostTicklessModel.ulMissedTicks++;
+        }
+    }
+
+    xHostTicklessModel.ullCycles = ullCycles;
+
+    return ullTime;
+}
+
+static inline uint32_t ulHostTicklessSysTickGetCount( void )
+{
+    uint32_t ulCount;
+
+    if( xHostTicklessModel.bSysTickEnabled )
+    {
+        ulCount = ( uint32_t ) ( xHostTicklessModel.ullNextTickCycles - xHostTicklessModel.ullCycles );
+    }
+    else
+    {
+        ulCount = xHostTicklessModel.ulStoppedCount;
+    }
+
+    return ulCount;
+}
+
+static inline void vHostTicklessSysTickStop( void )
+{
+    xHostTicklessModel.ulStoppedCount = ulHostTicklessSysTickGetCount();
+    xHostTicklessModel.bSysTickEnabled = false;
+}
+
+static inline void vHostTicklessSysTickStart( bool bFromZero )
+{
+    if( bFromZero )
+    {
+        xHostTicklessModel.ullNextTickCycles = xHostTicklessModel.ullCycles + xHostTicklessModel.ulLoad + 1U;
+    }
+    else
+    {
+        xHostTicklessModel.ullNextTickCycles = xHostTicklessModel.ullCycles + xHostTicklessModel.ulStoppedCount;
+    }
+
+    xHostTicklessModel.bSysTickEnabled = true;
+}
+
+static inline bool bHostTicklessSetAlarm( uint64_t ullTime )
+{
+    bool bSet = false;
+
+    if( ullTime > ullHostTicklessGetTime() )
+    {
+        xHostTicklessModel.ullAlarmTime = ullTime;
+        xHostTicklessModel.bAlarmArmed = true;
+        bSet = true;
+    }
+
+    return bSet;
+}
+
+static inline bool bHostTicklessInterruptPending( void )
+{
+    return ( xHostTicklessModel.bAlarmArmed && ( ullHostTicklessGetTime() >= xHostTicklessModel.ullAlarmTime ) ) ||
+           ( xHostTicklessModel.ullCycles >= xHostTicklessModel.ullInterruptCycles );
+}
+
+static inline void vHostTicklessWaitForEvent( void )
+{
+    uint64_t ullWake = xHostTicklessModel.ullInterruptCycles;
+
+    if( xHostTicklessModel.bAlarmArmed && ( ( xHostTicklessModel.ullAlarmTime * hostticklessCYCLES_PER_US ) < ullWake ) )
+    {
+        ullWake = xHostTicklessModel.ullAlarmTime * hostticklessCYCLES_PER_US;
+    }
+
+    if( xHostTicklessModel.ullOtherCoreCycles < ullWake )
+    {
+        /* The other core acts first.  Whether it sends an event or not, the
+        wait ends, as a spurious event would end it. */
+        ullWake = xHostTicklessModel.ullOtherCoreCycles;
+        xHostTicklessModel.ullOtherCoreCycles = UINT64_MAX;
+
+        if( ullWake > xHostTicklessModel.ullCycles )
+        {
+            xHostTicklessModel.ullCycles = ullWake;
+        }
+
+        xHostTicklessModel.pxOtherCoreEvent();
+    }
+    else if( ullWake > xHostTicklessModel.ullCycles )
+    {
+        xHostTicklessModel.ullCycles = ullWake;
+    }
+}
+
+/* Move time on by ullCycles with SysTick running, and return the number of
+times SysTick reached zero. */
+static inline uint32_t ulHostTicklessRun( uint64_t ullCycles )
+{
+    uint64_t ullEnd = xHostTicklessModel.ullCycles + ullCycles;
+    uint32_t ulTicks = 0;
+
+    while( xHostTicklessModel.bSysTickEnabled && ( xHostTicklessModel.ullNextTickCycles <= ullEnd ) )
+    {
+        xHostTicklessModel.ullNextTickCycles += xHostTicklessModel.ulLoad + 1U;
+        ulTicks++;
+    }
+
+    xHostTicklessModel.ullCycles = ullEnd;
+
+    return ulTicks;
+}
+
+#endif /* TICKLESS_IDLE_HOST_MODEL_H */
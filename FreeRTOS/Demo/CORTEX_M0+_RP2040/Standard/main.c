@@ -53,6 +53,13 @@
 #include "EventGroupsDemo.h"
 #include "IntSemTest.h"
 #include "TaskNotify.h"
+#include "BlockPoolDemo.h"
+#include "TickLoadBenchmark.h"
+#include "partest.h"
+#include "ParTestBatch.h"
+#if ( configUSE_TICKLESS_IDLE == 2 )
+#include "TicklessIdle.h"
+#endif
 
 #include "main.h"
 
@@ -62,6 +69,15 @@
 #if ( mainRUN_ON_CORE == 1 )
 #include "pico/multicore.h"
 #endif
+#if ( mainOFFLOAD_TICK_WORK == 1 )
+#include "timers.h"
+#include "hardware/timer.h"
+#include "pico/time.h"
+
+/* The core that runs the work moved off the tick core. */
+#define mainTICK_WORK_CORE ( ( configTICK_CORE + 1 ) % configNUM_CORES )
+#define mainTICK_WORK_PERIOD_US ( 1000000UL / configTICK_RATE_HZ )
+#endif
 
 /* Set mainCREATE_SIMPLE_BLINKY_DEMO_ONLY to one to run the simple blinky demo,
 or 0 to run the more comprehensive test and demo application. */
@@ -90,6 +106,28 @@ void vApplicationIdleHook( void );
 void vApplicationStackOverflowHook( TaskHandle_t pxTask, char *pcTaskName );
 void vApplicationTickHook( void );
 
+#if mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 0
+/*
+ * The tests the full demo drives from the tick.  Called by the tick hook, or,
+ * if mainOFFLOAD_TICK_WORK is 1, by a hardware alarm interrupt at the same rate
+ * on the core that does not take the tick interrupt.
+ */
+static void prvTickWork( void );
+#endif
+
+#if ( mainOFFLOAD_TICK_WORK == 1 )
+/*
+ * Called by main_full() to create a task on mainTICK_WORK_CORE that starts the
+ * alarm that calls prvTickWork(), and moves the timer daemon task to
+ * mainTICK_WORK_CORE.
+ */
+void vStartTickWorkOffload( void );
+static void prvTickWorkOffloadTask( void *pvParameters );
+static void prvTickWorkAlarmCallback( uint uxAlarm );
+
+static absolute_time_t xNextTickWorkTime;
+#endif
+
 /*-----------------------------------------------------------*/
 
 void vLaunch( void)
@@ -139,9 +177,8 @@ int main( void )
 static void prvSetupHardware( void )
 {
     stdio_init_all();
-    gpio_init(PICO_DEFAULT_LED_PIN);
-    gpio_set_dir(PICO_DEFAULT_LED_PIN, 1);
-    gpio_put(PICO_DEFAULT_LED_PIN, !PICO_DEFAULT_LED_PIN_INVERTED);
+    vParTestInitialise();
+    vParTestSetLED(PICO_DEFAULT_LED_PIN, !PICO_DEFAULT_LED_PIN_INVERTED);
 }
 /*-----------------------------------------------------------*/
 
@@ -192,33 +229,118 @@ void vApplicationIdleHook( void )
 
 void vApplicationTickHook( void )
 {
+    /* Write the LED changes made since the last tick. */
+    vParTestFlushFromISR();
+
+#if ( configUSE_TICKLESS_IDLE == 2 )
+    /* Count the tick interrupts that were not suppressed. */
+    vTicklessIdleTickHook();
+#endif
+
 #if mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 0
     {
-        /* The full demo includes a software timer demo/test that requires
-        prodding periodically from the tick interrupt. */
-        #if (mainENABLE_TIMER_DEMO == 1)
-        vTimerPeriodicISRTests();
+        /* Time stamp the tick for the tick load benchmark. */
+        #if (mainENABLE_TICK_LOAD_BENCHMARK == 1)
+        vTickLoadBenchmarkTickHook();
         #endif
 
-        /* Call the periodic queue overwrite from ISR demo. */
-        #if (mainENABLE_QUEUE_OVERWRITE == 1)
-        vQueueOverwritePeriodicISRDemo();
+        /* Unless it has been moved to the other core, run the tests that are
+        driven from the tick. */
+        #if (mainOFFLOAD_TICK_WORK == 0)
+        prvTickWork();
         #endif
+    }
+#endif
+}
+/*-----------------------------------------------------------*/
 
-        /* Call the periodic event group from ISR demo. */
-        #if (mainENABLE_EVENT_GROUP == 1)
-        vPeriodicEventGroupsProcessing();
-        #endif
+#if mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 0
 
-        /* Call the code that uses a mutex from an ISR. */
-        #if (mainENABLE_INTERRUPT_SEMAPHORE == 1)
-        vInterruptSemaphorePeriodicTest();
-        #endif
+static void prvTickWork( void )
+{
+    /* The full demo includes a software timer demo/test that requires
+    prodding periodically from the tick interrupt. */
+    #if (mainENABLE_TIMER_DEMO == 1)
+    vTimerPeriodicISRTests();
+    #endif
 
-        /* Call the code that 'gives' a task notification from an ISR. */
-        #if (mainENABLE_TASK_NOTIFY == 1)
-        xNotifyTaskFromISR();
-        #endif
+    /* Call the periodic queue overwrite from ISR demo. */
+    #if (mainENABLE_QUEUE_OVERWRITE == 1)
+    vQueueOverwritePeriodicISRDemo();
+    #endif
+
+    /* Call the periodic event group from ISR demo. */
+    #if (mainENABLE_EVENT_GROUP == 1)
+    vPeriodicEventGroupsProcessing();
+    #endif
+
+    /* Call the code that uses a mutex from an ISR. */
+    #if (mainENABLE_INTERRUPT_SEMAPHORE == 1)
+    vInterruptSemaphorePeriodicTest();
+    #endif
+
+    /* Call the code that 'gives' a task notification from an ISR. */
+    #if (mainENABLE_TASK_NOTIFY == 1)
+    xNotifyTaskFromISR();
+    #endif
+
+    /* Call the code that exchanges block pool blocks with a task. */
+    #if (mainENABLE_BLOCK_POOL == 1)
+    vBlockPoolPeriodicISRTest();
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+#if (mainOFFLOAD_TICK_WORK == 1)
+
+void vStartTickWorkOffload( void )
+{
+    TaskHandle_t xTask;
+
+    xTaskCreate( prvTickWorkOffloadTask, "TickOff", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &xTask );
+    vTaskCoreAffinitySet( xTask, ( UBaseType_t ) 1 << mainTICK_WORK_CORE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickWorkOffloadTask( void *pvParameters )
+{
+    uint uxAlarm;
+
+    ( void ) pvParameters;
+
+    /* This task runs on mainTICK_WORK_CORE, so the alarm interrupt is enabled
+    on, and taken by, that core. */
+    uxAlarm = ( uint ) hardware_alarm_claim_unused( true );
+    hardware_alarm_set_callback( uxAlarm, prvTickWorkAlarmCallback );
+    xNextTickWorkTime = make_timeout_time_us( mainTICK_WORK_PERIOD_US );
+    hardware_alarm_set_target( uxAlarm, xNextTickWorkTime );
+
+    /* Software timers expire in the timer daemon task, so move that too. */
+    vTaskCoreAffinitySet( xTimerGetTimerDaemonTaskHandle(), ( UBaseType_t ) 1 << mainTICK_WORK_CORE );
+
+    /* Suspend rather than delete this task, as the death test checks the
+    number of tasks does not fall. */
+    vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickWorkAlarmCallback( uint uxAlarm )
+{
+    prvTickWork();
+
+    /* Set the next target from the last, not from now, so the alarm keeps
+    the same average rate as the tick. */
+    xNextTickWorkTime = delayed_by_us( xNextTickWorkTime, mainTICK_WORK_PERIOD_US );
+
+    if( hardware_alarm_set_target( uxAlarm, xNextTickWorkTime ) )
+    {
+        /* The target had already passed, so start again from now. */
+        xNextTickWorkTime = make_timeout_time_us( mainTICK_WORK_PERIOD_US );
+        hardware_alarm_set_target( uxAlarm, xNextTickWorkTime );
     }
-#endif
 }
+/*-----------------------------------------------------------*/
+
+#endif /* mainOFFLOAD_TICK_WORK */
+
+#endif /* mainCREATE_SIMPLE_BLINKY_DEMO_ONLY */
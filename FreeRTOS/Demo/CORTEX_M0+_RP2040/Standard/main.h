@@ -44,6 +44,7 @@
 #define mainENABLE_REG_TEST 1
 #define mainENABLE_SEMAPHORE 1
 #define mainENABLE_TASK_NOTIFY 1
+#define mainENABLE_BLOCK_POOL 1
 
 #if configNUM_CORES != 2 || configRUN_MULTIPLE_PRIORITIES == 0
 
@@ -62,4 +63,56 @@
 #define mainENABLE_DYNAMIC_PRIORITY 1
 #endif
 
+/* Benchmarks.  These load the system heavily enough to perturb the timing of
+the tests above, so are disabled by default.  The main_full_timer_bench and
+main_full_timer_wheel_bench targets build the full demo with the timer benchmark
+enabled, timing the kernel's software timers and the timing wheel in
+TimerWheel.c respectively. */
+#ifndef mainENABLE_TIMER_BENCHMARK
+    #define mainENABLE_TIMER_BENCHMARK 0
+#endif
+#define mainENABLE_QUEUE_SET_BENCHMARK 0
+#define mainENABLE_ADAPTIVE_MUTEX_BENCHMARK 0
+
+/* Build main_full (heap_4.c) and main_full_tlsf (heap_tlsf.c) with this set to
+1 to compare the two heaps. */
+#define mainENABLE_HEAP_BENCHMARK 0
+#define mainENABLE_BLOCK_POOL_BENCHMARK 0
+
+/* Compares memcpy() with the DMA copy service in DMACopy.c. */
+#define mainENABLE_DMA_COPY_BENCHMARK 0
+
+/* Measures the spare capacity and task wake latency of each core - see
+TickLoadBenchmark.h.  Build main_full (tick on core 0) and main_full_tick1
+(tick on core 1) with this set to 1 to see the effect of moving the tick. */
+#define mainENABLE_TICK_LOAD_BENCHMARK 0
+
+/* Compares writing each message straight to stdio with logging through the
+per core rings in LogRing.c. */
+#define mainENABLE_LOG_RING_BENCHMARK 0
+
+/* Set to 1 to run the tests that are driven from the tick hook from a hardware
+alarm interrupt on the core that does not take the tick interrupt, and to move
+the timer daemon task to that core, leaving the tick core with only the tick
+itself. */
+#define mainOFFLOAD_TICK_WORK 0
+
+/* Instrumentation.  Set to 1 to sample the state of the hardware spin locks,
+including those used by the port's critical sections, and to run two tasks
+that contend for an instrumented spin lock - see SpinlockStats.h.  The check
+task prints the statistics. */
+#define mainENABLE_SPINLOCK_STATS 0
+
+/* Set to 1 to show the status of the full demo as a pattern on a GPIO driven by
+a PIO state machine - see mainPATTERN_GPIO in main_full.c. */
+#define mainENABLE_GPIO_PATTERN 0
+
+/* Set to 1 to send the full demo's printf() and puts() output through the per
+core rings in LogRing.c, which a low priority task drains to stdio in large
+writes, so the calling tasks never wait for the console.  main_full_log builds
+the full demo with this set to 1 and stdio on USB CDC. */
+#ifndef mainUSE_LOG_RING
+    #define mainUSE_LOG_RING 0
+#endif
+
 #endif /* MAIN_H */
\ No newline at end of file
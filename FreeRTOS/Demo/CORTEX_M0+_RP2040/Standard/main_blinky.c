@@ -60,6 +60,12 @@
  * send task writes to the queue every 200 milliseconds, the queue receive
  * task leaves the Blocked state every 200 milliseconds, and therefore toggles
  * the LED every 200 milliseconds.
+ *
+ * The Tickless Idle Tasks:
+ * Only created when configUSE_TICKLESS_IDLE is 2, as it is in the main_tickless
+ * build.  The tasks in TicklessIdle.c measure wake latency and check the tick
+ * count, and prvTicklessReportTask() prints how often the tick core woke, and
+ * the measurements, every mainTICKLESS_REPORT_PERIOD_MS milliseconds.
  */
 
 /* Kernel includes. */
@@ -69,7 +75,9 @@
 
 /* Library includes. */
 #include <stdio.h>
-#include "hardware/gpio.h"
+
+/* Demo includes. */
+#include "partest.h"
 
 /* Priorities at which the tasks are created. */
 #define mainQUEUE_RECEIVE_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
@@ -87,6 +95,14 @@ the queue empty. */
 /* The LED toggled by the Rx task. */
 #define mainTASK_LED						( PICO_DEFAULT_LED_PIN )
 
+#if ( configUSE_TICKLESS_IDLE == 2 )
+	#include "TicklessIdle.h"
+
+	#define mainTICKLESS_DEMO_PRIORITY		( tskIDLE_PRIORITY + 3 )
+	#define mainTICKLESS_REPORT_PRIORITY	( tskIDLE_PRIORITY + 1 )
+	#define mainTICKLESS_REPORT_PERIOD_MS	( 5000 / portTICK_PERIOD_MS )
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -101,6 +117,14 @@ void main_blinky( void );
 static void prvQueueReceiveTask( void *pvParameters );
 static void prvQueueSendTask( void *pvParameters );
 
+#if ( configUSE_TICKLESS_IDLE == 2 )
+/*
+ * Prints the tickless idle statistics - see the comments at the top of this
+ * file.
+ */
+static void prvTicklessReportTask( void *pvParameters );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The queue used by both tasks. */
@@ -128,6 +152,13 @@ void main_blinky( void )
 
 		xTaskCreate( prvQueueSendTask, "TX", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_SEND_TASK_PRIORITY, NULL );
 
+		#if ( configUSE_TICKLESS_IDLE == 2 )
+		{
+			vStartTicklessIdleDemoTasks( mainTICKLESS_DEMO_PRIORITY );
+			xTaskCreate( prvTicklessReportTask, "TLReport", configMINIMAL_STACK_SIZE, NULL, mainTICKLESS_REPORT_PRIORITY, NULL );
+		}
+		#endif
+
 		/* Start the tasks and timer running. */
 		vTaskStartScheduler();
 	}
@@ -186,10 +217,57 @@ const unsigned long ulExpectedValue = 100UL;
 		is it the expected value?  If it is, toggle the LED. */
 		if( ulReceivedValue == ulExpectedValue )
 		{
-			gpio_xor_mask( 1u << mainTASK_LED );
+			vParTestToggleLED( mainTASK_LED );
 			ulReceivedValue = 0U;
 		}
 	}
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TICKLESS_IDLE == 2 )
+
+static void prvTicklessReportTask( void *pvParameters )
+{
+TickType_t xNextWakeTime;
+TicklessIdleStats_t xLast, xNow;
+TicklessIdleDemoResult_t xResult;
+uint32_t ulPeriod, ulTicks, ulSleeps;
+
+	/* Remove compiler warning about unused parameter. */
+	( void ) pvParameters;
+
+	xNextWakeTime = xTaskGetTickCount();
+	vTicklessIdleGetStats( &xLast );
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xNextWakeTime, mainTICKLESS_REPORT_PERIOD_MS );
+
+		vTicklessIdleGetStats( &xNow );
+		vTicklessIdleDemoGetResults( &xResult );
+
+		/* Rates per second.  Each sleep ends with one wake up, and each tick
+		interrupt that was not suppressed is another. */
+		ulPeriod = mainTICKLESS_REPORT_PERIOD_MS / configTICK_RATE_HZ;
+		ulTicks = ( xNow.ulTickInterrupts - xLast.ulTickInterrupts ) / ulPeriod;
+		ulSleeps = ( xNow.ulSleeps - xLast.ulSleeps ) / ulPeriod;
+
+		printf( "Tick core: %u wakeups/s (%u ticks/s, %u sleeps/s), %u%% asleep, %u busy, %u aborted, %u early\n",
+				( unsigned ) ( ulTicks + ulSleeps ), ( unsigned ) ulTicks, ( unsigned ) ulSleeps,
+				( unsigned ) ( ( xNow.ulTimeAsleep - xLast.ulTimeAsleep ) / ( ulPeriod * 10000UL ) ),
+				( unsigned ) ( xNow.ulOtherCoreBusy - xLast.ulOtherCoreBusy ),
+				( unsigned ) ( xNow.ulAborted - xLast.ulAborted ),
+				( unsigned ) ( xNow.ulEarlyWakes - xLast.ulEarlyWakes ) );
+
+		printf( "Wake latency: %u us (max %u us) over %u wakeups, max delay error %u us - %s\n",
+				( unsigned ) xResult.ulMeanWakeLatency, ( unsigned ) xResult.ulMaxWakeLatency,
+				( unsigned ) xResult.ulWakeups, ( unsigned ) xResult.ulMaxDelayError,
+				( xAreTicklessIdleDemoTasksStillRunning() == pdPASS ) ? "OK" : "ERROR" );
+
+		xLast = xNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TICKLESS_IDLE */
+
@@ -67,6 +67,7 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <unistd.h>
 
 /* Kernel includes. */
 #include "FreeRTOS.h"
@@ -96,9 +97,30 @@
 #include "EventGroupsDemo.h"
 #include "IntSemTest.h"
 #include "TaskNotify.h"
+#include "TimerBenchmark.h"
+#include "QueueSetBenchmark.h"
+#include "MutexProfiler.h"
+#include "AdaptiveMutexBenchmark.h"
+#include "HeapBenchmark.h"
+#include "BlockPoolDemo.h"
+#include "BlockPoolBenchmark.h"
+#include "DMACopyBenchmark.h"
+#include "SpinlockStats.h"
+#include "TickLoadBenchmark.h"
+#include "LogRing.h"
+#include "LogRingBenchmark.h"
+#include "partest.h"
+#include "ParTestBatch.h"
 
 #include "main.h"
 
+#if (mainUSE_LOG_RING == 1)
+	/* Log through LogRing.c.  The macros are function-like so the C library
+	functions can still be called directly as ( printf )() and ( puts )(). */
+	#define printf( ... )					lLogRingPrintf( __VA_ARGS__ )
+	#define puts( pcString )				lLogRingPuts( pcString )
+#endif
+
 /* Priorities for the demo application tasks. */
 #define mainSEM_TEST_PRIORITY				( tskIDLE_PRIORITY + 1UL )
 #define mainBLOCK_Q_PRIORITY				( tskIDLE_PRIORITY + 2UL )
@@ -108,6 +130,16 @@
 #define mainCOM_TEST_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
 #define mainCHECK_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
 #define mainQUEUE_OVERWRITE_PRIORITY		( tskIDLE_PRIORITY )
+#define mainTIMER_BENCHMARK_PRIORITY		( tskIDLE_PRIORITY + 1UL )
+#define mainQUEUE_SET_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + 1UL )
+#define mainADAPTIVE_MUTEX_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + 1UL )
+#define mainHEAP_BENCHMARK_PRIORITY			( tskIDLE_PRIORITY + 1UL )
+#define mainBLOCK_POOL_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + 1UL )
+#define mainDMA_COPY_BENCHMARK_PRIORITY		( tskIDLE_PRIORITY + 2UL )
+#define mainSPINLOCK_STATS_PRIORITY			( tskIDLE_PRIORITY + 1UL )
+#define mainTICK_LOAD_BENCHMARK_PRIORITY	( tskIDLE_PRIORITY + 1UL )
+#define mainLOG_RING_TASK_PRIORITY			( tskIDLE_PRIORITY + 1UL )
+#define mainLOG_RING_BENCHMARK_PRIORITY		( tskIDLE_PRIORITY + 2UL )
 
 /* The initial priority used by the UART command console task. */
 #define mainUART_COMMAND_CONSOLE_TASK_PRIORITY	( configMAX_PRIORITIES - 2 )
@@ -115,6 +147,15 @@
 /* The LED used by the check task. */
 #define mainCHECK_LED						( PICO_DEFAULT_LED_PIN )
 
+/* The GPIO that shows a status pattern when mainENABLE_GPIO_PATTERN is 1.  The
+patterns are sent out least significant bit first, one bit every
+mainPATTERN_STEP_US microseconds - a double blink every 1.6 seconds if all is
+well, and a fast blink if an error has been found. */
+#define mainPATTERN_GPIO					( 2 )
+#define mainPATTERN_STEP_US					( 50000UL )
+#define mainPATTERN_NO_ERROR				( 0x00000005UL )
+#define mainPATTERN_ERROR					( 0x33333333UL )
+
 /* A block time of zero simply means "don't block". */
 #define mainDONT_BLOCK						( 0UL )
 
@@ -161,6 +202,20 @@ extern void vRegTest1Implementation( void );
 static void prvRegTestTaskEntry2( void *pvParameters );
 extern void vRegTest2Implementation( void );
 
+/*
+ * Defined in main.c.  Moves the work done in the tick hook, and the timer
+ * daemon task, off the tick core - see mainOFFLOAD_TICK_WORK in main.h.
+ */
+extern void vStartTickWorkOffload( void );
+
+/*
+ * Write to stdio in a single call, for the log ring drain task and the direct
+ * logging measured by the log ring benchmark.
+ */
+#if (mainUSE_LOG_RING == 1) || (mainENABLE_LOG_RING_BENCHMARK == 1)
+	static void prvWriteConsole( const char *pcData, size_t xLength );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* The following two variables are used to communicate the status of the
@@ -177,6 +232,12 @@ void main_full( void )
 	functionality, but do demonstrate how to use the FreeRTOS API and test the
 	kernel port. */
 
+#if (mainUSE_LOG_RING == 1) || (mainENABLE_LOG_RING_BENCHMARK == 1)
+	/* Started first so everything below is logged through the rings.  Nothing
+	is drained until the scheduler starts. */
+	vStartLogRingTask( mainLOG_RING_TASK_PRIORITY, prvWriteConsole );
+#endif
+
 	puts(" Starting tests:");
 #if (mainENABLE_INTERRUPT_QUEUE == 1)
     puts("  - Interrupt Queue");
@@ -234,6 +295,51 @@ void main_full( void )
     puts("  - Task Notify");
 	vStartTaskNotifyTask();
 #endif
+#if (mainENABLE_BLOCK_POOL == 1)
+    puts("  - Block Pool");
+	vStartBlockPoolDemoTasks();
+#endif
+#if (mainENABLE_TIMER_BENCHMARK == 1)
+    puts("  - Timer Benchmark");
+	vStartTimerBenchmarkTask( mainTIMER_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_QUEUE_SET_BENCHMARK == 1)
+    puts("  - Queue Set Benchmark");
+	vStartQueueSetBenchmarkTasks( mainQUEUE_SET_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_ADAPTIVE_MUTEX_BENCHMARK == 1)
+    puts("  - Adaptive Mutex Benchmark");
+	vStartAdaptiveMutexBenchmarkTasks( mainADAPTIVE_MUTEX_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_HEAP_BENCHMARK == 1)
+    puts("  - Heap Benchmark");
+	vStartHeapBenchmarkTasks( mainHEAP_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_BLOCK_POOL_BENCHMARK == 1)
+    puts("  - Block Pool Benchmark");
+	vStartBlockPoolBenchmarkTasks( mainBLOCK_POOL_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_DMA_COPY_BENCHMARK == 1)
+    puts("  - DMA Copy Benchmark");
+	vStartDMACopyBenchmarkTasks( mainDMA_COPY_BENCHMARK_PRIORITY );
+#endif
+#if (mainENABLE_SPINLOCK_STATS == 1)
+    puts("  - Spinlock Statistics");
+	vSpinlockStatsStartSampling();
+	vStartSpinlockStatsTasks( mainSPINLOCK_STATS_PRIORITY );
+#endif
+#if (mainENABLE_TICK_LOAD_BENCHMARK == 1)
+    puts("  - Tick Load Benchmark");
+	vStartTickLoadBenchmarkTasks( mainTICK_LOAD_BENCHMARK_PRIORITY );
+#endif
+#if (mainOFFLOAD_TICK_WORK == 1)
+    puts("  - Tick Work Offload");
+	vStartTickWorkOffload();
+#endif
+#if (mainENABLE_LOG_RING_BENCHMARK == 1)
+    puts("  - Log Ring Benchmark");
+	vStartLogRingBenchmarkTasks( mainLOG_RING_BENCHMARK_PRIORITY, prvWriteConsole );
+#endif
 
 #if (mainENABLE_REG_TEST == 1)
 	puts("  - Register");
@@ -282,6 +388,11 @@ unsigned long ulIterations = 0;
 	works correctly. */
 	xLastExecutionTime = xTaskGetTickCount();
 
+#if (mainENABLE_GPIO_PATTERN == 1)
+	/* The pattern runs on a PIO state machine, so costs no CPU time. */
+	xParTestSetLEDPattern( mainPATTERN_GPIO, mainPATTERN_NO_ERROR, mainPATTERN_STEP_US );
+#endif
+
 	/* Cycle for ever, delaying then checking all the other tasks are still
 	operating without error.  The onboard LED is toggled on each iteration.
 	If an error is detected then the delay period is decreased from
@@ -416,10 +527,314 @@ unsigned long ulIterations = 0;
 		ulLastRegTest2Value = ulRegTest2LoopCounter;
         #endif
 
+        #if (mainENABLE_TIMER_BENCHMARK == 1)
+		if( xIsTimerBenchmarkTaskStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 17UL;
+		}
+		else
+		{
+			static uint32_t ulLastTimerBenchmarkSweep = 0;
+			const TimerBenchmarkResult_t *pxResults;
+			uint32_t ulSweep;
+			UBaseType_t uxResults, ux;
+
+			/* Print the results of each sweep once. */
+			uxResults = uxGetTimerBenchmarkResults( &pxResults, &ulSweep );
+			if( ulSweep != ulLastTimerBenchmarkSweep )
+			{
+				ulLastTimerBenchmarkSweep = ulSweep;
+				for( ux = 0; ux < uxResults; ux++ )
+				{
+					/* Times are in microseconds if configGENERATE_RUN_TIME_STATS is 1,
+					otherwise in ticks - see portGET_RUN_TIME_COUNTER_VALUE(). */
+					printf("Timers %5u: start %u reset %u batched reset %u stop %u us; expiries %u late max %u total %u\n",
+						   ( unsigned ) pxResults[ ux ].ulNumberOfTimers, ( unsigned ) pxResults[ ux ].ulStartTime,
+						   ( unsigned ) pxResults[ ux ].ulResetTime, ( unsigned ) pxResults[ ux ].ulBatchResetTime,
+						   ( unsigned ) pxResults[ ux ].ulStopTime, ( unsigned ) pxResults[ ux ].ulExpiries,
+						   ( unsigned ) pxResults[ ux ].xMaxLateness, ( unsigned ) pxResults[ ux ].ulTotalLateness);
+
+					if( ( pxResults[ ux ].ulResetTime != 0 ) && ( pxResults[ ux ].ulBatchResetTime != 0 ) )
+					{
+						printf("  reset commands/s: %u individually, %u batched\n",
+							   ( unsigned ) ( ( ( uint64_t ) pxResults[ ux ].ulNumberOfTimers * 1000000ULL ) / pxResults[ ux ].ulResetTime ),
+							   ( unsigned ) ( ( ( uint64_t ) pxResults[ ux ].ulNumberOfTimers * 1000000ULL ) / pxResults[ ux ].ulBatchResetTime ));
+					}
+				}
+			}
+		}
+        #endif
+
+        #if (recmuUSE_MUTEX_PROFILER == 1) || (genqUSE_MUTEX_PROFILER == 1)
+		{
+			static MutexProfile_t xProfiles[ configQUEUE_REGISTRY_SIZE ];
+			UBaseType_t uxProfiles, ux;
+
+			/* Print a table of the contention seen on each profiled mutex.
+			Times are in microseconds if configGENERATE_RUN_TIME_STATS is 1, otherwise
+			in ticks - see portGET_RUN_TIME_COUNTER_VALUE(). */
+			uxProfiles = uxMutexProfilerGetProfiles( xProfiles, configQUEUE_REGISTRY_SIZE );
+			if( uxProfiles > 0 )
+			{
+				printf("Mutex             Takes  Contended  Timeouts  Wait total  Wait max  Boosts  Holder core0/core1\n");
+				for( ux = 0; ux < uxProfiles; ux++ )
+				{
+					printf("%-16s %6u %10u %9u %11u %9u %7u  %u/%u\n",
+						   xProfiles[ ux ].pcMutexName, ( unsigned ) xProfiles[ ux ].ulAcquisitions,
+						   ( unsigned ) xProfiles[ ux ].ulContendedAcquisitions, ( unsigned ) xProfiles[ ux ].ulTimeouts,
+						   ( unsigned ) xProfiles[ ux ].ulTotalWaitTime, ( unsigned ) xProfiles[ ux ].ulMaxWaitTime,
+						   ( unsigned ) xProfiles[ ux ].ulPriorityInheritanceBoosts,
+						   ( unsigned ) xProfiles[ ux ].ulContendedByHolderCore[ 0 ], ( unsigned ) xProfiles[ ux ].ulContendedByHolderCore[ 1 ]);
+				}
+			}
+		}
+        #endif
+
+        #if (mainENABLE_QUEUE_SET_BENCHMARK == 1)
+		if( xAreQueueSetBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 18UL;
+		}
+		else
+		{
+			static uint32_t ulLastQueueSetBenchmarkSweep = 0;
+			const QueueSetBenchmarkResult_t *pxResults;
+			uint32_t ulSweep;
+			UBaseType_t uxResults, ux;
+
+			uxResults = uxGetQueueSetBenchmarkResults( &pxResults, &ulSweep );
+			if( ulSweep != ulLastQueueSetBenchmarkSweep )
+			{
+				ulLastQueueSetBenchmarkSweep = ulSweep;
+				for( ux = 0; ux < uxResults; ux++ )
+				{
+					printf("Set of %2u: queue set %u items/s latency mean %u max %u us; wait for any %u items/s latency mean %u max %u us\n",
+						   ( unsigned ) pxResults[ ux ].ulNumberOfMembers,
+						   ( unsigned ) pxResults[ ux ].xQueueSet.ulItemsPerSecond, ( unsigned ) pxResults[ ux ].xQueueSet.ulMeanLatency,
+						   ( unsigned ) pxResults[ ux ].xQueueSet.ulMaxLatency,
+						   ( unsigned ) pxResults[ ux ].xWaitForAny.ulItemsPerSecond, ( unsigned ) pxResults[ ux ].xWaitForAny.ulMeanLatency,
+						   ( unsigned ) pxResults[ ux ].xWaitForAny.ulMaxLatency);
+				}
+			}
+		}
+        #endif
+
+        #if (mainENABLE_ADAPTIVE_MUTEX_BENCHMARK == 1)
+		if( xAreAdaptiveMutexBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 19UL;
+		}
+		else
+		{
+			static uint32_t ulLastAdaptiveMutexBenchmarkRun = 0;
+			AdaptiveMutexBenchmarkResult_t xStandard, xAdaptive;
+			uint32_t ulRun;
+
+			if( ( xGetAdaptiveMutexBenchmarkResults( &xStandard, &xAdaptive, &ulRun ) == pdPASS ) && ( ulRun != ulLastAdaptiveMutexBenchmarkRun ) )
+			{
+				ulLastAdaptiveMutexBenchmarkRun = ulRun;
+				printf("Standard mutex: %u takes/s, %u handoffs latency mean %u max %u us\n",
+					   ( unsigned ) xStandard.ulAcquisitionsPerSecond, ( unsigned ) xStandard.ulHandoffs,
+					   ( unsigned ) xStandard.ulMeanHandoffLatency, ( unsigned ) xStandard.ulMaxHandoffLatency);
+				printf("Adaptive mutex: %u takes/s, %u handoffs latency mean %u max %u us (%u spun, %u blocked)\n",
+					   ( unsigned ) xAdaptive.ulAcquisitionsPerSecond, ( unsigned ) xAdaptive.ulHandoffs,
+					   ( unsigned ) xAdaptive.ulMeanHandoffLatency, ( unsigned ) xAdaptive.ulMaxHandoffLatency,
+					   ( unsigned ) xAdaptive.ulSpinAcquisitions, ( unsigned ) xAdaptive.ulBlockedAcquisitions);
+			}
+		}
+        #endif
+
+        #if (mainENABLE_HEAP_BENCHMARK == 1)
+		if( xAreHeapBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 20UL;
+		}
+		else
+		{
+			static uint32_t ulLastHeapBenchmarkRun = 0;
+			HeapBenchmarkResult_t xHeap;
+			uint32_t ulRun;
+
+			if( ( xGetHeapBenchmarkResults( &xHeap, &ulRun ) == pdPASS ) && ( ulRun != ulLastHeapBenchmarkRun ) )
+			{
+				ulLastHeapBenchmarkRun = ulRun;
+				printf("Heap: %u ops/s, malloc mean %u max %u us, free mean %u max %u us, %u failed\n",
+					   ( unsigned ) xHeap.ulOperationsPerSecond,
+					   ( unsigned ) xHeap.ulMeanMallocLatency, ( unsigned ) xHeap.ulMaxMallocLatency,
+					   ( unsigned ) xHeap.ulMeanFreeLatency, ( unsigned ) xHeap.ulMaxFreeLatency,
+					   ( unsigned ) xHeap.ulFailedAllocations);
+				printf("Heap: fragmentation mean %u max %u /1000, minimum ever free %u bytes\n",
+					   ( unsigned ) xHeap.ulMeanFragmentation, ( unsigned ) xHeap.ulMaxFragmentation,
+					   ( unsigned ) xHeap.xMinimumEverFreeBytes);
+				printf("Heap: malloc us 0 <2 <4 <8 <16 <32 <64 >=64: %u %u %u %u %u %u %u %u\n",
+					   ( unsigned ) xHeap.ulMallocLatency[ 0 ], ( unsigned ) xHeap.ulMallocLatency[ 1 ],
+					   ( unsigned ) xHeap.ulMallocLatency[ 2 ], ( unsigned ) xHeap.ulMallocLatency[ 3 ],
+					   ( unsigned ) xHeap.ulMallocLatency[ 4 ], ( unsigned ) xHeap.ulMallocLatency[ 5 ],
+					   ( unsigned ) xHeap.ulMallocLatency[ 6 ], ( unsigned ) xHeap.ulMallocLatency[ 7 ]);
+				printf("Heap: free us   0 <2 <4 <8 <16 <32 <64 >=64: %u %u %u %u %u %u %u %u\n",
+					   ( unsigned ) xHeap.ulFreeLatency[ 0 ], ( unsigned ) xHeap.ulFreeLatency[ 1 ],
+					   ( unsigned ) xHeap.ulFreeLatency[ 2 ], ( unsigned ) xHeap.ulFreeLatency[ 3 ],
+					   ( unsigned ) xHeap.ulFreeLatency[ 4 ], ( unsigned ) xHeap.ulFreeLatency[ 5 ],
+					   ( unsigned ) xHeap.ulFreeLatency[ 6 ], ( unsigned ) xHeap.ulFreeLatency[ 7 ]);
+			}
+		}
+        #endif
+
+        #if (mainENABLE_BLOCK_POOL == 1)
+		if( xAreBlockPoolDemoTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 21UL;
+		}
+        #endif
+
+        #if (mainENABLE_BLOCK_POOL_BENCHMARK == 1)
+		if( xAreBlockPoolBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 22UL;
+		}
+		else
+		{
+			static uint32_t ulLastBlockPoolBenchmarkRun = 0;
+			BlockPoolBenchmarkResult_t xHeapAllocator, xPoolAllocator;
+			uint32_t ulRun;
+
+			if( ( xGetBlockPoolBenchmarkResults( &xHeapAllocator, &xPoolAllocator, &ulRun ) == pdPASS ) && ( ulRun != ulLastBlockPoolBenchmarkRun ) )
+			{
+				ulLastBlockPoolBenchmarkRun = ulRun;
+				printf("pvPortMalloc: %u ops/s, latency mean %u max %u us, %u failed\n",
+					   ( unsigned ) xHeapAllocator.ulOperationsPerSecond, ( unsigned ) xHeapAllocator.ulMeanLatency,
+					   ( unsigned ) xHeapAllocator.ulMaxLatency, ( unsigned ) xHeapAllocator.ulFailedAllocations);
+				printf("Block pool: %u ops/s, latency mean %u max %u us, %u failed\n",
+					   ( unsigned ) xPoolAllocator.ulOperationsPerSecond, ( unsigned ) xPoolAllocator.ulMeanLatency,
+					   ( unsigned ) xPoolAllocator.ulMaxLatency, ( unsigned ) xPoolAllocator.ulFailedAllocations);
+			}
+		}
+        #endif
+
+        #if (mainENABLE_DMA_COPY_BENCHMARK == 1)
+		if( xAreDMACopyBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 23UL;
+		}
+		else
+		{
+			static uint32_t ulLastDMACopyBenchmarkRun = 0;
+			DMACopyBenchmarkResult_t xCPUCopy, xDMACopy;
+			uint32_t ulRun;
+
+			if( ( xGetDMACopyBenchmarkResults( &xCPUCopy, &xDMACopy, &ulRun ) == pdPASS ) && ( ulRun != ulLastDMACopyBenchmarkRun ) )
+			{
+				ulLastDMACopyBenchmarkRun = ulRun;
+				printf("memcpy: %u bytes/s, %u us per copy, %u%% CPU available\n",
+					   ( unsigned ) xCPUCopy.ulBytesPerSecond, ( unsigned ) xCPUCopy.ulMeanCopyTime, ( unsigned ) xCPUCopy.ulCPUAvailable);
+				printf("pvDMAMemCpy: %u bytes/s, %u us per copy, %u%% CPU available\n",
+					   ( unsigned ) xDMACopy.ulBytesPerSecond, ( unsigned ) xDMACopy.ulMeanCopyTime, ( unsigned ) xDMACopy.ulCPUAvailable);
+			}
+		}
+        #endif
+
+        #if (mainENABLE_SPINLOCK_STATS == 1)
+		if( xAreSpinlockStatsTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 24UL;
+		}
+		else
+		{
+			SpinlockStats_t xLock;
+			uint32_t ulLockNum, ulSamples;
+
+			/* Only the test lock is taken through ulSpinlockStatsLock(), so
+			only it has acquisition counts.  The sample counts cover every lock,
+			including those used by the port and the SDK. */
+			for( ulLockNum = 0; ulLockNum < spinstatsNUM_LOCKS; ulLockNum++ )
+			{
+				ulSamples = ulSpinlockStatsGet( ulLockNum, &xLock );
+
+				if( ( xLock.ulAcquisitions != 0 ) || ( xLock.ulHeldSamples != 0 ) )
+				{
+					printf("Spin lock %2u%s: %u acquisitions, %u contended, %u spins (max %u), max hold %u us, held in %u of %u samples\n",
+						   ( unsigned ) ulLockNum, ( ulLockNum == ulSpinlockStatsTestLock() ) ? " (test)" : "",
+						   ( unsigned ) xLock.ulAcquisitions, ( unsigned ) xLock.ulContendedAcquisitions,
+						   ( unsigned ) xLock.ulSpinIterations, ( unsigned ) xLock.ulMaxSpinIterations,
+						   ( unsigned ) xLock.ulMaxHoldTime, ( unsigned ) xLock.ulHeldSamples, ( unsigned ) ulSamples);
+				}
+			}
+		}
+        #endif
+
+        #if (mainENABLE_TICK_LOAD_BENCHMARK == 1)
+		if( xAreTickLoadBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 25UL;
+		}
+		else
+		{
+			static uint32_t ulLastTickLoadBenchmarkRun = 0;
+			TickLoadBenchmarkResult_t xTickLoad;
+			uint32_t ulRun, ulCore;
+
+			if( ( xGetTickLoadBenchmarkResults( &xTickLoad, &ulRun ) == pdPASS ) && ( ulRun != ulLastTickLoadBenchmarkRun ) )
+			{
+				ulLastTickLoadBenchmarkRun = ulRun;
+
+				for( ulCore = 0; ulCore < tlbenchNUM_CORES; ulCore++ )
+				{
+					printf("Core %u%s: %u spare loops/s, wake latency %u us (max %u us), %u late\n",
+						   ( unsigned ) ulCore, ( ulCore == configTICK_CORE ) ? " (tick)" : "",
+						   ( unsigned ) xTickLoad.ulSpareLoopsPerSecond[ ulCore ], ( unsigned ) xTickLoad.ulMeanWakeLatency[ ulCore ],
+						   ( unsigned ) xTickLoad.ulMaxWakeLatency[ ulCore ], ( unsigned ) xTickLoad.ulLateWakeups[ ulCore ]);
+				}
+
+				printf("Core imbalance: %u%%\n", ( unsigned ) xTickLoad.ulImbalance);
+			}
+		}
+        #endif
+
+        #if (mainENABLE_LOG_RING_BENCHMARK == 1)
+		if( xAreLogRingBenchmarkTasksStillRunning() != pdPASS )
+		{
+			ulErrorFound |= 1UL << 26UL;
+		}
+		else
+		{
+			static uint32_t ulLastLogRingBenchmarkRun = 0;
+			LogRingBenchmarkResult_t xDirectLog, xRingLog;
+			uint32_t ulRun;
+
+			if( ( xGetLogRingBenchmarkResults( &xDirectLog, &xRingLog, &ulRun ) == pdPASS ) && ( ulRun != ulLastLogRingBenchmarkRun ) )
+			{
+				ulLastLogRingBenchmarkRun = ulRun;
+				printf("Log direct: %u msgs/s, %u us/msg\n",
+					   ( unsigned ) xDirectLog.ulMessagesPerSecond, ( unsigned ) xDirectLog.ulMeanCallTime);
+				printf("Log ring: %u msgs/s, %u us/msg, %u bytes dropped\n",
+					   ( unsigned ) xRingLog.ulMessagesPerSecond, ( unsigned ) xRingLog.ulMeanCallTime, ( unsigned ) xRingLog.ulBytesDropped);
+			}
+		}
+        #endif
+
+        #if (mainUSE_LOG_RING == 1) || (mainENABLE_LOG_RING_BENCHMARK == 1)
+		{
+			static uint32_t ulLastBytesDropped = 0;
+			LogRingStats_t xLogStats;
+
+			/* Report lost output once the rings have room again. */
+			vLogRingGetStats( &xLogStats );
+
+			if( xLogStats.ulBytesDropped != ulLastBytesDropped )
+			{
+				ulLastBytesDropped = xLogStats.ulBytesDropped;
+				printf("Log: %u bytes in %u msgs dropped, %u bytes sent in %u writes, ring high water %u\n",
+					   ( unsigned ) xLogStats.ulBytesDropped, ( unsigned ) xLogStats.ulMessagesDropped,
+					   ( unsigned ) xLogStats.ulBytesSent, ( unsigned ) xLogStats.ulPacketsSent,
+					   ( unsigned ) xLogStats.ulHighWaterMark);
+			}
+		}
+        #endif
+
 		/* Toggle the check LED to give an indication of the system status.  If
 		the LED toggles every mainNO_ERROR_CHECK_TASK_PERIOD milliseconds then
 		everything is ok.  A faster toggle indicates an error. */
-		gpio_xor_mask( 1u << mainCHECK_LED );
+		vParTestToggleLED( mainCHECK_LED );
 
 		ulIterations++;
 		if( ulErrorFound != pdFALSE )
@@ -434,11 +849,30 @@ unsigned long ulIterations = 0;
 			gone wrong (it might just be that the loop back connector required
 			by the comtest tasks has not been fitted). */
 			xDelayPeriod = mainERROR_CHECK_TASK_PERIOD;
+
+			#if (mainENABLE_GPIO_PATTERN == 1)
+			/* The step length is unchanged, so the new pattern starts when the
+			current one ends. */
+			xParTestSetLEDPattern( mainPATTERN_GPIO, mainPATTERN_ERROR, mainPATTERN_STEP_US );
+			#endif
 		}
 	}
 }
 /*-----------------------------------------------------------*/
 
+#if (mainUSE_LOG_RING == 1) || (mainENABLE_LOG_RING_BENCHMARK == 1)
+
+	static void prvWriteConsole( const char *pcData, size_t xLength )
+	{
+		/* The SDK's _write() passes the whole buffer to the stdio drivers in
+		one go, whereas printf() passes it in PICO_STDIO_STACK_BUFFER_SIZE
+		pieces. */
+		( void ) write( STDOUT_FILENO, pcData, xLength );
+	}
+
+#endif
+/*-----------------------------------------------------------*/
+
 static void prvRegTestTaskEntry1( void *pvParameters )
 {
 	/* Although the regtest task is written in assembler, its entry point is
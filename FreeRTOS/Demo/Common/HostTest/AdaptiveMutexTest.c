@@ -0,0 +1,630 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the adaptive mutex in Minimal/AdaptiveMutex.c, and a host run
+ * of the benchmark in Minimal/AdaptiveMutexBenchmark.c.
+ *
+ * The test includes AdaptiveMutex.c so it can set the holder recorded in a
+ * mutex directly.  The first tests run in one thread: the mutex is left held
+ * by a stand in task whose state the test sets, and hooks in the stub
+ * semaphore and eTaskGetState() functions play the holder giving the mutex, or
+ * blocking, at a chosen point in the taker's spin.  The counters kept by the
+ * stubs show which path the take followed.
+ *
+ * The last test starts the benchmark, with each task a host thread.  A task's
+ * state is eRunning unless it is in vTaskDelay() or waiting in a blocking
+ * semaphore take, which is what the spin looks at.  The benchmark checks
+ * mutual exclusion itself, and the test prints the results of its first runs
+ * for comparison.  The measurement period is in milliseconds of real time, so
+ * the run takes a few seconds.
+ */
+
+/* Standard includes. */
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The code under test. */
+#include "../Minimal/AdaptiveMutex.c"
+
+/* Demo program include files. */
+#include "AdaptiveMutexBenchmark.h"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define amtestSPIN_BUDGET			( 1000UL )
+#define amtestBENCHMARK_RUNS		( 2UL )
+#define amtestBENCHMARK_TIMEOUT_MS	( 20000UL )
+
+/* A task - the main thread, a stand in holder, or a benchmark task. */
+typedef struct HostTestTask
+{
+	pthread_t xThread;
+	TaskFunction_t pxTaskCode;
+	void *pvParameters;
+	volatile eTaskState eState;
+} HostTestTask_t;
+
+/* A semaphore, used for both the mutexes and the counting semaphores. */
+struct HostTestQueue
+{
+	pthread_mutex_t xLock;
+	pthread_cond_t xGiven;
+	UBaseType_t uxCount;
+	UBaseType_t uxMaxCount;
+};
+
+static HostTestTask_t xMainTask = { .eState = eRunning };
+static HostTestTask_t xHolderTask = { .eState = eRunning };
+static __thread HostTestTask_t *pxCurrentTask = NULL;
+static struct timespec xStartTime;
+
+/* Counted by the stubs, and reset by each test. */
+static volatile uint32_t ulPolls = 0, ulBlockingTakes = 0, ulStateChecks = 0;
+
+/* Called by the stubs when set, so a test can act as the holder.  Only set
+while a single thread is running. */
+static void ( *pxOnPoll )( void ) = NULL;
+static void ( *pxOnBlock )( void ) = NULL;
+static void ( *pxOnStateCheck )( void ) = NULL;
+
+/* What the hooks below do, and when. */
+static AdaptiveMutexHandle_t xHookMutex = NULL;
+static uint32_t ulActOnCount = 0;
+static eTaskState eNewHolderState = eRunning;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions AdaptiveMutex.c and
+AdaptiveMutexBenchmark.c use. */
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+	return malloc( xWantedSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+	free( pv );
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return ( TaskHandle_t ) pxCurrentTask;
+}
+/*-----------------------------------------------------------*/
+
+eTaskState eTaskGetState( TaskHandle_t xTask )
+{
+	__atomic_add_fetch( &ulStateChecks, 1, __ATOMIC_RELAXED );
+
+	if( pxOnStateCheck != NULL )
+	{
+		pxOnStateCheck();
+	}
+
+	return ( ( HostTestTask_t * ) xTask )->eState;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCount( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( TickType_t ) ( ( ( xNow.tv_sec - xStartTime.tv_sec ) * 1000L ) + ( ( xNow.tv_nsec - xStartTime.tv_nsec ) / 1000000L ) );
+}
+/*-----------------------------------------------------------*/
+
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+	pxCurrentTask->eState = eBlocked;
+	usleep( ( useconds_t ) xTicksToDelay * 1000U );
+	pxCurrentTask->eState = eRunning;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThread( void *pvParameters )
+{
+HostTestTask_t *pxTask = ( HostTestTask_t * ) pvParameters;
+
+	pxCurrentTask = pxTask;
+	pxTask->pxTaskCode( pxTask->pvParameters );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+HostTestTask_t *pxTask;
+
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) uxPriority;
+
+	/* The benchmark tasks never end, so the threads are detached and left
+	running when the test exits. */
+	pxTask = ( HostTestTask_t * ) calloc( 1, sizeof( HostTestTask_t ) );
+	configASSERT( pxTask );
+	pxTask->pxTaskCode = pxTaskCode;
+	pxTask->pvParameters = pvParameters;
+	pxTask->eState = eRunning;
+	configASSERT( pthread_create( &( pxTask->xThread ), NULL, prvTaskThread, pxTask ) == 0 );
+	pthread_detach( pxTask->xThread );
+
+	if( pxCreatedTask != NULL )
+	{
+		*pxCreatedTask = pxTask;
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+SemaphoreHandle_t xSemaphoreCreateCounting( UBaseType_t uxMaxCount, UBaseType_t uxInitialCount )
+{
+struct HostTestQueue *pxSemaphore;
+
+	pxSemaphore = ( struct HostTestQueue * ) malloc( sizeof( struct HostTestQueue ) );
+	configASSERT( pxSemaphore );
+	pthread_mutex_init( &( pxSemaphore->xLock ), NULL );
+	pthread_cond_init( &( pxSemaphore->xGiven ), NULL );
+	pxSemaphore->uxCount = uxInitialCount;
+	pxSemaphore->uxMaxCount = uxMaxCount;
+
+	return pxSemaphore;
+}
+/*-----------------------------------------------------------*/
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+	/* Priority inheritance plays no part in the test. */
+	return xSemaphoreCreateCounting( 1, 1 );
+}
+/*-----------------------------------------------------------*/
+
+void vSemaphoreDelete( SemaphoreHandle_t xSemaphore )
+{
+	pthread_cond_destroy( &( xSemaphore->xGiven ) );
+	pthread_mutex_destroy( &( xSemaphore->xLock ) );
+	free( xSemaphore );
+}
+/*-----------------------------------------------------------*/
+
+void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcQueueName )
+{
+	( void ) xQueue;
+	( void ) pcQueueName;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )
+{
+BaseType_t xReturn = pdFAIL;
+struct timespec xDeadline;
+int iResult = 0;
+
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xBlockTime == 0 )
+	{
+		__atomic_add_fetch( &ulPolls, 1, __ATOMIC_RELAXED );
+
+		if( pxOnPoll != NULL )
+		{
+			pxOnPoll();
+		}
+	}
+	else
+	{
+		__atomic_add_fetch( &ulBlockingTakes, 1, __ATOMIC_RELAXED );
+
+		if( ( pxOnBlock != NULL ) && ( xSemaphore->uxCount == 0 ) )
+		{
+			pxOnBlock();
+		}
+	}
+
+	clock_gettime( CLOCK_REALTIME, &xDeadline );
+	xDeadline.tv_sec += ( time_t ) ( xBlockTime / 1000UL );
+	xDeadline.tv_nsec += ( long ) ( xBlockTime % 1000UL ) * 1000000L;
+
+	if( xDeadline.tv_nsec >= 1000000000L )
+	{
+		xDeadline.tv_sec++;
+		xDeadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_mutex_lock( &( xSemaphore->xLock ) );
+	{
+		if( ( xSemaphore->uxCount == 0 ) && ( xBlockTime != 0 ) )
+		{
+			pxCurrentTask->eState = eBlocked;
+
+			while( ( xSemaphore->uxCount == 0 ) && ( iResult != ETIMEDOUT ) )
+			{
+				if( xBlockTime == portMAX_DELAY )
+				{
+					pthread_cond_wait( &( xSemaphore->xGiven ), &( xSemaphore->xLock ) );
+				}
+				else
+				{
+					iResult = pthread_cond_timedwait( &( xSemaphore->xGiven ), &( xSemaphore->xLock ), &xDeadline );
+				}
+			}
+
+			pxCurrentTask->eState = eRunning;
+		}
+
+		if( xSemaphore->uxCount > 0 )
+		{
+			xSemaphore->uxCount--;
+			xReturn = pdPASS;
+		}
+	}
+	pthread_mutex_unlock( &( xSemaphore->xLock ) );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t xSemaphore )
+{
+BaseType_t xReturn = pdFAIL;
+
+	pthread_mutex_lock( &( xSemaphore->xLock ) );
+	{
+		if( xSemaphore->uxCount < xSemaphore->uxMaxCount )
+		{
+			xSemaphore->uxCount++;
+			pthread_cond_signal( &( xSemaphore->xGiven ) );
+			xReturn = pdPASS;
+		}
+	}
+	pthread_mutex_unlock( &( xSemaphore->xLock ) );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/* Leave the mutex held by the stand in holder task, in the given state, and
+start counting afresh. */
+static AdaptiveMutexHandle_t prvCreateHeldMutex( uint32_t ulSpinBudget, eTaskState eHolderState )
+{
+AdaptiveMutexHandle_t xMutex;
+
+	xMutex = xAdaptiveMutexCreate( ulSpinBudget );
+	configASSERT( xMutex );
+	configASSERT( xAdaptiveMutexTake( xMutex, 0 ) == pdPASS );
+	xMutex->xHolder = &xHolderTask;
+	xHolderTask.eState = eHolderState;
+
+	xHookMutex = xMutex;
+	ulPolls = 0;
+	ulBlockingTakes = 0;
+	ulStateChecks = 0;
+	pxOnPoll = NULL;
+	pxOnBlock = NULL;
+	pxOnStateCheck = NULL;
+
+	return xMutex;
+}
+/*-----------------------------------------------------------*/
+
+/* The holder gives the mutex, as xAdaptiveMutexGive() would. */
+static void prvHolderGives( void )
+{
+	configASSERT( ( xHookMutex->xHolder == &xHolderTask ) || ( xHookMutex->xHolder == NULL ) );
+	xHookMutex->xHolder = NULL;
+	configASSERT( xSemaphoreGive( xHookMutex->xMutex ) == pdPASS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveOnStateCheck( void )
+{
+	if( ulStateChecks == ulActOnCount )
+	{
+		prvHolderGives();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveOnPoll( void )
+{
+	if( ulPolls == ulActOnCount )
+	{
+		prvHolderGives();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvChangeStateOnStateCheck( void )
+{
+	if( ulStateChecks == ulActOnCount )
+	{
+		xHolderTask.eState = eNewHolderState;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckStats( AdaptiveMutexHandle_t xMutex, uint32_t ulExpectedSpins, uint32_t ulExpectedBlocks )
+{
+uint32_t ulSpins, ulBlocks;
+
+	vAdaptiveMutexGetStats( xMutex, &ulSpins, &ulBlocks );
+	hosttestCHECK( ulSpins == ulExpectedSpins );
+	hosttestCHECK( ulBlocks == ulExpectedBlocks );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestFastTakeAndGive( void )
+{
+AdaptiveMutexHandle_t xMutex;
+
+	/* A free mutex is taken by the first poll, whatever the block time, and
+	neither counter changes. */
+	xMutex = prvCreateHeldMutex( amtestSPIN_BUDGET, eRunning );
+	prvHolderGives();
+	ulPolls = 0;
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, 0 ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == &xMainTask );
+	hosttestCHECK( xMutex->xMutex->uxCount == 0 );
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == NULL );
+	hosttestCHECK( xMutex->xMutex->uxCount == 1 );
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == &xMainTask );
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+
+	hosttestCHECK( ulPolls == 2 );
+	hosttestCHECK( ulBlockingTakes == 0 );
+	hosttestCHECK( ulStateChecks == 0 );
+	prvCheckStats( xMutex, 0, 0 );
+	vAdaptiveMutexDelete( xMutex );
+
+	/* Without a block time a held mutex is not waited for at all, even if
+	its holder is running. */
+	xMutex = prvCreateHeldMutex( amtestSPIN_BUDGET, eRunning );
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, 0 ) == pdFAIL );
+	hosttestCHECK( xMutex->xHolder == &xHolderTask );
+	hosttestCHECK( ulPolls == 1 );
+	hosttestCHECK( ulBlockingTakes == 0 );
+	hosttestCHECK( ulStateChecks == 0 );
+	prvCheckStats( xMutex, 0, 0 );
+
+	prvHolderGives();
+	vAdaptiveMutexDelete( xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSpinAcquisition( void )
+{
+AdaptiveMutexHandle_t xMutex;
+
+	/* The holder keeps running and gives the mutex while it is checked for
+	the third time, which is on the 33rd spin.  The next spin sees the holder
+	cleared and takes the mutex without blocking. */
+	xMutex = prvCreateHeldMutex( amtestSPIN_BUDGET, eRunning );
+	ulActOnCount = 3;
+	pxOnStateCheck = prvGiveOnStateCheck;
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == &xMainTask );
+	hosttestCHECK( ulStateChecks == 3 );
+	hosttestCHECK( ulPolls == 2 );
+	hosttestCHECK( ulBlockingTakes == 0 );
+	prvCheckStats( xMutex, 1, 0 );
+
+	pxOnStateCheck = NULL;
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+	vAdaptiveMutexDelete( xMutex );
+
+	/* The holder is cleared just before the mutex is given, so the spinning
+	task polls until the give happens, without checking the holder's state. */
+	xMutex = prvCreateHeldMutex( amtestSPIN_BUDGET, eRunning );
+	xMutex->xHolder = NULL;
+	ulActOnCount = 4;
+	pxOnPoll = prvGiveOnPoll;
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == &xMainTask );
+	hosttestCHECK( ulPolls == 4 );
+	hosttestCHECK( ulStateChecks == 0 );
+	hosttestCHECK( ulBlockingTakes == 0 );
+	prvCheckStats( xMutex, 1, 0 );
+
+	pxOnPoll = NULL;
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+	vAdaptiveMutexDelete( xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSpinEndsWhenHolderStopsRunning( void )
+{
+const eTaskState eStates[] = { eReady, eBlocked, eSuspended };
+AdaptiveMutexHandle_t xMutex;
+size_t x;
+
+	for( x = 0; x < ( sizeof( eStates ) / sizeof( eStates[ 0 ] ) ); x++ )
+	{
+		/* A holder that is not running when the spin starts is checked once,
+		then the task blocks.  The holder gives the mutex while the task is
+		blocked. */
+		xMutex = prvCreateHeldMutex( amtestSPIN_BUDGET, eStates[ x ] );
+		pxOnBlock = prvHolderGives;
+
+		hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+		hosttestCHECK( xMutex->xHolder == &xMainTask );
+		hosttestCHECK( ulStateChecks == 1 );
+		hosttestCHECK( ulPolls == 1 );
+		hosttestCHECK( ulBlockingTakes == 1 );
+		prvCheckStats( xMutex, 0, 1 );
+
+		pxOnBlock = NULL;
+		hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+
+		/* A holder that stops running part way through the spin is seen at
+		the next check, long before the budget is used. */
+		xHookMutex = xMutex;
+		hosttestCHECK( xAdaptiveMutexTake( xMutex, 0 ) == pdPASS );
+		xMutex->xHolder = &xHolderTask;
+		xHolderTask.eState = eRunning;
+		ulPolls = 0;
+		ulBlockingTakes = 0;
+		ulStateChecks = 0;
+		ulActOnCount = 2;
+		eNewHolderState = eStates[ x ];
+		pxOnStateCheck = prvChangeStateOnStateCheck;
+		pxOnBlock = prvHolderGives;
+
+		hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+		hosttestCHECK( xMutex->xHolder == &xMainTask );
+		hosttestCHECK( ulStateChecks == 2 );
+		hosttestCHECK( ulPolls == 1 );
+		hosttestCHECK( ulBlockingTakes == 1 );
+		prvCheckStats( xMutex, 0, 2 );
+
+		pxOnStateCheck = NULL;
+		pxOnBlock = NULL;
+		hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+		vAdaptiveMutexDelete( xMutex );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSpinBudget( void )
+{
+AdaptiveMutexHandle_t xMutex;
+
+	/* The holder runs for longer than the budget of 40 spins, which checks
+	its state on spins 0, 16 and 32, then the task blocks.  Nothing is given
+	while it is blocked, so the take times out and neither counter changes. */
+	xMutex = prvCreateHeldMutex( 40, eRunning );
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, 5 ) == pdFAIL );
+	hosttestCHECK( xMutex->xHolder == &xHolderTask );
+	hosttestCHECK( ulStateChecks == 3 );
+	hosttestCHECK( ulPolls == 1 );
+	hosttestCHECK( ulBlockingTakes == 1 );
+	prvCheckStats( xMutex, 0, 0 );
+
+	/* This time the mutex is given while the task is blocked. */
+	ulStateChecks = 0;
+	ulPolls = 0;
+	ulBlockingTakes = 0;
+	pxOnBlock = prvHolderGives;
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, 5 ) == pdPASS );
+	hosttestCHECK( xMutex->xHolder == &xMainTask );
+	hosttestCHECK( ulStateChecks == 3 );
+	hosttestCHECK( ulBlockingTakes == 1 );
+	prvCheckStats( xMutex, 0, 1 );
+
+	pxOnBlock = NULL;
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+	vAdaptiveMutexDelete( xMutex );
+
+	/* With no budget the mutex behaves as a standard mutex. */
+	xMutex = prvCreateHeldMutex( 0, eRunning );
+	pxOnBlock = prvHolderGives;
+
+	hosttestCHECK( xAdaptiveMutexTake( xMutex, portMAX_DELAY ) == pdPASS );
+	hosttestCHECK( ulStateChecks == 0 );
+	hosttestCHECK( ulPolls == 1 );
+	hosttestCHECK( ulBlockingTakes == 1 );
+	prvCheckStats( xMutex, 0, 1 );
+
+	pxOnBlock = NULL;
+	hosttestCHECK( xAdaptiveMutexGive( xMutex ) == pdPASS );
+	vAdaptiveMutexDelete( xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestBenchmark( void )
+{
+AdaptiveMutexBenchmarkResult_t xStandard, xAdaptive;
+uint32_t ulRuns = 0, ulWaited = 0;
+
+	/* The hooks are only for the single thread tests. */
+	pxOnPoll = NULL;
+	pxOnBlock = NULL;
+	pxOnStateCheck = NULL;
+
+	vStartAdaptiveMutexBenchmarkTasks( tskIDLE_PRIORITY + 1 );
+
+	while( ( ulRuns < amtestBENCHMARK_RUNS ) && ( ulWaited < amtestBENCHMARK_TIMEOUT_MS ) )
+	{
+		usleep( 100000 );
+		ulWaited += 100UL;
+		xGetAdaptiveMutexBenchmarkResults( &xStandard, &xAdaptive, &ulRuns );
+	}
+
+	hosttestCHECK( ulRuns >= amtestBENCHMARK_RUNS );
+	hosttestCHECK( xAreAdaptiveMutexBenchmarkTasksStillRunning() == pdPASS );
+	hosttestCHECK( xStandard.ulAcquisitionsPerSecond > 0 );
+	hosttestCHECK( xAdaptive.ulAcquisitionsPerSecond > 0 );
+
+	/* Only the adaptive mutex has spin and block counts. */
+	hosttestCHECK( xStandard.ulSpinAcquisitions == 0 );
+	hosttestCHECK( xStandard.ulBlockedAcquisitions == 0 );
+
+	printf( "Standard mutex: %lu takes/s, %lu handoffs, mean latency %lu, max latency %lu\n",
+		( unsigned long ) xStandard.ulAcquisitionsPerSecond, ( unsigned long ) xStandard.ulHandoffs,
+		( unsigned long ) xStandard.ulMeanHandoffLatency, ( unsigned long ) xStandard.ulMaxHandoffLatency );
+	printf( "Adaptive mutex: %lu takes/s, %lu handoffs, mean latency %lu, max latency %lu, %lu spun, %lu blocked\n",
+		( unsigned long ) xAdaptive.ulAcquisitionsPerSecond, ( unsigned long ) xAdaptive.ulHandoffs,
+		( unsigned long ) xAdaptive.ulMeanHandoffLatency, ( unsigned long ) xAdaptive.ulMaxHandoffLatency,
+		( unsigned long ) xAdaptive.ulSpinAcquisitions, ( unsigned long ) xAdaptive.ulBlockedAcquisitions );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+	pxCurrentTask = &xMainTask;
+
+	prvTestFastTakeAndGive();
+	prvTestSpinAcquisition();
+	prvTestSpinEndsWhenHolderStopsRunning();
+	prvTestSpinBudget();
+	prvTestBenchmark();
+
+	return iHostTestResult( "AdaptiveMutexTest" );
+}
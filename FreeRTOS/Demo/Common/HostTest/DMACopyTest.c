@@ -0,0 +1,229 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the DMA copy service in Minimal/DMACopy.c, built with the
+ * host port layer in Minimal/DMACopyHostPort.c.
+ *
+ * Each test task is a host thread with a semaphore standing in for its task
+ * notification.  Another thread plays the tick interrupt, calling
+ * vDMACopyHostPortTickHook() as the tick hook would.  The tasks make copies
+ * and sets of random lengths and alignments at the same time, so they contend
+ * for the port's channels, and each checks its destination buffer - including
+ * the bytes either side of the transfer, which must not be touched.
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "DMACopy.h"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define dmatestTASKS			( 4 )
+#define dmatestTRANSFERS		( 3000 )
+#define dmatestMAX_LENGTH		( 20000 )
+#define dmatestMAX_OFFSET		( 128 )
+#define dmatestGUARD_VALUE		( 0xEE )
+
+/* The task notification of one test task. */
+typedef struct DMATestTask
+{
+	sem_t xNotification;
+} DMATestTask_t;
+
+static __thread DMATestTask_t *pxCurrentTask = NULL;
+static volatile int iStopTicks = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions DMACopy.c uses. */
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return ( TaskHandle_t ) pxCurrentTask;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+	return taskSCHEDULER_RUNNING;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+uint32_t ulReturn = 0;
+
+	( void ) uxIndexToWaitOn;
+	configASSERT( xClearCountOnExit == pdTRUE );
+
+	/* Nothing may block inside a critical section. */
+	hosttestCHECK( ( xTicksToWait == 0 ) || ( uxHostTestCriticalNesting == 0 ) );
+
+	if( xTicksToWait != 0 )
+	{
+		sem_wait( &( pxCurrentTask->xNotification ) );
+		ulReturn++;
+	}
+
+	while( sem_trywait( &( pxCurrentTask->xNotification ) ) == 0 )
+	{
+		ulReturn++;
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	( void ) uxIndexToNotify;
+
+	sem_post( &( ( ( DMATestTask_t * ) xTaskToNotify )->xNotification ) );
+	*pxHigherPriorityTaskWoken = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTickInterrupt( void *pvParameters )
+{
+	while( iStopTicks == 0 )
+	{
+		usleep( 100 );
+		vDMACopyHostPortTickHook();
+	}
+
+	return pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTestTask( void *pvParameters )
+{
+static __thread uint8_t ucSource[ dmatestMAX_LENGTH ], ucDestination[ dmatestMAX_LENGTH + dmatestMAX_OFFSET ];
+DMATestTask_t xTask;
+uint32_t ulSeed = ( uint32_t ) ( uintptr_t ) pvParameters, ulTransfer;
+size_t xLength, xOffset, x;
+uint8_t ucValue;
+int iMismatches = 0;
+
+	sem_init( &( xTask.xNotification ), 0, 0 );
+	pxCurrentTask = &xTask;
+
+	for( ulTransfer = 0; ulTransfer < dmatestTRANSFERS; ulTransfer++ )
+	{
+		ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+		xLength = ulSeed % dmatestMAX_LENGTH;
+		xOffset = ( ulSeed >> 16 ) % dmatestMAX_OFFSET;
+		ucValue = ( uint8_t ) ulTransfer;
+
+		memset( ucDestination, dmatestGUARD_VALUE, sizeof( ucDestination ) );
+
+		if( ( ulSeed & 0x100UL ) != 0 )
+		{
+			for( x = 0; x < xLength; x++ )
+			{
+				ucSource[ x ] = ( uint8_t ) ( ( x * 7 ) + ulTransfer );
+			}
+
+			hosttestCHECK( pvDMAMemCpy( ucDestination + xOffset, ucSource, xLength ) == ( ucDestination + xOffset ) );
+			iMismatches += ( memcmp( ucDestination + xOffset, ucSource, xLength ) != 0 );
+		}
+		else
+		{
+			hosttestCHECK( pvDMAMemSet( ucDestination + xOffset, ucValue, xLength ) == ( ucDestination + xOffset ) );
+
+			for( x = 0; x < xLength; x++ )
+			{
+				iMismatches += ( ucDestination[ xOffset + x ] != ucValue );
+			}
+		}
+
+		/* Nothing either side of the transfer was written. */
+		for( x = 0; x < xOffset; x++ )
+		{
+			iMismatches += ( ucDestination[ x ] != dmatestGUARD_VALUE );
+		}
+
+		for( x = xOffset + xLength; x < sizeof( ucDestination ); x++ )
+		{
+			iMismatches += ( ucDestination[ x ] != dmatestGUARD_VALUE );
+		}
+	}
+
+	hosttestCHECK( iMismatches == 0 );
+	sem_destroy( &( xTask.xNotification ) );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+pthread_t xTick, xTasks[ dmatestTASKS ];
+DMACopyStats_t xStats;
+uintptr_t x;
+
+	vDMACopyInit();
+
+	pthread_create( &xTick, NULL, prvTickInterrupt, NULL );
+
+	for( x = 0; x < dmatestTASKS; x++ )
+	{
+		pthread_create( &( xTasks[ x ] ), NULL, prvTestTask, ( void * ) ( x + 1 ) );
+	}
+
+	for( x = 0; x < dmatestTASKS; x++ )
+	{
+		pthread_join( xTasks[ x ], NULL );
+	}
+
+	iStopTicks = 1;
+	pthread_join( xTick, NULL );
+
+	/* Every transfer was accounted for, and some were made by each route. */
+	vDMACopyGetStats( &xStats );
+	hosttestCHECK( ( xStats.ulCPUTransfers + xStats.ulDMATransfers + xStats.ulChannelBusyTransfers ) == ( dmatestTASKS * dmatestTRANSFERS ) );
+	hosttestCHECK( xStats.ulCPUTransfers > 0 );
+	hosttestCHECK( xStats.ulDMATransfers > 0 );
+	hosttestCHECK( xStats.ulFailedTransfers == 0 );
+
+	printf( "CPU %u, DMA %u, channel busy %u\n", ( unsigned ) xStats.ulCPUTransfers, ( unsigned ) xStats.ulDMATransfers, ( unsigned ) xStats.ulChannelBusyTransfers );
+
+	return iHostTestResult( "DMACopyTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,225 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the TLSF heap in MemMang/heap_tlsf.c.
+ *
+ * The test plays the part of two cores by changing the value returned by
+ * portGET_CORE_ID(), so blocks are cached by the core that frees them just as
+ * they are on a target.  It checks the heap never hands out the same memory
+ * twice, and that the heap statistics count cached blocks as free blocks, so
+ * that once the caches have been flushed the statistics describe the TLSF
+ * lists alone.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#include "../MemMang/heap_tlsf.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define tlsftestSLOTS		( 2000 )
+
+static uint8_t *pucSlots[ tlsftestSLOTS ];
+static size_t xSlotSizes[ tlsftestSLOTS ];
+
+/*-----------------------------------------------------------*/
+
+static void prvFlushAllCaches( void )
+{
+UBaseType_t uxCore;
+
+	for( uxCore = 0; uxCore < heapNUM_CORES; uxCore++ )
+	{
+		uxHostTestCoreID = uxCore;
+		vPortFlushHeapCache();
+	}
+
+	uxHostTestCoreID = 0;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvCachedBlocks( void )
+{
+size_t xBlocks = 0, xClass;
+UBaseType_t uxCore;
+
+	for( uxCore = 0; uxCore < heapNUM_CORES; uxCore++ )
+	{
+		for( xClass = 0; xClass < heapCACHE_CLASSES; xClass++ )
+		{
+			xBlocks += xCoreCaches[ uxCore ].ucCount[ xClass ];
+		}
+	}
+
+	return xBlocks;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandomUse( void )
+{
+uint32_t ulSeed = 1, ulIteration, ulSlot;
+size_t xInitialFree, xSize, x;
+HeapStats_t xStats;
+
+	prvFlushAllCaches();
+	xInitialFree = xPortGetFreeHeapSize();
+
+	for( ulIteration = 0; ulIteration < 1000000UL; ulIteration++ )
+	{
+		ulSlot = ( uint32_t ) rand_r( &ulSeed ) % tlsftestSLOTS;
+
+		/* Blocks are freed on either core, which need not be the core that
+		allocated them. */
+		uxHostTestCoreID = ( UBaseType_t ) ( rand_r( &ulSeed ) % heapNUM_CORES );
+
+		if( pucSlots[ ulSlot ] != NULL )
+		{
+			for( x = 0; x < xSlotSizes[ ulSlot ]; x++ )
+			{
+				if( pucSlots[ ulSlot ][ x ] != ( uint8_t ) ulSlot )
+				{
+					break;
+				}
+			}
+
+			hosttestCHECK( x == xSlotSizes[ ulSlot ] );
+			vPortFree( pucSlots[ ulSlot ] );
+			pucSlots[ ulSlot ] = NULL;
+		}
+		else
+		{
+			/* Mostly small requests, which can be served from the caches. */
+			xSize = ( rand_r( &ulSeed ) % 4 == 0 ) ? ( size_t ) ( rand_r( &ulSeed ) % 3000 + 1 ) : ( size_t ) ( rand_r( &ulSeed ) % 80 + 1 );
+			pucSlots[ ulSlot ] = pvPortMalloc( xSize );
+
+			if( pucSlots[ ulSlot ] != NULL )
+			{
+				xSlotSizes[ ulSlot ] = xSize;
+				memset( pucSlots[ ulSlot ], ( int ) ( uint8_t ) ulSlot, xSize );
+			}
+		}
+	}
+
+	for( ulSlot = 0; ulSlot < tlsftestSLOTS; ulSlot++ )
+	{
+		vPortFree( pucSlots[ ulSlot ] );
+		pucSlots[ ulSlot ] = NULL;
+	}
+
+	/* Everything has been freed, some of it into the caches, which count as
+	free memory. */
+	uxHostTestCoreID = 0;
+	hosttestCHECK( xPortGetFreeHeapSize() == xInitialFree );
+	vPortGetHeapStats( &xStats );
+	hosttestCHECK( xStats.xAvailableHeapSpaceInBytes == xInitialFree );
+	hosttestCHECK( xStats.xNumberOfSuccessfulAllocations == xStats.xNumberOfSuccessfulFrees );
+
+	/* Once the caches are flushed everything merges back into one block. */
+	prvFlushAllCaches();
+	vPortGetHeapStats( &xStats );
+	hosttestCHECK( xStats.xNumberOfFreeBlocks == 1 );
+	hosttestCHECK( xStats.xSizeOfLargestFreeBlockInBytes == xInitialFree );
+	hosttestCHECK( xStats.xAvailableHeapSpaceInBytes == xInitialFree );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestCachedBlocksAreFree( void )
+{
+uint8_t *pucSmall[ heaptlsfCACHE_DEPTH ], *pucLarge;
+size_t xInitialFree, xSmallBlockSize, xLargeBlockSize, xCachedBlocks, x;
+HeapStats_t xStats;
+
+	/* The first allocation initialises the heap.  This test runs first, so
+	the minimum ever free size has only been reduced by this allocation. */
+	vPortFree( pvPortMalloc( 1 ) );
+	prvFlushAllCaches();
+	xInitialFree = xPortGetFreeHeapSize();
+
+	/* Fill the cache for one size of block on core 1. */
+	uxHostTestCoreID = 1;
+
+	for( x = 0; x < heaptlsfCACHE_DEPTH; x++ )
+	{
+		pucSmall[ x ] = pvPortMalloc( 20 );
+		configASSERT( pucSmall[ x ] );
+	}
+
+	xSmallBlockSize = heapBLOCK_SIZE( ( TLSFBlock_t * ) ( pucSmall[ 0 ] - heapHEADER_SIZE ) );
+
+	for( x = 0; x < heaptlsfCACHE_DEPTH; x++ )
+	{
+		vPortFree( pucSmall[ x ] );
+	}
+
+	xCachedBlocks = prvCachedBlocks();
+	hosttestCHECK( xCachedBlocks == heaptlsfCACHE_DEPTH );
+
+	/* The cached blocks are reported as free blocks of their own size. */
+	uxHostTestCoreID = 0;
+	vPortGetHeapStats( &xStats );
+	hosttestCHECK( xStats.xAvailableHeapSpaceInBytes == xInitialFree );
+	hosttestCHECK( xStats.xNumberOfFreeBlocks == ( 1 + xCachedBlocks ) );
+	hosttestCHECK( xStats.xSizeOfSmallestFreeBlockInBytes == xSmallBlockSize );
+
+	/* An allocation from the TLSF lists while blocks are cached does not
+	count the cached blocks as used in the minimum ever free size. */
+	pucLarge = pvPortMalloc( 4096 );
+	configASSERT( pucLarge );
+	xLargeBlockSize = heapBLOCK_SIZE( ( TLSFBlock_t * ) ( pucLarge - heapHEADER_SIZE ) );
+	configASSERT( xLargeBlockSize > ( xCachedBlocks * xSmallBlockSize ) );
+	hosttestCHECK( xPortGetMinimumEverFreeHeapSize() == ( xInitialFree - xLargeBlockSize ) );
+	vPortFree( pucLarge );
+
+	/* Flushing core 0's cache leaves core 1's blocks where they are... */
+	vPortFlushHeapCache();
+	hosttestCHECK( prvCachedBlocks() == xCachedBlocks );
+
+	/* ...and flushing core 1's cache merges them back. */
+	uxHostTestCoreID = 1;
+	vPortFlushHeapCache();
+	uxHostTestCoreID = 0;
+	vPortGetHeapStats( &xStats );
+	hosttestCHECK( prvCachedBlocks() == 0 );
+	hosttestCHECK( xStats.xNumberOfFreeBlocks == 1 );
+	hosttestCHECK( xStats.xSizeOfLargestFreeBlockInBytes == xInitialFree );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	prvTestCachedBlocksAreFree();
+	prvTestRandomUse();
+
+	return iHostTestResult( "HeapTLSFTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,159 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Support shared by the host tests in this directory - see HostTest.h.
+ */
+
+/* PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP is a GNU extension. */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+
+/* Test includes. */
+#include "HostTest.h"
+
+__thread UBaseType_t uxHostTestCriticalNesting = 0;
+volatile UBaseType_t uxHostTestSchedulerSuspended = 0;
+volatile UBaseType_t uxHostTestCoreID = 0;
+
+static pthread_mutex_t xCriticalMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+/* Checks may be made from more than one thread. */
+static volatile unsigned long ulChecks = 0, ulFailures = 0;
+
+/*-----------------------------------------------------------*/
+
+void vHostTestAssertCalled( const char *pcFile, int iLine )
+{
+	/* The code under test cannot carry on past a failed assertion. */
+	printf( "configASSERT() failed at %s:%d\n", pcFile, iLine );
+	fflush( stdout );
+	abort();
+}
+/*-----------------------------------------------------------*/
+
+void vHostTestCheck( int iPassed, const char *pcCheck, const char *pcFile, int iLine )
+{
+	__atomic_add_fetch( &ulChecks, 1, __ATOMIC_RELAXED );
+
+	if( iPassed == 0 )
+	{
+		__atomic_add_fetch( &ulFailures, 1, __ATOMIC_RELAXED );
+
+		/* Only the first failures are printed, as a failure inside a loop
+		would otherwise fill the log. */
+		if( ulFailures <= 20UL )
+		{
+			printf( "%s:%d: check failed: %s\n", pcFile, iLine, pcCheck );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+int iHostTestResult( const char *pcTestName )
+{
+	if( uxHostTestCriticalNesting != 0 )
+	{
+		printf( "%s: critical section left open\n", pcTestName );
+		ulFailures++;
+	}
+
+	if( uxHostTestSchedulerSuspended != 0 )
+	{
+		printf( "%s: scheduler left suspended\n", pcTestName );
+		ulFailures++;
+	}
+
+	printf( "%s: %lu checks, %lu failed\n", pcTestName, ulChecks, ulFailures );
+
+	return ( ulFailures == 0UL ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskEnterCritical( void )
+{
+	pthread_mutex_lock( &xCriticalMutex );
+	uxHostTestCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskExitCritical( void )
+{
+	configASSERT( uxHostTestCriticalNesting > 0 );
+	uxHostTestCriticalNesting--;
+	pthread_mutex_unlock( &xCriticalMutex );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskEnterCriticalFromISR( void )
+{
+	vTaskEnterCritical();
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus )
+{
+	( void ) uxSavedInterruptStatus;
+	vTaskExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t ulPortSetInterruptMask( void )
+{
+	vTaskEnterCritical();
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t ulMask )
+{
+	( void ) ulMask;
+	vTaskExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSuspendAll( void )
+{
+	uxHostTestSchedulerSuspended++;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskResumeAll( void )
+{
+	configASSERT( uxHostTestSchedulerSuspended > 0 );
+	uxHostTestSchedulerSuspended--;
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,56 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/*
+ * Support shared by the host tests in this directory.  Each test is a plain
+ * program that includes the source file it tests, so it can reach the file's
+ * private functions and data, defines the kernel functions that file calls,
+ * and returns non zero if any check failed.
+ */
+
+#include <stdio.h>
+
+/* Record a failed check, but carry on so one run reports every failure. */
+#define hosttestCHECK( x )	vHostTestCheck( ( x ) != 0, #x, __FILE__, __LINE__ )
+
+void vHostTestCheck( int iPassed, const char *pcCheck, const char *pcFile, int iLine );
+
+/* The nesting depth of the stub critical sections and interrupt masks in the
+calling thread, and of scheduler suspension.  Critical sections and interrupt
+masks share one recursive mutex, so tests can use threads to play the part of
+tasks, other cores or interrupts. */
+extern __thread UBaseType_t uxHostTestCriticalNesting;
+extern volatile UBaseType_t uxHostTestSchedulerSuspended;
+
+/* Print a summary line for the named test and return the program's exit
+code. */
+int iHostTestResult( const char *pcTestName );
+
+#endif /* HOST_TEST_H */
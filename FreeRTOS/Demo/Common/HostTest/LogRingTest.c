@@ -0,0 +1,450 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the log ring in Minimal/LogRing.c.
+ *
+ * The test includes LogRing.c, with small rings and packets so they wrap and
+ * fill quickly, and plays the part of the writers on each core - by setting
+ * uxHostTestCoreID - and of the drain task, by calling xLogRingDrain() with an
+ * output function that records each packet.  Interrupt masking is provided by
+ * HostTest.c, which counts it, so the test can check a write leaves it
+ * balanced.
+ *
+ * prvTestRandom() compares the output with a model of the rings over a long
+ * run of random writes and drains on both cores.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#define logringRING_SIZE			256
+#define logringPACKET_SIZE			64
+#define logringMAX_MESSAGE_LENGTH	32
+#include "../Minimal/LogRing.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define ringtestOUTPUT_SIZE			( 64 * 1024 )
+#define ringtestMAX_PACKETS			( 1024 )
+#define ringtestRANDOM_STEPS		( 200000 )
+
+/*-----------------------------------------------------------*/
+
+/* Everything passed to the output function since the last reset, and the size
+of each packet. */
+static char cOutput[ ringtestOUTPUT_SIZE ];
+static size_t xOutputLength = 0;
+static size_t xPacketLengths[ ringtestMAX_PACKETS ];
+static size_t xPackets = 0;
+
+/* The drain task, and its notifications. */
+static uint8_t ucDrainTaskStandIn;
+static uint32_t ulDrainNotifications = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+	( void ) uxPriority;
+
+	hosttestCHECK( pxTaskCode == prvLogRingTask );
+	*pxCreatedTask = ( TaskHandle_t ) &ucDrainTaskStandIn;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+	hosttestCHECK( xTaskToNotify == ( TaskHandle_t ) &ucDrainTaskStandIn );
+	hosttestCHECK( uxIndexToNotify == 0 );
+	ulDrainNotifications++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+	/* Only called by the drain task, which the test does not run. */
+	( void ) uxIndexToWaitOn;
+	( void ) xClearCountOnExit;
+	( void ) xTicksToWait;
+	hosttestCHECK( pdFALSE );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvOutput( const char *pcData, size_t xLength )
+{
+	/* Packets are never empty, never too big, and are only output from
+	outside any critical section or interrupt mask. */
+	hosttestCHECK( ( xLength > 0 ) && ( xLength <= logringPACKET_SIZE ) );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( ( xOutputLength + xLength ) <= ringtestOUTPUT_SIZE )
+	{
+		memcpy( &( cOutput[ xOutputLength ] ), pcData, xLength );
+		xOutputLength += xLength;
+	}
+	else
+	{
+		hosttestCHECK( pdFALSE );
+	}
+
+	if( xPackets < ringtestMAX_PACKETS )
+	{
+		xPacketLengths[ xPackets ] = xLength;
+	}
+
+	xPackets++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReset( void )
+{
+	memset( xRings, 0x00, sizeof( xRings ) );
+	ulBytesSent = 0;
+	ulPacketsSent = 0;
+	xOutputLength = 0;
+	xPackets = 0;
+	uxHostTestCoreID = 0;
+}
+/*-----------------------------------------------------------*/
+
+/* Write a message of xLength copies of cFill. */
+static size_t prvWriteFill( char cFill, size_t xLength )
+{
+char cMessage[ logringRING_SIZE + 1 ];
+size_t xWritten;
+
+	memset( cMessage, cFill, xLength );
+	xWritten = xLogRingWrite( cMessage, xLength );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	return xWritten;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvOutputIs( char cFill, size_t xOffset, size_t xLength )
+{
+size_t x;
+BaseType_t xReturn = pdTRUE;
+
+	for( x = xOffset; x < ( xOffset + xLength ); x++ )
+	{
+		if( cOutput[ x ] != cFill )
+		{
+			xReturn = pdFALSE;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestWrapAround( void )
+{
+static const char cMessage[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+const size_t xLength = sizeof( cMessage ) - 1;
+size_t xRound;
+
+	prvReset();
+
+	/* Enough rounds for the message to start at every alignment relative to
+	the end of the ring, so many of them are split around the end. */
+	for( xRound = 0; xRound < logringRING_SIZE; xRound++ )
+	{
+		hosttestCHECK( xLogRingWrite( cMessage, xLength ) == xLength );
+		hosttestCHECK( ( xRings[ 0 ].ulHead - xRings[ 0 ].ulTail ) == xLength );
+
+		xOutputLength = 0;
+		hosttestCHECK( xLogRingDrain( prvOutput ) == xLength );
+		hosttestCHECK( xOutputLength == xLength );
+		hosttestCHECK( memcmp( cOutput, cMessage, xLength ) == 0 );
+		hosttestCHECK( xRings[ 0 ].ulHead == xRings[ 0 ].ulTail );
+	}
+
+	hosttestCHECK( xRings[ 0 ].ulHead == ( uint32_t ) ( logringRING_SIZE * xLength ) );
+
+	/* The free running counts wrap as well as the ring. */
+	prvReset();
+	xRings[ 0 ].ulHead = 0xFFFFFFF0UL;
+	xRings[ 0 ].ulTail = 0xFFFFFFF0UL;
+	hosttestCHECK( xLogRingWrite( cMessage, xLength ) == xLength );
+	hosttestCHECK( xRings[ 0 ].ulHead == ( uint32_t ) ( xLength - 16U ) );
+	hosttestCHECK( xLogRingDrain( prvOutput ) == xLength );
+	hosttestCHECK( memcmp( cOutput, cMessage, xLength ) == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestDrops( void )
+{
+LogRingStats_t xStats;
+
+	prvReset();
+
+	/* Leave 6 bytes free.  A message of 10 bytes is dropped whole, then one
+	of exactly 6 fits. */
+	hosttestCHECK( prvWriteFill( 'a', 200 ) == 200 );
+	hosttestCHECK( prvWriteFill( 'b', 50 ) == 50 );
+	hosttestCHECK( prvWriteFill( 'c', 10 ) == 0 );
+	hosttestCHECK( prvWriteFill( 'd', 6 ) == 6 );
+	hosttestCHECK( prvWriteFill( 'e', 1 ) == 0 );
+
+	/* lLogRingPuts() counts the newline it adds. */
+	hosttestCHECK( lLogRingPuts( "fgh" ) == 0 );
+
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulBytesLogged == 256 );
+	hosttestCHECK( xStats.ulMessagesLogged == 3 );
+	hosttestCHECK( xStats.ulBytesDropped == 15 );
+	hosttestCHECK( xStats.ulMessagesDropped == 3 );
+
+	/* None of a dropped message reaches the output. */
+	hosttestCHECK( xLogRingDrain( prvOutput ) == 256 );
+	hosttestCHECK( xOutputLength == 256 );
+	hosttestCHECK( prvOutputIs( 'a', 0, 200 ) != pdFALSE );
+	hosttestCHECK( prvOutputIs( 'b', 200, 50 ) != pdFALSE );
+	hosttestCHECK( prvOutputIs( 'd', 250, 6 ) != pdFALSE );
+
+	/* A message bigger than the ring can never fit. */
+	hosttestCHECK( prvWriteFill( 'g', logringRING_SIZE + 1 ) == 0 );
+	hosttestCHECK( prvWriteFill( 'h', logringRING_SIZE ) == logringRING_SIZE );
+
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulBytesDropped == 15 + logringRING_SIZE + 1 );
+	hosttestCHECK( xStats.ulMessagesDropped == 4 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestCoalescing( void )
+{
+LogRingStats_t xStats;
+size_t x;
+
+	prvReset();
+
+	/* Twenty messages of 10 bytes leave in full packets, then one with the
+	remainder. */
+	for( x = 0; x < 20; x++ )
+	{
+		hosttestCHECK( prvWriteFill( ( char ) ( 'A' + x ), 10 ) == 10 );
+	}
+
+	hosttestCHECK( xLogRingDrain( prvOutput ) == 200 );
+	hosttestCHECK( xPackets == 4 );
+	hosttestCHECK( xPacketLengths[ 0 ] == logringPACKET_SIZE );
+	hosttestCHECK( xPacketLengths[ 1 ] == logringPACKET_SIZE );
+	hosttestCHECK( xPacketLengths[ 2 ] == logringPACKET_SIZE );
+	hosttestCHECK( xPacketLengths[ 3 ] == 200 - ( 3 * logringPACKET_SIZE ) );
+
+	for( x = 0; x < 20; x++ )
+	{
+		hosttestCHECK( prvOutputIs( ( char ) ( 'A' + x ), x * 10, 10 ) != pdFALSE );
+	}
+
+	/* Small messages share a packet, and an empty ring outputs nothing. */
+	hosttestCHECK( lLogRingPuts( "one" ) == 4 );
+	hosttestCHECK( lLogRingPrintf( "%s %d", "two", 2 ) == 5 );
+	hosttestCHECK( xLogRingDrain( prvOutput ) == 9 );
+	hosttestCHECK( xPackets == 5 );
+	hosttestCHECK( memcmp( &( cOutput[ 200 ] ), "one\ntwo 2", 9 ) == 0 );
+	hosttestCHECK( xLogRingDrain( prvOutput ) == 0 );
+	hosttestCHECK( xPackets == 5 );
+
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulBytesSent == 209 );
+	hosttestCHECK( xStats.ulPacketsSent == 5 );
+
+	/* Long printf() output is truncated to fit the message buffer. */
+	hosttestCHECK( lLogRingPrintf( "%040d", 7 ) == logringMAX_MESSAGE_LENGTH - 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSeveralRings( void )
+{
+LogRingStats_t xStats;
+
+	prvReset();
+
+	/* Each core writes to its own ring, so one core filling its ring does not
+	stop the other logging. */
+	uxHostTestCoreID = 0;
+	hosttestCHECK( prvWriteFill( 'x', 20 ) == 20 );
+	uxHostTestCoreID = 1;
+	hosttestCHECK( prvWriteFill( 'y', logringRING_SIZE ) == logringRING_SIZE );
+	hosttestCHECK( prvWriteFill( 'z', 1 ) == 0 );
+	uxHostTestCoreID = 0;
+	hosttestCHECK( prvWriteFill( 'w', 10 ) == 10 );
+
+	/* The rings are drained in turn, each in order, into shared packets. */
+	hosttestCHECK( xLogRingDrain( prvOutput ) == 30 + logringRING_SIZE );
+	hosttestCHECK( prvOutputIs( 'x', 0, 20 ) != pdFALSE );
+	hosttestCHECK( prvOutputIs( 'w', 20, 10 ) != pdFALSE );
+	hosttestCHECK( prvOutputIs( 'y', 30, logringRING_SIZE ) != pdFALSE );
+	hosttestCHECK( xPacketLengths[ 0 ] == logringPACKET_SIZE );
+	hosttestCHECK( xPackets == ( ( 30 + logringRING_SIZE ) + logringPACKET_SIZE - 1 ) / logringPACKET_SIZE );
+
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulMessagesLogged == 3 );
+	hosttestCHECK( xStats.ulBytesLogged == 30 + logringRING_SIZE );
+	hosttestCHECK( xStats.ulMessagesDropped == 1 );
+	hosttestCHECK( xStats.ulHighWaterMark == logringRING_SIZE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestHighWaterMark( void )
+{
+LogRingStats_t xStats;
+
+	prvReset();
+
+	hosttestCHECK( prvWriteFill( 'a', 100 ) == 100 );
+	( void ) xLogRingDrain( prvOutput );
+	hosttestCHECK( prvWriteFill( 'b', 50 ) == 50 );
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulHighWaterMark == 100 );
+
+	/* The mark covers what was held at once, not what was logged. */
+	hosttestCHECK( prvWriteFill( 'c', 70 ) == 70 );
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulHighWaterMark == 120 );
+
+	/* A dropped message does not raise it, and the highest ring counts. */
+	hosttestCHECK( prvWriteFill( 'd', 200 ) == 0 );
+	uxHostTestCoreID = 1;
+	hosttestCHECK( prvWriteFill( 'e', 30 ) == 30 );
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulHighWaterMark == 120 );
+	hosttestCHECK( prvWriteFill( 'f', 100 ) == 100 );
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulHighWaterMark == 130 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRandom( void )
+{
+static char cExpected[ configNUM_CORES ][ ringtestOUTPUT_SIZE ];
+static char cMessage[ logringRING_SIZE ];
+size_t xExpected[ configNUM_CORES ], xHeld[ configNUM_CORES ], xLength, xOffset;
+uint32_t ulDropped = 0, ulHighWaterMark = 0;
+LogRingStats_t xStats;
+UBaseType_t uxCore;
+long lStep;
+
+	prvReset();
+	srand( 3 );
+	memset( xHeld, 0x00, sizeof( xHeld ) );
+
+	for( lStep = 0; lStep < ringtestRANDOM_STEPS; lStep++ )
+	{
+		memset( xExpected, 0x00, sizeof( xExpected ) );
+		xOutputLength = 0;
+
+		/* Random messages from random cores, then a drain, after which the
+		output must be each ring's accepted messages in order, ring by ring. */
+		while( ( rand() % 8 ) != 0 )
+		{
+			uxCore = ( UBaseType_t ) ( rand() % configNUM_CORES );
+			uxHostTestCoreID = uxCore;
+			xLength = 1 + ( size_t ) ( rand() % 80 );
+
+			for( xOffset = 0; xOffset < xLength; xOffset++ )
+			{
+				cMessage[ xOffset ] = ( char ) rand();
+			}
+
+			if( xLength <= ( logringRING_SIZE - xHeld[ uxCore ] ) )
+			{
+				hosttestCHECK( xLogRingWrite( cMessage, xLength ) == xLength );
+				memcpy( &( cExpected[ uxCore ][ xExpected[ uxCore ] ] ), cMessage, xLength );
+				xExpected[ uxCore ] += xLength;
+				xHeld[ uxCore ] += xLength;
+
+				if( xHeld[ uxCore ] > ulHighWaterMark )
+				{
+					ulHighWaterMark = ( uint32_t ) xHeld[ uxCore ];
+				}
+			}
+			else
+			{
+				hosttestCHECK( xLogRingWrite( cMessage, xLength ) == 0 );
+				ulDropped++;
+			}
+		}
+
+		hosttestCHECK( xLogRingDrain( prvOutput ) == xExpected[ 0 ] + xExpected[ 1 ] );
+		hosttestCHECK( memcmp( cOutput, cExpected[ 0 ], xExpected[ 0 ] ) == 0 );
+		hosttestCHECK( memcmp( &( cOutput[ xExpected[ 0 ] ] ), cExpected[ 1 ], xExpected[ 1 ] ) == 0 );
+		memset( xHeld, 0x00, sizeof( xHeld ) );
+	}
+
+	/* The rings were filled often enough for messages to be dropped. */
+	hosttestCHECK( ulDropped > 0 );
+
+	vLogRingGetStats( &xStats );
+	hosttestCHECK( xStats.ulMessagesDropped == ulDropped );
+	hosttestCHECK( xStats.ulHighWaterMark == ulHighWaterMark );
+	hosttestCHECK( xStats.ulBytesSent == xStats.ulBytesLogged );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestDrainTask( void )
+{
+	/* Flushing before the task exists does nothing. */
+	vLogRingFlush();
+	hosttestCHECK( ulDrainNotifications == 0 );
+
+	vStartLogRingTask( tskIDLE_PRIORITY, prvOutput );
+	vLogRingFlush();
+	hosttestCHECK( ulDrainNotifications == 1 );
+	hosttestCHECK( pxDrainOutput == prvOutput );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	prvTestWrapAround();
+	prvTestDrops();
+	prvTestCoalescing();
+	prvTestSeveralRings();
+	prvTestHighWaterMark();
+	prvTestRandom();
+	prvTestDrainTask();
+
+	return iHostTestResult( "LogRingTest" );
+}
+/*-----------------------------------------------------------*/
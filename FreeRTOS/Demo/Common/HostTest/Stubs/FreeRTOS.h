@@ -0,0 +1,136 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+/*
+ * A stand in for the kernel's FreeRTOS.h, used to build demo code on a host so
+ * it can be tested without the kernel or the target.  Only the definitions the
+ * tested code uses are provided.  The kernel functions are declared in the
+ * other headers in this directory, and each test defines the ones it calls, so
+ * the test decides what they do - for example, when a queue is empty or what
+ * the tick count is.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdFALSE						( ( BaseType_t ) 0 )
+#define pdTRUE						( ( BaseType_t ) 1 )
+#define pdPASS						( pdTRUE )
+#define pdFAIL						( pdFALSE )
+#define portMAX_DELAY				( ( TickType_t ) 0xffffffffUL )
+#define portBYTE_ALIGNMENT			8
+#define portBYTE_ALIGNMENT_MASK		( 0x0007 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1 )
+#define pdMS_TO_TICKS( xTimeInMs )	( ( TickType_t ) ( xTimeInMs ) )
+#define tskIDLE_PRIORITY			( ( UBaseType_t ) 0U )
+#define PRIVILEGED_DATA
+
+#ifndef configNUM_CORES
+	#define configNUM_CORES						2
+#endif
+#ifndef configTICK_CORE
+	#define configTICK_CORE						0
+#endif
+#define configMAX_PRIORITIES					32
+#define configMINIMAL_STACK_SIZE				256
+#define configSTACK_DEPTH_TYPE					uint32_t
+#define configTICK_RATE_HZ						1000
+#define configUSE_16_BIT_TICKS					0
+#define configTIMER_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
+#define configTIMER_TASK_STACK_DEPTH			1024
+#define configTIMER_QUEUE_LENGTH				10
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	1
+#ifndef configTOTAL_HEAP_SIZE
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 128 * 1024 ) )
+#endif
+#define configAPPLICATION_ALLOCATED_HEAP		0
+#define configSUPPORT_DYNAMIC_ALLOCATION		1
+#define configUSE_MALLOC_FAILED_HOOK			0
+#define INCLUDE_eTaskGetState					1
+
+/* A failed assertion reports where it failed and ends the test - see
+HostTest.c. */
+void vHostTestAssertCalled( const char *pcFile, int iLine );
+#define configASSERT( x ) if( ( x ) == 0 ) vHostTestAssertCalled( __FILE__, __LINE__ )
+
+/* Critical sections take a recursive mutex shared by every thread of the test,
+and count their nesting, so a test can check they are balanced and that nothing
+that could block is called from inside one. */
+void vTaskEnterCritical( void );
+void vTaskExitCritical( void );
+UBaseType_t uxTaskEnterCriticalFromISR( void );
+void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus );
+#define taskENTER_CRITICAL()				vTaskEnterCritical()
+#define taskEXIT_CRITICAL()					vTaskExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR()		uxTaskEnterCriticalFromISR()
+#define taskEXIT_CRITICAL_FROM_ISR( x )		vTaskExitCriticalFromISR( x )
+#define portYIELD_FROM_ISR( x )				( ( void ) ( x ) )
+#define portEND_SWITCHING_ISR( x )			( ( void ) ( x ) )
+
+/* Masking interrupts is also counted in uxHostTestCriticalNesting. */
+UBaseType_t ulPortSetInterruptMask( void );
+void vPortClearInterruptMask( UBaseType_t ulMask );
+#define portSET_INTERRUPT_MASK()				ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK( x )			vPortClearInterruptMask( x )
+#define portSET_INTERRUPT_MASK_FROM_ISR()		ulPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	vPortClearInterruptMask( x )
+
+/* The core the code under test is running on, which a test can change to
+play the part of each core in turn. */
+extern volatile UBaseType_t uxHostTestCoreID;
+#define portGET_CORE_ID()					( uxHostTestCoreID )
+
+#define traceMALLOC( pvAddress, uiSize )
+#define traceFREE( pvAddress, uiSize )
+
+void *pvPortMalloc( size_t xWantedSize );
+void vPortFree( void *pv );
+size_t xPortGetFreeHeapSize( void );
+size_t xPortGetMinimumEverFreeHeapSize( void );
+
+typedef struct xHeapStats
+{
+	size_t xAvailableHeapSpaceInBytes;
+	size_t xSizeOfLargestFreeBlockInBytes;
+	size_t xSizeOfSmallestFreeBlockInBytes;
+	size_t xNumberOfFreeBlocks;
+	size_t xMinimumEverFreeBytesRemaining;
+	size_t xNumberOfSuccessfulAllocations;
+	size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats );
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,107 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+/* A stand in for the kernel's task.h - see FreeRTOS.h in this directory. */
+
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+typedef void ( *TaskFunction_t )( void * );
+
+typedef enum
+{
+	eNoAction = 0,
+	eSetBits,
+	eIncrement,
+	eSetValueWithOverwrite,
+	eSetValueWithoutOverwrite
+} eNotifyAction;
+
+typedef struct xTIME_OUT
+{
+	BaseType_t xOverflowCount;
+	TickType_t xTimeOnEntering;
+} TimeOut_t;
+
+typedef enum
+{
+	eAbortSleep = 0,
+	eStandardSleep,
+	eNoTasksWaitingTimeout
+} eSleepModeStatus;
+
+typedef enum
+{
+	eRunning = 0,
+	eReady,
+	eBlocked,
+	eSuspended,
+	eDeleted,
+	eInvalid
+} eTaskState;
+
+#define taskSCHEDULER_SUSPENDED		( ( BaseType_t ) 0 )
+#define taskSCHEDULER_NOT_STARTED	( ( BaseType_t ) 1 )
+#define taskSCHEDULER_RUNNING		( ( BaseType_t ) 2 )
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask );
+void vTaskDelete( TaskHandle_t xTaskToDelete );
+void vTaskDelay( const TickType_t xTicksToDelay );
+TickType_t xTaskGetTickCount( void );
+TickType_t xTaskGetTickCountFromISR( void );
+TaskHandle_t xTaskGetCurrentTaskHandle( void );
+BaseType_t xTaskGetSchedulerState( void );
+eTaskState eTaskGetState( TaskHandle_t xTask );
+UBaseType_t uxTaskPriorityGet( const TaskHandle_t xTask );
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority );
+
+/* Scheduler suspension is counted in uxHostTestSchedulerSuspended - see
+HostTest.c. */
+void vTaskSuspendAll( void );
+BaseType_t xTaskResumeAll( void );
+eSleepModeStatus eTaskConfirmSleepModeStatus( void );
+void vTaskStepTick( const TickType_t xTicksToJump );
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut );
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait );
+BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction );
+BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );
+BaseType_t xTaskNotifyIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction );
+BaseType_t xTaskNotifyIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xTaskNotifyWaitIndexed( UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify );
+void vTaskNotifyGiveIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken );
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait );
+
+#define xTaskNotifyGive( xTaskToNotify )	xTaskNotifyGiveIndexed( ( xTaskToNotify ), 0 )
+#define vTaskNotifyGiveFromISR( xTaskToNotify, pxHigherPriorityTaskWoken )	vTaskNotifyGiveIndexedFromISR( ( xTaskToNotify ), 0, ( pxHigherPriorityTaskWoken ) )
+#define ulTaskNotifyTake( xClearCountOnExit, xTicksToWait )	ulTaskNotifyTakeIndexed( 0, ( xClearCountOnExit ), ( xTicksToWait ) )
+
+#endif /* INC_TASK_H */
@@ -0,0 +1,379 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host run of the timer demo in Minimal/TimerDemo.c, built with
+ * tmrdemoUSE_TIMER_WHEEL set to 1 so it tests the timing wheel in
+ * Minimal/TimerWheel.c - including prvTest7_CheckBatchedCommands().
+ *
+ * The test includes both files and plays the scheduler, one tick at a time,
+ * in a single thread.  The timer wheel task has the highest priority, so it
+ * runs each time a task level command is sent to it and after each tick.  The
+ * tick runs vTimerPeriodicISRTests(), as the demo's tick hook would, which
+ * sends its commands from the interrupt.  The demo task runs until it delays
+ * past the end of the run, when the test jumps back to main().  Along the way
+ * xAreTimerDemoTasksStillRunning() is called as the demo's check task would.
+ *
+ * The demo reports errors with configASSERT(), which ends the test.
+ */
+
+/* Standard includes. */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#include "../Minimal/TimerWheel.c"
+
+#define tmrdemoUSE_TIMER_WHEEL 1
+#include "../Minimal/TimerDemo.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define tdwtestBASE_PERIOD			( ( TickType_t ) 50 )
+#define tdwtestCHECK_PERIOD			( ( TickType_t ) 1000 )
+#define tdwtestRUN_TICKS			( ( TickType_t ) 200000 )
+
+/* Each pass of the demo task's loop increments ulLoopCounter once in each of
+tests 3, 4, 5 and 7 and in the restart, and tmrdemoNUM_TIMER_RESETS + 1 times in
+test 6. */
+#define tdwtestLOOPS_PER_PASS		( 5UL + ( uint32_t ) tmrdemoNUM_TIMER_RESETS + 1UL )
+
+/* The timer wheel's queue, which holds twheelQUEUE_LENGTH commands as the
+kernel's queue would, so the demo can fill it before the scheduler starts. */
+static WheelTimerMessage_t xQueueItems[ twheelQUEUE_LENGTH ];
+static size_t xQueueHead = 0, xQueueWaiting = 0;
+
+static TickType_t xTickCount = 0;
+static BaseType_t xSchedulerState = taskSCHEDULER_NOT_STARTED;
+static UBaseType_t uxPendingNotifications = 0;
+
+/* The tasks, and which one is running. */
+static TaskFunction_t pxDemoTaskCode = NULL;
+static UBaseType_t uxDemoTaskPriority = 0;
+static uint8_t ucDemoTaskStandIn, ucTimerWheelTaskStandIn;
+static TaskHandle_t xRunningTask = NULL;
+static uint32_t ulTimerWheelTaskRuns = 0;
+
+/* Jumped to when the run is over. */
+static jmp_buf xEndOfRun;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions TimerWheel.c and TimerDemo.c use. */
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+	return malloc( xWantedSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+	free( pv );
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCount( void )
+{
+	return xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+	return xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+	return xSchedulerState;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return xRunningTask;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+TaskHandle_t xCreatedTask;
+
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+
+	if( pxTaskCode == prvTimerWheelTask )
+	{
+		/* The timer wheel task is played by prvRunTimerWheelTask(). */
+		hosttestCHECK( uxPriority == ( configMAX_PRIORITIES - 1 ) );
+		xCreatedTask = &ucTimerWheelTaskStandIn;
+	}
+	else
+	{
+		hosttestCHECK( pxDemoTaskCode == NULL );
+		hosttestCHECK( uxPriority < ( configMAX_PRIORITIES - 1 ) );
+		pxDemoTaskCode = pxTaskCode;
+		uxDemoTaskPriority = uxPriority;
+		xCreatedTask = &ucDemoTaskStandIn;
+	}
+
+	if( pxCreatedTask != NULL )
+	{
+		*pxCreatedTask = xCreatedTask;
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskPriorityGet( const TaskHandle_t xTask )
+{
+	hosttestCHECK( xTask == NULL );
+	return uxDemoTaskPriority;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority )
+{
+	/* The timer wheel task still has the highest priority. */
+	hosttestCHECK( xTask == NULL );
+	hosttestCHECK( uxNewPriority <= ( configMAX_PRIORITIES - 1 ) );
+	uxDemoTaskPriority = uxNewPriority;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTimerWheelTask( void )
+{
+TaskHandle_t xPreviousTask = xRunningTask;
+
+	/* Runs until its queue is empty and it blocks again. */
+	xRunningTask = &ucTimerWheelTaskStandIn;
+	prvProcessTimerQueue();
+	xRunningTask = xPreviousTask;
+	ulTimerWheelTaskRuns++;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+	configASSERT( uxQueueLength == twheelQUEUE_LENGTH );
+	configASSERT( uxItemSize == sizeof( WheelTimerMessage_t ) );
+
+	return ( QueueHandle_t ) xQueueItems;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcQueueName )
+{
+	( void ) xQueue;
+	( void ) pcQueueName;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBackFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xQueue;
+
+	if( xQueueWaiting < twheelQUEUE_LENGTH )
+	{
+		memcpy( &( xQueueItems[ ( xQueueHead + xQueueWaiting ) % twheelQUEUE_LENGTH ] ), pvItemToQueue, sizeof( WheelTimerMessage_t ) );
+		xQueueWaiting++;
+
+		if( pxHigherPriorityTaskWoken != NULL )
+		{
+			*pxHigherPriorityTaskWoken = pdTRUE;
+		}
+
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+
+	/* Commands are only sent by the demo task, which is always preempted by
+	the timer wheel task before it could fill the queue - so it never needs
+	to block. */
+	( void ) xTicksToWait;
+	hosttestCHECK( xRunningTask != &ucTimerWheelTaskStandIn );
+
+	xReturn = xQueueSendToBackFromISR( xQueue, pvItemToQueue, NULL );
+
+	if( xSchedulerState == taskSCHEDULER_RUNNING )
+	{
+		hosttestCHECK( xReturn == pdPASS );
+		prvRunTimerWheelTask();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xQueue;
+
+	/* Only the timer wheel task receives, and it only blocks until something
+	else runs, so an empty queue always times out. */
+	( void ) xTicksToWait;
+	hosttestCHECK( xRunningTask == &ucTimerWheelTaskStandIn );
+
+	if( xQueueWaiting > 0 )
+	{
+		memcpy( pvBuffer, &( xQueueItems[ xQueueHead ] ), sizeof( WheelTimerMessage_t ) );
+		xQueueHead = ( xQueueHead + 1 ) % twheelQUEUE_LENGTH;
+		xQueueWaiting--;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+	hosttestCHECK( xTaskToNotify == &ucDemoTaskStandIn );
+	configASSERT( uxIndexToNotify == twheelBATCH_NOTIFICATION_INDEX );
+
+	uxPendingNotifications++;
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+uint32_t ulReturn;
+
+	configASSERT( uxIndexToWaitOn == twheelBATCH_NOTIFICATION_INDEX );
+	configASSERT( xClearCountOnExit == pdTRUE );
+	hosttestCHECK( xRunningTask == &ucDemoTaskStandIn );
+
+	/* The timer wheel task processed the batch as soon as it was sent, so a
+	task that waits never has to. */
+	hosttestCHECK( ( xTicksToWait == twheelNO_DELAY ) || ( uxPendingNotifications == 1 ) );
+
+	ulReturn = ( uint32_t ) uxPendingNotifications;
+	uxPendingNotifications = 0;
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTick( void )
+{
+	xTickCount++;
+
+	/* The tick hook runs in the tick interrupt, then the timer wheel task
+	runs before the demo task. */
+	vTimerPeriodicISRTests();
+	prvRunTimerWheelTask();
+
+	if( ( xTickCount % tdwtestCHECK_PERIOD ) == 0 )
+	{
+		hosttestCHECK( xAreTimerDemoTasksStillRunning( tdwtestCHECK_PERIOD ) == pdPASS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vTaskDelay( const TickType_t xTicksToDelay )
+{
+TickType_t xTick;
+
+	hosttestCHECK( xRunningTask == &ucDemoTaskStandIn );
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	for( xTick = 0; xTick < xTicksToDelay; xTick++ )
+	{
+		prvTick();
+	}
+
+	if( xTickCount >= tdwtestRUN_TICKS )
+	{
+		longjmp( xEndOfRun, 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+size_t x;
+
+	vStartTimerDemoTask( tdwtestBASE_PERIOD );
+	hosttestCHECK( pxDemoTaskCode != NULL );
+	hosttestCHECK( xTimerWheelTask == &ucTimerWheelTaskStandIn );
+
+	/* The demo filled the queue before the scheduler started, so could not
+	start its last timer. */
+	hosttestCHECK( xQueueWaiting == twheelQUEUE_LENGTH );
+	hosttestCHECK( xTestStatus == pdPASS );
+
+	/* Start the scheduler.  The timer wheel task runs first. */
+	xSchedulerState = taskSCHEDULER_RUNNING;
+	prvRunTimerWheelTask();
+	hosttestCHECK( xQueueWaiting == 0 );
+
+	if( setjmp( xEndOfRun ) == 0 )
+	{
+		xRunningTask = &ucDemoTaskStandIn;
+		pxDemoTaskCode( NULL );
+
+		/* The demo task never returns. */
+		hosttestCHECK( pdFALSE );
+	}
+
+	/* Every test in the demo task's loop, including the batched commands,
+	ran many times without an error. */
+	hosttestCHECK( xTestStatus == pdPASS );
+	hosttestCHECK( ulLoopCounter >= ( 10UL * tdwtestLOOPS_PER_PASS ) );
+	hosttestCHECK( xQueueWaiting == 0 );
+	hosttestCHECK( uxPendingNotifications == 0 );
+
+	/* The timers created by the demo are all still there. */
+	for( x = 0; x <= configTIMER_QUEUE_LENGTH; x++ )
+	{
+		hosttestCHECK( xAutoReloadTimers[ x ] != NULL );
+	}
+
+	printf( "%lu ticks, %lu demo task loop counts, %lu timer wheel task runs\n",
+		( unsigned long ) xTickCount, ( unsigned long ) ulLoopCounter, ( unsigned long ) ulTimerWheelTaskRuns );
+
+	return iHostTestResult( "TimerDemoWheelTest" );
+}
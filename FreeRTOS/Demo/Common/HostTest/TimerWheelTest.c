@@ -0,0 +1,507 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the timer wheel in Minimal/TimerWheel.c.
+ *
+ * The test includes TimerWheel.c so it can drive the timer wheel task's
+ * processing directly.  The tick count is a variable the test advances, and
+ * the timer wheel's queue is a FIFO the test can inspect.  Calling
+ * prvProcessTimerQueue() does what one pass of the timer wheel task would do
+ * when it unblocks, so the test calls it once per tick.
+ *
+ * prvTestCommandSentWhileDraining() sends a command, stamped with the time it
+ * was sent, while the timer wheel task is part way through draining its
+ * queue - as an interrupt or a task on another core can.  The command's time
+ * is later than the time the wheel was advanced to before the drain started.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#include "../Minimal/TimerWheel.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define wheeltestQUEUE_LENGTH		( 4096 )
+#define wheeltestRANDOM_TIMERS		( 3000 )
+
+/* The queue used in place of the kernel's. */
+static WheelTimerMessage_t xQueueItems[ wheeltestQUEUE_LENGTH ];
+static size_t xQueueHead = 0, xQueueTail = 0;
+
+/* Called each time an item is received from the queue, so a test can send
+more commands while the queue is being drained. */
+static void ( *pxOnReceive )( void ) = NULL;
+
+static TickType_t xTickCount = 0;
+static UBaseType_t uxPendingNotifications = 0;
+
+/* Record of each timer's expiries - indexed by the timer's ID. */
+static TickType_t xExpectedExpiry[ wheeltestRANDOM_TIMERS ];
+static uint32_t ulExpiries[ wheeltestRANDOM_TIMERS ];
+static TickType_t xLastExpiry[ wheeltestRANDOM_TIMERS ];
+static uint32_t ulEarlyOrLateExpiries = 0;
+
+/*-----------------------------------------------------------*/
+
+/* Stand ins for the kernel functions TimerWheel.c uses. */
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+	return malloc( xWantedSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+	free( pv );
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCount( void )
+{
+	return xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+	return xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskGetSchedulerState( void )
+{
+	return taskSCHEDULER_RUNNING;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	/* Commands are always sent from a task other than the timer wheel
+	task. */
+	return ( TaskHandle_t ) &xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask )
+{
+	( void ) pxTaskCode;
+	( void ) pcName;
+	( void ) usStackDepth;
+	( void ) pvParameters;
+	( void ) uxPriority;
+
+	*pxCreatedTask = ( TaskHandle_t ) &xQueueHead;
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+	configASSERT( uxItemSize == sizeof( WheelTimerMessage_t ) );
+	( void ) uxQueueLength;
+
+	return ( QueueHandle_t ) xQueueItems;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueAddToRegistry( QueueHandle_t xQueue, const char *pcQueueName )
+{
+	( void ) xQueue;
+	( void ) pcQueueName;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+	( void ) xQueue;
+	( void ) xTicksToWait;
+
+	configASSERT( xQueueTail < wheeltestQUEUE_LENGTH );
+	memcpy( &( xQueueItems[ xQueueTail ] ), pvItemToQueue, sizeof( WheelTimerMessage_t ) );
+	xQueueTail++;
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBackFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+	( void ) pxHigherPriorityTaskWoken;
+	return xQueueSendToBack( xQueue, pvItemToQueue, 0 );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xQueue;
+
+	/* Nothing else can run while the timer wheel task is blocked, so an empty
+	queue always times out. */
+	( void ) xTicksToWait;
+
+	if( xQueueHead != xQueueTail )
+	{
+		memcpy( pvBuffer, &( xQueueItems[ xQueueHead ] ), sizeof( WheelTimerMessage_t ) );
+		xQueueHead++;
+
+		if( xQueueHead == xQueueTail )
+		{
+			xQueueHead = 0;
+			xQueueTail = 0;
+		}
+
+		if( pxOnReceive != NULL )
+		{
+			pxOnReceive();
+		}
+
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyGiveIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify )
+{
+	( void ) xTaskToNotify;
+	configASSERT( uxIndexToNotify == twheelBATCH_NOTIFICATION_INDEX );
+
+	uxPendingNotifications++;
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTaskNotifyTakeIndexed( UBaseType_t uxIndexToWaitOn, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+{
+uint32_t ulReturn;
+
+	configASSERT( uxIndexToWaitOn == twheelBATCH_NOTIFICATION_INDEX );
+	configASSERT( xClearCountOnExit == pdTRUE );
+
+	if( xTicksToWait != twheelNO_DELAY )
+	{
+		/* The sending task blocks until the timer wheel task has processed
+		its batch, so let the timer wheel task run. */
+		prvProcessTimerQueue();
+	}
+
+	ulReturn = ( uint32_t ) uxPendingNotifications;
+	uxPendingNotifications = 0;
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResetWheel( TickType_t xStartTime )
+{
+	configASSERT( uxLinkedTimers == 0 );
+
+	xTickCount = xStartTime;
+	xQueueHead = 0;
+	xQueueTail = 0;
+	pxOnReceive = NULL;
+	ulEarlyOrLateExpiries = 0;
+	memset( ulExpiries, 0x00, sizeof( ulExpiries ) );
+	memset( xLastExpiry, 0x00, sizeof( xLastExpiry ) );
+
+	/* Let xTimerWheelServiceStart() create the queue and task again. */
+	xTimerWheelQueue = NULL;
+	hosttestCHECK( xTimerWheelServiceStart() == pdPASS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTicks( TickType_t xTicks )
+{
+	while( xTicks > 0 )
+	{
+		xTickCount++;
+		prvProcessTimerQueue();
+		xTicks--;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerCallback( WheelTimerHandle_t xTimer )
+{
+size_t xIndex = ( size_t ) pvWheelTimerGetTimerID( xTimer );
+
+	/* Callbacks only run from the timer wheel task, never from a critical
+	section. */
+	hosttestCHECK( uxHostTestCriticalNesting == 0 );
+
+	if( xTickCount != xExpectedExpiry[ xIndex ] )
+	{
+		ulEarlyOrLateExpiries++;
+
+		if( ulEarlyOrLateExpiries <= 10 )
+		{
+			printf( "Timer %u expired at %lu, expected %lu\n", ( unsigned ) xIndex, ( unsigned long ) xTickCount, ( unsigned long ) xExpectedExpiry[ xIndex ] );
+		}
+	}
+
+	ulExpiries[ xIndex ]++;
+	xLastExpiry[ xIndex ] = xTickCount;
+
+	if( uxWheelTimerGetReloadMode( xTimer ) != pdFALSE )
+	{
+		xExpectedExpiry[ xIndex ] += xWheelTimerGetPeriod( xTimer );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeleteTimer( WheelTimerHandle_t xTimer )
+{
+	hosttestCHECK( xWheelTimerDelete( xTimer, 0 ) == pdPASS );
+	prvProcessTimerQueue();
+}
+/*-----------------------------------------------------------*/
+
+/* The timers used by prvTestCommandSentWhileDraining(). */
+static WheelTimerHandle_t xLateTimer = NULL;
+static TickType_t xLateCommandTime = 0;
+
+static void prvSendLateCommand( void )
+{
+	/* Only send one command. */
+	pxOnReceive = NULL;
+
+	/* Time moves on while the timer wheel task is processing the command it
+	just received, then the late command is sent. */
+	xTickCount += 5;
+	xLateCommandTime = xTickCount;
+	xExpectedExpiry[ 0 ] = xLateCommandTime + xWheelTimerGetPeriod( xLateTimer );
+	hosttestCHECK( xWheelTimerReset( xLateTimer, 0 ) == pdPASS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestCommandSentWhileDraining( UBaseType_t uxAutoReload, TickType_t xStartTime )
+{
+WheelTimerHandle_t xOtherTimer;
+const TickType_t xPeriod = 10;
+
+	prvResetWheel( xStartTime );
+
+	/* Timer 0 receives the late command.  Timer 1 gives the timer wheel task
+	a command to receive before the late command is sent. */
+	xLateTimer = xWheelTimerCreate( "Late", xPeriod, uxAutoReload, ( void * ) 0, prvTimerCallback );
+	xOtherTimer = xWheelTimerCreate( "Other", xPeriod * 100, pdFALSE, ( void * ) 1, prvTimerCallback );
+	configASSERT( xLateTimer && xOtherTimer );
+
+	/* Bring the wheel up to date, then queue a command so the late command is
+	sent part way through a drain. */
+	prvProcessTimerQueue();
+	xExpectedExpiry[ 1 ] = xTickCount + ( xPeriod * 100 );
+	hosttestCHECK( xWheelTimerStart( xOtherTimer, 0 ) == pdPASS );
+	pxOnReceive = prvSendLateCommand;
+	prvProcessTimerQueue();
+
+	/* The late command was sent and processed in the same drain. */
+	hosttestCHECK( pxOnReceive == NULL );
+	hosttestCHECK( xQueueHead == xQueueTail );
+
+	/* The late command must not have expired the timer, or for an auto-reload
+	timer caught up on the periods it appeared to have missed. */
+	hosttestCHECK( ulExpiries[ 0 ] == 0 );
+	hosttestCHECK( xWheelTimerIsTimerActive( xLateTimer ) == pdTRUE );
+	hosttestCHECK( xWheelTimerGetExpiryTime( xLateTimer ) == ( TickType_t ) ( xLateCommandTime + xPeriod ) );
+
+	/* The timer expires one period after the late command was sent. */
+	prvRunTicks( xPeriod - 1 );
+	hosttestCHECK( ulExpiries[ 0 ] == 0 );
+	prvRunTicks( 1 );
+	hosttestCHECK( ulExpiries[ 0 ] == 1 );
+	hosttestCHECK( xLastExpiry[ 0 ] == ( TickType_t ) ( xLateCommandTime + xPeriod ) );
+
+	/* A one-shot timer then stops, and an auto-reload timer keeps going. */
+	prvRunTicks( xPeriod * 3 );
+
+	if( uxAutoReload != pdFALSE )
+	{
+		hosttestCHECK( ulExpiries[ 0 ] == 4 );
+	}
+	else
+	{
+		hosttestCHECK( ulExpiries[ 0 ] == 1 );
+		hosttestCHECK( xWheelTimerIsTimerActive( xLateTimer ) == pdFALSE );
+	}
+
+	hosttestCHECK( ulEarlyOrLateExpiries == 0 );
+
+	prvDeleteTimer( xLateTimer );
+	prvDeleteTimer( xOtherTimer );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestCommandHeldInQueue( void )
+{
+WheelTimerHandle_t xTimer;
+const TickType_t xPeriod = 10;
+
+	/* A command that sits in the queue for longer than the timer's period is
+	still timed from when it was sent - so an auto-reload timer catches up on
+	the expiries it missed while the command was queued. */
+	prvResetWheel( 1000 );
+
+	xTimer = xWheelTimerCreate( "Held", xPeriod, pdTRUE, ( void * ) 0, prvTimerCallback );
+	configASSERT( xTimer );
+	prvProcessTimerQueue();
+
+	hosttestCHECK( xWheelTimerStart( xTimer, 0 ) == pdPASS );
+	xExpectedExpiry[ 0 ] = xTickCount + xPeriod;
+	xTickCount += ( xPeriod * 3 ) + 2;
+
+	/* The expiries that were missed are reported late, so don't check their
+	times. */
+	prvProcessTimerQueue();
+	hosttestCHECK( ulExpiries[ 0 ] == 3 );
+	hosttestCHECK( xWheelTimerGetExpiryTime( xTimer ) == ( TickType_t ) ( 1000 + ( xPeriod * 4 ) ) );
+
+	ulEarlyOrLateExpiries = 0;
+	prvRunTicks( xPeriod - 2 );
+	hosttestCHECK( ulExpiries[ 0 ] == 4 );
+	hosttestCHECK( ulEarlyOrLateExpiries == 0 );
+
+	prvDeleteTimer( xTimer );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestManyTimers( void )
+{
+static WheelTimerHandle_t xTimers[ wheeltestRANDOM_TIMERS ];
+static WheelTimerCommand_t xBatch[ wheeltestRANDOM_TIMERS ];
+UBaseType_t uxCommands = 0;
+TickType_t xPeriod;
+size_t x;
+uint32_t ulTick;
+
+	/* Start close to the tick count overflowing, so timers are cascaded
+	across the wrap. */
+	prvResetWheel( ( TickType_t ) 0xfffff000UL );
+	srand( 1 );
+
+	for( x = 0; x < wheeltestRANDOM_TIMERS; x++ )
+	{
+		/* A few timers have periods long enough to be parked in the coarsest
+		wheel. */
+		xPeriod = ( TickType_t ) ( 1 + ( rand() % ( ( x < 100 ) ? 20000000 : 5000 ) ) );
+
+		/* Odd numbered timers are auto-reload timers. */
+		xTimers[ x ] = xWheelTimerCreate( "Rand", xPeriod, ( UBaseType_t ) ( x & 1 ), ( void * ) x, prvTimerCallback );
+		configASSERT( xTimers[ x ] );
+
+		xExpectedExpiry[ x ] = xTickCount + xPeriod;
+		hosttestCHECK( xWheelTimerStart( xTimers[ x ], 0 ) == pdPASS );
+	}
+
+	prvProcessTimerQueue();
+
+	for( ulTick = 0; ulTick < 200000UL; ulTick++ )
+	{
+		if( ulTick == 50000UL )
+		{
+			/* Reset every third timer individually. */
+			for( x = 0; x < wheeltestRANDOM_TIMERS; x += 3 )
+			{
+				xExpectedExpiry[ x ] = xTickCount + xWheelTimerGetPeriod( xTimers[ x ] );
+				hosttestCHECK( xWheelTimerReset( xTimers[ x ], 0 ) == pdPASS );
+			}
+		}
+		else if( ulTick == 80000UL )
+		{
+			/* Reset every fifth timer as a batch, which returns once the batch
+			has been processed. */
+			for( x = 1; x < wheeltestRANDOM_TIMERS; x += 5 )
+			{
+				xBatch[ uxCommands ].xTimer = xTimers[ x ];
+				xBatch[ uxCommands ].xCommandID = twheelCOMMAND_RESET;
+				xBatch[ uxCommands ].xOptionalValue = 0;
+				xExpectedExpiry[ x ] = xTickCount + xWheelTimerGetPeriod( xTimers[ x ] );
+				uxCommands++;
+			}
+
+			hosttestCHECK( xWheelTimerSendCommandBatch( xBatch, uxCommands, 0 ) == pdPASS );
+			hosttestCHECK( xQueueHead == xQueueTail );
+		}
+
+		prvRunTicks( 1 );
+	}
+
+	/* Let the long timers expire too. */
+	for( ulTick = 0; ulTick < 30000000UL; ulTick++ )
+	{
+		xTickCount++;
+		prvAdvanceWheel( xTickCount );
+	}
+
+	hosttestCHECK( ulEarlyOrLateExpiries == 0 );
+
+	for( x = 0; x < wheeltestRANDOM_TIMERS; x++ )
+	{
+		hosttestCHECK( ulExpiries[ x ] > 0 );
+
+		if( ( x & 1 ) == 0 )
+		{
+			/* A one-shot timer expires once per start or reset - and only if
+			it had not already expired when it was reset. */
+			hosttestCHECK( ulExpiries[ x ] <= 3 );
+			hosttestCHECK( xWheelTimerIsTimerActive( xTimers[ x ] ) == pdFALSE );
+		}
+	}
+
+	for( x = 0; x < wheeltestRANDOM_TIMERS; x++ )
+	{
+		prvDeleteTimer( xTimers[ x ] );
+	}
+
+	hosttestCHECK( uxLinkedTimers == 0 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	prvTestCommandSentWhileDraining( pdFALSE, 1000 );
+	prvTestCommandSentWhileDraining( pdTRUE, 1000 );
+
+	/* Again with the late command sent after the tick count overflows. */
+	prvTestCommandSentWhileDraining( pdTRUE, ( TickType_t ) 0xfffffffeUL );
+
+	prvTestCommandHeldInQueue();
+	prvTestManyTimers();
+
+	return iHostTestResult( "TimerWheelTest" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,506 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test for the wait for any primitive in Minimal/WaitForAny.c.
+ *
+ * The test is single threaded and plays the part of both the task that owns a
+ * set and the tasks that write to it.  The owner's notification value and the
+ * tick count are variables the test controls.  When the owner would block, the
+ * stub calls pxDuringBlock, so a test can write to a member or deliver a late
+ * notification while the owner waits, and the tick count is advanced by the
+ * time the owner waited.
+ *
+ * prvTestLateNotification() holds back the notification of a write until the
+ * owner has already read the written item, as happens when the writer is
+ * preempted, or runs on another core, between writing the member and setting
+ * its bit.  The stale bit must not make xWaitForAnySelect() return NULL
+ * before its block time has expired.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* The code under test. */
+#include "../Minimal/WaitForAny.c"
+
+/* Test includes. */
+#include "HostTest.h"
+
+#define waittestQUEUE_LENGTH		( 8 )
+
+/* The handle of the task that owns the sets. */
+#define waittestOWNER				( ( TaskHandle_t ) &xTickCount )
+
+/*-----------------------------------------------------------*/
+
+/* A queue or semaphore.  Semaphores have an item size of 0. */
+struct HostTestQueue
+{
+	UBaseType_t uxItemSize;
+	UBaseType_t uxWaiting;
+	UBaseType_t uxHead;
+	uint8_t ucItems[ waittestQUEUE_LENGTH ][ sizeof( uint32_t ) ];
+};
+
+/*-----------------------------------------------------------*/
+
+static TickType_t xTickCount = 0;
+
+/* The owner's notification value and state. */
+static uint32_t ulNotificationValue = 0;
+static BaseType_t xNotificationPending = pdFALSE;
+
+/* When set, notifications are held in ulHeldBits instead of being sent, as if
+the writer had not yet got as far as sending them. */
+static BaseType_t xHoldNotifications = pdFALSE;
+static uint32_t ulHeldBits = 0;
+
+/* The number of times the owner blocked. */
+static uint32_t ulBlocks = 0;
+
+/* Called when the owner blocks, with the time it blocks for.  Returns the
+number of ticks that pass before it is woken, if it does anything to wake it. */
+static TickType_t ( *pxDuringBlock )( TickType_t xTicksToWait ) = NULL;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+	return malloc( xWantedSize );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+	free( pv );
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xTaskGetCurrentTaskHandle( void )
+{
+	return waittestOWNER;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	pxTimeOut->xOverflowCount = 0;
+	pxTimeOut->xTimeOnEntering = xTickCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+const TickType_t xElapsed = xTickCount - pxTimeOut->xTimeOnEntering;
+BaseType_t xReturn;
+
+	/* As the kernel's with INCLUDE_vTaskSuspend set to 1. */
+	if( *pxTicksToWait == portMAX_DELAY )
+	{
+		xReturn = pdFALSE;
+	}
+	else if( xElapsed < *pxTicksToWait )
+	{
+		*pxTicksToWait -= xElapsed;
+		pxTimeOut->xTimeOnEntering = xTickCount;
+		xReturn = pdFALSE;
+	}
+	else
+	{
+		*pxTicksToWait = 0;
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyIndexed( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction )
+{
+	hosttestCHECK( xTaskToNotify == waittestOWNER );
+	hosttestCHECK( uxIndexToNotify == waitanyNOTIFICATION_INDEX );
+	hosttestCHECK( eAction == eSetBits );
+
+	if( xHoldNotifications != pdFALSE )
+	{
+		ulHeldBits |= ulValue;
+	}
+	else
+	{
+		ulNotificationValue |= ulValue;
+		xNotificationPending = pdTRUE;
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyIndexedFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	*pxHigherPriorityTaskWoken = pdTRUE;
+
+	return xTaskNotifyIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskNotifyWaitIndexed( UBaseType_t uxIndexToWaitOn, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFALSE;
+TickType_t xTicksWaited = xTicksToWait;
+
+	hosttestCHECK( uxIndexToWaitOn == waitanyNOTIFICATION_INDEX );
+
+	if( xNotificationPending == pdFALSE )
+	{
+		ulNotificationValue &= ~ulBitsToClearOnEntry;
+
+		if( xTicksToWait != 0 )
+		{
+			ulBlocks++;
+
+			if( pxDuringBlock != NULL )
+			{
+				xTicksWaited = pxDuringBlock( xTicksToWait );
+			}
+
+			/* Nothing would ever wake the owner. */
+			hosttestCHECK( ( xTicksToWait != portMAX_DELAY ) || ( xNotificationPending != pdFALSE ) );
+
+			if( xNotificationPending == pdFALSE )
+			{
+				xTicksWaited = xTicksToWait;
+			}
+
+			if( xTicksWaited != portMAX_DELAY )
+			{
+				xTickCount += xTicksWaited;
+			}
+		}
+	}
+
+	if( xNotificationPending != pdFALSE )
+	{
+		*pulNotificationValue = ulNotificationValue;
+		ulNotificationValue &= ~ulBitsToClearOnExit;
+		xNotificationPending = pdFALSE;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueueCreate( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize )
+{
+QueueHandle_t xQueue;
+
+	hosttestCHECK( uxQueueLength <= waittestQUEUE_LENGTH );
+	hosttestCHECK( uxItemSize <= sizeof( uint32_t ) );
+
+	xQueue = calloc( 1, sizeof( *xQueue ) );
+	xQueue->uxItemSize = uxItemSize;
+
+	return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBack( QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	( void ) xTicksToWait;
+
+	if( xQueue->uxWaiting < waittestQUEUE_LENGTH )
+	{
+		if( xQueue->uxItemSize != 0 )
+		{
+			memcpy( xQueue->ucItems[ ( xQueue->uxHead + xQueue->uxWaiting ) % waittestQUEUE_LENGTH ], pvItemToQueue, xQueue->uxItemSize );
+		}
+
+		xQueue->uxWaiting++;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSendToBackFromISR( QueueHandle_t xQueue, const void * const pvItemToQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+	( void ) pxHigherPriorityTaskWoken;
+
+	return xQueueSendToBack( xQueue, pvItemToQueue, 0 );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+
+	/* The owner reads the member it is given without blocking. */
+	hosttestCHECK( xTicksToWait == 0 );
+
+	if( xQueue->uxWaiting > 0 )
+	{
+		if( xQueue->uxItemSize != 0 )
+		{
+			memcpy( pvBuffer, xQueue->ucItems[ xQueue->uxHead ], xQueue->uxItemSize );
+		}
+
+		xQueue->uxHead = ( xQueue->uxHead + 1 ) % waittestQUEUE_LENGTH;
+		xQueue->uxWaiting--;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+	return xQueue->uxWaiting;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t xSemaphore )
+{
+	return xQueueSendToBack( xSemaphore, NULL, 0 );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSemaphoreGiveFromISR( SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	return xQueueSendToBackFromISR( xSemaphore, NULL, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReset( void )
+{
+	xTickCount = 0;
+	ulNotificationValue = 0;
+	xNotificationPending = pdFALSE;
+	xHoldNotifications = pdFALSE;
+	ulHeldBits = 0;
+	ulBlocks = 0;
+	pxDuringBlock = NULL;
+}
+/*-----------------------------------------------------------*/
+
+/* Send the notifications that were held back. */
+static void prvReleaseHeldNotifications( void )
+{
+	xHoldNotifications = pdFALSE;
+
+	if( ulHeldBits != 0 )
+	{
+		( void ) xTaskNotifyIndexed( waittestOWNER, waitanyNOTIFICATION_INDEX, ulHeldBits, eSetBits );
+		ulHeldBits = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static WaitForAnySetHandle_t xBlockSet = NULL;
+static UBaseType_t uxBlockMember = 0;
+
+/* Write to a member three ticks into the owner's block time. */
+static TickType_t prvWriteWhileBlocked( TickType_t xTicksToWait )
+{
+const uint32_t ulValue = 0x5A5A5A5AUL;
+
+	( void ) xTicksToWait;
+	hosttestCHECK( xWaitForAnyQueueSend( xBlockSet, uxBlockMember, &ulValue, 0 ) == pdPASS );
+
+	return 3;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestRoundRobin( void )
+{
+WaitForAnySetHandle_t xSet;
+QueueHandle_t xQueues[ 3 ];
+UBaseType_t uxIndexes[ 3 ], ux;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+uint32_t ulValue;
+
+	prvReset();
+	xSet = xWaitForAnyCreate( NULL );
+	hosttestCHECK( xSet != NULL );
+
+	for( ux = 0; ux < 3; ux++ )
+	{
+		xQueues[ ux ] = xQueueCreate( waittestQUEUE_LENGTH, sizeof( uint32_t ) );
+		hosttestCHECK( xWaitForAnyAddMember( xSet, xQueues[ ux ], &( uxIndexes[ ux ] ) ) == pdPASS );
+		hosttestCHECK( uxIndexes[ ux ] == ux );
+	}
+
+	/* Nothing to read, and no time to wait. */
+	hosttestCHECK( xWaitForAnySelect( xSet, 0 ) == NULL );
+	hosttestCHECK( ulBlocks == 0 );
+
+	/* Two items in member 0, one each in members 1 and 2, written from a task
+	and from an interrupt.  The members are returned in turn, and member 0 stays
+	pending until both its items have been read. */
+	ulValue = 0;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnyQueueSendFromISR( xSet, 0, &ulValue, &xHigherPriorityTaskWoken ) == pdPASS );
+	hosttestCHECK( xHigherPriorityTaskWoken == pdTRUE );
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 1, &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 2, &ulValue, 0 ) == pdPASS );
+
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueues[ 0 ] );
+	hosttestCHECK( xQueueReceive( xQueues[ 0 ], &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueues[ 1 ] );
+	hosttestCHECK( xQueueReceive( xQueues[ 1 ], &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueues[ 2 ] );
+	hosttestCHECK( xQueueReceive( xQueues[ 2 ], &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueues[ 0 ] );
+	hosttestCHECK( xQueueReceive( xQueues[ 0 ], &ulValue, 0 ) == pdPASS );
+
+	/* Every member is empty, so the owner waits the whole block time. */
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == NULL );
+	hosttestCHECK( ulBlocks == 1 );
+	hosttestCHECK( xTickCount == 10 );
+
+	vWaitForAnyDelete( xSet );
+
+	for( ux = 0; ux < 3; ux++ )
+	{
+		free( xQueues[ ux ] );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestSemaphores( void )
+{
+WaitForAnySetHandle_t xSet;
+SemaphoreHandle_t xSemaphores[ 2 ];
+UBaseType_t uxIndex;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	prvReset();
+	xSet = xWaitForAnyCreate( waittestOWNER );
+	xSemaphores[ 0 ] = xQueueCreate( 1, 0 );
+	xSemaphores[ 1 ] = xQueueCreate( 1, 0 );
+	hosttestCHECK( xWaitForAnyAddMember( xSet, xSemaphores[ 0 ], &uxIndex ) == pdPASS );
+	hosttestCHECK( xWaitForAnyAddMember( xSet, xSemaphores[ 1 ], &uxIndex ) == pdPASS );
+
+	hosttestCHECK( xWaitForAnySemaphoreGiveFromISR( xSet, 1, &xHigherPriorityTaskWoken ) == pdPASS );
+	hosttestCHECK( xWaitForAnySelect( xSet, portMAX_DELAY ) == xSemaphores[ 1 ] );
+	hosttestCHECK( xQueueReceive( xSemaphores[ 1 ], NULL, 0 ) == pdPASS );
+
+	hosttestCHECK( xWaitForAnySemaphoreGive( xSet, 0 ) == pdPASS );
+	hosttestCHECK( xWaitForAnySelect( xSet, portMAX_DELAY ) == xSemaphores[ 0 ] );
+	hosttestCHECK( xQueueReceive( xSemaphores[ 0 ], NULL, 0 ) == pdPASS );
+	hosttestCHECK( ulBlocks == 0 );
+
+	vWaitForAnyDelete( xSet );
+	free( xSemaphores[ 0 ] );
+	free( xSemaphores[ 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTestLateNotification( void )
+{
+WaitForAnySetHandle_t xSet;
+QueueHandle_t xQueue;
+uint32_t ulValue;
+
+	prvReset();
+	xSet = xWaitForAnyCreate( NULL );
+	xQueue = xQueueCreate( waittestQUEUE_LENGTH, sizeof( uint32_t ) );
+	hosttestCHECK( xWaitForAnyAddMember( xSet, xQueue, &uxBlockMember ) == pdPASS );
+	xBlockSet = xSet;
+
+	/* A is written and notified.  B is written, but its writer has not yet
+	set the member's bit. */
+	ulValue = 0xA;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+	xHoldNotifications = pdTRUE;
+	ulValue = 0xB;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+
+	/* The owner reads both, as the member still contains B after A is
+	read. */
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueue );
+	hosttestCHECK( ( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS ) && ( ulValue == 0xA ) );
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueue );
+	hosttestCHECK( ( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS ) && ( ulValue == 0xB ) );
+
+	/* B's bit arrives late.  The member is empty, so the owner must carry on
+	waiting, and is given C when it is written three ticks later. */
+	prvReleaseHeldNotifications();
+	pxDuringBlock = prvWriteWhileBlocked;
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == xQueue );
+	hosttestCHECK( ulBlocks == 1 );
+	hosttestCHECK( xTickCount == 3 );
+	hosttestCHECK( ( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS ) && ( ulValue == 0x5A5A5A5AUL ) );
+
+	/* The same with an indefinite block time. */
+	xHoldNotifications = pdTRUE;
+	ulValue = 0xD;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS );
+	prvReleaseHeldNotifications();
+	hosttestCHECK( xWaitForAnySelect( xSet, portMAX_DELAY ) == xQueue );
+	hosttestCHECK( ulBlocks == 2 );
+	hosttestCHECK( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS );
+
+	/* With nothing written, a stale bit only ends the wait when the block
+	time expires, having waited the whole of it. */
+	pxDuringBlock = NULL;
+	xHoldNotifications = pdTRUE;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS );
+	prvReleaseHeldNotifications();
+	xTickCount = 100;
+	hosttestCHECK( xWaitForAnySelect( xSet, 10 ) == NULL );
+	hosttestCHECK( xTickCount == 110 );
+
+	/* And without a block time the call returns at once. */
+	xHoldNotifications = pdTRUE;
+	hosttestCHECK( xWaitForAnyQueueSend( xSet, 0, &ulValue, 0 ) == pdPASS );
+	hosttestCHECK( xQueueReceive( xQueue, &ulValue, 0 ) == pdPASS );
+	prvReleaseHeldNotifications();
+	hosttestCHECK( xWaitForAnySelect( xSet, 0 ) == NULL );
+	hosttestCHECK( xTickCount == 110 );
+
+	vWaitForAnyDelete( xSet );
+	free( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	prvTestRoundRobin();
+	prvTestSemaphores();
+	prvTestLateNotification();
+
+	return iHostTestResult( "WaitForAnyTest" );
+}
+/*-----------------------------------------------------------*/
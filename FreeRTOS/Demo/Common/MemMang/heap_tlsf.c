@@ -0,0 +1,939 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A heap implementation using a two level segregated fit (TLSF) allocator,
+ * with a small per-core cache of recently freed small blocks.  Link this file
+ * in place of one of the heap_n.c files from the kernel's portable/MemMang
+ * directory.  As with heap_4.c the heap is the array ucHeap, sized by
+ * configTOTAL_HEAP_SIZE.
+ *
+ * Free blocks are held in an array of segregated lists.  The first level
+ * divides block sizes into powers of two and the second level divides each
+ * power of two into 2^heaptlsfSL_INDEX_COUNT_LOG2 equal ranges.  Two levels of
+ * bitmaps record which lists are not empty, so finding a free block that is
+ * large enough, and inserting or removing a block, each take a constant number
+ * of steps no matter how many blocks are free.  heap_4.c by contrast walks a
+ * single address ordered list, so its worst case grows with fragmentation.
+ * Adjacent free blocks are merged as soon as a block is freed.
+ *
+ * On a multicore build every allocation would otherwise suspend the
+ * scheduler, which in the SMP kernel serialises both cores.  So blocks of up
+ * to heaptlsfCACHE_MAX_SIZE bytes are not returned to the TLSF lists when they
+ * are freed, but pushed onto a per-core list of blocks of the same size,
+ * holding up to heaptlsfCACHE_DEPTH blocks of each size.  An allocation of the
+ * same size on the same core pops the block back off without taking any lock -
+ * the cache is only ever accessed from its own core with that core's
+ * interrupts masked.  If the TLSF lists cannot satisfy an allocation the
+ * calling core's cache is returned to them and the allocation retried.
+ *
+ * Blocks held in a cache are free as far as the application is concerned, so
+ * xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize() and
+ * vPortGetHeapStats() all count them as free - vPortGetHeapStats() reports
+ * each cached block as a free block.  They are not merged with their
+ * neighbours until they leave the cache though, so call vPortFlushHeapCache()
+ * on each core before reading the statistics to measure the fragmentation of
+ * the TLSF lists themselves.
+ *
+ * See http://www.FreeRTOS.org/a00111.html for an explanation of the heap
+ * implementations provided with the kernel.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* Each power of two is divided into 2^heaptlsfSL_INDEX_COUNT_LOG2 lists. */
+#ifndef heaptlsfSL_INDEX_COUNT_LOG2
+	#define heaptlsfSL_INDEX_COUNT_LOG2	4
+#endif
+
+/* Blocks must be smaller than 2^heaptlsfFL_INDEX_MAX bytes, so this must be
+larger than log2( configTOTAL_HEAP_SIZE ).  Reducing it reduces the size of the
+free list array. */
+#ifndef heaptlsfFL_INDEX_MAX
+	#define heaptlsfFL_INDEX_MAX		24
+#endif
+
+/* Requests for up to heaptlsfCACHE_MAX_SIZE bytes are served from the per-core
+caches when possible.  Set to 0 to remove the caches. */
+#ifndef heaptlsfCACHE_MAX_SIZE
+	#define heaptlsfCACHE_MAX_SIZE		64
+#endif
+
+/* The maximum number of blocks of each size held in each core's cache. */
+#ifndef heaptlsfCACHE_DEPTH
+	#define heaptlsfCACHE_DEPTH			8
+#endif
+
+#if( portBYTE_ALIGNMENT == 32 )
+	#define heapALIGNMENT_LOG2			5
+#elif( portBYTE_ALIGNMENT == 16 )
+	#define heapALIGNMENT_LOG2			4
+#elif( portBYTE_ALIGNMENT == 8 )
+	#define heapALIGNMENT_LOG2			3
+#elif( portBYTE_ALIGNMENT == 4 )
+	#define heapALIGNMENT_LOG2			2
+#else
+	#error heap_tlsf.c requires portBYTE_ALIGNMENT to be 4, 8, 16 or 32
+#endif
+
+#ifdef configNUM_CORES
+	#define heapNUM_CORES				configNUM_CORES
+#else
+	#define heapNUM_CORES				1
+#endif
+
+#ifndef portGET_CORE_ID
+	#define portGET_CORE_ID()			0
+#endif
+
+/* Blocks below heapSMALL_BLOCK_SIZE are all held in first level list 0, which
+is divided linearly. */
+#define heapFL_INDEX_SHIFT				( heaptlsfSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapFL_INDEX_COUNT				( heaptlsfFL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+#define heapSL_INDEX_COUNT				( 1UL << heaptlsfSL_INDEX_COUNT_LOG2 )
+#define heapSMALL_BLOCK_SIZE			( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+#if( heapFL_INDEX_COUNT > 31 ) || ( heaptlsfSL_INDEX_COUNT_LOG2 > 5 )
+	#error The TLSF bitmaps are 32 bits
+#endif
+
+/* The low bits of a block's size are always zero, so hold flags. */
+#define heapBLOCK_FREE					( ( size_t ) 1 )
+#define heapPREVIOUS_FREE				( ( size_t ) 2 )
+#define heapFLAGS_MASK					( heapBLOCK_FREE | heapPREVIOUS_FREE )
+
+/*-----------------------------------------------------------*/
+
+/* The header at the start of each block.  pxNextFree and pxPreviousFree are
+only used while the block is free, so overlay the start of the memory returned
+to the application - they are not part of the header. */
+typedef struct A_TLSF_BLOCK
+{
+	struct A_TLSF_BLOCK *pxPreviousPhysical;	/*<< The block before this one in memory.  Only valid if heapPREVIOUS_FREE is set. */
+	size_t xSize;								/*<< The size of the block, including the header, plus the flags. */
+	struct A_TLSF_BLOCK *pxNextFree;			/*<< The next block in the same free list, or the next block in a cache. */
+	struct A_TLSF_BLOCK *pxPreviousFree;
+} TLSFBlock_t;
+
+/* The size of the header rounded up to keep the memory returned to the
+application aligned, and the smallest block that can be held in a free list. */
+#define heapHEADER_SIZE			( ( offsetof( TLSFBlock_t, pxNextFree ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+#define heapMINIMUM_BLOCK_SIZE	( ( sizeof( TLSFBlock_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The largest request that cannot overflow the size calculations or the free
+lists. */
+#define heapMAXIMUM_REQUEST		( ( ( size_t ) 1 << heaptlsfFL_INDEX_MAX ) - heapHEADER_SIZE - portBYTE_ALIGNMENT )
+
+#define heapBLOCK_SIZE( pxBlock )	( ( pxBlock )->xSize & ~heapFLAGS_MASK )
+#define heapNEXT_PHYSICAL( pxBlock )	( ( TLSFBlock_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+#if( heaptlsfCACHE_MAX_SIZE > 0 )
+
+	#define heapCACHE_MAX_BLOCK_SIZE	( ( heaptlsfCACHE_MAX_SIZE + heapHEADER_SIZE + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+	#define heapCACHE_CLASSES			( ( ( heapCACHE_MAX_BLOCK_SIZE - heapMINIMUM_BLOCK_SIZE ) >> heapALIGNMENT_LOG2 ) + 1 )
+	#define heapCACHE_CLASS( xSize )	( ( ( xSize ) - heapMINIMUM_BLOCK_SIZE ) >> heapALIGNMENT_LOG2 )
+
+	/* A cache is only accessed by its own core with interrupts masked, which
+	stops the calling task being switched out, and on a multicore build moved
+	to another core, part way through. */
+	#if( heapNUM_CORES > 1 )
+		#define heapCACHE_LOCK()			portSET_INTERRUPT_MASK()
+		#define heapCACHE_UNLOCK( x )		portCLEAR_INTERRUPT_MASK( x )
+	#else
+		#define heapCACHE_LOCK()			portSET_INTERRUPT_MASK_FROM_ISR()
+		#define heapCACHE_UNLOCK( x )		portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+	#endif
+
+	typedef struct A_TLSF_CORE_CACHE
+	{
+		TLSFBlock_t *pxBlocks[ heapCACHE_CLASSES ];	/*<< Linked through pxNextFree. */
+		uint8_t ucCount[ heapCACHE_CLASSES ];
+		size_t xCachedBytes;
+		size_t xAllocations;						/*<< Allocations served from the cache. */
+		size_t xFrees;								/*<< Frees that went into the cache. */
+	} TLSFCoreCache_t;
+
+#endif /* heaptlsfCACHE_MAX_SIZE */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to set up the free lists on the first call to
+ * pvPortMalloc().
+ */
+static void prvHeapInit( void );
+
+/*
+ * Return the first and second level indexes of the free list that holds
+ * blocks of xSize bytes.
+ */
+static void prvMappingInsert( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Return the indexes of the first free list that only holds blocks of at
+ * least xSize bytes - the list that would hold xSize rounded up to the next
+ * list boundary.  Returns pdFALSE if there is no such list.
+ */
+static BaseType_t prvMappingSearch( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Using the bitmaps, find the first non-empty list at or above the list
+ * indexed by *puxFL and *puxSL, updating the indexes to those of the list
+ * found.  Returns NULL if there is no such list.
+ */
+static TLSFBlock_t *prvFindSuitableBlock( UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Add and remove blocks from the free lists.
+ */
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock, UBaseType_t uxFL, UBaseType_t uxSL );
+
+/*
+ * Allocate and free blocks of xBlockSize bytes, including the header, from
+ * the TLSF lists.  Must be called with the scheduler suspended.
+ */
+static TLSFBlock_t *prvTLSFAllocate( size_t xBlockSize );
+static void prvTLSFFree( TLSFBlock_t *pxBlock );
+
+/*
+ * Bit scan helpers.  prvFindLastSet() returns the index of the most
+ * significant set bit and prvFindFirstSet() the least significant.  Neither
+ * can be passed zero.
+ */
+static UBaseType_t prvFindLastSet( size_t xValue );
+static UBaseType_t prvFindFirstSet( uint32_t ulValue );
+
+#if( heaptlsfCACHE_MAX_SIZE > 0 )
+
+	/*
+	 * Pop a block of exactly xBlockSize bytes from the calling core's cache,
+	 * or push pxBlock onto it.  prvCachePut() returns pdFALSE if the cache for
+	 * that size is full.
+	 */
+	static TLSFBlock_t *prvCacheGet( size_t xBlockSize );
+	static BaseType_t prvCachePut( TLSFBlock_t *pxBlock );
+
+	/*
+	 * Return every block in the calling core's cache to the TLSF lists.  Must
+	 * be called with the scheduler suspended.
+	 */
+	static void prvCacheFlush( void );
+
+	/*
+	 * The number of bytes held in all the cores' caches.
+	 */
+	static size_t prvCachedBytes( void );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* The free lists and the bitmaps that record which are not empty. */
+PRIVILEGED_DATA static TLSFBlock_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+PRIVILEGED_DATA static uint32_t ulFLBitmap = 0;
+PRIVILEGED_DATA static uint32_t ulSLBitmaps[ heapFL_INDEX_COUNT ];
+
+PRIVILEGED_DATA static BaseType_t xHeapInitialised = pdFALSE;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+number of free bytes remaining, but says nothing about fragmentation.  Blocks
+held in the caches are not included in xFreeBytesRemaining, but are included
+in xMinimumEverFreeBytesRemaining. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+
+#if( heaptlsfCACHE_MAX_SIZE > 0 )
+	PRIVILEGED_DATA static TLSFCoreCache_t xCoreCaches[ heapNUM_CORES ];
+#endif
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TLSFBlock_t *pxBlock = NULL;
+void *pvReturn = NULL;
+size_t xBlockSize;
+
+	/* Zero sized requests, and requests so large that adding the header would
+	overflow, fail. */
+	if( ( xWantedSize > 0 ) && ( xWantedSize <= heapMAXIMUM_REQUEST ) )
+	{
+		xBlockSize = ( xWantedSize + heapHEADER_SIZE + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		if( xBlockSize < heapMINIMUM_BLOCK_SIZE )
+		{
+			xBlockSize = heapMINIMUM_BLOCK_SIZE;
+		}
+
+		#if( heaptlsfCACHE_MAX_SIZE > 0 )
+		{
+			if( xBlockSize <= heapCACHE_MAX_BLOCK_SIZE )
+			{
+				pxBlock = prvCacheGet( xBlockSize );
+			}
+		}
+		#endif
+
+		if( pxBlock == NULL )
+		{
+			vTaskSuspendAll();
+			{
+				if( xHeapInitialised == pdFALSE )
+				{
+					prvHeapInit();
+				}
+
+				pxBlock = prvTLSFAllocate( xBlockSize );
+
+				#if( heaptlsfCACHE_MAX_SIZE > 0 )
+				{
+					if( pxBlock == NULL )
+					{
+						/* The blocks held in this core's cache might merge
+						into a block that is large enough. */
+						prvCacheFlush();
+						pxBlock = prvTLSFAllocate( xBlockSize );
+					}
+				}
+				#endif
+
+				if( pxBlock != NULL )
+				{
+					#if( heaptlsfCACHE_MAX_SIZE > 0 )
+					{
+					size_t xTotalFreeBytes = xFreeBytesRemaining + prvCachedBytes();
+
+						/* Only allocations from the TLSF lists are checked, as
+						an allocation from a cache takes no lock.  A cache can
+						only hold a few small blocks, so the minimum is out by
+						at most the few bytes handed out of the caches since
+						the last check. */
+						if( xTotalFreeBytes < xMinimumEverFreeBytesRemaining )
+						{
+							xMinimumEverFreeBytesRemaining = xTotalFreeBytes;
+						}
+					}
+					#else
+					{
+						if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+						{
+							xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+						}
+					}
+					#endif
+
+					xNumberOfSuccessfulAllocations++;
+				}
+			}
+			( void ) xTaskResumeAll();
+		}
+
+		if( pxBlock != NULL )
+		{
+			pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + heapHEADER_SIZE );
+		}
+	}
+
+	traceMALLOC( pvReturn, xWantedSize );
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+TLSFBlock_t *pxBlock;
+BaseType_t xCached = pdFALSE;
+
+	if( pv != NULL )
+	{
+		pxBlock = ( TLSFBlock_t * ) ( ( ( uint8_t * ) pv ) - heapHEADER_SIZE );
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxBlock->xSize & heapBLOCK_FREE ) == 0 );
+		traceFREE( pv, heapBLOCK_SIZE( pxBlock ) );
+
+		#if( heaptlsfCACHE_MAX_SIZE > 0 )
+		{
+			if( heapBLOCK_SIZE( pxBlock ) <= heapCACHE_MAX_BLOCK_SIZE )
+			{
+				xCached = prvCachePut( pxBlock );
+			}
+		}
+		#endif
+
+		if( xCached == pdFALSE )
+		{
+			vTaskSuspendAll();
+			{
+				prvTLSFFree( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+size_t xReturn = xFreeBytesRemaining;
+
+	#if( heaptlsfCACHE_MAX_SIZE > 0 )
+	{
+		xReturn += prvCachedBytes();
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFlushHeapCache( void )
+{
+	#if( heaptlsfCACHE_MAX_SIZE > 0 )
+	{
+		vTaskSuspendAll();
+		{
+			prvCacheFlush();
+		}
+		( void ) xTaskResumeAll();
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TLSFBlock_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+UBaseType_t uxFL, uxSL;
+
+	vTaskSuspendAll();
+	{
+		for( uxFL = 0; uxFL < heapFL_INDEX_COUNT; uxFL++ )
+		{
+			for( uxSL = 0; uxSL < heapSL_INDEX_COUNT; uxSL++ )
+			{
+				for( pxBlock = pxFreeLists[ uxFL ][ uxSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+				{
+					xBlocks++;
+
+					if( heapBLOCK_SIZE( pxBlock ) > xMaxSize )
+					{
+						xMaxSize = heapBLOCK_SIZE( pxBlock );
+					}
+
+					if( heapBLOCK_SIZE( pxBlock ) < xMinSize )
+					{
+						xMinSize = heapBLOCK_SIZE( pxBlock );
+					}
+				}
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xPortGetFreeHeapSize();
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+
+		#if( heaptlsfCACHE_MAX_SIZE > 0 )
+		{
+		UBaseType_t uxCore;
+		size_t xClass, xCount, xBlockSize;
+
+			/* Each cached block is a free block, the size of its class.  The
+			other cores can use their caches while the scheduler is suspended,
+			so these counts are a snapshot. */
+			for( uxCore = 0; uxCore < heapNUM_CORES; uxCore++ )
+			{
+				for( xClass = 0; xClass < heapCACHE_CLASSES; xClass++ )
+				{
+					xCount = ( size_t ) xCoreCaches[ uxCore ].ucCount[ xClass ];
+
+					if( xCount > 0 )
+					{
+						xBlockSize = heapMINIMUM_BLOCK_SIZE + ( xClass << heapALIGNMENT_LOG2 );
+						xBlocks += xCount;
+
+						if( xBlockSize > xMaxSize )
+						{
+							xMaxSize = xBlockSize;
+						}
+
+						if( xBlockSize < xMinSize )
+						{
+							xMinSize = xBlockSize;
+						}
+					}
+				}
+
+				pxHeapStats->xNumberOfSuccessfulAllocations += xCoreCaches[ uxCore ].xAllocations;
+				pxHeapStats->xNumberOfSuccessfulFrees += xCoreCaches[ uxCore ].xFrees;
+			}
+		}
+		#endif
+
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks > 0 ) ? xMinSize : 0;
+		pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+TLSFBlock_t *pxFirstBlock, *pxSentinel;
+size_t uxAddress, xTotalHeapSize = configTOTAL_HEAP_SIZE, xFirstBlockSize;
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	uxAddress = ( size_t ) ucHeap;
+
+	if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		uxAddress += ( portBYTE_ALIGNMENT - 1 );
+		uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xTotalHeapSize -= uxAddress - ( size_t ) ucHeap;
+	}
+
+	xTotalHeapSize &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* The whole heap starts as one free block, followed by a sentinel header
+	that is never free, so is never merged into the block before it. */
+	xFirstBlockSize = xTotalHeapSize - heapHEADER_SIZE;
+	configASSERT( xFirstBlockSize < ( ( size_t ) 1 << heaptlsfFL_INDEX_MAX ) );
+
+	pxFirstBlock = ( TLSFBlock_t * ) uxAddress;
+	pxFirstBlock->xSize = xFirstBlockSize | heapBLOCK_FREE;
+
+	pxSentinel = heapNEXT_PHYSICAL( pxFirstBlock );
+	pxSentinel->xSize = heapPREVIOUS_FREE;
+	pxSentinel->pxPreviousPhysical = pxFirstBlock;
+
+	prvInsertFreeBlock( pxFirstBlock );
+
+	xFreeBytesRemaining = xFirstBlockSize;
+	xMinimumEverFreeBytesRemaining = xFirstBlockSize;
+	xHeapInitialised = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindLastSet( size_t xValue )
+{
+UBaseType_t uxBit;
+
+	#if defined( __GNUC__ )
+	{
+		uxBit = ( UBaseType_t ) ( ( sizeof( unsigned long ) * 8U ) - 1U - ( UBaseType_t ) __builtin_clzl( ( unsigned long ) xValue ) );
+	}
+	#else
+	{
+		for( uxBit = 0; ( xValue >> 1 ) != 0; uxBit++ )
+		{
+			xValue >>= 1;
+		}
+	}
+	#endif
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindFirstSet( uint32_t ulValue )
+{
+UBaseType_t uxBit;
+
+	#if defined( __GNUC__ )
+	{
+		uxBit = ( UBaseType_t ) __builtin_ctz( ulValue );
+	}
+	#else
+	{
+		for( uxBit = 0; ( ulValue & 1UL ) == 0; uxBit++ )
+		{
+			ulValue >>= 1;
+		}
+	}
+	#endif
+
+	return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+UBaseType_t uxFL, uxSL;
+
+	if( xSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are divided linearly. */
+		uxFL = 0;
+		uxSL = ( UBaseType_t ) ( xSize >> heapALIGNMENT_LOG2 );
+	}
+	else
+	{
+		/* The bits below the most significant bit select the second level
+		list. */
+		uxFL = prvFindLastSet( xSize );
+		uxSL = ( UBaseType_t ) ( xSize >> ( uxFL - heaptlsfSL_INDEX_COUNT_LOG2 ) ) ^ ( UBaseType_t ) heapSL_INDEX_COUNT;
+		uxFL -= ( heapFL_INDEX_SHIFT - 1 );
+	}
+
+	*puxFL = uxFL;
+	*puxSL = uxSL;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvMappingSearch( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+	if( xSize >= heapSMALL_BLOCK_SIZE )
+	{
+		/* Round up so every block in the list found is large enough, rather
+		than having to search the list. */
+		xSize += ( ( size_t ) 1 << ( prvFindLastSet( xSize ) - heaptlsfSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+
+	prvMappingInsert( xSize, puxFL, puxSL );
+
+	return ( *puxFL < heapFL_INDEX_COUNT ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvFindSuitableBlock( UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+UBaseType_t uxFL = *puxFL;
+uint32_t ulSLMap, ulFLMap;
+TLSFBlock_t *pxReturn = NULL;
+
+	/* First look for a non-empty list in the same power of two. */
+	ulSLMap = ulSLBitmaps[ uxFL ] & ( 0xFFFFFFFFUL << *puxSL );
+
+	if( ulSLMap == 0 )
+	{
+		/* Otherwise the smallest list in the next non-empty power of two. */
+		ulFLMap = ulFLBitmap & ( 0xFFFFFFFFUL << ( uxFL + 1 ) );
+
+		if( ulFLMap != 0 )
+		{
+			uxFL = prvFindFirstSet( ulFLMap );
+			ulSLMap = ulSLBitmaps[ uxFL ];
+		}
+	}
+
+	if( ulSLMap != 0 )
+	{
+		*puxFL = uxFL;
+		*puxSL = prvFindFirstSet( ulSLMap );
+		pxReturn = pxFreeLists[ uxFL ][ *puxSL ];
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock )
+{
+UBaseType_t uxFL, uxSL;
+TLSFBlock_t *pxHead;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &uxFL, &uxSL );
+
+	pxHead = pxFreeLists[ uxFL ][ uxSL ];
+	pxBlock->pxNextFree = pxHead;
+	pxBlock->pxPreviousFree = NULL;
+
+	if( pxHead != NULL )
+	{
+		pxHead->pxPreviousFree = pxBlock;
+	}
+
+	pxFreeLists[ uxFL ][ uxSL ] = pxBlock;
+	ulFLBitmap |= 1UL << uxFL;
+	ulSLBitmaps[ uxFL ] |= 1UL << uxSL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock, UBaseType_t uxFL, UBaseType_t uxSL )
+{
+TLSFBlock_t *pxNext = pxBlock->pxNextFree, *pxPrevious = pxBlock->pxPreviousFree;
+
+	if( pxNext != NULL )
+	{
+		pxNext->pxPreviousFree = pxPrevious;
+	}
+
+	if( pxPrevious != NULL )
+	{
+		pxPrevious->pxNextFree = pxNext;
+	}
+	else
+	{
+		/* The block was at the head of its list. */
+		pxFreeLists[ uxFL ][ uxSL ] = pxNext;
+
+		if( pxNext == NULL )
+		{
+			ulSLBitmaps[ uxFL ] &= ~( 1UL << uxSL );
+
+			if( ulSLBitmaps[ uxFL ] == 0 )
+			{
+				ulFLBitmap &= ~( 1UL << uxFL );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvTLSFAllocate( size_t xBlockSize )
+{
+TLSFBlock_t *pxBlock = NULL, *pxRemainder;
+UBaseType_t uxFL, uxSL;
+size_t xRemainingSize;
+
+	if( prvMappingSearch( xBlockSize, &uxFL, &uxSL ) != pdFALSE )
+	{
+		pxBlock = prvFindSuitableBlock( &uxFL, &uxSL );
+	}
+
+	if( pxBlock != NULL )
+	{
+		prvRemoveFreeBlock( pxBlock, uxFL, uxSL );
+		xRemainingSize = heapBLOCK_SIZE( pxBlock ) - xBlockSize;
+
+		if( xRemainingSize >= heapMINIMUM_BLOCK_SIZE )
+		{
+			/* Split the block.  The remainder follows an allocated block, and
+			the block after the remainder already knows its previous block is
+			free. */
+			pxRemainder = ( TLSFBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + xBlockSize );
+			pxRemainder->xSize = xRemainingSize | heapBLOCK_FREE;
+			heapNEXT_PHYSICAL( pxRemainder )->pxPreviousPhysical = pxRemainder;
+			prvInsertFreeBlock( pxRemainder );
+
+			pxBlock->xSize = xBlockSize | ( pxBlock->xSize & heapPREVIOUS_FREE );
+		}
+		else
+		{
+			/* Too small to split, so the whole block is used. */
+			pxBlock->xSize &= ~heapBLOCK_FREE;
+			heapNEXT_PHYSICAL( pxBlock )->xSize &= ~heapPREVIOUS_FREE;
+		}
+
+		xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock );
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTLSFFree( TLSFBlock_t *pxBlock )
+{
+TLSFBlock_t *pxNeighbour;
+UBaseType_t uxFL, uxSL;
+
+	xFreeBytesRemaining += heapBLOCK_SIZE( pxBlock );
+
+	/* Merge with the previous block if it is free.  The previous block's own
+	heapPREVIOUS_FREE flag must be clear, as two free blocks are never
+	adjacent. */
+	if( ( pxBlock->xSize & heapPREVIOUS_FREE ) != 0 )
+	{
+		pxNeighbour = pxBlock->pxPreviousPhysical;
+		prvMappingInsert( heapBLOCK_SIZE( pxNeighbour ), &uxFL, &uxSL );
+		prvRemoveFreeBlock( pxNeighbour, uxFL, uxSL );
+		pxNeighbour->xSize += heapBLOCK_SIZE( pxBlock );
+		pxBlock = pxNeighbour;
+	}
+
+	/* Merge with the next block if it is free. */
+	pxNeighbour = heapNEXT_PHYSICAL( pxBlock );
+
+	if( ( pxNeighbour->xSize & heapBLOCK_FREE ) != 0 )
+	{
+		prvMappingInsert( heapBLOCK_SIZE( pxNeighbour ), &uxFL, &uxSL );
+		prvRemoveFreeBlock( pxNeighbour, uxFL, uxSL );
+		pxBlock->xSize += heapBLOCK_SIZE( pxNeighbour );
+	}
+
+	pxBlock->xSize |= heapBLOCK_FREE;
+
+	pxNeighbour = heapNEXT_PHYSICAL( pxBlock );
+	pxNeighbour->xSize |= heapPREVIOUS_FREE;
+	pxNeighbour->pxPreviousPhysical = pxBlock;
+
+	prvInsertFreeBlock( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+#if( heaptlsfCACHE_MAX_SIZE > 0 )
+
+	static TLSFBlock_t *prvCacheGet( size_t xBlockSize )
+	{
+	TLSFCoreCache_t *pxCache;
+	TLSFBlock_t *pxBlock;
+	const size_t xClass = heapCACHE_CLASS( xBlockSize );
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = heapCACHE_LOCK();
+		{
+			pxCache = &( xCoreCaches[ portGET_CORE_ID() ] );
+			pxBlock = pxCache->pxBlocks[ xClass ];
+
+			if( pxBlock != NULL )
+			{
+				pxCache->pxBlocks[ xClass ] = pxBlock->pxNextFree;
+				pxCache->ucCount[ xClass ]--;
+				pxCache->xCachedBytes -= xBlockSize;
+				pxCache->xAllocations++;
+			}
+		}
+		heapCACHE_UNLOCK( uxSavedInterruptStatus );
+
+		return pxBlock;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvCachePut( TLSFBlock_t *pxBlock )
+	{
+	TLSFCoreCache_t *pxCache;
+	const size_t xBlockSize = heapBLOCK_SIZE( pxBlock );
+	const size_t xClass = heapCACHE_CLASS( xBlockSize );
+	BaseType_t xReturn = pdFALSE;
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = heapCACHE_LOCK();
+		{
+			/* The block may have been allocated on another core - it goes into
+			the cache of the core that frees it. */
+			pxCache = &( xCoreCaches[ portGET_CORE_ID() ] );
+
+			if( pxCache->ucCount[ xClass ] < ( uint8_t ) heaptlsfCACHE_DEPTH )
+			{
+				pxBlock->pxNextFree = pxCache->pxBlocks[ xClass ];
+				pxCache->pxBlocks[ xClass ] = pxBlock;
+				pxCache->ucCount[ xClass ]++;
+				pxCache->xCachedBytes += xBlockSize;
+				pxCache->xFrees++;
+				xReturn = pdTRUE;
+			}
+		}
+		heapCACHE_UNLOCK( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCacheFlush( void )
+	{
+	TLSFCoreCache_t *pxCache;
+	TLSFBlock_t *pxBlock;
+	size_t xClass;
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = heapCACHE_LOCK();
+		{
+			pxCache = &( xCoreCaches[ portGET_CORE_ID() ] );
+
+			for( xClass = 0; xClass < heapCACHE_CLASSES; xClass++ )
+			{
+				while( pxCache->pxBlocks[ xClass ] != NULL )
+				{
+					pxBlock = pxCache->pxBlocks[ xClass ];
+					pxCache->pxBlocks[ xClass ] = pxBlock->pxNextFree;
+					pxCache->xCachedBytes -= heapBLOCK_SIZE( pxBlock );
+
+					/* The cache counted this block as freed when it was
+					pushed, so it is not counted again. */
+					prvTLSFFree( pxBlock );
+				}
+
+				pxCache->ucCount[ xClass ] = 0;
+			}
+		}
+		heapCACHE_UNLOCK( uxSavedInterruptStatus );
+	}
+	/*-----------------------------------------------------------*/
+
+	static size_t prvCachedBytes( void )
+	{
+	size_t xReturn = 0;
+	UBaseType_t uxCore;
+
+		for( uxCore = 0; uxCore < heapNUM_CORES; uxCore++ )
+		{
+			xReturn += xCoreCaches[ uxCore ].xCachedBytes;
+		}
+
+		return xReturn;
+	}
+
+#endif /* heaptlsfCACHE_MAX_SIZE */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,213 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An adaptive mutex for SMP systems.
+ *
+ * When a task attempts to take a standard mutex that is held by a task running
+ * on another core, the task blocks, and is unblocked again when the mutex is
+ * given.  If the mutex protects a short section of code, the mutex is often
+ * given back long before the block, unblock and context switch complete.
+ *
+ * An adaptive mutex wraps a standard mutex.  A task that finds the mutex held
+ * by a task that is in the Running state - which, as the calling task is also
+ * running, means the holder is running on a different core - polls the mutex
+ * rather than blocking, for up to the spin budget given when the mutex was
+ * created.  If the mutex is not obtained within the budget, or the holder stops
+ * running (it blocked or was preempted), the task blocks on the wrapped mutex
+ * as normal, so priority inheritance still applies.
+ *
+ * The spinning task only reads the holder recorded in the adaptive mutex while
+ * it polls, and only checks the holder's state every adaptmuSTATE_CHECK_SPINS
+ * polls, to minimise the traffic it creates on the locks the holder needs to
+ * give the mutex.
+ *
+ * On single core builds the spin phase is compiled out.
+ */
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "AdaptiveMutex.h"
+
+#if( INCLUDE_eTaskGetState != 1 )
+	#error INCLUDE_eTaskGetState must be set to 1 to use adaptive mutexes.
+#endif
+
+#if defined( configNUM_CORES ) && ( configNUM_CORES > 1 )
+	#define adaptmuCAN_SPIN		1
+#else
+	#define adaptmuCAN_SPIN		0
+#endif
+
+/* How many polls are made between checks that the holder is still running. */
+#ifndef adaptmuSTATE_CHECK_SPINS
+	#define adaptmuSTATE_CHECK_SPINS	( 16UL )
+#endif
+
+#define adaptmuDONT_BLOCK			( ( TickType_t ) 0 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct AdaptiveMutexDefinition
+{
+	SemaphoreHandle_t xMutex;				/*<< The wrapped mutex. */
+	volatile TaskHandle_t xHolder;			/*<< The task holding the mutex, or NULL.  Read without a critical section by spinning tasks. */
+	uint32_t ulSpinBudget;
+	volatile uint32_t ulSpinAcquisitions;
+	volatile uint32_t ulBlockedAcquisitions;
+} AdaptiveMutex_t;
+
+/*-----------------------------------------------------------*/
+
+AdaptiveMutexHandle_t xAdaptiveMutexCreate( uint32_t ulSpinBudget )
+{
+AdaptiveMutex_t *pxMutex;
+
+	pxMutex = ( AdaptiveMutex_t * ) pvPortMalloc( sizeof( AdaptiveMutex_t ) );
+
+	if( pxMutex != NULL )
+	{
+		pxMutex->xMutex = xSemaphoreCreateMutex();
+
+		if( pxMutex->xMutex != NULL )
+		{
+			pxMutex->xHolder = NULL;
+			pxMutex->ulSpinBudget = ulSpinBudget;
+			pxMutex->ulSpinAcquisitions = 0;
+			pxMutex->ulBlockedAcquisitions = 0;
+		}
+		else
+		{
+			vPortFree( pxMutex );
+			pxMutex = NULL;
+		}
+	}
+
+	return pxMutex;
+}
+/*-----------------------------------------------------------*/
+
+void vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex )
+{
+	configASSERT( xMutex );
+	configASSERT( xMutex->xHolder == NULL );
+
+	vSemaphoreDelete( xMutex->xMutex );
+	vPortFree( xMutex );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+
+	configASSERT( xMutex );
+
+	xReturn = xSemaphoreTake( xMutex->xMutex, adaptmuDONT_BLOCK );
+
+	if( ( xReturn != pdPASS ) && ( xTicksToWait != adaptmuDONT_BLOCK ) )
+	{
+		#if( adaptmuCAN_SPIN == 1 )
+		{
+		uint32_t ulSpin;
+		TaskHandle_t xHolder;
+
+			for( ulSpin = 0; ulSpin < xMutex->ulSpinBudget; ulSpin++ )
+			{
+				xHolder = xMutex->xHolder;
+
+				if( xHolder == NULL )
+				{
+					/* The mutex has been, or is about to be, given. */
+					xReturn = xSemaphoreTake( xMutex->xMutex, adaptmuDONT_BLOCK );
+
+					if( xReturn == pdPASS )
+					{
+						xMutex->ulSpinAcquisitions++;
+						break;
+					}
+				}
+				else if( ( ulSpin % adaptmuSTATE_CHECK_SPINS ) == 0UL )
+				{
+					/* There is no point spinning if the holder is not running,
+					as the mutex cannot be given until it runs again. */
+					if( eTaskGetState( xHolder ) != eRunning )
+					{
+						break;
+					}
+				}
+			}
+		}
+		#endif /* adaptmuCAN_SPIN */
+
+		if( xReturn != pdPASS )
+		{
+			xReturn = xSemaphoreTake( xMutex->xMutex, xTicksToWait );
+
+			if( xReturn == pdPASS )
+			{
+				xMutex->ulBlockedAcquisitions++;
+			}
+		}
+	}
+
+	if( xReturn == pdPASS )
+	{
+		xMutex->xHolder = xTaskGetCurrentTaskHandle();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex )
+{
+	configASSERT( xMutex );
+	configASSERT( xMutex->xHolder == xTaskGetCurrentTaskHandle() );
+
+	/* Clear the holder before giving the mutex, otherwise a task that takes
+	the mutex between the two lines would have its handle overwritten.  A
+	spinning task that sees the holder cleared before the mutex is given just
+	polls again. */
+	xMutex->xHolder = NULL;
+
+	return xSemaphoreGive( xMutex->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+void vAdaptiveMutexGetStats( AdaptiveMutexHandle_t xMutex, uint32_t *pulSpinAcquisitions, uint32_t *pulBlockedAcquisitions )
+{
+	configASSERT( xMutex );
+
+	*pulSpinAcquisitions = xMutex->ulSpinAcquisitions;
+	*pulBlockedAcquisitions = xMutex->ulBlockedAcquisitions;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,404 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares a standard mutex, created by xSemaphoreCreateMutex(), with the
+ * adaptive mutex implemented in AdaptiveMutex.c.
+ *
+ * Two worker tasks of equal priority repeatedly take the mutex, execute a
+ * short critical section of ambenchCRITICAL_SECTION_LOOPS iterations, give the
+ * mutex, then execute ambenchNON_CRITICAL_LOOPS iterations outside the
+ * critical section.  On a multicore part the two workers run on different
+ * cores, so the mutex is frequently contended by a task whose holder is
+ * running.  A higher priority controller task runs the workers for
+ * ambenchMEASUREMENT_PERIOD ticks using each type of mutex in turn, and
+ * records:
+ *
+ * + Throughput - the total number of takes per second.
+ * + Handoff latency - for takes that found the mutex held by the other worker,
+ *   the time from the other worker giving the mutex to the take completing.
+ *
+ * Each critical section increments a shared counter without any other
+ * protection.  An error is latched if the counter does not equal the total
+ * number of takes at the end of a measurement, which would indicate the mutex
+ * failed to provide mutual exclusion.
+ *
+ * On single core builds the adaptive mutex never spins, so the two results
+ * should match - which is itself a useful sanity check of the overhead the
+ * adaptive mutex adds.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "AdaptiveMutex.h"
+#include "AdaptiveMutexBenchmark.h"
+
+/* The work done inside and outside of the critical section on each loop. */
+#ifndef ambenchCRITICAL_SECTION_LOOPS
+	#define ambenchCRITICAL_SECTION_LOOPS	( 50UL )
+#endif
+
+#ifndef ambenchNON_CRITICAL_LOOPS
+	#define ambenchNON_CRITICAL_LOOPS		( 100UL )
+#endif
+
+/* The spin budget given to the adaptive mutex. */
+#ifndef ambenchSPIN_BUDGET
+	#define ambenchSPIN_BUDGET				( 1000UL )
+#endif
+
+/* The time for which each type of mutex is measured. */
+#define ambenchMEASUREMENT_PERIOD			pdMS_TO_TICKS( 500UL )
+
+#define ambenchNUM_WORKERS					( 2 )
+#define ambenchDONT_BLOCK					( ( TickType_t ) 0 )
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define ambenchGET_TIME()				( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define ambenchGET_TIME()				( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef ambenchTASK_STACK_SIZE
+	#define ambenchTASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The controller and worker tasks, as described at the top of this file.
+ */
+static void prvAdaptiveMutexControllerTask( void *pvParameters );
+static void prvAdaptiveMutexWorkerTask( void *pvParameters );
+
+/*
+ * Run the workers for one measurement period, using the adaptive mutex if
+ * xUseAdaptiveMutex is pdTRUE, otherwise the standard mutex.
+ */
+static void prvMeasure( BaseType_t xUseAdaptiveMutex, AdaptiveMutexBenchmarkResult_t *pxResult );
+
+/*
+ * Take and give whichever mutex is being measured.  prvTake() sets
+ * *pxWaited to pdTRUE if the mutex was not available immediately.
+ */
+static void prvTake( BaseType_t *pxWaited );
+static void prvGive( void );
+
+/*
+ * Execute ulLoops iterations of a loop the compiler cannot remove.
+ */
+static void prvBusyWait( uint32_t ulLoops );
+
+/*-----------------------------------------------------------*/
+
+/* The two mutexes being compared. */
+static SemaphoreHandle_t xStandardMutex = NULL;
+static AdaptiveMutexHandle_t xAdaptiveMutex = NULL;
+static volatile BaseType_t xUseAdaptiveMutexInMeasurement = pdFALSE;
+
+/* Used to start and end each measurement. */
+static SemaphoreHandle_t xStartSemaphore = NULL, xDoneSemaphore = NULL;
+static volatile BaseType_t xStopRequested = pdFALSE;
+
+/* Only accessed by a worker that holds the mutex. */
+static uint32_t ulSharedCounter = 0;
+static uint32_t ulReleaseTime = 0;
+static TaskHandle_t xLastReleaser = NULL;
+static uint32_t ulHandoffs = 0, ulTotalHandoffLatency = 0, ulMaxHandoffLatency = 0;
+
+/* The number of takes made by each worker in the current measurement. */
+static volatile uint32_t ulWorkerAcquisitions[ ambenchNUM_WORKERS ];
+
+/* The most recent results. */
+static AdaptiveMutexBenchmarkResult_t xStandardMutexResult, xAdaptiveMutexResult;
+static uint32_t ulRunCount = 0;
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartAdaptiveMutexBenchmarkTasks( UBaseType_t uxPriority )
+{
+BaseType_t xWorker;
+
+	xStandardMutex = xSemaphoreCreateMutex();
+	xAdaptiveMutex = xAdaptiveMutexCreate( ambenchSPIN_BUDGET );
+	xStartSemaphore = xSemaphoreCreateCounting( ambenchNUM_WORKERS, 0 );
+	xDoneSemaphore = xSemaphoreCreateCounting( ambenchNUM_WORKERS, 0 );
+
+	configASSERT( xStandardMutex );
+	configASSERT( xAdaptiveMutex );
+	configASSERT( xStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	vQueueAddToRegistry( xStandardMutex, "AMBench_Mutex" );
+
+	for( xWorker = 0; xWorker < ambenchNUM_WORKERS; xWorker++ )
+	{
+		xTaskCreate( prvAdaptiveMutexWorkerTask, "AMWork", ambenchTASK_STACK_SIZE, ( void * ) xWorker, uxPriority, NULL );
+	}
+
+	xTaskCreate( prvAdaptiveMutexControllerTask, "AMCtrl", ambenchTASK_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdaptiveMutexControllerTask( void *pvParameters )
+{
+AdaptiveMutexBenchmarkResult_t xStandard, xAdaptive;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvMeasure( pdFALSE, &xStandard );
+		prvMeasure( pdTRUE, &xAdaptive );
+
+		taskENTER_CRITICAL();
+		{
+			xStandardMutexResult = xStandard;
+			xAdaptiveMutexResult = xAdaptive;
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasure( BaseType_t xUseAdaptiveMutex, AdaptiveMutexBenchmarkResult_t *pxResult )
+{
+BaseType_t xWorker;
+uint32_t ulTotalAcquisitions = 0, ulSpinsBefore = 0, ulBlocksBefore = 0, ulSpinsAfter = 0, ulBlocksAfter = 0;
+
+	memset( pxResult, 0x00, sizeof( AdaptiveMutexBenchmarkResult_t ) );
+
+	/* The workers are blocked on the start semaphore, so nothing else is
+	accessing these variables. */
+	ulSharedCounter = 0;
+	xLastReleaser = NULL;
+	ulHandoffs = 0;
+	ulTotalHandoffLatency = 0;
+	ulMaxHandoffLatency = 0;
+
+	for( xWorker = 0; xWorker < ambenchNUM_WORKERS; xWorker++ )
+	{
+		ulWorkerAcquisitions[ xWorker ] = 0;
+	}
+
+	vAdaptiveMutexGetStats( xAdaptiveMutex, &ulSpinsBefore, &ulBlocksBefore );
+
+	xUseAdaptiveMutexInMeasurement = xUseAdaptiveMutex;
+	xStopRequested = pdFALSE;
+
+	for( xWorker = 0; xWorker < ambenchNUM_WORKERS; xWorker++ )
+	{
+		xSemaphoreGive( xStartSemaphore );
+	}
+
+	vTaskDelay( ambenchMEASUREMENT_PERIOD );
+	xStopRequested = pdTRUE;
+
+	for( xWorker = 0; xWorker < ambenchNUM_WORKERS; xWorker++ )
+	{
+		xSemaphoreTake( xDoneSemaphore, portMAX_DELAY );
+	}
+
+	/* The workers can finish in either order, so their counts are only read
+	once they have all finished. */
+	for( xWorker = 0; xWorker < ambenchNUM_WORKERS; xWorker++ )
+	{
+		ulTotalAcquisitions += ulWorkerAcquisitions[ xWorker ];
+	}
+
+	/* Every take incremented the shared counter, which would not add up if
+	two workers were ever in the critical section at the same time. */
+	if( ulSharedCounter != ulTotalAcquisitions )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	pxResult->ulAcquisitionsPerSecond = ( uint32_t ) ( ( ( uint64_t ) ulTotalAcquisitions * configTICK_RATE_HZ ) / ambenchMEASUREMENT_PERIOD );
+	pxResult->ulHandoffs = ulHandoffs;
+	pxResult->ulMeanHandoffLatency = ( ulHandoffs > 0UL ) ? ( ulTotalHandoffLatency / ulHandoffs ) : 0UL;
+	pxResult->ulMaxHandoffLatency = ulMaxHandoffLatency;
+
+	if( xUseAdaptiveMutex != pdFALSE )
+	{
+		vAdaptiveMutexGetStats( xAdaptiveMutex, &ulSpinsAfter, &ulBlocksAfter );
+		pxResult->ulSpinAcquisitions = ulSpinsAfter - ulSpinsBefore;
+		pxResult->ulBlockedAcquisitions = ulBlocksAfter - ulBlocksBefore;
+	}
+
+	ulLoopCounter++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdaptiveMutexWorkerTask( void *pvParameters )
+{
+const BaseType_t xWorker = ( BaseType_t ) pvParameters;
+const TaskHandle_t xThisTask = xTaskGetCurrentTaskHandle();
+BaseType_t xWaited;
+uint32_t ulLatency;
+
+	for( ;; )
+	{
+		xSemaphoreTake( xStartSemaphore, portMAX_DELAY );
+
+		while( xStopRequested == pdFALSE )
+		{
+			prvTake( &xWaited );
+			{
+				/* A take that had to wait for the other worker to give the
+				mutex is a handoff. */
+				if( ( xWaited != pdFALSE ) && ( xLastReleaser != NULL ) && ( xLastReleaser != xThisTask ) )
+				{
+					ulLatency = ambenchGET_TIME() - ulReleaseTime;
+					ulHandoffs++;
+					ulTotalHandoffLatency += ulLatency;
+
+					if( ulLatency > ulMaxHandoffLatency )
+					{
+						ulMaxHandoffLatency = ulLatency;
+					}
+				}
+
+				ulSharedCounter++;
+				prvBusyWait( ambenchCRITICAL_SECTION_LOOPS );
+
+				xLastReleaser = xThisTask;
+				ulReleaseTime = ambenchGET_TIME();
+			}
+			prvGive();
+
+			ulWorkerAcquisitions[ xWorker ]++;
+			prvBusyWait( ambenchNON_CRITICAL_LOOPS );
+		}
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTake( BaseType_t *pxWaited )
+{
+	*pxWaited = pdFALSE;
+
+	if( xUseAdaptiveMutexInMeasurement != pdFALSE )
+	{
+		if( xAdaptiveMutexTake( xAdaptiveMutex, ambenchDONT_BLOCK ) != pdPASS )
+		{
+			*pxWaited = pdTRUE;
+			xAdaptiveMutexTake( xAdaptiveMutex, portMAX_DELAY );
+		}
+	}
+	else
+	{
+		if( xSemaphoreTake( xStandardMutex, ambenchDONT_BLOCK ) != pdPASS )
+		{
+			*pxWaited = pdTRUE;
+			xSemaphoreTake( xStandardMutex, portMAX_DELAY );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvGive( void )
+{
+	if( xUseAdaptiveMutexInMeasurement != pdFALSE )
+	{
+		xAdaptiveMutexGive( xAdaptiveMutex );
+	}
+	else
+	{
+		xSemaphoreGive( xStandardMutex );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBusyWait( uint32_t ulLoops )
+{
+volatile uint32_t ulLoop;
+
+	for( ulLoop = 0; ulLoop < ulLoops; ulLoop++ )
+	{
+		/* Nothing to do, just burning time. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetAdaptiveMutexBenchmarkResults( AdaptiveMutexBenchmarkResult_t *pxStandardMutex, AdaptiveMutexBenchmarkResult_t *pxAdaptiveMutex, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxStandardMutex = xStandardMutexResult;
+		*pxAdaptiveMutex = xAdaptiveMutexResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreAdaptiveMutexBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
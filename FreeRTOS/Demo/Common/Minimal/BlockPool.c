@@ -0,0 +1,444 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A pool of fixed size blocks.
+ *
+ * Applications often allocate many buffers of the same size - message payloads
+ * passed through queues for example.  Allocating them with pvPortMalloc()
+ * mixes them with allocations of other sizes, which fragments the heap, and
+ * each allocation and free searches or merges the heap's free list with the
+ * scheduler suspended.  A block pool instead carves a single allocation (or a
+ * statically allocated array) into uxNumberOfBlocks equal blocks and keeps the
+ * free blocks on a singly linked list threaded through the blocks themselves,
+ * so allocating and freeing a block each take a constant number of steps, and
+ * the pool never fragments.
+ *
+ * On a multicore build the shared free list has to be protected by a cross
+ * core critical section, which stalls the other core if it wants to use the
+ * same pool, or just enter a critical section of its own.  So, like the
+ * magazines of a slab allocator, each core keeps a small array of free blocks
+ * (its magazine) that only it accesses, with its own interrupts masked.  A
+ * block freed on a core goes into that core's magazine, and an allocation on
+ * a core takes a block from that core's magazine, without any cross core
+ * locking.  Only when a core's magazine is empty (on allocation) or full (on
+ * free) does the core take the pool's lock, and then it moves half a magazine
+ * of blocks between the magazine and the shared list in one go, so a core that
+ * allocates and frees at a steady rate rarely takes the lock at all.
+ *
+ * The cost of the magazines is that blocks held in one core's magazine cannot
+ * be allocated by another core, so an allocation can fail while a few blocks
+ * are still free.  Each magazine holds at most blockpoolMAGAZINE_SIZE blocks,
+ * and never more than a quarter of the pool's blocks divided by the number of
+ * cores, so small pools are not starved.  On single core builds masking
+ * interrupts is all the locking needed, so the magazines are not used.
+ *
+ * Both allocating and freeing can be called from tasks and interrupts, and
+ * neither ever blocks.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "BlockPool.h"
+
+#ifndef portGET_CORE_ID
+	#define portGET_CORE_ID()			0
+#endif
+
+/* A magazine is only accessed by its own core with interrupts masked, which
+stops the calling task being switched out, and on a multicore build moved to
+another core, part way through.  The shared list is also accessed with the
+pool's lock held, which on a single core build is no more than masking
+interrupts, so is already done. */
+#if( blockpoolNUM_CORES > 1 )
+	#define poolMAGAZINE_LOCK()			portSET_INTERRUPT_MASK()
+	#define poolMAGAZINE_UNLOCK( x )	portCLEAR_INTERRUPT_MASK( x )
+	#define poolSHARED_LOCK()			taskENTER_CRITICAL_FROM_ISR()
+	#define poolSHARED_UNLOCK( x )		taskEXIT_CRITICAL_FROM_ISR( x )
+	#define poolUSE_MAGAZINES			1
+#else
+	#define poolMAGAZINE_LOCK()			portSET_INTERRUPT_MASK_FROM_ISR()
+	#define poolMAGAZINE_UNLOCK( x )	portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+	#define poolSHARED_LOCK()			( ( UBaseType_t ) 0 )
+	#define poolSHARED_UNLOCK( x )		( void ) ( x )
+	#define poolUSE_MAGAZINES			0
+#endif
+
+/* The size of the pool structure, rounded up so the blocks that follow it in
+a dynamically allocated pool are aligned. */
+#define poolSTRUCT_SIZE					( ( sizeof( BlockPool_t ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/*-----------------------------------------------------------*/
+
+/* A free block holds a pointer to the next free block. */
+typedef struct BlockPoolFreeBlock
+{
+	struct BlockPoolFreeBlock *pxNext;
+} BlockPoolFreeBlock_t;
+
+typedef struct BlockPoolMagazine
+{
+	void *pvBlocks[ blockpoolMAGAZINE_SIZE ];
+	UBaseType_t uxCount;
+	uint32_t ulHits;						/*<< Allocations and frees served by the magazine alone. */
+} BlockPoolMagazine_t;
+
+typedef struct BlockPoolDefinition
+{
+	BlockPoolMagazine_t xMagazines[ blockpoolNUM_CORES ];
+	BlockPoolFreeBlock_t *pxSharedList;		/*<< Free blocks not held in a magazine. */
+	uint8_t *pucStorage;					/*<< The first block. */
+	size_t xBlockStride;
+	UBaseType_t uxNumberOfBlocks;
+	UBaseType_t uxMagazineCapacity;			/*<< The most blocks a magazine holds - 0 if the magazines are not used. */
+	UBaseType_t uxSharedBlocks;
+	UBaseType_t uxMinimumEverSharedBlocks;
+	uint32_t ulRefills;
+	uint32_t ulFlushes;
+	uint32_t ulFailedAllocations;
+	uint8_t ucStaticallyAllocated;
+} BlockPool_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Fill in the pool structure and link all the blocks into the shared list.
+ */
+static void prvInitialisePool( BlockPool_t *pxPool, size_t xBlockSize, UBaseType_t uxNumberOfBlocks, uint8_t *pucPoolStorage );
+
+/*
+ * Called with the calling core's magazine empty.  Takes a block for the
+ * caller, and up to half a magazine more for the magazine, from the shared
+ * list.  Returns NULL if the shared list is empty.
+ */
+static void *prvRefillAndAllocate( BlockPool_t *pxPool, BlockPoolMagazine_t *pxMagazine );
+
+/*
+ * Called with the calling core's magazine full.  Returns pvBlock, and half a
+ * magazine of blocks from the magazine, to the shared list.
+ */
+static void prvFlushAndFree( BlockPool_t *pxPool, BlockPoolMagazine_t *pxMagazine, void *pvBlock );
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	BlockPoolHandle_t xBlockPoolCreate( size_t xBlockSize, UBaseType_t uxNumberOfBlocks )
+	{
+	BlockPool_t *pxPool;
+
+		configASSERT( uxNumberOfBlocks > 0 );
+
+		/* The pool structure and the blocks share one allocation, as a queue
+		structure and its storage area do. */
+		pxPool = ( BlockPool_t * ) pvPortMalloc( poolSTRUCT_SIZE + ( blockpoolBLOCK_STRIDE( xBlockSize ) * ( size_t ) uxNumberOfBlocks ) );
+
+		if( pxPool != NULL )
+		{
+			prvInitialisePool( pxPool, xBlockSize, uxNumberOfBlocks, ( ( uint8_t * ) pxPool ) + poolSTRUCT_SIZE );
+			pxPool->ucStaticallyAllocated = pdFALSE;
+		}
+
+		return pxPool;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+BlockPoolHandle_t xBlockPoolCreateStatic( size_t xBlockSize,
+										  UBaseType_t uxNumberOfBlocks,
+										  uint8_t *pucPoolStorage,
+										  StaticBlockPool_t *pxStaticPool )
+{
+BlockPool_t *pxPool = ( BlockPool_t * ) pxStaticPool;
+
+	configASSERT( pxStaticPool );
+	configASSERT( pucPoolStorage );
+	configASSERT( uxNumberOfBlocks > 0 );
+
+	#if( configASSERT_DEFINED == 1 )
+	{
+		/* Sanity check that the size of the structure used to declare a
+		variable of type StaticBlockPool_t equals the size of the real pool
+		structure. */
+		volatile size_t xSize = sizeof( StaticBlockPool_t );
+		configASSERT( xSize == sizeof( BlockPool_t ) );
+		( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+	}
+	#endif /* configASSERT_DEFINED */
+
+	/* Ensure the first block is correctly aligned - blockpoolSTORAGE_SIZE()
+	includes space for this. */
+	if( ( ( size_t ) pucPoolStorage & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		pucPoolStorage += portBYTE_ALIGNMENT - ( ( size_t ) pucPoolStorage & portBYTE_ALIGNMENT_MASK );
+	}
+
+	prvInitialisePool( pxPool, xBlockSize, uxNumberOfBlocks, pucPoolStorage );
+	pxPool->ucStaticallyAllocated = pdTRUE;
+
+	return pxPool;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialisePool( BlockPool_t *pxPool, size_t xBlockSize, UBaseType_t uxNumberOfBlocks, uint8_t *pucPoolStorage )
+{
+BlockPoolFreeBlock_t *pxBlock;
+UBaseType_t uxBlock;
+
+	memset( pxPool, 0x00, sizeof( BlockPool_t ) );
+
+	pxPool->pucStorage = pucPoolStorage;
+	pxPool->xBlockStride = blockpoolBLOCK_STRIDE( xBlockSize );
+	pxPool->uxNumberOfBlocks = uxNumberOfBlocks;
+	pxPool->uxSharedBlocks = uxNumberOfBlocks;
+	pxPool->uxMinimumEverSharedBlocks = uxNumberOfBlocks;
+
+	#if( poolUSE_MAGAZINES == 1 )
+	{
+		/* Between them the magazines hold at most a quarter of the blocks. */
+		pxPool->uxMagazineCapacity = uxNumberOfBlocks / ( ( UBaseType_t ) 4 * blockpoolNUM_CORES );
+
+		if( pxPool->uxMagazineCapacity > blockpoolMAGAZINE_SIZE )
+		{
+			pxPool->uxMagazineCapacity = blockpoolMAGAZINE_SIZE;
+		}
+	}
+	#endif
+
+	/* Link the blocks in address order. */
+	pxPool->pxSharedList = ( BlockPoolFreeBlock_t * ) pucPoolStorage;
+
+	for( uxBlock = 0; uxBlock < uxNumberOfBlocks; uxBlock++ )
+	{
+		pxBlock = ( BlockPoolFreeBlock_t * ) ( pucPoolStorage + ( pxPool->xBlockStride * uxBlock ) );
+
+		if( uxBlock < ( uxNumberOfBlocks - 1 ) )
+		{
+			pxBlock->pxNext = ( BlockPoolFreeBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + pxPool->xBlockStride );
+		}
+		else
+		{
+			pxBlock->pxNext = NULL;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolDelete( BlockPoolHandle_t xPool )
+{
+BlockPool_t *pxPool = xPool;
+
+	configASSERT( pxPool );
+
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	{
+		if( pxPool->ucStaticallyAllocated == pdFALSE )
+		{
+			vPortFree( pxPool );
+		}
+	}
+	#else
+	{
+		( void ) pxPool;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void *pvBlockPoolAllocate( BlockPoolHandle_t xPool )
+{
+BlockPool_t *pxPool = xPool;
+BlockPoolMagazine_t *pxMagazine;
+void *pvBlock;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxPool );
+
+	uxSavedInterruptStatus = poolMAGAZINE_LOCK();
+	{
+		pxMagazine = &( pxPool->xMagazines[ portGET_CORE_ID() ] );
+
+		if( pxMagazine->uxCount > 0 )
+		{
+			pxMagazine->uxCount--;
+			pvBlock = pxMagazine->pvBlocks[ pxMagazine->uxCount ];
+			pxMagazine->ulHits++;
+		}
+		else
+		{
+			pvBlock = prvRefillAndAllocate( pxPool, pxMagazine );
+		}
+	}
+	poolMAGAZINE_UNLOCK( uxSavedInterruptStatus );
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolFree( BlockPoolHandle_t xPool, void *pvBlock )
+{
+BlockPool_t *pxPool = xPool;
+BlockPoolMagazine_t *pxMagazine;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxPool );
+	configASSERT( pvBlock );
+
+	/* The block must be one of this pool's blocks. */
+	configASSERT( ( ( uint8_t * ) pvBlock >= pxPool->pucStorage ) &&
+				  ( ( uint8_t * ) pvBlock < ( pxPool->pucStorage + ( pxPool->xBlockStride * pxPool->uxNumberOfBlocks ) ) ) );
+	configASSERT( ( ( size_t ) ( ( uint8_t * ) pvBlock - pxPool->pucStorage ) % pxPool->xBlockStride ) == 0 );
+
+	uxSavedInterruptStatus = poolMAGAZINE_LOCK();
+	{
+		pxMagazine = &( pxPool->xMagazines[ portGET_CORE_ID() ] );
+
+		if( pxMagazine->uxCount < pxPool->uxMagazineCapacity )
+		{
+			pxMagazine->pvBlocks[ pxMagazine->uxCount ] = pvBlock;
+			pxMagazine->uxCount++;
+			pxMagazine->ulHits++;
+		}
+		else
+		{
+			prvFlushAndFree( pxPool, pxMagazine, pvBlock );
+		}
+	}
+	poolMAGAZINE_UNLOCK( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvRefillAndAllocate( BlockPool_t *pxPool, BlockPoolMagazine_t *pxMagazine )
+{
+BlockPoolFreeBlock_t *pxBlock;
+UBaseType_t uxToMove, uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = poolSHARED_LOCK();
+	{
+		pxBlock = pxPool->pxSharedList;
+
+		if( pxBlock != NULL )
+		{
+			pxPool->pxSharedList = pxBlock->pxNext;
+			pxPool->uxSharedBlocks--;
+
+			/* Take half a magazine more, so the next few allocations on this
+			core do not need the lock. */
+			uxToMove = pxPool->uxMagazineCapacity / 2;
+
+			while( ( uxToMove > 0 ) && ( pxPool->pxSharedList != NULL ) )
+			{
+				pxMagazine->pvBlocks[ pxMagazine->uxCount ] = pxPool->pxSharedList;
+				pxMagazine->uxCount++;
+				pxPool->pxSharedList = pxPool->pxSharedList->pxNext;
+				pxPool->uxSharedBlocks--;
+				uxToMove--;
+			}
+
+			if( pxPool->uxSharedBlocks < pxPool->uxMinimumEverSharedBlocks )
+			{
+				pxPool->uxMinimumEverSharedBlocks = pxPool->uxSharedBlocks;
+			}
+
+			pxPool->ulRefills++;
+		}
+		else
+		{
+			pxPool->ulFailedAllocations++;
+		}
+	}
+	poolSHARED_UNLOCK( uxSavedInterruptStatus );
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFlushAndFree( BlockPool_t *pxPool, BlockPoolMagazine_t *pxMagazine, void *pvBlock )
+{
+BlockPoolFreeBlock_t *pxBlock;
+UBaseType_t uxToMove, uxSavedInterruptStatus;
+
+	/* Build the list to return before taking the lock. */
+	pxBlock = ( BlockPoolFreeBlock_t * ) pvBlock;
+	pxBlock->pxNext = NULL;
+
+	for( uxToMove = pxPool->uxMagazineCapacity / 2; uxToMove > 0; uxToMove-- )
+	{
+		pxMagazine->uxCount--;
+		( ( BlockPoolFreeBlock_t * ) pxMagazine->pvBlocks[ pxMagazine->uxCount ] )->pxNext = pxBlock;
+		pxBlock = ( BlockPoolFreeBlock_t * ) pxMagazine->pvBlocks[ pxMagazine->uxCount ];
+	}
+
+	uxSavedInterruptStatus = poolSHARED_LOCK();
+	{
+		( ( BlockPoolFreeBlock_t * ) pvBlock )->pxNext = pxPool->pxSharedList;
+		pxPool->pxSharedList = pxBlock;
+		pxPool->uxSharedBlocks += ( pxPool->uxMagazineCapacity / 2 ) + 1;
+		pxPool->ulFlushes++;
+	}
+	poolSHARED_UNLOCK( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolGetStats( BlockPoolHandle_t xPool, BlockPoolStats_t *pxStats )
+{
+BlockPool_t *pxPool = xPool;
+BaseType_t xCore;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxPool );
+	configASSERT( pxStats );
+
+	uxSavedInterruptStatus = poolSHARED_LOCK();
+	{
+		pxStats->xBlockSize = pxPool->xBlockStride;
+		pxStats->uxNumberOfBlocks = pxPool->uxNumberOfBlocks;
+		pxStats->uxFreeBlocks = pxPool->uxSharedBlocks;
+		pxStats->uxMinimumEverSharedBlocks = pxPool->uxMinimumEverSharedBlocks;
+		pxStats->ulRefills = pxPool->ulRefills;
+		pxStats->ulFlushes = pxPool->ulFlushes;
+		pxStats->ulFailedAllocations = pxPool->ulFailedAllocations;
+		pxStats->ulCacheHits = 0;
+
+		/* The other cores' magazines can change while they are read, hence
+		the counts are not exact. */
+		for( xCore = 0; xCore < blockpoolNUM_CORES; xCore++ )
+		{
+			pxStats->uxFreeBlocks += pxPool->xMagazines[ xCore ].uxCount;
+			pxStats->ulCacheHits += pxPool->xMagazines[ xCore ].ulHits;
+		}
+	}
+	poolSHARED_UNLOCK( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
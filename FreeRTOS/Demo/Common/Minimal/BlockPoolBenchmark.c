@@ -0,0 +1,423 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares allocating and freeing fixed size blocks using pvPortMalloc() and
+ * vPortFree() with allocating and freeing them from a block pool, as
+ * implemented in BlockPool.c.
+ *
+ * bpbenchNUM_WORKERS worker tasks each own bpbenchSLOTS pointers.  On each
+ * operation a worker picks a slot at random - if the slot holds a block the
+ * block is freed, otherwise a bpbenchBLOCK_SIZE byte block is allocated into
+ * it.  On a multicore build there is one worker per core, each pinned to its
+ * core, so the allocator is used from all the cores at once.  A higher
+ * priority controller task runs the workers for bpbenchMEASUREMENT_PERIOD
+ * ticks using the heap, then for the same time using the pool, and records
+ * for each:
+ *
+ * + Throughput - the total number of allocations plus frees per second.
+ * + Latency - the mean and maximum time taken by a single allocation or free.
+ *
+ * The workers write to each block they allocate and check it before freeing
+ * it.  An error is latched if a block has been changed, which would indicate
+ * the same memory was given to two workers at once.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "BlockPool.h"
+#include "BlockPoolBenchmark.h"
+
+/* The size of every block, typical of a small message payload. */
+#ifndef bpbenchBLOCK_SIZE
+	#define bpbenchBLOCK_SIZE				( 48 )
+#endif
+
+#ifndef bpbenchSLOTS
+	#define bpbenchSLOTS					( 16 )
+#endif
+
+/* The time for which each allocator is measured. */
+#define bpbenchMEASUREMENT_PERIOD			pdMS_TO_TICKS( 500UL )
+
+#ifdef configNUM_CORES
+	#define bpbenchNUM_WORKERS				configNUM_CORES
+#else
+	#define bpbenchNUM_WORKERS				1
+#endif
+
+/* Enough blocks for every slot to be full, plus the most the magazines can
+hold. */
+#define bpbenchPOOL_BLOCKS					( ( bpbenchSLOTS * bpbenchNUM_WORKERS * 4 ) / 3 )
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define bpbenchGET_TIME()				( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define bpbenchGET_TIME()				( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef bpbenchTASK_STACK_SIZE
+	#define bpbenchTASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The measurements made by one worker during a measurement. */
+typedef struct BLOCK_POOL_BENCHMARK_WORKER_RESULT
+{
+	uint32_t ulOperations;
+	uint32_t ulTotalLatency;
+	uint32_t ulMaxLatency;
+	uint32_t ulFailedAllocations;
+} BlockPoolBenchmarkWorkerResult_t;
+
+/*
+ * The controller and worker tasks, as described at the top of this file.
+ */
+static void prvBlockPoolBenchmarkControllerTask( void *pvParameters );
+static void prvBlockPoolBenchmarkWorkerTask( void *pvParameters );
+
+/*
+ * Run the workers for one measurement period, using the pool if xUsePool is
+ * pdTRUE, otherwise the heap.
+ */
+static void prvMeasure( BaseType_t xUsePool, BlockPoolBenchmarkResult_t *pxResult );
+
+/*
+ * Allocate and free a block using whichever allocator is being measured.
+ */
+static void *prvAllocate( void );
+static void prvFree( void *pvBlock );
+
+/*
+ * Check the value written into a block, then free it, recording the time the
+ * free took.
+ */
+static void prvCheckAndFree( BaseType_t xWorker, uint8_t *pucBlock, BlockPoolBenchmarkWorkerResult_t *pxResult );
+
+/*
+ * Add a latency to a worker's total and maximum.
+ */
+static void prvRecordLatency( uint32_t ulLatency, BlockPoolBenchmarkWorkerResult_t *pxResult );
+
+/*-----------------------------------------------------------*/
+
+/* The pool being compared with the heap. */
+static BlockPoolHandle_t xPool = NULL;
+static volatile BaseType_t xUsePoolInMeasurement = pdFALSE;
+
+/* Used to start and end each measurement. */
+static SemaphoreHandle_t xStartSemaphore = NULL, xDoneSemaphore = NULL;
+static volatile BaseType_t xStopRequested = pdFALSE;
+
+/* Written by each worker during a measurement, and read by the controller
+after. */
+static BlockPoolBenchmarkWorkerResult_t xWorkerResults[ bpbenchNUM_WORKERS ];
+
+/* The most recent results. */
+static BlockPoolBenchmarkResult_t xHeapResult, xPoolResult;
+static uint32_t ulRunCount = 0;
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartBlockPoolBenchmarkTasks( UBaseType_t uxPriority )
+{
+BaseType_t xWorker;
+TaskHandle_t xWorkerTask;
+
+	xPool = xBlockPoolCreate( bpbenchBLOCK_SIZE, bpbenchPOOL_BLOCKS );
+	xStartSemaphore = xSemaphoreCreateCounting( bpbenchNUM_WORKERS, 0 );
+	xDoneSemaphore = xSemaphoreCreateCounting( bpbenchNUM_WORKERS, 0 );
+
+	configASSERT( xPool );
+	configASSERT( xStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	for( xWorker = 0; xWorker < bpbenchNUM_WORKERS; xWorker++ )
+	{
+		xTaskCreate( prvBlockPoolBenchmarkWorkerTask, "BBWork", bpbenchTASK_STACK_SIZE, ( void * ) xWorker, uxPriority, &xWorkerTask );
+
+		#if( configUSE_CORE_AFFINITY == 1 ) && ( bpbenchNUM_WORKERS > 1 )
+		{
+			/* One worker on each core, so the allocators are used from all the
+			cores at the same time. */
+			vTaskCoreAffinitySet( xWorkerTask, ( UBaseType_t ) 1 << xWorker );
+		}
+		#else
+		{
+			( void ) xWorkerTask;
+		}
+		#endif
+	}
+
+	xTaskCreate( prvBlockPoolBenchmarkControllerTask, "BBCtrl", bpbenchTASK_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockPoolBenchmarkControllerTask( void *pvParameters )
+{
+BlockPoolBenchmarkResult_t xHeap, xPoolMeasurement;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvMeasure( pdFALSE, &xHeap );
+		prvMeasure( pdTRUE, &xPoolMeasurement );
+
+		taskENTER_CRITICAL();
+		{
+			xHeapResult = xHeap;
+			xPoolResult = xPoolMeasurement;
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasure( BaseType_t xUsePool, BlockPoolBenchmarkResult_t *pxResult )
+{
+BaseType_t xWorker;
+uint32_t ulOperations = 0, ulTotalLatency = 0;
+
+	memset( pxResult, 0x00, sizeof( BlockPoolBenchmarkResult_t ) );
+
+	/* The workers are blocked on the start semaphore, so nothing else is
+	accessing these variables. */
+	memset( xWorkerResults, 0x00, sizeof( xWorkerResults ) );
+	xUsePoolInMeasurement = xUsePool;
+	xStopRequested = pdFALSE;
+
+	for( xWorker = 0; xWorker < bpbenchNUM_WORKERS; xWorker++ )
+	{
+		xSemaphoreGive( xStartSemaphore );
+	}
+
+	vTaskDelay( bpbenchMEASUREMENT_PERIOD );
+	xStopRequested = pdTRUE;
+
+	for( xWorker = 0; xWorker < bpbenchNUM_WORKERS; xWorker++ )
+	{
+		xSemaphoreTake( xDoneSemaphore, portMAX_DELAY );
+	}
+
+	for( xWorker = 0; xWorker < bpbenchNUM_WORKERS; xWorker++ )
+	{
+		ulOperations += xWorkerResults[ xWorker ].ulOperations;
+		ulTotalLatency += xWorkerResults[ xWorker ].ulTotalLatency;
+		pxResult->ulFailedAllocations += xWorkerResults[ xWorker ].ulFailedAllocations;
+
+		if( xWorkerResults[ xWorker ].ulMaxLatency > pxResult->ulMaxLatency )
+		{
+			pxResult->ulMaxLatency = xWorkerResults[ xWorker ].ulMaxLatency;
+		}
+	}
+
+	pxResult->ulOperationsPerSecond = ( uint32_t ) ( ( ( uint64_t ) ulOperations * configTICK_RATE_HZ ) / bpbenchMEASUREMENT_PERIOD );
+	pxResult->ulMeanLatency = ( ulOperations > 0UL ) ? ( ulTotalLatency / ulOperations ) : 0UL;
+
+	ulLoopCounter++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockPoolBenchmarkWorkerTask( void *pvParameters )
+{
+const BaseType_t xWorker = ( BaseType_t ) pvParameters;
+uint8_t *pucSlots[ bpbenchSLOTS ];
+uint32_t ulSeed = ( uint32_t ) xWorker + 1UL, ulSlot, ulStart, ulLatency;
+BlockPoolBenchmarkWorkerResult_t *pxResult = &( xWorkerResults[ xWorker ] );
+
+	memset( pucSlots, 0x00, sizeof( pucSlots ) );
+
+	for( ;; )
+	{
+		xSemaphoreTake( xStartSemaphore, portMAX_DELAY );
+
+		while( xStopRequested == pdFALSE )
+		{
+			ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+			ulSlot = ( ulSeed >> 16 ) % bpbenchSLOTS;
+
+			if( pucSlots[ ulSlot ] != NULL )
+			{
+				prvCheckAndFree( xWorker, pucSlots[ ulSlot ], pxResult );
+				pucSlots[ ulSlot ] = NULL;
+			}
+			else
+			{
+				ulStart = bpbenchGET_TIME();
+				pucSlots[ ulSlot ] = ( uint8_t * ) prvAllocate();
+				ulLatency = bpbenchGET_TIME() - ulStart;
+
+				if( pucSlots[ ulSlot ] == NULL )
+				{
+					pxResult->ulFailedAllocations++;
+				}
+				else
+				{
+					memset( pucSlots[ ulSlot ], ( int ) xWorker, bpbenchBLOCK_SIZE );
+					prvRecordLatency( ulLatency, pxResult );
+				}
+			}
+		}
+
+		/* Return everything to the allocator that was being measured before
+		the next measurement, which may use the other. */
+		for( ulSlot = 0; ulSlot < bpbenchSLOTS; ulSlot++ )
+		{
+			if( pucSlots[ ulSlot ] != NULL )
+			{
+				prvCheckAndFree( xWorker, pucSlots[ ulSlot ], pxResult );
+				pucSlots[ ulSlot ] = NULL;
+			}
+		}
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckAndFree( BaseType_t xWorker, uint8_t *pucBlock, BlockPoolBenchmarkWorkerResult_t *pxResult )
+{
+uint32_t ulStart, ulLatency;
+size_t x;
+
+	for( x = 0; x < bpbenchBLOCK_SIZE; x++ )
+	{
+		if( pucBlock[ x ] != ( uint8_t ) xWorker )
+		{
+			xErrorDetected = pdTRUE;
+			break;
+		}
+	}
+
+	ulStart = bpbenchGET_TIME();
+	prvFree( pucBlock );
+	ulLatency = bpbenchGET_TIME() - ulStart;
+
+	prvRecordLatency( ulLatency, pxResult );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordLatency( uint32_t ulLatency, BlockPoolBenchmarkWorkerResult_t *pxResult )
+{
+	pxResult->ulOperations++;
+	pxResult->ulTotalLatency += ulLatency;
+
+	if( ulLatency > pxResult->ulMaxLatency )
+	{
+		pxResult->ulMaxLatency = ulLatency;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvAllocate( void )
+{
+void *pvReturn;
+
+	if( xUsePoolInMeasurement != pdFALSE )
+	{
+		pvReturn = pvBlockPoolAllocate( xPool );
+	}
+	else
+	{
+		pvReturn = pvPortMalloc( bpbenchBLOCK_SIZE );
+	}
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFree( void *pvBlock )
+{
+	if( xUsePoolInMeasurement != pdFALSE )
+	{
+		vBlockPoolFree( xPool, pvBlock );
+	}
+	else
+	{
+		vPortFree( pvBlock );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetBlockPoolBenchmarkResults( BlockPoolBenchmarkResult_t *pxHeap, BlockPoolBenchmarkResult_t *pxPool, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxHeap = xHeapResult;
+		*pxPool = xPoolResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreBlockPoolBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,525 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Demonstrates and tests the block pools implemented in BlockPool.c.
+ *
+ * A creator task repeatedly creates and deletes pools, using both statically
+ * and dynamically allocated memory, and checks each pool hands out every one
+ * of its blocks exactly once (allowing for blocks held in the other cores'
+ * magazines - see BlockPool.c), that the blocks do not overlap, and that every
+ * block is returned when freed.
+ *
+ * An exchange task and vBlockPoolPeriodicISRTest(), which must be called from
+ * the tick hook, pass blocks in both directions through a pair of queues, in
+ * the way an application might pass message payloads between a task and an
+ * interrupt.  The task allocates blocks and sends them to the interrupt, which
+ * checks and frees them, and the interrupt allocates blocks and sends them to
+ * the task, which checks and frees them.  So blocks are allocated and freed
+ * from both tasks and interrupts, and on a multicore build from different
+ * cores.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo program include files. */
+#include "BlockPool.h"
+#include "BlockPoolDemo.h"
+
+/* The priority at which the tasks that perform the tests are created. */
+#define bpoolTASK_PRIORITY					( tskIDLE_PRIORITY + 2 )
+
+/* The size and number of the blocks in the pools created and deleted by the
+creator task.  The block size is deliberately not a multiple of the byte
+alignment. */
+#define bpoolCREATED_POOL_BLOCK_SIZE		( 21 )
+#define bpoolCREATED_POOL_BLOCKS			( 64 )
+
+/* The size and number of blocks in the pool used by the exchange task and the
+interrupt. */
+#define bpoolEXCHANGE_POOL_BLOCK_SIZE		( sizeof( BlockPoolDemoMessage_t ) )
+#define bpoolEXCHANGE_POOL_BLOCKS			( 16 )
+
+/* The length of each queue, in items, not bytes. */
+#define bpoolQUEUE_LENGTH					( 4 )
+
+/* The interrupt sends a block to the task on every bpoolISR_SEND_PERIOD'th
+call. */
+#define bpoolISR_SEND_PERIOD				( 5 )
+
+/* The exchange task should receive at least one block from the interrupt
+within this time. */
+#define bpoolEXCHANGE_BLOCK_TIME			pdMS_TO_TICKS( 500 )
+
+/* A block time of 0 simply means "don't block". */
+#define bpoolDONT_BLOCK						( ( TickType_t ) 0 )
+
+#define bpoolTASK_STACK_SIZE				( configMINIMAL_STACK_SIZE * 2 )
+
+/*-----------------------------------------------------------*/
+
+/* The contents of the blocks passed between the exchange task and the
+interrupt. */
+typedef struct BLOCK_POOL_DEMO_MESSAGE
+{
+	uint32_t ulSequenceNumber;
+	uint32_t ulCheck;				/*<< Holds ~ulSequenceNumber. */
+} BlockPoolDemoMessage_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that repeatedly creates and deletes pools.
+ */
+static void prvBlockPoolCreatorTask( void *pvParameters );
+
+/*
+ * The task that exchanges blocks with vBlockPoolPeriodicISRTest().
+ */
+static void prvBlockPoolExchangeTask( void *pvParameters );
+
+/*
+ * Functions that create and delete a pool using statically and dynamically
+ * allocated memory respectively.
+ */
+static void prvCreateAndDeleteStaticallyAllocatedPool( void );
+static void prvCreateAndDeleteDynamicallyAllocatedPool( void );
+
+/*
+ * Checks the basic operation of a pool after it has been created.
+ */
+static void prvSanityCheckCreatedPool( BlockPoolHandle_t xPool );
+
+/*
+ * Utility function to create pseudo random numbers.
+ */
+static UBaseType_t prvRand( void );
+
+/*
+ * The creator task delays for a pseudo random time between cycles, as the
+ * task in StaticAllocation.c does.
+ */
+static TickType_t prvGetNextDelayTime( void );
+
+/*-----------------------------------------------------------*/
+
+/* The storage used by the statically allocated pools. */
+static StaticBlockPool_t xCreatedPoolBuffer, xExchangePoolBuffer;
+static uint8_t ucCreatedPoolStorage[ blockpoolSTORAGE_SIZE( bpoolCREATED_POOL_BLOCK_SIZE, bpoolCREATED_POOL_BLOCKS ) ];
+static uint8_t ucExchangePoolStorage[ blockpoolSTORAGE_SIZE( bpoolEXCHANGE_POOL_BLOCK_SIZE, bpoolEXCHANGE_POOL_BLOCKS ) ];
+
+/* The pool and queues used by the exchange task and the interrupt. */
+static BlockPoolHandle_t xExchangePool = NULL;
+static QueueHandle_t xToISRQueue = NULL, xFromISRQueue = NULL;
+
+/* Used by the pseudo random number generating function. */
+static uint32_t ulNextRand = 0;
+
+/* Used so a check task can ensure this test is still executing, and not
+stalled. */
+static volatile UBaseType_t uxCycleCounter = 0, uxExchangeCycleCounter = 0;
+
+/* A variable that gets set to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorOccurred = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartBlockPoolDemoTasks( void )
+{
+	xExchangePool = xBlockPoolCreateStatic( bpoolEXCHANGE_POOL_BLOCK_SIZE, bpoolEXCHANGE_POOL_BLOCKS, ucExchangePoolStorage, &xExchangePoolBuffer );
+	xToISRQueue = xQueueCreate( bpoolQUEUE_LENGTH, sizeof( BlockPoolDemoMessage_t * ) );
+	xFromISRQueue = xQueueCreate( bpoolQUEUE_LENGTH, sizeof( BlockPoolDemoMessage_t * ) );
+
+	configASSERT( xExchangePool );
+	configASSERT( xToISRQueue );
+	configASSERT( xFromISRQueue );
+
+	vQueueAddToRegistry( xToISRQueue, "BPool_ToISR" );
+	vQueueAddToRegistry( xFromISRQueue, "BPool_FromISR" );
+
+	xTaskCreate( prvBlockPoolCreatorTask, "BPCreate", bpoolTASK_STACK_SIZE, NULL, bpoolTASK_PRIORITY, NULL );
+	xTaskCreate( prvBlockPoolExchangeTask, "BPExch", bpoolTASK_STACK_SIZE, NULL, bpoolTASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockPoolCreatorTask( void *pvParameters )
+{
+	/* Avoid compiler warnings. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvCreateAndDeleteStaticallyAllocatedPool();
+
+		/* Delay to ensure lower priority tasks get CPU time, and increment the
+		cycle counter so a 'check' task can determine that this task is still
+		executing. */
+		vTaskDelay( prvGetNextDelayTime() );
+		uxCycleCounter++;
+
+		prvCreateAndDeleteDynamicallyAllocatedPool();
+		vTaskDelay( prvGetNextDelayTime() );
+		uxCycleCounter++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateAndDeleteStaticallyAllocatedPool( void )
+{
+BlockPoolHandle_t xPool;
+
+	/* Create the pool in the statically allocated buffers.  Nothing can be
+	allocated from the heap, so the handle cannot be NULL. */
+	xPool = xBlockPoolCreateStatic( bpoolCREATED_POOL_BLOCK_SIZE,
+									bpoolCREATED_POOL_BLOCKS,
+									ucCreatedPoolStorage,
+									&xCreatedPoolBuffer );
+
+	/* The pool handle is a pointer to the buffer that holds the pool
+	structure. */
+	configASSERT( xPool == ( BlockPoolHandle_t ) &xCreatedPoolBuffer );
+
+	prvSanityCheckCreatedPool( xPool );
+
+	/* Deleting a statically allocated pool does not free any memory. */
+	vBlockPoolDelete( xPool );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateAndDeleteDynamicallyAllocatedPool( void )
+{
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+BlockPoolHandle_t xPool;
+size_t xFreeHeapBefore;
+
+	xFreeHeapBefore = xPortGetFreeHeapSize();
+	xPool = xBlockPoolCreate( bpoolCREATED_POOL_BLOCK_SIZE, bpoolCREATED_POOL_BLOCKS );
+
+	if( xPool == NULL )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+	else
+	{
+		/* The pool structure and the blocks come from the heap in one
+		allocation, so the heap must have shrunk by at least the size of the
+		blocks.  Other tasks can use the heap at the same time, so the check
+		is only approximate. */
+		if( ( xFreeHeapBefore - xPortGetFreeHeapSize() ) < blockpoolSTORAGE_SIZE( bpoolCREATED_POOL_BLOCK_SIZE, bpoolCREATED_POOL_BLOCKS ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		prvSanityCheckCreatedPool( xPool );
+		vBlockPoolDelete( xPool );
+	}
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+static void prvSanityCheckCreatedPool( BlockPoolHandle_t xPool )
+{
+uint8_t *pucBlocks[ bpoolCREATED_POOL_BLOCKS ];
+BlockPoolStats_t xStats;
+UBaseType_t uxAllocated, uxBlock, uxCycle;
+size_t xByte;
+
+	vBlockPoolGetStats( xPool, &xStats );
+
+	if( ( xStats.xBlockSize < bpoolCREATED_POOL_BLOCK_SIZE ) ||
+		( xStats.uxNumberOfBlocks != bpoolCREATED_POOL_BLOCKS ) ||
+		( xStats.uxFreeBlocks != bpoolCREATED_POOL_BLOCKS ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* Allocate blocks until the pool is empty, filling each with a different
+	value. */
+	for( uxAllocated = 0; uxAllocated < bpoolCREATED_POOL_BLOCKS; uxAllocated++ )
+	{
+		pucBlocks[ uxAllocated ] = ( uint8_t * ) pvBlockPoolAllocate( xPool );
+
+		if( pucBlocks[ uxAllocated ] == NULL )
+		{
+			break;
+		}
+
+		memset( pucBlocks[ uxAllocated ], ( int ) uxAllocated, xStats.xBlockSize );
+	}
+
+	/* All the blocks are free, but this task is not pinned to a core, so on a
+	multicore build some may be in the magazine of a core this task is no
+	longer running on.  Between them the magazines never hold more than a
+	quarter of the blocks. */
+	if( uxAllocated < ( bpoolCREATED_POOL_BLOCKS - ( bpoolCREATED_POOL_BLOCKS / 4 ) ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* The pool should now be empty, as far as this core is concerned. */
+	if( uxAllocated == bpoolCREATED_POOL_BLOCKS )
+	{
+		if( pvBlockPoolAllocate( xPool ) != NULL )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+	}
+
+	/* If any two blocks overlapped, writing the second would have overwritten
+	the first. */
+	for( uxBlock = 0; uxBlock < uxAllocated; uxBlock++ )
+	{
+		for( xByte = 0; xByte < xStats.xBlockSize; xByte++ )
+		{
+			if( pucBlocks[ uxBlock ][ xByte ] != ( uint8_t ) uxBlock )
+			{
+				xErrorOccurred = pdTRUE;
+				break;
+			}
+		}
+	}
+
+	for( uxBlock = 0; uxBlock < uxAllocated; uxBlock++ )
+	{
+		vBlockPoolFree( xPool, pucBlocks[ uxBlock ] );
+	}
+
+	vBlockPoolGetStats( xPool, &xStats );
+
+	if( xStats.uxFreeBlocks != bpoolCREATED_POOL_BLOCKS )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+
+	/* Allocate and free a few blocks at a time, which on a multicore build
+	should mostly be served by the magazine of the core this task is running
+	on. */
+	for( uxCycle = 0; uxCycle < bpoolCREATED_POOL_BLOCKS; uxCycle++ )
+	{
+		uxAllocated = ( prvRand() % 4 ) + 1;
+
+		for( uxBlock = 0; uxBlock < uxAllocated; uxBlock++ )
+		{
+			pucBlocks[ uxBlock ] = ( uint8_t * ) pvBlockPoolAllocate( xPool );
+
+			if( pucBlocks[ uxBlock ] == NULL )
+			{
+				xErrorOccurred = pdTRUE;
+				break;
+			}
+		}
+
+		while( uxBlock > 0 )
+		{
+			uxBlock--;
+			vBlockPoolFree( xPool, pucBlocks[ uxBlock ] );
+		}
+	}
+
+	vBlockPoolGetStats( xPool, &xStats );
+
+	if( ( xStats.uxFreeBlocks != bpoolCREATED_POOL_BLOCKS ) || ( xStats.ulFailedAllocations > 1UL ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockPoolExchangeTask( void *pvParameters )
+{
+BlockPoolDemoMessage_t *pxMessage;
+uint32_t ulNextSequenceNumber = 0, ulExpectedSequenceNumber = 0;
+
+	/* Avoid compiler warnings. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Send a block to the interrupt.  If the queue is full the interrupt
+		has not caught up yet, so the block goes straight back to the pool. */
+		pxMessage = ( BlockPoolDemoMessage_t * ) pvBlockPoolAllocate( xExchangePool );
+
+		if( pxMessage != NULL )
+		{
+			pxMessage->ulSequenceNumber = ulNextSequenceNumber;
+			pxMessage->ulCheck = ~ulNextSequenceNumber;
+
+			if( xQueueSendToBack( xToISRQueue, &pxMessage, bpoolDONT_BLOCK ) == pdPASS )
+			{
+				ulNextSequenceNumber++;
+			}
+			else
+			{
+				vBlockPoolFree( xExchangePool, pxMessage );
+			}
+		}
+
+		/* Receive a block from the interrupt.  The interrupt numbers its
+		blocks in the same way. */
+		if( xQueueReceive( xFromISRQueue, &pxMessage, bpoolEXCHANGE_BLOCK_TIME ) == pdPASS )
+		{
+			if( ( pxMessage->ulCheck != ~( pxMessage->ulSequenceNumber ) ) ||
+				( pxMessage->ulSequenceNumber < ulExpectedSequenceNumber ) )
+			{
+				xErrorOccurred = pdTRUE;
+			}
+
+			ulExpectedSequenceNumber = pxMessage->ulSequenceNumber + 1;
+			vBlockPoolFree( xExchangePool, pxMessage );
+			uxExchangeCycleCounter++;
+		}
+		else
+		{
+			/* The interrupt should have sent something by now. */
+			xErrorOccurred = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolPeriodicISRTest( void )
+{
+static UBaseType_t uxCallCount = 0;
+static uint32_t ulNextSequenceNumber = 0, ulExpectedSequenceNumber = 0;
+BlockPoolDemoMessage_t *pxMessage;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* Called from the tick hook, so nothing can run until the scheduler has
+	started and the queues exist. */
+	if( xFromISRQueue == NULL )
+	{
+		return;
+	}
+
+	/* Check and free any block sent by the task.  The task numbers its blocks
+	consecutively, and they are never lost once queued. */
+	while( xQueueReceiveFromISR( xToISRQueue, &pxMessage, &xHigherPriorityTaskWoken ) == pdPASS )
+	{
+		if( ( pxMessage->ulSequenceNumber != ulExpectedSequenceNumber ) ||
+			( pxMessage->ulCheck != ~( pxMessage->ulSequenceNumber ) ) )
+		{
+			xErrorOccurred = pdTRUE;
+		}
+
+		ulExpectedSequenceNumber = pxMessage->ulSequenceNumber + 1;
+		vBlockPoolFree( xExchangePool, pxMessage );
+	}
+
+	uxCallCount++;
+
+	if( uxCallCount >= bpoolISR_SEND_PERIOD )
+	{
+		uxCallCount = 0;
+
+		/* Send a block to the task. */
+		pxMessage = ( BlockPoolDemoMessage_t * ) pvBlockPoolAllocate( xExchangePool );
+
+		if( pxMessage != NULL )
+		{
+			pxMessage->ulSequenceNumber = ulNextSequenceNumber;
+			pxMessage->ulCheck = ~ulNextSequenceNumber;
+			ulNextSequenceNumber++;
+
+			if( xQueueSendToBackFromISR( xFromISRQueue, &pxMessage, &xHigherPriorityTaskWoken ) != pdPASS )
+			{
+				vBlockPoolFree( xExchangePool, pxMessage );
+			}
+		}
+	}
+
+	/* Called from the tick hook, which does not return a yield request, so
+	xHigherPriorityTaskWoken is not used. */
+	( void ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvRand( void )
+{
+const uint32_t ulMultiplier = 0x015a4e35UL, ulIncrement = 1UL;
+
+	/* Utility function to generate a pseudo random number. */
+	ulNextRand = ( ulMultiplier * ulNextRand ) + ulIncrement;
+	return( ( ulNextRand >> 16UL ) & 0x7fffUL );
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetNextDelayTime( void )
+{
+TickType_t xNextDelay;
+const TickType_t xMaxDelay = pdMS_TO_TICKS( ( TickType_t ) 150 );
+const TickType_t xMinDelay = pdMS_TO_TICKS( ( TickType_t ) 75 );
+const TickType_t xTinyDelay = pdMS_TO_TICKS( ( TickType_t ) 2 );
+
+	/* Generate the next delay time.  This is kept within a narrow band so as
+	not to disturb the timing of other tests - but does add in some pseudo
+	randomisation into the tests. */
+	do
+	{
+		xNextDelay = prvRand() % xMaxDelay;
+
+		/* Just in case this loop is executed lots of times. */
+		vTaskDelay( xTinyDelay );
+
+	} while ( xNextDelay < xMinDelay );
+
+	return xNextDelay;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreBlockPoolDemoTasksStillRunning( void )
+{
+static UBaseType_t uxLastCycleCounter = 0, uxLastExchangeCycleCounter = 0;
+BaseType_t xReturn;
+
+	if( ( uxCycleCounter == uxLastCycleCounter ) || ( uxExchangeCycleCounter == uxLastExchangeCycleCounter ) )
+	{
+		xErrorOccurred = pdTRUE;
+	}
+	else
+	{
+		uxLastCycleCounter = uxCycleCounter;
+		uxLastExchangeCycleCounter = uxExchangeCycleCounter;
+	}
+
+	if( xErrorOccurred != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,327 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A copy service that moves large buffers using a DMA engine, so the CPU is
+ * free to run other tasks while the data moves.
+ *
+ * pvDMAMemCpy() and pvDMAMemSet() make transfers of fewer than
+ * dmacopyTHRESHOLD bytes on the CPU - below that size blocking and unblocking
+ * the calling task costs more than the copy.  For larger transfers the calling
+ * task claims a free DMA channel, starts the transfer through the port layer,
+ * then blocks on a direct to task notification that the DMA interrupt gives
+ * when the transfer ends.  The DMA engine only moves the part of the buffer
+ * that starts and ends on a dmacopyPORT_ALIGNMENT boundary in the destination
+ * - on ports where the data cache is not coherent with the DMA engine this is
+ * the cache line size, so no cache line is shared between the DMA engine and
+ * the CPU.  The CPU copies the unaligned head and tail while the DMA engine
+ * moves the rest.
+ *
+ * If no channel is free, or the DMA engine reports an error, the transfer is
+ * made on the CPU, so pvDMAMemCpy() and pvDMAMemSet() never fail.
+ *
+ * The port layer is described in DMACopy.h.  The task notification index used
+ * is dmacopyNOTIFICATION_INDEX.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "DMACopy.h"
+
+/* Transfers of fewer bytes than this are always made on the CPU. */
+#ifndef dmacopyTHRESHOLD
+	#define dmacopyTHRESHOLD			( 1024U )
+#endif
+
+/* The alignment the port layer needs for the destination of a DMA transfer,
+which must be a power of two.  Defined in FreeRTOSConfig.h by ports that need
+more than byte alignment. */
+#ifndef dmacopyPORT_ALIGNMENT
+	#define dmacopyPORT_ALIGNMENT		( 1U )
+#endif
+
+/* The task notification index used to wait for a transfer to complete.  As
+in TimerWheel.c the default uses the last index, so a task that calls
+pvDMAMemCpy() or pvDMAMemSet() must not use that index for anything else. */
+#ifndef dmacopyNOTIFICATION_INDEX
+	#define dmacopyNOTIFICATION_INDEX	( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#define dmacopyDONT_BLOCK				( ( TickType_t ) 0 )
+#define dmacopyNO_CHANNEL				( ( UBaseType_t ) ~0U )
+
+/*-----------------------------------------------------------*/
+
+/* The state of one DMA channel. */
+typedef struct DMACopyChannel
+{
+	TaskHandle_t xWaitingTask;			/*<< The task using the channel, or NULL if the channel is free. */
+	volatile BaseType_t xSucceeded;		/*<< Set by the interrupt when the transfer ends. */
+} DMACopyChannel_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Claim a free channel for the calling task.  Returns dmacopyNO_CHANNEL if
+ * every channel is in use.
+ */
+static UBaseType_t prvClaimChannel( void );
+
+/*
+ * Start the aligned middle of a transfer on a DMA channel, make the head and
+ * tail on the CPU, then wait for the DMA channel.  pvSource is NULL for a
+ * memset(), in which case ucValue is the value to write.  Returns pdFALSE if
+ * the transfer could not be made using DMA, in which case none of it has been
+ * made.
+ */
+static BaseType_t prvDMATransfer( uint8_t *pucDestination, const uint8_t *pucSource, uint8_t ucValue, size_t xLength );
+
+/*-----------------------------------------------------------*/
+
+static DMACopyChannel_t xChannels[ dmacopyMAX_CHANNELS ];
+static UBaseType_t uxNumberOfChannels = 0;
+static DMACopyStats_t xStats;
+
+/*-----------------------------------------------------------*/
+
+void vDMACopyInit( void )
+{
+	memset( xChannels, 0x00, sizeof( xChannels ) );
+	memset( &xStats, 0x00, sizeof( xStats ) );
+
+	uxNumberOfChannels = uxDMACopyPortInit();
+	configASSERT( uxNumberOfChannels <= dmacopyMAX_CHANNELS );
+}
+/*-----------------------------------------------------------*/
+
+void *pvDMAMemCpy( void *pvDestination, const void *pvSource, size_t xLength )
+{
+BaseType_t xUseCPU = pdTRUE;
+
+	if( ( xLength >= dmacopyTHRESHOLD ) && ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) )
+	{
+		if( prvDMATransfer( ( uint8_t * ) pvDestination, ( const uint8_t * ) pvSource, 0U, xLength ) != pdFALSE )
+		{
+			xUseCPU = pdFALSE;
+		}
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+		{
+			xStats.ulCPUTransfers++;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	if( xUseCPU != pdFALSE )
+	{
+		memcpy( pvDestination, pvSource, xLength );
+	}
+
+	return pvDestination;
+}
+/*-----------------------------------------------------------*/
+
+void *pvDMAMemSet( void *pvDestination, int iValue, size_t xLength )
+{
+BaseType_t xUseCPU = pdTRUE;
+
+	if( ( xLength >= dmacopyTHRESHOLD ) && ( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING ) )
+	{
+		if( prvDMATransfer( ( uint8_t * ) pvDestination, NULL, ( uint8_t ) iValue, xLength ) != pdFALSE )
+		{
+			xUseCPU = pdFALSE;
+		}
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+		{
+			xStats.ulCPUTransfers++;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	if( xUseCPU != pdFALSE )
+	{
+		memset( pvDestination, iValue, xLength );
+	}
+
+	return pvDestination;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDMATransfer( uint8_t *pucDestination, const uint8_t *pucSource, uint8_t ucValue, size_t xLength )
+{
+UBaseType_t uxChannel;
+size_t xHead, xBody, xTail;
+BaseType_t xStarted, xReturn = pdFALSE;
+
+	/* Split the transfer into a head and tail made on the CPU and an aligned
+	body made by the DMA engine. */
+	xHead = ( dmacopyPORT_ALIGNMENT - ( ( size_t ) pucDestination & ( dmacopyPORT_ALIGNMENT - 1U ) ) ) & ( dmacopyPORT_ALIGNMENT - 1U );
+
+	if( xHead > xLength )
+	{
+		xHead = xLength;
+	}
+
+	xBody = ( xLength - xHead ) & ~( ( size_t ) dmacopyPORT_ALIGNMENT - 1U );
+	xTail = xLength - xHead - xBody;
+
+	if( xBody < dmacopyTHRESHOLD )
+	{
+		/* After alignment not enough is left to be worth moving by DMA. */
+		uxChannel = dmacopyNO_CHANNEL;
+	}
+	else
+	{
+		uxChannel = prvClaimChannel();
+	}
+
+	if( uxChannel != dmacopyNO_CHANNEL )
+	{
+		/* Clear any stale notification before starting the transfer. */
+		( void ) ulTaskNotifyTakeIndexed( dmacopyNOTIFICATION_INDEX, pdTRUE, dmacopyDONT_BLOCK );
+
+		if( pucSource != NULL )
+		{
+			xStarted = xDMACopyPortStartCopy( uxChannel, pucDestination + xHead, pucSource + xHead, xBody );
+		}
+		else
+		{
+			xStarted = xDMACopyPortStartSet( uxChannel, pucDestination + xHead, ucValue, xBody );
+		}
+
+		if( xStarted != pdFALSE )
+		{
+			/* Make the head and tail while the DMA engine makes the body. */
+			if( pucSource != NULL )
+			{
+				memcpy( pucDestination, pucSource, xHead );
+				memcpy( pucDestination + xHead + xBody, pucSource + xHead + xBody, xTail );
+			}
+			else
+			{
+				memset( pucDestination, ucValue, xHead );
+				memset( pucDestination + xHead + xBody, ucValue, xTail );
+			}
+
+			/* The DMA engine is writing into the caller's buffer, so there is
+			no safe way to give up waiting. */
+			( void ) ulTaskNotifyTakeIndexed( dmacopyNOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+			vDMACopyPortEndTransfer( uxChannel, pucDestination + xHead, xBody );
+
+			xReturn = xChannels[ uxChannel ].xSucceeded;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( xReturn != pdFALSE )
+			{
+				xStats.ulDMATransfers++;
+				xStats.ulDMABytes += ( uint32_t ) xBody;
+			}
+			else
+			{
+				xStats.ulFailedTransfers++;
+			}
+
+			/* Release the channel. */
+			xChannels[ uxChannel ].xWaitingTask = NULL;
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+		{
+			if( xBody < dmacopyTHRESHOLD )
+			{
+				xStats.ulCPUTransfers++;
+			}
+			else
+			{
+				xStats.ulChannelBusyTransfers++;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvClaimChannel( void )
+{
+UBaseType_t uxChannel, uxReturn = dmacopyNO_CHANNEL;
+
+	taskENTER_CRITICAL();
+	{
+		for( uxChannel = 0; uxChannel < uxNumberOfChannels; uxChannel++ )
+		{
+			if( xChannels[ uxChannel ].xWaitingTask == NULL )
+			{
+				xChannels[ uxChannel ].xWaitingTask = xTaskGetCurrentTaskHandle();
+				xChannels[ uxChannel ].xSucceeded = pdFALSE;
+				uxReturn = uxChannel;
+				break;
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vDMACopyTransferCompleteFromISR( UBaseType_t uxChannel, BaseType_t xSucceeded, BaseType_t *pxHigherPriorityTaskWoken )
+{
+	configASSERT( uxChannel < uxNumberOfChannels );
+	configASSERT( xChannels[ uxChannel ].xWaitingTask != NULL );
+
+	xChannels[ uxChannel ].xSucceeded = xSucceeded;
+	vTaskNotifyGiveIndexedFromISR( xChannels[ uxChannel ].xWaitingTask, dmacopyNOTIFICATION_INDEX, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vDMACopyGetStats( DMACopyStats_t *pxStats )
+{
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
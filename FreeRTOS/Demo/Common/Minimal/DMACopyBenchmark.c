@@ -0,0 +1,373 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares copying a buffer using memcpy() with copying it using
+ * pvDMAMemCpy(), as implemented in DMACopy.c.
+ *
+ * A copier task copies a dmabenchBUFFER_SIZE byte buffer as fast as it can,
+ * and a background task one priority lower increments a counter as fast as
+ * it can.  On a multicore build both tasks are pinned to the same core.  The
+ * background task only runs while the copier is blocked, so its count is a
+ * measure of the CPU time the copy method leaves to other tasks.  A higher
+ * priority controller task runs the background task on its own for
+ * dmabenchMEASUREMENT_PERIOD ticks to get a baseline count, then runs both
+ * tasks for the same time with the copier using memcpy(), then again with the
+ * copier using pvDMAMemCpy(), and records for each copy method:
+ *
+ * + Throughput - the number of bytes copied per second.
+ * + The mean time taken by one copy.
+ * + CPU availability - the background task's count as a percentage of the
+ *   baseline count.
+ *
+ * At the end of each measurement the copier checks the destination matches
+ * the source, and after the pvDMAMemCpy() measurement it also checks
+ * pvDMAMemSet().  An error is latched if either check fails.
+ *
+ * vStartDMACopyBenchmarkTasks() calls vDMACopyInit().
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "DMACopy.h"
+#include "DMACopyBenchmark.h"
+
+#ifndef dmabenchBUFFER_SIZE
+	#define dmabenchBUFFER_SIZE				( 4096 )
+#endif
+
+/* The time for which each copy method is measured. */
+#define dmabenchMEASUREMENT_PERIOD			pdMS_TO_TICKS( 500UL )
+
+#ifndef dmabenchTASK_STACK_SIZE
+	#define dmabenchTASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/* The value pvDMAMemSet() is checked with. */
+#define dmabenchSET_VALUE					( 0xA5 )
+
+/* The copy methods, plus the baseline measurement in which no copies are
+made. */
+#define dmabenchNO_COPY						( 0 )
+#define dmabenchCPU_COPY					( 1 )
+#define dmabenchDMA_COPY					( 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The controller, copier and background tasks, as described at the top of
+ * this file.
+ */
+static void prvDMACopyBenchmarkControllerTask( void *pvParameters );
+static void prvDMACopyBenchmarkCopierTask( void *pvParameters );
+static void prvDMACopyBenchmarkBackgroundTask( void *pvParameters );
+
+/*
+ * Run the background task, and the copier using xMethod unless xMethod is
+ * dmabenchNO_COPY, for one measurement period.  Returns the background task's
+ * count.
+ */
+static uint32_t prvMeasure( BaseType_t xMethod );
+
+/*
+ * Check the copier's destination buffer after a measurement.
+ */
+static void prvCheckCopy( BaseType_t xMethod );
+
+/*-----------------------------------------------------------*/
+
+/* The copier's buffers, as words so they are at least word aligned. */
+static uint32_t ulSource[ dmabenchBUFFER_SIZE / sizeof( uint32_t ) ];
+static uint32_t ulDestination[ dmabenchBUFFER_SIZE / sizeof( uint32_t ) ];
+
+/* Used to start and end each measurement. */
+static SemaphoreHandle_t xCopierStartSemaphore = NULL, xBackgroundStartSemaphore = NULL, xDoneSemaphore = NULL;
+static volatile BaseType_t xStopRequested = pdFALSE;
+static volatile BaseType_t xCopyMethod = dmabenchNO_COPY;
+
+/* Written by the copier and background tasks during a measurement, and read
+by the controller after. */
+static volatile uint32_t ulCopies = 0, ulBackgroundLoops = 0;
+
+/* The most recent results. */
+static DMACopyBenchmarkResult_t xCPUResult, xDMAResult;
+static uint32_t ulRunCount = 0;
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartDMACopyBenchmarkTasks( UBaseType_t uxPriority )
+{
+TaskHandle_t xCopierTask, xBackgroundTask;
+
+	/* The background task runs one priority below the copier. */
+	configASSERT( uxPriority > tskIDLE_PRIORITY );
+
+	vDMACopyInit();
+
+	xCopierStartSemaphore = xSemaphoreCreateBinary();
+	xBackgroundStartSemaphore = xSemaphoreCreateBinary();
+	xDoneSemaphore = xSemaphoreCreateCounting( 2, 0 );
+
+	configASSERT( xCopierStartSemaphore );
+	configASSERT( xBackgroundStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	xTaskCreate( prvDMACopyBenchmarkCopierTask, "DBCopy", dmabenchTASK_STACK_SIZE, NULL, uxPriority, &xCopierTask );
+	xTaskCreate( prvDMACopyBenchmarkBackgroundTask, "DBBack", dmabenchTASK_STACK_SIZE, NULL, uxPriority - 1, &xBackgroundTask );
+
+	#if( configUSE_CORE_AFFINITY == 1 ) && ( configNUM_CORES > 1 )
+	{
+		/* Both tasks on the same core, so the background task only gets the
+		CPU time the copier leaves. */
+		vTaskCoreAffinitySet( xCopierTask, ( UBaseType_t ) 1 );
+		vTaskCoreAffinitySet( xBackgroundTask, ( UBaseType_t ) 1 );
+	}
+	#else
+	{
+		( void ) xCopierTask;
+		( void ) xBackgroundTask;
+	}
+	#endif
+
+	xTaskCreate( prvDMACopyBenchmarkControllerTask, "DBCtrl", dmabenchTASK_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDMACopyBenchmarkControllerTask( void *pvParameters )
+{
+DMACopyBenchmarkResult_t xResults[ 2 ];
+uint32_t ulBaseline, ulLoops;
+BaseType_t xMethod;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulBaseline = prvMeasure( dmabenchNO_COPY );
+
+		for( xMethod = dmabenchCPU_COPY; xMethod <= dmabenchDMA_COPY; xMethod++ )
+		{
+			ulLoops = prvMeasure( xMethod );
+
+			xResults[ xMethod - dmabenchCPU_COPY ].ulBytesPerSecond = ( uint32_t ) ( ( ( uint64_t ) ulCopies * dmabenchBUFFER_SIZE * configTICK_RATE_HZ ) / dmabenchMEASUREMENT_PERIOD );
+			xResults[ xMethod - dmabenchCPU_COPY ].ulMeanCopyTime = ( ulCopies > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) dmabenchMEASUREMENT_PERIOD * 1000000ULL ) / ( ( uint64_t ) configTICK_RATE_HZ * ulCopies ) ) : 0UL;
+			xResults[ xMethod - dmabenchCPU_COPY ].ulCPUAvailable = ( ulBaseline > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) ulLoops * 100ULL ) / ulBaseline ) : 0UL;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			xCPUResult = xResults[ 0 ];
+			xDMAResult = xResults[ 1 ];
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMeasure( BaseType_t xMethod )
+{
+BaseType_t xTasks = 1;
+
+	/* The copier and background tasks are blocked on their start semaphores,
+	so nothing else is accessing these variables. */
+	ulCopies = 0;
+	ulBackgroundLoops = 0;
+	xCopyMethod = xMethod;
+	xStopRequested = pdFALSE;
+
+	xSemaphoreGive( xBackgroundStartSemaphore );
+
+	if( xMethod != dmabenchNO_COPY )
+	{
+		xSemaphoreGive( xCopierStartSemaphore );
+		xTasks++;
+	}
+
+	vTaskDelay( dmabenchMEASUREMENT_PERIOD );
+	xStopRequested = pdTRUE;
+
+	while( xTasks > 0 )
+	{
+		xSemaphoreTake( xDoneSemaphore, portMAX_DELAY );
+		xTasks--;
+	}
+
+	ulLoopCounter++;
+
+	return ulBackgroundLoops;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDMACopyBenchmarkCopierTask( void *pvParameters )
+{
+uint32_t ulFill = 0;
+size_t x;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xSemaphoreTake( xCopierStartSemaphore, portMAX_DELAY );
+
+		/* A different pattern for each measurement, so a copy that did not
+		happen is not hidden by the data left from the last measurement. */
+		ulFill++;
+
+		for( x = 0; x < ( sizeof( ulSource ) / sizeof( ulSource[ 0 ] ) ); x++ )
+		{
+			ulSource[ x ] = ( ulFill << 16 ) ^ ( uint32_t ) x;
+		}
+
+		memset( ulDestination, 0x00, sizeof( ulDestination ) );
+
+		while( xStopRequested == pdFALSE )
+		{
+			if( xCopyMethod == dmabenchDMA_COPY )
+			{
+				( void ) pvDMAMemCpy( ulDestination, ulSource, sizeof( ulSource ) );
+			}
+			else
+			{
+				( void ) memcpy( ulDestination, ulSource, sizeof( ulSource ) );
+			}
+
+			ulCopies++;
+		}
+
+		prvCheckCopy( xCopyMethod );
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckCopy( BaseType_t xMethod )
+{
+uint8_t *pucDestination = ( uint8_t * ) ulDestination;
+const uint8_t *pucSource = ( const uint8_t * ) ulSource;
+size_t x;
+
+	if( memcmp( ulDestination, ulSource, sizeof( ulSource ) ) != 0 )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	if( xMethod == dmabenchDMA_COPY )
+	{
+		/* Start and end part way through a word so the head and tail are
+		also checked. */
+		( void ) pvDMAMemSet( &( pucDestination[ 1 ] ), dmabenchSET_VALUE, sizeof( ulDestination ) - 2 );
+
+		if( ( pucDestination[ 0 ] != pucSource[ 0 ] ) ||
+			( pucDestination[ sizeof( ulDestination ) - 1 ] != pucSource[ sizeof( ulSource ) - 1 ] ) )
+		{
+			/* The set wrote outside the buffer it was given. */
+			xErrorDetected = pdTRUE;
+		}
+
+		for( x = 1; x < ( sizeof( ulDestination ) - 1 ); x++ )
+		{
+			if( pucDestination[ x ] != ( uint8_t ) dmabenchSET_VALUE )
+			{
+				xErrorDetected = pdTRUE;
+				break;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDMACopyBenchmarkBackgroundTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xSemaphoreTake( xBackgroundStartSemaphore, portMAX_DELAY );
+
+		while( xStopRequested == pdFALSE )
+		{
+			ulBackgroundLoops++;
+		}
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetDMACopyBenchmarkResults( DMACopyBenchmarkResult_t *pxCPU, DMACopyBenchmarkResult_t *pxDMA, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxCPU = xCPUResult;
+		*pxDMA = xDMAResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreDMACopyBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
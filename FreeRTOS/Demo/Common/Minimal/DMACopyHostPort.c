@@ -0,0 +1,227 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A port layer for DMACopy.c for builds that run on a host, such as the
+ * FreeRTOS POSIX (Linux simulator) port, so the copy service can be tested
+ * without DMA hardware.  Each "DMA channel" is a host worker thread that
+ * makes the transfer with memcpy() or memset() while the calling task is
+ * blocked.
+ *
+ * The worker threads are not FreeRTOS threads, so they must not call the
+ * FreeRTOS API.  Instead they mark their transfer as complete, and
+ * vDMACopyHostPortTickHook() - which must be called from the tick hook, so it
+ * runs in the same context as an interrupt would - reports completed transfers
+ * to the copy service.  A transfer therefore completes on the tick after the
+ * worker thread finishes it.
+ *
+ * HostTest/DMACopyTest.c builds the copy service with this layer.
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "DMACopy.h"
+
+/* The number of worker threads, and so channels. */
+#ifndef dmacopyHOST_CHANNELS
+	#define dmacopyHOST_CHANNELS		dmacopyMAX_CHANNELS
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The state of one worker thread. */
+typedef struct DMACopyHostChannel
+{
+	pthread_t xThread;
+	pthread_mutex_t xMutex;
+	pthread_cond_t xCondition;
+	uint8_t *pucDestination;
+	const uint8_t *pucSource;		/*<< NULL for a memset(). */
+	uint8_t ucValue;
+	size_t xLength;
+	BaseType_t xPending;			/*<< Set when a transfer is started, cleared by the worker thread. */
+	volatile BaseType_t xComplete;	/*<< Set by the worker thread, cleared by the tick hook. */
+} DMACopyHostChannel_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The worker thread that makes transfers for one channel.
+ */
+static void *prvDMACopyWorker( void *pvParameters );
+
+/*
+ * Hand a transfer to a worker thread.
+ */
+static BaseType_t prvStartTransfer( UBaseType_t uxChannel, uint8_t *pucDestination, const uint8_t *pucSource, uint8_t ucValue, size_t xLength );
+
+/*-----------------------------------------------------------*/
+
+static DMACopyHostChannel_t xHostChannels[ dmacopyHOST_CHANNELS ];
+static UBaseType_t uxHostChannels = 0;
+
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxDMACopyPortInit( void )
+{
+UBaseType_t uxChannel;
+
+	/* Only create the worker threads once, even if the service is reset. */
+	if( uxHostChannels == 0 )
+	{
+		for( uxChannel = 0; uxChannel < dmacopyHOST_CHANNELS; uxChannel++ )
+		{
+			memset( &( xHostChannels[ uxChannel ] ), 0x00, sizeof( DMACopyHostChannel_t ) );
+			pthread_mutex_init( &( xHostChannels[ uxChannel ].xMutex ), NULL );
+			pthread_cond_init( &( xHostChannels[ uxChannel ].xCondition ), NULL );
+
+			if( pthread_create( &( xHostChannels[ uxChannel ].xThread ), NULL, prvDMACopyWorker, &( xHostChannels[ uxChannel ] ) ) != 0 )
+			{
+				break;
+			}
+		}
+
+		uxHostChannels = uxChannel;
+	}
+
+	return uxHostChannels;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDMACopyPortStartCopy( UBaseType_t uxChannel, void *pvDestination, const void *pvSource, size_t xLength )
+{
+	return prvStartTransfer( uxChannel, ( uint8_t * ) pvDestination, ( const uint8_t * ) pvSource, 0U, xLength );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDMACopyPortStartSet( UBaseType_t uxChannel, void *pvDestination, uint8_t ucValue, size_t xLength )
+{
+	return prvStartTransfer( uxChannel, ( uint8_t * ) pvDestination, NULL, ucValue, xLength );
+}
+/*-----------------------------------------------------------*/
+
+void vDMACopyPortEndTransfer( UBaseType_t uxChannel, void *pvDestination, size_t xLength )
+{
+	/* Nothing to do - the host caches are coherent. */
+	( void ) uxChannel;
+	( void ) pvDestination;
+	( void ) xLength;
+}
+/*-----------------------------------------------------------*/
+
+void vDMACopyHostPortTickHook( void )
+{
+UBaseType_t uxChannel;
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	for( uxChannel = 0; uxChannel < uxHostChannels; uxChannel++ )
+	{
+		if( __atomic_load_n( &( xHostChannels[ uxChannel ].xComplete ), __ATOMIC_ACQUIRE ) != pdFALSE )
+		{
+			__atomic_store_n( &( xHostChannels[ uxChannel ].xComplete ), pdFALSE, __ATOMIC_RELAXED );
+			vDMACopyTransferCompleteFromISR( uxChannel, pdTRUE, &xHigherPriorityTaskWoken );
+		}
+	}
+
+	/* The tick interrupt performs any context switch the tick hook needs, so
+	xHigherPriorityTaskWoken is not used. */
+	( void ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartTransfer( UBaseType_t uxChannel, uint8_t *pucDestination, const uint8_t *pucSource, uint8_t ucValue, size_t xLength )
+{
+DMACopyHostChannel_t *pxChannel;
+
+	configASSERT( uxChannel < uxHostChannels );
+	pxChannel = &( xHostChannels[ uxChannel ] );
+
+	pthread_mutex_lock( &( pxChannel->xMutex ) );
+	{
+		configASSERT( pxChannel->xPending == pdFALSE );
+
+		pxChannel->pucDestination = pucDestination;
+		pxChannel->pucSource = pucSource;
+		pxChannel->ucValue = ucValue;
+		pxChannel->xLength = xLength;
+		pxChannel->xPending = pdTRUE;
+		pthread_cond_signal( &( pxChannel->xCondition ) );
+	}
+	pthread_mutex_unlock( &( pxChannel->xMutex ) );
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvDMACopyWorker( void *pvParameters )
+{
+DMACopyHostChannel_t *pxChannel = ( DMACopyHostChannel_t * ) pvParameters;
+sigset_t xSignals;
+
+	/* The POSIX port uses signals for the tick and to suspend threads, which
+	must only be delivered to FreeRTOS threads. */
+	sigfillset( &xSignals );
+	pthread_sigmask( SIG_SETMASK, &xSignals, NULL );
+
+	for( ;; )
+	{
+		pthread_mutex_lock( &( pxChannel->xMutex ) );
+		{
+			while( pxChannel->xPending == pdFALSE )
+			{
+				pthread_cond_wait( &( pxChannel->xCondition ), &( pxChannel->xMutex ) );
+			}
+
+			if( pxChannel->pucSource != NULL )
+			{
+				memcpy( pxChannel->pucDestination, pxChannel->pucSource, pxChannel->xLength );
+			}
+			else
+			{
+				memset( pxChannel->pucDestination, pxChannel->ucValue, pxChannel->xLength );
+			}
+
+			pxChannel->xPending = pdFALSE;
+		}
+		pthread_mutex_unlock( &( pxChannel->xMutex ) );
+
+		/* Publish the data before the tick hook can see the transfer as
+		complete. */
+		__atomic_store_n( &( pxChannel->xComplete ), pdTRUE, __ATOMIC_RELEASE );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
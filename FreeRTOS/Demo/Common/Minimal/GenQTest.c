@@ -33,6 +33,10 @@
  *
  * See the comments above the prvSendFrontAndBackTest() and
  * prvLowPriorityMutexTask() prototypes below for more information.
+ *
+ * Setting genqUSE_MUTEX_PROFILER to 1 takes the mutexes through
+ * MutexProfiler.c, which records contention and priority inheritance
+ * statistics for the mutex that is in the queue registry.
  */
 
 /* Standard includes. */
@@ -47,6 +51,20 @@
 /* Demo program include files. */
 #include "GenQTest.h"
 
+#ifndef genqUSE_MUTEX_PROFILER
+	#define genqUSE_MUTEX_PROFILER 0
+#endif
+
+#if( genqUSE_MUTEX_PROFILER == 1 )
+	#include "MutexProfiler.h"
+
+	/* Take semaphores through the profiler, which keeps statistics for the
+	mutexes that are in the queue registry.  Other semaphores are passed
+	straight through. */
+	#undef xSemaphoreTake
+	#define xSemaphoreTake( xSemaphore, xBlockTime )	xMutexProfilerTake( ( xSemaphore ), ( xBlockTime ) )
+#endif
+
 #define genqQUEUE_LENGTH		( 5 )
 #define intsemNO_BLOCK			( 0 )
 #define genqSHORT_BLOCK			( pdMS_TO_TICKS( 2 ) )
@@ -0,0 +1,659 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures the latency of pvPortMalloc() and vPortFree(), and the
+ * fragmentation of the heap, while several tasks allocate and free memory
+ * concurrently.  The same file is built against whichever heap the demo links
+ * - comparing builds that link different heaps (heap_4.c and heap_tlsf.c for
+ * example) shows which suits the application.
+ *
+ * heapbenchNUM_WORKERS worker tasks each own heapbenchSLOTS pointers.  On each
+ * operation a worker picks a slot at random - if the slot holds a block it is
+ * checked and freed, otherwise a block of random size is allocated into it and
+ * filled with a pattern.  Most requests are small, with a tail of larger ones,
+ * similar to the mix of queue storage, message payloads and task stacks an
+ * application allocates.  On a multicore build there is one worker per core,
+ * each pinned to its core, so the allocator is used from both cores at once.
+ *
+ * A higher priority controller task starts the workers, then samples the
+ * fragmentation of the heap every heapbenchSAMPLE_PERIOD until they have each
+ * performed heapbenchOPERATIONS_PER_RUN operations, after which it publishes
+ * the results and starts another run.  The workers free everything they hold
+ * at the end of each run.
+ *
+ * Fragmentation is the proportion of the free space that is not in the
+ * largest free block, in parts per thousand, as obtained from
+ * vPortGetHeapStats().  heap_1.c does not provide vPortGetHeapStats() and
+ * cannot free memory, so to build against heap_1.c set heapbenchUSE_HEAP_STATS
+ * and heapbenchFREE_MEMORY to 0.  The benchmark then performs a single run in
+ * which the workers only allocate, filling their slots once.
+ *
+ * A heap that holds freed blocks in a per-core cache, such as heap_tlsf.c,
+ * counts the cached blocks as free, but does not merge them with their
+ * neighbours until they leave the cache - so the fragmentation would partly
+ * measure the caches.  Building against such a heap with
+ * heapbenchFLUSH_HEAP_CACHE set to 1 has each worker call
+ * vPortFlushHeapCache() on its own core before each sample is taken, and again
+ * at the end of each run, so the samples measure the allocator itself.
+ *
+ * An error is latched if the pattern written into a block has changed when the
+ * block is freed.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.  Nothing
+ * in this file is specific to a port, so it can also be run in a host build.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "HeapBenchmark.h"
+
+/* Set to 0 when the heap does not implement vPortGetHeapStats(). */
+#ifndef heapbenchUSE_HEAP_STATS
+	#define heapbenchUSE_HEAP_STATS			1
+#endif
+
+/* Set to 0 when the heap cannot free memory. */
+#ifndef heapbenchFREE_MEMORY
+	#define heapbenchFREE_MEMORY			1
+#endif
+
+/* Set to 1 when the heap caches freed blocks and provides
+vPortFlushHeapCache() - see the comments at the top of this file. */
+#ifndef heapbenchFLUSH_HEAP_CACHE
+	#define heapbenchFLUSH_HEAP_CACHE		0
+#endif
+
+#ifndef heapbenchSLOTS
+	#define heapbenchSLOTS					32
+#endif
+
+#ifndef heapbenchOPERATIONS_PER_RUN
+	#define heapbenchOPERATIONS_PER_RUN		( 20000UL )
+#endif
+
+/* The ranges of the request sizes, and the percentage of requests that are
+small and medium.  The rest are large. */
+#define heapbenchSMALL_MAX					( 64UL )
+#define heapbenchMEDIUM_MAX					( 512UL )
+#define heapbenchLARGE_MAX					( 2048UL )
+#define heapbenchSMALL_PERCENT				( 70UL )
+#define heapbenchMEDIUM_PERCENT				( 25UL )
+
+#define heapbenchSAMPLE_PERIOD				pdMS_TO_TICKS( 10UL )
+
+#ifdef configNUM_CORES
+	#define heapbenchNUM_WORKERS			configNUM_CORES
+#else
+	#define heapbenchNUM_WORKERS			1
+#endif
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define heapbenchGET_TIME()				( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define heapbenchGET_TIME()				( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef heapbenchTASK_STACK_SIZE
+	#define heapbenchTASK_STACK_SIZE		configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The measurements made by one worker during a run. */
+typedef struct HEAP_BENCHMARK_WORKER_RESULT
+{
+	uint32_t ulMallocLatency[ heapbenchLATENCY_BUCKETS ];
+	uint32_t ulFreeLatency[ heapbenchLATENCY_BUCKETS ];
+	uint32_t ulMallocs;
+	uint32_t ulFrees;
+	uint32_t ulTotalMallocLatency;
+	uint32_t ulTotalFreeLatency;
+	uint32_t ulMaxMallocLatency;
+	uint32_t ulMaxFreeLatency;
+	uint32_t ulFailedAllocations;
+} HeapBenchmarkWorkerResult_t;
+
+/*
+ * The controller and worker tasks, as described at the top of this file.
+ */
+static void prvHeapBenchmarkControllerTask( void *pvParameters );
+static void prvHeapBenchmarkWorkerTask( void *pvParameters );
+
+/*
+ * Add a latency to a histogram and its total and maximum.
+ */
+static void prvRecordLatency( uint32_t ulLatency, uint32_t *pulHistogram, uint32_t *pulTotal, uint32_t *pulMax );
+
+/*
+ * Return the size of the next request, using the worker's random number
+ * generator.
+ */
+static size_t prvNextRequestSize( uint32_t *pulSeed );
+
+/*
+ * Check the pattern written into a block, then free it.
+ */
+static void prvCheckAndFree( BaseType_t xWorker, uint8_t *pucBlock, size_t xSize, HeapBenchmarkWorkerResult_t *pxResult );
+
+#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+
+	/*
+	 * Provided by the heap.  Returns the blocks cached by the calling core to
+	 * the heap.
+	 */
+	extern void vPortFlushHeapCache( void );
+
+	/*
+	 * Ask each worker that is part way through a run to flush its core's heap
+	 * cache, and wait until they have.  Called by the controller before it
+	 * samples the heap.
+	 */
+	static void prvFlushWorkerCaches( void );
+
+	/*
+	 * Called by a worker to flush its core's heap cache, and clear its bit in
+	 * uxFlushRequests.  Workers that have finished the run also clear their bit
+	 * in uxRunningWorkers.
+	 */
+	static void prvWorkerFlushCache( UBaseType_t uxWorkerBit, BaseType_t xRunComplete );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Used to start the workers and signal the end of each run. */
+static SemaphoreHandle_t xStartSemaphore = NULL, xDoneSemaphore = NULL;
+
+/* Written by each worker during a run, and read by the controller after. */
+static HeapBenchmarkWorkerResult_t xWorkerResults[ heapbenchNUM_WORKERS ];
+
+/* The most recent results. */
+static HeapBenchmarkResult_t xLastResult;
+static uint32_t ulRunCount = 0;
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a run completes so the check task can see the
+benchmark is still running.  Set xBenchmarkComplete if there will be no more
+runs. */
+static volatile uint32_t ulLoopCounter = 0;
+static volatile BaseType_t xBenchmarkComplete = pdFALSE;
+
+#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+
+	/* One bit per worker - set in uxRunningWorkers while the worker is part
+	way through a run, and in uxFlushRequests when the controller is waiting
+	for the worker to flush its core's heap cache. */
+	static volatile UBaseType_t uxRunningWorkers = 0, uxFlushRequests = 0;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartHeapBenchmarkTasks( UBaseType_t uxPriority )
+{
+BaseType_t xWorker;
+TaskHandle_t xWorkerTask;
+
+	xStartSemaphore = xSemaphoreCreateCounting( heapbenchNUM_WORKERS, 0 );
+	xDoneSemaphore = xSemaphoreCreateCounting( heapbenchNUM_WORKERS, 0 );
+
+	configASSERT( xStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	for( xWorker = 0; xWorker < heapbenchNUM_WORKERS; xWorker++ )
+	{
+		xTaskCreate( prvHeapBenchmarkWorkerTask, "HBWork", heapbenchTASK_STACK_SIZE, ( void * ) xWorker, uxPriority, &xWorkerTask );
+
+		#if( configUSE_CORE_AFFINITY == 1 ) && ( heapbenchNUM_WORKERS > 1 )
+		{
+			/* One worker on each core, so the heap is used from all the cores
+			at the same time. */
+			vTaskCoreAffinitySet( xWorkerTask, ( UBaseType_t ) 1 << xWorker );
+		}
+		#else
+		{
+			( void ) xWorkerTask;
+		}
+		#endif
+	}
+
+	xTaskCreate( prvHeapBenchmarkControllerTask, "HBCtrl", heapbenchTASK_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapBenchmarkControllerTask( void *pvParameters )
+{
+HeapBenchmarkResult_t xResult;
+BaseType_t xWorker, xWorkersDone;
+uint32_t ulStartTime, ulElapsed, ulOperations, ulMallocs, ulFrees, ulTotalMallocLatency, ulTotalFreeLatency;
+uint32_t ulSamples, ulTotalFragmentation, ulFragmentation, ulBucket;
+HeapBenchmarkWorkerResult_t *pxWorkerResult;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		memset( &xResult, 0x00, sizeof( xResult ) );
+		memset( xWorkerResults, 0x00, sizeof( xWorkerResults ) );
+		ulSamples = 0;
+		ulTotalFragmentation = 0;
+		ulStartTime = heapbenchGET_TIME();
+
+		for( xWorker = 0; xWorker < heapbenchNUM_WORKERS; xWorker++ )
+		{
+			xSemaphoreGive( xStartSemaphore );
+		}
+
+		/* Sample the fragmentation while waiting for the workers. */
+		xWorkersDone = 0;
+
+		while( xWorkersDone < heapbenchNUM_WORKERS )
+		{
+			if( xSemaphoreTake( xDoneSemaphore, heapbenchSAMPLE_PERIOD ) == pdPASS )
+			{
+				xWorkersDone++;
+			}
+			else
+			{
+				#if( heapbenchUSE_HEAP_STATS == 1 )
+				{
+				HeapStats_t xHeapStats;
+
+					#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+					{
+						prvFlushWorkerCaches();
+					}
+					#endif
+
+					vPortGetHeapStats( &xHeapStats );
+
+					if( xHeapStats.xAvailableHeapSpaceInBytes > 0 )
+					{
+						ulFragmentation = 1000UL - ( uint32_t ) ( ( ( uint64_t ) xHeapStats.xSizeOfLargestFreeBlockInBytes * 1000ULL ) / xHeapStats.xAvailableHeapSpaceInBytes );
+						ulTotalFragmentation += ulFragmentation;
+						ulSamples++;
+
+						if( ulFragmentation > xResult.ulMaxFragmentation )
+						{
+							xResult.ulMaxFragmentation = ulFragmentation;
+						}
+					}
+				}
+				#else
+				{
+					( void ) ulFragmentation;
+				}
+				#endif
+			}
+		}
+
+		ulElapsed = heapbenchGET_TIME() - ulStartTime;
+
+		/* Combine the results of the workers. */
+		ulMallocs = 0;
+		ulFrees = 0;
+		ulTotalMallocLatency = 0;
+		ulTotalFreeLatency = 0;
+
+		for( xWorker = 0; xWorker < heapbenchNUM_WORKERS; xWorker++ )
+		{
+			pxWorkerResult = &( xWorkerResults[ xWorker ] );
+
+			for( ulBucket = 0; ulBucket < heapbenchLATENCY_BUCKETS; ulBucket++ )
+			{
+				xResult.ulMallocLatency[ ulBucket ] += pxWorkerResult->ulMallocLatency[ ulBucket ];
+				xResult.ulFreeLatency[ ulBucket ] += pxWorkerResult->ulFreeLatency[ ulBucket ];
+			}
+
+			ulMallocs += pxWorkerResult->ulMallocs;
+			ulFrees += pxWorkerResult->ulFrees;
+			ulTotalMallocLatency += pxWorkerResult->ulTotalMallocLatency;
+			ulTotalFreeLatency += pxWorkerResult->ulTotalFreeLatency;
+			xResult.ulFailedAllocations += pxWorkerResult->ulFailedAllocations;
+
+			if( pxWorkerResult->ulMaxMallocLatency > xResult.ulMaxMallocLatency )
+			{
+				xResult.ulMaxMallocLatency = pxWorkerResult->ulMaxMallocLatency;
+			}
+
+			if( pxWorkerResult->ulMaxFreeLatency > xResult.ulMaxFreeLatency )
+			{
+				xResult.ulMaxFreeLatency = pxWorkerResult->ulMaxFreeLatency;
+			}
+		}
+
+		ulOperations = ulMallocs + ulFrees;
+
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			/* The run time counter on the demos that use this file counts
+			microseconds. */
+			xResult.ulOperationsPerSecond = ( ulElapsed > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) ulOperations * 1000000ULL ) / ulElapsed ) : 0UL;
+		}
+		#else
+		{
+			xResult.ulOperationsPerSecond = ( ulElapsed > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) ulOperations * configTICK_RATE_HZ ) / ulElapsed ) : 0UL;
+		}
+		#endif
+
+		xResult.ulMeanMallocLatency = ( ulMallocs > 0UL ) ? ( ulTotalMallocLatency / ulMallocs ) : 0UL;
+		xResult.ulMeanFreeLatency = ( ulFrees > 0UL ) ? ( ulTotalFreeLatency / ulFrees ) : 0UL;
+		xResult.ulMeanFragmentation = ( ulSamples > 0UL ) ? ( ulTotalFragmentation / ulSamples ) : 0UL;
+		xResult.xMinimumEverFreeBytes = xPortGetMinimumEverFreeHeapSize();
+
+		taskENTER_CRITICAL();
+		{
+			xLastResult = xResult;
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+
+		ulLoopCounter++;
+
+		#if( heapbenchFREE_MEMORY == 0 )
+		{
+			/* The memory allocated by the run cannot be freed, so there can
+			only be one run. */
+			xBenchmarkComplete = pdTRUE;
+			vTaskSuspend( NULL );
+		}
+		#endif
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapBenchmarkWorkerTask( void *pvParameters )
+{
+const BaseType_t xWorker = ( BaseType_t ) pvParameters;
+uint8_t *pucSlots[ heapbenchSLOTS ];
+size_t xSlotSizes[ heapbenchSLOTS ];
+uint32_t ulSeed = ( uint32_t ) xWorker + 1UL, ulOperation, ulStart, ulLatency, ulSlot;
+HeapBenchmarkWorkerResult_t *pxResult = &( xWorkerResults[ xWorker ] );
+
+	#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+		const UBaseType_t uxWorkerBit = ( UBaseType_t ) 1 << xWorker;
+	#endif
+
+	memset( pucSlots, 0x00, sizeof( pucSlots ) );
+
+	for( ;; )
+	{
+		xSemaphoreTake( xStartSemaphore, portMAX_DELAY );
+
+		#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+		{
+			taskENTER_CRITICAL();
+			{
+				uxRunningWorkers |= uxWorkerBit;
+			}
+			taskEXIT_CRITICAL();
+		}
+		#endif
+
+		for( ulOperation = 0; ulOperation < heapbenchOPERATIONS_PER_RUN; ulOperation++ )
+		{
+			#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+			{
+				if( ( uxFlushRequests & uxWorkerBit ) != 0 )
+				{
+					prvWorkerFlushCache( uxWorkerBit, pdFALSE );
+				}
+			}
+			#endif
+
+			/* Simple linear congruential generator, as used elsewhere in the
+			demos - it only needs to be cheap and repeatable. */
+			ulSeed = ( ulSeed * 1103515245UL ) + 12345UL;
+			ulSlot = ( ulSeed >> 16 ) % heapbenchSLOTS;
+
+			if( pucSlots[ ulSlot ] != NULL )
+			{
+				#if( heapbenchFREE_MEMORY == 1 )
+				{
+					prvCheckAndFree( xWorker, pucSlots[ ulSlot ], xSlotSizes[ ulSlot ], pxResult );
+					pucSlots[ ulSlot ] = NULL;
+				}
+				#endif
+			}
+			else
+			{
+				xSlotSizes[ ulSlot ] = prvNextRequestSize( &ulSeed );
+
+				ulStart = heapbenchGET_TIME();
+				pucSlots[ ulSlot ] = ( uint8_t * ) pvPortMalloc( xSlotSizes[ ulSlot ] );
+				ulLatency = heapbenchGET_TIME() - ulStart;
+
+				if( pucSlots[ ulSlot ] == NULL )
+				{
+					pxResult->ulFailedAllocations++;
+				}
+				else
+				{
+					memset( pucSlots[ ulSlot ], ( int ) ( ulSlot + ( ( uint32_t ) xWorker << 6 ) ), xSlotSizes[ ulSlot ] );
+					prvRecordLatency( ulLatency, pxResult->ulMallocLatency, &( pxResult->ulTotalMallocLatency ), &( pxResult->ulMaxMallocLatency ) );
+					pxResult->ulMallocs++;
+				}
+			}
+		}
+
+		#if( heapbenchFREE_MEMORY == 1 )
+		{
+			/* Leave the heap as it was found. */
+			for( ulSlot = 0; ulSlot < heapbenchSLOTS; ulSlot++ )
+			{
+				if( pucSlots[ ulSlot ] != NULL )
+				{
+					prvCheckAndFree( xWorker, pucSlots[ ulSlot ], xSlotSizes[ ulSlot ], pxResult );
+					pucSlots[ ulSlot ] = NULL;
+				}
+			}
+		}
+		#endif
+
+		#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+		{
+			/* Leave nothing in this core's cache either, so the controller's
+			end of run figures are not affected by it. */
+			prvWorkerFlushCache( uxWorkerBit, pdTRUE );
+		}
+		#endif
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( heapbenchFLUSH_HEAP_CACHE == 1 )
+
+	static void prvFlushWorkerCaches( void )
+	{
+		taskENTER_CRITICAL();
+		{
+			uxFlushRequests = uxRunningWorkers;
+		}
+		taskEXIT_CRITICAL();
+
+		/* The workers have a lower priority, so run while the controller is
+		delayed.  A worker that finishes its run flushes its cache and clears
+		its request before it signals the controller, so this cannot wait for
+		a worker that is no longer running. */
+		while( uxFlushRequests != 0 )
+		{
+			vTaskDelay( 1 );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvWorkerFlushCache( UBaseType_t uxWorkerBit, BaseType_t xRunComplete )
+	{
+		/* The workers are pinned to their cores, so this flushes the cache of
+		the core this worker runs on. */
+		vPortFlushHeapCache();
+
+		taskENTER_CRITICAL();
+		{
+			uxFlushRequests &= ~uxWorkerBit;
+
+			if( xRunComplete != pdFALSE )
+			{
+				uxRunningWorkers &= ~uxWorkerBit;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* heapbenchFLUSH_HEAP_CACHE */
+
+static void prvCheckAndFree( BaseType_t xWorker, uint8_t *pucBlock, size_t xSize, HeapBenchmarkWorkerResult_t *pxResult )
+{
+const uint8_t ucExpected = pucBlock[ 0 ];
+uint32_t ulStart, ulLatency;
+size_t x;
+
+	/* Every byte was set to the same value, which identifies the worker.  If
+	another worker has written to the block the allocator handed the same
+	memory out twice. */
+	if( ( ( uint32_t ) ucExpected >> 6 ) != ( ( uint32_t ) xWorker & 0x03UL ) )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	for( x = 1; x < xSize; x++ )
+	{
+		if( pucBlock[ x ] != ucExpected )
+		{
+			xErrorDetected = pdTRUE;
+			break;
+		}
+	}
+
+	ulStart = heapbenchGET_TIME();
+	vPortFree( pucBlock );
+	ulLatency = heapbenchGET_TIME() - ulStart;
+
+	prvRecordLatency( ulLatency, pxResult->ulFreeLatency, &( pxResult->ulTotalFreeLatency ), &( pxResult->ulMaxFreeLatency ) );
+	pxResult->ulFrees++;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvNextRequestSize( uint32_t *pulSeed )
+{
+uint32_t ulPercent, ulRandom;
+size_t xSize;
+
+	*pulSeed = ( *pulSeed * 1103515245UL ) + 12345UL;
+	ulRandom = *pulSeed >> 8;
+	ulPercent = ulRandom % 100UL;
+	ulRandom /= 100UL;
+
+	if( ulPercent < heapbenchSMALL_PERCENT )
+	{
+		xSize = ( size_t ) ( 1UL + ( ulRandom % heapbenchSMALL_MAX ) );
+	}
+	else if( ulPercent < ( heapbenchSMALL_PERCENT + heapbenchMEDIUM_PERCENT ) )
+	{
+		xSize = ( size_t ) ( heapbenchSMALL_MAX + 1UL + ( ulRandom % ( heapbenchMEDIUM_MAX - heapbenchSMALL_MAX ) ) );
+	}
+	else
+	{
+		xSize = ( size_t ) ( heapbenchMEDIUM_MAX + 1UL + ( ulRandom % ( heapbenchLARGE_MAX - heapbenchMEDIUM_MAX ) ) );
+	}
+
+	return xSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordLatency( uint32_t ulLatency, uint32_t *pulHistogram, uint32_t *pulTotal, uint32_t *pulMax )
+{
+uint32_t ulBucket = 0, ulValue = ulLatency;
+
+	/* Bucket n holds latencies from 2^(n-1) to (2^n)-1. */
+	while( ( ulValue != 0UL ) && ( ulBucket < ( heapbenchLATENCY_BUCKETS - 1 ) ) )
+	{
+		ulValue >>= 1;
+		ulBucket++;
+	}
+
+	pulHistogram[ ulBucket ]++;
+	*pulTotal += ulLatency;
+
+	if( ulLatency > *pulMax )
+	{
+		*pulMax = ulLatency;
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetHeapBenchmarkResults( HeapBenchmarkResult_t *pxResult, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxResult = xLastResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreHeapBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ( ulLastLoopCounter == ulLoopCounter ) && ( xBenchmarkComplete == pdFALSE ) )
+	{
+		/* No runs have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
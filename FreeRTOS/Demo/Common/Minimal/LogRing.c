@@ -0,0 +1,382 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A logging backend that never blocks the caller, as an alternative to
+ * writing log messages directly to stdio.  Writing directly means each
+ * printf() or puts() call waits for its characters to be pushed to the
+ * console, often in small fragments, for every message.
+ *
+ * Each core has its own single producer single consumer ring buffer.
+ * xLogRingWrite() masks interrupts on the calling core, which both stops an
+ * interrupt on that core writing to the same ring and stops the calling task
+ * moving to another core part way through the write, so no lock shared
+ * between cores is needed.  A message is copied into the ring whole or not at
+ * all - if there is not enough space the message is dropped and counted.
+ *
+ * The consumer is a single drain task.  Every logringFLUSH_PERIOD_MS
+ * milliseconds it copies everything held in the rings into a
+ * logringPACKET_SIZE byte packet buffer, passing the buffer to the output
+ * function each time it fills and once more at the end, so the output sees
+ * few large writes rather than many small ones.  Space in a ring is released
+ * as soon as it has been copied out, before the packet is output.
+ *
+ * Head and tail are free running byte counts, so the number of bytes in a
+ * ring is always ( ulHead - ulTail ), even after they wrap.  Only the producer
+ * writes ulHead and only the consumer writes ulTail.
+ *
+ * The port and kernel dependencies are all behind macros, so the ring and
+ * drain logic can be built and tested on a host.
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "LogRing.h"
+
+#if( ( logringRING_SIZE & ( logringRING_SIZE - 1 ) ) != 0 )
+	#error logringRING_SIZE must be a power of two.
+#endif
+
+/* The longest the drain task waits between drains. */
+#ifndef logringFLUSH_PERIOD_MS
+	#define logringFLUSH_PERIOD_MS			20
+#endif
+
+#ifndef logringTASK_STACK_SIZE
+	#define logringTASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/* Used to stop interrupts on the calling core writing to the ring, and the
+calling task from being moved to another core, while a message is written. */
+#ifndef logringDISABLE_INTERRUPTS
+	#define logringDISABLE_INTERRUPTS()		portSET_INTERRUPT_MASK_FROM_ISR()
+	#define logringENABLE_INTERRUPTS( x )	portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+#endif
+
+#ifndef logringGET_CORE_ID
+	#ifdef portGET_CORE_ID
+		#define logringGET_CORE_ID()		portGET_CORE_ID()
+	#else
+		#define logringGET_CORE_ID()		0
+	#endif
+#endif
+
+#ifndef portMEMORY_BARRIER
+	#define portMEMORY_BARRIER()
+#endif
+
+#define logringINDEX_MASK					( ( uint32_t ) logringRING_SIZE - 1UL )
+
+/*-----------------------------------------------------------*/
+
+typedef struct LogRing
+{
+	volatile uint32_t ulHead;				/* Written by the producer only. */
+	volatile uint32_t ulTail;				/* Written by the consumer only. */
+	uint32_t ulBytesLogged;					/* Producer counters. */
+	uint32_t ulMessagesLogged;
+	uint32_t ulBytesDropped;
+	uint32_t ulMessagesDropped;
+	uint32_t ulHighWaterMark;
+	char cData[ logringRING_SIZE ];
+} LogRing_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Copy xLength bytes from pcData, followed by a newline if xAppendNewline is
+ * not pdFALSE, into the calling core's ring as a single message.
+ */
+static size_t prvWrite( const char *pcData, size_t xLength, BaseType_t xAppendNewline );
+
+/*
+ * Copy xLength bytes into pxRing starting at free running index ulIndex,
+ * wrapping at the end of the ring.
+ */
+static void prvCopyIn( LogRing_t *pxRing, uint32_t ulIndex, const char *pcData, size_t xLength );
+
+/*
+ * The drain task, as described at the top of this file.
+ */
+static void prvLogRingTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static LogRing_t xRings[ logringNUM_RINGS ];
+
+/* Only accessed by the single consumer. */
+static char cPacket[ logringPACKET_SIZE ];
+static uint32_t ulBytesSent = 0, ulPacketsSent = 0;
+
+static TaskHandle_t xDrainTask = NULL;
+static LogRingOutput_t pxDrainOutput = NULL;
+
+/*-----------------------------------------------------------*/
+
+size_t xLogRingWrite( const char *pcData, size_t xLength )
+{
+	return prvWrite( pcData, xLength, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+int lLogRingPrintf( const char *pcFormat, ... )
+{
+char cMessage[ logringMAX_MESSAGE_LENGTH ];
+va_list xArgs;
+int lLength;
+
+	va_start( xArgs, pcFormat );
+	lLength = vsnprintf( cMessage, sizeof( cMessage ), pcFormat, xArgs );
+	va_end( xArgs );
+
+	if( lLength < 0 )
+	{
+		lLength = 0;
+	}
+	else if( lLength >= ( int ) sizeof( cMessage ) )
+	{
+		/* Truncated. */
+		lLength = ( int ) sizeof( cMessage ) - 1;
+	}
+
+	return ( int ) prvWrite( cMessage, ( size_t ) lLength, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+int lLogRingPuts( const char *pcString )
+{
+	return ( int ) prvWrite( pcString, strlen( pcString ), pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWrite( const char *pcData, size_t xLength, BaseType_t xAppendNewline )
+{
+LogRing_t *pxRing;
+UBaseType_t uxSavedInterruptStatus;
+uint32_t ulHead, ulUsed;
+size_t xTotal = xLength;
+
+	if( xAppendNewline != pdFALSE )
+	{
+		xTotal++;
+	}
+
+	uxSavedInterruptStatus = logringDISABLE_INTERRUPTS();
+	{
+		pxRing = &( xRings[ logringGET_CORE_ID() ] );
+		ulHead = pxRing->ulHead;
+
+		/* ulTail may be moved on by the consumer at any time, but that only
+		ever frees space, so a stale value is safe. */
+		ulUsed = ulHead - pxRing->ulTail;
+
+		if( xTotal > ( size_t ) ( logringRING_SIZE - ulUsed ) )
+		{
+			pxRing->ulBytesDropped += ( uint32_t ) xTotal;
+			pxRing->ulMessagesDropped++;
+			xTotal = 0;
+		}
+		else
+		{
+			prvCopyIn( pxRing, ulHead, pcData, xLength );
+
+			if( xAppendNewline != pdFALSE )
+			{
+				pxRing->cData[ ( ulHead + xLength ) & logringINDEX_MASK ] = '\n';
+			}
+
+			/* The data must be in the ring before the consumer can see it. */
+			portMEMORY_BARRIER();
+			pxRing->ulHead = ulHead + ( uint32_t ) xTotal;
+
+			pxRing->ulBytesLogged += ( uint32_t ) xTotal;
+			pxRing->ulMessagesLogged++;
+
+			ulUsed += ( uint32_t ) xTotal;
+
+			if( ulUsed > pxRing->ulHighWaterMark )
+			{
+				pxRing->ulHighWaterMark = ulUsed;
+			}
+		}
+	}
+	logringENABLE_INTERRUPTS( uxSavedInterruptStatus );
+
+	return xTotal;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyIn( LogRing_t *pxRing, uint32_t ulIndex, const char *pcData, size_t xLength )
+{
+uint32_t ulOffset = ulIndex & logringINDEX_MASK;
+size_t xFirst = logringRING_SIZE - ulOffset;
+
+	if( xFirst >= xLength )
+	{
+		memcpy( &( pxRing->cData[ ulOffset ] ), pcData, xLength );
+	}
+	else
+	{
+		memcpy( &( pxRing->cData[ ulOffset ] ), pcData, xFirst );
+		memcpy( pxRing->cData, &( pcData[ xFirst ] ), xLength - xFirst );
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xLogRingDrain( LogRingOutput_t pxOutput )
+{
+LogRing_t *pxRing;
+uint32_t ulHead, ulTail, ulOffset;
+size_t xInPacket = 0, xDrained = 0, xChunk;
+UBaseType_t uxRing;
+
+	configASSERT( pxOutput );
+
+	for( uxRing = 0; uxRing < ( UBaseType_t ) logringNUM_RINGS; uxRing++ )
+	{
+		pxRing = &( xRings[ uxRing ] );
+
+		/* Only drain what was in the ring on entry, so a core that logs
+		continuously cannot keep the consumer in this loop. */
+		ulHead = pxRing->ulHead;
+		portMEMORY_BARRIER();
+		ulTail = pxRing->ulTail;
+
+		while( ulTail != ulHead )
+		{
+			/* As much as fits in the packet, stopping at the end of the ring. */
+			ulOffset = ulTail & logringINDEX_MASK;
+			xChunk = ( size_t ) ( ulHead - ulTail );
+
+			if( xChunk > ( size_t ) ( logringRING_SIZE - ulOffset ) )
+			{
+				xChunk = ( size_t ) ( logringRING_SIZE - ulOffset );
+			}
+
+			if( xChunk > ( logringPACKET_SIZE - xInPacket ) )
+			{
+				xChunk = logringPACKET_SIZE - xInPacket;
+			}
+
+			memcpy( &( cPacket[ xInPacket ] ), &( pxRing->cData[ ulOffset ] ), xChunk );
+			xInPacket += xChunk;
+			ulTail += ( uint32_t ) xChunk;
+
+			/* The data must be out of the ring before the producer can
+			overwrite it. */
+			portMEMORY_BARRIER();
+			pxRing->ulTail = ulTail;
+
+			if( xInPacket == logringPACKET_SIZE )
+			{
+				pxOutput( cPacket, xInPacket );
+				ulPacketsSent++;
+				ulBytesSent += ( uint32_t ) xInPacket;
+				xDrained += xInPacket;
+				xInPacket = 0;
+			}
+		}
+	}
+
+	if( xInPacket > 0 )
+	{
+		pxOutput( cPacket, xInPacket );
+		ulPacketsSent++;
+		ulBytesSent += ( uint32_t ) xInPacket;
+		xDrained += xInPacket;
+	}
+
+	return xDrained;
+}
+/*-----------------------------------------------------------*/
+
+void vStartLogRingTask( UBaseType_t uxPriority, LogRingOutput_t pxOutput )
+{
+	configASSERT( pxOutput );
+	configASSERT( xDrainTask == NULL );
+
+	pxDrainOutput = pxOutput;
+	xTaskCreate( prvLogRingTask, "LogRing", logringTASK_STACK_SIZE, NULL, uxPriority, &xDrainTask );
+}
+/*-----------------------------------------------------------*/
+
+void vLogRingFlush( void )
+{
+	if( xDrainTask != NULL )
+	{
+		xTaskNotifyGive( xDrainTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLogRingTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( logringFLUSH_PERIOD_MS ) );
+		( void ) xLogRingDrain( pxDrainOutput );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vLogRingGetStats( LogRingStats_t *pxStats )
+{
+UBaseType_t uxRing;
+
+	memset( pxStats, 0x00, sizeof( *pxStats ) );
+
+	taskENTER_CRITICAL();
+	{
+		for( uxRing = 0; uxRing < ( UBaseType_t ) logringNUM_RINGS; uxRing++ )
+		{
+			pxStats->ulBytesLogged += xRings[ uxRing ].ulBytesLogged;
+			pxStats->ulMessagesLogged += xRings[ uxRing ].ulMessagesLogged;
+			pxStats->ulBytesDropped += xRings[ uxRing ].ulBytesDropped;
+			pxStats->ulMessagesDropped += xRings[ uxRing ].ulMessagesDropped;
+
+			if( xRings[ uxRing ].ulHighWaterMark > pxStats->ulHighWaterMark )
+			{
+				pxStats->ulHighWaterMark = xRings[ uxRing ].ulHighWaterMark;
+			}
+		}
+
+		pxStats->ulBytesSent = ulBytesSent;
+		pxStats->ulPacketsSent = ulPacketsSent;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,256 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares logging by writing each message directly to the console with
+ * logging through the rings implemented in LogRing.c.
+ *
+ * A logging task formats and logs the same short message as fast as it can
+ * for logbenchMEASUREMENT_PERIOD ticks, first passing each message to the
+ * direct output function provided by the application, then using
+ * lLogRingPrintf().  A higher priority controller task starts and stops each
+ * measurement, then waits for the drain task to empty the rings, and records
+ * for each method:
+ *
+ * + The number of messages the logging task logged per second.
+ * + The mean time taken by one call.
+ * + The number of bytes dropped because a ring was full.  Writing directly
+ *   never drops, but the caller waits for the console instead.
+ *
+ * The measurements are repeated every logbenchRUN_PERIOD ticks, which is less
+ * than the period of the demo check tasks that call
+ * xAreLogRingBenchmarkTasksStillRunning().  While a measurement is in
+ * progress the console is flooded with benchmark messages.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "LogRing.h"
+#include "LogRingBenchmark.h"
+
+/* The time for which each logging method is measured. */
+#define logbenchMEASUREMENT_PERIOD			pdMS_TO_TICKS( 250UL )
+
+/* The time between the start of each pair of measurements. */
+#ifndef logbenchRUN_PERIOD
+	#define logbenchRUN_PERIOD				pdMS_TO_TICKS( 2500UL )
+#endif
+
+#ifndef logbenchTASK_STACK_SIZE
+	#define logbenchTASK_STACK_SIZE			( configMINIMAL_STACK_SIZE + logringMAX_MESSAGE_LENGTH )
+#endif
+
+/* The logging methods. */
+#define logbenchDIRECT						( 0 )
+#define logbenchRING						( 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The controller and logging tasks, as described at the top of this file.
+ */
+static void prvLogRingBenchmarkControllerTask( void *pvParameters );
+static void prvLogRingBenchmarkLoggingTask( void *pvParameters );
+
+/*
+ * Run the logging task using xMethod for one measurement period, and fill in
+ * *pxResult.
+ */
+static void prvMeasure( BaseType_t xMethod, LogRingBenchmarkResult_t *pxResult );
+
+/*-----------------------------------------------------------*/
+
+static LogRingOutput_t pxDirectOutputFunction = NULL;
+
+/* Used to start and end each measurement. */
+static SemaphoreHandle_t xStartSemaphore = NULL, xDoneSemaphore = NULL;
+static volatile BaseType_t xStopRequested = pdFALSE;
+static volatile BaseType_t xLogMethod = logbenchDIRECT;
+
+/* Written by the logging task during a measurement, and read by the
+controller after. */
+static volatile uint32_t ulMessages = 0;
+
+/* The most recent results. */
+static LogRingBenchmarkResult_t xDirectResult, xRingResult;
+static uint32_t ulRunCount = 0;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartLogRingBenchmarkTasks( UBaseType_t uxPriority, LogRingOutput_t pxDirectOutput )
+{
+	configASSERT( pxDirectOutput );
+
+	pxDirectOutputFunction = pxDirectOutput;
+
+	xStartSemaphore = xSemaphoreCreateBinary();
+	xDoneSemaphore = xSemaphoreCreateBinary();
+
+	configASSERT( xStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	xTaskCreate( prvLogRingBenchmarkLoggingTask, "LBLog", logbenchTASK_STACK_SIZE, NULL, uxPriority, NULL );
+	xTaskCreate( prvLogRingBenchmarkControllerTask, "LBCtrl", configMINIMAL_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLogRingBenchmarkControllerTask( void *pvParameters )
+{
+LogRingBenchmarkResult_t xDirectMeasured, xRingMeasured;
+TickType_t xLastRunTime;
+
+	( void ) pvParameters;
+
+	xLastRunTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastRunTime, logbenchRUN_PERIOD );
+
+		prvMeasure( logbenchDIRECT, &xDirectMeasured );
+		prvMeasure( logbenchRING, &xRingMeasured );
+
+		taskENTER_CRITICAL();
+		{
+			xDirectResult = xDirectMeasured;
+			xRingResult = xRingMeasured;
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasure( BaseType_t xMethod, LogRingBenchmarkResult_t *pxResult )
+{
+LogRingStats_t xBefore, xAfter;
+
+	/* Start with empty rings, so the measurement is not affected by messages
+	logged by other tasks before it started. */
+	vLogRingFlush();
+	vTaskDelay( logbenchMEASUREMENT_PERIOD );
+
+	/* The logging task is blocked on its start semaphore, so nothing else is
+	accessing these variables. */
+	ulMessages = 0;
+	xLogMethod = xMethod;
+	xStopRequested = pdFALSE;
+
+	vLogRingGetStats( &xBefore );
+	xSemaphoreGive( xStartSemaphore );
+	vTaskDelay( logbenchMEASUREMENT_PERIOD );
+	xStopRequested = pdTRUE;
+	xSemaphoreTake( xDoneSemaphore, portMAX_DELAY );
+	vLogRingGetStats( &xAfter );
+
+	pxResult->ulMessagesPerSecond = ( uint32_t ) ( ( ( uint64_t ) ulMessages * configTICK_RATE_HZ ) / logbenchMEASUREMENT_PERIOD );
+	pxResult->ulMeanCallTime = ( ulMessages > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) logbenchMEASUREMENT_PERIOD * 1000000ULL ) / ( ( uint64_t ) configTICK_RATE_HZ * ulMessages ) ) : 0UL;
+	pxResult->ulBytesDropped = xAfter.ulBytesDropped - xBefore.ulBytesDropped;
+
+	ulLoopCounter++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLogRingBenchmarkLoggingTask( void *pvParameters )
+{
+char cMessage[ logringMAX_MESSAGE_LENGTH ];
+int lLength;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xSemaphoreTake( xStartSemaphore, portMAX_DELAY );
+
+		while( xStopRequested == pdFALSE )
+		{
+			if( xLogMethod == logbenchRING )
+			{
+				( void ) lLogRingPrintf( "LogBench ring %08lu: the quick brown fox\n", ( unsigned long ) ulMessages );
+			}
+			else
+			{
+				lLength = snprintf( cMessage, sizeof( cMessage ), "LogBench direct %08lu: the quick brown fox\n", ( unsigned long ) ulMessages );
+
+				if( ( lLength > 0 ) && ( lLength < ( int ) sizeof( cMessage ) ) )
+				{
+					pxDirectOutputFunction( cMessage, ( size_t ) lLength );
+				}
+			}
+
+			ulMessages++;
+		}
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetLogRingBenchmarkResults( LogRingBenchmarkResult_t *pxDirect, LogRingBenchmarkResult_t *pxRing, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxDirect = xDirectResult;
+		*pxRing = xRingResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreLogRingBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
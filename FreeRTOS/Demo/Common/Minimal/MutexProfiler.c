@@ -0,0 +1,306 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A contention profiler for mutexes and recursive mutexes.
+ *
+ * Tasks take mutexes through xMutexProfilerTake() and
+ * xMutexProfilerTakeRecursive() in place of xSemaphoreTake() and
+ * xSemaphoreTakeRecursive() - recmutex.c and GenQTest.c do so when
+ * recmuUSE_MUTEX_PROFILER and genqUSE_MUTEX_PROFILER respectively are set to 1.
+ * Statistics are only kept for mutexes that have been added to the queue
+ * registry using vQueueAddToRegistry(), so the application chooses which
+ * mutexes to profile, and the registry name identifies the mutex in the
+ * results.
+ *
+ * Each take first tries to obtain the mutex without blocking.  Only if that
+ * fails, and the caller specified a block time, is the take counted as
+ * contended, in which case the profiler records:
+ *
+ * + The time spent waiting, and whether the wait timed out.
+ * + Whether the waiting task has a higher priority than the holder, in which
+ *   case priority inheritance raises the priority of the holder.
+ * + The core on which the holder took the mutex.  Mutexes that are often
+ *   contended by tasks on a different core to the holder are candidates for
+ *   splitting on multicore parts.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "MutexProfiler.h"
+
+#if( configQUEUE_REGISTRY_SIZE == 0 )
+	#error The mutex profiler requires the queue registry - set configQUEUE_REGISTRY_SIZE above 0.
+#endif
+
+/* The maximum number of mutexes that can be profiled. */
+#ifndef mutexprofMAX_MUTEXES
+	#define mutexprofMAX_MUTEXES		configQUEUE_REGISTRY_SIZE
+#endif
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define mutexprofGET_TIME()			( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define mutexprofGET_TIME()			( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifdef portGET_CORE_ID
+	#define mutexprofGET_CORE_ID()		( ( UBaseType_t ) portGET_CORE_ID() )
+#else
+	#define mutexprofGET_CORE_ID()		( ( UBaseType_t ) 0 )
+#endif
+
+#define mutexprofDONT_BLOCK				( ( TickType_t ) 0 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct MUTEX_PROFILE_ENTRY
+{
+	SemaphoreHandle_t xMutex;
+	UBaseType_t uxHolderCore;		/*<< The core on which the mutex was last taken. */
+	MutexProfile_t xProfile;
+} MutexProfileEntry_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Take xMutex, recursively if xRecursive is pdTRUE, recording statistics if it
+ * is in the queue registry.
+ */
+static BaseType_t prvTake( SemaphoreHandle_t xMutex, TickType_t xTicksToWait, BaseType_t xRecursive );
+
+/*
+ * Return the profile entry for xMutex, creating it if this is the first time
+ * xMutex has been taken.  Returns NULL if xMutex is not in the queue registry
+ * or there is no space for another entry.
+ */
+static MutexProfileEntry_t *prvGetEntry( SemaphoreHandle_t xMutex );
+
+/*-----------------------------------------------------------*/
+
+static MutexProfileEntry_t xEntries[ mutexprofMAX_MUTEXES ];
+static volatile UBaseType_t uxNumberOfEntries = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xMutexProfilerTake( SemaphoreHandle_t xMutex, TickType_t xTicksToWait )
+{
+	return prvTake( xMutex, xTicksToWait, pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMutexProfilerTakeRecursive( SemaphoreHandle_t xMutex, TickType_t xTicksToWait )
+{
+	return prvTake( xMutex, xTicksToWait, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTake( SemaphoreHandle_t xMutex, TickType_t xTicksToWait, BaseType_t xRecursive )
+{
+MutexProfileEntry_t *pxEntry;
+BaseType_t xReturn, xContended = pdFALSE, xBoost = pdFALSE;
+UBaseType_t uxHolderCore = 0;
+uint32_t ulStartTime = 0, ulWaitTime = 0;
+
+	pxEntry = prvGetEntry( xMutex );
+
+	/* First try without blocking, to find out whether the mutex is
+	contended. */
+	if( xRecursive != pdFALSE )
+	{
+		xReturn = xSemaphoreTakeRecursive( xMutex, mutexprofDONT_BLOCK );
+	}
+	else
+	{
+		xReturn = xSemaphoreTake( xMutex, mutexprofDONT_BLOCK );
+	}
+
+	if( ( xReturn != pdPASS ) && ( xTicksToWait != mutexprofDONT_BLOCK ) )
+	{
+		if( pxEntry != NULL )
+		{
+			xContended = pdTRUE;
+			uxHolderCore = pxEntry->uxHolderCore;
+
+			/* Blocking on a mutex raises the priority of the holder if the
+			holder has a lower priority than the calling task.  The holder
+			may give the mutex back at any time, so this is a best effort
+			observation. */
+			#if( INCLUDE_xSemaphoreGetMutexHolder == 1 )
+			{
+			TaskHandle_t xHolder = xSemaphoreGetMutexHolder( xMutex );
+
+				if( ( xHolder != NULL ) && ( uxTaskPriorityGet( xHolder ) < uxTaskPriorityGet( NULL ) ) )
+				{
+					xBoost = pdTRUE;
+				}
+			}
+			#endif
+
+			ulStartTime = mutexprofGET_TIME();
+		}
+
+		if( xRecursive != pdFALSE )
+		{
+			xReturn = xSemaphoreTakeRecursive( xMutex, xTicksToWait );
+		}
+		else
+		{
+			xReturn = xSemaphoreTake( xMutex, xTicksToWait );
+		}
+
+		if( pxEntry != NULL )
+		{
+			ulWaitTime = mutexprofGET_TIME() - ulStartTime;
+		}
+	}
+
+	if( pxEntry != NULL )
+	{
+		taskENTER_CRITICAL();
+		{
+			if( xContended != pdFALSE )
+			{
+				pxEntry->xProfile.ulContendedAcquisitions++;
+				pxEntry->xProfile.ulTotalWaitTime += ulWaitTime;
+
+				if( ulWaitTime > pxEntry->xProfile.ulMaxWaitTime )
+				{
+					pxEntry->xProfile.ulMaxWaitTime = ulWaitTime;
+				}
+
+				if( xBoost != pdFALSE )
+				{
+					pxEntry->xProfile.ulPriorityInheritanceBoosts++;
+				}
+
+				if( uxHolderCore < mutexprofNUM_CORES )
+				{
+					pxEntry->xProfile.ulContendedByHolderCore[ uxHolderCore ]++;
+				}
+
+				if( xReturn != pdPASS )
+				{
+					pxEntry->xProfile.ulTimeouts++;
+				}
+			}
+
+			if( xReturn == pdPASS )
+			{
+				pxEntry->xProfile.ulAcquisitions++;
+				pxEntry->uxHolderCore = mutexprofGET_CORE_ID();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static MutexProfileEntry_t *prvGetEntry( SemaphoreHandle_t xMutex )
+{
+MutexProfileEntry_t *pxReturn = NULL;
+UBaseType_t uxEntry;
+const char *pcName;
+
+	/* Entries are never removed, so the existing entries can be searched
+	outside of a critical section. */
+	for( uxEntry = 0; uxEntry < uxNumberOfEntries; uxEntry++ )
+	{
+		if( xEntries[ uxEntry ].xMutex == xMutex )
+		{
+			pxReturn = &( xEntries[ uxEntry ] );
+			break;
+		}
+	}
+
+	if( pxReturn == NULL )
+	{
+		pcName = pcQueueGetName( ( QueueHandle_t ) xMutex );
+
+		if( pcName != NULL )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Another task may have added the entry since the search
+				above. */
+				for( uxEntry = 0; uxEntry < uxNumberOfEntries; uxEntry++ )
+				{
+					if( xEntries[ uxEntry ].xMutex == xMutex )
+					{
+						pxReturn = &( xEntries[ uxEntry ] );
+						break;
+					}
+				}
+
+				if( ( pxReturn == NULL ) && ( uxNumberOfEntries < mutexprofMAX_MUTEXES ) )
+				{
+					pxReturn = &( xEntries[ uxNumberOfEntries ] );
+					memset( pxReturn, 0x00, sizeof( MutexProfileEntry_t ) );
+					pxReturn->xMutex = xMutex;
+					pxReturn->xProfile.pcMutexName = pcName;
+
+					/* Only make the entry visible once it is initialised. */
+					uxNumberOfEntries++;
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMutexProfilerGetProfiles( MutexProfile_t *pxProfiles, UBaseType_t uxMaxProfiles )
+{
+UBaseType_t uxEntry;
+
+	taskENTER_CRITICAL();
+	{
+		for( uxEntry = 0; ( uxEntry < uxNumberOfEntries ) && ( uxEntry < uxMaxProfiles ); uxEntry++ )
+		{
+			pxProfiles[ uxEntry ] = xEntries[ uxEntry ].xProfile;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return uxEntry;
+}
+/*-----------------------------------------------------------*/
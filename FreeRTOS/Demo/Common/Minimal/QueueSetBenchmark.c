@@ -0,0 +1,432 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares the cost of waiting on a queue set with the cost of waiting on the
+ * lighter weight "wait for any" primitive implemented in WaitForAny.c.
+ *
+ * A send task and a higher priority receive task are created.  For each set
+ * size from qsbenchMIN_MEMBERS to qsbenchMAX_MEMBERS (doubling each time), and
+ * for each of the two mechanisms, the send task adds that many queues to a set
+ * then, for qsbenchMEASUREMENT_PERIOD ticks, sends time stamps to the queues in
+ * turn.  The receive task waits on the set, reads each time stamp from the
+ * queue returned by the set, and accumulates the time taken for the item to
+ * arrive.  The number of items that were sent in the measurement period gives
+ * the throughput.
+ *
+ * At the end of each measurement period the send task sends
+ * qsbenchSTOP_VALUE.  When the receive task receives it the receive task
+ * empties all the queues (as, unlike a queue set, the wait for any primitive
+ * does not preserve the order of items sent to different queues) then tells
+ * the send task it has finished.  An error is latched if the receive task does
+ * not receive every item that was sent, or if a queue returned by either
+ * mechanism is empty.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* Demo includes. */
+#include "QueueSetBenchmark.h"
+#include "WaitForAny.h"
+
+
+#if( configUSE_QUEUE_SETS == 1 ) /* Remove the benchmark if queue sets are not defined. */
+
+/* The range of set sizes. */
+#define qsbenchMIN_MEMBERS				( 2U )
+#define qsbenchMAX_MEMBERS				waitanyMAX_MEMBERS
+
+/* Enough results for set sizes of 2, 4, 8, 16 and 32. */
+#define qsbenchMAX_RESULTS				( 5 )
+
+/* The length of each queue added to a set. */
+#define qsbenchQUEUE_LENGTH				( 2U )
+
+/* The time for which items are sent for each set size and mechanism. */
+#define qsbenchMEASUREMENT_PERIOD		pdMS_TO_TICKS( 500UL )
+
+/* Time stamps are masked to 31 bits so they can never equal
+qsbenchSTOP_VALUE. */
+#define qsbenchTIME_MASK				( 0x7fffffffUL )
+#define qsbenchSTOP_VALUE				( 0xffffffffUL )
+
+#define qsbenchDONT_BLOCK				( ( TickType_t ) 0 )
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define qsbenchGET_TIME()			( ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() ) & qsbenchTIME_MASK )
+#else
+	#define qsbenchGET_TIME()			( ( ( uint32_t ) xTaskGetTickCount() ) & qsbenchTIME_MASK )
+#endif
+
+#ifndef qsbenchTASK_STACK_SIZE
+	#define qsbenchTASK_STACK_SIZE		configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The send and receive tasks, as described at the top of this file.
+ */
+static void prvQueueSetBenchmarkSendTask( void *pvParameters );
+static void prvQueueSetBenchmarkReceiveTask( void *pvParameters );
+
+/*
+ * Measure one mechanism with uxNumberOfMembers queues in the set.
+ */
+static void prvMeasure( UBaseType_t uxNumberOfMembers, BaseType_t xUseQueueSet, QueueSetBenchmarkMeasurement_t *pxMeasurement );
+
+/*
+ * Called by the receive task to empty all the queues at the end of a
+ * measurement.  Returns the number of items removed.
+ */
+static uint32_t prvEmptyQueues( void );
+
+/*-----------------------------------------------------------*/
+
+/* The queues that are added to the sets, and the sets themselves.  Only one of
+the two sets exists at any time. */
+static QueueHandle_t xMemberQueues[ qsbenchMAX_MEMBERS ];
+static QueueSetHandle_t xQueueSet = NULL;
+static WaitForAnySetHandle_t xWaitForAnySet = NULL;
+
+/* Describe the measurement in progress to the receive task. */
+static volatile UBaseType_t uxMembersInUse = 0;
+static volatile BaseType_t xUseQueueSetInMeasurement = pdFALSE;
+
+/* Used to start and end each measurement. */
+static SemaphoreHandle_t xStartSemaphore = NULL, xDoneSemaphore = NULL;
+static TaskHandle_t xReceiveTask = NULL;
+
+/* Accumulated by the receive task during a measurement. */
+static volatile uint32_t ulItemsReceived = 0, ulTotalLatency = 0, ulMaxLatency = 0;
+
+/* Results from the sweep in progress, and from the last completed sweep. */
+static QueueSetBenchmarkResult_t xSweepResults[ qsbenchMAX_RESULTS ];
+static QueueSetBenchmarkResult_t xLastSweepResults[ qsbenchMAX_RESULTS ];
+static UBaseType_t uxLastSweepResults = 0;
+static uint32_t ulSweepCount = 0;
+
+/* Latched to pdTRUE if an error is detected. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartQueueSetBenchmarkTasks( UBaseType_t uxPriority )
+{
+UBaseType_t uxQueue;
+
+	xStartSemaphore = xSemaphoreCreateBinary();
+	xDoneSemaphore = xSemaphoreCreateBinary();
+	configASSERT( xStartSemaphore );
+	configASSERT( xDoneSemaphore );
+
+	for( uxQueue = 0; uxQueue < qsbenchMAX_MEMBERS; uxQueue++ )
+	{
+		xMemberQueues[ uxQueue ] = xQueueCreate( qsbenchQUEUE_LENGTH, sizeof( uint32_t ) );
+		configASSERT( xMemberQueues[ uxQueue ] );
+	}
+
+	/* The receive task has the higher priority so, on a single core, every
+	item sent unblocks it. */
+	xTaskCreate( prvQueueSetBenchmarkReceiveTask, "QSBRx", qsbenchTASK_STACK_SIZE, NULL, uxPriority + 1, &xReceiveTask );
+	xTaskCreate( prvQueueSetBenchmarkSendTask, "QSBTx", qsbenchTASK_STACK_SIZE, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueSetBenchmarkSendTask( void *pvParameters )
+{
+UBaseType_t uxNumberOfMembers, uxResults;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		uxResults = 0;
+
+		for( uxNumberOfMembers = qsbenchMIN_MEMBERS; ( uxNumberOfMembers <= qsbenchMAX_MEMBERS ) && ( uxResults < qsbenchMAX_RESULTS ); uxNumberOfMembers <<= 1U )
+		{
+			xSweepResults[ uxResults ].ulNumberOfMembers = ( uint32_t ) uxNumberOfMembers;
+			prvMeasure( uxNumberOfMembers, pdTRUE, &( xSweepResults[ uxResults ].xQueueSet ) );
+			prvMeasure( uxNumberOfMembers, pdFALSE, &( xSweepResults[ uxResults ].xWaitForAny ) );
+			uxResults++;
+		}
+
+		/* Make the completed sweep available to the check task. */
+		taskENTER_CRITICAL();
+		{
+			memcpy( xLastSweepResults, xSweepResults, sizeof( xSweepResults ) );
+			uxLastSweepResults = uxResults;
+			ulSweepCount++;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasure( UBaseType_t uxNumberOfMembers, BaseType_t xUseQueueSet, QueueSetBenchmarkMeasurement_t *pxMeasurement )
+{
+UBaseType_t uxQueue, uxMemberIndex;
+uint32_t ulItemsSent = 0, ulValue;
+TickType_t xStartTime;
+
+	/* Build the set. */
+	if( xUseQueueSet != pdFALSE )
+	{
+		xQueueSet = xQueueCreateSet( uxNumberOfMembers * qsbenchQUEUE_LENGTH );
+		configASSERT( xQueueSet );
+
+		for( uxQueue = 0; uxQueue < uxNumberOfMembers; uxQueue++ )
+		{
+			xQueueAddToSet( xMemberQueues[ uxQueue ], xQueueSet );
+		}
+	}
+	else
+	{
+		xWaitForAnySet = xWaitForAnyCreate( xReceiveTask );
+		configASSERT( xWaitForAnySet );
+
+		for( uxQueue = 0; uxQueue < uxNumberOfMembers; uxQueue++ )
+		{
+			xWaitForAnyAddMember( xWaitForAnySet, xMemberQueues[ uxQueue ], &uxMemberIndex );
+
+			/* Members are indexed in the order they are added. */
+			configASSERT( uxMemberIndex == uxQueue );
+		}
+	}
+
+	ulItemsReceived = 0;
+	ulTotalLatency = 0;
+	ulMaxLatency = 0;
+	uxMembersInUse = uxNumberOfMembers;
+	xUseQueueSetInMeasurement = xUseQueueSet;
+	xSemaphoreGive( xStartSemaphore );
+
+	/* Send time stamps to each queue in turn for the measurement period, then
+	send the stop value. */
+	uxQueue = 0;
+	xStartTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		if( ( xTaskGetTickCount() - xStartTime ) < qsbenchMEASUREMENT_PERIOD )
+		{
+			ulValue = qsbenchGET_TIME();
+			ulItemsSent++;
+		}
+		else
+		{
+			ulValue = qsbenchSTOP_VALUE;
+		}
+
+		if( xUseQueueSet != pdFALSE )
+		{
+			xQueueSendToBack( xMemberQueues[ uxQueue ], &ulValue, portMAX_DELAY );
+		}
+		else
+		{
+			xWaitForAnyQueueSend( xWaitForAnySet, uxQueue, &ulValue, portMAX_DELAY );
+		}
+
+		if( ulValue == qsbenchSTOP_VALUE )
+		{
+			break;
+		}
+
+		uxQueue++;
+		if( uxQueue >= uxNumberOfMembers )
+		{
+			uxQueue = 0;
+		}
+	}
+
+	xSemaphoreTake( xDoneSemaphore, portMAX_DELAY );
+
+	/* The stop value is counted as a received item but not as a sent item. */
+	if( ulItemsReceived != ( ulItemsSent + 1UL ) )
+	{
+		xErrorDetected = pdTRUE;
+	}
+
+	pxMeasurement->ulItemsPerSecond = ( uint32_t ) ( ( ( uint64_t ) ulItemsSent * configTICK_RATE_HZ ) / qsbenchMEASUREMENT_PERIOD );
+	pxMeasurement->ulMeanLatency = ( ulItemsSent > 0UL ) ? ( ulTotalLatency / ulItemsSent ) : 0UL;
+	pxMeasurement->ulMaxLatency = ulMaxLatency;
+
+	/* The receive task has emptied all the queues, so they can be removed from
+	the set. */
+	if( xUseQueueSet != pdFALSE )
+	{
+		for( uxQueue = 0; uxQueue < uxNumberOfMembers; uxQueue++ )
+		{
+			xQueueRemoveFromSet( xMemberQueues[ uxQueue ], xQueueSet );
+		}
+
+		vQueueDelete( xQueueSet );
+		xQueueSet = NULL;
+	}
+	else
+	{
+		vWaitForAnyDelete( xWaitForAnySet );
+		xWaitForAnySet = NULL;
+	}
+
+	ulLoopCounter++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueSetBenchmarkReceiveTask( void *pvParameters )
+{
+QueueHandle_t xQueue;
+uint32_t ulValue, ulLatency;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xSemaphoreTake( xStartSemaphore, portMAX_DELAY );
+
+		for( ;; )
+		{
+			if( xUseQueueSetInMeasurement != pdFALSE )
+			{
+				xQueue = xQueueSelectFromSet( xQueueSet, portMAX_DELAY );
+			}
+			else
+			{
+				xQueue = xWaitForAnySelect( xWaitForAnySet, portMAX_DELAY );
+			}
+
+			if( xQueue == NULL )
+			{
+				/* Neither kind of set returns NULL before the block time
+				has expired, so this is only possible if INCLUDE_vTaskSuspend
+				is 0, in which case portMAX_DELAY is a finite time. */
+				continue;
+			}
+
+			/* The queue returned by the set must contain data. */
+			if( xQueueReceive( xQueue, &ulValue, qsbenchDONT_BLOCK ) != pdPASS )
+			{
+				xErrorDetected = pdTRUE;
+				continue;
+			}
+
+			ulItemsReceived++;
+
+			if( ulValue == qsbenchSTOP_VALUE )
+			{
+				ulItemsReceived += prvEmptyQueues();
+				break;
+			}
+
+			ulLatency = ( qsbenchGET_TIME() - ulValue ) & qsbenchTIME_MASK;
+			ulTotalLatency += ulLatency;
+
+			if( ulLatency > ulMaxLatency )
+			{
+				ulMaxLatency = ulLatency;
+			}
+		}
+
+		xSemaphoreGive( xDoneSemaphore );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvEmptyQueues( void )
+{
+UBaseType_t uxQueue;
+uint32_t ulValue, ulItemsRemoved = 0;
+
+	/* Items removed here are not selected through the set, so are not included
+	in the latency measurements.  The handles (or notification bits) that
+	remain for them are discarded when the set is deleted (or skipped by
+	xWaitForAnySelect() because the queue is empty). */
+	for( uxQueue = 0; uxQueue < uxMembersInUse; uxQueue++ )
+	{
+		while( xQueueReceive( xMemberQueues[ uxQueue ], &ulValue, qsbenchDONT_BLOCK ) == pdPASS )
+		{
+			ulItemsRemoved++;
+		}
+	}
+
+	return ulItemsRemoved;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetQueueSetBenchmarkResults( const QueueSetBenchmarkResult_t **ppxResults, uint32_t *pulSweepCount )
+{
+UBaseType_t uxReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*ppxResults = xLastSweepResults;
+		*pulSweepCount = ulSweepCount;
+		uxReturn = uxLastSweepResults;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreQueueSetBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_QUEUE_SETS == 1 ) */
@@ -0,0 +1,341 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures how evenly the work driven by the tick interrupt is spread across
+ * the cores of a multicore build.  On a single core build it measures the
+ * wake up latency of a delayed task.
+ *
+ * One spare capacity task runs on each core at the idle priority, and does
+ * nothing but count.  The number of counts each core makes in a measurement
+ * period is a measure of the time the core has left after the tick interrupt,
+ * the tick hook, the timer daemon task and the other tasks it runs.  The
+ * imbalance is the difference between the most and fewest counts, as a
+ * percentage of the most.
+ *
+ * One wake up task also runs on each core, and wakes every tlbenchWAKE_PERIOD
+ * ticks using vTaskDelayUntil().  The tick hook records the time at which each
+ * tick is processed, so when a wake up task runs it can measure how long it
+ * took to run after the tick that unblocked it was processed.  On a multicore
+ * build a wake up task pinned to a core other than the one that takes the tick
+ * interrupt has to be told to run by the tick core, so its latency includes
+ * the time taken to signal across the cores.  A wake up task that does not run
+ * until a later tick is counted as late rather than included in the latency.
+ *
+ * A higher priority controller task collects the counts at the end of each
+ * tlbenchMEASUREMENT_PERIOD.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count - in
+ * which case the latencies are all 0.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo program include files. */
+#include "TickLoadBenchmark.h"
+
+/* The period over which measurements are made. */
+#define tlbenchMEASUREMENT_PERIOD			pdMS_TO_TICKS( 1000UL )
+
+/* The period at which the wake up tasks wake. */
+#ifndef tlbenchWAKE_PERIOD
+	#define tlbenchWAKE_PERIOD				( ( TickType_t ) 3 )
+#endif
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define tlbenchGET_TIME()				( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define tlbenchGET_TIME()				( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef tlbenchTASK_STACK_SIZE
+	#define tlbenchTASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The counts made on one core during a measurement. */
+typedef struct TICK_LOAD_BENCHMARK_CORE_COUNTS
+{
+	uint32_t ulWakeups;
+	uint32_t ulTotalWakeLatency;
+	uint32_t ulMaxWakeLatency;
+	uint32_t ulLateWakeups;
+} TickLoadBenchmarkCoreCounts_t;
+
+/*
+ * The controller, spare capacity and wake up tasks, as described at the top of
+ * this file.
+ */
+static void prvTickLoadBenchmarkControllerTask( void *pvParameters );
+static void prvSpareCapacityTask( void *pvParameters );
+static void prvWakeUpTask( void *pvParameters );
+
+/*
+ * Create a task and, on a multicore build, pin it to xCore.
+ */
+static void prvCreatePinnedTask( TaskFunction_t pxTaskCode, const char *pcName, BaseType_t xCore, UBaseType_t uxPriority );
+
+/*-----------------------------------------------------------*/
+
+/* Written by the wake up tasks, and read and cleared by the controller at the
+end of each measurement. */
+static TickLoadBenchmarkCoreCounts_t xCoreCounts[ tlbenchNUM_CORES ];
+
+/* Each is only written by the spare capacity task on its core, so is never
+cleared - the controller works with the difference between readings. */
+static volatile uint32_t ulSpareLoops[ tlbenchNUM_CORES ];
+
+/* The tick count and time at which the tick hook last ran.  The time is
+written first, so a reader that sees the same tick count before and after
+reading the time has read the time that goes with it. */
+static volatile uint32_t ulTickStampTime = 0;
+static volatile TickType_t xTickStampTick = 0;
+
+/* The most recent results. */
+static TickLoadBenchmarkResult_t xLastResult;
+static uint32_t ulRunCount = 0;
+
+/* Incremented each time a measurement completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartTickLoadBenchmarkTasks( UBaseType_t uxPriority )
+{
+BaseType_t xCore;
+
+	memset( xCoreCounts, 0x00, sizeof( xCoreCounts ) );
+
+	for( xCore = 0; xCore < tlbenchNUM_CORES; xCore++ )
+	{
+		prvCreatePinnedTask( prvSpareCapacityTask, "TLSpare", xCore, tskIDLE_PRIORITY );
+		prvCreatePinnedTask( prvWakeUpTask, "TLWake", xCore, uxPriority );
+	}
+
+	xTaskCreate( prvTickLoadBenchmarkControllerTask, "TLCtrl", tlbenchTASK_STACK_SIZE, NULL, uxPriority + 1, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreatePinnedTask( TaskFunction_t pxTaskCode, const char *pcName, BaseType_t xCore, UBaseType_t uxPriority )
+{
+TaskHandle_t xTask;
+
+	xTaskCreate( pxTaskCode, pcName, tlbenchTASK_STACK_SIZE, ( void * ) xCore, uxPriority, &xTask );
+
+	#if( configUSE_CORE_AFFINITY == 1 ) && ( tlbenchNUM_CORES > 1 )
+	{
+		vTaskCoreAffinitySet( xTask, ( UBaseType_t ) 1 << xCore );
+	}
+	#else
+	{
+		( void ) xTask;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vTickLoadBenchmarkTickHook( void )
+{
+	ulTickStampTime = tlbenchGET_TIME();
+	portMEMORY_BARRIER();
+	xTickStampTick = xTaskGetTickCountFromISR();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickLoadBenchmarkControllerTask( void *pvParameters )
+{
+TickLoadBenchmarkCoreCounts_t xCounts[ tlbenchNUM_CORES ];
+TickLoadBenchmarkResult_t xResult;
+uint32_t ulLastSpareLoops[ tlbenchNUM_CORES ], ulSpare[ tlbenchNUM_CORES ], ulMost, ulFewest;
+BaseType_t xCore;
+TickType_t xLastWakeTime;
+
+	( void ) pvParameters;
+
+	for( xCore = 0; xCore < tlbenchNUM_CORES; xCore++ )
+	{
+		ulLastSpareLoops[ xCore ] = ulSpareLoops[ xCore ];
+	}
+
+	xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, tlbenchMEASUREMENT_PERIOD );
+
+		for( xCore = 0; xCore < tlbenchNUM_CORES; xCore++ )
+		{
+			ulSpare[ xCore ] = ulSpareLoops[ xCore ] - ulLastSpareLoops[ xCore ];
+			ulLastSpareLoops[ xCore ] += ulSpare[ xCore ];
+		}
+
+		taskENTER_CRITICAL();
+		{
+			memcpy( xCounts, xCoreCounts, sizeof( xCounts ) );
+			memset( xCoreCounts, 0x00, sizeof( xCoreCounts ) );
+		}
+		taskEXIT_CRITICAL();
+
+		ulMost = 0;
+		ulFewest = UINT32_MAX;
+
+		for( xCore = 0; xCore < tlbenchNUM_CORES; xCore++ )
+		{
+			xResult.ulSpareLoopsPerSecond[ xCore ] = ( uint32_t ) ( ( ( uint64_t ) ulSpare[ xCore ] * configTICK_RATE_HZ ) / tlbenchMEASUREMENT_PERIOD );
+			xResult.ulMeanWakeLatency[ xCore ] = ( xCounts[ xCore ].ulWakeups > 0UL ) ? ( xCounts[ xCore ].ulTotalWakeLatency / xCounts[ xCore ].ulWakeups ) : 0UL;
+			xResult.ulMaxWakeLatency[ xCore ] = xCounts[ xCore ].ulMaxWakeLatency;
+			xResult.ulLateWakeups[ xCore ] = xCounts[ xCore ].ulLateWakeups;
+
+			if( ulSpare[ xCore ] > ulMost )
+			{
+				ulMost = ulSpare[ xCore ];
+			}
+
+			if( ulSpare[ xCore ] < ulFewest )
+			{
+				ulFewest = ulSpare[ xCore ];
+			}
+		}
+
+		xResult.ulImbalance = ( ulMost > 0UL ) ? ( uint32_t ) ( ( ( uint64_t ) ( ulMost - ulFewest ) * 100ULL ) / ulMost ) : 0UL;
+
+		taskENTER_CRITICAL();
+		{
+			xLastResult = xResult;
+			ulRunCount++;
+		}
+		taskEXIT_CRITICAL();
+
+		ulLoopCounter++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpareCapacityTask( void *pvParameters )
+{
+const BaseType_t xCore = ( BaseType_t ) pvParameters;
+
+	for( ;; )
+	{
+		ulSpareLoops[ xCore ]++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeUpTask( void *pvParameters )
+{
+const BaseType_t xCore = ( BaseType_t ) pvParameters;
+TickType_t xLastWakeTime, xStampTick;
+uint32_t ulStampTime, ulLatency;
+BaseType_t xLate;
+
+	xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, tlbenchWAKE_PERIOD );
+		ulLatency = tlbenchGET_TIME();
+
+		/* Read the time the tick hook recorded for the tick this task was
+		due to wake in. */
+		xStampTick = xTickStampTick;
+		portMEMORY_BARRIER();
+		ulStampTime = ulTickStampTime;
+		portMEMORY_BARRIER();
+
+		if( ( xStampTick == xLastWakeTime ) && ( xTickStampTick == xStampTick ) )
+		{
+			ulLatency -= ulStampTime;
+			xLate = pdFALSE;
+		}
+		else
+		{
+			xLate = pdTRUE;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			if( xLate != pdFALSE )
+			{
+				xCoreCounts[ xCore ].ulLateWakeups++;
+			}
+			else
+			{
+				xCoreCounts[ xCore ].ulWakeups++;
+				xCoreCounts[ xCore ].ulTotalWakeLatency += ulLatency;
+
+				if( ulLatency > xCoreCounts[ xCore ].ulMaxWakeLatency )
+				{
+					xCoreCounts[ xCore ].ulMaxWakeLatency = ulLatency;
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGetTickLoadBenchmarkResults( TickLoadBenchmarkResult_t *pxResult, uint32_t *pulRunCount )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*pxResult = xLastResult;
+		*pulRunCount = ulRunCount;
+		xReturn = ( ulRunCount > 0UL ) ? pdPASS : pdFAIL;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAreTickLoadBenchmarkTasksStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No measurements have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
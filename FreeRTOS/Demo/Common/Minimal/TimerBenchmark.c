@@ -0,0 +1,437 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Measures how the cost of software timer operations scales with the number of
+ * timers in use.
+ *
+ * The benchmark task repeatedly sweeps from tmrbenchMIN_TIMERS to
+ * tmrbenchMAX_TIMERS timers, doubling the number of timers each step.  Each step
+ * creates the timers with pseudo random periods between tmrbenchMIN_PERIOD and
+ * tmrbenchMAX_PERIOD (three quarters auto-reload, one quarter one-shot), then:
+ *
+ * 1) Times how long it takes to start, reset, then stop every timer.  As the
+ *    benchmark task runs below the priority of the timer service task, the
+ *    measured times include the time the timer service task takes to action
+ *    the commands.
+ *
+ * 2) Restarts every timer and, for tmrbenchEXPIRY_MEASUREMENT_PERIOD ticks,
+ *    records how late each timer callback executes relative to the timer's
+ *    expiry time.  A callback that executes before its expiry time is latched
+ *    as an error.
+ *
+ * Setting tmrbenchUSE_TIMER_WHEEL to 1 benchmarks the timing wheel in
+ * TimerWheel.c rather than the kernel's software timers, so the two can be
+ * compared on the same target.  The timing wheel supports batched commands,
+ * so in that case the timers are also reset using batches of
+ * tmrbenchBATCH_SIZE commands, for comparison with resetting the timers one
+ * command at a time.
+ *
+ * Times are measured using portGET_RUN_TIME_COUNTER_VALUE() if
+ * configGENERATE_RUN_TIME_STATS is 1, otherwise using the tick count.  A step
+ * is skipped if there is not enough free heap for the number of timers it
+ * requires, so tmrbenchMAX_TIMERS can be set to 100000 or more on targets (or
+ * host builds) that have the RAM.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Demo program include files. */
+#include "TimerBenchmark.h"
+
+#ifndef tmrbenchUSE_TIMER_WHEEL
+	#define tmrbenchUSE_TIMER_WHEEL 0
+#endif
+
+#if( tmrbenchUSE_TIMER_WHEEL == 1 )
+	#include "TimerWheel.h"
+
+	/* Map the kernel software timer API used by this file onto the equivalent
+	timing wheel API. */
+	#define TimerHandle_t					WheelTimerHandle_t
+	#define xTimerCreate					xWheelTimerCreate
+	#define xTimerStart						xWheelTimerStart
+	#define xTimerStop						xWheelTimerStop
+	#define xTimerReset						xWheelTimerReset
+	#define xTimerDelete					xWheelTimerDelete
+	#define pvTimerGetTimerID				pvWheelTimerGetTimerID
+#endif
+
+/* The range of timer counts swept by the benchmark. */
+#ifndef tmrbenchMIN_TIMERS
+	#define tmrbenchMIN_TIMERS					( 64UL )
+#endif
+
+#ifndef tmrbenchMAX_TIMERS
+	#define tmrbenchMAX_TIMERS					( 1024UL )
+#endif
+
+/* The number of commands sent in each batch when batched commands are
+benchmarked. */
+#ifndef tmrbenchBATCH_SIZE
+	#define tmrbenchBATCH_SIZE					( 32UL )
+#endif
+
+/* The range of timer periods. */
+#define tmrbenchMIN_PERIOD						pdMS_TO_TICKS( 10UL )
+#define tmrbenchMAX_PERIOD						pdMS_TO_TICKS( 500UL )
+
+/* The time for which callback lateness is measured in each step. */
+#define tmrbenchEXPIRY_MEASUREMENT_PERIOD		pdMS_TO_TICKS( 1000UL )
+
+/* The time between sweeps. */
+#define tmrbenchSWEEP_DELAY						pdMS_TO_TICKS( 1000UL )
+
+/* Time given to the timer service task to process outstanding delete commands
+before the memory used by the benchmark is freed. */
+#define tmrbenchSHORT_DELAY						pdMS_TO_TICKS( 20UL )
+
+/* Enough results for the sweep to double tmrbenchMIN_TIMERS up to 16 times. */
+#define tmrbenchMAX_RESULTS						( 16 )
+
+/* Heap that is left for the rest of the application when deciding if there is
+enough heap to run a step. */
+#define tmrbenchHEAP_MARGIN						( ( size_t ) 4096 )
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#define tmrbenchGET_TIME()					( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+	#define tmrbenchGET_TIME()					( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef tmrbenchTASK_STACK_SIZE
+	#define tmrbenchTASK_STACK_SIZE				configMINIMAL_STACK_SIZE
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Per timer state used to check when each callback executes.  A pointer to the
+structure is used as the timer's ID. */
+typedef struct TIMER_RECORD
+{
+	TickType_t xNextExpiryTime;
+	TickType_t xPeriod;
+	BaseType_t xAutoReload;
+} TimerRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmark, as described at the top of this file.
+ */
+static void prvTimerBenchmarkTask( void *pvParameters );
+
+/*
+ * Run a single step of the benchmark with ulNumberOfTimers timers, storing the
+ * measurements in *pxResult.  Returns pdFAIL if there was not enough memory to
+ * run the step.
+ */
+static BaseType_t prvRunBenchmarkStep( uint32_t ulNumberOfTimers, TimerBenchmarkResult_t *pxResult );
+
+/*
+ * The callback used by all the timers created by the benchmark.
+ */
+static void prvBenchmarkTimerCallback( TimerHandle_t xTimer );
+
+/*-----------------------------------------------------------*/
+
+/* Results from the sweep in progress, and from the last completed sweep. */
+static TimerBenchmarkResult_t xSweepResults[ tmrbenchMAX_RESULTS ];
+static TimerBenchmarkResult_t xLastSweepResults[ tmrbenchMAX_RESULTS ];
+static UBaseType_t uxLastSweepResults = 0;
+static uint32_t ulSweepCount = 0;
+
+#if( tmrbenchUSE_TIMER_WHEEL == 1 )
+	/* Static rather than on the stack so the stack size of the benchmark task
+	does not depend on tmrbenchBATCH_SIZE. */
+	static WheelTimerCommand_t xCommandBatch[ tmrbenchBATCH_SIZE ];
+#endif
+
+/* Accumulated by the timer callback while expiries are being measured. */
+static volatile BaseType_t xMeasuringExpiries = pdFALSE;
+static volatile uint32_t ulExpiries = 0, ulTotalLateness = 0;
+static volatile TickType_t xMaxLateness = 0;
+
+/* Latched to pdTRUE if a timer callback executes before its expiry time. */
+static volatile BaseType_t xErrorDetected = pdFALSE;
+
+/* Incremented each time a step completes so the check task can see the
+benchmark is still running. */
+static volatile uint32_t ulLoopCounter = 0;
+
+/*-----------------------------------------------------------*/
+
+void vStartTimerBenchmarkTask( UBaseType_t uxPriority )
+{
+	#if( tmrbenchUSE_TIMER_WHEEL == 1 )
+	{
+		/* The timing wheel's service task is not created by the scheduler. */
+		if( xTimerWheelServiceStart() != pdPASS )
+		{
+			xErrorDetected = pdTRUE;
+		}
+	}
+	#endif
+
+	xTaskCreate( prvTimerBenchmarkTask, "TmrBench", tmrbenchTASK_STACK_SIZE, NULL, uxPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerBenchmarkTask( void *pvParameters )
+{
+uint32_t ulNumberOfTimers;
+UBaseType_t uxResults;
+
+	( void ) pvParameters;
+
+	/* The measured times include the time taken by the timer service task to
+	process the commands, which is only the case if this task does not preempt
+	it. */
+	configASSERT( uxTaskPriorityGet( NULL ) < configTIMER_TASK_PRIORITY );
+
+	for( ;; )
+	{
+		uxResults = 0;
+
+		for( ulNumberOfTimers = tmrbenchMIN_TIMERS; ( ulNumberOfTimers <= tmrbenchMAX_TIMERS ) && ( uxResults < tmrbenchMAX_RESULTS ); ulNumberOfTimers <<= 1UL )
+		{
+			if( prvRunBenchmarkStep( ulNumberOfTimers, &( xSweepResults[ uxResults ] ) ) != pdPASS )
+			{
+				/* Not enough heap for this many timers, so there is no point
+				trying more. */
+				break;
+			}
+
+			uxResults++;
+			ulLoopCounter++;
+		}
+
+		/* Make the completed sweep available to the check task. */
+		taskENTER_CRITICAL();
+		{
+			memcpy( xLastSweepResults, xSweepResults, sizeof( xSweepResults ) );
+			uxLastSweepResults = uxResults;
+			ulSweepCount++;
+		}
+		taskEXIT_CRITICAL();
+
+		vTaskDelay( tmrbenchSWEEP_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRunBenchmarkStep( uint32_t ulNumberOfTimers, TimerBenchmarkResult_t *pxResult )
+{
+TimerHandle_t *pxTimers;
+TimerRecord_t *pxRecords;
+uint32_t ulTimer, ulStartTime;
+TickType_t xNextRand = ( TickType_t ) ulNumberOfTimers, xTimeNow;
+const size_t xBytesPerTimer = sizeof( TimerHandle_t ) + sizeof( TimerRecord_t ) + sizeof( StaticTimer_t ) + ( 2 * portBYTE_ALIGNMENT );
+
+	if( xPortGetFreeHeapSize() < ( ( ulNumberOfTimers * xBytesPerTimer ) + tmrbenchHEAP_MARGIN ) )
+	{
+		return pdFAIL;
+	}
+
+	pxTimers = ( TimerHandle_t * ) pvPortMalloc( ulNumberOfTimers * sizeof( TimerHandle_t ) );
+	pxRecords = ( TimerRecord_t * ) pvPortMalloc( ulNumberOfTimers * sizeof( TimerRecord_t ) );
+	configASSERT( pxTimers );
+	configASSERT( pxRecords );
+
+	memset( pxResult, 0x00, sizeof( TimerBenchmarkResult_t ) );
+	pxResult->ulNumberOfTimers = ulNumberOfTimers;
+
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		/* Generate a pseudo random period so timers expire in a mixed order. */
+		xNextRand = ( xNextRand * ( TickType_t ) 1103515245UL ) + ( TickType_t ) 12345UL;
+		pxRecords[ ulTimer ].xPeriod = tmrbenchMIN_PERIOD + ( ( xNextRand >> 8 ) % ( tmrbenchMAX_PERIOD - tmrbenchMIN_PERIOD ) );
+		pxRecords[ ulTimer ].xAutoReload = ( ( ulTimer & 0x03UL ) != 0UL ) ? pdTRUE : pdFALSE;
+
+		pxTimers[ ulTimer ] = xTimerCreate( "Bench", pxRecords[ ulTimer ].xPeriod, ( UBaseType_t ) pxRecords[ ulTimer ].xAutoReload, ( void * ) &( pxRecords[ ulTimer ] ), prvBenchmarkTimerCallback );
+		configASSERT( pxTimers[ ulTimer ] );
+	}
+
+	/* Time starting, resetting then stopping every timer. */
+	ulStartTime = tmrbenchGET_TIME();
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		xTimerStart( pxTimers[ ulTimer ], portMAX_DELAY );
+	}
+	pxResult->ulStartTime = tmrbenchGET_TIME() - ulStartTime;
+
+	ulStartTime = tmrbenchGET_TIME();
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		xTimerReset( pxTimers[ ulTimer ], portMAX_DELAY );
+	}
+	pxResult->ulResetTime = tmrbenchGET_TIME() - ulStartTime;
+
+	#if( tmrbenchUSE_TIMER_WHEEL == 1 )
+	{
+	uint32_t ulInBatch = 0;
+
+		ulStartTime = tmrbenchGET_TIME();
+		for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+		{
+			xCommandBatch[ ulInBatch ].xTimer = pxTimers[ ulTimer ];
+			xCommandBatch[ ulInBatch ].xCommandID = twheelCOMMAND_RESET;
+			xCommandBatch[ ulInBatch ].xOptionalValue = 0;
+			ulInBatch++;
+
+			if( ( ulInBatch == tmrbenchBATCH_SIZE ) || ( ulTimer == ( ulNumberOfTimers - 1UL ) ) )
+			{
+				xWheelTimerSendCommandBatch( xCommandBatch, ( UBaseType_t ) ulInBatch, portMAX_DELAY );
+				ulInBatch = 0;
+			}
+		}
+		pxResult->ulBatchResetTime = tmrbenchGET_TIME() - ulStartTime;
+	}
+	#endif
+
+	ulStartTime = tmrbenchGET_TIME();
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		xTimerStop( pxTimers[ ulTimer ], portMAX_DELAY );
+	}
+	pxResult->ulStopTime = tmrbenchGET_TIME() - ulStartTime;
+
+	/* Restart all the timers, noting when each is expected to expire, then
+	measure callback lateness for a while. */
+	ulExpiries = 0;
+	ulTotalLateness = 0;
+	xMaxLateness = 0;
+
+	xMeasuringExpiries = pdTRUE;
+
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		/* The expiry time is calculated from the tick count at the time the
+		start command is sent. */
+		xTimeNow = xTaskGetTickCount();
+		pxRecords[ ulTimer ].xNextExpiryTime = xTimeNow + pxRecords[ ulTimer ].xPeriod;
+		xTimerStart( pxTimers[ ulTimer ], portMAX_DELAY );
+	}
+
+	vTaskDelay( tmrbenchEXPIRY_MEASUREMENT_PERIOD );
+	xMeasuringExpiries = pdFALSE;
+
+	pxResult->ulExpiries = ulExpiries;
+	pxResult->ulTotalLateness = ulTotalLateness;
+	pxResult->xMaxLateness = xMaxLateness;
+
+	/* Clean up.  The timer service task frees the timers, so wait for it to
+	do so before freeing the records the timers reference. */
+	for( ulTimer = 0; ulTimer < ulNumberOfTimers; ulTimer++ )
+	{
+		xTimerDelete( pxTimers[ ulTimer ], portMAX_DELAY );
+	}
+
+	vTaskDelay( tmrbenchSHORT_DELAY );
+	vPortFree( pxRecords );
+	vPortFree( pxTimers );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTimerCallback( TimerHandle_t xTimer )
+{
+TimerRecord_t *pxRecord = ( TimerRecord_t * ) pvTimerGetTimerID( xTimer );
+TickType_t xLateness;
+
+	if( xMeasuringExpiries != pdFALSE )
+	{
+		xLateness = xTaskGetTickCount() - pxRecord->xNextExpiryTime;
+
+		if( xLateness > ( portMAX_DELAY >> 1 ) )
+		{
+			/* The callback executed before the timer's expiry time. */
+			xErrorDetected = pdTRUE;
+		}
+		else
+		{
+			ulExpiries++;
+			ulTotalLateness += ( uint32_t ) xLateness;
+
+			if( xLateness > xMaxLateness )
+			{
+				xMaxLateness = xLateness;
+			}
+		}
+
+		if( pxRecord->xAutoReload != pdFALSE )
+		{
+			pxRecord->xNextExpiryTime += pxRecord->xPeriod;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetTimerBenchmarkResults( const TimerBenchmarkResult_t **ppxResults, uint32_t *pulSweepCount )
+{
+UBaseType_t uxReturn;
+
+	taskENTER_CRITICAL();
+	{
+		*ppxResults = xLastSweepResults;
+		*pulSweepCount = ulSweepCount;
+		uxReturn = uxLastSweepResults;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIsTimerBenchmarkTaskStillRunning( void )
+{
+static uint32_t ulLastLoopCounter = 0;
+BaseType_t xReturn = pdPASS;
+
+	if( ulLastLoopCounter == ulLoopCounter )
+	{
+		/* No steps have completed since the last call. */
+		xReturn = pdFAIL;
+	}
+
+	ulLastLoopCounter = ulLoopCounter;
+
+	if( xErrorDetected != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
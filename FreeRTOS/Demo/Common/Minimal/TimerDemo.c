@@ -29,6 +29,10 @@
 /*
  * Tests the behaviour of timers.  Some timers are created before the scheduler
  * is started, and some after.
+ *
+ * Setting tmrdemoUSE_TIMER_WHEEL to 1 runs the same tests against the timing
+ * wheel implementation in TimerWheel.c instead of the kernel's software timers,
+ * plus an additional test of the timing wheel's batched command API.
  */
 
 /* Standard includes. */
@@ -42,6 +46,32 @@
 /* Demo program include files. */
 #include "TimerDemo.h"
 
+#ifndef tmrdemoUSE_TIMER_WHEEL
+	#define tmrdemoUSE_TIMER_WHEEL 0
+#endif
+
+#if( tmrdemoUSE_TIMER_WHEEL == 1 )
+	#include "TimerWheel.h"
+
+	/* Map the kernel software timer API used by this file onto the equivalent
+	timing wheel API. */
+	#define TimerHandle_t					WheelTimerHandle_t
+	#define xTimerCreate					xWheelTimerCreate
+	#define xTimerStart						xWheelTimerStart
+	#define xTimerStop						xWheelTimerStop
+	#define xTimerReset						xWheelTimerReset
+	#define xTimerStartFromISR				xWheelTimerStartFromISR
+	#define xTimerStopFromISR				xWheelTimerStopFromISR
+	#define xTimerResetFromISR				xWheelTimerResetFromISR
+	#define xTimerChangePeriodFromISR		xWheelTimerChangePeriodFromISR
+	#define xTimerIsTimerActive				xWheelTimerIsTimerActive
+	#define pvTimerGetTimerID				pvWheelTimerGetTimerID
+	#define vTimerSetTimerID				vWheelTimerSetTimerID
+	#define pcTimerGetName					pcWheelTimerGetName
+	#define vTimerSetReloadMode				vWheelTimerSetReloadMode
+	#define uxTimerGetReloadMode			uxWheelTimerGetReloadMode
+#endif
+
 #if ( configTIMER_TASK_PRIORITY < 1 )
 	#error configTIMER_TASK_PRIORITY must be set to at least 1 for this test/demo to function correctly.
 #endif
@@ -87,6 +117,10 @@ static void prvTest5_CheckBasicOneShotTimerBehaviour( void );
 static void prvTest6_CheckAutoReloadResetBehaviour( void );
 static void prvResetStartConditionsForNextIteration( void );
 
+#if( tmrdemoUSE_TIMER_WHEEL == 1 )
+	static void prvTest7_CheckBatchedCommands( void );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Flag that will be latched to pdFAIL should any unexpected behaviour be
@@ -138,6 +172,17 @@ void vStartTimerDemoTask( TickType_t xBasePeriodIn )
 	(multiples of). */
 	xBasePeriod = xBasePeriodIn;
 
+	#if( tmrdemoUSE_TIMER_WHEEL == 1 )
+	{
+		/* The timing wheel's service task is not created by the scheduler, so
+		must be created before the timers. */
+		if( xTimerWheelServiceStart() != pdPASS )
+		{
+			xTestStatus = pdFAIL;
+		}
+	}
+	#endif
+
 	/* Create a set of timers for use by this demo/test. */
 	prvTest1_CreateTimersWithoutSchedulerRunning();
 
@@ -206,6 +251,14 @@ static void prvTimerTestTask( void *pvParameters )
 		/* Check timer reset behaviour. */
 		prvTest6_CheckAutoReloadResetBehaviour();
 
+		#if( tmrdemoUSE_TIMER_WHEEL == 1 )
+		{
+			/* Check timers can be started and stopped using a single batch of
+			commands. */
+			prvTest7_CheckBatchedCommands();
+		}
+		#endif
+
 		/* Start the timers again to restart all the tests over again. */
 		prvResetStartConditionsForNextIteration();
 	}
@@ -671,6 +724,102 @@ uint8_t ucTimer;
 }
 /*-----------------------------------------------------------*/
 
+#if( tmrdemoUSE_TIMER_WHEEL == 1 )
+
+	static void prvTest7_CheckBatchedCommands( void )
+	{
+	WheelTimerCommand_t xCommands[ configTIMER_QUEUE_LENGTH ];
+	uint8_t ucTimer;
+
+		/* All the auto-reload timers are inactive at this point.  Start them all
+		with a single batch of commands. */
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			xCommands[ ucTimer ].xTimer = xAutoReloadTimers[ ucTimer ];
+			xCommands[ ucTimer ].xCommandID = twheelCOMMAND_START;
+			xCommands[ ucTimer ].xOptionalValue = 0;
+		}
+
+		if( xWheelTimerSendCommandBatch( xCommands, ( UBaseType_t ) configTIMER_QUEUE_LENGTH, tmrdemoDONT_BLOCK ) != pdPASS )
+		{
+			xTestStatus = pdFAIL;
+			configASSERT( xTestStatus );
+		}
+
+		/* The batch has been processed by the time the above function returns,
+		so all the timers should now be active. */
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			if( xTimerIsTimerActive( xAutoReloadTimers[ ucTimer ] ) == pdFALSE )
+			{
+				xTestStatus = pdFAIL;
+				configASSERT( xTestStatus );
+			}
+		}
+
+		/* Delay long enough for every timer to expire at least once. */
+		vTaskDelay( ( ( TickType_t ) configTIMER_QUEUE_LENGTH + ( TickType_t ) 1 ) * xBasePeriod );
+
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			if( ucAutoReloadTimerCounters[ ucTimer ] == ( uint8_t ) 0 )
+			{
+				xTestStatus = pdFAIL;
+				configASSERT( xTestStatus );
+			}
+		}
+
+		/* Stop all the timers again with a single batch, which leaves them in the
+		state expected by prvResetStartConditionsForNextIteration(). */
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			xCommands[ ucTimer ].xCommandID = twheelCOMMAND_STOP;
+		}
+
+		if( xWheelTimerSendCommandBatch( xCommands, ( UBaseType_t ) configTIMER_QUEUE_LENGTH, tmrdemoDONT_BLOCK ) != pdPASS )
+		{
+			xTestStatus = pdFAIL;
+			configASSERT( xTestStatus );
+		}
+
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			if( xTimerIsTimerActive( xAutoReloadTimers[ ucTimer ] ) != pdFALSE )
+			{
+				xTestStatus = pdFAIL;
+				configASSERT( xTestStatus );
+			}
+		}
+
+		/* None of the callbacks should execute now the timers are stopped. */
+		taskENTER_CRITICAL();
+		{
+			memset( ( void * ) ucAutoReloadTimerCounters, 0, sizeof( ucAutoReloadTimerCounters ) );
+		}
+		taskEXIT_CRITICAL();
+
+		vTaskDelay( ( ( TickType_t ) configTIMER_QUEUE_LENGTH ) * xBasePeriod );
+
+		for( ucTimer = 0; ucTimer < ( uint8_t ) configTIMER_QUEUE_LENGTH; ucTimer++ )
+		{
+			if( ucAutoReloadTimerCounters[ ucTimer ] != ( uint8_t ) 0 )
+			{
+				xTestStatus = pdFAIL;
+				configASSERT( xTestStatus );
+			}
+		}
+
+		if( xTestStatus == pdPASS )
+		{
+			/* No errors have been reported so increment the loop counter so the
+			check task knows this task is still running. */
+			ulLoopCounter++;
+		}
+	}
+
+#endif /* tmrdemoUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
 static void prvResetStartConditionsForNextIteration( void )
 {
 uint8_t ucTimer;
@@ -0,0 +1,765 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A software timer service built on a hierarchical timing wheel.
+ *
+ * The kernel's timer service task keeps active timers in a list sorted by
+ * expiry time, so starting or resetting a timer is O(n) in the number of
+ * active timers.  That is fine for the handful of timers most applications
+ * use, but not for applications that use thousands of timers.  This file
+ * instead keeps active timers in twheelNUM_LEVELS wheels of twheelNUM_SLOTS
+ * slots each.  A timer that expires within twheelNUM_SLOTS ticks is linked into
+ * a slot of the first wheel, indexed directly by its expiry time.  Timers that
+ * expire further in the future are linked into the coarser wheels, and are
+ * cascaded down into the finer wheels as time advances.  Inserting, removing
+ * and expiring a timer are therefore all O(1) operations.
+ *
+ * As with the kernel implementation, timers are manipulated by sending
+ * commands to a queue that is serviced by a single task, so the wheels
+ * themselves are only ever accessed from that task and need no locking.  The
+ * task blocks indefinitely when no timers are active, and otherwise wakes on
+ * each tick to advance the wheel.
+ *
+ * xWheelTimerSendCommandBatch() sends any number of commands in a single queue
+ * message, so an application that restarts many timers at once (for example,
+ * a set of watchdog timers that are all reset each tick) pays for one queue
+ * write and at most one context switch rather than one per timer.  The timer
+ * wheel task actions all the commands in the batch in a single pass.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo program include files. */
+#include "TimerWheel.h"
+
+/* The number of slots in each wheel is 2 ^ twheelSLOT_BITS. */
+#define twheelSLOT_BITS				( 6U )
+#define twheelNUM_SLOTS				( 1U << twheelSLOT_BITS )
+#define twheelSLOT_MASK				( ( TickType_t ) ( twheelNUM_SLOTS - 1U ) )
+
+/* The wheels together span 2 ^ ( twheelSLOT_BITS * twheelNUM_LEVELS ) ticks.
+Timers that expire further in the future than that are parked in the last slot
+of the coarsest wheel and re-inserted each time that slot is cascaded. */
+#if( configUSE_16_BIT_TICKS == 1 )
+	/* Three wheels already span more than the whole tick range. */
+	#define twheelNUM_LEVELS		( 3U )
+	#define twheelMAX_DELTA			( ( TickType_t ) 0xffffU )
+#else
+	#define twheelNUM_LEVELS		( 4U )
+	#define twheelMAX_DELTA			( ( TickType_t ) ( ( 1UL << ( twheelSLOT_BITS * ( twheelNUM_LEVELS - 1U ) ) ) * ( twheelNUM_SLOTS - 1UL ) ) )
+#endif
+
+/* The timer wheel service task uses the same priority, stack size and queue
+length as the kernel's timer service task unless configured otherwise. */
+#ifndef twheelTASK_PRIORITY
+	#define twheelTASK_PRIORITY		configTIMER_TASK_PRIORITY
+#endif
+
+#ifndef twheelTASK_STACK_DEPTH
+	#define twheelTASK_STACK_DEPTH	configTIMER_TASK_STACK_DEPTH
+#endif
+
+#ifndef twheelQUEUE_LENGTH
+	#define twheelQUEUE_LENGTH		configTIMER_QUEUE_LENGTH
+#endif
+
+/* The task notification index used to tell a task that sent a batch of
+commands that the batch has been processed.  The default uses the last index,
+which is also the only index if configTASK_NOTIFICATION_ARRAY_ENTRIES is 1 - in
+which case tasks that send command batches must not use task notifications for
+anything else. */
+#ifndef twheelBATCH_NOTIFICATION_INDEX
+	#define twheelBATCH_NOTIFICATION_INDEX	( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#define twheelNO_DELAY				( ( TickType_t ) 0U )
+
+/* Command ID used internally to send a batch of commands. */
+#define twheelCOMMAND_EXECUTE_BATCH	( ( BaseType_t ) 0 )
+
+/* Bits used in the ucStatus member of a timer. */
+#define twheelSTATUS_IS_ACTIVE		( ( uint8_t ) 0x01 )
+#define twheelSTATUS_IS_AUTORELOAD	( ( uint8_t ) 0x02 )
+
+/*-----------------------------------------------------------*/
+
+/* The definition of the timers themselves.  Timers in the same slot are held in
+a NULL terminated doubly linked list.  ppxPrevious points to whichever pointer
+references the timer (either the slot itself or the pxNext member of the
+preceding timer), so a timer can be removed from its slot without knowing which
+slot it is in. */
+typedef struct WheelTimerControlBlock
+{
+	struct WheelTimerControlBlock *pxNext;
+	struct WheelTimerControlBlock **ppxPrevious;	/*<< NULL when the timer is not in a slot. */
+	TickType_t xExpiryTime;
+	TickType_t xPeriod;
+	void *pvTimerID;
+	const char *pcTimerName;
+	WheelTimerCallbackFunction_t pxCallbackFunction;
+	uint8_t ucStatus;
+} WheelTimer_t;
+
+/* The definition of messages that are sent to the timer wheel task.  As in the
+kernel's timers.c, the parameters depend on the message ID, so are held in a
+union. */
+typedef struct WheelTimerParameters
+{
+	TickType_t xMessageValue;
+	WheelTimer_t *pxTimer;
+} WheelTimerParameter_t;
+
+typedef struct WheelTimerBatchParameters
+{
+	const WheelTimerCommand_t *pxCommands;
+	UBaseType_t uxNumberOfCommands;
+	TickType_t xCommandTime;		/*<< The tick count when the batch was sent. */
+	TaskHandle_t xSendingTask;		/*<< Notified when the batch has been processed. */
+} WheelTimerBatchParameter_t;
+
+typedef struct WheelTimerMessage
+{
+	BaseType_t xMessageID;
+	union
+	{
+		WheelTimerParameter_t xTimerParameters;
+		WheelTimerBatchParameter_t xBatchParameters;
+	} u;
+} WheelTimerMessage_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that owns the timing wheel.
+ */
+static void prvTimerWheelTask( void *pvParameters );
+
+/*
+ * Wait for a command or the next tick, then bring the wheel up to date and
+ * action any commands that have been received.  Called in a loop by the timer
+ * wheel task.
+ */
+static void prvProcessTimerQueue( void );
+
+/*
+ * Advance the wheel one tick at a time until it catches up with xTimeNow,
+ * cascading and expiring timers as it goes.
+ */
+static void prvAdvanceWheel( TickType_t xTimeNow );
+
+/*
+ * Action a message received on the command queue.
+ */
+static void prvProcessReceivedCommand( const WheelTimerMessage_t *pxMessage );
+
+/*
+ * Action a single timer command, either received on its own or as part of a
+ * batch.
+ */
+static void prvProcessTimerCommand( WheelTimer_t *pxTimer, BaseType_t xCommandID, TickType_t xCommandValue );
+
+/*
+ * Start pxTimer so it next expires one period after xCommandTime.  If that time
+ * has already passed the callback is executed immediately - once for each
+ * elapsed period if the timer is an auto-reload timer.
+ */
+static void prvStartTimer( WheelTimer_t *pxTimer, TickType_t xCommandTime );
+
+/*
+ * Insert a timer into, and remove a timer from, the wheel.
+ */
+static void prvLinkTimer( WheelTimer_t *pxTimer );
+static void prvUnlinkTimer( WheelTimer_t *pxTimer );
+
+/*-----------------------------------------------------------*/
+
+/* The wheels.  Each slot holds the head of a list of timers. */
+static WheelTimer_t *pxWheel[ twheelNUM_LEVELS ][ twheelNUM_SLOTS ];
+
+/* The tick count up to which the wheel has been processed, and the number of
+timers currently linked into the wheel. */
+static TickType_t xWheelTime = ( TickType_t ) 0U;
+static UBaseType_t uxLinkedTimers = ( UBaseType_t ) 0U;
+
+/* The queue used to send commands to the timer wheel task. */
+static QueueHandle_t xTimerWheelQueue = NULL;
+
+/* The handle of the timer wheel task, used to detect attempts to send a batch
+of commands from a timer callback. */
+static TaskHandle_t xTimerWheelTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerWheelServiceStart( void )
+{
+BaseType_t xReturn = pdPASS;
+
+	if( xTimerWheelQueue == NULL )
+	{
+		memset( pxWheel, 0x00, sizeof( pxWheel ) );
+		xWheelTime = xTaskGetTickCount();
+
+		xTimerWheelQueue = xQueueCreate( twheelQUEUE_LENGTH, sizeof( WheelTimerMessage_t ) );
+
+		if( xTimerWheelQueue != NULL )
+		{
+			vQueueAddToRegistry( xTimerWheelQueue, "TWheelQ" );
+			xReturn = xTaskCreate( prvTimerWheelTask, "TWheel", twheelTASK_STACK_DEPTH, NULL, twheelTASK_PRIORITY, &xTimerWheelTask );
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	configASSERT( xReturn );
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+WheelTimerHandle_t xWheelTimerCreate( const char * const pcTimerName,
+									  const TickType_t xTimerPeriodInTicks,
+									  const UBaseType_t uxAutoReload,
+									  void * const pvTimerID,
+									  WheelTimerCallbackFunction_t pxCallbackFunction )
+{
+WheelTimer_t *pxNewTimer;
+
+	/* 0 is not a valid value for xTimerPeriodInTicks. */
+	configASSERT( ( xTimerPeriodInTicks > 0 ) );
+
+	pxNewTimer = ( WheelTimer_t * ) pvPortMalloc( sizeof( WheelTimer_t ) );
+
+	if( pxNewTimer != NULL )
+	{
+		pxNewTimer->pxNext = NULL;
+		pxNewTimer->ppxPrevious = NULL;
+		pxNewTimer->xExpiryTime = ( TickType_t ) 0U;
+		pxNewTimer->xPeriod = xTimerPeriodInTicks;
+		pxNewTimer->pvTimerID = pvTimerID;
+		pxNewTimer->pcTimerName = pcTimerName;
+		pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+		pxNewTimer->ucStatus = ( uxAutoReload != pdFALSE ) ? twheelSTATUS_IS_AUTORELOAD : 0x00;
+	}
+
+	return pxNewTimer;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWheelTimerGenericCommand( WheelTimerHandle_t xTimer,
+									  const BaseType_t xCommandID,
+									  const TickType_t xOptionalValue,
+									  BaseType_t * const pxHigherPriorityTaskWoken,
+									  const TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+WheelTimerMessage_t xMessage;
+
+	configASSERT( xTimer );
+
+	/* Send a message to the timer wheel task to perform a particular action
+	on a particular timer definition. */
+	if( xTimerWheelQueue != NULL )
+	{
+		xMessage.xMessageID = xCommandID;
+		xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
+		xMessage.u.xTimerParameters.pxTimer = xTimer;
+
+		if( xCommandID < twheelFIRST_FROM_ISR_COMMAND )
+		{
+			/* The block time is ignored if the scheduler is not running, just
+			as it is by the kernel implementation. */
+			if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+			{
+				xReturn = xQueueSendToBack( xTimerWheelQueue, &xMessage, xTicksToWait );
+			}
+			else
+			{
+				xReturn = xQueueSendToBack( xTimerWheelQueue, &xMessage, twheelNO_DELAY );
+			}
+		}
+		else
+		{
+			xReturn = xQueueSendToBackFromISR( xTimerWheelQueue, &xMessage, pxHigherPriorityTaskWoken );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWheelTimerSendCommandBatch( const WheelTimerCommand_t * const pxCommands,
+										const UBaseType_t uxNumberOfCommands,
+										const TickType_t xTicksToWait )
+{
+BaseType_t xReturn = pdFAIL;
+WheelTimerMessage_t xMessage;
+
+	configASSERT( pxCommands );
+
+	/* The calling task blocks until the batch has been processed, so batches
+	cannot be sent before the scheduler has started or from a timer callback. */
+	configASSERT( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING );
+	configASSERT( xTaskGetCurrentTaskHandle() != xTimerWheelTask );
+
+	if( uxNumberOfCommands == ( UBaseType_t ) 0U )
+	{
+		xReturn = pdPASS;
+	}
+	else if( xTimerWheelQueue != NULL )
+	{
+		xMessage.xMessageID = twheelCOMMAND_EXECUTE_BATCH;
+		xMessage.u.xBatchParameters.pxCommands = pxCommands;
+		xMessage.u.xBatchParameters.uxNumberOfCommands = uxNumberOfCommands;
+		xMessage.u.xBatchParameters.xCommandTime = xTaskGetTickCount();
+		xMessage.u.xBatchParameters.xSendingTask = xTaskGetCurrentTaskHandle();
+
+		/* Clear any stale notification before sending the batch. */
+		( void ) ulTaskNotifyTakeIndexed( twheelBATCH_NOTIFICATION_INDEX, pdTRUE, twheelNO_DELAY );
+
+		xReturn = xQueueSendToBack( xTimerWheelQueue, &xMessage, xTicksToWait );
+
+		if( xReturn != pdFAIL )
+		{
+			/* The commands are read from the caller's array, so wait for the
+			timer wheel task to finish with it. */
+			( void ) ulTaskNotifyTakeIndexed( twheelBATCH_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWheelTimerIsTimerActive( WheelTimerHandle_t xTimer )
+{
+BaseType_t xReturn;
+
+	configASSERT( xTimer );
+
+	taskENTER_CRITICAL();
+	{
+		xReturn = ( ( xTimer->ucStatus & twheelSTATUS_IS_ACTIVE ) != 0 ) ? pdTRUE : pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *pvWheelTimerGetTimerID( const WheelTimerHandle_t xTimer )
+{
+void *pvReturn;
+
+	configASSERT( xTimer );
+
+	taskENTER_CRITICAL();
+	{
+		pvReturn = xTimer->pvTimerID;
+	}
+	taskEXIT_CRITICAL();
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vWheelTimerSetTimerID( WheelTimerHandle_t xTimer, void *pvNewID )
+{
+	configASSERT( xTimer );
+
+	taskENTER_CRITICAL();
+	{
+		xTimer->pvTimerID = pvNewID;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+const char * pcWheelTimerGetName( WheelTimerHandle_t xTimer )
+{
+	configASSERT( xTimer );
+	return xTimer->pcTimerName;
+}
+/*-----------------------------------------------------------*/
+
+void vWheelTimerSetReloadMode( WheelTimerHandle_t xTimer, const UBaseType_t uxAutoReload )
+{
+	configASSERT( xTimer );
+
+	taskENTER_CRITICAL();
+	{
+		if( uxAutoReload != pdFALSE )
+		{
+			xTimer->ucStatus |= twheelSTATUS_IS_AUTORELOAD;
+		}
+		else
+		{
+			xTimer->ucStatus &= ( uint8_t ) ~twheelSTATUS_IS_AUTORELOAD;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxWheelTimerGetReloadMode( WheelTimerHandle_t xTimer )
+{
+UBaseType_t uxReturn;
+
+	configASSERT( xTimer );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = ( ( xTimer->ucStatus & twheelSTATUS_IS_AUTORELOAD ) != 0 ) ? ( UBaseType_t ) pdTRUE : ( UBaseType_t ) pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xWheelTimerGetPeriod( WheelTimerHandle_t xTimer )
+{
+	configASSERT( xTimer );
+	return xTimer->xPeriod;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xWheelTimerGetExpiryTime( WheelTimerHandle_t xTimer )
+{
+	configASSERT( xTimer );
+	return xTimer->xExpiryTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimerWheelTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvProcessTimerQueue();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessTimerQueue( void )
+{
+WheelTimerMessage_t xMessage;
+TickType_t xBlockTime;
+
+	/* There is no need to wake on each tick if there are no timers to
+	expire. */
+	xBlockTime = ( uxLinkedTimers == ( UBaseType_t ) 0U ) ? portMAX_DELAY : ( TickType_t ) 1U;
+
+	if( xQueueReceive( xTimerWheelQueue, &xMessage, xBlockTime ) != pdFAIL )
+	{
+		do
+		{
+			/* Timers are always inserted relative to the current time, so
+			bring the wheel up to date before actioning each command.  The
+			tick count is read again for each command because a command can
+			be sent - from an interrupt or from another core - after the
+			previous command was received, and so carry a command time later
+			than the time the wheel was last advanced to.  A command is always
+			sent before it is received, so the tick count read after receiving
+			it is never earlier than its command time. */
+			prvAdvanceWheel( xTaskGetTickCount() );
+			prvProcessReceivedCommand( &xMessage );
+		} while( xQueueReceive( xTimerWheelQueue, &xMessage, twheelNO_DELAY ) != pdFAIL );
+	}
+	else
+	{
+		prvAdvanceWheel( xTaskGetTickCount() );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdvanceWheel( TickType_t xTimeNow )
+{
+WheelTimer_t *pxTimer, *pxNextTimer;
+TickType_t xIndex;
+UBaseType_t uxLevel;
+
+	if( uxLinkedTimers == ( UBaseType_t ) 0U )
+	{
+		/* Nothing to expire, so there is no need to step through the
+		intervening ticks one at a time. */
+		xWheelTime = xTimeNow;
+	}
+
+	while( xWheelTime != xTimeNow )
+	{
+		xWheelTime++;
+
+		/* Each time the index into a wheel wraps back to zero the next slot of
+		the next coarser wheel is emptied into the finer wheels.  This must be
+		done before the slot of the finest wheel is expired as timers that
+		expire on this tick may be cascaded into it. */
+		xIndex = xWheelTime & twheelSLOT_MASK;
+
+		for( uxLevel = 1; ( uxLevel < twheelNUM_LEVELS ) && ( xIndex == ( TickType_t ) 0U ); uxLevel++ )
+		{
+			xIndex = ( xWheelTime >> ( uxLevel * twheelSLOT_BITS ) ) & twheelSLOT_MASK;
+
+			pxTimer = pxWheel[ uxLevel ][ xIndex ];
+			pxWheel[ uxLevel ][ xIndex ] = NULL;
+
+			while( pxTimer != NULL )
+			{
+				pxNextTimer = pxTimer->pxNext;
+				uxLinkedTimers--;
+				pxTimer->ppxPrevious = NULL;
+				prvLinkTimer( pxTimer );
+				pxTimer = pxNextTimer;
+			}
+		}
+
+		/* Detach the list of timers that expire on this tick before calling
+		any callbacks, so auto-reload timers that get re-inserted into the same
+		slot are not processed twice. */
+		xIndex = xWheelTime & twheelSLOT_MASK;
+		pxTimer = pxWheel[ 0 ][ xIndex ];
+		pxWheel[ 0 ][ xIndex ] = NULL;
+
+		while( pxTimer != NULL )
+		{
+			pxNextTimer = pxTimer->pxNext;
+			uxLinkedTimers--;
+			pxTimer->ppxPrevious = NULL;
+
+			if( pxTimer->xExpiryTime != xWheelTime )
+			{
+				/* A timer is only placed in the finest wheel if it expires
+				within one revolution of it, so this should not happen - but
+				re-link the timer rather than expire it early if it does. */
+				prvLinkTimer( pxTimer );
+			}
+			else
+			{
+				if( ( pxTimer->ucStatus & twheelSTATUS_IS_AUTORELOAD ) != 0 )
+				{
+					prvStartTimer( pxTimer, pxTimer->xExpiryTime );
+				}
+				else
+				{
+					pxTimer->ucStatus &= ( uint8_t ) ~twheelSTATUS_IS_ACTIVE;
+				}
+
+				pxTimer->pxCallbackFunction( ( WheelTimerHandle_t ) pxTimer );
+			}
+
+			pxTimer = pxNextTimer;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessReceivedCommand( const WheelTimerMessage_t *pxMessage )
+{
+const WheelTimerBatchParameter_t *pxBatch;
+const WheelTimerCommand_t *pxCommand;
+UBaseType_t uxCommand;
+
+	if( pxMessage->xMessageID == twheelCOMMAND_EXECUTE_BATCH )
+	{
+		pxBatch = &( pxMessage->u.xBatchParameters );
+
+		for( uxCommand = 0; uxCommand < pxBatch->uxNumberOfCommands; uxCommand++ )
+		{
+			pxCommand = &( pxBatch->pxCommands[ uxCommand ] );
+
+			/* Only task level commands can be batched. */
+			configASSERT( pxCommand->xCommandID < twheelFIRST_FROM_ISR_COMMAND );
+
+			/* Start and reset commands are timed from when the batch was sent.
+			Other commands use the value provided with the command. */
+			if( ( pxCommand->xCommandID == twheelCOMMAND_START ) || ( pxCommand->xCommandID == twheelCOMMAND_RESET ) )
+			{
+				prvProcessTimerCommand( pxCommand->xTimer, pxCommand->xCommandID, pxBatch->xCommandTime );
+			}
+			else
+			{
+				prvProcessTimerCommand( pxCommand->xTimer, pxCommand->xCommandID, pxCommand->xOptionalValue );
+			}
+		}
+
+		/* The sending task can now reuse its array of commands. */
+		( void ) xTaskNotifyGiveIndexed( pxBatch->xSendingTask, twheelBATCH_NOTIFICATION_INDEX );
+	}
+	else
+	{
+		prvProcessTimerCommand( pxMessage->u.xTimerParameters.pxTimer, pxMessage->xMessageID, pxMessage->u.xTimerParameters.xMessageValue );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessTimerCommand( WheelTimer_t *pxTimer, BaseType_t xCommandID, TickType_t xCommandValue )
+{
+	configASSERT( pxTimer );
+
+	/* Whatever the command, the timer's current position in the wheel (if it
+	has one) is no longer valid. */
+	prvUnlinkTimer( pxTimer );
+
+	switch( xCommandID )
+	{
+		case twheelCOMMAND_START :
+		case twheelCOMMAND_START_FROM_ISR :
+		case twheelCOMMAND_RESET :
+		case twheelCOMMAND_RESET_FROM_ISR :
+			/* The command value holds the tick count at the time the command
+			was sent, so the period is measured from then, not from now. */
+			prvStartTimer( pxTimer, xCommandValue );
+			break;
+
+		case twheelCOMMAND_STOP :
+		case twheelCOMMAND_STOP_FROM_ISR :
+			pxTimer->ucStatus &= ( uint8_t ) ~twheelSTATUS_IS_ACTIVE;
+			break;
+
+		case twheelCOMMAND_CHANGE_PERIOD :
+		case twheelCOMMAND_CHANGE_PERIOD_FROM_ISR :
+			/* As per the kernel implementation, changing the period also
+			starts the timer, with the new period measured from now. */
+			configASSERT( ( xCommandValue > 0 ) );
+			pxTimer->xPeriod = xCommandValue;
+			prvStartTimer( pxTimer, xWheelTime );
+			break;
+
+		case twheelCOMMAND_DELETE :
+			vPortFree( pxTimer );
+			break;
+
+		default :
+			/* Don't expect to get here. */
+			configASSERT( pdFALSE );
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartTimer( WheelTimer_t *pxTimer, TickType_t xCommandTime )
+{
+	/* The wheel is advanced before each command is actioned, so a command
+	time is never later than the wheel time - see prvProcessTimerQueue().  If
+	it were, the unsigned subtraction below would wrap, and the timer would be
+	treated as having expired almost a whole tick range ago. */
+	configASSERT( ( TickType_t ) ( xWheelTime - xCommandTime ) <= ( TickType_t ) ( ( ( TickType_t ) -1 ) / 2U ) );
+
+	pxTimer->ucStatus |= twheelSTATUS_IS_ACTIVE;
+
+	for( ;; )
+	{
+		pxTimer->xExpiryTime = xCommandTime + pxTimer->xPeriod;
+
+		if( ( TickType_t ) ( xWheelTime - xCommandTime ) < pxTimer->xPeriod )
+		{
+			/* The expiry time is still in the future. */
+			prvLinkTimer( pxTimer );
+			break;
+		}
+
+		/* The expiry time has already passed, which can happen if the command
+		sat in the queue for longer than the timer's period. */
+		if( ( pxTimer->ucStatus & twheelSTATUS_IS_AUTORELOAD ) == 0 )
+		{
+			pxTimer->ucStatus &= ( uint8_t ) ~twheelSTATUS_IS_ACTIVE;
+			pxTimer->pxCallbackFunction( ( WheelTimerHandle_t ) pxTimer );
+			break;
+		}
+
+		xCommandTime = pxTimer->xExpiryTime;
+		pxTimer->pxCallbackFunction( ( WheelTimerHandle_t ) pxTimer );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLinkTimer( WheelTimer_t *pxTimer )
+{
+TickType_t xDelta, xSlotTime, xIndex;
+UBaseType_t uxLevel;
+
+	configASSERT( pxTimer->ppxPrevious == NULL );
+
+	/* A delta of zero is only possible when a timer is cascaded into the
+	finest wheel on the tick it expires, in which case the slot for the current
+	tick is about to be processed. */
+	xDelta = pxTimer->xExpiryTime - xWheelTime;
+	xSlotTime = pxTimer->xExpiryTime;
+
+	if( xDelta > twheelMAX_DELTA )
+	{
+		xSlotTime = xWheelTime + twheelMAX_DELTA;
+		xDelta = twheelMAX_DELTA;
+	}
+
+	/* Find the finest wheel that spans the delta. */
+	for( uxLevel = 0; uxLevel < ( twheelNUM_LEVELS - 1U ); uxLevel++ )
+	{
+		if( xDelta < ( ( TickType_t ) twheelNUM_SLOTS << ( uxLevel * twheelSLOT_BITS ) ) )
+		{
+			break;
+		}
+	}
+
+	xIndex = ( xSlotTime >> ( uxLevel * twheelSLOT_BITS ) ) & twheelSLOT_MASK;
+
+	pxTimer->pxNext = pxWheel[ uxLevel ][ xIndex ];
+	if( pxTimer->pxNext != NULL )
+	{
+		pxTimer->pxNext->ppxPrevious = &( pxTimer->pxNext );
+	}
+	pxTimer->ppxPrevious = &( pxWheel[ uxLevel ][ xIndex ] );
+	pxWheel[ uxLevel ][ xIndex ] = pxTimer;
+
+	uxLinkedTimers++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlinkTimer( WheelTimer_t *pxTimer )
+{
+	if( pxTimer->ppxPrevious != NULL )
+	{
+		*( pxTimer->ppxPrevious ) = pxTimer->pxNext;
+		if( pxTimer->pxNext != NULL )
+		{
+			pxTimer->pxNext->ppxPrevious = pxTimer->ppxPrevious;
+		}
+
+		pxTimer->pxNext = NULL;
+		pxTimer->ppxPrevious = NULL;
+		uxLinkedTimers--;
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,284 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A "wait for any" primitive that provides the same functionality as a queue
+ * set for a single reading task, without the cost of a queue set.
+ *
+ * When a queue that is a member of a queue set is written to, the handle of the
+ * queue is also written to the queue set (itself a queue), so every item is
+ * copied into two queues and the reading task reads two queues for every item.
+ * This file instead uses one bit of the reading task's notification value per
+ * member.  Writing to a member sets the member's bit using xTaskNotifyIndexed()
+ * with the eSetBits action, which does not copy any data and unblocks the
+ * reading task if it is waiting.  xWaitForAnySelect() collects the bits into a
+ * pending mask and returns the members that have data in round robin order.
+ *
+ * The cost of this simplicity is that a set supports a single reading task,
+ * at most waitanyMAX_MEMBERS members, and uses one task notification index of
+ * the reading task - which is waitanyNOTIFICATION_INDEX.
+ */
+
+/* Standard includes. */
+#include <limits.h>
+
+/* Scheduler include files. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* Demo program include files. */
+#include "WaitForAny.h"
+
+/* The task notification index used to signal the task that owns a set.  The
+default uses the last index, which is also the only index if
+configTASK_NOTIFICATION_ARRAY_ENTRIES is 1 - in which case the owning task must
+not use task notifications for anything else. */
+#ifndef waitanyNOTIFICATION_INDEX
+	#define waitanyNOTIFICATION_INDEX	( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#define waitanyDONT_BLOCK				( ( TickType_t ) 0 )
+#define waitanyALL_BITS					( ( uint32_t ) ULONG_MAX )
+
+/*-----------------------------------------------------------*/
+
+typedef struct WaitForAnySetDefinition
+{
+	TaskHandle_t xOwner;								/*<< The only task that can read from the set. */
+	QueueHandle_t xMembers[ waitanyMAX_MEMBERS ];
+	UBaseType_t uxNumberOfMembers;
+	uint32_t ulPendingMask;								/*<< Members that may contain data.  Only accessed by the owner. */
+	UBaseType_t uxNextMember;							/*<< Where the round robin search starts.  Only accessed by the owner. */
+} WaitForAnySet_t;
+
+/*-----------------------------------------------------------*/
+
+WaitForAnySetHandle_t xWaitForAnyCreate( TaskHandle_t xOwner )
+{
+WaitForAnySet_t *pxSet;
+
+	pxSet = ( WaitForAnySet_t * ) pvPortMalloc( sizeof( WaitForAnySet_t ) );
+
+	if( pxSet != NULL )
+	{
+		if( xOwner == NULL )
+		{
+			xOwner = xTaskGetCurrentTaskHandle();
+		}
+
+		pxSet->xOwner = xOwner;
+		pxSet->uxNumberOfMembers = 0;
+		pxSet->ulPendingMask = 0;
+		pxSet->uxNextMember = 0;
+	}
+
+	return pxSet;
+}
+/*-----------------------------------------------------------*/
+
+void vWaitForAnyDelete( WaitForAnySetHandle_t xSet )
+{
+	configASSERT( xSet );
+	vPortFree( xSet );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitForAnyAddMember( WaitForAnySetHandle_t xSet, QueueHandle_t xMember, UBaseType_t *puxMemberIndex )
+{
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xSet );
+	configASSERT( xMember );
+
+	/* As with queue sets, a member that already contains data would not have
+	its bit set, so the owning task would never know it contained data. */
+	configASSERT( uxQueueMessagesWaiting( xMember ) == 0 );
+
+	if( xSet->uxNumberOfMembers < waitanyMAX_MEMBERS )
+	{
+		*puxMemberIndex = xSet->uxNumberOfMembers;
+		xSet->xMembers[ xSet->uxNumberOfMembers ] = xMember;
+		xSet->uxNumberOfMembers++;
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitForAnyQueueSend( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, const void * const pvItemToQueue, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+
+	configASSERT( xSet );
+	configASSERT( uxMemberIndex < xSet->uxNumberOfMembers );
+
+	/* The data must be in the queue before the owner is told it is there. */
+	xReturn = xQueueSendToBack( xSet->xMembers[ uxMemberIndex ], pvItemToQueue, xTicksToWait );
+
+	if( xReturn == pdPASS )
+	{
+		( void ) xTaskNotifyIndexed( xSet->xOwner, waitanyNOTIFICATION_INDEX, ( 1UL << uxMemberIndex ), eSetBits );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitForAnyQueueSendFromISR( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, const void * const pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn;
+
+	configASSERT( xSet );
+	configASSERT( uxMemberIndex < xSet->uxNumberOfMembers );
+
+	xReturn = xQueueSendToBackFromISR( xSet->xMembers[ uxMemberIndex ], pvItemToQueue, pxHigherPriorityTaskWoken );
+
+	if( xReturn == pdPASS )
+	{
+		( void ) xTaskNotifyIndexedFromISR( xSet->xOwner, waitanyNOTIFICATION_INDEX, ( 1UL << uxMemberIndex ), eSetBits, pxHigherPriorityTaskWoken );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitForAnySemaphoreGive( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex )
+{
+BaseType_t xReturn;
+
+	configASSERT( xSet );
+	configASSERT( uxMemberIndex < xSet->uxNumberOfMembers );
+
+	xReturn = xSemaphoreGive( xSet->xMembers[ uxMemberIndex ] );
+
+	if( xReturn == pdPASS )
+	{
+		( void ) xTaskNotifyIndexed( xSet->xOwner, waitanyNOTIFICATION_INDEX, ( 1UL << uxMemberIndex ), eSetBits );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitForAnySemaphoreGiveFromISR( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, BaseType_t *pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn;
+
+	configASSERT( xSet );
+	configASSERT( uxMemberIndex < xSet->uxNumberOfMembers );
+
+	xReturn = xSemaphoreGiveFromISR( xSet->xMembers[ uxMemberIndex ], pxHigherPriorityTaskWoken );
+
+	if( xReturn == pdPASS )
+	{
+		( void ) xTaskNotifyIndexedFromISR( xSet->xOwner, waitanyNOTIFICATION_INDEX, ( 1UL << uxMemberIndex ), eSetBits, pxHigherPriorityTaskWoken );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xWaitForAnySelect( WaitForAnySetHandle_t xSet, TickType_t xTicksToWait )
+{
+QueueHandle_t xReturn = NULL;
+TimeOut_t xTimeOut;
+TickType_t xTicksToBlock;
+uint32_t ulNotifiedBits;
+UBaseType_t uxMember, uxMessagesWaiting;
+
+	configASSERT( xSet );
+	configASSERT( xTaskGetCurrentTaskHandle() == xSet->xOwner );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	do
+	{
+		/* Collect the bits of any members written since the last time they
+		were collected.  Only block if there are no members already known to
+		contain data. */
+		if( xSet->ulPendingMask != 0UL )
+		{
+			xTicksToBlock = waitanyDONT_BLOCK;
+		}
+		else
+		{
+			xTicksToBlock = xTicksToWait;
+		}
+
+		if( xTaskNotifyWaitIndexed( waitanyNOTIFICATION_INDEX, 0UL, waitanyALL_BITS, &ulNotifiedBits, xTicksToBlock ) == pdPASS )
+		{
+			xSet->ulPendingMask |= ulNotifiedBits;
+		}
+
+		while( ( xSet->ulPendingMask != 0UL ) && ( xReturn == NULL ) )
+		{
+			/* Find the next pending member in round robin order. */
+			uxMember = xSet->uxNextMember;
+			while( ( xSet->ulPendingMask & ( 1UL << uxMember ) ) == 0UL )
+			{
+				uxMember++;
+				if( uxMember >= xSet->uxNumberOfMembers )
+				{
+					uxMember = 0;
+				}
+			}
+
+			xSet->uxNextMember = uxMember + 1U;
+			if( xSet->uxNextMember >= xSet->uxNumberOfMembers )
+			{
+				xSet->uxNextMember = 0;
+			}
+
+			/* The bit stays pending if the member will still contain data
+			after the caller has read one item from it.  A member can be empty
+			even if only the owner reads from it, as a writer sets the member's
+			bit after its item is in the queue.  The owner may read the item
+			before the bit arrives, leaving a stale bit for the next call.
+			Such a member is skipped. */
+			uxMessagesWaiting = uxQueueMessagesWaiting( xSet->xMembers[ uxMember ] );
+
+			if( uxMessagesWaiting <= ( UBaseType_t ) 1U )
+			{
+				xSet->ulPendingMask &= ~( 1UL << uxMember );
+			}
+
+			if( uxMessagesWaiting != ( UBaseType_t ) 0U )
+			{
+				xReturn = xSet->xMembers[ uxMember ];
+			}
+		}
+
+		/* If every pending bit was stale, wait again for whatever remains of
+		the block time, rather than returning NULL early. */
+	} while( ( xReturn == NULL ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
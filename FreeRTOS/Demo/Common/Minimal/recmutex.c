@@ -59,6 +59,10 @@
 	does obtain the mutex it first unsuspends both the controlling task and
 	blocking task prior to giving the mutex back - resulting in the polling
 	task temporarily inheriting the controlling tasks priority.
+
+	Setting recmuUSE_MUTEX_PROFILER to 1 takes the mutex through
+	MutexProfiler.c, which records how often and for how long each task waits
+	for it.
 */
 
 /* Scheduler include files. */
@@ -69,6 +73,19 @@
 /* Demo app include files. */
 #include "recmutex.h"
 
+#ifndef recmuUSE_MUTEX_PROFILER
+	#define recmuUSE_MUTEX_PROFILER 0
+#endif
+
+#if( recmuUSE_MUTEX_PROFILER == 1 )
+	#include "MutexProfiler.h"
+
+	/* Take the mutex through the profiler.  The mutex is in the queue registry
+	so the profiler keeps statistics for it. */
+	#undef xSemaphoreTakeRecursive
+	#define xSemaphoreTakeRecursive( xMutex, xBlockTime )	xMutexProfilerTakeRecursive( ( xMutex ), ( xBlockTime ) )
+#endif
+
 /* Priorities assigned to the three tasks.  recmuCONTROLLING_TASK_PRIORITY can
 be overridden by a definition in FreeRTOSConfig.h. */
 #ifndef recmuCONTROLLING_TASK_PRIORITY
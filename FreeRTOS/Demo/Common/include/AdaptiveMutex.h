@@ -0,0 +1,66 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A mutex that spins for a bounded time while its holder is running on another
+ * core, before falling back to blocking.  See AdaptiveMutex.c.
+ */
+
+#ifndef ADAPTIVE_MUTEX_H
+#define ADAPTIVE_MUTEX_H
+
+struct AdaptiveMutexDefinition;
+typedef struct AdaptiveMutexDefinition * AdaptiveMutexHandle_t;
+
+/*
+ * Create an adaptive mutex.  ulSpinBudget is the maximum number of times a
+ * task polls the mutex while waiting for a holder that is running on another
+ * core, before blocking.  A budget of 0 makes the mutex behave as a standard
+ * mutex.  Returns NULL if there is not enough heap.
+ */
+AdaptiveMutexHandle_t xAdaptiveMutexCreate( uint32_t ulSpinBudget );
+
+/*
+ * Delete a mutex that is not held.
+ */
+void vAdaptiveMutexDelete( AdaptiveMutexHandle_t xMutex );
+
+/*
+ * The equivalents of xSemaphoreTake() and xSemaphoreGive() for a mutex
+ * created by xSemaphoreCreateMutex().  Must only be called from tasks.
+ */
+BaseType_t xAdaptiveMutexTake( AdaptiveMutexHandle_t xMutex, TickType_t xTicksToWait );
+BaseType_t xAdaptiveMutexGive( AdaptiveMutexHandle_t xMutex );
+
+/*
+ * Return the number of takes that had to wait for the mutex, split into those
+ * that obtained the mutex while spinning and those that blocked.
+ */
+void vAdaptiveMutexGetStats( AdaptiveMutexHandle_t xMutex, uint32_t *pulSpinAcquisitions, uint32_t *pulBlockedAcquisitions );
+
+#endif /* ADAPTIVE_MUTEX_H */
+
@@ -0,0 +1,48 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef ADAPTIVE_MUTEX_BENCHMARK_H
+#define ADAPTIVE_MUTEX_BENCHMARK_H
+
+/* Measurements taken for one type of mutex.  Latencies are in the units of the
+benchmark time base - see AdaptiveMutexBenchmark.c. */
+typedef struct ADAPTIVE_MUTEX_BENCHMARK_RESULT
+{
+	uint32_t ulAcquisitionsPerSecond;	/* Total takes per second by both worker tasks. */
+	uint32_t ulHandoffs;				/* Takes that waited for the mutex to be given by the other worker. */
+	uint32_t ulMeanHandoffLatency;		/* Mean time from the mutex being given to it being taken by a waiting worker. */
+	uint32_t ulMaxHandoffLatency;
+	uint32_t ulSpinAcquisitions;		/* Waiting takes that obtained the mutex by spinning (adaptive mutex only). */
+	uint32_t ulBlockedAcquisitions;		/* Waiting takes that blocked (adaptive mutex only). */
+} AdaptiveMutexBenchmarkResult_t;
+
+void vStartAdaptiveMutexBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreAdaptiveMutexBenchmarkTasksStillRunning( void );
+BaseType_t xGetAdaptiveMutexBenchmarkResults( AdaptiveMutexBenchmarkResult_t *pxStandardMutex, AdaptiveMutexBenchmarkResult_t *pxAdaptiveMutex, uint32_t *pulRunCount );
+
+#endif /* ADAPTIVE_MUTEX_BENCHMARK_H */
+
@@ -0,0 +1,136 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A pool of fixed size blocks, allocated and freed in constant time, with a
+ * per-core cache of free blocks.  See BlockPool.c.
+ */
+
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+/* The number of free blocks each core can cache.  Also see the comments at the
+top of BlockPool.c. */
+#ifndef blockpoolMAGAZINE_SIZE
+	#define blockpoolMAGAZINE_SIZE		8
+#endif
+
+#ifdef configNUM_CORES
+	#define blockpoolNUM_CORES			configNUM_CORES
+#else
+	#define blockpoolNUM_CORES			1
+#endif
+
+/* The space each block occupies in the pool - the block size rounded up to
+hold at least a pointer and to a multiple of portBYTE_ALIGNMENT. */
+#define blockpoolBLOCK_STRIDE( xBlockSize )	( ( ( ( xBlockSize ) < sizeof( void * ) ? sizeof( void * ) : ( xBlockSize ) ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+/* The size of the storage array that must be passed to
+xBlockPoolCreateStatic().  This includes space to align the first block, so
+the array itself need not be aligned. */
+#define blockpoolSTORAGE_SIZE( xBlockSize, uxNumberOfBlocks )	( ( blockpoolBLOCK_STRIDE( xBlockSize ) * ( size_t ) ( uxNumberOfBlocks ) ) + portBYTE_ALIGNMENT_MASK )
+
+struct BlockPoolDefinition;
+typedef struct BlockPoolDefinition * BlockPoolHandle_t;
+
+/* As with the kernel's StaticQueue_t and similar structures, StaticBlockPool_t
+has the same size and alignment as the real pool structure, so an application
+can allocate one without seeing the real structure. */
+typedef struct xSTATIC_BLOCK_POOL_MAGAZINE
+{
+	void *pvDummy1[ blockpoolMAGAZINE_SIZE ];
+	UBaseType_t uxDummy2;
+	uint32_t ulDummy3;
+} StaticBlockPoolMagazine_t;
+
+typedef struct xSTATIC_BLOCK_POOL
+{
+	StaticBlockPoolMagazine_t xDummy1[ blockpoolNUM_CORES ];
+	void *pvDummy2[ 2 ];
+	size_t xDummy3;
+	UBaseType_t uxDummy4[ 4 ];
+	uint32_t ulDummy5[ 3 ];
+	uint8_t ucDummy6;
+} StaticBlockPool_t;
+
+/* Counters maintained by a pool. */
+typedef struct BlockPoolStats
+{
+	size_t xBlockSize;					/* The usable size of each block, which may be larger than requested. */
+	UBaseType_t uxNumberOfBlocks;
+	UBaseType_t uxFreeBlocks;			/* Free blocks, including those cached by the cores. */
+	UBaseType_t uxMinimumEverSharedBlocks;	/* The fewest blocks ever left in the shared list. */
+	uint32_t ulCacheHits;				/* Allocations and frees that did not take the pool's lock. */
+	uint32_t ulRefills;					/* Times a core took blocks from the shared list. */
+	uint32_t ulFlushes;					/* Times a core returned blocks to the shared list. */
+	uint32_t ulFailedAllocations;
+} BlockPoolStats_t;
+
+/*
+ * Create a pool of uxNumberOfBlocks blocks of at least xBlockSize bytes each.
+ * The pool structure and the blocks are obtained with a single call to
+ * pvPortMalloc().  Returns NULL if there is not enough heap.
+ */
+BlockPoolHandle_t xBlockPoolCreate( size_t xBlockSize, UBaseType_t uxNumberOfBlocks );
+
+/*
+ * As xBlockPoolCreate(), but using memory provided by the application.
+ * pucPoolStorage must point to an array of at least
+ * blockpoolSTORAGE_SIZE( xBlockSize, uxNumberOfBlocks ) bytes, and
+ * pxStaticPool holds the pool structure.
+ */
+BlockPoolHandle_t xBlockPoolCreateStatic( size_t xBlockSize,
+										  UBaseType_t uxNumberOfBlocks,
+										  uint8_t *pucPoolStorage,
+										  StaticBlockPool_t *pxStaticPool );
+
+/*
+ * Delete a pool.  Blocks that are still allocated become invalid.
+ */
+void vBlockPoolDelete( BlockPoolHandle_t xPool );
+
+/*
+ * Allocate a block from the pool.  Never blocks, and can be called from tasks
+ * and interrupts.  Returns NULL if no block is free.
+ */
+void *pvBlockPoolAllocate( BlockPoolHandle_t xPool );
+
+/*
+ * Return a block to the pool it was allocated from.  Never blocks, and can be
+ * called from tasks and interrupts - on any core, not only the core that
+ * allocated the block.
+ */
+void vBlockPoolFree( BlockPoolHandle_t xPool, void *pvBlock );
+
+/*
+ * Take a snapshot of the pool's counters.  The counts of free blocks are not
+ * exact if other tasks or interrupts are using the pool at the same time.
+ */
+void vBlockPoolGetStats( BlockPoolHandle_t xPool, BlockPoolStats_t *pxStats );
+
+#endif /* BLOCK_POOL_H */
+
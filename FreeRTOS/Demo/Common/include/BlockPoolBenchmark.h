@@ -0,0 +1,46 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef BLOCK_POOL_BENCHMARK_H
+#define BLOCK_POOL_BENCHMARK_H
+
+/* Measurements taken for one allocator.  Latencies are in the units of the
+benchmark time base - see BlockPoolBenchmark.c. */
+typedef struct BLOCK_POOL_BENCHMARK_RESULT
+{
+	uint32_t ulOperationsPerSecond;		/* Allocations plus frees per second, by all the workers together. */
+	uint32_t ulMeanLatency;				/* Mean time taken by one allocation or free. */
+	uint32_t ulMaxLatency;
+	uint32_t ulFailedAllocations;
+} BlockPoolBenchmarkResult_t;
+
+void vStartBlockPoolBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreBlockPoolBenchmarkTasksStillRunning( void );
+BaseType_t xGetBlockPoolBenchmarkResults( BlockPoolBenchmarkResult_t *pxHeap, BlockPoolBenchmarkResult_t *pxPool, uint32_t *pulRunCount );
+
+#endif /* BLOCK_POOL_BENCHMARK_H */
+
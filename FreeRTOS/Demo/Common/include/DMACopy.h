@@ -0,0 +1,111 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * memcpy() and memset() equivalents that use a DMA engine for large
+ * transfers, blocking the calling task until the transfer completes.  See
+ * DMACopy.c.
+ */
+
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+/* The most DMA channels the service uses. */
+#ifndef dmacopyMAX_CHANNELS
+	#define dmacopyMAX_CHANNELS			2
+#endif
+
+/* Counters maintained by the copy service. */
+typedef struct DMACopyStats
+{
+	uint32_t ulCPUTransfers;			/* Transfers below the threshold, or made before the scheduler started. */
+	uint32_t ulDMATransfers;			/* Transfers made, at least in part, by the DMA engine. */
+	uint32_t ulChannelBusyTransfers;	/* Transfers made on the CPU because no DMA channel was free. */
+	uint32_t ulFailedTransfers;			/* DMA transfers that failed, and were then made on the CPU. */
+	uint32_t ulDMABytes;				/* Bytes moved by the DMA engine. */
+} DMACopyStats_t;
+
+/*
+ * Initialise the service and the port layer.  Must be called once, before
+ * the other functions, and on the RP2040 from the core that is to take the DMA
+ * interrupt.
+ */
+void vDMACopyInit( void );
+
+/*
+ * Equivalent to memcpy() and memset(), but must not be called from an
+ * interrupt.  Transfers of at least dmacopyTHRESHOLD bytes are made by the DMA
+ * engine, with the calling task blocked until the transfer is complete.
+ * Smaller transfers, and transfers made before the scheduler has started, are
+ * made on the CPU.  The buffers must not overlap.
+ */
+void *pvDMAMemCpy( void *pvDestination, const void *pvSource, size_t xLength );
+void *pvDMAMemSet( void *pvDestination, int iValue, size_t xLength );
+
+/*
+ * Take a snapshot of the service's counters.
+ */
+void vDMACopyGetStats( DMACopyStats_t *pxStats );
+
+/*
+ * Called by the port layer's DMA interrupt handler when the transfer on
+ * uxChannel ends.  xSucceeded is pdFALSE if the DMA engine reported an error,
+ * in which case the transfer is repeated on the CPU.
+ */
+void vDMACopyTransferCompleteFromISR( UBaseType_t uxChannel, BaseType_t xSucceeded, BaseType_t *pxHigherPriorityTaskWoken );
+
+/*
+ * The port layer, implemented once for each DMA engine - see DMACopyPort.c in
+ * the demos that use this service.
+ *
+ * uxDMACopyPortInit() sets up the DMA engine and its interrupt, and returns
+ * the number of channels the service can use (at most dmacopyMAX_CHANNELS),
+ * which can be 0.
+ *
+ * xDMACopyPortStartCopy() and xDMACopyPortStartSet() start a transfer on
+ * uxChannel, then return without waiting for it to complete.  pvDestination is
+ * aligned to dmacopyPORT_ALIGNMENT and xLength is a multiple of it.  They
+ * return pdFALSE if the transfer could not be started, in which case it is
+ * made on the CPU.
+ *
+ * vDMACopyPortEndTransfer() is called from the task that started a transfer,
+ * after vDMACopyTransferCompleteFromISR() has been called for it - for
+ * example to invalidate the data cache over the destination.
+ */
+UBaseType_t uxDMACopyPortInit( void );
+BaseType_t xDMACopyPortStartCopy( UBaseType_t uxChannel, void *pvDestination, const void *pvSource, size_t xLength );
+BaseType_t xDMACopyPortStartSet( UBaseType_t uxChannel, void *pvDestination, uint8_t ucValue, size_t xLength );
+void vDMACopyPortEndTransfer( UBaseType_t uxChannel, void *pvDestination, size_t xLength );
+
+/*
+ * Only provided by the host port layer, DMACopyHostPort.c, and must be called
+ * from the tick hook.
+ */
+void vDMACopyHostPortTickHook( void );
+
+#endif /* DMA_COPY_H */
+
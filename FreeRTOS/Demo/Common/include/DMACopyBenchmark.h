@@ -0,0 +1,43 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef DMA_COPY_BENCHMARK_H
+#define DMA_COPY_BENCHMARK_H
+
+/* Measurements taken for one copy method - see DMACopyBenchmark.c. */
+typedef struct DMA_COPY_BENCHMARK_RESULT
+{
+	uint32_t ulBytesPerSecond;			/* Bytes copied per second by the copying task. */
+	uint32_t ulMeanCopyTime;			/* Mean time taken by one copy, in microseconds. */
+	uint32_t ulCPUAvailable;			/* Percentage of the CPU left to a lower priority task while copying. */
+} DMACopyBenchmarkResult_t;
+
+void vStartDMACopyBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreDMACopyBenchmarkTasksStillRunning( void );
+BaseType_t xGetDMACopyBenchmarkResults( DMACopyBenchmarkResult_t *pxCPU, DMACopyBenchmarkResult_t *pxDMA, uint32_t *pulRunCount );
+
+#endif /* DMA_COPY_BENCHMARK_H */
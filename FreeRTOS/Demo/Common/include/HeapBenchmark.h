@@ -0,0 +1,58 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef HEAP_BENCHMARK_H
+#define HEAP_BENCHMARK_H
+
+/* The number of buckets in the latency histograms.  Bucket 0 counts
+operations that took less than one time unit, and bucket n counts operations
+that took from 2^(n-1) to (2^n)-1 units, except the last bucket, which also
+counts everything slower. */
+#define heapbenchLATENCY_BUCKETS	8
+
+/* The results of one run.  Times are in the units of the benchmark time base -
+see HeapBenchmark.c. */
+typedef struct HEAP_BENCHMARK_RESULT
+{
+	uint32_t ulOperationsPerSecond;					/* Allocations plus frees per second, by all the workers together. */
+	uint32_t ulMallocLatency[ heapbenchLATENCY_BUCKETS ];
+	uint32_t ulFreeLatency[ heapbenchLATENCY_BUCKETS ];
+	uint32_t ulMeanMallocLatency;
+	uint32_t ulMaxMallocLatency;
+	uint32_t ulMeanFreeLatency;
+	uint32_t ulMaxFreeLatency;
+	uint32_t ulFailedAllocations;
+	uint32_t ulMeanFragmentation;					/* Parts per thousand of the free space not in the largest free block, sampled during the run. */
+	uint32_t ulMaxFragmentation;
+	size_t xMinimumEverFreeBytes;					/* As returned by xPortGetMinimumEverFreeHeapSize() at the end of the run. */
+} HeapBenchmarkResult_t;
+
+void vStartHeapBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreHeapBenchmarkTasksStillRunning( void );
+BaseType_t xGetHeapBenchmarkResults( HeapBenchmarkResult_t *pxResult, uint32_t *pulRunCount );
+
+#endif /* HEAP_BENCHMARK_H */
@@ -0,0 +1,124 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A logging backend that never blocks the caller.  Messages are copied into a
+ * ring buffer belonging to the calling core, and a low priority task drains
+ * the rings to an output function in packets of up to logringPACKET_SIZE
+ * bytes.  See LogRing.c.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+/* The number of rings - one per core. */
+#ifndef logringNUM_RINGS
+	#ifdef configNUM_CORES
+		#define logringNUM_RINGS		configNUM_CORES
+	#else
+		#define logringNUM_RINGS		1
+	#endif
+#endif
+
+/* The size of each ring, in bytes.  Must be a power of two. */
+#ifndef logringRING_SIZE
+	#define logringRING_SIZE			4096
+#endif
+
+/* The most bytes passed to the output function in one call. */
+#ifndef logringPACKET_SIZE
+	#define logringPACKET_SIZE			512
+#endif
+
+/* The longest message lLogRingPrintf() formats - longer messages are
+truncated.  The buffer is on the calling task's stack. */
+#ifndef logringMAX_MESSAGE_LENGTH
+	#define logringMAX_MESSAGE_LENGTH	128
+#endif
+
+/* The prototype of the function the drain task passes packets to.  It is only
+ever called from the drain task, so may block. */
+typedef void ( *LogRingOutput_t )( const char *pcData, size_t xLength );
+
+/* Counters maintained by the rings, summed over all the rings. */
+typedef struct LogRingStats
+{
+	uint32_t ulBytesLogged;			/* Bytes copied into the rings. */
+	uint32_t ulMessagesLogged;
+	uint32_t ulBytesDropped;		/* Bytes in messages that did not fit in a ring. */
+	uint32_t ulMessagesDropped;
+	uint32_t ulBytesSent;			/* Bytes passed to the output function. */
+	uint32_t ulPacketsSent;			/* Calls to the output function. */
+	uint32_t ulHighWaterMark;		/* The most bytes held in any one ring. */
+} LogRingStats_t;
+
+/*
+ * Copy xLength bytes into the calling core's ring as a single message.  The
+ * message is either copied whole or, if the ring does not have space for all
+ * of it, dropped and counted - the caller never blocks.  Can be called from
+ * tasks and interrupts, and before the scheduler is started.
+ *
+ * Returns the number of bytes copied, which is 0 if the message was dropped.
+ */
+size_t xLogRingWrite( const char *pcData, size_t xLength );
+
+/*
+ * printf() and puts() equivalents that write to the calling core's ring using
+ * xLogRingWrite().  Return the number of bytes logged, or 0 if the message was
+ * dropped.
+ */
+int lLogRingPrintf( const char *pcFormat, ... );
+int lLogRingPuts( const char *pcString );
+
+/*
+ * Pass everything currently held in the rings to pxOutput, in packets of up to
+ * logringPACKET_SIZE bytes, and return the number of bytes passed.  Data from
+ * several messages, and from several rings, is combined into one packet, but
+ * the messages from each ring are kept in order and are never interleaved with
+ * each other.  There must only be one caller at a time - normally the drain
+ * task created by vStartLogRingTask().
+ */
+size_t xLogRingDrain( LogRingOutput_t pxOutput );
+
+/*
+ * Create the task that calls xLogRingDrain( pxOutput ) every
+ * logringFLUSH_PERIOD_MS milliseconds, or sooner if vLogRingFlush() is called.
+ */
+void vStartLogRingTask( UBaseType_t uxPriority, LogRingOutput_t pxOutput );
+
+/*
+ * Ask the drain task to drain the rings now rather than at the end of its
+ * current period.  Must be called from a task.
+ */
+void vLogRingFlush( void );
+
+/*
+ * Take a snapshot of the counters.
+ */
+void vLogRingGetStats( LogRingStats_t *pxStats );
+
+#endif /* LOG_RING_H */
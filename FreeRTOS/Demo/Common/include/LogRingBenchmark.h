@@ -0,0 +1,54 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Compares the cost of logging through the application's existing console
+ * output with the cost of logging through LogRing.c.  See LogRingBenchmark.c.
+ */
+
+#ifndef LOG_RING_BENCHMARK_H
+#define LOG_RING_BENCHMARK_H
+
+#include "LogRing.h"
+
+/* Measurements taken for one logging method - see LogRingBenchmark.c. */
+typedef struct LOG_RING_BENCHMARK_RESULT
+{
+	uint32_t ulMessagesPerSecond;		/* Messages logged per second by the logging task, including any dropped. */
+	uint32_t ulMeanCallTime;			/* Mean time taken by one call, in microseconds. */
+	uint32_t ulBytesDropped;			/* Bytes dropped during the measurement. */
+} LogRingBenchmarkResult_t;
+
+/*
+ * pxDirectOutput writes to the console directly, and is called once per
+ * message.  vStartLogRingTask() must also have been called.
+ */
+void vStartLogRingBenchmarkTasks( UBaseType_t uxPriority, LogRingOutput_t pxDirectOutput );
+BaseType_t xAreLogRingBenchmarkTasksStillRunning( void );
+BaseType_t xGetLogRingBenchmarkResults( LogRingBenchmarkResult_t *pxDirect, LogRingBenchmarkResult_t *pxRing, uint32_t *pulRunCount );
+
+#endif /* LOG_RING_BENCHMARK_H */
@@ -0,0 +1,72 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Records contention statistics for mutexes that have been added to the queue
+ * registry.  See MutexProfiler.c.
+ */
+
+#ifndef MUTEX_PROFILER_H
+#define MUTEX_PROFILER_H
+
+/* The number of cores for which statistics are kept. */
+#ifdef configNUM_CORES
+	#define mutexprofNUM_CORES		configNUM_CORES
+#else
+	#define mutexprofNUM_CORES		1
+#endif
+
+/* Statistics for one mutex.  Times are in the units of the profiler's time
+base - see MutexProfiler.c. */
+typedef struct MUTEX_PROFILE
+{
+	const char *pcMutexName;						/* The name the mutex was given in the queue registry. */
+	uint32_t ulAcquisitions;						/* Number of successful takes. */
+	uint32_t ulContendedAcquisitions;				/* Number of blocking takes that found the mutex already held. */
+	uint32_t ulTimeouts;							/* Number of contended takes that failed. */
+	uint32_t ulTotalWaitTime;						/* Total time spent waiting by contended takes. */
+	uint32_t ulMaxWaitTime;							/* Longest time spent waiting by a contended take. */
+	uint32_t ulPriorityInheritanceBoosts;			/* Number of contended takes that raised the priority of the holder. */
+	uint32_t ulContendedByHolderCore[ mutexprofNUM_CORES ];	/* Contended takes, by the core on which the holder took the mutex. */
+} MutexProfile_t;
+
+/*
+ * Drop in replacements for xSemaphoreTake() and xSemaphoreTakeRecursive()
+ * that update the statistics of the mutex if it is in the queue registry.
+ * Takes of any other semaphore are passed straight through.
+ */
+BaseType_t xMutexProfilerTake( SemaphoreHandle_t xMutex, TickType_t xTicksToWait );
+BaseType_t xMutexProfilerTakeRecursive( SemaphoreHandle_t xMutex, TickType_t xTicksToWait );
+
+/*
+ * Copy the statistics of up to uxMaxProfiles mutexes into pxProfiles.  Returns
+ * the number of profiles copied.
+ */
+UBaseType_t uxMutexProfilerGetProfiles( MutexProfile_t *pxProfiles, UBaseType_t uxMaxProfiles );
+
+#endif /* MUTEX_PROFILER_H */
+
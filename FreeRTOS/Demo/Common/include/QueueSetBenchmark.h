@@ -0,0 +1,53 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef QUEUE_SET_BENCHMARK_H
+#define QUEUE_SET_BENCHMARK_H
+
+/* Measurements taken for one mechanism.  Latencies are in the units of the
+benchmark time base - see QueueSetBenchmark.c. */
+typedef struct QUEUE_SET_BENCHMARK_MEASUREMENT
+{
+	uint32_t ulItemsPerSecond;		/* Items sent and received per second. */
+	uint32_t ulMeanLatency;			/* Mean time from an item being sent to it being received. */
+	uint32_t ulMaxLatency;			/* Maximum time from an item being sent to it being received. */
+} QueueSetBenchmarkMeasurement_t;
+
+/* The results for one set size. */
+typedef struct QUEUE_SET_BENCHMARK_RESULT
+{
+	uint32_t ulNumberOfMembers;
+	QueueSetBenchmarkMeasurement_t xQueueSet;
+	QueueSetBenchmarkMeasurement_t xWaitForAny;
+} QueueSetBenchmarkResult_t;
+
+void vStartQueueSetBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreQueueSetBenchmarkTasksStillRunning( void );
+UBaseType_t uxGetQueueSetBenchmarkResults( const QueueSetBenchmarkResult_t **ppxResults, uint32_t *pulSweepCount );
+
+#endif /* QUEUE_SET_BENCHMARK_H */
+
@@ -0,0 +1,57 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef TICK_LOAD_BENCHMARK_H
+#define TICK_LOAD_BENCHMARK_H
+
+#ifdef configNUM_CORES
+	#define tlbenchNUM_CORES				configNUM_CORES
+#else
+	#define tlbenchNUM_CORES				1
+#endif
+
+/* Measurements taken over one measurement period.  Latencies are in the units
+of the benchmark time base - see TickLoadBenchmark.c. */
+typedef struct TICK_LOAD_BENCHMARK_RESULT
+{
+	uint32_t ulSpareLoopsPerSecond[ tlbenchNUM_CORES ];	/* Loops made by the lowest priority task on each core. */
+	uint32_t ulMeanWakeLatency[ tlbenchNUM_CORES ];		/* Mean time from the tick hook to a delayed task on each core running. */
+	uint32_t ulMaxWakeLatency[ tlbenchNUM_CORES ];
+	uint32_t ulLateWakeups[ tlbenchNUM_CORES ];			/* Wake ups that did not happen within the tick they were due in. */
+	uint32_t ulImbalance;								/* Difference between the most and least spare loops, as a percentage of the most. */
+} TickLoadBenchmarkResult_t;
+
+void vStartTickLoadBenchmarkTasks( UBaseType_t uxPriority );
+BaseType_t xAreTickLoadBenchmarkTasksStillRunning( void );
+BaseType_t xGetTickLoadBenchmarkResults( TickLoadBenchmarkResult_t *pxResult, uint32_t *pulRunCount );
+
+/*
+ * Must be called from the tick hook.
+ */
+void vTickLoadBenchmarkTickHook( void );
+
+#endif /* TICK_LOAD_BENCHMARK_H */
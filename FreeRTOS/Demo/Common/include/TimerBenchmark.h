@@ -0,0 +1,50 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef TIMER_BENCHMARK_H
+#define TIMER_BENCHMARK_H
+
+/* The results of one step of the benchmark.  Times are in the units of the
+benchmark time base - see TimerBenchmark.c. */
+typedef struct TIMER_BENCHMARK_RESULT
+{
+	uint32_t ulNumberOfTimers;		/* The number of timers used in this step. */
+	uint32_t ulStartTime;			/* Time taken to start all the timers. */
+	uint32_t ulResetTime;			/* Time taken to reset all the timers. */
+	uint32_t ulBatchResetTime;		/* Time taken to reset all the timers using batches of commands, or 0 if batches are not supported. */
+	uint32_t ulStopTime;			/* Time taken to stop all the timers. */
+	uint32_t ulExpiries;			/* Number of callbacks executed while expiries were measured. */
+	uint32_t ulTotalLateness;		/* Sum of the ticks by which each of those callbacks was late. */
+	TickType_t xMaxLateness;		/* The latest any one callback executed, in ticks. */
+} TimerBenchmarkResult_t;
+
+void vStartTimerBenchmarkTask( UBaseType_t uxPriority );
+BaseType_t xIsTimerBenchmarkTaskStillRunning( void );
+UBaseType_t uxGetTimerBenchmarkResults( const TimerBenchmarkResult_t **ppxResults, uint32_t *pulSweepCount );
+
+#endif /* TIMER_BENCHMARK_H */
+
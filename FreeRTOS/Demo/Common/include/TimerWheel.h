@@ -0,0 +1,150 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A software timer service that keeps its active timers in a hierarchical
+ * timing wheel rather than in the sorted lists used by the kernel's timer
+ * service task.  Starting, stopping and expiring a timer are O(1) operations,
+ * independent of the number of active timers.  See TimerWheel.c.
+ *
+ * The API mirrors the kernel software timer API in timers.h, so an application
+ * (or TimerDemo.c, when tmrdemoUSE_TIMER_WHEEL is set to 1) can switch between
+ * the two implementations at build time.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/* IDs for commands that can be sent/received on the timer wheel's command
+queue.  The IDs follow the same scheme as the kernel's timer command IDs -
+commands with an ID at or above twheelFIRST_FROM_ISR_COMMAND are sent from an
+interrupt. */
+#define twheelCOMMAND_START						( ( BaseType_t ) 1 )
+#define twheelCOMMAND_RESET						( ( BaseType_t ) 2 )
+#define twheelCOMMAND_STOP						( ( BaseType_t ) 3 )
+#define twheelCOMMAND_CHANGE_PERIOD				( ( BaseType_t ) 4 )
+#define twheelCOMMAND_DELETE					( ( BaseType_t ) 5 )
+
+#define twheelFIRST_FROM_ISR_COMMAND			( ( BaseType_t ) 6 )
+#define twheelCOMMAND_START_FROM_ISR			( ( BaseType_t ) 6 )
+#define twheelCOMMAND_RESET_FROM_ISR			( ( BaseType_t ) 7 )
+#define twheelCOMMAND_STOP_FROM_ISR				( ( BaseType_t ) 8 )
+#define twheelCOMMAND_CHANGE_PERIOD_FROM_ISR	( ( BaseType_t ) 9 )
+
+struct WheelTimerControlBlock;
+typedef struct WheelTimerControlBlock * WheelTimerHandle_t;
+
+/* Defines the prototype to which timer callback functions must conform. */
+typedef void (*WheelTimerCallbackFunction_t)( WheelTimerHandle_t xTimer );
+
+/* One entry in a batch of commands sent by xWheelTimerSendCommandBatch(). */
+typedef struct WheelTimerCommand
+{
+	WheelTimerHandle_t xTimer;
+	BaseType_t xCommandID;			/* A task level command - twheelCOMMAND_START to twheelCOMMAND_DELETE. */
+	TickType_t xOptionalValue;		/* The new period for twheelCOMMAND_CHANGE_PERIOD, otherwise unused. */
+} WheelTimerCommand_t;
+
+/*
+ * Create the timer wheel command queue and the task that services it.  Must be
+ * called before any other function in this file, normally before the scheduler
+ * is started.  Calling it more than once has no effect.
+ */
+BaseType_t xTimerWheelServiceStart( void );
+
+/*
+ * Equivalent to xTimerCreate() - see timers.h.
+ */
+WheelTimerHandle_t xWheelTimerCreate( const char * const pcTimerName,
+									  const TickType_t xTimerPeriodInTicks,
+									  const UBaseType_t uxAutoReload,
+									  void * const pvTimerID,
+									  WheelTimerCallbackFunction_t pxCallbackFunction );
+
+/*
+ * Equivalents of the timers.h query and set functions.
+ */
+BaseType_t xWheelTimerIsTimerActive( WheelTimerHandle_t xTimer );
+void *pvWheelTimerGetTimerID( const WheelTimerHandle_t xTimer );
+void vWheelTimerSetTimerID( WheelTimerHandle_t xTimer, void *pvNewID );
+const char * pcWheelTimerGetName( WheelTimerHandle_t xTimer );
+void vWheelTimerSetReloadMode( WheelTimerHandle_t xTimer, const UBaseType_t uxAutoReload );
+UBaseType_t uxWheelTimerGetReloadMode( WheelTimerHandle_t xTimer );
+TickType_t xWheelTimerGetPeriod( WheelTimerHandle_t xTimer );
+TickType_t xWheelTimerGetExpiryTime( WheelTimerHandle_t xTimer );
+
+/*
+ * Send uxNumberOfCommands commands to the timer wheel task in a single queue
+ * message.  The timer wheel task actions the commands in array order, in one
+ * pass.  Start and reset commands are timed from the tick count at the time
+ * the batch is sent.
+ *
+ * xTicksToWait is the maximum time to wait for space on the command queue.
+ * Once the batch is queued the calling task blocks until the timer wheel task
+ * has processed it, as the commands are read directly from pxCommands - so
+ * this function must only be called from a task (not a timer callback) after
+ * the scheduler has started.  See twheelBATCH_NOTIFICATION_INDEX in
+ * TimerWheel.c for the task notification it uses.
+ *
+ * Returns pdPASS if the batch was processed, or pdFAIL if it could not be
+ * queued within xTicksToWait ticks.
+ */
+BaseType_t xWheelTimerSendCommandBatch( const WheelTimerCommand_t * const pxCommands,
+										const UBaseType_t uxNumberOfCommands,
+										const TickType_t xTicksToWait );
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the macros below only, exactly as xTimerGenericCommand() is used
+ * by the macros in timers.h.
+ */
+BaseType_t xWheelTimerGenericCommand( WheelTimerHandle_t xTimer,
+									  const BaseType_t xCommandID,
+									  const TickType_t xOptionalValue,
+									  BaseType_t * const pxHigherPriorityTaskWoken,
+									  const TickType_t xTicksToWait );
+
+#define xWheelTimerStart( xTimer, xTicksToWait ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_START, ( xTaskGetTickCount() ), NULL, ( xTicksToWait ) )
+
+#define xWheelTimerStop( xTimer, xTicksToWait ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_STOP, 0U, NULL, ( xTicksToWait ) )
+
+#define xWheelTimerChangePeriod( xTimer, xNewPeriod, xTicksToWait ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_CHANGE_PERIOD, ( xNewPeriod ), NULL, ( xTicksToWait ) )
+
+#define xWheelTimerDelete( xTimer, xTicksToWait ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_DELETE, 0U, NULL, ( xTicksToWait ) )
+
+#define xWheelTimerReset( xTimer, xTicksToWait ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_RESET, ( xTaskGetTickCount() ), NULL, ( xTicksToWait ) )
+
+#define xWheelTimerStartFromISR( xTimer, pxHigherPriorityTaskWoken ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_START_FROM_ISR, ( xTaskGetTickCountFromISR() ), ( pxHigherPriorityTaskWoken ), 0U )
+
+#define xWheelTimerStopFromISR( xTimer, pxHigherPriorityTaskWoken ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_STOP_FROM_ISR, 0, ( pxHigherPriorityTaskWoken ), 0U )
+
+#define xWheelTimerChangePeriodFromISR( xTimer, xNewPeriod, pxHigherPriorityTaskWoken ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_CHANGE_PERIOD_FROM_ISR, ( xNewPeriod ), ( pxHigherPriorityTaskWoken ), 0U )
+
+#define xWheelTimerResetFromISR( xTimer, pxHigherPriorityTaskWoken ) xWheelTimerGenericCommand( ( xTimer ), twheelCOMMAND_RESET_FROM_ISR, ( xTaskGetTickCountFromISR() ), ( pxHigherPriorityTaskWoken ), 0U )
+
+#endif /* TIMER_WHEEL_H */
+
@@ -0,0 +1,84 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A light weight alternative to queue sets for a single task that needs to
+ * wait for data to become available on any one of up to waitanyMAX_MEMBERS
+ * queues or semaphores.  See WaitForAny.c.
+ */
+
+#ifndef WAIT_FOR_ANY_H
+#define WAIT_FOR_ANY_H
+
+/* The ready state of each member is held in one bit of a 32-bit task
+notification value. */
+#define waitanyMAX_MEMBERS		( 32U )
+
+struct WaitForAnySetDefinition;
+typedef struct WaitForAnySetDefinition * WaitForAnySetHandle_t;
+
+/*
+ * Create a set that is read by the task xOwner, or by the calling task if
+ * xOwner is NULL.  Returns NULL if there is not enough heap.
+ */
+WaitForAnySetHandle_t xWaitForAnyCreate( TaskHandle_t xOwner );
+
+/*
+ * Delete a set.  The member queues and semaphores are not deleted.
+ */
+void vWaitForAnyDelete( WaitForAnySetHandle_t xSet );
+
+/*
+ * Add a queue or semaphore to the set.  The member must be empty when it is
+ * added.  On success the member's index within the set is written to
+ * *puxMemberIndex - that index is passed to the send and give functions below.
+ * Returns pdFAIL if the set already has waitanyMAX_MEMBERS members.
+ */
+BaseType_t xWaitForAnyAddMember( WaitForAnySetHandle_t xSet, QueueHandle_t xMember, UBaseType_t *puxMemberIndex );
+
+/*
+ * Equivalents of xQueueSendToBack(), xQueueSendToBackFromISR(),
+ * xSemaphoreGive() and xSemaphoreGiveFromISR() for members of a set.  As with
+ * queue sets, members of a set must only be written using these functions, or
+ * the task that owns the set will not know that the member contains data.
+ */
+BaseType_t xWaitForAnyQueueSend( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, const void * const pvItemToQueue, TickType_t xTicksToWait );
+BaseType_t xWaitForAnyQueueSendFromISR( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, const void * const pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken );
+BaseType_t xWaitForAnySemaphoreGive( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex );
+BaseType_t xWaitForAnySemaphoreGiveFromISR( WaitForAnySetHandle_t xSet, UBaseType_t uxMemberIndex, BaseType_t *pxHigherPriorityTaskWoken );
+
+/*
+ * The equivalent of xQueueSelectFromSet().  Must only be called by the task
+ * that owns the set.  Returns a member that contains data, or NULL if no
+ * member contained data within xTicksToWait ticks.  The calling task must then
+ * read the member using a block time of 0.  Members are returned in round
+ * robin order when more than one contains data.
+ */
+QueueHandle_t xWaitForAnySelect( WaitForAnySetHandle_t xSet, TickType_t xTicksToWait );
+
+#endif /* WAIT_FOR_ANY_H */
+